@@ -23,6 +23,7 @@
 
 #include <ctime>
 #include <cstring>
+#include <map>
 
 /// \brief method to retrieve data on a separate thread
 void retrieveDataQueue(std::vector < CauldronIO::VisualizationIOData* >* allData, boost::lockfree::queue<int>* queue,
@@ -75,12 +76,16 @@ int main(int argc, char ** argv)
 			<< "  -import-native <xml-file>               : loads xml reads all the data into memory" << std::endl
 			<< "  -import-projectHandle <project3D file>  : loads the specified project3D file into memory" << std::endl
 			<< "  -convert <project3D file>               : converts the specified project3D file to new native format, " << std::endl
+			<< "  -append <project3D file>                : appends the snapshots not yet converted to the converted xml-project" << std::endl
 			<< " Options: " << std::endl
 			<< "  -threads=x                              : use x threads for compression during export or parallel importing" << std::endl
+			<< "  -memory=x                               : keep at most about x MB of snapshot data in memory during export" << std::endl
 			<< "  -center                                 : cell-center all properties except depth" << std::endl
 			<< "  -extend <xml-file>                      : if data is existing in the given xml-file, that data will not be converted but referred to" << std::endl
 			<< "  -verbose                                : output debugging information" << std::endl
-			<< "  -outputDir <directory>                  : output to this directory instead of input directory" << std::endl;
+			<< "  -outputDir <directory>                  : output to this directory instead of input directory" << std::endl
+			<< "  -lossy <property> <bound>               : store the property lossy, with the given maximum absolute error" << std::endl
+			<< "  -lossy-rel <property> <bound>           : store the property lossy, with the given maximum error relative to its range" << std::endl;
 
 		return -1;
 	}
@@ -89,19 +94,53 @@ int main(int argc, char ** argv)
 
 	// Check options
 	int numThreads = 1;
+	size_t maxMemory = 0;
 	bool center = false;
 	bool verbose = false;
 	std::string extendXMLfile;
 	std::string outputDirStr;
+	std::map<std::string, CauldronIO::ErrorBound> errorBounds;
 
 	for (int i = 3; i < argc; i++)
 	{
-		if (std::string(argv[i]).find("threads") != std::string::npos)
+		if (std::string(argv[i]).find("lossy") != std::string::npos)
+		{
+			bool relative = std::string(argv[i]).find("lossy-rel") != std::string::npos;
+			if (i >= argc - 2)
+			{
+				std::cerr << "Missing property name or error bound" << std::endl;
+				return -1;
+			}
+
+			std::string propertyName(argv[i + 1]);
+			double bound = std::atof(argv[i + 2]);
+			i += 2;
+
+			if (bound <= 0)
+			{
+				std::cerr << "Invalid error bound for property " << propertyName << std::endl;
+				return -1;
+			}
+			errorBounds[propertyName] = CauldronIO::ErrorBound(bound, relative);
+			std::cout << "Storing " << propertyName << " lossy with error bound " << bound << (relative ? " of its range" : "") << std::endl;
+		}
+		else if (std::string(argv[i]).find("threads") != std::string::npos)
 		{
 			numThreads = std::atoi(argv[i] + 9);
 			numThreads = std::min(24, (int)std::max(1, (int)numThreads));
 			std::cout << "Using " << numThreads << " threads" << std::endl;
 		}
+		else if (std::string(argv[i]).find("memory") != std::string::npos)
+		{
+			int megaBytes = std::atoi(argv[i] + 8);
+			if (megaBytes <= 0)
+			{
+				std::cerr << "Invalid memory limit" << std::endl;
+				return -1;
+			}
+			maxMemory = (size_t)megaBytes * 1024 * 1024;
+			std::cout << "Keeping at most " << megaBytes << " MB of snapshot data in memory" << std::endl;
+		}
 		else if (std::string(argv[i]).find("center") != std::string::npos)
 		{
 			center = true;
@@ -219,7 +258,7 @@ int main(int argc, char ** argv)
 
             return 0;
         }
-        else if (mode == "-import-projectHandle" || mode == "-convert")
+        else if (mode == "-import-projectHandle" || mode == "-convert" || mode == "-append")
         {
             if (argc < 3)
             {
@@ -267,6 +306,43 @@ int main(int argc, char ** argv)
 
 								timeInSeconds = (float)(clock() - start) / CLOCKS_PER_SEC;
 				std::cout << "Finished retrieve in " << timeInSeconds << " seconds " << std::endl;
+						}
+						else if (mode == "-append")
+						{
+				if (center)
+				{
+					std::cerr << "Cannot cell-center appended data: the existing data would be centered twice" << std::endl;
+					return -1;
+				}
+
+				// The converted project is next to the project3D file, or in the explicit output path
+				ibs::FilePath absPath(projectFileName);
+				if (!outputDirStr.empty())
+				{
+					absPath = ibs::FilePath(outputDirStr) << absPath.fileName();
+				}
+				ibs::FilePath xmlFileName(absPath.filePath());
+				xmlFileName << absPath.fileNameNoExtension() + ".xml";
+
+				std::cout << "Reading converted XML project " << xmlFileName.path() << std::endl;
+				start = clock();
+				std::shared_ptr<CauldronIO::Project> projectConverted = CauldronIO::ImportFromXML::importFromXML(xmlFileName.path());
+				timeInSeconds = (float)(clock() - start) / CLOCKS_PER_SEC;
+				std::cout << "Finished import in " << timeInSeconds << " seconds " << std::endl;
+
+				if (!(*project == *projectConverted))
+				{
+					std::cerr << "Cannot append since projects are not matching" << std::endl;
+					return -1;
+				}
+
+				size_t numAdded = CauldronIO::VisualizationUtils::addNewSnapShots(projectConverted, project);
+				std::cout << "Appending " << numAdded << " new snapshots" << std::endl;
+				start = clock();
+
+				CauldronIO::ExportToXML::appendToXML(projectConverted, absPath.path(), numThreads, errorBounds, maxMemory);
+				timeInSeconds = (float)(clock() - start) / CLOCKS_PER_SEC;
+				std::cout << "Appended to xml-project in " << timeInSeconds << " seconds" << std::endl;
 						}
 						else // mode is convert
 						{
@@ -300,7 +376,7 @@ int main(int argc, char ** argv)
           absPath = ibs::FilePath(outputDirStr) << absPath.fileName();
                 }
 
-                CauldronIO::ExportToXML::exportToXML(project, projectExisting, absPath.path(), numThreads, center);
+                CauldronIO::ExportToXML::exportToXML(project, projectExisting, absPath.path(), numThreads, center, errorBounds, maxMemory);
                 timeInSeconds = (float)(clock() - start) / CLOCKS_PER_SEC;
         std::cout << "Wrote to new format in " << timeInSeconds << " seconds" << std::endl;
             }
@@ -39,6 +39,10 @@
 
 #include "PropertyManager.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //std library
 #include <assert.h>
 #include <stdexcept>
@@ -98,6 +102,8 @@ AbstractPropertiesCalculator::AbstractPropertiesCalculator(int aRank)
     m_primaryPod       = false;
     m_extract2D        = false;
     m_no3Dproperties   = false;
+    m_cacheMemory      = 0;
+    m_threads          = 1;
 
     m_snapshotsType = MAJOR;
 
@@ -178,6 +184,14 @@ bool  AbstractPropertiesCalculator::finalise (bool isComplete)
       displayProgress("", Start_Time, "Saving is finished for ProjectFile ");
    }
 
+   if (m_propertyManager != 0)
+   {
+      const DerivedPropertyManager::CacheStatistics& statistics = m_propertyManager->getCacheStatistics ();
+      LogHandler(LogHandler::DEBUG_SEVERITY) << "Derived property cache: " << statistics.hits << " hits, " << statistics.misses << " misses, "
+                                             << statistics.calculations << " calculations, " << statistics.recalculations << " recalculations, "
+                                             << statistics.evictions << " evictions, peak memory " << statistics.peakMemory / 1048576 << " MB";
+   }
+
    delete m_propertyManager;
    m_propertyManager = 0;
 
@@ -195,6 +209,7 @@ bool AbstractPropertiesCalculator::createFrom (DataAccess::Interface::ObjectFact
       if (m_projectHandle != 0)
       {
          m_propertyManager = new DerivedPropertyManager (*m_projectHandle, getProperiesActivity(), m_debug);
+         m_propertyManager->setMemoryLimit (static_cast<size_t>(m_cacheMemory) * 1048576);
       }
    }
    if (m_projectHandle == 0 ||  m_propertyManager == 0)
@@ -206,6 +221,10 @@ bool AbstractPropertiesCalculator::createFrom (DataAccess::Interface::ObjectFact
    {
       H5_Parallel_PropertyList::setOtherFileProcessOptions(false);
    }
+   else
+   {
+      H5_Parallel_PropertyList::setChunkingAndCompressionOptions();
+   }
 
    return true;
 }
@@ -816,6 +835,37 @@ bool AbstractPropertiesCalculator::parseCommandLine(int argc, char ** argv) {
    PetscOptionsHasName (PETSC_IGNORE, PETSC_IGNORE, "-extract2D", &parameterDefined);
    if (parameterDefined) m_extract2D = true;
 
+   PetscInt cacheMemory = 0;
+   PetscOptionsGetInt (PETSC_IGNORE, PETSC_IGNORE, "-cachememory", &cacheMemory, &parameterDefined);
+   if (parameterDefined)
+   {
+      if (cacheMemory < 0)
+      {
+         showUsage (argv[0], "Argument for '-cachememory' must not be negative");
+
+         return false;
+      }
+      m_cacheMemory = static_cast<int>(cacheMemory);
+   }
+
+   PetscInt threads = 1;
+   PetscOptionsGetInt (PETSC_IGNORE, PETSC_IGNORE, "-threads", &threads, &parameterDefined);
+   if (parameterDefined)
+   {
+      if (threads < 1)
+      {
+         showUsage (argv[0], "Argument for '-threads' must be positive");
+
+         return false;
+      }
+      m_threads = static_cast<int>(threads);
+   }
+
+#ifdef _OPENMP
+   // Ranks share the cores of a node, so the calculators use more than one thread only when asked for
+   omp_set_num_threads (m_threads);
+#endif
+
 
    if (m_projectFileName == "")
    {
@@ -871,6 +921,12 @@ void AbstractPropertiesCalculator::showUsage (const char* command, const char* m
            << "\t[-all-2D-properties]                       produce output for all 2D primary properties" << endl
            << "\t[-project-properties]                      produce output for the properties selected for output in the project file" << endl
            << "\t[-extract2D]                               produce output for all 2D properties (use with -all-2D-properties)" << endl
+           << "\t[-cachememory MB]                          keep at most MB megabytes of derived property values in memory, recalculating" << endl
+           << "\t                                           these when needed again; default 0 keeps all values of a snapshot" << endl
+           << "\t[-threads n]                               number of threads of each rank for the porosity and permeability calculations," << endl
+           << "\t                                           default 1" << endl
+           << "\t[-recompute]                               calculate all outputs, also those whose inputs have not changed since" << endl
+           << "\t                                           these were written by a previous run" << endl
            << "\t[-list-properties]                         print a list of available properties and exit" << endl
            << "\t[-list-snapshots]                          print a list of available snapshots and exit" << endl
            << "\t[-list-stratigraphy]                       print a list of available surfaces and formations and exit" << endl << endl
@@ -892,7 +948,11 @@ void AbstractPropertiesCalculator::showUsage (const char* command, const char* m
            << "\t[-copy]                                    use in combination with -primaryPod. Copy the results to the local dir and " << endl
            << "\t                                           remove them from the shared dir on the cluster" << endl << endl
            << "\t[-noremove]                                use in combination with -primaryPod and -copy. Don't remove results from " << endl
-           << "\t                                           the shared dir on the cluster" << endl << endl;
+           << "\t                                           the shared dir on the cluster" << endl << endl
+           << "Options for volume output:" << endl << endl
+           << "\t[-hdfchunked]                              write volume properties with chunked layout" << endl << endl
+           << "\t[-hdfchunksize <ni,nj,nk>]                 chunk shape, 0 entries are taken from the domain decomposition" << endl << endl
+           << "\t[-hdfcompress <level>]                     compress volume properties with deflate level 1-9 (default 4)" << endl << endl;
       cout << "If names in an argument list contain spaces, put the list between double or single quotes, e.g:"
            << "\t-formations \"Dissolved Salt,Al Khalata\"" << endl;
       cout << "Bracketed options are optional and options may be abbreviated" << endl << endl;
@@ -52,6 +52,8 @@ protected:
    bool m_listProperties;     ///< If true: prints all outputable properties
    bool m_listSnapshots;      ///< If true: prints all snapshots from project file
    bool m_listStratigraphy;   ///< If true: prints all stratigraphy from project file
+   int  m_cacheMemory;        ///< Memory limit in MB for the derived property values kept by the property manager, 0 for no limit
+   int  m_threads;            ///< Number of OpenMP threads of each rank for the node loops of the calculators
 
    StringVector m_propertyNames;
    DoubleVector m_ages;
@@ -13,8 +13,12 @@
 #include "FilePath.h"
 #include "GeoPhysicsFormation.h"
 #include "h5_parallel_file_types.h"
+#include "OutputFingerprints.h"
 #include "OutputPropertyValue.h"
+#include "PropertyTaskGraph.h"
+#include "SimulationDetails.h"
 
+#include <sstream>
 #include <sys/stat.h>
 
 using namespace Interface;
@@ -25,6 +29,7 @@ HdfPropertiesCalculator::HdfPropertiesCalculator(int aRank) : AbstractProperties
 
    m_copy              = false;
    m_projectProperties = false;
+   m_recompute         = false;
 }
 
 //------------------------------------------------------------//
@@ -47,6 +52,14 @@ void HdfPropertiesCalculator::calculateProperties(FormationSurfaceVector& format
    struct stat fileStatus;
    int fileError;
 
+   // Outputs written before with the same inputs are not calculated again, unless requested
+   OutputFingerprints fingerprints (OutputFingerprints::getFileName (getProjectHandle().getFullOutputDir ()), getFingerprintInputs (),
+                                    getProjectHandle(), getPropertyManager());
+   size_t numberOfSkipped = 0;
+
+   fingerprints.load ();
+   fingerprints.setRecompute (m_recompute);
+
    for ( const Interface::Snapshot* snapshot : snapshots )
    {
       displayProgress(snapshot->getFileName (), m_startTime, "Start computing ");
@@ -61,6 +74,9 @@ void HdfPropertiesCalculator::calculateProperties(FormationSurfaceVector& format
       }
 
 
+      // Collect the outputs first, so the values they depend on can be released as soon as these are no longer needed
+      PropertyTaskGraph taskGraph (getPropertyManager(), snapshot);
+
       for ( const FormationSurface& formationIter : formationItems )
       {
          const Interface::Formation * formation = formationIter.first;
@@ -90,36 +106,66 @@ void HdfPropertiesCalculator::calculateProperties(FormationSurfaceVector& format
 
             if (not m_projectProperties or (m_projectProperties and allowOutput(property->getName(), formation, surface)))
             {
-               resetProjectActivityGrid (property);
-               OutputPropertyValuePtr outputProperty = DerivedProperties::allocateOutputProperty (getPropertyManager(), property, snapshot, formationIter, m_basement);
-               resetProjectActivityGrid ();
-
-               if (outputProperty != 0)
+               if (fingerprints.isUpToDate (snapshot, formationIter, property) and outputExists (snapshot, formationIter, property))
                {
                   if (m_debug && m_rank == 0)
                   {
                      LogHandler(LogHandler::INFO_SEVERITY) << "Snapshot: " << snapshot->getTime() <<
-                        " allocate " << property->getName() << " " << (formation != 0 ? formation->getName() : "") << " " <<
+                        " skip up-to-date " << property->getName() << " " << (formation != 0 ? formation->getName() : "") << " " <<
                         (surface != 0 ? surface->getName() : "");
                   }
-                  allOutputPropertyValues [ snapshot ][ formationIter ][ property ] = outputProperty;
+                  ++ numberOfSkipped;
+                  continue;
+               }
+
+               taskGraph.addOutput (formationIter, property);
+            }
+         }
+      }
+
+      for ( const FormationSurface& formationIter : taskGraph.getFormationItems () )
+      {
+         const Interface::Formation * formation = formationIter.first;
+         const Interface::Surface   * surface   = formationIter.second;
+
+         for ( const Interface::Property* property : taskGraph.getProperties (formationIter) )
+         {
+            resetProjectActivityGrid (property);
+            OutputPropertyValuePtr outputProperty = DerivedProperties::allocateOutputProperty (getPropertyManager(), property, snapshot, formationIter, m_basement);
+            resetProjectActivityGrid ();
+
+            if (outputProperty != 0)
+            {
+               if (m_debug && m_rank == 0)
+               {
+                  LogHandler(LogHandler::INFO_SEVERITY) << "Snapshot: " << snapshot->getTime() <<
+                     " allocate " << property->getName() << " " << (formation != 0 ? formation->getName() : "") << " " <<
+                     (surface != 0 ? surface->getName() : "");
                }
-               else
+               allOutputPropertyValues [ snapshot ][ formationIter ][ property ] = outputProperty;
+               fingerprints.update (snapshot, formationIter, property);
+            }
+            else
+            {
+               if (m_debug && m_rank == 0)
                {
-                  if (m_debug && m_rank == 0)
-                  {
-                     LogHandler(LogHandler::INFO_SEVERITY) << "Could not calculate derived property " << property->getName()
-                                                             << " @ snapshot " << snapshot->getTime() << "Ma for formation " <<
-                        (formation != 0 ? formation->getName() : "") << " " <<  (surface != 0 ? surface->getName() : "") << ".";
-                  }
+                  LogHandler(LogHandler::INFO_SEVERITY) << "Could not calculate derived property " << property->getName()
+                                                          << " @ snapshot " << snapshot->getTime() << "Ma for formation " <<
+                     (formation != 0 ? formation->getName() : "") << " " <<  (surface != 0 ? surface->getName() : "") << ".";
                }
             }
          }
 
-
          DerivedProperties::outputSnapshotFormationData(getProjectHandle(), snapshot, formationIter, properties, allOutputPropertyValues);
+
+         // The values have been copied to the output maps
+         allOutputPropertyValues [ snapshot ].erase (formationIter);
+         taskGraph.outputDone (formationIter);
       }
 
+      LogHandler(LogHandler::DEBUG_SEVERITY) << "Snapshot: " << snapshot->getTime() << " released " << taskGraph.getNumberOfReleasedProperties () <<
+         " intermediate property values";
+
       removeProperties(snapshot, allOutputPropertyValues);
       getPropertyManager().removeProperties(snapshot);
 
@@ -129,11 +175,23 @@ void HdfPropertiesCalculator::calculateProperties(FormationSurfaceVector& format
 
       displayProgress(snapshot->getFileName (), m_startTime, "Saving is finished for ");
 
+      // Only record the outputs once these have been saved, so an interrupted run calculates them again
+      if (m_rank == 0 and not fingerprints.save ())
+      {
+         LogHandler(LogHandler::WARNING_SEVERITY) << "Could not save the fingerprints of the outputs, these will all be calculated again next run.";
+      }
+
       getProjectHandle().deletePropertiesValuesMaps (snapshot);
 
       Utilities::CheckMemory::StatisticsHandler::update ();
    }
 
+   if (m_rank == 0 and numberOfSkipped > 0)
+   {
+      LogHandler(LogHandler::INFO_SEVERITY) << "Skipped " << numberOfSkipped << " outputs whose inputs have not changed since these were written"
+                                            << " (use -recompute to calculate all).";
+   }
+
    PetscLogDouble End_Time;
    PetscTime(&End_Time);
 
@@ -141,6 +199,39 @@ void HdfPropertiesCalculator::calculateProperties(FormationSurfaceVector& format
 }
 
 //------------------------------------------------------------//
+std::string HdfPropertiesCalculator::getFingerprintInputs() const
+{
+   std::ostringstream inputs;
+
+   // The primary properties are identified by the fastcauldron run that wrote them
+   const Interface::SimulationDetails* simulationDetails = getProjectHandle().getDetailsOfLastSimulation ("fastcauldron");
+   if (simulationDetails != 0)
+   {
+      inputs << "fastcauldron " << simulationDetails->getSimulationSequenceNumber () << " " << simulationDetails->getSimulatorMode ()
+             << " " << simulationDetails->getSimulatorCommandLineParameters () << "\n";
+   }
+
+   const Interface::Grid* grid = getProjectHandle().getLowResolutionOutputGrid ();
+   if (grid != 0)
+   {
+      inputs << "grid " << grid->numIGlobal () << " " << grid->numJGlobal () << " " << grid->deltaIGlobal () << " " << grid->deltaJGlobal () << "\n";
+   }
+
+   return inputs.str ();
+}
+
+//------------------------------------------------------------//
+bool HdfPropertiesCalculator::outputExists(const Interface::Snapshot * snapshot, const FormationSurface& formationItem, const Interface::Property * property) const
+{
+   if (formationItem.second == 0)
+   {
+      return getProjectHandle().hasPropertyValues (FORMATION, property, snapshot, 0, formationItem.first, 0, MAP | VOLUME);
+   }
+
+   return getProjectHandle().hasPropertyValues (SURFACE | FORMATIONSURFACE, property, snapshot, 0, 0, formationItem.second, MAP);
+}
+
+//------------------------------------------------------------//
 
 
 
@@ -261,6 +352,9 @@ bool HdfPropertiesCalculator::parseCommandLine(int argc, char ** argv) {
       PetscOptionsHasName (PETSC_IGNORE, PETSC_IGNORE, "-copy", &parameterDefined);
       if (parameterDefined) m_copy = true;
 
+      PetscOptionsHasName (PETSC_IGNORE, PETSC_IGNORE, "-recompute", &parameterDefined);
+      if (parameterDefined) m_recompute = true;
+
       status = checkParameters();
    }
 
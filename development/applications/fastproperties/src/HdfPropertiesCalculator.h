@@ -24,10 +24,17 @@ private:
 
    bool m_copy;
    bool m_projectProperties;
+   bool m_recompute;          ///< If true: calculate all outputs, also those whose inputs have not changed since these were written
 
     /// \brief Check command-line parameters consistency
    bool checkParameters();
 
+   /// \brief Describe the inputs shared by all outputs, to detect outputs that are up to date
+   std::string getFingerprintInputs() const;
+
+   /// \brief Check if the project already has values of the property for the formation/surface at the snapshot
+   bool outputExists( const Interface::Snapshot * snapshot, const FormationSurface& formationItem, const Interface::Property * property ) const;
+
 public:
 
    void calculateProperties( FormationSurfaceVector& formationItems, Interface::PropertyList properties, Interface::SnapshotList & snapshots );
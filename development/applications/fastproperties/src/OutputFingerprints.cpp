@@ -0,0 +1,213 @@
+//
+// Copyright (C) 2015-2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+#include "OutputFingerprints.h"
+
+#include "FilePath.h"
+#include "Hash.h"
+
+// TableIO
+#include "database.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+   /// Increase when a change to the derived property calculations changes the results,
+   /// so that all outputs of earlier runs are calculated again
+   const int FingerprintVersion = 1;
+
+   const char * const FingerprintFileName = "fastproperties.fingerprints";
+
+   /// The project tables read by the derived property calculations, besides the primary properties
+   const char * const InputTableNames [] = { "StratIoTbl", "LithotypeIoTbl", "LitThCondIoTbl", "LitHeatCapIoTbl",
+                                             "FluidtypeIoTbl", "FltThCondIoTbl", "FltHeatCapIoTbl", "SGDensityIoTbl",
+                                             "BasementIoTbl", "SourceRockLithoIoTbl", "RunOptionsIoTbl" };
+
+   uint64_t hashText ( const std::string& text, const uint64_t previous = Utilities::HashOffsetBasis )
+   {
+      return Utilities::hash ( text.data (), text.size (), previous );
+   }
+}
+
+//------------------------------------------------------------//
+OutputFingerprints::OutputFingerprints ( const std::string&                                        fileName,
+                                         const std::string&                                        inputs,
+                                         const Interface::ProjectHandle&                           projectHandle,
+                                         const AbstractDerivedProperties::AbstractPropertyManager& propertyManager ) :
+   m_fileName ( fileName ),
+   m_inputsHash ( 0 ),
+   m_propertyManager ( propertyManager ),
+   m_recompute ( false )
+{
+   // The shared inputs are hashed once, the fingerprint of each property continues from this hash
+   std::ostringstream sharedInputs;
+   sharedInputs << FingerprintVersion << '\n' << inputs << getInputRecords ( projectHandle ) << '\n';
+   m_inputsHash = hashText ( sharedInputs.str ());
+}
+
+//------------------------------------------------------------//
+std::string OutputFingerprints::getFileName ( const std::string& outputDirectory )
+{
+   ibs::FilePath filePath ( outputDirectory );
+   filePath << FingerprintFileName;
+   return filePath.path ();
+}
+
+//------------------------------------------------------------//
+bool OutputFingerprints::load ()
+{
+   m_fingerprints.clear ();
+
+   std::ifstream file ( m_fileName.c_str ());
+   if (not file)
+   {
+      return false;
+   }
+
+   // Each line holds: age, formation, surface, property and fingerprint, separated by tabs as names may contain spaces
+   std::string line;
+   while (std::getline ( file, line ))
+   {
+      std::istringstream fields ( line );
+      std::string age, formation, surface, property, fingerprint;
+
+      if (std::getline ( fields, age, '\t' ) and std::getline ( fields, formation, '\t' ) and std::getline ( fields, surface, '\t' ) and
+          std::getline ( fields, property, '\t' ) and std::getline ( fields, fingerprint ))
+      {
+         std::istringstream ageValue ( age );
+         std::istringstream fingerprintValue ( fingerprint );
+         double snapshotAge;
+         uint64_t value;
+
+         if (ageValue >> snapshotAge and fingerprintValue >> std::hex >> value)
+         {
+            m_fingerprints [ OutputKey ( snapshotAge, formation, surface, property ) ] = value;
+         }
+      }
+   }
+
+   return true;
+}
+
+//------------------------------------------------------------//
+bool OutputFingerprints::save () const
+{
+   std::ofstream file ( m_fileName.c_str (), std::ios::trunc );
+   if (not file)
+   {
+      return false;
+   }
+
+   file << std::setprecision ( 17 );
+   for ( const std::pair<const OutputKey, uint64_t>& fingerprint : m_fingerprints )
+   {
+      file << std::get<0>( fingerprint.first ) << '\t' << std::get<1>( fingerprint.first ) << '\t' << std::get<2>( fingerprint.first ) << '\t'
+           << std::get<3>( fingerprint.first ) << '\t' << std::hex << fingerprint.second << std::dec << '\n';
+   }
+
+   file.close ();
+   return not file.fail ();
+}
+
+//------------------------------------------------------------//
+void OutputFingerprints::setRecompute ( bool recompute )
+{
+   m_recompute = recompute;
+}
+
+//------------------------------------------------------------//
+bool OutputFingerprints::isUpToDate ( const Interface::Snapshot* snapshot, const FormationSurface& formationItem, const Interface::Property* property ) const
+{
+   if (m_recompute)
+   {
+      return false;
+   }
+
+   std::map<OutputKey, uint64_t>::const_iterator fingerprint = m_fingerprints.find ( getKey ( snapshot, formationItem, property ));
+   return fingerprint != m_fingerprints.end () and fingerprint->second == getFingerprint ( property );
+}
+
+//------------------------------------------------------------//
+void OutputFingerprints::update ( const Interface::Snapshot* snapshot, const FormationSurface& formationItem, const Interface::Property* property )
+{
+   m_fingerprints [ getKey ( snapshot, formationItem, property ) ] = getFingerprint ( property );
+}
+
+//------------------------------------------------------------//
+OutputFingerprints::OutputKey OutputFingerprints::getKey ( const Interface::Snapshot* snapshot, const FormationSurface& formationItem, const Interface::Property* property )
+{
+   return OutputKey ( snapshot->getTime (),
+                      formationItem.first  != 0 ? formationItem.first->getName ()  : "",
+                      formationItem.second != 0 ? formationItem.second->getName () : "",
+                      property->getName ());
+}
+
+//------------------------------------------------------------//
+std::string OutputFingerprints::getInputRecords ( const Interface::ProjectHandle& projectHandle )
+{
+   std::ostringstream records;
+
+   for ( const char * tableName : InputTableNames )
+   {
+      database::Table* table = projectHandle.getTable ( tableName );
+
+      if (table != 0)
+      {
+         records << tableName << '\n';
+         table->saveToStream ( records );
+      }
+   }
+
+   return records.str ();
+}
+
+//------------------------------------------------------------//
+void OutputFingerprints::addDependencies ( const std::string& propertyName, std::set<std::string>& dependencies ) const
+{
+   std::vector<std::string> dependentNames;
+   m_propertyManager.getDependentPropertyNames ( m_propertyManager.getProperty ( propertyName ), dependentNames );
+
+   for ( const std::string& name : dependentNames )
+   {
+      if (dependencies.insert ( name ).second)
+      {
+         addDependencies ( name, dependencies );
+      }
+   }
+}
+
+//------------------------------------------------------------//
+uint64_t OutputFingerprints::getFingerprint ( const Interface::Property* property ) const
+{
+   std::map<std::string, uint64_t>::const_iterator fingerprint = m_propertyFingerprints.find ( property->getName ());
+   if (fingerprint != m_propertyFingerprints.end ())
+   {
+      return fingerprint->second;
+   }
+
+   std::set<std::string> dependencies;
+   addDependencies ( property->getName (), dependencies );
+
+   std::ostringstream inputs;
+   inputs << property->getName ();
+
+   // A property calculated from other properties than before is calculated differently
+   for ( const std::string& name : dependencies )
+   {
+      inputs << '\n' << name;
+   }
+
+   const uint64_t value = hashText ( inputs.str (), m_inputsHash );
+   m_propertyFingerprints [ property->getName () ] = value;
+   return value;
+}
@@ -0,0 +1,89 @@
+//
+// Copyright (C) 2015-2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+#ifndef FASTPROPERTIES__OUTPUT_FINGERPRINTS__H
+#define FASTPROPERTIES__OUTPUT_FINGERPRINTS__H
+
+#include "OutputUtilities.h"
+
+#include "AbstractPropertyManager.h"
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+
+/// \brief Fingerprints of the inputs of the property values written by a previous run.
+///
+/// The fingerprint of an output combines the version of the derived property calculations, the fastcauldron run
+/// that produced the primary properties and its output grid, the project records the calculations read (e.g. the
+/// lithologies and fluids), the name of the property and the names of all properties it is calculated from.
+/// The fastproperties options select which outputs are written, these do not change the values and are not included.
+/// An output whose fingerprint has not changed since it was written does not need to be calculated again.
+/// The fingerprints are kept in a text file in the output directory, one line per output.
+class OutputFingerprints {
+
+public :
+
+   /// \param [in] fileName        The file holding the fingerprints.
+   /// \param [in] inputs          Description of the inputs shared by all outputs, e.g. the fastcauldron run and the output grid.
+   /// \param [in] projectHandle   The project whose input records are part of the fingerprints.
+   /// \param [in] propertyManager The property manager whose calculators determine the dependencies of a property.
+   OutputFingerprints ( const std::string&                                        fileName,
+                        const std::string&                                        inputs,
+                        const Interface::ProjectHandle&                           projectHandle,
+                        const AbstractDerivedProperties::AbstractPropertyManager& propertyManager );
+
+   /// \brief Read the fingerprints of the previous run, returns false if there are none.
+   bool load ();
+
+   /// \brief Write the fingerprints, returns false if the file cannot be written.
+   bool save () const;
+
+   /// \brief Calculate all outputs again, also those whose inputs have not changed.
+   ///
+   /// The fingerprints of the outputs are still updated, so a later run without recalculation skips these.
+   void setRecompute ( bool recompute );
+
+   /// \brief Determine whether the output has been written with the same inputs, never when recalculating all outputs.
+   bool isUpToDate ( const Interface::Snapshot* snapshot, const FormationSurface& formationItem, const Interface::Property* property ) const;
+
+   /// \brief Record that the output has been written with the current inputs.
+   void update ( const Interface::Snapshot* snapshot, const FormationSurface& formationItem, const Interface::Property* property );
+
+   /// \brief Get the name of the fingerprint file in an output directory.
+   static std::string getFileName ( const std::string& outputDirectory );
+
+private :
+
+   /// \brief Snapshot age, formation name, surface name and property name of an output.
+   typedef std::tuple<double, std::string, std::string, std::string> OutputKey;
+
+   static OutputKey getKey ( const Interface::Snapshot* snapshot, const FormationSurface& formationItem, const Interface::Property* property );
+
+   /// \brief Get the contents of the project tables read by the derived property calculations.
+   static std::string getInputRecords ( const Interface::ProjectHandle& projectHandle );
+
+   /// \brief Add the names of the properties the property is calculated from, directly or indirectly.
+   void addDependencies ( const std::string& propertyName, std::set<std::string>& dependencies ) const;
+
+   /// \brief Get the fingerprint of the outputs of a property, calculated once per property.
+   uint64_t getFingerprint ( const Interface::Property* property ) const;
+
+   std::string                                               m_fileName;
+   uint64_t                                                  m_inputsHash;          ///< Hash of the inputs shared by all outputs.
+   const AbstractDerivedProperties::AbstractPropertyManager& m_propertyManager;
+   bool                                                      m_recompute;
+   std::map<OutputKey, uint64_t>                             m_fingerprints;
+   mutable std::map<std::string, uint64_t>                   m_propertyFingerprints; ///< Fingerprint for each property name.
+
+};
+
+#endif // FASTPROPERTIES__OUTPUT_FINGERPRINTS__H
@@ -0,0 +1,139 @@
+//
+// Copyright (C) 2015-2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+#include "PropertyTaskGraph.h"
+
+#include <string>
+#include <vector>
+
+using namespace DataAccess;
+
+//------------------------------------------------------------//
+PropertyTaskGraph::PropertyTaskGraph ( AbstractDerivedProperties::AbstractPropertyManager& propertyManager, const Interface::Snapshot* snapshot ) :
+   m_propertyManager ( propertyManager ),
+   m_snapshot ( snapshot ),
+   m_numberOfReleased ( 0 )
+{
+}
+
+//------------------------------------------------------------//
+void PropertyTaskGraph::addOutput ( const FormationSurface& formationItem, const Interface::Property* property )
+{
+   std::map<FormationSurface, Interface::PropertyList>::iterator properties = m_properties.find ( formationItem );
+
+   if (properties == m_properties.end ())
+   {
+      m_formationItems.push_back ( formationItem );
+      properties = m_properties.insert ( std::make_pair ( formationItem, Interface::PropertyList ())).first;
+   }
+
+   properties->second.push_back ( property );
+
+   FormationPropertyNodeSet& inputs = m_inputs [ formationItem ];
+   const Interface::Surface* surface = formationItem.second;
+
+   if (surface == 0)
+   {
+      addDependencies ( property, formationItem.first, inputs );
+   }
+   else
+   {
+      // Surface values are calculated from the formations on either side of the surface
+      addDependencies ( property, surface->getTopFormation (), inputs );
+      addDependencies ( property, surface->getBottomFormation (), inputs );
+   }
+}
+
+//------------------------------------------------------------//
+const Interface::PropertyList& PropertyTaskGraph::getProperties ( const FormationSurface& formationItem ) const
+{
+   static const Interface::PropertyList noProperties;
+
+   std::map<FormationSurface, Interface::PropertyList>::const_iterator properties = m_properties.find ( formationItem );
+   return properties != m_properties.end () ? properties->second : noProperties;
+}
+
+//------------------------------------------------------------//
+void PropertyTaskGraph::outputDone ( const FormationSurface& formationItem )
+{
+   std::map<FormationSurface, FormationPropertyNodeSet>::iterator inputs = m_inputs.find ( formationItem );
+
+   if (inputs == m_inputs.end ())
+   {
+      return;
+   }
+
+   for ( const FormationPropertyNode& node : inputs->second )
+   {
+      if (--m_numberOfConsumers [ node ] == 0)
+      {
+         m_propertyManager.removeFormationProperty ( node.first, m_snapshot, node.second );
+         m_numberOfConsumers.erase ( node );
+         ++m_numberOfReleased;
+      }
+   }
+
+   m_inputs.erase ( inputs );
+}
+
+//------------------------------------------------------------//
+void PropertyTaskGraph::addDependencies ( const DataModel::AbstractProperty* property, const Interface::Formation* formation, FormationPropertyNodeSet& inputs )
+{
+   if (not addInput ( property, formation, inputs ))
+   {
+      return;
+   }
+
+   std::vector<std::string> dependentNames;
+   m_propertyManager.getDependentPropertyNames ( property, dependentNames );
+
+   for ( const std::string& name : dependentNames )
+   {
+      addDependencies ( m_propertyManager.getProperty ( name ), formation, inputs );
+   }
+
+   // Only the values of the formation above are needed; those have been calculated with the formation above itself,
+   // so its dependencies are not followed up the column
+   if (m_propertyManager.formationPropertyDependsOnFormationAbove ( property ))
+   {
+      addInput ( property, getFormationAbove ( formation ), inputs );
+   }
+}
+
+//------------------------------------------------------------//
+bool PropertyTaskGraph::addInput ( const DataModel::AbstractProperty* property, const Interface::Formation* formation, FormationPropertyNodeSet& inputs )
+{
+   if (property == 0 or formation == 0)
+   {
+      return false;
+   }
+
+   const FormationPropertyNode node ( property, formation );
+
+   if (not inputs.insert ( node ).second)
+   {
+      return false;
+   }
+
+   ++m_numberOfConsumers [ node ];
+   return true;
+}
+
+//------------------------------------------------------------//
+const Interface::Formation* PropertyTaskGraph::getFormationAbove ( const Interface::Formation* formation ) const
+{
+   const Interface::Surface* topSurface = formation->getTopSurface ();
+
+   if (topSurface != 0 and ( topSurface->getSnapshot () == 0 or topSurface->getSnapshot ()->getTime () > m_snapshot->getTime ()))
+   {
+      return topSurface->getTopFormation ();
+   }
+
+   return 0;
+}
@@ -0,0 +1,85 @@
+//
+// Copyright (C) 2015-2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+#ifndef FASTPROPERTIES__PROPERTY_TASK_GRAPH__H
+#define FASTPROPERTIES__PROPERTY_TASK_GRAPH__H
+
+#include "OutputUtilities.h"
+
+#include "AbstractPropertyManager.h"
+
+#include <map>
+#include <set>
+#include <utility>
+
+/// \brief Dependency graph of the formation properties needed to output the properties at a snapshot.
+///
+/// The outputs are added per formation-surface item, in the order in which they are to be computed. Every formation
+/// property an output depends on, directly or through the calculators of its dependencies, counts the items that still
+/// need it. Once the last of these has been output, its values are removed from the property manager instead of being
+/// kept until all properties at the snapshot have been output.
+class PropertyTaskGraph {
+
+public :
+
+   PropertyTaskGraph ( AbstractDerivedProperties::AbstractPropertyManager& propertyManager, const Interface::Snapshot* snapshot );
+
+   /// \brief Add the output of the property for the formation-surface item, and the formation properties it depends on.
+   void addOutput ( const FormationSurface& formationItem, const Interface::Property* property );
+
+   /// \brief Get the formation-surface items that have outputs, in the order in which these were added.
+   const FormationSurfaceVector& getFormationItems () const;
+
+   /// \brief Get the properties to output for the formation-surface item.
+   const Interface::PropertyList& getProperties ( const FormationSurface& formationItem ) const;
+
+   /// \brief Mark the outputs of the formation-surface item as done.
+   ///
+   /// The values of the formation properties that are not needed by any of the remaining items are removed from the property manager.
+   void outputDone ( const FormationSurface& formationItem );
+
+   /// \brief Get the number of formation property values that have been removed so far.
+   size_t getNumberOfReleasedProperties () const;
+
+private :
+
+   /// \brief A formation property at the snapshot of the graph.
+   typedef std::pair<const DataModel::AbstractProperty*, const DataModel::AbstractFormation*> FormationPropertyNode;
+
+   typedef std::set<FormationPropertyNode> FormationPropertyNodeSet;
+
+   /// \brief Add the formation property and, recursively, the properties it depends on to the inputs of an item.
+   void addDependencies ( const DataModel::AbstractProperty* property, const Interface::Formation* formation, FormationPropertyNodeSet& inputs );
+
+   /// \brief Add the formation property to the inputs of an item, returns false if it was an input already.
+   bool addInput ( const DataModel::AbstractProperty* property, const Interface::Formation* formation, FormationPropertyNodeSet& inputs );
+
+   /// \brief Get the formation above the formation at the snapshot, null if there is none.
+   const Interface::Formation* getFormationAbove ( const Interface::Formation* formation ) const;
+
+   AbstractDerivedProperties::AbstractPropertyManager& m_propertyManager;
+   const Interface::Snapshot*                          m_snapshot;
+
+   FormationSurfaceVector                                    m_formationItems;   ///< The items with outputs, in order
+   std::map<FormationSurface, Interface::PropertyList>       m_properties;       ///< The properties to output per item
+   std::map<FormationSurface, FormationPropertyNodeSet>      m_inputs;           ///< The formation properties needed per item
+   std::map<FormationPropertyNode, size_t>                   m_numberOfConsumers; ///< The number of items still needing a formation property
+   size_t                                                    m_numberOfReleased;
+
+};
+
+inline const FormationSurfaceVector& PropertyTaskGraph::getFormationItems () const {
+   return m_formationItems;
+}
+
+inline size_t PropertyTaskGraph::getNumberOfReleasedProperties () const {
+   return m_numberOfReleased;
+}
+
+#endif // FASTPROPERTIES__PROPERTY_TASK_GRAPH__H
@@ -27,6 +27,7 @@
 
 #include "SimulationDetails.h"
 #include "DerivedPropertyManager.h"
+#include "PropertyTaskGraph.h"
 #include "Utilities.h"
 
 using namespace DataAccess;
@@ -73,6 +74,8 @@ void VisualizationPropertiesCalculator::createXML() {
 
    if (m_rank == 0)
    {
+      m_projectLock.reset(new CauldronIO::ProjectLock(m_fileNameXml));
+
       ibs::FilePath folderPath(m_filePathXml);
       folderPath << m_outputNameXml;
 
@@ -108,7 +111,8 @@ void VisualizationPropertiesCalculator::saveXML() {
       // snapshots are already written - add the project data
       m_export->addProjectData(m_pt, m_vizProject, false);
 
-      m_doc.save_file(m_fileNameXml.c_str());
+      CauldronIO::ExportToXML::saveXML(m_doc, m_fileNameXml);
+      m_projectLock.reset();
 
       displayProgress("", m_startTime, "Writing to visualization format done ");
    }
@@ -208,6 +212,9 @@ void VisualizationPropertiesCalculator::calculateProperties(FormationSurfaceVect
          continue;
       }
 
+      // Collect the outputs first, so the values they depend on can be released as soon as these are no longer needed
+      PropertyTaskGraph taskGraph (getPropertyManager(), snapshot);
+
       for (formationIter = formationItems.begin(); formationIter != formationItems.end(); ++formationIter)
       {
          const Interface::Formation * formation = (*formationIter).first;
@@ -245,8 +252,19 @@ void VisualizationPropertiesCalculator::calculateProperties(FormationSurfaceVect
                continue;
             }
 
+            taskGraph.addOutput (* formationIter, property);
+         }
+      }
+
+      for (const FormationSurface& formationItem : taskGraph.getFormationItems ())
+      {
+         const Interface::Formation * formation = formationItem.first;
+         const Interface::Surface   * surface   = formationItem.second;
+
+         for (const Interface::Property * property : taskGraph.getProperties (formationItem))
+         {
             resetProjectActivityGrid (property);
-            OutputPropertyValuePtr outputProperty = DerivedProperties::allocateOutputProperty (getPropertyManager(), property, snapshot, * formationIter, m_basement);
+            OutputPropertyValuePtr outputProperty = DerivedProperties::allocateOutputProperty (getPropertyManager(), property, snapshot, formationItem, m_basement);
             resetProjectActivityGrid ();
 
             if (outputProperty != 0)
@@ -257,7 +275,7 @@ void VisualizationPropertiesCalculator::calculateProperties(FormationSurfaceVect
                      " allocate " << property->getName() << " " << (formation != 0 ? formation->getName() : "") << " " <<
                      (surface != 0 ? surface->getName() : "");
                }
-               allOutputPropertyValues [ snapshot ][ * formationIter ][ property ] = outputProperty;
+               allOutputPropertyValues [ snapshot ][ formationItem ][ property ] = outputProperty;
             }
             else
             {
@@ -270,9 +288,16 @@ void VisualizationPropertiesCalculator::calculateProperties(FormationSurfaceVect
             }
          }
 
-         createVizSnapshotFormationData(snapshot, * formationIter, properties, allOutputPropertyValues);
+         createVizSnapshotFormationData(snapshot, formationItem, properties, allOutputPropertyValues);
+
+         // The values have been copied to the visualization data
+         allOutputPropertyValues [ snapshot ].erase (formationItem);
+         taskGraph.outputDone (formationItem);
       }
 
+      LogHandler(LogHandler::DEBUG_SEVERITY) << "Snapshot: " << snapshot->getTime() << " released " << taskGraph.getNumberOfReleasedProperties () <<
+         " intermediate property values";
+
       removeProperties(snapshot, allOutputPropertyValues);
       getPropertyManager().removeProperties(snapshot);
 
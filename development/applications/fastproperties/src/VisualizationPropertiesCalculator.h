@@ -38,6 +38,7 @@ private:
    std::shared_ptr<CauldronIO::Project> m_vizProjectExisting;
 
    CauldronIO::ExportToXML * m_export;
+   std::unique_ptr<CauldronIO::ProjectLock> m_projectLock; ///< Held on rank 0 while the datastores and the xml are written
    pugi::xml_document m_doc;
    pugi::xml_node m_pt;
    pugi::xml_node m_snapShotNodes;
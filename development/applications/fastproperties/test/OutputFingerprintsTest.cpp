@@ -0,0 +1,242 @@
+//
+// Copyright (C) 2015-2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#include "../src/OutputFingerprints.h"
+
+#include "FormationPropertyCalculator.h"
+
+#include "GeoPhysicsObjectFactory.h"
+
+// TableIO
+#include "database.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace AbstractDerivedProperties;
+
+namespace
+{
+   /// A calculator that only declares the property it calculates and the properties it depends on.
+   class DependencyCalculator : public FormationPropertyCalculator
+   {
+   public :
+
+      DependencyCalculator( const std::string& propertyName, const std::vector<std::string>& dependentPropertyNames )
+      {
+         addPropertyName( propertyName );
+
+         for ( const std::string& name : dependentPropertyNames )
+         {
+            addDependentPropertyName( name );
+         }
+      }
+
+      void calculate( AbstractPropertyManager&, const DataModel::AbstractSnapshot*, const DataModel::AbstractFormation*, FormationPropertyList& ) const final
+      {
+      }
+   };
+
+   class DependencyPropertyManager : public AbstractPropertyManager
+   {
+   public :
+
+      /// \param porosityDependencies The properties the porosity is calculated from, the bulk density is calculated from the porosity.
+      DependencyPropertyManager( const DataAccess::Interface::ProjectHandle& projectHandle, const std::vector<std::string>& porosityDependencies ) :
+         m_projectHandle( projectHandle )
+      {
+         addFormationPropertyCalculator( FormationPropertyCalculatorPtr( new DependencyCalculator( "Temperature", {} )));
+         addFormationPropertyCalculator( FormationPropertyCalculatorPtr( new DependencyCalculator( "Porosity", porosityDependencies )));
+         addFormationPropertyCalculator( FormationPropertyCalculatorPtr( new DependencyCalculator( "BulkDensity", { "Porosity", "Temperature" } )));
+      }
+
+      const DataModel::AbstractProperty* getProperty( const std::string& name ) const final
+      {
+         return m_projectHandle.findProperty( name );
+      }
+
+      const DataModel::AbstractGrid* getMapGrid() const final
+      {
+         return m_projectHandle.getLowResolutionOutputGrid();
+      }
+
+      bool getNodeIsValid( const unsigned int, const unsigned int ) const final
+      {
+         return true;
+      }
+
+   private :
+
+      const DataAccess::Interface::ProjectHandle& m_projectHandle;
+   };
+
+   class OutputFingerprintsTest : public ::testing::Test
+   {
+   protected :
+
+      void SetUp() override
+      {
+         m_projectHandle.reset( DataAccess::Interface::OpenCauldronProject( "DBMProject.project3d", &m_factory ));
+         ASSERT_NE( m_projectHandle, nullptr );
+
+         m_snapshot = m_projectHandle->findSnapshot( 0.0 );
+         ASSERT_NE( m_snapshot, nullptr );
+
+         m_formation = m_projectHandle->findFormation( "Layer 1" );
+         ASSERT_NE( m_formation, nullptr );
+
+         m_temperature = m_projectHandle->findProperty( "Temperature" );
+         m_porosity = m_projectHandle->findProperty( "Porosity" );
+         m_bulkDensity = m_projectHandle->findProperty( "BulkDensity" );
+         ASSERT_NE( m_temperature, nullptr );
+         ASSERT_NE( m_porosity, nullptr );
+         ASSERT_NE( m_bulkDensity, nullptr );
+
+         m_propertyManager.reset( new DependencyPropertyManager( *m_projectHandle, { "Ves", "MaxVes" } ));
+
+         std::remove( FileName );
+      }
+
+      void TearDown() override
+      {
+         std::remove( FileName );
+      }
+
+      /// Write the fingerprints of the outputs of the three properties in the formation.
+      void save( const std::string& inputs )
+      {
+         OutputFingerprints fingerprints( FileName, inputs, *m_projectHandle, *m_propertyManager );
+
+         for ( const DataAccess::Interface::Property* property : { m_temperature, m_porosity, m_bulkDensity } )
+         {
+            EXPECT_FALSE( fingerprints.isUpToDate( m_snapshot, FormationSurface( m_formation, 0 ), property )) << property->getName();
+            fingerprints.update( m_snapshot, FormationSurface( m_formation, 0 ), property );
+         }
+
+         ASSERT_TRUE( fingerprints.save() );
+      }
+
+      static const char* const FileName;
+
+      GeoPhysics::ObjectFactory m_factory;
+      std::unique_ptr<DataAccess::Interface::ProjectHandle> m_projectHandle;
+      std::unique_ptr<DependencyPropertyManager> m_propertyManager;
+      const DataAccess::Interface::Snapshot* m_snapshot = nullptr;
+      const DataAccess::Interface::Formation* m_formation = nullptr;
+      const DataAccess::Interface::Property* m_temperature = nullptr;
+      const DataAccess::Interface::Property* m_porosity = nullptr;
+      const DataAccess::Interface::Property* m_bulkDensity = nullptr;
+   };
+
+   const char* const OutputFingerprintsTest::FileName = "OutputFingerprintsTest.fingerprints";
+}
+
+TEST_F( OutputFingerprintsTest, SaveAndLoad )
+{
+   OutputFingerprints missing( FileName, "fastcauldron 1", *m_projectHandle, *m_propertyManager );
+   EXPECT_FALSE( missing.load() );
+
+   save( "fastcauldron 1" );
+
+   OutputFingerprints fingerprints( FileName, "fastcauldron 1", *m_projectHandle, *m_propertyManager );
+   ASSERT_TRUE( fingerprints.load() );
+
+   for ( const DataAccess::Interface::Property* property : { m_temperature, m_porosity, m_bulkDensity } )
+   {
+      EXPECT_TRUE( fingerprints.isUpToDate( m_snapshot, FormationSurface( m_formation, 0 ), property )) << property->getName();
+   }
+
+   // Outputs that have not been written are not up to date
+   const DataAccess::Interface::Formation* otherFormation = m_projectHandle->findFormation( "Layer2" );
+   ASSERT_NE( otherFormation, nullptr );
+   EXPECT_FALSE( fingerprints.isUpToDate( m_snapshot, FormationSurface( otherFormation, 0 ), m_porosity ));
+   EXPECT_FALSE( fingerprints.isUpToDate( m_snapshot, FormationSurface( 0, m_formation->getTopSurface() ), m_porosity ));
+}
+
+TEST_F( OutputFingerprintsTest, SimulationChanged )
+{
+   save( "fastcauldron 1" );
+
+   OutputFingerprints fingerprints( FileName, "fastcauldron 2", *m_projectHandle, *m_propertyManager );
+   ASSERT_TRUE( fingerprints.load() );
+
+   for ( const DataAccess::Interface::Property* property : { m_temperature, m_porosity, m_bulkDensity } )
+   {
+      EXPECT_FALSE( fingerprints.isUpToDate( m_snapshot, FormationSurface( m_formation, 0 ), property )) << property->getName();
+   }
+}
+
+TEST_F( OutputFingerprintsTest, InputRecordChanged )
+{
+   save( "fastcauldron 1" );
+
+   database::Table* lithotypes = m_projectHandle->getTable( "LithotypeIoTbl" );
+   ASSERT_NE( lithotypes, nullptr );
+   ASSERT_GT( lithotypes->size(), 0u );
+
+   database::Record* lithotype = lithotypes->getRecord( 0 );
+   const double density = lithotype->getValue<double>( "Density" );
+   lithotype->setValue<double>( "Density", density + 1.0 );
+
+   {
+      OutputFingerprints fingerprints( FileName, "fastcauldron 1", *m_projectHandle, *m_propertyManager );
+      ASSERT_TRUE( fingerprints.load() );
+      EXPECT_FALSE( fingerprints.isUpToDate( m_snapshot, FormationSurface( m_formation, 0 ), m_bulkDensity ));
+   }
+
+   // The outputs are up to date again once the record has its original value
+   lithotype->setValue<double>( "Density", density );
+
+   OutputFingerprints fingerprints( FileName, "fastcauldron 1", *m_projectHandle, *m_propertyManager );
+   ASSERT_TRUE( fingerprints.load() );
+   EXPECT_TRUE( fingerprints.isUpToDate( m_snapshot, FormationSurface( m_formation, 0 ), m_bulkDensity ));
+}
+
+TEST_F( OutputFingerprintsTest, DependenciesChanged )
+{
+   save( "fastcauldron 1" );
+
+   // The porosity now also depends on the depth, and the bulk density through the porosity
+   DependencyPropertyManager propertyManager( *m_projectHandle, { "Ves", "MaxVes", "Depth" } );
+   OutputFingerprints fingerprints( FileName, "fastcauldron 1", *m_projectHandle, propertyManager );
+   ASSERT_TRUE( fingerprints.load() );
+
+   EXPECT_TRUE( fingerprints.isUpToDate( m_snapshot, FormationSurface( m_formation, 0 ), m_temperature ));
+   EXPECT_FALSE( fingerprints.isUpToDate( m_snapshot, FormationSurface( m_formation, 0 ), m_porosity ));
+   EXPECT_FALSE( fingerprints.isUpToDate( m_snapshot, FormationSurface( m_formation, 0 ), m_bulkDensity ));
+}
+
+TEST_F( OutputFingerprintsTest, Recompute )
+{
+   save( "fastcauldron 1" );
+
+   {
+      OutputFingerprints fingerprints( FileName, "fastcauldron 1", *m_projectHandle, *m_propertyManager );
+      ASSERT_TRUE( fingerprints.load() );
+      fingerprints.setRecompute( true );
+
+      EXPECT_FALSE( fingerprints.isUpToDate( m_snapshot, FormationSurface( m_formation, 0 ), m_porosity ));
+      fingerprints.update( m_snapshot, FormationSurface( m_formation, 0 ), m_porosity );
+      ASSERT_TRUE( fingerprints.save() );
+   }
+
+   // The recalculated outputs are skipped by the next run
+   OutputFingerprints fingerprints( FileName, "fastcauldron 1", *m_projectHandle, *m_propertyManager );
+   ASSERT_TRUE( fingerprints.load() );
+
+   for ( const DataAccess::Interface::Property* property : { m_temperature, m_porosity, m_bulkDensity } )
+   {
+      EXPECT_TRUE( fingerprints.isUpToDate( m_snapshot, FormationSurface( m_formation, 0 ), property )) << property->getName();
+   }
+}
@@ -0,0 +1,220 @@
+//
+// Copyright (C) 2015-2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#include "../src/PropertyTaskGraph.h"
+
+#include "DerivedFormationProperty.h"
+#include "FormationPropertyCalculator.h"
+
+#include "GeoPhysicsObjectFactory.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace AbstractDerivedProperties;
+
+namespace
+{
+   typedef std::map<const DataModel::AbstractFormation*, int> CalculationCounts;
+
+   /// The depth of a formation, read as if from file.
+   class InputCalculator : public FormationPropertyCalculator
+   {
+   public :
+
+      explicit InputCalculator( CalculationCounts& counts ) : m_counts( counts )
+      {
+         addPropertyName( "Depth" );
+      }
+
+      void calculate( AbstractPropertyManager&            propertyManager,
+                      const DataModel::AbstractSnapshot*  snapshot,
+                      const DataModel::AbstractFormation* formation,
+                      FormationPropertyList&              derivedProperties ) const final
+      {
+         ++m_counts[formation];
+
+         DerivedProperties::DerivedFormationPropertyPtr input( new DerivedProperties::DerivedFormationProperty(
+            propertyManager.getProperty( "Depth" ), snapshot, formation, propertyManager.getMapGrid(), 3 ));
+
+         for ( unsigned int i = input->firstI( true ); i <= input->lastI( true ); ++i )
+         {
+            for ( unsigned int j = input->firstJ( true ); j <= input->lastJ( true ); ++j )
+            {
+               for ( unsigned int k = input->firstK(); k <= input->lastK(); ++k )
+               {
+                  input->set( i, j, k, 1.0 );
+               }
+            }
+         }
+
+         derivedProperties.push_back( input );
+      }
+
+   private :
+
+      CalculationCounts& m_counts;
+   };
+
+   /// A value integrated down the column, starting from the values at the bottom of the formation above.
+   class IntegratedCalculator : public FormationPropertyCalculator
+   {
+   public :
+
+      explicit IntegratedCalculator( CalculationCounts& counts ) : m_counts( counts )
+      {
+         addPropertyName( "HydroStaticPressure" );
+         addDependentPropertyName( "Depth" );
+      }
+
+      void calculate( AbstractPropertyManager&            propertyManager,
+                      const DataModel::AbstractSnapshot*  snapshot,
+                      const DataModel::AbstractFormation* formation,
+                      FormationPropertyList&              derivedProperties ) const final
+      {
+         ++m_counts[formation];
+
+         const DataAccess::Interface::Formation* currentFormation = dynamic_cast<const DataAccess::Interface::Formation*>( formation );
+         const DataAccess::Interface::Snapshot* currentSnapshot = dynamic_cast<const DataAccess::Interface::Snapshot*>( snapshot );
+         const DataAccess::Interface::Surface* topSurface = currentFormation->getTopSurface();
+
+         FormationPropertyPtr integratedAbove;
+         if ( topSurface->getSnapshot() == 0 or topSurface->getSnapshot()->getTime() > currentSnapshot->getTime() )
+         {
+            integratedAbove = propertyManager.getFormationProperty( propertyManager.getProperty( "HydroStaticPressure" ), snapshot, topSurface->getTopFormation() );
+         }
+
+         const FormationPropertyPtr input = propertyManager.getFormationProperty( propertyManager.getProperty( "Depth" ), snapshot, formation );
+
+         DerivedProperties::DerivedFormationPropertyPtr integrated( new DerivedProperties::DerivedFormationProperty(
+            propertyManager.getProperty( "HydroStaticPressure" ), snapshot, formation, propertyManager.getMapGrid(), 3 ));
+
+         for ( unsigned int i = integrated->firstI( true ); i <= integrated->lastI( true ); ++i )
+         {
+            for ( unsigned int j = integrated->firstJ( true ); j <= integrated->lastJ( true ); ++j )
+            {
+               double value = integratedAbove != nullptr ? integratedAbove->get( i, j, 0 ) : 0.0;
+               integrated->set( i, j, integrated->lastK(), value );
+
+               for ( unsigned int k = integrated->lastK(); k > 0; --k )
+               {
+                  value += input->get( i, j, k );
+                  integrated->set( i, j, k - 1, value );
+               }
+            }
+         }
+
+         derivedProperties.push_back( integrated );
+      }
+
+      bool dependsOnFormationAbove() const final
+      {
+         return true;
+      }
+
+   private :
+
+      CalculationCounts& m_counts;
+   };
+
+   class TaskGraphPropertyManager : public AbstractPropertyManager
+   {
+   public :
+
+      explicit TaskGraphPropertyManager( const DataAccess::Interface::ProjectHandle& projectHandle ) :
+         m_projectHandle( projectHandle )
+      {
+         addFormationPropertyCalculator( FormationPropertyCalculatorPtr( new InputCalculator( m_inputCounts )));
+         addFormationPropertyCalculator( FormationPropertyCalculatorPtr( new IntegratedCalculator( m_integratedCounts )));
+      }
+
+      const DataModel::AbstractProperty* getProperty( const std::string& name ) const final
+      {
+         return m_projectHandle.findProperty( name );
+      }
+
+      const DataModel::AbstractGrid* getMapGrid() const final
+      {
+         return m_projectHandle.getLowResolutionOutputGrid();
+      }
+
+      bool getNodeIsValid( const unsigned int, const unsigned int ) const final
+      {
+         return true;
+      }
+
+      CalculationCounts m_inputCounts;
+      CalculationCounts m_integratedCounts;
+
+   private :
+
+      const DataAccess::Interface::ProjectHandle& m_projectHandle;
+   };
+}
+
+TEST( PropertyTaskGraph, ReleasedAfterFormationBelow )
+{
+   GeoPhysics::ObjectFactory factory;
+   std::unique_ptr<DataAccess::Interface::ProjectHandle> projectHandle( DataAccess::Interface::OpenCauldronProject( "DBMProject.project3d", &factory ));
+   ASSERT_NE( projectHandle, nullptr );
+
+   const DataAccess::Interface::Snapshot* snapshot = projectHandle->findSnapshot( 0.0 );
+   ASSERT_NE( snapshot, nullptr );
+
+   std::unique_ptr<DataAccess::Interface::FormationList> formations( projectHandle->getFormations( snapshot ));
+   ASSERT_EQ( formations->size(), 3u );
+
+   TaskGraphPropertyManager propertyManager( *projectHandle );
+   const DataAccess::Interface::Property* integrated = projectHandle->findProperty( "HydroStaticPressure" );
+   const DataAccess::Interface::Property* input = projectHandle->findProperty( "Depth" );
+   ASSERT_NE( integrated, nullptr );
+   ASSERT_NE( input, nullptr );
+
+   PropertyTaskGraph graph( propertyManager, snapshot );
+   for ( const DataAccess::Interface::Formation* formation : *formations )
+   {
+      graph.addOutput( FormationSurface( formation, 0 ), integrated );
+   }
+   ASSERT_EQ( graph.getFormationItems().size(), 3u );
+
+   const DataAccess::Interface::Formation* top = ( *formations )[0];
+   const DataAccess::Interface::Formation* middle = ( *formations )[1];
+   const DataAccess::Interface::Formation* bottom = ( *formations )[2];
+
+   // The integrated values of the top formation are kept for the formation below it, its input is not
+   ASSERT_NE( propertyManager.getFormationProperty( integrated, snapshot, top ), nullptr );
+   graph.outputDone( graph.getFormationItems()[0] );
+   EXPECT_TRUE( propertyManager.formationPropertyIsCalculated( integrated, snapshot, top ));
+   EXPECT_FALSE( propertyManager.formationPropertyIsCalculated( input, snapshot, top ));
+   EXPECT_EQ( graph.getNumberOfReleasedProperties(), 1u );
+
+   // Once the formation below has been output, the values of the top formation are released, and were not recalculated
+   ASSERT_NE( propertyManager.getFormationProperty( integrated, snapshot, middle ), nullptr );
+   graph.outputDone( graph.getFormationItems()[1] );
+   EXPECT_FALSE( propertyManager.formationPropertyIsCalculated( integrated, snapshot, top ));
+   EXPECT_TRUE( propertyManager.formationPropertyIsCalculated( integrated, snapshot, middle ));
+   EXPECT_EQ( propertyManager.m_integratedCounts[top], 1 );
+   EXPECT_EQ( propertyManager.m_inputCounts[top], 1 );
+
+   ASSERT_NE( propertyManager.getFormationProperty( integrated, snapshot, bottom ), nullptr );
+   graph.outputDone( graph.getFormationItems()[2] );
+   EXPECT_FALSE( propertyManager.formationPropertyIsCalculated( integrated, snapshot, middle ));
+   EXPECT_FALSE( propertyManager.formationPropertyIsCalculated( integrated, snapshot, bottom ));
+   EXPECT_EQ( graph.getNumberOfReleasedProperties(), 6u );
+
+   for ( const DataAccess::Interface::Formation* formation : *formations )
+   {
+      EXPECT_EQ( propertyManager.m_integratedCounts[formation], 1 ) << formation->getName();
+      EXPECT_EQ( propertyManager.m_inputCounts[formation], 1 ) << formation->getName();
+   }
+}
@@ -23,6 +23,29 @@ if (UNIX)
    set(cxxVersion "-std=c++17")
    MESSAGE(STATUS "CXX version is set to ${cxxVersion}")
 
+   # Instruction set for the SIMD specialisations in LinearAlgebra, e.g. the matrix products of the element assembly,
+   # and for the vectorised maths functions of utilities/src/SimdMathematics.h.
+   # The default leaves the choice to the compiler, which for GCC and Clang means SSE2 only.
+   set(BM_SIMD_TARGET "" CACHE STRING "Instruction set targetted by the GCC and Clang builds: SSE4, AVX2 or AVX512")
+   set_property(CACHE BM_SIMD_TARGET PROPERTY STRINGS "" SSE4 AVX2 AVX512)
+   set(simdTargetFlags)
+   if (NOT BM_USE_INTEL_COMPILER)
+      if (BM_SIMD_TARGET STREQUAL SSE4)
+         set(simdTargetFlags "-msse4.2")
+      elseif (BM_SIMD_TARGET STREQUAL AVX2)
+         set(simdTargetFlags "-mavx2 -mfma")
+      elseif (BM_SIMD_TARGET STREQUAL AVX512)
+         set(simdTargetFlags "-mavx512f -mavx2 -mfma")
+      elseif (NOT BM_SIMD_TARGET STREQUAL "")
+         message(FATAL_ERROR "Unknown SIMD target '${BM_SIMD_TARGET}', expected SSE4, AVX2 or AVX512")
+      endif()
+      if (simdTargetFlags)
+         MESSAGE(STATUS "SIMD target is set to ${BM_SIMD_TARGET}")
+         set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} ${simdTargetFlags}")
+         set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${simdTargetFlags}")
+      endif()
+   endif()
+
    #Release
    set(CMAKE_C_FLAGS_RELEASE "-g -O2 ${strictFpModel} -DNDEBUG" CACHE STRING "List of C compiler flags for a Release build")
    set(CMAKE_CXX_FLAGS_RELEASE "-g -O2 ${strictFpModel} ${cxxVersion} -DNDEBUG" CACHE STRING "List of C++ compiler flags for a Release build")
@@ -14,8 +14,6 @@
 #include <iostream>
 using namespace std;
 
-#include "PropertyErasePredicate.h"
-
 // Surface property calcualtors with offset.
 #include "FormationSurfacePropertyOffsetCalculator.h"
 #include "SurfacePropertyOffsetCalculator.h"
@@ -23,6 +21,22 @@ using namespace std;
 // utility library
 #include "LogHandler.h"
 
+namespace {
+
+   /// \brief Estimate the number of bytes used by the values of a map property.
+   template<typename PropertyValues>
+   size_t getNumberOfBytes ( const PropertyValues& values ) {
+      return static_cast<size_t>( values.lastI ( true ) - values.firstI ( true ) + 1 ) *
+             static_cast<size_t>( values.lastJ ( true ) - values.firstJ ( true ) + 1 ) * sizeof ( double );
+   }
+
+   /// \brief Estimate the number of bytes used by the values of a formation property.
+   size_t getNumberOfBytes ( const AbstractDerivedProperties::FormationProperty& values ) {
+      return getNumberOfBytes<AbstractDerivedProperties::FormationProperty>( values ) * static_cast<size_t>( values.lastK () - values.firstK () + 1 );
+   }
+
+}
+
 void AbstractDerivedProperties::AbstractPropertyManager::addSurfacePropertyCalculator ( const SurfacePropertyCalculatorPtr& calculator ) {
 
    const std::vector<std::string>& propertyNames = calculator->getPropertyNames ();
@@ -190,114 +204,103 @@ AbstractDerivedProperties::ReservoirPropertyCalculatorPtr AbstractDerivedPropert
 }
 
 
-void AbstractDerivedProperties::AbstractPropertyManager::addSurfaceProperty ( const SurfacePropertyPtr& surfaceProperty ) {
-   m_surfaceProperties.push_back ( surfaceProperty );
-}
+void AbstractDerivedProperties::AbstractPropertyManager::addSurfaceProperty ( const SurfacePropertyPtr& surfaceProperty, const double cost ) {
 
-void AbstractDerivedProperties::AbstractPropertyManager::addFormationMapProperty ( const FormationMapPropertyPtr& formationMapProperty ) {
-   m_formationMapProperties.push_back ( formationMapProperty );
-}
+   if ( surfaceProperty == nullptr ) {
+      return;
+   }
 
-void AbstractDerivedProperties::AbstractPropertyManager::addFormationProperty ( const FormationPropertyPtr& formationProperty ) {
-   m_formationProperties.push_back ( formationProperty );
-}
+   const CacheKey key ( SURFACE_VALUES, surfaceProperty->getProperty (), surfaceProperty->getSnapshot (), surfaceProperty->getSurface (), nullptr );
 
-void AbstractDerivedProperties::AbstractPropertyManager::addFormationSurfaceProperty ( const FormationSurfacePropertyPtr& formationSurfaceProperty ) {
-   m_formationSurfaceProperties.push_back ( formationSurfaceProperty );
-}
+   if ( addCacheEntry ( key, surfaceProperty, getNumberOfBytes ( *surfaceProperty ), cost )) {
+      evictCacheEntries ();
+   }
 
-void AbstractDerivedProperties::AbstractPropertyManager::addReservoirProperty ( const ReservoirPropertyPtr& reservoirProperty ) {
-   m_reservoirProperties.push_back ( reservoirProperty );
 }
 
+void AbstractDerivedProperties::AbstractPropertyManager::addFormationMapProperty ( const FormationMapPropertyPtr& formationMapProperty, const double cost ) {
 
-AbstractDerivedProperties::SurfacePropertyPtr AbstractDerivedProperties::AbstractPropertyManager::findSurfacePropertyValues ( const DataModel::AbstractProperty* property,
-                                                                                                              const DataModel::AbstractSnapshot* snapshot,
-                                                                                                              const DataModel::AbstractSurface*  surface ) const {
+   const CacheKey key ( FORMATION_MAP_VALUES, formationMapProperty->getProperty (), formationMapProperty->getSnapshot (), formationMapProperty->getFormation (), nullptr );
 
-   for ( size_t i = 0; i < m_surfaceProperties.size (); ++i ) {
+   if ( addCacheEntry ( key, formationMapProperty, getNumberOfBytes ( *formationMapProperty ), cost )) {
+      evictCacheEntries ();
+   }
 
-      if ( m_surfaceProperties [ i ]->getProperty () == property and
-           m_surfaceProperties [ i ]->getSnapshot () == snapshot and
-           m_surfaceProperties [ i ]->getSurface  () == surface ) {
-         return m_surfaceProperties [ i ];
-      }
+}
+
+void AbstractDerivedProperties::AbstractPropertyManager::addFormationProperty ( const FormationPropertyPtr& formationProperty, const double cost ) {
+
+   const CacheKey key ( FORMATION_VALUES, formationProperty->getProperty (), formationProperty->getSnapshot (), formationProperty->getFormation (), nullptr );
 
+   if ( addCacheEntry ( key, formationProperty, getNumberOfBytes ( *formationProperty ), cost )) {
+      evictCacheEntries ();
    }
 
-   return SurfacePropertyPtr ();
 }
 
-AbstractDerivedProperties::FormationMapPropertyPtr AbstractDerivedProperties::AbstractPropertyManager::findFormationMapPropertyValues ( const DataModel::AbstractProperty*  property,
-                                                                                                                        const DataModel::AbstractSnapshot*  snapshot,
-                                                                                                                        const DataModel::AbstractFormation* formation ) const {
+void AbstractDerivedProperties::AbstractPropertyManager::addFormationSurfaceProperty ( const FormationSurfacePropertyPtr& formationSurfaceProperty, const double cost ) {
 
-   for ( size_t i = 0; i < m_formationMapProperties.size (); ++i ) {
-
-      if ( m_formationMapProperties [ i ]->getProperty () == property and
-           m_formationMapProperties [ i ]->getSnapshot () == snapshot and
-           m_formationMapProperties [ i ]->getFormation() == formation ) {
-         return m_formationMapProperties [ i ];
-      }
+   const CacheKey key ( FORMATION_SURFACE_VALUES, formationSurfaceProperty->getProperty (), formationSurfaceProperty->getSnapshot (),
+                        formationSurfaceProperty->getFormation (), formationSurfaceProperty->getSurface ());
 
+   if ( addCacheEntry ( key, formationSurfaceProperty, getNumberOfBytes ( *formationSurfaceProperty ), cost )) {
+      evictCacheEntries ();
    }
 
-   return FormationMapPropertyPtr ();
 }
 
+void AbstractDerivedProperties::AbstractPropertyManager::addReservoirProperty ( const ReservoirPropertyPtr& reservoirProperty, const double cost ) {
 
-AbstractDerivedProperties::FormationPropertyPtr AbstractDerivedProperties::AbstractPropertyManager::findFormationPropertyValues ( const DataModel::AbstractProperty*  property,
-                                                                                                                  const DataModel::AbstractSnapshot*  snapshot,
-                                                                                                                  const DataModel::AbstractFormation* formation ) const {
+   const CacheKey key ( RESERVOIR_VALUES, reservoirProperty->getProperty (), reservoirProperty->getSnapshot (), reservoirProperty->getReservoir (), nullptr );
+
+   if ( addCacheEntry ( key, reservoirProperty, getNumberOfBytes ( *reservoirProperty ), cost )) {
+      evictCacheEntries ();
+   }
 
-   for ( size_t i = 0; i < m_formationProperties.size (); ++i ) {
+}
 
-      if ( m_formationProperties [ i ]->getProperty () == property and
-           m_formationProperties [ i ]->getSnapshot () == snapshot and
-           m_formationProperties [ i ]->getFormation() == formation ) {
-         return m_formationProperties [ i ];
-      }
 
+template<typename PropertyPtr>
+PropertyPtr AbstractDerivedProperties::AbstractPropertyManager::findCachedValues ( const CacheKey& key ) const {
+
+   const CacheEntryMap::const_iterator entry = m_cacheEntries.find ( key );
+
+   if ( entry == m_cacheEntries.end ()) {
+      return PropertyPtr ();
    }
 
-   return FormationPropertyPtr ();
+   return std::static_pointer_cast<typename PropertyPtr::element_type>( entry->second.values );
+}
+
+AbstractDerivedProperties::SurfacePropertyPtr AbstractDerivedProperties::AbstractPropertyManager::findSurfacePropertyValues ( const DataModel::AbstractProperty* property,
+                                                                                                              const DataModel::AbstractSnapshot* snapshot,
+                                                                                                              const DataModel::AbstractSurface*  surface ) const {
+   return findCachedValues<SurfacePropertyPtr> ( CacheKey ( SURFACE_VALUES, property, snapshot, surface, nullptr ));
+}
+
+AbstractDerivedProperties::FormationMapPropertyPtr AbstractDerivedProperties::AbstractPropertyManager::findFormationMapPropertyValues ( const DataModel::AbstractProperty*  property,
+                                                                                                                        const DataModel::AbstractSnapshot*  snapshot,
+                                                                                                                        const DataModel::AbstractFormation* formation ) const {
+   return findCachedValues<FormationMapPropertyPtr> ( CacheKey ( FORMATION_MAP_VALUES, property, snapshot, formation, nullptr ));
 }
 
+AbstractDerivedProperties::FormationPropertyPtr AbstractDerivedProperties::AbstractPropertyManager::findFormationPropertyValues ( const DataModel::AbstractProperty*  property,
+                                                                                                                  const DataModel::AbstractSnapshot*  snapshot,
+                                                                                                                  const DataModel::AbstractFormation* formation ) const {
+   return findCachedValues<FormationPropertyPtr> ( CacheKey ( FORMATION_VALUES, property, snapshot, formation, nullptr ));
+}
 
 AbstractDerivedProperties::FormationSurfacePropertyPtr AbstractDerivedProperties::AbstractPropertyManager::findFormationSurfacePropertyValues ( const DataModel::AbstractProperty*  property,
                                                                                                                                 const DataModel::AbstractSnapshot*  snapshot,
                                                                                                                                 const DataModel::AbstractFormation* formation,
                                                                                                                                 const DataModel::AbstractSurface*   surface ) const {
-
-   for ( size_t i = 0; i < m_formationSurfaceProperties.size (); ++i ) {
-
-      if ( m_formationSurfaceProperties [ i ]->getProperty () == property and
-           m_formationSurfaceProperties [ i ]->getSnapshot () == snapshot and
-           m_formationSurfaceProperties [ i ]->getFormation() == formation and
-           m_formationSurfaceProperties [ i ]->getSurface()   == surface ) {
-         return m_formationSurfaceProperties [ i ];
-      }
-
-   }
-
-   return FormationSurfacePropertyPtr ();
+   return findCachedValues<FormationSurfacePropertyPtr> ( CacheKey ( FORMATION_SURFACE_VALUES, property, snapshot, formation, surface ));
 }
 
 AbstractDerivedProperties::ReservoirPropertyPtr AbstractDerivedProperties::AbstractPropertyManager::findReservoirPropertyValues ( const DataModel::AbstractProperty*  property,
                                                                                                                   const DataModel::AbstractSnapshot*  snapshot,
                                                                                                                   const DataModel::AbstractReservoir* reservoir ) const {
-
-   for ( size_t i = 0; i < m_reservoirProperties.size (); ++i ) {
-
-      if ( m_reservoirProperties [ i ]->getProperty  () == property  and
-           m_reservoirProperties [ i ]->getSnapshot  () == snapshot  and
-           m_reservoirProperties [ i ]->getReservoir () == reservoir ) {
-         return m_reservoirProperties [ i ];
-      }
-
-   }
-
-   return ReservoirPropertyPtr ();
+   return findCachedValues<ReservoirPropertyPtr> ( CacheKey ( RESERVOIR_VALUES, property, snapshot, reservoir, nullptr ));
 }
 
 
@@ -310,31 +313,56 @@ AbstractDerivedProperties::SurfacePropertyPtr AbstractDerivedProperties::Abstrac
    if ( property->getPropertyAttribute () == DataModel::CONTINUOUS_3D_PROPERTY or
         property->getPropertyAttribute () == DataModel::SURFACE_2D_PROPERTY ) {
 
+      const CacheKey key ( SURFACE_VALUES, property, snapshot, surface, nullptr );
+      const bool requestedByCalculator = m_calculationDepth > 0;
+
       result = findSurfacePropertyValues ( property, snapshot, surface );
+      useCacheEntry ( key, result != nullptr );
 
       if ( result == 0 ) {
          const SurfacePropertyCalculatorPtr calculator = getSurfaceCalculator ( property );
          SurfacePropertyList  calculatedProperties;
 
          if ( calculator != 0 ) {
-            calculator->calculate ( *this, snapshot, surface, calculatedProperties );
+            const size_t calculations = m_cacheStatistics.calculations++;
 
-            for ( SurfacePropertyPtr calculatedProperty : calculatedProperties )
             {
-               addSurfaceProperty ( calculatedProperty );
+               const ScopedCount calculation ( m_calculationDepth );
+               calculator->calculate ( *this, snapshot, surface, calculatedProperties );
+            }
 
-               if ( calculatedProperty and calculatedProperty->getProperty() == property ) {
-                     result = calculatedProperty;
-               }
+            // The cost of the values includes the calculation of the values these depend on.
+            const double cost = static_cast<double>( m_cacheStatistics.calculations - calculations );
+
+            // The values calculated together are all added before any values are evicted, and are all kept.
+            const size_t firstCalculatedUse = m_useCount + 1;
+
+            {
+               const ScopedCount deferEvictions ( m_deferredEvictions );
+
+               for ( SurfacePropertyPtr calculatedProperty : calculatedProperties )
+               {
+                  addSurfaceProperty ( calculatedProperty, cost );
+
+                  if ( calculatedProperty and calculatedProperty->getProperty() == property ) {
+                        result = calculatedProperty;
+                  }
 
+               }
             }
 
+            evictCacheEntries ( firstCalculatedUse );
+
          } else {
             LogHandler( LogHandler::DEBUG_SEVERITY ) << "Derived property " << property->getName() << " @ snapshot " << snapshot->getTime() << " already computed.";
          }
 
       }
 
+      if ( requestedByCalculator ) {
+         countDependentUse ( key );
+      }
+
    }
    else{
       throw AbstractPropertyException() << "Could not compute surface derived property " << property->getName() << " @ snapshot " << snapshot->getTime() << ":"
@@ -352,31 +380,56 @@ AbstractDerivedProperties::FormationMapPropertyPtr AbstractDerivedProperties::Ab
 
    if ( property->getPropertyAttribute () == DataModel::FORMATION_2D_PROPERTY ) {
 
+      const CacheKey key ( FORMATION_MAP_VALUES, property, snapshot, formation, nullptr );
+      const bool requestedByCalculator = m_calculationDepth > 0;
+
       result = findFormationMapPropertyValues ( property, snapshot, formation );
+      useCacheEntry ( key, result != nullptr );
 
       if ( result == 0 ) {
          const FormationMapPropertyCalculatorPtr calculator = getFormationMapCalculator ( property );
          FormationMapPropertyList  calculatedProperties;
 
          if ( calculator != 0 ) {
-            calculator->calculate ( *this, snapshot, formation, calculatedProperties );
+            const size_t calculations = m_cacheStatistics.calculations++;
 
-            for ( FormationMapPropertyPtr calculatedProperty : calculatedProperties )
             {
-               addFormationMapProperty ( calculatedProperty );
+               const ScopedCount calculation ( m_calculationDepth );
+               calculator->calculate ( *this, snapshot, formation, calculatedProperties );
+            }
 
-               if ( calculatedProperty->getProperty () == property ) {
-                  result = calculatedProperty;
-               }
+            // The cost of the values includes the calculation of the values these depend on.
+            const double cost = static_cast<double>( m_cacheStatistics.calculations - calculations );
+
+            // The values calculated together are all added before any values are evicted, and are all kept.
+            const size_t firstCalculatedUse = m_useCount + 1;
+
+            {
+               const ScopedCount deferEvictions ( m_deferredEvictions );
+
+               for ( FormationMapPropertyPtr calculatedProperty : calculatedProperties )
+               {
+                  addFormationMapProperty ( calculatedProperty, cost );
+
+                  if ( calculatedProperty->getProperty () == property ) {
+                     result = calculatedProperty;
+                  }
 
+               }
             }
 
+            evictCacheEntries ( firstCalculatedUse );
+
          } else {
             LogHandler( LogHandler::DEBUG_SEVERITY ) << "Derived property " << property->getName() << " @ snapshot " << snapshot->getTime() << " already computed.";
          }
 
       }
 
+      if ( requestedByCalculator ) {
+         countDependentUse ( key );
+      }
+
    }
 
    else{
@@ -396,7 +449,11 @@ AbstractDerivedProperties::FormationPropertyPtr AbstractDerivedProperties::Abstr
    if ( property->getPropertyAttribute () == DataModel::CONTINUOUS_3D_PROPERTY or
         property->getPropertyAttribute () == DataModel::DISCONTINUOUS_3D_PROPERTY ) {
 
+      const CacheKey key ( FORMATION_VALUES, property, snapshot, formation, nullptr );
+      const bool requestedByCalculator = m_calculationDepth > 0;
+
       result = findFormationPropertyValues ( property, snapshot, formation );
+      useCacheEntry ( key, result != nullptr );
 
       if ( result == 0 ) {
          const FormationPropertyCalculatorPtr calculator = getFormationCalculator ( property );
@@ -404,17 +461,35 @@ AbstractDerivedProperties::FormationPropertyPtr AbstractDerivedProperties::Abstr
 
          if ( calculator )
          {
-             calculator->calculate ( *this, snapshot, formation, calculatedProperties );
+            const size_t calculations = m_cacheStatistics.calculations++;
+
+            {
+               const ScopedCount calculation ( m_calculationDepth );
+               calculator->calculate ( *this, snapshot, formation, calculatedProperties );
+            }
+
+            // The cost of the values includes the calculation of the values these depend on.
+            const double cost = static_cast<double>( m_cacheStatistics.calculations - calculations );
+
+            // The values calculated together are all added before any values are evicted, and are all kept.
+            const size_t firstCalculatedUse = m_useCount + 1;
 
-            for ( FormationPropertyPtr calculatedProperty : calculatedProperties )
             {
-               addFormationProperty ( calculatedProperty );
+               const ScopedCount deferEvictions ( m_deferredEvictions );
+
+               for ( FormationPropertyPtr calculatedProperty : calculatedProperties )
+               {
+                  addFormationProperty ( calculatedProperty, cost );
 
-               if ( calculatedProperty->getProperty () == property ) {
-                  result = calculatedProperty;
+                  // A calculator may also return the values of other formations, e.g. those above in the same column.
+                  if ( calculatedProperty->getProperty () == property and calculatedProperty->getFormation () == formation ) {
+                     result = calculatedProperty;
+                  }
                }
             }
 
+            evictCacheEntries ( firstCalculatedUse );
+
          } else {
             LogHandler( LogHandler::DEBUG_SEVERITY ) << "Derived property " << property->getName()
                << " @ snapshot " << snapshot->getTime() << "Ma for formation " << formation->getName() << " already computed.";
@@ -422,6 +497,10 @@ AbstractDerivedProperties::FormationPropertyPtr AbstractDerivedProperties::Abstr
 
       }
 
+      if ( requestedByCalculator ) {
+         countDependentUse ( key );
+      }
+
    }
 
    else{
@@ -443,31 +522,56 @@ AbstractDerivedProperties::FormationSurfacePropertyPtr AbstractDerivedProperties
 
    if ( property->getPropertyAttribute () == DataModel::DISCONTINUOUS_3D_PROPERTY ) {
 
+      const CacheKey key ( FORMATION_SURFACE_VALUES, property, snapshot, formation, surface );
+      const bool requestedByCalculator = m_calculationDepth > 0;
+
       result = findFormationSurfacePropertyValues ( property, snapshot, formation, surface );
+      useCacheEntry ( key, result != nullptr );
 
       if ( result == 0 ) {
          const FormationSurfacePropertyCalculatorPtr calculator = getFormationSurfaceCalculator ( property );
          FormationSurfacePropertyList  calculatedProperties;
 
          if ( calculator != 0 ) {
-            calculator->calculate ( *this, snapshot, formation, surface, calculatedProperties );
+            const size_t calculations = m_cacheStatistics.calculations++;
 
-            for ( FormationSurfacePropertyPtr calculatedProperty : calculatedProperties )
             {
-               addFormationSurfaceProperty ( calculatedProperty );
+               const ScopedCount calculation ( m_calculationDepth );
+               calculator->calculate ( *this, snapshot, formation, surface, calculatedProperties );
+            }
 
-               if ( calculatedProperty->getProperty () == property ) {
-                  result = calculatedProperty;
-               }
+            // The cost of the values includes the calculation of the values these depend on.
+            const double cost = static_cast<double>( m_cacheStatistics.calculations - calculations );
+
+            // The values calculated together are all added before any values are evicted, and are all kept.
+            const size_t firstCalculatedUse = m_useCount + 1;
+
+            {
+               const ScopedCount deferEvictions ( m_deferredEvictions );
 
+               for ( FormationSurfacePropertyPtr calculatedProperty : calculatedProperties )
+               {
+                  addFormationSurfaceProperty ( calculatedProperty, cost );
+
+                  if ( calculatedProperty->getProperty () == property ) {
+                     result = calculatedProperty;
+                  }
+
+               }
             }
 
+            evictCacheEntries ( firstCalculatedUse );
+
          } else {
             LogHandler( LogHandler::DEBUG_SEVERITY ) << "Derived property " << property->getName() << " @ snapshot " << snapshot->getTime() << " already computed.";
          }
 
       }
 
+      if ( requestedByCalculator ) {
+         countDependentUse ( key );
+      }
+
    }
 
    else{
@@ -486,31 +590,56 @@ AbstractDerivedProperties::ReservoirPropertyPtr AbstractDerivedProperties::Abstr
 
    if ( property->getPropertyAttribute () == DataModel::FORMATION_2D_PROPERTY ) {
 
+      const CacheKey key ( RESERVOIR_VALUES, property, snapshot, reservoir, nullptr );
+      const bool requestedByCalculator = m_calculationDepth > 0;
+
       result = findReservoirPropertyValues ( property, snapshot, reservoir );
+      useCacheEntry ( key, result != nullptr );
 
       if ( result == 0 ) {
          const ReservoirPropertyCalculatorPtr calculator = getReservoirCalculator ( property );
          ReservoirPropertyList  calculatedProperties;
 
          if ( calculator != 0 ) {
-            calculator->calculate ( *this, snapshot, reservoir, calculatedProperties );
+            const size_t calculations = m_cacheStatistics.calculations++;
 
-            for ( ReservoirPropertyPtr calculatedProperty : calculatedProperties )
             {
-               addReservoirProperty ( calculatedProperty );
+               const ScopedCount calculation ( m_calculationDepth );
+               calculator->calculate ( *this, snapshot, reservoir, calculatedProperties );
+            }
 
-               if ( calculatedProperty->getProperty () == property ) {
-                  result = calculatedProperty;
-               }
+            // The cost of the values includes the calculation of the values these depend on.
+            const double cost = static_cast<double>( m_cacheStatistics.calculations - calculations );
+
+            // The values calculated together are all added before any values are evicted, and are all kept.
+            const size_t firstCalculatedUse = m_useCount + 1;
+
+            {
+               const ScopedCount deferEvictions ( m_deferredEvictions );
+
+               for ( ReservoirPropertyPtr calculatedProperty : calculatedProperties )
+               {
+                  addReservoirProperty ( calculatedProperty, cost );
+
+                  if ( calculatedProperty->getProperty () == property ) {
+                     result = calculatedProperty;
+                  }
 
+               }
             }
 
+            evictCacheEntries ( firstCalculatedUse );
+
          } else {
             LogHandler( LogHandler::DEBUG_SEVERITY ) << "Derived property " << property->getName() << " @ snapshot " << snapshot->getTime() << " already computed.";
          }
 
       }
 
+      if ( requestedByCalculator ) {
+         countDependentUse ( key );
+      }
+
    }
 
    else{
@@ -523,31 +652,178 @@ AbstractDerivedProperties::ReservoirPropertyPtr AbstractDerivedProperties::Abstr
 
 void AbstractDerivedProperties::AbstractPropertyManager::removeProperties ( const DataModel::AbstractSnapshot* snapshot ) {
 
-   // Remove formation properties at snapshot time.
-   FormationPropertyList::iterator formationsToRemove = std::remove_if ( m_formationProperties.begin (), m_formationProperties.end (),
-                                                                         PropertyErasePredicate<FormationPropertyPtr> ( snapshot ));
-   m_formationProperties.erase ( formationsToRemove, m_formationProperties.end ());
+   // Remove all property values at snapshot time.
+   for ( CacheEntryMap::iterator entry = m_cacheEntries.begin (); entry != m_cacheEntries.end (); ) {
+
+      if ( std::get<2>( entry->first ) == snapshot ) {
+         removeCacheEntry ( entry++ );
+      } else {
+         ++entry;
+      }
+
+   }
+
+   for ( std::set<CacheKey>::iterator key = m_evictedKeys.begin (); key != m_evictedKeys.end (); ) {
+
+      if ( std::get<2>( *key ) == snapshot ) {
+         key = m_evictedKeys.erase ( key );
+      } else {
+         ++key;
+      }
+
+   }
+
+}
+
+bool AbstractDerivedProperties::AbstractPropertyManager::formationPropertyIsCalculated ( const DataModel::AbstractProperty*  property,
+                                                                                         const DataModel::AbstractSnapshot*  snapshot,
+                                                                                         const DataModel::AbstractFormation* formation ) const {
+   return findFormationPropertyValues ( property, snapshot, formation ) != nullptr;
+}
+
+void AbstractDerivedProperties::AbstractPropertyManager::getDependentPropertyNames ( const DataModel::AbstractProperty* property,
+                                                                                    std::vector<std::string>&          dependentNames ) const {
+
+   dependentNames.clear ();
+
+   if ( const FormationPropertyCalculatorPtr calculator = getFormationCalculator ( property )) {
+      dependentNames = calculator->getDependentPropertyNames ();
+   } else if ( const FormationMapPropertyCalculatorPtr calculator = getFormationMapCalculator ( property )) {
+      dependentNames = calculator->getDependentPropertyNames ();
+   } else if ( const SurfacePropertyCalculatorPtr calculator = getSurfaceCalculator ( property )) {
+      dependentNames = calculator->getDependentPropertyNames ();
+   } else if ( const FormationSurfacePropertyCalculatorPtr calculator = getFormationSurfaceCalculator ( property )) {
+      dependentNames = calculator->getDependentPropertyNames ();
+   } else if ( const ReservoirPropertyCalculatorPtr calculator = getReservoirCalculator ( property )) {
+      dependentNames = calculator->getDependentPropertyNames ();
+   }
+
+}
+
+bool AbstractDerivedProperties::AbstractPropertyManager::formationPropertyDependsOnFormationAbove ( const DataModel::AbstractProperty* property ) const {
+
+   const FormationPropertyCalculatorPtr calculator = getFormationCalculator ( property );
+   return calculator != nullptr and calculator->dependsOnFormationAbove ();
+}
+
+void AbstractDerivedProperties::AbstractPropertyManager::removeFormationProperty ( const DataModel::AbstractProperty*  property,
+                                                                                  const DataModel::AbstractSnapshot*  snapshot,
+                                                                                  const DataModel::AbstractFormation* formation ) {
+
+   const CacheEntryMap::iterator entry = m_cacheEntries.find ( CacheKey ( FORMATION_VALUES, property, snapshot, formation, nullptr ));
+
+   if ( entry != m_cacheEntries.end ()) {
+      removeCacheEntry ( entry );
+   }
 
-   // Remove formation-surface properties at snapshot time.
-   FormationSurfacePropertyList::iterator formationSurfacesToRemove = std::remove_if ( m_formationSurfaceProperties.begin (), m_formationSurfaceProperties.end (),
-                                                                                       PropertyErasePredicate<FormationSurfacePropertyPtr> ( snapshot ));
-   m_formationSurfaceProperties.erase ( formationSurfacesToRemove, m_formationSurfaceProperties.end ());
+}
+
+void AbstractDerivedProperties::AbstractPropertyManager::setMemoryLimit ( const size_t numberOfBytes ) {
+   m_memoryLimit = numberOfBytes;
+   evictCacheEntries ();
+}
 
-   // Remove formation-map properties at snapshot time.
-   FormationMapPropertyList::iterator formationMapsToRemove = std::remove_if ( m_formationMapProperties.begin (), m_formationMapProperties.end (),
-                                                                               PropertyErasePredicate<FormationMapPropertyPtr> ( snapshot ));
-   m_formationMapProperties.erase ( formationMapsToRemove, m_formationMapProperties.end ());
+size_t AbstractDerivedProperties::AbstractPropertyManager::getMemoryLimit () const {
+   return m_memoryLimit;
+}
+
+const AbstractDerivedProperties::AbstractPropertyManager::CacheStatistics& AbstractDerivedProperties::AbstractPropertyManager::getCacheStatistics () const {
+   return m_cacheStatistics;
+}
+
+bool AbstractDerivedProperties::AbstractPropertyManager::addCacheEntry ( const CacheKey& key, const AbstractPropertyValuesPtr& values, const size_t numberOfBytes, const double cost ) {
+
+   if ( m_cacheEntries.find ( key ) != m_cacheEntries.end ()) {
+      return false;
+   }
 
-   // Remove surface properties at snapshot time.
-   SurfacePropertyList::iterator surfacesToRemove = std::remove_if ( m_surfaceProperties.begin (), m_surfaceProperties.end (),
-                                                                     PropertyErasePredicate<SurfacePropertyPtr> ( snapshot ));
-   m_surfaceProperties.erase ( surfacesToRemove, m_surfaceProperties.end ());
+   // Until the values are used again, the reuse distance is estimated as the number of values cached.
+   const CacheEntry entry = { values, numberOfBytes, ++m_useCount, m_cacheEntries.size () + 1, 0, cost, 0.0 };
+   prioritiseCacheEntry ( *m_cacheEntries.insert ( std::make_pair ( key, entry )).first );
+   m_evictedKeys.erase ( key );
+
+   m_cacheStatistics.memoryInUse += numberOfBytes;
+   m_cacheStatistics.peakMemory = std::max ( m_cacheStatistics.peakMemory, m_cacheStatistics.memoryInUse );
+   return true;
+}
+
+void AbstractDerivedProperties::AbstractPropertyManager::useCacheEntry ( const CacheKey& key, const bool found ) {
+
+   if ( found ) {
+      ++m_cacheStatistics.hits;
+      CacheEntryMap::iterator entry = m_cacheEntries.find ( key );
+
+      if ( entry != m_cacheEntries.end ()) {
+         entry->second.reuseDistance = m_useCount + 1 - entry->second.lastUse;
+         entry->second.lastUse = ++m_useCount;
+         prioritiseCacheEntry ( *entry );
+      }
+
+   } else {
+      ++m_cacheStatistics.misses;
+
+      if ( m_evictedKeys.find ( key ) != m_evictedKeys.end ()) {
+         ++m_cacheStatistics.recalculations;
+      }
+
+   }
 
-   // Remove reservoir properties at snapshot time.
-   ReservoirPropertyList::iterator reservoirsToRemove = std::remove_if ( m_reservoirProperties.begin (), m_reservoirProperties.end (),
-                                                                         PropertyErasePredicate<ReservoirPropertyPtr> ( snapshot ));
-   m_reservoirProperties.erase ( reservoirsToRemove, m_reservoirProperties.end ());
+}
+
+void AbstractDerivedProperties::AbstractPropertyManager::countDependentUse ( const CacheKey& key ) {
+
+   CacheEntryMap::iterator entry = m_cacheEntries.find ( key );
+
+   if ( entry != m_cacheEntries.end ()) {
+      ++entry->second.dependentUses;
+      prioritiseCacheEntry ( *entry );
+   }
+
+}
+
+void AbstractDerivedProperties::AbstractPropertyManager::prioritiseCacheEntry ( CacheEntryMap::value_type& entry ) {
+
+   CacheEntry& values = entry.second;
+   const double numberOfBytes = static_cast<double>( std::max<size_t> ( values.numberOfBytes, 1 ));
+
+   m_evictionOrder.erase ( std::make_pair ( values.priority, entry.first ));
+   values.priority = m_inflation + values.cost * static_cast<double>( 1 + values.dependentUses ) / ( numberOfBytes * static_cast<double>( values.reuseDistance ));
+   m_evictionOrder.insert ( std::make_pair ( values.priority, entry.first ));
+}
+
+void AbstractDerivedProperties::AbstractPropertyManager::evictCacheEntries () {
+   evictCacheEntries ( m_useCount );
+}
+
+void AbstractDerivedProperties::AbstractPropertyManager::evictCacheEntries ( const size_t firstProtectedUse ) {
+
+   if ( m_memoryLimit == 0 or m_deferredEvictions > 0 ) {
+      return;
+   }
+
+   CacheEvictionOrder::iterator candidate = m_evictionOrder.begin ();
+
+   while ( m_cacheStatistics.memoryInUse > m_memoryLimit and candidate != m_evictionOrder.end ()) {
+      const CacheEntryMap::iterator entry = m_cacheEntries.find ( candidate->second );
+      ++candidate;
+
+      if ( entry->second.lastUse >= firstProtectedUse ) {
+         continue;
+      }
+
+      LogHandler( LogHandler::DEBUG_SEVERITY ) << "Removing derived property values of " << entry->second.numberOfBytes << " bytes to stay within the memory limit.";
+      m_inflation = entry->second.priority;
+      ++m_cacheStatistics.evictions;
+      m_evictedKeys.insert ( entry->first );
+      removeCacheEntry ( entry );
+   }
+
+}
 
+void AbstractDerivedProperties::AbstractPropertyManager::removeCacheEntry ( CacheEntryMap::iterator entry ) {
+   m_cacheStatistics.memoryInUse -= entry->second.numberOfBytes;
+   m_evictionOrder.erase ( std::make_pair ( entry->second.priority, entry->first ));
+   m_cacheEntries.erase ( entry );
 }
 
 bool AbstractDerivedProperties::AbstractPropertyManager::formationPropertyIsComputable ( const DataModel::AbstractProperty*  property,
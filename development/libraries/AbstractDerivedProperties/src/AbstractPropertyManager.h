@@ -1,410 +1,558 @@
-//
-// Copyright (C) 2015-2018 Shell International Exploration & Production.
-// All rights reserved.
-//
-// Developed under license for Shell by PDS BV.
-//
-// Confidential and proprietary source code of Shell.
-// Do not distribute without written permission from Shell.
-//
-
-#ifndef ABSTRACTDERIVED_PROPERTIES__ABSTRACT_PROPERTY_MANAGER_H
-#define ABSTRACTDERIVED_PROPERTIES__ABSTRACT_PROPERTY_MANAGER_H
-
-#include <vector>
-#include <map>
-
-#include "AbstractProperty.h"
-#include "AbstractSnapshot.h"
-#include "AbstractSurface.h"
-#include "AbstractFormation.h"
-#include "AbstractReservoir.h"
-
-#include "SurfacePropertyCalculator.h"
-#include "FormationMapPropertyCalculator.h"
-#include "FormationPropertyCalculator.h"
-#include "FormationSurfacePropertyCalculator.h"
-#include "ReservoirPropertyCalculator.h"
-#include "PropertySnapshotCalculatorMap.h"
-
-// utilities library
-#include "FormattingException.h"
-
-namespace AbstractDerivedProperties {
-
-   /// \brief Handles derived properties and their calculation.
-   class AbstractPropertyManager {
-
-   typedef formattingexception::GeneralException AbstractPropertyException;
-
-   public :
-
-      /// \brief Constructor.
-      AbstractPropertyManager () = default;
-
-      /// \brief Destructor.
-      virtual ~AbstractPropertyManager () = default;
-
-
-      /// \brief Get the property given the property-name.
-      ///
-      /// If the name is not found then a null pointer will be returned.
-      /// \param [in] name The name of the required property.
-      virtual const DataModel::AbstractProperty* getProperty ( const std::string& name ) const = 0;
-
-      /// \brief Get the surface property values.
-      ///
-      /// If the surface property values have not been computed and there is an associated calculator
-      /// then the values will be calculated as required. Additional properties may also be calculated.
-      /// \param [in] property The property whose values are requested.
-      /// \param [in] snapshot The snapshot time at which the values were calculated.
-      /// \param [in] surface  The surface with which the values are associated.
-      /// \pre property is not be null and is a valid property.
-      /// \pre snapshot is not null and is a valid snapshot age.
-      /// \pre surface is not null and is a  valid surface.
-      /// \pre A calculator for this property exists.
-      /// \post The result contains values of the required property at the required surface for the required snapshot age.
-      /// If the propery is not computed then a null will be returned.
-      virtual SurfacePropertyPtr getSurfaceProperty ( const DataModel::AbstractProperty* property,
-                                                      const DataModel::AbstractSnapshot* snapshot,
-                                                      const DataModel::AbstractSurface*  surface );
-
-      /// \brief Get the formation property values.
-      ///
-      /// If the formation property values have not been computed and there is an associated calculator
-      /// then the values will be calculated as required. Additional properties may also be calculated.
-      /// \param [in] property  The property whose values are requested.
-      /// \param [in] snapshot  The snapshot time at which the values were calculated.
-      /// \param [in] formation The formation with which the values are associated.
-      /// If the propery is not computed then a null will be returned.
-      virtual FormationMapPropertyPtr getFormationMapProperty ( const DataModel::AbstractProperty*  property,
-                                                                const DataModel::AbstractSnapshot*  snapshot,
-                                                                const DataModel::AbstractFormation* formation );
-
-      /// \brief Get the formation property values.
-      ///
-      /// If the formation property values have not been computed and there is an associated calculator
-      /// then the values will be calculated as required. Additional properties may also be calculated.
-      /// \param [in] property  The property whose values are requested.
-      /// \param [in] snapshot  The snapshot time at which the values were calculated.
-      /// \param [in] formation The formation with which the values are associated.
-      /// If the propery is not computed then a null will be returned.
-      virtual FormationPropertyPtr getFormationProperty ( const DataModel::AbstractProperty*  property,
-                                                          const DataModel::AbstractSnapshot*  snapshot,
-                                                          const DataModel::AbstractFormation* formation );
-
-      /// \brief Get the surface and formation property values.
-      ///
-      /// If the property values have not been computed and there is an associated calculator
-      /// then the values will be calculated as required. Additional properties may also be calculated.
-      /// \param [in] property  The property whose values are requested.
-      /// \param [in] snapshot  The snapshot time at which the values were calculated.
-      /// \param [in] formation The formation with which the values are associated.
-      /// \param [in] surface   The surface with which the values are associated.
-      /// If the propery is not computed then a null will be returned.
-      virtual FormationSurfacePropertyPtr getFormationSurfaceProperty ( const DataModel::AbstractProperty*  property,
-                                                                        const DataModel::AbstractSnapshot*  snapshot,
-                                                                        const DataModel::AbstractFormation* formation,
-                                                                        const DataModel::AbstractSurface*   surface );
-
-      /// \brief Get the reservoir property values.
-      ///
-      /// If the reservoir property values have not been computed and there is an associated calculator
-      /// then the values will be calculated as required. Additional properties may also be calculated.
-      /// \param [in] property  The property whose values are requested.
-      /// \param [in] snapshot  The snapshot time at which the values were calculated.
-      /// \param [in] reservoir The reservoir to which the values are associated.
-      /// If the propery is not computed then a null will be returned.
-      virtual ReservoirPropertyPtr getReservoirProperty ( const DataModel::AbstractProperty*  property,
-                                                          const DataModel::AbstractSnapshot*  snapshot,
-                                                          const DataModel::AbstractReservoir* reservoir );
-
-      /// \brief Determine if the formation property is computable.
-      ///
-      /// If snapshot is null then this will determine if the property is computable at some undefined snapshot time.
-      /// If formation is null then this will determine if the property is computable at some undefined formation in the domain.
-      ///
-      /// \param [in] property  The property we would like to know is calculatable.
-      /// \param [in] snapshot  The snapshot at which we would like to know if the property is calculatable.
-      /// \param [in] formation The formation for which we would like to know if the property is calculatable.
-      /// \pre The property points to a valid property object.
-      /// \pre The snapshot points to a valid snapshot object or is null.
-      /// \pre The formation points to a valid formation object or is null.
-      virtual bool formationPropertyIsComputable ( const DataModel::AbstractProperty*  property,
-                                                   const DataModel::AbstractSnapshot*  snapshot = 0,
-                                                   const DataModel::AbstractFormation* formation = 0 ) const;
-
-      /// \brief Determine if the formation-surface property is computable.
-      ///
-      /// If snapshot is null then this will determine if the property is computable at some undefined snapshot time.
-      /// If formation is null then this will determine if the property is computable at some undefined formation in the domain.
-      /// If surface is null then this will determine if the property is computable at some undefined surface in the domain.
-      ///
-      /// \param [in] property  The property we would like to know is calculatable.
-      /// \param [in] snapshot  The snapshot at which we would like to know if the property is calculatable.
-      /// \param [in] formation The formation for which we would like to know if the property is calculatable.
-      /// \param [in] surface   The surface for which we would like to know if the property is calculatable.
-      /// \pre The property points to a valid property object.
-      /// \pre The snapshot points to a valid snapshot object or is null.
-      /// \pre The formation points to a valid formation object or is null.
-      /// \pre The surface points to a valid surface object or is null.
-      virtual bool formationSurfacePropertyIsComputable ( const DataModel::AbstractProperty*  property,
-                                                          const DataModel::AbstractSnapshot*  snapshot = 0,
-                                                          const DataModel::AbstractFormation* formation = 0,
-                                                          const DataModel::AbstractSurface*   surface = 0 ) const;
-
-      /// \brief Determine if the surface property is computable.
-      ///
-      /// If snapshot is null then this will determine if the property is computable at some undefined snapshot time.
-      /// If surface is null then this will determine if the property is computable at some undefined surface in the domain.
-      ///
-      /// \param [in] property The property we would like to know is calculatable.
-      /// \param [in] snapshot The snapshot at which we would like to know if the property is calculatable.
-      /// \param [in] surface  The surface for which we would like to know if the property is calculatable.
-      /// \pre The property points to a valid property object.
-      /// \pre The snapshot points to a valid snapshot object or is null.
-      /// \pre The surface points to a valid surface object or is null.
-      virtual bool surfacePropertyIsComputable ( const DataModel::AbstractProperty* property,
-                                                 const DataModel::AbstractSnapshot* snapshot = 0,
-                                                 const DataModel::AbstractSurface*  surface = 0 ) const;
-
-      /// \brief Determine if the formation-map property is computable.
-      ///
-      /// If snapshot is null then this will determine if the property is computable at some undefined snapshot time.
-      /// If formation is null then this will determine if the property is computable at some undefined formation in the domain.
-      ///
-      /// \param [in] property  The property we would like to know is calculatable.
-      /// \param [in] snapshot  The snapshot at which we would like to know if the property is calculatable.
-      /// \param [in] formation The formation for which we would like to know if the property is calculatable.
-      /// \pre The property points to a valid property object.
-      /// \pre The snapshot points to a valid snapshot object or is null.
-      /// \pre The formation points to a valid formation object or is null.
-      virtual bool formationMapPropertyIsComputable ( const DataModel::AbstractProperty* property,
-                                                      const DataModel::AbstractSnapshot*  snapshot = 0,
-                                                      const DataModel::AbstractFormation* formation = 0 ) const;
-
-
-      /// \brief Determine if the reservoir property is computable.
-      ///
-      /// If snapshot is null then this will determine if the property is computable at some undefined snapshot time.
-      /// If reservoir is null then this will determine if the property is computable at some undefined reservoir in the domain.
-      ///
-      /// \param [in] property  The property we would like to know is calculatable.
-      /// \param [in] snapshot  The snapshot at which we would like to know if the property is calculatable.
-      /// \param [in] reservoir The reservoir for which we would like to know if the property is calculatable.
-      /// \pre The property points to a valid property object.
-      /// \pre The snapshot points to a valid snapshot object or is null.
-      /// \pre The reservoir points to a valid reservoir object or is null.
-      virtual bool reservoirPropertyIsComputable ( const DataModel::AbstractProperty*  property,
-                                                   const DataModel::AbstractSnapshot*  snapshot = 0,
-                                                   const DataModel::AbstractReservoir* reservoir = 0 ) const;
-
-
-      /// \brief Remove all properties associated with a particular snapshot.
-      void removeProperties ( const DataModel::AbstractSnapshot* snapshot );
-
-      /// \brief Get the grid for the map.
-      virtual const DataModel::AbstractGrid* getMapGrid () const = 0;
-
-      /// \brief Determine whether or not the node is valid.
-      virtual bool getNodeIsValid ( const unsigned int i, const unsigned int j ) const = 0;
-
-   protected :
-
-      /// \brief Add a calculator for a property or set of properties defined on a surface.
-      ///
-      /// \param [in] calculator  A calculator of surface properties.
-      ///
-      void addSurfacePropertyCalculator (const SurfacePropertyCalculatorPtr& calculator);
-
-      /// \brief Add a calculator for a property or set of map properties defined on a formation.
-      ///
-      /// \param [in] calculator  A calculator of formation map properties.
-      ///
-      void addFormationMapPropertyCalculator ( const FormationMapPropertyCalculatorPtr& calculator );
-
-      /// \brief Add a calculator for a property or set of properties defined on a formation.
-      ///
-      /// \param [in] calculator  A calculator of formation properties.      
-      ///
-      void addFormationPropertyCalculator ( const FormationPropertyCalculatorPtr& calculator,
-                                            const bool                            debug = false );
- 
-      /// \brief Add a calculator for a property or set of properties defined on a surface and formation.
-      ///
-      /// \param [in] calculator  A calculator of formation-surface properties.
-      ///
-      void addFormationSurfacePropertyCalculator ( const FormationSurfacePropertyCalculatorPtr& calculator );
-
-      /// \brief Add a calculator for a property or set of properties defined for a reservoir.
-      ///
-      /// \param [in] calculator  A calculator of reservoir properties.
-      ///
-      void addReservoirPropertyCalculator ( const ReservoirPropertyCalculatorPtr& calculator );
-
-      /// \brief Add a set of property values to the availble property values.
-      ///
-      /// \param [in] surfaceProperty  A set of property values associated with a surface.
-      void addSurfaceProperty ( const SurfacePropertyPtr& surfaceProperty );
-      
-      /// \brief Add a set of property values to the available property values.
-      ///
-      /// \param [in] formationMapProperty  A set of map property values associated with a formation.
-      void addFormationMapProperty ( const FormationMapPropertyPtr& formationMapProperty );
-      
-      /// \brief Add a set of property values to the availble property values.
-      ///
-      /// \param [in] formationProperty  A set of property values associated with a formation.
-      void addFormationProperty ( const FormationPropertyPtr& formationProperty );
-
-      /// \brief Add a set of property values to the availble property values.
-      ///
-      /// \param [in] formationSurfaceProperty  A set of property values associated with a formation and surface.
-      void addFormationSurfaceProperty ( const FormationSurfacePropertyPtr& formationSurfaceProperty );
-
-      /// \brief Add a set of property values to the availble property values.
-      ///
-      /// \param [in] reservoirProperty  A set of property values associated with a reservoir.
-      void addReservoirProperty ( const ReservoirPropertyPtr& reservoirProperty );
-
-      /// \brief Get the calculator for the property and snapshot.
-      ///
-      /// \param [in] property The property whose calulator is requested.
-      ///
-      /// If no calculator has been added then a null will be returned.
-      SurfacePropertyCalculatorPtr getSurfaceCalculator ( const DataModel::AbstractProperty* property ) const;
-
-      /// \brief Get the calculator for the property and snapshot.
-      ///
-      /// \param [in] property The property whose calulator is requested.
-      ///
-      /// If no calculator has been added then a null will be returned.
-      FormationSurfacePropertyCalculatorPtr getFormationSurfaceCalculator ( const DataModel::AbstractProperty* property ) const;
-
-      /// \brief Get the calculator for the property and snapshot.
-      ///
-      /// \param [in] property The property whose calulator is requested.
-      ///
-      /// If no calculator has been added then a null will be returned.
-      FormationMapPropertyCalculatorPtr getFormationMapCalculator ( const DataModel::AbstractProperty* property ) const;
-
-      /// \brief Get the calculator for the property and snapshot.
-      ///
-      /// \param [in] property The property whose calulator is requested.
-      ///
-      /// If no calculator has been added then a null will be returned.
-      FormationPropertyCalculatorPtr getFormationCalculator ( const DataModel::AbstractProperty* property ) const;
-
-      /// \brief Get the calculator for the property and snapshot.
-      ///
-      /// \param [in] property The property whose calulator is requested.
-      ///
-      /// If no calculator has been added then a null will be returned.
-      ReservoirPropertyCalculatorPtr getReservoirCalculator ( const DataModel::AbstractProperty* property) const;
-
-      /// \brief Search the list of available surface property values for a specific set of values.
-      ///
-      /// If the values are not found then a null will be returned.
-      /// \param [in] property The property whose values are requested.
-      /// \param [in] snapshot The snapshot time at which the values were calculated.
-      /// \param [in] surface  The surface with which the values are associated.
-      SurfacePropertyPtr findSurfacePropertyValues ( const DataModel::AbstractProperty* property,
-                                                     const DataModel::AbstractSnapshot* snapshot,
-                                                     const DataModel::AbstractSurface*  surface ) const;
-
-      /// \brief Search the list of available formation map property values for a specific set of values.
-      ///
-      /// If the values are not found then a null will be returned.
-      /// \param [in] property  The property whose values are requested.
-      /// \param [in] snapshot  The snapshot time at which the values were calculated.
-      /// \param [in] formation The formation with which the values are associated.
-      FormationMapPropertyPtr findFormationMapPropertyValues ( const DataModel::AbstractProperty*  property,
-                                                               const DataModel::AbstractSnapshot*  snapshot,
-                                                               const DataModel::AbstractFormation* formation ) const;
-
-      /// \brief Search the list of available formation property values for a specific set of values.
-      ///
-      /// If the values are not found then a null will be returned.
-      /// \param [in] property  The property whose values are requested.
-      /// \param [in] snapshot  The snapshot time at which the values were calculated.
-      /// \param [in] formation The formation with which the values are associated.
-      FormationPropertyPtr findFormationPropertyValues ( const DataModel::AbstractProperty*  property,
-                                                         const DataModel::AbstractSnapshot*  snapshot,
-                                                         const DataModel::AbstractFormation* formation ) const;
-
-      /// \brief Search the list of available formation surface property values for a specific set of values.
-      ///
-      /// If the values are not found then a null will be returned.
-      /// \param [in] property  The property whose values are requested.
-      /// \param [in] snapshot  The snapshot time at which the values were calculated.
-      /// \param [in] formation The formation with which the values are associated.
-      /// \param [in] surface   The surface with which the values are associated.
-      FormationSurfacePropertyPtr findFormationSurfacePropertyValues ( const DataModel::AbstractProperty*  property,
-                                                                       const DataModel::AbstractSnapshot*  snapshot,
-                                                                       const DataModel::AbstractFormation* formation,
-                                                                       const DataModel::AbstractSurface*   surface ) const;      
-
-      /// \brief Search the list of available reservoir property values for a specific set of values.
-      ///
-      /// If the values are not found then a null will be returned.
-      /// \param [in] property  The property whose values are requested.
-      /// \param [in] snapshot  The snapshot time at which the values were calculated.
-      /// \param [in] reservoir The reservoir with which the values are associated.
-      ReservoirPropertyPtr findReservoirPropertyValues ( const DataModel::AbstractProperty*  property,
-                                                         const DataModel::AbstractSnapshot*  snapshot,
-                                                         const DataModel::AbstractReservoir* reservoir ) const;
-
-   private :
-
-      /// \brief Mapping from property and snapshot to the associated surface property calculator.
-      typedef PropertySnapshotCalculatorMap<SurfacePropertyCalculatorPtr> SurfacePropertyCalculatorMap;
-
-      /// \brief Mapping from property and snapshot to the associated formation map property calculator.
-      typedef PropertySnapshotCalculatorMap<FormationMapPropertyCalculatorPtr> FormationMapPropertyCalculatorMap;
-
-      /// \brief Mapping from property and snapshot to the associated formation property calculator.
-      typedef PropertySnapshotCalculatorMap<FormationPropertyCalculatorPtr> FormationPropertyCalculatorMap;
-
-      /// \brief Mapping from property and snapshot to the associated formation and surface property calculator.
-      typedef PropertySnapshotCalculatorMap<FormationSurfacePropertyCalculatorPtr> FormationSurfacePropertyCalculatorMap;
-
-      /// \brief Mapping from property and snapshot to the associated reservoir property calculator.
-      typedef PropertySnapshotCalculatorMap<ReservoirPropertyCalculatorPtr> ReservoirPropertyCalculatorMap;
-
-
-
-      /// \brief Map of property to surface-property calculator.
-      SurfacePropertyCalculatorMap m_surfacePropertyCalculators;
-
-      /// \brief List of all surface-properties that have been stored.
-      SurfacePropertyList          m_surfaceProperties;
-
-      /// \brief Map of property to formation-property calculator.
-      FormationMapPropertyCalculatorMap m_formationMapPropertyCalculators;
-
-      /// \brief List of all formation-properties that have been stored.
-      FormationMapPropertyList         m_formationMapProperties;
-
-      /// \brief Map of property to formation and surface property calculator.
-      FormationSurfacePropertyCalculatorMap m_formationSurfacePropertyCalculators;
-
-      /// \brief List of all formation and surface properties that have been stored.
-      FormationSurfacePropertyList    m_formationSurfaceProperties;
-
-      /// \brief Map of property to formation-property calculator.
-      FormationPropertyCalculatorMap  m_formationPropertyCalculators;
-
-      /// \brief List of all formation-properties that have been stored.
-      FormationPropertyList           m_formationProperties;
-
-      /// \brief Map of property to reservoir-property calculator.
-      ReservoirPropertyCalculatorMap m_reservoirPropertyCalculators;
-
-      /// \brief List of all reservoir-properties that have been stored.
-      ReservoirPropertyList          m_reservoirProperties;
-
-   };
-
-} // namespace AbstractDerivedProperties
-
-#endif // ABSTRACTDERIVED_PROPERTIES__ABSTRACT_PROPERTY_MANAGER_H
+//
+// Copyright (C) 2015-2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#ifndef ABSTRACTDERIVED_PROPERTIES__ABSTRACT_PROPERTY_MANAGER_H
+#define ABSTRACTDERIVED_PROPERTIES__ABSTRACT_PROPERTY_MANAGER_H
+
+#include <vector>
+#include <map>
+#include <set>
+#include <tuple>
+
+#include "AbstractProperty.h"
+#include "AbstractSnapshot.h"
+#include "AbstractSurface.h"
+#include "AbstractFormation.h"
+#include "AbstractReservoir.h"
+
+#include "SurfacePropertyCalculator.h"
+#include "FormationMapPropertyCalculator.h"
+#include "FormationPropertyCalculator.h"
+#include "FormationSurfacePropertyCalculator.h"
+#include "ReservoirPropertyCalculator.h"
+#include "PropertySnapshotCalculatorMap.h"
+
+// utilities library
+#include "FormattingException.h"
+
+namespace AbstractDerivedProperties {
+
+   /// \brief Handles derived properties and their calculation.
+   class AbstractPropertyManager {
+
+   typedef formattingexception::GeneralException AbstractPropertyException;
+
+   public :
+
+      /// \brief Counters of the use of the cached property values.
+      struct CacheStatistics {
+         size_t hits = 0;           ///< Number of requests served from the cache.
+         size_t misses = 0;         ///< Number of requests for values not in the cache.
+         size_t calculations = 0;   ///< Number of times a calculator has been run.
+         size_t recalculations = 0; ///< Number of misses for values that had been evicted before.
+         size_t evictions = 0;      ///< Number of values removed to stay within the memory limit.
+         size_t memoryInUse = 0;    ///< Estimated number of bytes of the cached values.
+         size_t peakMemory = 0;     ///< Largest estimated number of bytes of the cached values.
+      };
+
+      /// \brief Constructor.
+      AbstractPropertyManager () = default;
+
+      /// \brief Destructor.
+      virtual ~AbstractPropertyManager () = default;
+
+
+      /// \brief Get the property given the property-name.
+      ///
+      /// If the name is not found then a null pointer will be returned.
+      /// \param [in] name The name of the required property.
+      virtual const DataModel::AbstractProperty* getProperty ( const std::string& name ) const = 0;
+
+      /// \brief Get the surface property values.
+      ///
+      /// If the surface property values have not been computed and there is an associated calculator
+      /// then the values will be calculated as required. Additional properties may also be calculated.
+      /// \param [in] property The property whose values are requested.
+      /// \param [in] snapshot The snapshot time at which the values were calculated.
+      /// \param [in] surface  The surface with which the values are associated.
+      /// \pre property is not be null and is a valid property.
+      /// \pre snapshot is not null and is a valid snapshot age.
+      /// \pre surface is not null and is a  valid surface.
+      /// \pre A calculator for this property exists.
+      /// \post The result contains values of the required property at the required surface for the required snapshot age.
+      /// If the propery is not computed then a null will be returned.
+      virtual SurfacePropertyPtr getSurfaceProperty ( const DataModel::AbstractProperty* property,
+                                                      const DataModel::AbstractSnapshot* snapshot,
+                                                      const DataModel::AbstractSurface*  surface );
+
+      /// \brief Get the formation property values.
+      ///
+      /// If the formation property values have not been computed and there is an associated calculator
+      /// then the values will be calculated as required. Additional properties may also be calculated.
+      /// \param [in] property  The property whose values are requested.
+      /// \param [in] snapshot  The snapshot time at which the values were calculated.
+      /// \param [in] formation The formation with which the values are associated.
+      /// If the propery is not computed then a null will be returned.
+      virtual FormationMapPropertyPtr getFormationMapProperty ( const DataModel::AbstractProperty*  property,
+                                                                const DataModel::AbstractSnapshot*  snapshot,
+                                                                const DataModel::AbstractFormation* formation );
+
+      /// \brief Get the formation property values.
+      ///
+      /// If the formation property values have not been computed and there is an associated calculator
+      /// then the values will be calculated as required. Additional properties may also be calculated.
+      /// \param [in] property  The property whose values are requested.
+      /// \param [in] snapshot  The snapshot time at which the values were calculated.
+      /// \param [in] formation The formation with which the values are associated.
+      /// If the propery is not computed then a null will be returned.
+      virtual FormationPropertyPtr getFormationProperty ( const DataModel::AbstractProperty*  property,
+                                                          const DataModel::AbstractSnapshot*  snapshot,
+                                                          const DataModel::AbstractFormation* formation );
+
+      /// \brief Get the surface and formation property values.
+      ///
+      /// If the property values have not been computed and there is an associated calculator
+      /// then the values will be calculated as required. Additional properties may also be calculated.
+      /// \param [in] property  The property whose values are requested.
+      /// \param [in] snapshot  The snapshot time at which the values were calculated.
+      /// \param [in] formation The formation with which the values are associated.
+      /// \param [in] surface   The surface with which the values are associated.
+      /// If the propery is not computed then a null will be returned.
+      virtual FormationSurfacePropertyPtr getFormationSurfaceProperty ( const DataModel::AbstractProperty*  property,
+                                                                        const DataModel::AbstractSnapshot*  snapshot,
+                                                                        const DataModel::AbstractFormation* formation,
+                                                                        const DataModel::AbstractSurface*   surface );
+
+      /// \brief Get the reservoir property values.
+      ///
+      /// If the reservoir property values have not been computed and there is an associated calculator
+      /// then the values will be calculated as required. Additional properties may also be calculated.
+      /// \param [in] property  The property whose values are requested.
+      /// \param [in] snapshot  The snapshot time at which the values were calculated.
+      /// \param [in] reservoir The reservoir to which the values are associated.
+      /// If the propery is not computed then a null will be returned.
+      virtual ReservoirPropertyPtr getReservoirProperty ( const DataModel::AbstractProperty*  property,
+                                                          const DataModel::AbstractSnapshot*  snapshot,
+                                                          const DataModel::AbstractReservoir* reservoir );
+
+      /// \brief Determine if the formation property is computable.
+      ///
+      /// If snapshot is null then this will determine if the property is computable at some undefined snapshot time.
+      /// If formation is null then this will determine if the property is computable at some undefined formation in the domain.
+      ///
+      /// \param [in] property  The property we would like to know is calculatable.
+      /// \param [in] snapshot  The snapshot at which we would like to know if the property is calculatable.
+      /// \param [in] formation The formation for which we would like to know if the property is calculatable.
+      /// \pre The property points to a valid property object.
+      /// \pre The snapshot points to a valid snapshot object or is null.
+      /// \pre The formation points to a valid formation object or is null.
+      virtual bool formationPropertyIsComputable ( const DataModel::AbstractProperty*  property,
+                                                   const DataModel::AbstractSnapshot*  snapshot = 0,
+                                                   const DataModel::AbstractFormation* formation = 0 ) const;
+
+      /// \brief Determine if the formation-surface property is computable.
+      ///
+      /// If snapshot is null then this will determine if the property is computable at some undefined snapshot time.
+      /// If formation is null then this will determine if the property is computable at some undefined formation in the domain.
+      /// If surface is null then this will determine if the property is computable at some undefined surface in the domain.
+      ///
+      /// \param [in] property  The property we would like to know is calculatable.
+      /// \param [in] snapshot  The snapshot at which we would like to know if the property is calculatable.
+      /// \param [in] formation The formation for which we would like to know if the property is calculatable.
+      /// \param [in] surface   The surface for which we would like to know if the property is calculatable.
+      /// \pre The property points to a valid property object.
+      /// \pre The snapshot points to a valid snapshot object or is null.
+      /// \pre The formation points to a valid formation object or is null.
+      /// \pre The surface points to a valid surface object or is null.
+      virtual bool formationSurfacePropertyIsComputable ( const DataModel::AbstractProperty*  property,
+                                                          const DataModel::AbstractSnapshot*  snapshot = 0,
+                                                          const DataModel::AbstractFormation* formation = 0,
+                                                          const DataModel::AbstractSurface*   surface = 0 ) const;
+
+      /// \brief Determine if the surface property is computable.
+      ///
+      /// If snapshot is null then this will determine if the property is computable at some undefined snapshot time.
+      /// If surface is null then this will determine if the property is computable at some undefined surface in the domain.
+      ///
+      /// \param [in] property The property we would like to know is calculatable.
+      /// \param [in] snapshot The snapshot at which we would like to know if the property is calculatable.
+      /// \param [in] surface  The surface for which we would like to know if the property is calculatable.
+      /// \pre The property points to a valid property object.
+      /// \pre The snapshot points to a valid snapshot object or is null.
+      /// \pre The surface points to a valid surface object or is null.
+      virtual bool surfacePropertyIsComputable ( const DataModel::AbstractProperty* property,
+                                                 const DataModel::AbstractSnapshot* snapshot = 0,
+                                                 const DataModel::AbstractSurface*  surface = 0 ) const;
+
+      /// \brief Determine if the formation-map property is computable.
+      ///
+      /// If snapshot is null then this will determine if the property is computable at some undefined snapshot time.
+      /// If formation is null then this will determine if the property is computable at some undefined formation in the domain.
+      ///
+      /// \param [in] property  The property we would like to know is calculatable.
+      /// \param [in] snapshot  The snapshot at which we would like to know if the property is calculatable.
+      /// \param [in] formation The formation for which we would like to know if the property is calculatable.
+      /// \pre The property points to a valid property object.
+      /// \pre The snapshot points to a valid snapshot object or is null.
+      /// \pre The formation points to a valid formation object or is null.
+      virtual bool formationMapPropertyIsComputable ( const DataModel::AbstractProperty* property,
+                                                      const DataModel::AbstractSnapshot*  snapshot = 0,
+                                                      const DataModel::AbstractFormation* formation = 0 ) const;
+
+
+      /// \brief Determine if the reservoir property is computable.
+      ///
+      /// If snapshot is null then this will determine if the property is computable at some undefined snapshot time.
+      /// If reservoir is null then this will determine if the property is computable at some undefined reservoir in the domain.
+      ///
+      /// \param [in] property  The property we would like to know is calculatable.
+      /// \param [in] snapshot  The snapshot at which we would like to know if the property is calculatable.
+      /// \param [in] reservoir The reservoir for which we would like to know if the property is calculatable.
+      /// \pre The property points to a valid property object.
+      /// \pre The snapshot points to a valid snapshot object or is null.
+      /// \pre The reservoir points to a valid reservoir object or is null.
+      virtual bool reservoirPropertyIsComputable ( const DataModel::AbstractProperty*  property,
+                                                   const DataModel::AbstractSnapshot*  snapshot = 0,
+                                                   const DataModel::AbstractReservoir* reservoir = 0 ) const;
+
+
+      /// \brief Determine if the formation property values have been calculated already.
+      ///
+      /// Unlike getFormationProperty this does not calculate the values.
+      /// \param [in] property  The property whose values are requested.
+      /// \param [in] snapshot  The snapshot time at which the values were calculated.
+      /// \param [in] formation The formation with which the values are associated.
+      bool formationPropertyIsCalculated ( const DataModel::AbstractProperty*  property,
+                                           const DataModel::AbstractSnapshot*  snapshot,
+                                           const DataModel::AbstractFormation* formation ) const;
+
+      /// \brief Get the names of the properties on which the calculator of the property depends.
+      ///
+      /// The calculators are searched in the order formation, formation-map, surface, formation-surface and reservoir.
+      /// If there is no calculator, e.g. for a property that is only read from file, then the list will be empty.
+      /// \param [in]  property       The property whose dependencies are requested.
+      /// \param [out] dependentNames On exit contains the names of the dependent properties.
+      void getDependentPropertyNames ( const DataModel::AbstractProperty* property,
+                                       std::vector<std::string>&          dependentNames ) const;
+
+      /// \brief Determine if the formation property values depend on the properties of the formation above.
+      bool formationPropertyDependsOnFormationAbove ( const DataModel::AbstractProperty* property ) const;
+
+      /// \brief Remove the formation property values, e.g. when these are no longer needed.
+      ///
+      /// The values are calculated again if they are requested afterwards.
+      /// Values still referenced outside the property manager stay alive until released there.
+      void removeFormationProperty ( const DataModel::AbstractProperty*  property,
+                                     const DataModel::AbstractSnapshot*  snapshot,
+                                     const DataModel::AbstractFormation* formation );
+
+      /// \brief Remove all properties associated with a particular snapshot.
+      void removeProperties ( const DataModel::AbstractSnapshot* snapshot );
+
+      /// \brief Set the maximum number of bytes of property values to keep.
+      ///
+      /// When the estimated size of the cached property values exceeds the limit, values are removed until it fits again;
+      /// these are calculated again when requested. Large values that are not expected to be used again soon are removed
+      /// first; values that cost several calculations or that other properties depend on are kept longer.
+      /// Values still referenced outside the property manager stay alive until released there.
+      /// \param [in] numberOfBytes The memory limit, zero for no limit (the default).
+      void setMemoryLimit ( const size_t numberOfBytes );
+
+      /// \brief Get the maximum number of bytes of property values to keep, zero if there is no limit.
+      size_t getMemoryLimit () const;
+
+      /// \brief Get the counters of the use of the cached property values.
+      const CacheStatistics& getCacheStatistics () const;
+
+      /// \brief Get the grid for the map.
+      virtual const DataModel::AbstractGrid* getMapGrid () const = 0;
+
+      /// \brief Determine whether or not the node is valid.
+      virtual bool getNodeIsValid ( const unsigned int i, const unsigned int j ) const = 0;
+
+   protected :
+
+      /// \brief Add a calculator for a property or set of properties defined on a surface.
+      ///
+      /// \param [in] calculator  A calculator of surface properties.
+      ///
+      void addSurfacePropertyCalculator (const SurfacePropertyCalculatorPtr& calculator);
+
+      /// \brief Add a calculator for a property or set of map properties defined on a formation.
+      ///
+      /// \param [in] calculator  A calculator of formation map properties.
+      ///
+      void addFormationMapPropertyCalculator ( const FormationMapPropertyCalculatorPtr& calculator );
+
+      /// \brief Add a calculator for a property or set of properties defined on a formation.
+      ///
+      /// \param [in] calculator  A calculator of formation properties.      
+      ///
+      void addFormationPropertyCalculator ( const FormationPropertyCalculatorPtr& calculator,
+                                            const bool                            debug = false );
+ 
+      /// \brief Add a calculator for a property or set of properties defined on a surface and formation.
+      ///
+      /// \param [in] calculator  A calculator of formation-surface properties.
+      ///
+      void addFormationSurfacePropertyCalculator ( const FormationSurfacePropertyCalculatorPtr& calculator );
+
+      /// \brief Add a calculator for a property or set of properties defined for a reservoir.
+      ///
+      /// \param [in] calculator  A calculator of reservoir properties.
+      ///
+      void addReservoirPropertyCalculator ( const ReservoirPropertyCalculatorPtr& calculator );
+
+      /// \brief Add a set of property values to the availble property values.
+      ///
+      /// \param [in] surfaceProperty  A set of property values associated with a surface.
+      /// \param [in] cost  The number of calculations needed to obtain the values.
+      void addSurfaceProperty ( const SurfacePropertyPtr& surfaceProperty, const double cost = 1.0 );
+      
+      /// \brief Add a set of property values to the available property values.
+      ///
+      /// \param [in] formationMapProperty  A set of map property values associated with a formation.
+      /// \param [in] cost  The number of calculations needed to obtain the values.
+      void addFormationMapProperty ( const FormationMapPropertyPtr& formationMapProperty, const double cost = 1.0 );
+      
+      /// \brief Add a set of property values to the availble property values.
+      ///
+      /// \param [in] formationProperty  A set of property values associated with a formation.
+      /// \param [in] cost  The number of calculations needed to obtain the values.
+      void addFormationProperty ( const FormationPropertyPtr& formationProperty, const double cost = 1.0 );
+
+      /// \brief Add a set of property values to the availble property values.
+      ///
+      /// \param [in] formationSurfaceProperty  A set of property values associated with a formation and surface.
+      /// \param [in] cost  The number of calculations needed to obtain the values.
+      void addFormationSurfaceProperty ( const FormationSurfacePropertyPtr& formationSurfaceProperty, const double cost = 1.0 );
+
+      /// \brief Add a set of property values to the availble property values.
+      ///
+      /// \param [in] reservoirProperty  A set of property values associated with a reservoir.
+      /// \param [in] cost  The number of calculations needed to obtain the values.
+      void addReservoirProperty ( const ReservoirPropertyPtr& reservoirProperty, const double cost = 1.0 );
+
+      /// \brief Get the calculator for the property and snapshot.
+      ///
+      /// \param [in] property The property whose calulator is requested.
+      ///
+      /// If no calculator has been added then a null will be returned.
+      SurfacePropertyCalculatorPtr getSurfaceCalculator ( const DataModel::AbstractProperty* property ) const;
+
+      /// \brief Get the calculator for the property and snapshot.
+      ///
+      /// \param [in] property The property whose calulator is requested.
+      ///
+      /// If no calculator has been added then a null will be returned.
+      FormationSurfacePropertyCalculatorPtr getFormationSurfaceCalculator ( const DataModel::AbstractProperty* property ) const;
+
+      /// \brief Get the calculator for the property and snapshot.
+      ///
+      /// \param [in] property The property whose calulator is requested.
+      ///
+      /// If no calculator has been added then a null will be returned.
+      FormationMapPropertyCalculatorPtr getFormationMapCalculator ( const DataModel::AbstractProperty* property ) const;
+
+      /// \brief Get the calculator for the property and snapshot.
+      ///
+      /// \param [in] property The property whose calulator is requested.
+      ///
+      /// If no calculator has been added then a null will be returned.
+      FormationPropertyCalculatorPtr getFormationCalculator ( const DataModel::AbstractProperty* property ) const;
+
+      /// \brief Get the calculator for the property and snapshot.
+      ///
+      /// \param [in] property The property whose calulator is requested.
+      ///
+      /// If no calculator has been added then a null will be returned.
+      ReservoirPropertyCalculatorPtr getReservoirCalculator ( const DataModel::AbstractProperty* property) const;
+
+      /// \brief Search the available surface property values for a specific set of values.
+      ///
+      /// If the values are not found then a null will be returned.
+      /// \param [in] property The property whose values are requested.
+      /// \param [in] snapshot The snapshot time at which the values were calculated.
+      /// \param [in] surface  The surface with which the values are associated.
+      SurfacePropertyPtr findSurfacePropertyValues ( const DataModel::AbstractProperty* property,
+                                                     const DataModel::AbstractSnapshot* snapshot,
+                                                     const DataModel::AbstractSurface*  surface ) const;
+
+      /// \brief Search the available formation map property values for a specific set of values.
+      ///
+      /// If the values are not found then a null will be returned.
+      /// \param [in] property  The property whose values are requested.
+      /// \param [in] snapshot  The snapshot time at which the values were calculated.
+      /// \param [in] formation The formation with which the values are associated.
+      FormationMapPropertyPtr findFormationMapPropertyValues ( const DataModel::AbstractProperty*  property,
+                                                               const DataModel::AbstractSnapshot*  snapshot,
+                                                               const DataModel::AbstractFormation* formation ) const;
+
+      /// \brief Search the available formation property values for a specific set of values.
+      ///
+      /// If the values are not found then a null will be returned.
+      /// \param [in] property  The property whose values are requested.
+      /// \param [in] snapshot  The snapshot time at which the values were calculated.
+      /// \param [in] formation The formation with which the values are associated.
+      FormationPropertyPtr findFormationPropertyValues ( const DataModel::AbstractProperty*  property,
+                                                         const DataModel::AbstractSnapshot*  snapshot,
+                                                         const DataModel::AbstractFormation* formation ) const;
+
+      /// \brief Search the available formation surface property values for a specific set of values.
+      ///
+      /// If the values are not found then a null will be returned.
+      /// \param [in] property  The property whose values are requested.
+      /// \param [in] snapshot  The snapshot time at which the values were calculated.
+      /// \param [in] formation The formation with which the values are associated.
+      /// \param [in] surface   The surface with which the values are associated.
+      FormationSurfacePropertyPtr findFormationSurfacePropertyValues ( const DataModel::AbstractProperty*  property,
+                                                                       const DataModel::AbstractSnapshot*  snapshot,
+                                                                       const DataModel::AbstractFormation* formation,
+                                                                       const DataModel::AbstractSurface*   surface ) const;      
+
+      /// \brief Search the available reservoir property values for a specific set of values.
+      ///
+      /// If the values are not found then a null will be returned.
+      /// \param [in] property  The property whose values are requested.
+      /// \param [in] snapshot  The snapshot time at which the values were calculated.
+      /// \param [in] reservoir The reservoir with which the values are associated.
+      ReservoirPropertyPtr findReservoirPropertyValues ( const DataModel::AbstractProperty*  property,
+                                                         const DataModel::AbstractSnapshot*  snapshot,
+                                                         const DataModel::AbstractReservoir* reservoir ) const;
+
+   private :
+
+      /// \brief The kinds of property values that are cached.
+      enum CacheKind { SURFACE_VALUES, FORMATION_MAP_VALUES, FORMATION_VALUES, FORMATION_SURFACE_VALUES, RESERVOIR_VALUES };
+
+      /// \brief Identifies a set of cached values: the kind, property, snapshot and formation, surface and/or reservoir.
+      typedef std::tuple<CacheKind, const void*, const void*, const void*, const void*> CacheKey;
+
+      /// \brief Increments a counter for as long as it exists, also when an exception is thrown.
+      class ScopedCount {
+      public :
+         explicit ScopedCount ( size_t& count ) : m_count ( count ) { ++m_count; }
+         ~ScopedCount () { --m_count; }
+
+         ScopedCount ( const ScopedCount& ) = delete;
+         ScopedCount& operator= ( const ScopedCount& ) = delete;
+
+      private :
+         size_t& m_count;
+      };
+
+      /// \brief A set of cached values and its bookkeeping.
+      struct CacheEntry {
+         AbstractPropertyValuesPtr values;
+         size_t                    numberOfBytes;
+         size_t                    lastUse;
+         size_t                    reuseDistance; ///< Number of requests between the last two uses of the values.
+         size_t                    dependentUses; ///< Number of requests for the values from calculators.
+         double                    cost;          ///< Number of calculations needed to obtain the values.
+         double                    priority;      ///< The values with the lowest priority are evicted first.
+      };
+
+      /// \brief Map from the key to the cached values.
+      typedef std::map<CacheKey, CacheEntry> CacheEntryMap;
+
+      /// \brief The keys of the cached values, ordered by their priority.
+      typedef std::set<std::pair<double, CacheKey>> CacheEvictionOrder;
+
+      /// \brief Find the cached values.
+      ///
+      /// If the values are not found then a null will be returned.
+      template<typename PropertyPtr>
+      PropertyPtr findCachedValues ( const CacheKey& key ) const;
+
+      /// \brief Add the values to the cache.
+      ///
+      /// Returns false if values with the same key are cached already; these are not added again.
+      bool addCacheEntry ( const CacheKey& key, const AbstractPropertyValuesPtr& values, const size_t numberOfBytes, const double cost );
+
+      /// \brief Mark the cached values as just used, counting the request as a hit or a miss.
+      void useCacheEntry ( const CacheKey& key, const bool found );
+
+      /// \brief Count a request for the values from a calculator, the values that other properties depend on are kept longer.
+      void countDependentUse ( const CacheKey& key );
+
+      /// \brief Set the priority of the values from their cost, size and expected reuse.
+      ///
+      /// The priority is that of greedy-dual-size caching: the cost per byte, weighted by the number of dependent
+      /// properties and divided by the reuse distance, on top of the priority of the last values evicted, such that
+      /// values that are no longer used are evicted eventually.
+      void prioritiseCacheEntry ( CacheEntryMap::value_type& entry );
+
+      /// \brief Remove the values with the lowest priority until the cached values fit within the memory limit.
+      ///
+      /// The most recently used values are always kept, these may have been requested just now.
+      void evictCacheEntries ();
+
+      /// \brief Remove the values with the lowest priority, keeping the values used at or after firstProtectedUse.
+      ///
+      /// Nothing is removed while the values calculated together are being added (m_deferredEvictions nonzero).
+      void evictCacheEntries ( const size_t firstProtectedUse );
+
+      /// \brief Remove the values from the cache.
+      void removeCacheEntry ( CacheEntryMap::iterator entry );
+
+      /// \brief Mapping from property and snapshot to the associated surface property calculator.
+      typedef PropertySnapshotCalculatorMap<SurfacePropertyCalculatorPtr> SurfacePropertyCalculatorMap;
+
+      /// \brief Mapping from property and snapshot to the associated formation map property calculator.
+      typedef PropertySnapshotCalculatorMap<FormationMapPropertyCalculatorPtr> FormationMapPropertyCalculatorMap;
+
+      /// \brief Mapping from property and snapshot to the associated formation property calculator.
+      typedef PropertySnapshotCalculatorMap<FormationPropertyCalculatorPtr> FormationPropertyCalculatorMap;
+
+      /// \brief Mapping from property and snapshot to the associated formation and surface property calculator.
+      typedef PropertySnapshotCalculatorMap<FormationSurfacePropertyCalculatorPtr> FormationSurfacePropertyCalculatorMap;
+
+      /// \brief Mapping from property and snapshot to the associated reservoir property calculator.
+      typedef PropertySnapshotCalculatorMap<ReservoirPropertyCalculatorPtr> ReservoirPropertyCalculatorMap;
+
+
+
+      /// \brief Map of property to surface-property calculator.
+      SurfacePropertyCalculatorMap m_surfacePropertyCalculators;
+
+      /// \brief Map of property to formation-property calculator.
+      FormationMapPropertyCalculatorMap m_formationMapPropertyCalculators;
+
+      /// \brief Map of property to formation and surface property calculator.
+      FormationSurfacePropertyCalculatorMap m_formationSurfacePropertyCalculators;
+
+      /// \brief Map of property to formation-property calculator.
+      FormationPropertyCalculatorMap  m_formationPropertyCalculators;
+
+      /// \brief Map of property to reservoir-property calculator.
+      ReservoirPropertyCalculatorMap m_reservoirPropertyCalculators;
+
+      /// \brief All property values that have been stored, with their bookkeeping.
+      CacheEntryMap                  m_cacheEntries;
+
+      /// \brief The keys of the stored property values, in the order in which these are evicted.
+      CacheEvictionOrder             m_evictionOrder;
+
+      /// \brief Keys of the values that have been evicted, to count recalculations.
+      std::set<CacheKey>             m_evictedKeys;
+
+      /// \brief The maximum number of bytes of property values to keep, zero for no limit.
+      size_t                         m_memoryLimit = 0;
+
+      /// \brief Counts the requests for property values, to determine the reuse distance of the cached values.
+      size_t                         m_useCount = 0;
+
+      /// \brief The priority of the values evicted last, the base priority of values used afterwards.
+      double                         m_inflation = 0.0;
+
+      /// \brief The number of calculators running, nonzero when values are requested by a calculator.
+      size_t                         m_calculationDepth = 0;
+
+      /// \brief Nonzero while the values calculated together are added, these are evicted only after all of them are added.
+      size_t                         m_deferredEvictions = 0;
+
+      /// \brief Counters of the use of the cached property values.
+      CacheStatistics                m_cacheStatistics;
+
+   };
+
+} // namespace AbstractDerivedProperties
+
+#endif // ABSTRACTDERIVED_PROPERTIES__ABSTRACT_PROPERTY_MANAGER_H
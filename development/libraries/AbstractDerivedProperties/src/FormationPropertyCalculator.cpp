@@ -12,6 +12,7 @@
 #include "AbstractPropertyManager.h"
 
 #include "AbstractProperty.h"
+#include <algorithm>
 #include <string>
 
 bool AbstractDerivedProperties::FormationPropertyCalculator::isComputable ( const AbstractPropertyManager&      propManager,
@@ -33,6 +34,10 @@ bool AbstractDerivedProperties::FormationPropertyCalculator::isComputable ( cons
    return true;
 }
 
+bool AbstractDerivedProperties::FormationPropertyCalculator::dependsOnFormationAbove () const {
+   return false;
+}
+
 void AbstractDerivedProperties::FormationPropertyCalculator::setUp2dEltMapping( AbstractPropertyManager& aPropManager,
                                                                         const FormationPropertyPtr aProperty,
                                                                         ElementList & mapElementList ) const
@@ -88,8 +93,27 @@ void AbstractDerivedProperties::FormationPropertyCalculator::setUp2dEltMapping(
 
 }
 
-double AbstractDerivedProperties::FormationPropertyCalculator::calculateAtPosition(const GeoPhysics::GeoPhysicsFormation* /*formation*/,
-                                                                                   const GeoPhysics::CompoundLithology* /*lithology*/, const std::map<std::string, double> &/*dependentProperties*/) const
+void AbstractDerivedProperties::FormationPropertyCalculator::calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      /*formation*/,
+                                                                                   const GeoPhysics::CompoundLithology* const* /*lithologies*/,
+                                                                                   const unsigned int                          numberOfPositions,
+                                                                                   const double*                               /*dependentValues*/,
+                                                                                         double*                               values ) const
 {
-  return -1;
+  std::fill( values, values + numberOfPositions, -1.0 );
+}
+
+double AbstractDerivedProperties::FormationPropertyCalculator::calculateAtPosition(const GeoPhysics::GeoPhysicsFormation* formation,
+                                                                                   const GeoPhysics::CompoundLithology* lithology, const std::map<std::string, double> &dependentProperties) const
+{
+  const std::vector<std::string>& dependentPropertyNames = getDependentPropertyNames();
+  std::vector<double> dependentValues( dependentPropertyNames.size() );
+
+  for ( size_t i = 0; i < dependentPropertyNames.size(); ++i )
+  {
+    dependentValues[i] = dependentProperties.at( dependentPropertyNames[i] );
+  }
+
+  double value;
+  calculateAtPositions( formation, &lithology, 1, dependentValues.data(), &value );
+  return value;
 }
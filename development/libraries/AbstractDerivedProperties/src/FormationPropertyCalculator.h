@@ -64,9 +64,26 @@ namespace AbstractDerivedProperties {
 
       virtual void setUp2dEltMapping( AbstractPropertyManager& propManager, const FormationPropertyPtr aProperty, ElementList & mapElementList ) const;
 
-      virtual double calculateAtPosition(const GeoPhysics::GeoPhysicsFormation* formation,
-                                         const GeoPhysics::CompoundLithology* lithology,
-                                         const std::map<std::string, double>& dependentProperties) const;
+      /// \brief Determine if the values in a formation also depend on the properties of the formation above.
+      ///
+      /// This is the case for properties that are integrated from the top of the domain downwards, e.g. the hydrostatic pressure.
+      virtual bool dependsOnFormationAbove () const;
+
+      /// \brief Calculate the property at a number of positions in the formation.
+      ///
+      /// The values of the dependent properties are given position after position, each in the order of
+      /// getDependentPropertyNames, so dependentValues holds the values of position p from p * getDependentPropertyNames ().size ().
+      /// The calculated values are stored in values, one per position.
+      virtual void calculateAtPositions ( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                          const GeoPhysics::CompoundLithology* const* lithologies,
+                                          const unsigned int                          numberOfPositions,
+                                          const double*                               dependentValues,
+                                                double*                               values ) const;
+
+      /// \brief Calculate the property at a single position in the formation, from the values of the dependent properties by name.
+      double calculateAtPosition(const GeoPhysics::GeoPhysicsFormation* formation,
+                                 const GeoPhysics::CompoundLithology* lithology,
+                                 const std::map<std::string, double>& dependentProperties) const;
 
     };
 
@@ -37,3 +37,9 @@ const std::vector<std::string>& AbstractDerivedProperties::PropertyCalculator::g
 const std::vector<std::string>& AbstractDerivedProperties::PropertyCalculator::getDependentPropertyNames () const {
    return m_dependentPropertyNames;
 }
+
+int AbstractDerivedProperties::PropertyCalculator::getDependentPropertyIndex ( const std::string& propertyName ) const {
+
+   const std::vector<std::string>::const_iterator found = std::find ( m_dependentPropertyNames.begin (), m_dependentPropertyNames.end (), propertyName );
+   return found == m_dependentPropertyNames.end () ? -1 : static_cast<int>( found - m_dependentPropertyNames.begin ());
+}
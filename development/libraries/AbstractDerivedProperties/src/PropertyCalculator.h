@@ -34,6 +34,11 @@ namespace AbstractDerivedProperties {
       /// \brief Get a list of the property names on which this calculator depends.
       virtual const std::vector<std::string>& getDependentPropertyNames () const;
 
+      /// \brief Get the position of the property in the list of dependent properties.
+      ///
+      /// Returns -1 if the calculator does not depend on the property.
+      int getDependentPropertyIndex ( const std::string& propertyName ) const;
+
    protected :
 
       /// \brief Add property name to the set of properties that will be calculated by this calculator.
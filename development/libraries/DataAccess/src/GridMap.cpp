@@ -4,6 +4,7 @@
 #include <limits.h>
 #endif
 #include <assert.h>
+#include <algorithm>
 #include <iomanip>
 
 #include "GridMap.h"
@@ -16,6 +17,26 @@ using namespace Interface;
 
 #define Min(a,b)        (a < b ? a : b)
 
+namespace
+{
+   /// copy num values between two arrays that each have their own stride
+   template < class Value >
+   void copyValues (const Value * from, size_t fromStride, Value * to, size_t toStride, size_t num)
+   {
+      if (fromStride == 1 && toStride == 1)
+      {
+         std::copy (from, from + num, to);
+      }
+      else
+      {
+         for (size_t n = 0; n < num; ++n)
+         {
+            to[n * toStride] = from[n * fromStride];
+         }
+      }
+   }
+}
+
 //--------------------------------------------
 
 unsigned int GridMap::firstI (void) const
@@ -72,4 +93,80 @@ unsigned int GridMap::lastI( bool withGhosts ) const
 unsigned int GridMap::lastJ( bool withGhosts ) const
 {
    return getGrid()->lastJ( withGhosts );
-}
\ No newline at end of file
+}
+
+//--------------------------------------------
+
+bool GridMap::getRow (unsigned int j, unsigned int k, std::vector<double> & values) const
+{
+   ConstValueArray array;
+   if (!getValueArray (array) || j < array.firstJ || j - array.firstJ >= array.numJ || k >= array.numK) return false;
+
+   values.resize (array.numI);
+   copyValues (&array (array.firstI, j, k), array.strideI, values.data (), 1, array.numI);
+   return true;
+}
+
+bool GridMap::setRow (unsigned int j, unsigned int k, const std::vector<double> & values)
+{
+   ValueArray array;
+   if (!getValueArray (array) || j < array.firstJ || j - array.firstJ >= array.numJ || k >= array.numK) return false;
+   if (values.size () != array.numI) return false;
+
+   copyValues (values.data (), 1, &array (array.firstI, j, k), array.strideI, array.numI);
+   return true;
+}
+
+bool GridMap::getColumn (unsigned int i, unsigned int j, std::vector<double> & values) const
+{
+   ConstValueArray array;
+   if (!getValueArray (array) || i < array.firstI || i - array.firstI >= array.numI || j < array.firstJ || j - array.firstJ >= array.numJ) return false;
+
+   values.resize (array.numK);
+   copyValues (&array (i, j), array.strideK, values.data (), 1, array.numK);
+   return true;
+}
+
+bool GridMap::setColumn (unsigned int i, unsigned int j, const std::vector<double> & values)
+{
+   ValueArray array;
+   if (!getValueArray (array) || i < array.firstI || i - array.firstI >= array.numI || j < array.firstJ || j - array.firstJ >= array.numJ) return false;
+   if (values.size () != array.numK) return false;
+
+   copyValues (values.data (), 1, &array (i, j), array.strideK, array.numK);
+   return true;
+}
+
+bool GridMap::getAllValues (std::vector<double> & values) const
+{
+   ConstValueArray array;
+   if (!getValueArray (array)) return false;
+
+   values.resize (static_cast<size_t>(array.numI) * array.numJ * array.numK);
+   for (unsigned int i = 0; i < array.numI; ++i)
+   {
+      for (unsigned int j = 0; j < array.numJ; ++j)
+      {
+         copyValues (&array (array.firstI + i, array.firstJ + j), array.strideK,
+                     &values[(static_cast<size_t>(i) * array.numJ + j) * array.numK], 1, array.numK);
+      }
+   }
+   return true;
+}
+
+bool GridMap::setAllValues (const std::vector<double> & values)
+{
+   ValueArray array;
+   if (!getValueArray (array)) return false;
+   if (values.size () != static_cast<size_t>(array.numI) * array.numJ * array.numK) return false;
+
+   for (unsigned int i = 0; i < array.numI; ++i)
+   {
+      for (unsigned int j = 0; j < array.numJ; ++j)
+      {
+         copyValues (&values[(static_cast<size_t>(i) * array.numJ + j) * array.numK], 1,
+                     &array (array.firstI + i, array.firstJ + j), array.strideK, array.numK);
+      }
+   }
+   return true;
+}
@@ -12,6 +12,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "Interface.h"
 #include "Child.h"
@@ -100,6 +101,51 @@ namespace DataAccess
          /// Return the array of values managed by this GridMap
          virtual double const * const * const * getValues (void) const = 0;
 
+         /// Direct access to the values of a GridMap, for loops over many values without a virtual call per value.
+         /// The value at grid point (i, j, k) is data[(i - firstI) * strideI + (j - firstJ) * strideJ + k * strideK].
+         /// The array covers numI x numJ x numK points, including the ghost points if these have been retrieved.
+         /// The values along the direction with a stride of 1 are contiguous; which direction that is depends on the implementation.
+         /// A constant map can be read with all strides 0, every point sharing the one value.
+         template < class Value >
+         struct ValueArrayOf
+         {
+            Value * data;
+            unsigned int firstI, firstJ;
+            unsigned int numI, numJ, numK;
+            size_t strideI, strideJ, strideK;
+
+            Value & operator() (unsigned int i, unsigned int j, unsigned int k = 0) const
+            {
+               return data[(i - firstI) * strideI + (j - firstJ) * strideJ + k * strideK];
+            }
+         };
+
+         typedef ValueArrayOf<const double> ConstValueArray;
+         typedef ValueArrayOf<double> ValueArray;
+
+         /// Get the values for reading, valid until the data is restored.
+         /// Returns false if the data has not been retrieved.
+         virtual bool getValueArray (ConstValueArray & values) const = 0;
+
+         /// Get the values for writing, valid until the data is restored.
+         /// Returns false if the data has not been retrieved.
+         virtual bool getValueArray (ValueArray & values) = 0;
+
+         /// Copy the values along I at (j, k), over the retrieved range of I
+         bool getRow (unsigned int j, unsigned int k, std::vector<double> & values) const;
+         /// Set the values along I at (j, k), over the retrieved range of I
+         bool setRow (unsigned int j, unsigned int k, const std::vector<double> & values);
+
+         /// Copy the values of the column at (i, j), from k = 0 to the depth of the map
+         bool getColumn (unsigned int i, unsigned int j, std::vector<double> & values) const;
+         /// Set the values of the column at (i, j), from k = 0 to the depth of the map
+         bool setColumn (unsigned int i, unsigned int j, const std::vector<double> & values);
+
+         /// Copy all retrieved values, ordered by i, then j, then k
+         bool getAllValues (std::vector<double> & values) const;
+         /// Set all retrieved values, ordered by i, then j, then k
+         bool setAllValues (const std::vector<double> & values);
+
          /// Print the attributes and map values of this GridMap
          // May not work if user application is compiled under IRIX with CC -lang:std
          virtual void printOn (std::ostream &) const = 0;
@@ -1931,7 +1931,7 @@ bool ProjectHandle::addTheThinningHistoryMaps(const std::string& TableName, Pale
 			++snapshotIter;
 		}
 	}
-	sort(crustIoTbl->begin(), crustIoTbl->end(), CrustIoTblSorter);
+	crustIoTbl->sort(CrustIoTblSorter);
 	for (thicknessIter = newCrustalThicknesses.begin(); thicknessIter != newCrustalThicknesses.end(); ++thicknessIter) {
 		theThicknessEntries.push_back(*thicknessIter);
 	}
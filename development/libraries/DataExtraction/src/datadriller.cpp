@@ -24,6 +24,9 @@
 
 #include "UndefinedValues.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace DataExtraction
 {
 
@@ -31,7 +34,10 @@ DataDriller::DataDriller( const std::string& inputProjectFileName ) :
   DataExtractor(),
   m_obtained(),
   m_objectFactory( new DataAccess::Mining::ObjectFactory ),
-  m_projectHandle( dynamic_cast<Mining::ProjectHandle*>( OpenCauldronProject( inputProjectFileName, m_objectFactory ) ) )
+  m_projectHandle( dynamic_cast<Mining::ProjectHandle*>( OpenCauldronProject( inputProjectFileName, m_objectFactory ) ) ),
+  m_snapshotReader(),
+  m_snapshotFileName(),
+  m_mapsReaders()
 {
   database::Table* table = m_projectHandle->getTable( "DataMiningIoTbl" );
 
@@ -49,6 +55,7 @@ DataDriller::DataDriller( const std::string& inputProjectFileName ) :
 
 DataDriller::~DataDriller()
 {
+  releaseReaders();
   if ( m_projectHandle )
   {
     m_projectHandle->finishActivity( false );
@@ -63,12 +70,10 @@ DataAccess::Interface::ProjectHandle& DataDriller::getProjectHandle() const
 
 const GeoPhysics::GeoPhysicsFormation* DataExtraction::DataDriller::getFormation(const double i, const double j, const double z, const Snapshot* snapshot) const
 {
-    HDFReadManager hdfReadManager( *m_projectHandle );
-    const std::string snapshotFileName = m_projectHandle->getFullOutputDir() + "/" + snapshot->getFileName();
-    hdfReadManager.openSnapshotFile( snapshotFileName );
+    HDFReadManager& hdfReadManager = getSnapshotReader( snapshot );
 
     const std::string depthDataGroup = "/Depth";
-    if ( !checkDataGroupInHDFFile( hdfReadManager, depthDataGroup, snapshotFileName ) )
+    if ( !hdfReadManager.checkDataGroup( depthDataGroup ) )
     {
       return nullptr;
     }
@@ -77,28 +82,82 @@ const GeoPhysics::GeoPhysicsFormation* DataExtraction::DataDriller::getFormation
     for ( const Formation* formation : *myFormations )
     {
       const std::string depthPropertyFormationName = depthDataGroup + "/" + formation->getMangledName();
-      if ( !checkDataGroupInHDFFile( hdfReadManager, depthPropertyFormationName, snapshotFileName ) )
+      const DoubleMatrix depths = hdfReadManager.get3dCoordinatePropertyMatrix( {{ i, j}}, depthPropertyFormationName );
+      if ( depths.empty() )
       {
+          delete myFormations;
           return nullptr;
       }
-      DoubleVector depthVec = hdfReadManager.get3dCoordinatePropertyMatrix( {{ i, j}}, depthPropertyFormationName )[0];
+      const DoubleVector& depthVec = depths[0];
 
       for ( int zi = 0; zi < depthVec.size() - 1; ++zi )
       {
         const double kf = getKfraction( depthVec[zi+1], depthVec[zi], z );
         if ( kf >= 0 && kf <= 1 )
         {
+          delete myFormations;
           return dynamic_cast<const GeoPhysics::GeoPhysicsFormation*>( formation );
         }
       }
     }
     delete myFormations;
 
-    hdfReadManager.closeSnapshotFile();
-
     return nullptr;
 }
 
+std::vector<int> DataDriller::getRecordOrder( database::Table* table ) const
+{
+  // Records of the same snapshot are drilled together, so each snapshot is set up and each of its datasets read only once
+  std::vector<int> order( table->size() );
+  std::vector<double> times( table->size() );
+  for ( size_t recordIndex = 0; recordIndex < table->size(); ++recordIndex )
+  {
+    order[recordIndex] = recordIndex;
+    times[recordIndex] = database::getTime( table->getRecord( recordIndex ) );
+  }
+
+  std::stable_sort( order.begin(), order.end(), [&times]( const int a, const int b ) { return times[a] < times[b]; } );
+  return order;
+}
+
+HDFReadManager& DataDriller::getSnapshotReader( const Snapshot* snapshot ) const
+{
+  const std::string snapshotFileName = m_projectHandle->getFullOutputDir() + "/" + snapshot->getFileName();
+  if ( !m_snapshotReader || snapshotFileName != m_snapshotFileName )
+  {
+    m_snapshotReader.reset( new HDFReadManager( *m_projectHandle, true ) );
+    m_snapshotReader->openSnapshotFile( snapshotFileName );
+    m_snapshotFileName = snapshotFileName;
+
+    // The maps of the previous snapshot are not needed anymore; the maps files themselves hold all snapshots
+    for ( auto& mapsReader : m_mapsReaders )
+    {
+      mapsReader.second->releaseDatasets();
+    }
+  }
+
+  return *m_snapshotReader;
+}
+
+HDFReadManager& DataDriller::getMapsReader( const std::string& mapsFileName ) const
+{
+  std::unique_ptr<HDFReadManager>& mapsReader = m_mapsReaders[mapsFileName];
+  if ( !mapsReader )
+  {
+    mapsReader.reset( new HDFReadManager( *m_projectHandle, true ) );
+    mapsReader->openMapsFile( mapsFileName );
+  }
+
+  return *mapsReader;
+}
+
+void DataDriller::releaseReaders()
+{
+  m_snapshotReader.reset();
+  m_snapshotFileName.clear();
+  m_mapsReaders.clear();
+}
+
 bool DataDriller::allDataObtained()
 {
   for ( const bool obtained : m_obtained )
@@ -157,11 +216,9 @@ void DataDriller::perform3DDataMining()
 
   DerivedProperties::DerivedPropertyManager propertyManager( *m_projectHandle );
 
-  int recordIndex = -1;
-
-  for ( database::Record* record : *table )
+  for ( const int recordIndex : getRecordOrder( table ) )
   {
-    ++recordIndex;
+    database::Record* record = table->getRecord( recordIndex );
     if ( m_obtained[recordIndex] )
     {
       continue; // Already read from the HDF file directly;
@@ -306,11 +363,11 @@ const Grid *DataDriller::getGridLowResolution() const
 void DataDriller::performDirectDataDrilling()
 {
   database::Table* table = m_projectHandle->getTable( "DataMiningIoTbl" );
-  int recordIndex = -1;
   DerivedPropertyDriller derivedPropertyDriller(this);
-  for ( database::Record* record : *table )
+  const DataAccess::Interface::Snapshot* derivedPropertySnapshot = nullptr;
+  for ( const int recordIndex : getRecordOrder( table ) )
   {
-    ++recordIndex;
+    database::Record* record = table->getRecord( recordIndex );
     double value = DataAccess::Interface::DefaultUndefinedScalarValue;
     const DataAccess::Interface::Property* property = nullptr;
 
@@ -322,6 +379,13 @@ void DataDriller::performDirectDataDrilling()
 
       const DataAccess::Interface::Snapshot * snapshot = m_projectHandle->findSnapshot( snapshotTime, Interface::MAJOR | Interface::MINOR  );
 
+      // The derived properties of a snapshot are calculated together, before the data of the next snapshot is read
+      if ( snapshot != derivedPropertySnapshot )
+      {
+        setDerivedPropertyValues( derivedPropertyDriller, table, derivedPropertySnapshot );
+        derivedPropertySnapshot = snapshot;
+      }
+
       const double x = database::getXCoord( record );
       const double y = database::getYCoord( record );
       const double z = database::getZCoord( record );
@@ -357,12 +421,12 @@ void DataDriller::performDirectDataDrilling()
         derivedPropertyDriller.setRecord(record);
         derivedPropertyDriller.setSnapshot(snapshot);
 
-        m_obtained[recordIndex] = derivedPropertyDriller.run(value);
-
-        if ( !m_obtained[recordIndex] )
+        if ( derivedPropertyDriller.add(recordIndex) )
         {
-          m_obtained[recordIndex] = readPropertyFromHDF(surfaceName, formationName, x, y, z, snapshot, property, value);
+          continue; // The value is set when the derived properties of the snapshot are calculated
         }
+
+        m_obtained[recordIndex] = readPropertyFromHDF(surfaceName, formationName, x, y, z, snapshot, property, value);
       }
 
     }
@@ -377,37 +441,59 @@ void DataDriller::performDirectDataDrilling()
       database::setPropertyUnit( record, property->getUnit() );
     }
   }
+
+  setDerivedPropertyValues( derivedPropertyDriller, table, derivedPropertySnapshot );
+  releaseReaders();
+}
+
+void DataDriller::setDerivedPropertyValues( DerivedPropertyDriller& derivedPropertyDriller, database::Table* table, const Snapshot* snapshot )
+{
+  for ( const std::pair<int, double>& recordValue : derivedPropertyDriller.calculate() )
+  {
+    const int recordIndex = recordValue.first;
+    database::Record* record = table->getRecord( recordIndex );
+    double value = recordValue.second;
+    const DataAccess::Interface::Property* property = m_projectHandle->findProperty( database::getPropertyName( record ) );
+
+    m_obtained[recordIndex] = std::fabs( value - DataAccess::Interface::DefaultUndefinedScalarValue ) > 1e-4;
+
+    try
+    {
+      if ( !m_obtained[recordIndex] )
+      {
+        m_obtained[recordIndex] = readPropertyFromHDF( database::getSurfaceName( record ), database::getFormationName( record ),
+                                                       database::getXCoord( record ), database::getYCoord( record ), database::getZCoord( record ),
+                                                       snapshot, property, value );
+      }
+    }
+    catch( const RecordException & recordException )
+    {
+      std::cerr << "Error in row " << recordIndex + 1 << " of DataMiningIoTbl: " << recordException.what () << std::endl;
+    }
+
+    database::setValue( record, value );
+    database::setPropertyUnit( record, property->getUnit() );
+  }
 }
 
 bool DataDriller::get2dPropertyFromHDF( const double i, const double j, const Surface* surface, const Formation* formation,
                                         const Property* property, const Snapshot* snapshot, double& value ) const
 {
-  HDFReadManager hdfReadManager( *m_projectHandle );
-  hdfReadManager.openMapsFile( getMapsFileName( property->getCauldronName() ) );
+  // Make sure the maps of another snapshot are released
+  getSnapshotReader( snapshot );
+
+  HDFReadManager& hdfReadManager = getMapsReader( getMapsFileName( property->getCauldronName() ) );
   const std::string propertyFormationDataGroup = getPropertyFormationDataGroupName( formation, surface, property, snapshot );
   const DoubleVector values = hdfReadManager.get2dCoordinatePropertyVector( {{i, j}}, propertyFormationDataGroup );
   if ( !values.empty() )
   {
-    hdfReadManager.closeMapsFile();
     value = values[0];
     return true;
   }
 
-  hdfReadManager.closeMapsFile();
   return false;
 }
 
-bool DataDriller::checkDataGroupInHDFFile(HDFReadManager& hdfReadManager, const std::string& dataGroup, const std::string& snapshotFileName) const
-{
-  if ( !hdfReadManager.checkDataGroup( dataGroup ) )
-  {
-    hdfReadManager.closeSnapshotFile();
-    return false;
-  }
-
-  return true;
-}
-
 bool DataDriller::get3dPropertyFromHDF( const double i, const double j, const double z,
                                           const DataAccess::Interface::Property* property,
                                           const DataAccess::Interface::Snapshot* snapshot,
@@ -419,14 +505,12 @@ bool DataDriller::get3dPropertyFromHDF( const double i, const double j, const do
     return false;
   }
 
-  HDFReadManager hdfReadManager( *m_projectHandle );
-  const std::string snapshotFileName = m_projectHandle->getFullOutputDir() + "/" + snapshot->getFileName();
-  hdfReadManager.openSnapshotFile( snapshotFileName );
+  HDFReadManager& hdfReadManager = getSnapshotReader( snapshot );
 
   const std::string depthDataGroup = "/Depth";
   const std::string propertyDataGroup = "/" + property->getName();
-  if ( !checkDataGroupInHDFFile( hdfReadManager, depthDataGroup, snapshotFileName ) ||
-       !checkDataGroupInHDFFile( hdfReadManager, propertyDataGroup, snapshotFileName ) )
+  if ( !hdfReadManager.checkDataGroup( depthDataGroup ) ||
+       !hdfReadManager.checkDataGroup( propertyDataGroup ) )
   {
     return false;
   }
@@ -436,8 +520,12 @@ bool DataDriller::get3dPropertyFromHDF( const double i, const double j, const do
   for ( const Formation* formation : *myFormations )
   {
     const std::string depthPropertyFormationName = depthDataGroup + "/" + formation->getMangledName();
-    checkDataGroupInHDFFile( hdfReadManager, depthPropertyFormationName, snapshotFileName );
-    DoubleVector depthVec = hdfReadManager.get3dCoordinatePropertyMatrix( {{ i, j}}, depthPropertyFormationName )[0];
+    const DoubleMatrix depths = hdfReadManager.get3dCoordinatePropertyMatrix( {{ i, j}}, depthPropertyFormationName );
+    if ( depths.empty() )
+    {
+      continue;
+    }
+    const DoubleVector& depthVec = depths[0];
 
     for ( int zi = 0; zi < depthVec.size() - 1; ++zi )
     {
@@ -445,11 +533,13 @@ bool DataDriller::get3dPropertyFromHDF( const double i, const double j, const do
       if ( kf >= 0 && kf <= 1 )
       {
         const std::string propertyFormationDataGroup = propertyDataGroup + "/" + formation->getMangledName();
-        if( !checkDataGroupInHDFFile( hdfReadManager, propertyFormationDataGroup, snapshotFileName ) )
+        const DoubleMatrix properties = hdfReadManager.get3dCoordinatePropertyMatrix( {{ i, j}}, propertyFormationDataGroup );
+        if( properties.empty() )
         {
+          delete myFormations;
           return false;
         }
-        DoubleVector propertyVec = hdfReadManager.get3dCoordinatePropertyMatrix( {{ i, j}}, propertyFormationDataGroup )[0];
+        const DoubleVector& propertyVec = properties[0];
 
         value = interpolate1d( propertyVec[zi+1], propertyVec[zi], kf );
         found = true;
@@ -460,8 +550,6 @@ bool DataDriller::get3dPropertyFromHDF( const double i, const double j, const do
   }
   delete myFormations;
 
-  hdfReadManager.closeSnapshotFile();
-
   return found;
 }
 
@@ -471,28 +559,24 @@ bool DataDriller::get3dPropertyFromHDF( const double i, const double j,
                                           const DataAccess::Interface::Property * property,
                                           const DataAccess::Interface::Snapshot * snapshot, double& value ) const
 {
-  HDFReadManager hdfReadManager( *m_projectHandle );
-  const std::string snapshotFileName = m_projectHandle->getFullOutputDir() + "/" + snapshot->getFileName();
-  hdfReadManager.openSnapshotFile( snapshotFileName );
+  HDFReadManager& hdfReadManager = getSnapshotReader( snapshot );
 
   const std::string propertyDataGroup = "/" + property->getName();
   const std::string propertyFormationDataGroup = propertyDataGroup + "/" + mangledName;
-  if ( !checkDataGroupInHDFFile( hdfReadManager, propertyDataGroup, snapshotFileName ) ||
-       !checkDataGroupInHDFFile( hdfReadManager, propertyFormationDataGroup, snapshotFileName) ||
+  if ( !hdfReadManager.checkDataGroup( propertyDataGroup ) ||
+       !hdfReadManager.checkDataGroup( propertyFormationDataGroup ) ||
        mangledName == "")
   {
        return false;
   }
 
-  DoubleVector propertyVec = hdfReadManager.get3dCoordinatePropertyMatrix( {{ i, j}}, propertyFormationDataGroup )[0];
+  const DoubleMatrix properties = hdfReadManager.get3dCoordinatePropertyMatrix( {{ i, j}}, propertyFormationDataGroup );
 
-  if (!propertyVec.empty())
+  if (!properties.empty() && !properties[0].empty())
   {
-    value = (isSurfaceTop ? propertyVec.back() : propertyVec.front());
+    value = (isSurfaceTop ? properties[0].back() : properties[0].front());
   }
 
-  hdfReadManager.closeSnapshotFile();
-
   return true;
 }
 
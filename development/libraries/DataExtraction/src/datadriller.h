@@ -12,6 +12,7 @@
 
 #include "dataExtractor.h"
 
+#include <map>
 #include <string>
 #include <vector>
 #include <memory>
@@ -25,6 +26,11 @@ class ObjectFactory;
 }
 }
 
+namespace database
+{
+class Table;
+}
+
 namespace GeoPhysics
 {
 class GeoPhysicsFormation;
@@ -33,6 +39,7 @@ class GeoPhysicsFormation;
 namespace DataExtraction
 {
 
+class DerivedPropertyDriller;
 class HDFReadManager;
 
 class DataDriller : public DataExtractor
@@ -55,11 +62,16 @@ private:
   void performDirectDataDrilling();
   void perform3DDataMining();
   bool allDataObtained();
+  std::vector<int> getRecordOrder( database::Table* table ) const;
+  void setDerivedPropertyValues( DerivedPropertyDriller& derivedPropertyDriller, database::Table* table, const DataAccess::Interface::Snapshot* snapshot );
+
+  HDFReadManager& getSnapshotReader( const DataAccess::Interface::Snapshot* snapshot ) const;
+  HDFReadManager& getMapsReader( const std::string& mapsFileName ) const;
+  void releaseReaders();
 
   bool get2dPropertyFromHDF( const double i, const double j, const DataAccess::Interface::Surface* surface, const DataAccess::Interface::Formation* formation,
                              const DataAccess::Interface::Property* property, const DataAccess::Interface::Snapshot* snapshot, double& value ) const;
 
-  bool checkDataGroupInHDFFile( HDFReadManager& hdfReadManager, const std::string& dataGroup, const std::string& snapshotFileName ) const;
   bool get3dPropertyFromHDF( const double i,  const double j, const double z, const DataAccess::Interface::Property* property,
                              const DataAccess::Interface::Snapshot* snapshot, double& value ) const;
   bool get3dPropertyFromHDF( const double i, const double j, const std::string& mangledName, const bool isSurfaceTop, const DataAccess::Interface::Property* property,
@@ -73,6 +85,11 @@ private:
   std::unique_ptr<DataAccess::Mining::ProjectHandle> m_projectHandle;
   const DataAccess::Interface::Grid* m_gridHighResolution;
   const DataAccess::Interface::Grid* m_gridLowResolution;
+
+  // Files stay open, and the datasets read from them in memory, while records of the same snapshot are drilled
+  mutable std::unique_ptr<HDFReadManager> m_snapshotReader;
+  mutable std::string m_snapshotFileName;
+  mutable std::map<std::string, std::unique_ptr<HDFReadManager>> m_mapsReaders;
 };
 
 } // namespace DataExtraction
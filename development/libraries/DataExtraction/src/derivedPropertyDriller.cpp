@@ -40,7 +40,10 @@ DerivedPropertyDriller::DerivedPropertyDriller( const DataDriller* dataDriller )
   m_record{nullptr},
   m_snapshot{nullptr},
   m_obtainedProperties{},
-  m_dataDriller{dataDriller}
+  m_dataDriller{dataDriller},
+  m_calculators{},
+  m_dependentValues{},
+  m_batches{}
 {
 }
 
@@ -54,13 +57,53 @@ void DerivedPropertyDriller::setSnapshot(const Snapshot *snapshot)
   m_snapshot = snapshot;
 }
 
-bool DerivedPropertyDriller::run( double& value )
+bool DerivedPropertyDriller::add( const int recordIndex )
 {
+  const std::string& propertyName = getPropertyName( m_record );
+  const AbstractDerivedProperties::FormationPropertyCalculator* calculator = getCalculator( propertyName );
+  if ( !calculator )
+  {
+    return false;
+  }
+
   m_obtainedProperties.clear();
-  const std::vector<std::string> dependentProperties = defineDependentProperties( getPropertyName( m_record) );
-  obtainDependentProperties( dependentProperties );
-  value = calculateProperty( getPropertyName( m_record ) );
-  return std::fabs(value - DefaultUndefinedScalarValue) > 1e-4;
+  obtainDependentProperties( calculator->getDependentPropertyNames() );
+
+  const GeoPhysics::GeoPhysicsFormation* formation = nullptr;
+  const GeoPhysics::CompoundLithology* lithology = nullptr;
+  if ( !findLithology( formation, lithology ) )
+  {
+    return false;
+  }
+
+  Batch& batch = m_batches[{propertyName, formation}];
+  batch.recordIndices.push_back( recordIndex );
+  batch.lithologies.push_back( lithology );
+  addDependentValues( calculator, batch.dependentValues );
+  return true;
+}
+
+std::vector<std::pair<int, double>> DerivedPropertyDriller::calculate()
+{
+  std::vector<std::pair<int, double>> recordValues;
+  std::vector<double> values;
+
+  for ( const auto& propertyBatch : m_batches )
+  {
+    const Batch& batch = propertyBatch.second;
+
+    values.assign( batch.recordIndices.size(), DefaultUndefinedScalarValue );
+    getCalculator( propertyBatch.first.first )->calculateAtPositions( propertyBatch.first.second, batch.lithologies.data(), values.size(),
+                                                                        batch.dependentValues.data(), values.data() );
+
+    for ( size_t p = 0; p < values.size(); ++p )
+    {
+      recordValues.emplace_back( batch.recordIndices[p], values[p] );
+    }
+  }
+
+  m_batches.clear();
+  return recordValues;
 }
 
 double DerivedPropertyDriller::run(const std::string& alternativePropertyName)
@@ -111,9 +154,19 @@ AbstractDerivedProperties::FormationPropertyCalculator* DerivedPropertyDriller::
   return nullptr;
 }
 
+const AbstractDerivedProperties::FormationPropertyCalculator* DerivedPropertyDriller::getCalculator(const std::string& propertyName) const
+{
+  std::map<std::string, std::unique_ptr<AbstractDerivedProperties::FormationPropertyCalculator>>::iterator found = m_calculators.find(propertyName);
+  if (found == m_calculators.end())
+  {
+    found = m_calculators.emplace(propertyName, std::unique_ptr<AbstractDerivedProperties::FormationPropertyCalculator>(initializeCalculator(propertyName))).first;
+  }
+  return found->second.get();
+}
+
 std::vector<std::string> DerivedPropertyDriller::defineDependentProperties(const std::string& propertyName) const
 {
-  std::unique_ptr<AbstractDerivedProperties::FormationPropertyCalculator> calculator(initializeCalculator(propertyName));
+  const AbstractDerivedProperties::FormationPropertyCalculator* calculator = getCalculator(propertyName);
   if (calculator)
   {
     return calculator->getDependentPropertyNames();
@@ -181,12 +234,20 @@ const GeoPhysics::CompoundLithology* DerivedPropertyDriller::getLithology(const
   return formation->getLithologyFromStratTable( undefinedMapValue, useMaps, i, j, lithoMap1, lithoMap2, lithoMap3, lithoName1, lithoName2, lithoName3);
 }
 
-double DerivedPropertyDriller::calculateProperty( const std::string& propertyName ) const
+void DerivedPropertyDriller::addDependentValues( const AbstractDerivedProperties::FormationPropertyCalculator* calculator, std::vector<double>& dependentValues ) const
+{
+  for ( const std::string& dependentProperty : calculator->getDependentPropertyNames() )
+  {
+    dependentValues.push_back( m_obtainedProperties.at( dependentProperty ) );
+  }
+}
+
+bool DerivedPropertyDriller::findLithology( const GeoPhysics::GeoPhysicsFormation*& formation, const GeoPhysics::CompoundLithology*& lithology ) const
 {
   unsigned int i, j;
   double x = getXCoord( m_record );
   double y = getYCoord( m_record );
-  const GeoPhysics::GeoPhysicsFormation* formation = dynamic_cast<const GeoPhysics::GeoPhysicsFormation*>( m_dataDriller->getProjectHandle().findFormation(getFormationName( m_record ) ) );
+  formation = dynamic_cast<const GeoPhysics::GeoPhysicsFormation*>( m_dataDriller->getProjectHandle().findFormation(getFormationName( m_record ) ) );
 
   if ( !m_dataDriller->getGridLowResolution()->getGridPoint( x, y, i, j ) ) throw RecordException( "Illegal (XCoord, YCoord) pair: (%, %)", x, y );
 
@@ -210,31 +271,27 @@ double DerivedPropertyDriller::calculateProperty( const std::string& propertyNam
   // Since the lithology percentages are inputs, we need the i, j indices related to the high-res
   // input grid instead of the low res output grid
   m_dataDriller->getProjectHandle().getInputGrid()->getGridPoint( x, y, i, j );
-  const GeoPhysics::CompoundLithology* lithology = getLithology( i, j, formation );
-  if (!lithology)
+  lithology = getLithology( i, j, formation );
+  return lithology && formation;
+}
+
+double DerivedPropertyDriller::calculateProperty( const std::string& propertyName ) const
+{
+  // Implemented Direct Derived Properties, see initializeCalculator
+  // LithoStaticPressure and ThCondVec2 return a DefaultUndefinedScalarValue for the basement
+  const AbstractDerivedProperties::FormationPropertyCalculator* calculator = getCalculator( propertyName );
+  const GeoPhysics::GeoPhysicsFormation* formation = nullptr;
+  const GeoPhysics::CompoundLithology* lithology = nullptr;
+
+  if ( !calculator || !findLithology( formation, lithology ) )
   {
     return DefaultUndefinedScalarValue;
   }
 
-  // Implemented Direct Derived Properties
-  if ( propertyName == "Porosity" ||
-       propertyName == "Permeability" ||
-       propertyName == "LithoStaticPressure" || // For the basement it returns a DefaultUndefinedScalarValue
-       propertyName == "DiffusivityVec2" ||
-       propertyName == "Velocity" ||
-       propertyName == "BrineViscosity" ||
-       propertyName == "BrineDensity" ||
-       propertyName == "BulkDensity" ||
-       propertyName == "SonicSlowness" ||
-       propertyName == "GammaRay" ||
-       propertyName == "ThCondVec2" )   // For the basement it returns a DefaultUndefinedScalarValue
-  {
-    if ( formation )
-    {
-      std::unique_ptr<AbstractDerivedProperties::FormationPropertyCalculator> calculator( initializeCalculator( propertyName ) );
-      return calculator->calculateAtPosition( formation, lithology, m_obtainedProperties );
-    }
-  }
+  m_dependentValues.clear();
+  addDependentValues( calculator, m_dependentValues );
 
-  return DefaultUndefinedScalarValue;
+  double value = DefaultUndefinedScalarValue;
+  calculator->calculateAtPositions( formation, &lithology, 1, m_dependentValues.data(), &value );
+  return value;
 }
@@ -11,6 +11,9 @@
 
 #include <string>
 #include <map>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "datadriller.h"
 
@@ -45,15 +48,35 @@ namespace DataExtraction
   {
   public:
     DerivedPropertyDriller( const DataDriller* dataDriller );
-    bool run(double& value);
     void setRecord(database::Record* record);
     void setSnapshot(const DataAccess::Interface::Snapshot *snapshot);
 
+    /// Add the record to the records of its property in its formation, whose values are calculated together
+    ///
+    /// Returns false if the property cannot be calculated at the record.
+    bool add(const int recordIndex);
+    /// Calculate the property at all added records, giving the value of each by record index
+    std::vector<std::pair<int, double>> calculate();
+
   private:
+    /// The records of a property in a formation, with the lithology and the dependent property values of each
+    struct Batch
+    {
+      std::vector<int> recordIndices;
+      std::vector<const GeoPhysics::CompoundLithology*> lithologies;
+      std::vector<double> dependentValues;
+    };
+
     database::Record* m_record;
     const DataAccess::Interface::Snapshot* m_snapshot;
     std::map<std::string, double> m_obtainedProperties;
     const DataDriller* m_dataDriller;
+    /// Calculators by property name, created on first use and kept for all records
+    mutable std::map<std::string, std::unique_ptr<AbstractDerivedProperties::FormationPropertyCalculator>> m_calculators;
+    /// Dependent property values of the calculator, in the order of its dependent property names
+    mutable std::vector<double> m_dependentValues;
+    /// Added records by property name and formation
+    std::map<std::pair<std::string, const GeoPhysics::GeoPhysicsFormation*>, Batch> m_batches;
 
     double run(const std::string& alternativePropertyName);
 
@@ -61,7 +84,10 @@ namespace DataExtraction
     void obtainDependentProperties(const std::vector<std::string>& dependentProperties);
     double obtainValue(const std::string& propertyName);
     double calculateProperty(const std::string &propertyName) const;
+    bool findLithology(const GeoPhysics::GeoPhysicsFormation*& formation, const GeoPhysics::CompoundLithology*& lithology) const;
+    void addDependentValues(const AbstractDerivedProperties::FormationPropertyCalculator* calculator, std::vector<double>& dependentValues) const;
     AbstractDerivedProperties::FormationPropertyCalculator *initializeCalculator(const std::string &propertyName) const;
+    const AbstractDerivedProperties::FormationPropertyCalculator* getCalculator(const std::string &propertyName) const;
     const GeoPhysics::CompoundLithology* getLithology(const unsigned int i, const unsigned int j, const GeoPhysics::GeoPhysicsFormation* formation) const;
   };
 }
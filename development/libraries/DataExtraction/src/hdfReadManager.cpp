@@ -23,10 +23,13 @@ using namespace ibs;
 namespace DataExtraction
 {
 
-HDFReadManager::HDFReadManager( const DataAccess::Interface::ProjectHandle& projectHandle ) :
+HDFReadManager::HDFReadManager( const DataAccess::Interface::ProjectHandle& projectHandle, const bool cacheDatasets ) :
    m_projectHandle( projectHandle ),
    m_mapsFileId( 0 ),
-   m_snapshotFileId( 0 )
+   m_snapshotFileId( 0 ),
+   m_cacheDatasets( cacheDatasets ),
+   m_mapsDatasets(),
+   m_snapshotDatasets()
 {
 }
 
@@ -54,6 +57,13 @@ void HDFReadManager::closeSnapshotFile()
       H5Fclose( m_snapshotFileId );
       m_snapshotFileId = 0;
    }
+   m_snapshotDatasets.clear();
+}
+
+void HDFReadManager::releaseDatasets()
+{
+   m_mapsDatasets.clear();
+   m_snapshotDatasets.clear();
 }
 
 void HDFReadManager::openMapsFile( const std::string& mapFileName )
@@ -80,6 +90,49 @@ void HDFReadManager::closeMapsFile()
       H5Fclose( m_mapsFileId );
       m_mapsFileId = 0;
    }
+   m_mapsDatasets.clear();
+}
+
+const HDFReadManager::Dataset* HDFReadManager::getDataset( const hid_t fileId, const std::string& dataGroup, const int rank,
+                                                           std::map<std::string, Dataset>& datasets )
+{
+   std::map<std::string, Dataset>::const_iterator found = datasets.find( dataGroup );
+   if ( found != datasets.end() )
+   {
+      return found->second.values.empty() ? nullptr : &found->second;
+   }
+
+   // Datasets that cannot be read are kept as well, empty, so they are only looked up once
+   Dataset& dataset = datasets[dataGroup];
+   if ( fileId <= 0 || H5Lexists( fileId, dataGroup.c_str(), NULL ) <= 0 )
+   {
+      return nullptr;
+   }
+
+   const hid_t datasetId = H5Dopen2( fileId, dataGroup.c_str(), H5P_DEFAULT );
+   const hid_t datatype = H5Dget_type( datasetId );
+   const hid_t dataspace = H5Dget_space( datasetId );
+
+   dataset.dims[0] = dataset.dims[1] = dataset.dims[2] = 1;
+   if ( H5Sget_simple_extent_ndims( dataspace ) == rank )
+   {
+      H5Sget_simple_extent_dims( dataspace, dataset.dims, NULL );
+   }
+
+   if ( dataset.dims[0] >= 2 && dataset.dims[1] >= 2 )
+   {
+      dataset.values.resize( dataset.dims[0] * dataset.dims[1] * dataset.dims[2] );
+      if ( H5Dread( datasetId, datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, dataset.values.data() ) < 0 )
+      {
+         dataset.values.clear();
+      }
+   }
+
+   H5Sclose( dataspace );
+   H5Tclose( datatype );
+   H5Dclose( datasetId );
+
+   return dataset.values.empty() ? nullptr : &dataset;
 }
 
 DoubleVector HDFReadManager::get2dCoordinatePropertyVector( const DoublePairVector& coordinates,
@@ -87,6 +140,32 @@ DoubleVector HDFReadManager::get2dCoordinatePropertyVector( const DoublePairVect
 {
    DoubleVector coordinatePropertyVector;
 
+   if ( m_cacheDatasets )
+   {
+      const Dataset* dataset = getDataset( m_mapsFileId, propertyFormationDataGroup, 2, m_mapsDatasets );
+      if ( !dataset )
+      {
+         return coordinatePropertyVector;
+      }
+
+      const hsize_t* dims = dataset->dims;
+      for ( const DoublePair& coordinate : coordinates )
+      {
+         const double i = coordinate.first;
+         const double j = coordinate.second;
+
+         const unsigned int i1 = std::min(static_cast<unsigned int>(i), static_cast<unsigned int>(dims[0] - 2));
+         const double di = i - i1;
+         const unsigned int j1 = std::min(static_cast<unsigned int>(j), static_cast<unsigned int>(dims[1] - 2));
+         const double dj = j - j1;
+
+         const float* ll = &dataset->values[i1 * dims[1] + j1];
+         const float* lr = ll + dims[1];
+         coordinatePropertyVector.push_back( interpolate2d( ll[0], lr[0], ll[1], lr[1], di, dj ) );
+      }
+      return coordinatePropertyVector;
+   }
+
    if ( m_mapsFileId <= 0 || H5Lexists( m_mapsFileId, propertyFormationDataGroup.c_str(), NULL ) <= 0 )
    {
       return coordinatePropertyVector;
@@ -144,6 +223,40 @@ DoubleMatrix HDFReadManager::get3dCoordinatePropertyMatrix( const DoublePairVect
 {
    DoubleMatrix coordinatePropertyMatrix;
 
+   if ( m_cacheDatasets )
+   {
+      const Dataset* dataset = getDataset( m_snapshotFileId, propertyFormationDataGroup, 3, m_snapshotDatasets );
+      if ( !dataset )
+      {
+         return coordinatePropertyMatrix;
+      }
+
+      const hsize_t* dims = dataset->dims;
+      for ( const DoublePair& coordinate : coordinates )
+      {
+         const double i = coordinate.first;
+         const double j = coordinate.second;
+
+         const unsigned int i1 = std::min(static_cast<unsigned int>(i), static_cast<unsigned int>(dims[0] - 2));
+         const double di = i - i1;
+         const unsigned int j1 = std::min(static_cast<unsigned int>(j), static_cast<unsigned int>(dims[1] - 2));
+         const double dj = j - j1;
+
+         const float* ll = &dataset->values[( i1 * dims[1] + j1 ) * dims[2]];
+         const float* lr = ll + dims[1] * dims[2];
+         const float* tl = ll + dims[2];
+         const float* tr = lr + dims[2];
+
+         std::vector<double> propertyVec( dims[2] );
+         for ( int zi = 0; zi < dims[2]; ++zi )
+         {
+            propertyVec[zi] = interpolate3d( ll[zi], lr[zi], tl[zi], tr[zi], di, dj );
+         }
+         coordinatePropertyMatrix.push_back( propertyVec );
+      }
+      return coordinatePropertyMatrix;
+   }
+
    if ( m_snapshotFileId <= 0 || !checkDataGroup( propertyFormationDataGroup ) )
    {
       return coordinatePropertyMatrix;
@@ -189,24 +302,7 @@ DoubleMatrix HDFReadManager::get3dCoordinatePropertyMatrix( const DoublePairVect
          const double tl = propertyData[0][1][zi];
          const double tr = propertyData[1][1][zi];
 
-         const double interpolatedValue = interpolate2d( ll, lr, tl, tr, di, dj );
-
-         if (Utilities::isValueUndefined(ll)
-             || Utilities::isValueUndefined(lr)
-             || Utilities::isValueUndefined(tl)
-             || Utilities::isValueUndefined(tr))
-         {
-            //The requested point could be right on the edge. In that case, the value should still be written.
-            if ( !(NumericFunctions::isEqual(interpolatedValue,ll,Utilities::Numerical::DefaultNumericalTolerance)
-                   || NumericFunctions::isEqual(interpolatedValue,lr,Utilities::Numerical::DefaultNumericalTolerance)
-                   || NumericFunctions::isEqual(interpolatedValue,tl,Utilities::Numerical::DefaultNumericalTolerance)
-                   || NumericFunctions::isEqual(interpolatedValue,tr,Utilities::Numerical::DefaultNumericalTolerance)))
-            {
-               propertyVec.push_back( Utilities::Numerical::CauldronNoDataValue);
-               continue;
-            }
-         }
-         propertyVec.push_back( interpolatedValue );
+         propertyVec.push_back( interpolate3d( ll, lr, tl, tr, di, dj ) );
       }
 
       coordinatePropertyMatrix.push_back(propertyVec);
@@ -229,4 +325,25 @@ double HDFReadManager::interpolate2d( const double ll, const double lr, const do
    return ((x1*ll)+(x2*lr))*(1-dj) + ((x1*tl)+(x2*tr))*(dj);
 }
 
+double HDFReadManager::interpolate3d( const double ll, const double lr, const double tl, const double tr, const double di, const double dj )
+{
+   const double interpolatedValue = interpolate2d( ll, lr, tl, tr, di, dj );
+
+   if (Utilities::isValueUndefined(ll)
+       || Utilities::isValueUndefined(lr)
+       || Utilities::isValueUndefined(tl)
+       || Utilities::isValueUndefined(tr))
+   {
+      //The requested point could be right on the edge. In that case, the value should still be written.
+      if ( !(NumericFunctions::isEqual(interpolatedValue,ll,Utilities::Numerical::DefaultNumericalTolerance)
+             || NumericFunctions::isEqual(interpolatedValue,lr,Utilities::Numerical::DefaultNumericalTolerance)
+             || NumericFunctions::isEqual(interpolatedValue,tl,Utilities::Numerical::DefaultNumericalTolerance)
+             || NumericFunctions::isEqual(interpolatedValue,tr,Utilities::Numerical::DefaultNumericalTolerance)))
+      {
+         return Utilities::Numerical::CauldronNoDataValue;
+      }
+   }
+   return interpolatedValue;
+}
+
 } // namespace DataExtraction
@@ -14,6 +14,7 @@
 
 #include <hdf5.h>
 
+#include <map>
 #include <string>
 #include <vector>
 #include <memory>
@@ -30,10 +31,12 @@ class ProjectHandle;
 namespace DataExtraction
 {
 
+// When datasets are cached, each dataset is read as a whole the first time a coordinate is requested from it,
+// and later coordinates are interpolated from memory until the file is closed or the datasets are released
 class HDFReadManager
 {
 public:
-  explicit HDFReadManager( const DataAccess::Interface::ProjectHandle& projectHandle );
+  explicit HDFReadManager( const DataAccess::Interface::ProjectHandle& projectHandle, const bool cacheDatasets = false );
   virtual ~HDFReadManager();
 
   void openMapsFile( const std::string& mapFileName );
@@ -41,17 +44,31 @@ public:
   bool openSnapshotFile( const std::string& snapshotFileName );
   bool checkDataGroup( const std::string& dataGroup );
   void closeSnapshotFile();
+  void releaseDatasets();
 
   DoubleVector get2dCoordinatePropertyVector( const DoublePairVector&, const std::string& propertyFormationDataGroup );
   DoubleMatrix get3dCoordinatePropertyMatrix( const DoublePairVector&, const std::string& propertyFormationDataGroup );
 
 private:
-  double interpolate2d( const double ll, const double lr, const double tl,
-                        const double tr, const double di, const double dj );
+  struct Dataset
+  {
+    std::vector<float> values; // ordered by i, then j, then k
+    hsize_t dims[3];
+  };
+
+  const Dataset* getDataset( const hid_t fileId, const std::string& dataGroup, const int rank, std::map<std::string, Dataset>& datasets );
+
+  static double interpolate2d( const double ll, const double lr, const double tl,
+                               const double tr, const double di, const double dj );
+  static double interpolate3d( const double ll, const double lr, const double tl,
+                               const double tr, const double di, const double dj );
 
   const DataAccess::Interface::ProjectHandle& m_projectHandle;
   hid_t m_mapsFileId;
   hid_t m_snapshotFileId;
+  const bool m_cacheDatasets;
+  std::map<std::string, Dataset> m_mapsDatasets;
+  std::map<std::string, Dataset> m_snapshotDatasets;
 };
 
 
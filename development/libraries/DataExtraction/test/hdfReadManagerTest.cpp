@@ -86,3 +86,36 @@ TEST( hdfReadManager, readFromOutputMap )
    }
 
 }
+
+TEST( hdfReadManager, cachedDatasetsMatchDirectReads )
+{
+   std::unique_ptr<DataAccess::Mining::ObjectFactory> objectFactory
+         = std::unique_ptr<DataAccess::Mining::ObjectFactory>(new DataAccess::Mining::ObjectFactory);
+
+   std::unique_ptr<DataAccess::Interface::ProjectHandle> projectHandle =
+         std::unique_ptr<DataAccess::Interface::ProjectHandle>(OpenCauldronProject( "Project.project3d", objectFactory.get()));
+
+   DataExtraction::HDFReadManager readManager(*projectHandle);
+   DataExtraction::HDFReadManager cachedReadManager(*projectHandle, true);
+
+   readManager.openSnapshotFile("Time_0.000000.h5");
+   cachedReadManager.openSnapshotFile("Time_0.000000.h5");
+
+   const DataExtraction::DoublePairVector coordinates = {{ 0.5, 0.5}, { 1, 1+Utilities::Numerical::DefaultNumericalTolerance}, { 2, 0}, { 2, 1}, { 1, 1}, { 1.25, 0.75}};
+
+   // All coordinates at once, and one by one from the same cached dataset
+   const DataExtraction::DoubleMatrix expected = readManager.get3dCoordinatePropertyMatrix(coordinates, "/Temperature/l1");
+   ASSERT_EQ(expected.size(), coordinates.size());
+   EXPECT_EQ(cachedReadManager.get3dCoordinatePropertyMatrix(coordinates, "/Temperature/l1"), expected);
+
+   for (size_t n = 0; n < coordinates.size(); ++n)
+   {
+      EXPECT_EQ(cachedReadManager.get3dCoordinatePropertyMatrix({coordinates[n]}, "/Temperature/l1")[0], expected[n]);
+   }
+
+   EXPECT_TRUE(cachedReadManager.get3dCoordinatePropertyMatrix(coordinates, "/Temperature/unknown").empty());
+
+   // Released datasets are read again
+   cachedReadManager.releaseDatasets();
+   EXPECT_EQ(cachedReadManager.get3dCoordinatePropertyMatrix(coordinates, "/Temperature/l1"), expected);
+}
@@ -17,6 +17,42 @@
 
 using namespace AbstractDerivedProperties;
 
+namespace
+{
+   /// \brief Interpolates the depths of the node columns at the corners of an element.
+   class ElementDepths
+   {
+   public :
+
+      ElementDepths( const DataAccess::Mining::ElementPosition& element, const double* corners[4] ) :
+         m_xi( element.getReferencePoint ().x ()),
+         m_eta( element.getReferencePoint ().y ())
+      {
+         for ( int l = 0; l < 4; ++l ) m_corners[l] = corners[l];
+      }
+
+      /// \brief The depth at the node of the node columns, the same as interpolating the depth property.
+      double operator ()( size_t node ) const
+      {
+         const double weights[4] = { m_corners[0][node], m_corners[1][node], m_corners[2][node], m_corners[3][node] };
+         return m_interpolate.doInterpolation( m_xi, m_eta, weights );
+      }
+
+      /// \brief Whether the interpolated depths increase downwards, given that the depths of the node columns do.
+      bool isMonotone() const
+      {
+         return NumericFunctions::inRange( m_xi, -1.0, 1.0 ) and NumericFunctions::inRange( m_eta, -1.0, 1.0 );
+      }
+
+   private :
+
+      const double* m_corners[4];
+      const double m_xi;
+      const double m_eta;
+      DataAccess::Mining::PropertyInterpolator2D m_interpolate;
+   };
+}
+
 //------------------------------------------------------------//
 DataAccess::Mining::CauldronDomain::CauldronDomain( Interface::ProjectHandle * handle )
    : m_projectHandle( handle )
@@ -37,12 +73,198 @@ void DataAccess::Mining::CauldronDomain::setSnapshot( const Interface::Snapshot
 {
    if ( m_snapshot == snapshot ) return;
 
-   clear ();
-
    m_snapshot = snapshot;
 
    // Get all 3d depth grids.
-   m_domainDerivedDepths = propertyManager.getFormationProperties ( m_depthProperty, m_snapshot, true );
+   setDepths ( propertyManager.getFormationProperties ( m_depthProperty, m_snapshot, true ));
+}
+
+//------------------------------------------------------------//
+void DataAccess::Mining::CauldronDomain::setDepths( const FormationPropertyList& depths )
+{
+   clear ();
+
+   m_domainDerivedDepths = depths;
+
+   size_t numberOfNodes = 0;
+   unsigned int globalK = 0;
+
+   for ( size_t f = 0; f < m_domainDerivedDepths.size (); ++f ) {
+      const Interface::Formation* formation = dynamic_cast<const Interface::Formation*>( m_domainDerivedDepths [ f ]->getFormation ());
+
+      m_firstNode.push_back ( numberOfNodes );
+      m_firstGlobalK.push_back ( globalK );
+      m_formationIndex.insert ( std::make_pair ( formation, f ));
+      m_topSurfaceIndex.insert ( std::make_pair ( formation->getTopSurface (), f ));
+
+      numberOfNodes += m_domainDerivedDepths [ f ]->lengthK ();
+      // Minus 1 because we do not want to include the end (bottom) point twice.
+      globalK += m_domainDerivedDepths [ f ]->lengthK () - 1;
+   }
+
+   m_firstNode.push_back ( numberOfNodes );
+}
+
+//------------------------------------------------------------//
+
+const DataAccess::Mining::CauldronDomain::NodeColumn& DataAccess::Mining::CauldronDomain::getNodeColumn( unsigned int i, unsigned int j ) const
+{
+   NodeColumn& column = m_nodeColumns [( static_cast<unsigned long long>( i ) << 32 ) | j ];
+
+   if ( column.depths.empty ()) {
+      column.depths.reserve ( m_firstNode.back ());
+      column.isMonotone = true;
+
+      for ( const FormationPropertyPtr& grid : m_domainDerivedDepths ) {
+
+         for ( int k = grid->lastK (); k >= 0; --k ) {
+            const double depth = grid->get ( i, j, k );
+
+            column.isMonotone = column.isMonotone and depth != Interface::DefaultUndefinedMapValue and
+                                ( column.depths.empty () or column.depths.back () <= depth );
+            column.depths.push_back ( depth );
+         }
+
+      }
+
+   }
+
+   return column;
+}
+
+//------------------------------------------------------------//
+
+bool DataAccess::Mining::CauldronDomain::findDepth( const ElementPosition& element, double z, size_t& formation, size_t& node,
+                                                    double& topDepth, double& bottomDepth ) const
+{
+   if ( m_domainDerivedDepths.empty ()) {
+      return false;
+   }
+
+   const unsigned int i = element.getI ();
+   const unsigned int j = element.getJ ();
+
+   const NodeColumn* columns [ 4 ] = { &getNodeColumn ( i, j ), &getNodeColumn ( i + 1, j ), &getNodeColumn ( i + 1, j + 1 ), &getNodeColumn ( i, j + 1 ) };
+   const double* corners [ 4 ] = { columns [ 0 ]->depths.data (), columns [ 1 ]->depths.data (), columns [ 2 ]->depths.data (), columns [ 3 ]->depths.data () };
+   const ElementDepths depths ( element, corners );
+
+   const size_t numberOfFormations = m_domainDerivedDepths.size ();
+
+   if ( columns [ 0 ]->isMonotone and columns [ 1 ]->isMonotone and columns [ 2 ]->isMonotone and columns [ 3 ]->isMonotone and depths.isMonotone ()) {
+      // Bisection finds the same element as the search from the top: the first with a thickness that contains z.
+      if ( z < depths ( 0 )) {
+         return false;
+      }
+
+      // The first formation with its bottom at or below z.
+      size_t lower = 0;
+      size_t upper = numberOfFormations;
+
+      while ( lower < upper ) {
+         const size_t middle = ( lower + upper ) / 2;
+
+         if ( depths ( m_firstNode [ middle + 1 ] - 1 ) < z ) {
+            lower = middle + 1;
+         } else {
+            upper = middle;
+         }
+
+      }
+
+      if ( lower == numberOfFormations ) {
+         return false;
+      }
+
+      formation = lower;
+
+      // The first node of the formation at or below z.
+      const size_t topNode = m_firstNode [ formation ];
+      const size_t bottomNode = m_firstNode [ formation + 1 ] - 1;
+
+      lower = topNode;
+      upper = bottomNode;
+
+      while ( lower < upper ) {
+         const size_t middle = ( lower + upper ) / 2;
+
+         if ( depths ( middle ) < z ) {
+            lower = middle + 1;
+         } else {
+            upper = middle;
+         }
+
+      }
+
+      if ( lower == topNode ) {
+
+         if ( depths ( topNode ) != z ) {
+            return false;
+         }
+
+         // z lies on top of the formation: the first node below it.
+         lower = topNode + 1;
+         upper = bottomNode + 1;
+
+         while ( lower < upper ) {
+            const size_t middle = ( lower + upper ) / 2;
+
+            if ( depths ( middle ) <= z ) {
+               lower = middle + 1;
+            } else {
+               upper = middle;
+            }
+
+         }
+
+         if ( lower > bottomNode ) {
+            return false;
+         }
+
+      }
+
+      node = lower - 1;
+      topDepth = depths ( node );
+      bottomDepth = depths ( node + 1 );
+      return true;
+   }
+
+   topDepth    = Interface::DefaultUndefinedMapValue;
+   bottomDepth = Interface::DefaultUndefinedMapValue;
+
+   for ( size_t f = 0; f < numberOfFormations; ++f ) {
+
+      if ( m_firstGlobalK [ f ] == 0 ) {
+         topDepth = depths ( m_firstNode [ f ] );
+      }
+
+      bottomDepth = depths ( m_firstNode [ f + 1 ] - 1 );
+
+      if ( topDepth == Interface::DefaultUndefinedMapValue or bottomDepth == Interface::DefaultUndefinedMapValue ) {
+         return false;
+      }
+
+      if ( NumericFunctions::inRange( z, topDepth, bottomDepth ) ) {
+         topDepth = depths ( m_firstNode [ f ] );
+
+         for ( size_t n = m_firstNode [ f ] + 1; n < m_firstNode [ f + 1 ]; ++n ) {
+            bottomDepth = depths ( n );
+
+            if ( topDepth < bottomDepth and NumericFunctions::inRange( z, topDepth, bottomDepth ) ) {
+               formation = f;
+               node = n - 1;
+               return true;
+            }
+
+            topDepth = bottomDepth;
+         }
+
+         return false;
+      }
+
+      topDepth = bottomDepth;
+   }
+
+   return false;
 }
 
 //------------------------------------------------------------//
@@ -98,63 +320,25 @@ bool DataAccess::Mining::CauldronDomain::findLocation( double x, double y, doubl
 
    if ( element.isValidPlaneElement() )
    {
-      PropertyInterpolator2D interpolate2D;
-
       element.getActualPoint()( 2 ) = z;
 
-      double topDepth    = Interface::DefaultUndefinedMapValue;
-      double bottomDepth = Interface::DefaultUndefinedMapValue;
-
-      int count = 0;
-
+      size_t formation;
+      size_t node;
+      double topDepth;
+      double bottomDepth;
 
-      for ( FormationPropertyList::const_iterator depthIter = m_domainDerivedDepths.begin(); depthIter != m_domainDerivedDepths.end(); ++depthIter )
+      if ( findDepth( element, z, formation, node, topDepth, bottomDepth ) )
       {
+         FormationPropertyPtr grid = m_domainDerivedDepths [ formation ];
+         const unsigned int l = grid->lastK () - static_cast<unsigned int>( node - m_firstNode [ formation ] );
 
-         FormationPropertyPtr grid = *depthIter;
+         elementFound = true;
 
-         if ( count == 0 ) {
-            topDepth = interpolate2D ( element, grid, grid->lastK () );
-         }
-
-         bottomDepth = interpolate2D( element, grid, 0 );
+         element.getReferencePoint()( 2 ) = 2.0 * ( z - topDepth ) / ( bottomDepth - topDepth ) - 1.0;
+         element.setDepthPosition( m_firstGlobalK [ formation ] + l, l );
 
-         if ( topDepth == Interface::DefaultUndefinedMapValue or bottomDepth == Interface::DefaultUndefinedMapValue )
-         {
-            break;
-         }
-
-         if ( NumericFunctions::inRange( z, topDepth, bottomDepth ) )
-         {
-            topDepth = interpolate2D( element, grid, grid->lastK () );
-
-            for ( int l = grid->lastK(); l > 0; -- l )
-            {
-               bottomDepth = interpolate2D( element, grid, l - 1 );
-
-               if ( topDepth < bottomDepth and NumericFunctions::inRange( z, topDepth, bottomDepth ) )
-               {
-                  elementFound = true;
-
-                  element.getReferencePoint()( 2 ) = 2.0 * ( z - topDepth ) / ( bottomDepth - topDepth ) - 1.0;
-                  element.setDepthPosition( count + l, l );
-
-                  // The grid must be in the mapping.
-                  element.setFormation( dynamic_cast<const Interface::Formation*>( grid->getFormation ()));
-                  // element.setFormation( m_mapToFormation.find( grid )->second );
-                  break;
-               }
-               topDepth = bottomDepth;
-            }
-            break;
-         }
-         else
-         {
-            // Minus 1 because we do not want to include the end (bottom) point twice.
-            count += grid->lengthK () - 1;
-         }
-
-         topDepth = bottomDepth;
+         // The grid must be in the mapping.
+         element.setFormation( dynamic_cast<const Interface::Formation*>( grid->getFormation ()));
       }
 
    }
@@ -185,41 +369,28 @@ bool DataAccess::Mining::CauldronDomain::findLocation( double x, double y, const
       double surfaceDepth;
       PropertyInterpolator2D interpolate2D;
 
-      if ( element.getI() != (unsigned int)(Interface::DefaultUndefinedMapValue ) )
-      {
-         int  count = 0;
+      // The first formation below the surface.
+      std::map<const Interface::Surface*, size_t>::const_iterator index = m_topSurfaceIndex.find( surface );
 
+      if ( element.getI() != (unsigned int)(Interface::DefaultUndefinedMapValue ) and index != m_topSurfaceIndex.end() )
+      {
+         FormationPropertyPtr grid = m_domainDerivedDepths [ index->second ];
+         const Interface::Formation* formation = dynamic_cast<const Interface::Formation*>( grid->getFormation ());
 
-         for ( FormationPropertyList::const_iterator depthIter = m_domainDerivedDepths.begin(); depthIter != m_domainDerivedDepths.end(); ++depthIter ) {
+         // Interpolate the depth at the (x,y) point on the surface.
+         surfaceDepth = interpolate2D ( element, grid, grid->lastK() );
 
-            FormationPropertyPtr grid = *depthIter;
+         if ( surfaceDepth != Interface::DefaultUndefinedMapValue )
+         {
+            elementFound = true;
 
-            // The formation must be in the domain of the map, since the this grid was added at the same time!
-            const Interface::Formation* formation = dynamic_cast<const Interface::Formation*>( grid->getFormation ());//m_mapToFormation.find( grid )->second;
+            element.getReferencePoint()( 2 ) = -1.0;
+            element.setDepthPosition( m_firstGlobalK [ index->second ], grid->lastK() );
 
-            if ( formation->getTopSurface() == surface )
-            {
-               // Interpolate the depth at the (x,y) point on the surface.
-               surfaceDepth = interpolate2D ( element, grid, grid->lastK() );
-
-               if ( surfaceDepth != Interface::DefaultUndefinedMapValue )
-               {
-                  elementFound = true;
-
-                  element.getReferencePoint()( 2 ) = -1.0;
-                  element.setDepthPosition( count, grid->lastK() );
-
-                  // The grid must be in the mapping.
-                  element.setFormation( formation );
-                  element.setSurface( surface );
-                  element.getActualPoint()( 2 ) = surfaceDepth;
-               }
-               break;
-            }
-            else
-            {
-               count += grid->lengthK () - 1;
-            }
+            // The grid must be in the mapping.
+            element.setFormation( formation );
+            element.setSurface( surface );
+            element.getActualPoint()( 2 ) = surfaceDepth;
          }
 
       }
@@ -244,37 +415,26 @@ bool DataAccess::Mining::CauldronDomain::findLocation( double x, double y, const
       double surfaceDepth;
       PropertyInterpolator2D interpolate2D;
 
-      if ( element.getI() != (unsigned int)(Interface::DefaultUndefinedMapValue ) )
-      {
-         int  count = 0;
-
-         for ( FormationPropertyList::const_iterator depthIter = m_domainDerivedDepths.begin(); depthIter != m_domainDerivedDepths.end(); ++depthIter ) {
+      // The formation must be in the domain of the map, since the this grid was added at the same time!
+      std::map<const Interface::Formation*, size_t>::const_iterator index = m_formationIndex.find( formation );
 
-            FormationPropertyPtr grid = *depthIter;
+      if ( element.getI() != (unsigned int)(Interface::DefaultUndefinedMapValue ) and index != m_formationIndex.end() )
+      {
+         FormationPropertyPtr grid = m_domainDerivedDepths [ index->second ];
 
-            // The formation must be in the domain of the map, since the this grid was added at the same time!
-            if ( grid->getFormation () == formation )
-            {
-               // Interpolate the depth at the (x,y) point on the surface.
-               surfaceDepth = interpolate2D( element, grid, grid->lastK() );
+         // Interpolate the depth at the (x,y) point on the surface.
+         surfaceDepth = interpolate2D( element, grid, grid->lastK() );
 
-               if ( surfaceDepth != Interface::DefaultUndefinedMapValue )
-               {
-                  elementFound = true;
+         if ( surfaceDepth != Interface::DefaultUndefinedMapValue )
+         {
+            elementFound = true;
 
-                  element.getReferencePoint()( 2 ) = -1.0;
-                  element.setDepthPosition( count, grid->lastK() );
+            element.getReferencePoint()( 2 ) = -1.0;
+            element.setDepthPosition( m_firstGlobalK [ index->second ], grid->lastK() );
 
-                  // The grid must be in the mapping.
-                  element.setFormation( formation );
-                  element.getActualPoint()( 2 ) = surfaceDepth;
-               }
-               break;
-            }
-            else
-            {
-               count += grid->lengthK () - 1;
-            }
+            // The grid must be in the mapping.
+            element.setFormation( formation );
+            element.getActualPoint()( 2 ) = surfaceDepth;
          }
       }
    }
@@ -289,6 +449,11 @@ bool DataAccess::Mining::CauldronDomain::findLocation( double x, double y, const
 
 void DataAccess::Mining::CauldronDomain::clear () {
    m_domainDerivedDepths.clear ();
+   m_firstNode.clear ();
+   m_firstGlobalK.clear ();
+   m_formationIndex.clear ();
+   m_topSurfaceIndex.clear ();
+   m_nodeColumns.clear ();
 }
 
 //------------------------------------------------------------//
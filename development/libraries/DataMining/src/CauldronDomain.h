@@ -28,6 +28,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 namespace DataAccess
 {
@@ -36,6 +37,11 @@ namespace DataAccess
    {
       /// Objects of this type contain the 3d depths for the basin,
       /// at the specified snapshot time.
+      ///
+      /// The depths of a column of nodes are copied the first time an element next to it is
+      /// searched, so repeated searches in the same columns, e.g. along a well path, only
+      /// interpolate from memory. Where the depths increase downwards, the element containing
+      /// a point is found by bisection instead of searching the column from the top.
       class CauldronDomain {
 
       public :
@@ -105,9 +111,34 @@ namespace DataAccess
 
       protected :
 
+         /// \brief The depths of the nodes of a column, from the top down, formation after formation.
+         struct NodeColumn {
+            std::vector<double> depths;
+            /// \brief Whether all depths are defined and none is less than the one above it.
+            bool isMonotone;
+         };
+
          /// \brief Remove all data from the object.
          void clear();
 
+         /// \brief Set the depths of the formations, from the top down, and index these.
+         ///
+         /// All previously set depth data is removed.
+         void setDepths( const AbstractDerivedProperties::FormationPropertyList& depths );
+
+         /// \brief Get the node column at (i,j), copying its depths the first time it is used.
+         const NodeColumn& getNodeColumn( unsigned int i, unsigned int j ) const;
+
+         /// \brief Find the formation and the top node of the element containing depth z, in the element column of the plane element.
+         ///
+         /// The node index is into the depths of a node column; the depths are those at the top and bottom of the element.
+         bool findDepth( const ElementPosition & element,
+                         double                  z,
+                         size_t                & formation,
+                         size_t                & node,
+                         double                & topDepth,
+                         double                & bottomDepth ) const;
+
          /// \brief Set the actual (x,y)-coordinates, the (xi,eta)-reference coordinates and the (i,j)-global position of the element.
          ///
          /// If the (x,y) is invalid then element will be cleared on exit.
@@ -155,6 +186,21 @@ namespace DataAccess
          /// The depth properties for the layers.
          AbstractDerivedProperties::FormationPropertyList m_domainDerivedDepths;
 
+         /// The index of the top node of each formation in a node column, followed by the number of nodes in a column.
+         std::vector<size_t> m_firstNode;
+
+         /// The number of element layers above each formation, from which the global k of its elements follows.
+         std::vector<unsigned int> m_firstGlobalK;
+
+         /// The index of each formation in the depth properties.
+         std::map<const Interface::Formation*, size_t> m_formationIndex;
+
+         /// The index of the first formation below each surface.
+         std::map<const Interface::Surface*, size_t> m_topSurfaceIndex;
+
+         /// The node columns used at the snapshot, by (i,j).
+         mutable std::unordered_map<unsigned long long, NodeColumn> m_nodeColumns;
+
 
       };
    }
@@ -45,9 +45,9 @@ namespace DataAccess {
          double operator ()( const ElementPosition&                          element,
                              AbstractDerivedProperties::FormationPropertyPtr property ) const;
 
-
-      private :
-
+         /// Interpolate the values at the four corners of an element, counter-clockwise from the lower left.
+         ///
+         /// Returns the undefined value if any of the corner values is undefined.
          double doInterpolation ( const double  xi,
                                   const double  eta,
                                   const double* weights) const;
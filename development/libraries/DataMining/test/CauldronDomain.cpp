@@ -0,0 +1,279 @@
+//
+// Copyright (C) 2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#include "CauldronDomain.h"
+#include "DataMiningProjectHandle.h"
+#include "DataMiningObjectFactory.h"
+#include "DeviatedWell.h"
+#include "PropertyInterpolator2D.h"
+
+#include "DerivedFormationProperty.h"
+#include "Interface.h"
+#include "NumericFunctions.h"
+#include "ObjectFactory.h"
+
+#include <memory>
+#include <random>
+#include <gtest/gtest.h>
+
+using namespace DataAccess;
+using namespace DataAccess::Mining;
+
+namespace
+{
+   /// A domain with given depths, which can also find a location by the search from the top used before the index.
+   class TestDomain : public CauldronDomain
+   {
+   public :
+
+      TestDomain( Interface::ProjectHandle* handle ) : CauldronDomain( handle ) {}
+
+      using CauldronDomain::setDepths;
+
+      bool findLocationBySearch( double x, double y, double z, ElementPosition& element ) const
+      {
+         bool elementFound = false;
+
+         setPlaneElement( element, x, y );
+
+         if ( element.isValidPlaneElement() )
+         {
+            PropertyInterpolator2D interpolate2D;
+
+            element.getActualPoint()( 2 ) = z;
+
+            double topDepth    = Interface::DefaultUndefinedMapValue;
+            double bottomDepth = Interface::DefaultUndefinedMapValue;
+
+            int count = 0;
+
+            for ( const AbstractDerivedProperties::FormationPropertyPtr& grid : m_domainDerivedDepths )
+            {
+               if ( count == 0 ) {
+                  topDepth = interpolate2D( element, grid, grid->lastK () );
+               }
+
+               bottomDepth = interpolate2D( element, grid, 0 );
+
+               if ( topDepth == Interface::DefaultUndefinedMapValue or bottomDepth == Interface::DefaultUndefinedMapValue ) break;
+
+               if ( NumericFunctions::inRange( z, topDepth, bottomDepth ) )
+               {
+                  topDepth = interpolate2D( element, grid, grid->lastK () );
+
+                  for ( int l = grid->lastK(); l > 0; -- l )
+                  {
+                     bottomDepth = interpolate2D( element, grid, l - 1 );
+
+                     if ( topDepth < bottomDepth and NumericFunctions::inRange( z, topDepth, bottomDepth ) )
+                     {
+                        elementFound = true;
+
+                        element.getReferencePoint()( 2 ) = 2.0 * ( z - topDepth ) / ( bottomDepth - topDepth ) - 1.0;
+                        element.setDepthPosition( count + l, l );
+                        element.setFormation( dynamic_cast<const Interface::Formation*>( grid->getFormation ()));
+                        break;
+                     }
+                     topDepth = bottomDepth;
+                  }
+                  break;
+               }
+               else
+               {
+                  count += grid->lengthK () - 1;
+               }
+
+               topDepth = bottomDepth;
+            }
+         }
+
+         if ( not elementFound ) element.clear ();
+
+         return elementFound;
+      }
+   };
+
+   class CauldronDomainTest : public ::testing::Test
+   {
+   protected :
+
+      void SetUp() override
+      {
+         m_factory.reset( new ObjectFactory );
+         m_projectHandle.reset( dynamic_cast<ProjectHandle*>( Interface::OpenCauldronProject( "DataMiningProjectHandleTest.project3d", m_factory.get() )));
+         ASSERT_NE( m_projectHandle, nullptr );
+         m_factory->initialiseObjectFactory( m_projectHandle.get() );
+
+         m_grid = m_projectHandle->getActivityOutputGrid();
+         if ( m_grid == nullptr ) m_grid = m_projectHandle->getLowResolutionOutputGrid();
+         ASSERT_NE( m_grid, nullptr );
+
+         m_domain.reset( new TestDomain( m_projectHandle.get() ));
+      }
+
+      /// Random depths for the first formations: zero-thickness layers, and a few columns with undefined or decreasing depths.
+      void setDepths( unsigned int seed )
+      {
+         std::unique_ptr<Interface::FormationList> formations( m_projectHandle->getFormations() );
+         ASSERT_GE( formations->size(), 4u );
+
+         const Interface::Property* depth = m_projectHandle->findProperty( "Depth" );
+         const Interface::Snapshot* snapshot = m_projectHandle->findSnapshot( 0.0 );
+         const unsigned int numberOfNodes[4] = { 3, 5, 2, 4 };
+
+         AbstractDerivedProperties::FormationPropertyList depths;
+         std::vector<DerivedProperties::DerivedFormationPropertyPtr>& grids = m_depths;
+         for ( int f = 0; f < 4; ++f )
+         {
+            grids.push_back( DerivedProperties::DerivedFormationPropertyPtr(
+               new DerivedProperties::DerivedFormationProperty( depth, snapshot, ( *formations )[f], m_grid, numberOfNodes[f] )));
+            depths.push_back( grids.back() );
+         }
+
+         std::mt19937 generator( seed );
+         std::uniform_real_distribution<double> top( 0.0, 50.0 );
+         std::uniform_real_distribution<double> thickness( 0.0, 40.0 );
+         std::uniform_real_distribution<double> chance( 0.0, 1.0 );
+
+         for ( int i = m_grid->firstI(); i <= m_grid->lastI(); ++i )
+         {
+            for ( int j = m_grid->firstJ(); j <= m_grid->lastJ(); ++j )
+            {
+               const double kind = chance( generator );
+               double z = top( generator );
+
+               for ( int f = 0; f < 4; ++f )
+               {
+                  // The top node of a formation is the bottom node of the one above
+                  for ( int k = int( numberOfNodes[f] ) - 1; k >= 0; --k )
+                  {
+                     if ( k < int( numberOfNodes[f] ) - 1 )
+                     {
+                        const double layerChance = chance( generator );
+                        z += ( layerChance < 0.2 ? 0.0 : thickness( generator )) * ( kind < 0.03 and layerChance > 0.9 ? -1.0 : 1.0 );
+                     }
+                     grids[f]->set( i, j, k, kind > 0.97 and f == 2 ? Interface::DefaultUndefinedMapValue : z );
+                  }
+               }
+            }
+         }
+
+         m_domain->setDepths( depths );
+      }
+
+      /// Find the location with the index and with the search from the top, and check these agree.
+      void compare( double x, double y, double z )
+      {
+         ElementPosition indexed;
+         ElementPosition searched;
+
+         const bool found = m_domain->findLocation( x, y, z, indexed );
+         ASSERT_EQ( found, m_domain->findLocationBySearch( x, y, z, searched )) << "at (" << x << ", " << y << ", " << z << ")";
+         ++m_numberCompared;
+         if ( not found ) return;
+
+         ++m_numberFound;
+         EXPECT_EQ( indexed.getFormation(), searched.getFormation() );
+         EXPECT_EQ( indexed.getI(), searched.getI() );
+         EXPECT_EQ( indexed.getJ(), searched.getJ() );
+         EXPECT_EQ( indexed.getGlobalK(), searched.getGlobalK() );
+         EXPECT_EQ( indexed.getLocalK(), searched.getLocalK() );
+         for ( int d = 0; d < 3; ++d )
+         {
+            EXPECT_DOUBLE_EQ( indexed.getReferencePoint()( d ), searched.getReferencePoint()( d ));
+         }
+      }
+
+      std::unique_ptr<ObjectFactory> m_factory;
+      std::unique_ptr<ProjectHandle> m_projectHandle;
+      const Interface::Grid* m_grid;
+      std::unique_ptr<TestDomain> m_domain;
+      std::vector<DerivedProperties::DerivedFormationPropertyPtr> m_depths;
+      size_t m_numberCompared = 0;
+      size_t m_numberFound = 0;
+   };
+}
+
+TEST_F( CauldronDomainTest, RandomPoints )
+{
+   setDepths( 42 );
+
+   std::mt19937 generator( 7 );
+   std::uniform_real_distribution<double> x( m_grid->minI() - 200.0, m_grid->maxI() + 200.0 );
+   std::uniform_real_distribution<double> y( m_grid->minJ() - 200.0, m_grid->maxJ() + 200.0 );
+   std::uniform_real_distribution<double> z( -20.0, 250.0 );
+
+   for ( int n = 0; n < 20000; ++n )
+   {
+      compare( x( generator ), y( generator ), z( generator ));
+   }
+
+   // Points outside the domain, laterally and vertically, are found by neither
+   compare( m_grid->minI() - 1.0, m_grid->minJ(), 10.0 );
+   compare( m_grid->maxI() + 1.0, m_grid->minJ(), 10.0 );
+   compare( m_grid->minI() + 1.0, m_grid->minJ() + 1.0, -1.0e4 );
+   compare( m_grid->minI() + 1.0, m_grid->minJ() + 1.0, 1.0e4 );
+
+   EXPECT_GT( m_numberFound, m_numberCompared / 4 );
+   EXPECT_LT( m_numberFound, m_numberCompared );
+}
+
+TEST_F( CauldronDomainTest, ElementFaces )
+{
+   setDepths( 3 );
+
+   // Points on the vertical edges and faces of the elements, at the depths of the nodes and halfway between
+   for ( int i = m_grid->firstI(); i < m_grid->lastI(); i += 3 )
+   {
+      for ( int j = m_grid->firstJ(); j < m_grid->lastJ(); ++j )
+      {
+         double x;
+         double y;
+         ASSERT_TRUE( m_grid->getPosition( static_cast<unsigned int>( i ), static_cast<unsigned int>( j ), x, y ));
+
+         for ( const DerivedProperties::DerivedFormationPropertyPtr& grid : m_depths )
+         {
+            for ( unsigned int k = 0; k <= grid->lastK(); ++k )
+            {
+               const double depth = grid->get( i, j, k );
+               const double nextDepth = grid->get( i + 1, j, k );
+
+               compare( x, y, depth );
+               compare( x + 0.5 * m_grid->deltaI(), y, 0.5 * ( depth + nextDepth ));
+               compare( x, y + 0.5 * m_grid->deltaJ(), depth );
+               compare( x + 0.5 * m_grid->deltaI(), y + 0.5 * m_grid->deltaJ(), depth );
+            }
+         }
+      }
+   }
+
+   EXPECT_GT( m_numberFound, m_numberCompared / 2 );
+}
+
+TEST_F( CauldronDomainTest, DeviatedWell )
+{
+   setDepths( 11 );
+
+   // A well entering at the top, turning, and leaving the domain through its side and bottom
+   DeviatedWell well( "Deviated" );
+   well.addLocation( m_grid->minI() + 130.0, m_grid->minJ() + 170.0,   0.0,   0.0 );
+   well.addLocation( m_grid->minI() + 400.0, m_grid->minJ() + 320.0,  90.0, 320.0 );
+   well.addLocation( m_grid->maxI() + 300.0, m_grid->minJ() + 600.0, 350.0, 0.0 );
+   well.freeze();
+
+   for ( double s = 0.0; s <= well.getLength(); s += 0.25 )
+   {
+      const Numerics::Point p = well.getLocation( s );
+      compare( p( 0 ), p( 1 ), p( 2 ));
+   }
+
+   EXPECT_GT( m_numberFound, 0u );
+   EXPECT_LT( m_numberFound, m_numberCompared );
+}
@@ -23,6 +23,8 @@
 #include "DerivedFormationProperty.h"
 #include "PropertyRetriever.h"
 
+#include <algorithm>
+
 using namespace AbstractDerivedProperties;
 
 using namespace std;
@@ -46,6 +48,8 @@ DerivedProperties::BrineDensityCalculator::BrineDensityCalculator ( const GeoPhy
       addDependentPropertyName ( "Pressure" );
    }
 
+   m_temperatureIndex = getDependentPropertyIndex ( "Temperature" );
+   m_pressureIndex = getDependentPropertyIndex ( "Pressure" );
 }
 
 double DerivedProperties::BrineDensityCalculator::calculateBrineDensity(const GeoPhysics::FluidType* fluid, const double temperature, const double porePressure) const
@@ -140,19 +144,29 @@ void DerivedProperties::BrineDensityCalculator::calculate ( AbstractPropertyMana
    derivedProperties.push_back ( brineDensity );
 }
 
-double DerivedProperties::BrineDensityCalculator::calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                                                       const GeoPhysics::CompoundLithology* /*lithology*/,
-                                                                       const std::map<string, double>& dependentProperties ) const
+void DerivedProperties::BrineDensityCalculator::calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                                                      const GeoPhysics::CompoundLithology* const* /*lithologies*/,
+                                                                      const unsigned int                          numberOfPositions,
+                                                                      const double*                               dependentValues,
+                                                                            double*                               values ) const
 {
   const GeoPhysics::FluidType* fluid = dynamic_cast<const GeoPhysics::FluidType*>( formation->getFluidType() );
   if ( !fluid )
   {
-    return DataAccess::Interface::DefaultUndefinedScalarValue;
+    std::fill( values, values + numberOfPositions, DataAccess::Interface::DefaultUndefinedScalarValue );
+    return;
   }
 
   if (m_hydrostaticMode)
   {
-    return calculateBrineDensityHydroStatic(fluid);
+    std::fill( values, values + numberOfPositions, calculateBrineDensityHydroStatic(fluid) );
+    return;
+  }
+
+  const size_t numberOfDependentValues = getDependentPropertyNames ().size ();
+
+  for ( unsigned int p = 0; p < numberOfPositions; ++p, dependentValues += numberOfDependentValues )
+  {
+    values[p] = calculateBrineDensity(fluid, dependentValues[m_temperatureIndex], dependentValues[m_pressureIndex]);
   }
-  return calculateBrineDensity(fluid, dependentProperties.at("Temperature"), dependentProperties.at("Pressure"));
 }
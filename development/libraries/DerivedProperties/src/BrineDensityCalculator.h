@@ -47,9 +47,11 @@ namespace DerivedProperties {
                                const DataModel::AbstractFormation*                         formation,
                                      AbstractDerivedProperties::FormationPropertyList&     derivedProperties ) const;
 
-      virtual double calculateAtPosition(const GeoPhysics::GeoPhysicsFormation* formation,
-                                         const GeoPhysics::CompoundLithology* lithology,
-                                         const std::map<std::string, double>& dependentProperties) const override;
+      virtual void calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                         const GeoPhysics::CompoundLithology* const* lithologies,
+                                         const unsigned int                          numberOfPositions,
+                                         const double*                               dependentValues,
+                                               double*                               values ) const override;
    private :
 
       const GeoPhysics::ProjectHandle& m_projectHandle;
@@ -57,6 +59,10 @@ namespace DerivedProperties {
 
       double calculateBrineDensity(const GeoPhysics::FluidType* fluid, const double temperature, const double porePressure) const;
       double calculateBrineDensityHydroStatic(const GeoPhysics::FluidType* fluid) const;
+
+      /// \brief The positions of the dependent properties used by calculateAtPositions, -1 if not a dependency.
+      int m_temperatureIndex;
+      int m_pressureIndex;
    };
 
 
@@ -23,6 +23,8 @@
 #include "DerivedFormationProperty.h"
 #include "PropertyRetriever.h"
 
+#include <algorithm>
+
 using namespace AbstractDerivedProperties;
 
 DerivedProperties::BrineViscosityCalculator::BrineViscosityCalculator ( const GeoPhysics::ProjectHandle& projectHandle ) :
@@ -31,6 +33,9 @@ DerivedProperties::BrineViscosityCalculator::BrineViscosityCalculator ( const Ge
    addPropertyName ( "BrineViscosity" );
    addDependentPropertyName ( "Temperature" );
    addDependentPropertyName ( "Pressure" );
+
+   m_temperatureIndex = getDependentPropertyIndex ( "Temperature" );
+   m_pressureIndex = getDependentPropertyIndex ( "Pressure" );
 }
 
 
@@ -92,15 +97,23 @@ void DerivedProperties::BrineViscosityCalculator::calculate ( AbstractPropertyMa
    derivedProperties.push_back ( brineViscosity );
 }
 
-double DerivedProperties::BrineViscosityCalculator::calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                                                         const GeoPhysics::CompoundLithology* /*lithology*/,
-                                                                         const std::map<std::string, double>& dependentProperties ) const
+void DerivedProperties::BrineViscosityCalculator::calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                                                        const GeoPhysics::CompoundLithology* const* /*lithologies*/,
+                                                                        const unsigned int                          numberOfPositions,
+                                                                        const double*                               dependentValues,
+                                                                              double*                               values ) const
 {
   const GeoPhysics::FluidType* fluid = dynamic_cast<const GeoPhysics::FluidType*>( formation->getFluidType() );
   if ( !fluid )
   {
-    return DataAccess::Interface::DefaultUndefinedScalarValue;
+    std::fill( values, values + numberOfPositions, DataAccess::Interface::DefaultUndefinedScalarValue );
+    return;
   }
 
-  return calculateBrineViscosity( fluid, dependentProperties.at("Temperature"), dependentProperties.at("Pressure") );
+  const size_t numberOfDependentValues = getDependentPropertyNames ().size ();
+
+  for ( unsigned int p = 0; p < numberOfPositions; ++p, dependentValues += numberOfDependentValues )
+  {
+    values[p] = calculateBrineViscosity( fluid, dependentValues[m_temperatureIndex], dependentValues[m_pressureIndex] );
+  }
 }
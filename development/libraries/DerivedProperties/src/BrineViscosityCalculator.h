@@ -47,15 +47,21 @@ namespace DerivedProperties {
                                const DataModel::AbstractFormation*                       formation,
                                      AbstractDerivedProperties::FormationPropertyList&   derivedProperties ) const;
 
-      virtual double calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                          const GeoPhysics::CompoundLithology* lithology,
-                                          const std::map<std::string, double>& dependentProperties) const override;
+      virtual void calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                         const GeoPhysics::CompoundLithology* const* lithologies,
+                                         const unsigned int                          numberOfPositions,
+                                         const double*                               dependentValues,
+                                               double*                               values ) const override;
    private :
       double calculateBrineViscosity( const GeoPhysics::FluidType* fluid, double temperature, double pressure ) const;
 
       const GeoPhysics::ProjectHandle& m_projectHandle;
       bool m_hydrostaticMode;
 
+
+      /// \brief The positions of the dependent properties used by calculateAtPositions, -1 if not a dependency.
+      int m_temperatureIndex;
+      int m_pressureIndex;
    };
 
 
@@ -67,55 +67,80 @@ DerivedProperties::BulkDensityFormationCalculator::BulkDensityFormationCalculato
       addDependentPropertyName( "ALCStepBasaltThickness");
       addDependentPropertyName( "Depth" );
    }
+
+   m_porosityIndex = getDependentPropertyIndex ( "Porosity" );
+   m_pressureIndex = getDependentPropertyIndex ( "Pressure" );
+   m_temperatureIndex = getDependentPropertyIndex ( "Temperature" );
+   m_lithoStaticPressureIndex = getDependentPropertyIndex ( "LithoStaticPressure" );
+   m_depthIndex = getDependentPropertyIndex ( "Depth" );
+   m_alcStepTopBasaltDepthIndex = getDependentPropertyIndex ( "ALCStepTopBasaltDepth" );
+   m_alcStepBasaltThicknessIndex = getDependentPropertyIndex ( "ALCStepBasaltThickness" );
 }
 
-double DerivedProperties::BulkDensityFormationCalculator::calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                                                               const GeoPhysics::CompoundLithology* lithology,
-                                                                               const std::map<std::string, double>& dependentProperties) const
+void DerivedProperties::BulkDensityFormationCalculator::calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                                                              const GeoPhysics::CompoundLithology* const* lithologies,
+                                                                              const unsigned int                          numberOfPositions,
+                                                                              const double*                               dependentValues,
+                                                                                    double*                               values ) const
 {
+   const size_t numberOfDependentValues = getDependentPropertyNames ().size ();
+
    if ( formation->kind () == DataAccess::Interface::BASEMENT_FORMATION )
    {
-      if ( m_alcModeEnabled )
-      {
-         return calculateSingleNodeBulkDensityBasementAlc( lithology,
-                                                           dependentProperties.at("Temperature"),
-                                                           dependentProperties.at("LithoStaticPressure"),
-                                                           dependentProperties.at("Depth"),
-                                                           dependentProperties.at("ALCStepTopBasaltDepth"),
-                                                           dependentProperties.at("ALCStepBasaltThickness"));
-      }
-      else
+      for ( unsigned int p = 0; p < numberOfPositions; ++p, dependentValues += numberOfDependentValues )
       {
-        return lithology->density();
+         if ( m_alcModeEnabled )
+         {
+            values[p] = calculateSingleNodeBulkDensityBasementAlc( lithologies[p],
+                                                                   dependentValues[m_temperatureIndex],
+                                                                   dependentValues[m_lithoStaticPressureIndex],
+                                                                   dependentValues[m_depthIndex],
+                                                                   dependentValues[m_alcStepTopBasaltDepthIndex],
+                                                                   dependentValues[m_alcStepBasaltThicknessIndex]);
+         }
+         else
+         {
+            values[p] = lithologies[p]->density();
+         }
       }
    }
    else
    {
+      const GeoPhysics::FluidType* fluid = dynamic_cast<const GeoPhysics::FluidType*>(formation->getFluidType());
+
       // The sediment calculation does not depend on the alc mode.
       if ( m_coupledModeEnabled )
       {
-        const GeoPhysics::FluidType* fluid = dynamic_cast<const GeoPhysics::FluidType*>(formation->getFluidType());
-        double solidDensity = lithology->density();
-        return calculateSingleNodeBulkDensitySedimentsCoupled( fluid,
-                                                               dependentProperties.at("Temperature"),
-                                                               dependentProperties.at("Pressure"),
-                                                               Utilities::Maths::PercentageToFraction * dependentProperties.at("Porosity"),
-                                                               solidDensity );
+         for ( unsigned int p = 0; p < numberOfPositions; ++p, dependentValues += numberOfDependentValues )
+         {
+            double solidDensity = lithologies[p]->density();
+            values[p] = calculateSingleNodeBulkDensitySedimentsCoupled( fluid,
+                                                                        dependentValues[m_temperatureIndex],
+                                                                        dependentValues[m_pressureIndex],
+                                                                        Utilities::Maths::PercentageToFraction * dependentValues[m_porosityIndex],
+                                                                        solidDensity );
+         }
       }
       else
       {
-        const GeoPhysics::FluidType* fluid = dynamic_cast<const GeoPhysics::FluidType*>(formation->getFluidType());
-        const double temperatureGradient = m_projectHandle.getRunParameters ()->getTemperatureGradient () / Utilities::Maths::KilometerToMeter;
-        const double fluidDensity = fluid->getCorrectedSimpleDensity ( GeoPhysics::FluidType::DefaultStandardDepth,
-                                                                       GeoPhysics::FluidType::DefaultHydrostaticPressureGradient,
-                                                                       GeoPhysics::FluidType::StandardSurfaceTemperature,
-                                                                       temperatureGradient );
-        double solidDensity = lithology->density();
-        return calculateSingleNodeBulkDensitySedimentsHydrostatic( Utilities::Maths::PercentageToFraction * dependentProperties.at("Porosity"), solidDensity, fluidDensity );
+         const double temperatureGradient = m_projectHandle.getRunParameters ()->getTemperatureGradient () / Utilities::Maths::KilometerToMeter;
+         const double fluidDensity = fluid->getCorrectedSimpleDensity ( GeoPhysics::FluidType::DefaultStandardDepth,
+                                                                        GeoPhysics::FluidType::DefaultHydrostaticPressureGradient,
+                                                                        GeoPhysics::FluidType::StandardSurfaceTemperature,
+                                                                        temperatureGradient );
+
+         for ( unsigned int p = 0; p < numberOfPositions; ++p, dependentValues += numberOfDependentValues )
+         {
+            double solidDensity = lithologies[p]->density();
+            values[p] = calculateSingleNodeBulkDensitySedimentsHydrostatic( Utilities::Maths::PercentageToFraction * dependentValues[m_porosityIndex], solidDensity, fluidDensity );
+         }
       }
    }
 }
 
+bool DerivedProperties::BulkDensityFormationCalculator::dependsOnFormationAbove () const {
+   return true;
+}
 
 void DerivedProperties::BulkDensityFormationCalculator::calculate ( AbstractPropertyManager&            propertyManager,
                                                                     const DataModel::AbstractSnapshot*  snapshot,
@@ -42,6 +42,9 @@ namespace DerivedProperties {
                                const DataModel::AbstractFormation*                 formation,
                                AbstractDerivedProperties::FormationPropertyList&   derivedProperties ) const;
 
+      /// \brief The values in the basement depend on those of the formation above.
+      virtual bool dependsOnFormationAbove () const;
+
       /// \brief Determine if the property is computable for the specific combination of formation and snapshot.
       virtual bool isComputable ( const AbstractDerivedProperties::AbstractPropertyManager& propManager,
                                   const DataModel::AbstractSnapshot*                        snapshot,
@@ -52,9 +55,11 @@ namespace DerivedProperties {
                                              const DataModel::AbstractSnapshot*                        snapshot,
                                              const DataModel::AbstractFormation*                       formation ) const;
 
-      virtual double calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                          const GeoPhysics::CompoundLithology* lithology,
-                                          const std::map<std::string, double>& dependentProperties ) const override;
+      virtual void calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                         const GeoPhysics::CompoundLithology* const* lithologies,
+                                         const unsigned int                          numberOfPositions,
+                                         const double*                               dependentValues,
+                                               double*                               values ) const override;
 
    private :
       const GeoPhysics::ProjectHandle& m_projectHandle;
@@ -92,6 +97,15 @@ namespace DerivedProperties {
       double calculateSingleNodeBulkDensityBasementAlc(const GeoPhysics::CompoundLithology* lithology, const double temperature, const double lithostaticPressure, const double depth, const double topBasaltDepth, const double basaltThickness) const;
       double calculateSingleNodeBulkDensitySedimentsCoupled(const GeoPhysics::FluidType* fluid, const double temperature, const double porePressure, const double porosity, const double solidDensity) const;
       double calculateSingleNodeBulkDensitySedimentsHydrostatic(const double porosity, const double solidDensity, const double fluidDensity) const;
+
+      /// \brief The positions of the dependent properties used by calculateAtPositions, -1 if not a dependency.
+      int m_porosityIndex;
+      int m_pressureIndex;
+      int m_temperatureIndex;
+      int m_lithoStaticPressureIndex;
+      int m_depthIndex;
+      int m_alcStepTopBasaltDepthIndex;
+      int m_alcStepBasaltThicknessIndex;
    };
 
 
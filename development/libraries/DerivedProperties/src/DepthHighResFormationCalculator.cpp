@@ -68,6 +68,10 @@ DerivedProperties::DepthHighResFormationCalculator::DepthHighResFormationCalcula
    }
 }
 
+bool DerivedProperties::DepthHighResFormationCalculator::dependsOnFormationAbove () const {
+   return true;
+}
+
 void DerivedProperties::DepthHighResFormationCalculator::calculate(       AbstractPropertyManager &      propertyManager,
                                                                     const DataModel::AbstractSnapshot *  snapshot,
                                                                     const DataModel::AbstractFormation * formation,
@@ -50,6 +50,9 @@ namespace DerivedProperties
                                const DataModel::AbstractFormation *                       formation,
                                      AbstractDerivedProperties::FormationPropertyList &   derivedProperties ) const;
 
+      /// \brief The values at the top of a formation are taken from the formation above.
+      virtual bool dependsOnFormationAbove () const;
+
    private :
 
       /// \brief Compute (indirectly, because we actually already have it) high resolution depth for non subsampled runs.
@@ -29,6 +29,8 @@ DerivedProperties::GammaRayFormationCalculator::GammaRayFormationCalculator( ) {
    addPropertyName ( "GammaRay" );
 
    addDependentPropertyName ( "Porosity" );
+
+   m_porosityIndex = getDependentPropertyIndex ( "Porosity" );
 }
 
 double DerivedProperties::GammaRayFormationCalculator::calculateGammaRay(const double porosity, const double solidRadiogenicHeatProduction) const
@@ -99,10 +101,17 @@ bool DerivedProperties::GammaRayFormationCalculator::isComputable( const Abstrac
    return  propManager.formationPropertyIsComputable( porosityProperty, snapshot, formation );
 }
 
-double DerivedProperties::GammaRayFormationCalculator::calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* /*formation*/,
-                                                                            const GeoPhysics::CompoundLithology* lithology,
-                                                                            const std::map<std::string, double>& dependentProperties) const
+void DerivedProperties::GammaRayFormationCalculator::calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      /*formation*/,
+                                                                           const GeoPhysics::CompoundLithology* const* lithologies,
+                                                                           const unsigned int                          numberOfPositions,
+                                                                           const double*                               dependentValues,
+                                                                                 double*                               values ) const
 {
-  const double solidRadiogenicHeatProduction = lithology->heatproduction();
-  return calculateGammaRay(dependentProperties.at("Porosity"), solidRadiogenicHeatProduction);
+  const size_t numberOfDependentValues = getDependentPropertyNames ().size ();
+
+  for ( unsigned int p = 0; p < numberOfPositions; ++p, dependentValues += numberOfDependentValues )
+  {
+    const double solidRadiogenicHeatProduction = lithologies[p]->heatproduction();
+    values[p] = calculateGammaRay(dependentValues[m_porosityIndex], solidRadiogenicHeatProduction);
+  }
 }
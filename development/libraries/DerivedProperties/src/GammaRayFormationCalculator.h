@@ -45,14 +45,19 @@ namespace DerivedProperties {
                          const DataModel::AbstractSnapshot*                        snapshot,
                          const DataModel::AbstractFormation*                       formation ) const final;
 
-      virtual double calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                          const GeoPhysics::CompoundLithology* lithology,
-                                          const std::map<std::string, double>& dependentProperties) const override;
+      virtual void calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                         const GeoPhysics::CompoundLithology* const* lithologies,
+                                         const unsigned int                          numberOfPositions,
+                                         const double*                               dependentValues,
+                                               double*                               values ) const override;
    private:
       const double m_gammaRayScaleFactor=0.0158;
       const double m_gammaRayOffset=0.8;
 
       double calculateGammaRay(const double porosity, const double solidRadiogenicHeatProduction) const;
+
+      /// \brief The positions of the dependent properties used by calculateAtPositions, -1 if not a dependency.
+      int m_porosityIndex;
    };
 
 
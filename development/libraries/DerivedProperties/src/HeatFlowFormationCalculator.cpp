@@ -59,6 +59,10 @@ DerivedProperties::HeatFlowFormationCalculator::HeatFlowFormationCalculator ( co
     }
 }
 
+bool DerivedProperties::HeatFlowFormationCalculator::dependsOnFormationAbove () const {
+   return true;
+}
+
 void DerivedProperties::HeatFlowFormationCalculator::calculate (       AbstractPropertyManager&      propertyManager,
                                                                  const DataModel::AbstractSnapshot*  snapshot,
                                                                  const DataModel::AbstractFormation* formation,
@@ -44,6 +44,9 @@ namespace DerivedProperties {
                                const DataModel::AbstractFormation*                       formation,
                                      AbstractDerivedProperties::FormationPropertyList&   derivedProperties ) const;
 
+      /// \brief The values in the basement depend on those of the formation above.
+      virtual bool dependsOnFormationAbove () const;
+
       virtual bool isComputable ( const AbstractDerivedProperties::AbstractPropertyManager& propManager,
                                   const DataModel::AbstractSnapshot*                        snapshot,
                                   const DataModel::AbstractFormation*                       formation ) const;
@@ -24,6 +24,8 @@
 #include "ConstantsPhysics.h"
 #include "ConstantsMathematics.h"
 
+#include <vector>
+
 using namespace AbstractDerivedProperties;
 
 DerivedProperties::HydrostaticPressureFormationCalculator::HydrostaticPressureFormationCalculator ( const GeoPhysics::ProjectHandle& projectHandle ) :
@@ -59,17 +61,19 @@ DerivedProperties::HydrostaticPressureFormationCalculator::HydrostaticPressureFo
    }
 }
 
+bool DerivedProperties::HydrostaticPressureFormationCalculator::dependsOnFormationAbove () const {
+   return true;
+}
+
 void DerivedProperties::HydrostaticPressureFormationCalculator::calculate (       AbstractPropertyManager&      propertyManager,
                                                                             const DataModel::AbstractSnapshot*  snapshot,
                                                                             const DataModel::AbstractFormation* formation,
                                                                                   FormationPropertyList&        derivedProperties ) const {
 
-   if ( m_hydrostaticDecompactionMode ) {
-      computeHydrostaticPressureForDecomapctionMode ( propertyManager, snapshot, formation, derivedProperties );
-   } else if ( m_hydrostaticMode ) {
+   if ( m_hydrostaticMode ) {
       computeHydrostaticPressureForHydrostaticMode ( propertyManager, snapshot, formation, derivedProperties );
    } else {
-      computeHydrostaticPressureForCoupledMode ( propertyManager, snapshot, formation, derivedProperties );
+      computeHydrostaticPressureForColumn ( propertyManager, snapshot, formation, derivedProperties );
    }
 
 }
@@ -145,13 +149,9 @@ void DerivedProperties::HydrostaticPressureFormationCalculator::computeHydrostat
 
 }
 
-void DerivedProperties::HydrostaticPressureFormationCalculator::copyHydrostaticPressureFromLayerAbove (       AbstractPropertyManager&      propertyManager,
-                                                                                                        const DataModel::AbstractProperty*  hydrostaticPressureProperty,
-                                                                                                        const DataModel::AbstractSnapshot*  snapshot,
-                                                                                                        const DataModel::AbstractFormation* formationAbove,
-                                                                                                              DerivedFormationPropertyPtr&  hydrostaticPressure ) const {
+void DerivedProperties::HydrostaticPressureFormationCalculator::copyHydrostaticPressureFromLayerAbove ( const FormationPropertyPtr&        hydrostaticPressureAbove,
+                                                                                                              DerivedFormationPropertyPtr& hydrostaticPressure ) const {
 
-   const FormationPropertyPtr hydrostaticPressureAbove = propertyManager.getFormationProperty ( hydrostaticPressureProperty, snapshot, formationAbove );
    double undefinedValue = hydrostaticPressure->getUndefinedValue ();
    unsigned int topNodeIndex = hydrostaticPressure->lastK ();
 
@@ -171,10 +171,21 @@ void DerivedProperties::HydrostaticPressureFormationCalculator::copyHydrostaticP
 
 }
 
-void DerivedProperties::HydrostaticPressureFormationCalculator::computeHydrostaticPressureForDecomapctionMode (       AbstractPropertyManager&      propertyManager,
-                                                                                                                const DataModel::AbstractSnapshot*  snapshot,
-                                                                                                                const DataModel::AbstractFormation* formation,
-                                                                                                                      FormationPropertyList&        derivedProperties ) const {
+const GeoPhysics::GeoPhysicsFormation* DerivedProperties::HydrostaticPressureFormationCalculator::getFormationAbove ( const GeoPhysics::GeoPhysicsFormation* formation,
+                                                                                                                    const DataModel::AbstractSnapshot*     snapshot ) const {
+
+   if ( formation->getTopSurface ()->getSnapshot () == 0 ||
+        formation->getTopSurface ()->getSnapshot ()->getTime () > snapshot->getTime ()) {
+      return dynamic_cast<const GeoPhysics::GeoPhysicsFormation*>( formation->getTopSurface ()->getTopFormation ());
+   }
+
+   return 0;
+}
+
+void DerivedProperties::HydrostaticPressureFormationCalculator::computeHydrostaticPressureForColumn (       AbstractPropertyManager&      propertyManager,
+                                                                                                      const DataModel::AbstractSnapshot*  snapshot,
+                                                                                                      const DataModel::AbstractFormation* formation,
+                                                                                                            FormationPropertyList&        derivedProperties ) const {
 
    const GeoPhysics::GeoPhysicsFormation* currentFormation = dynamic_cast<const GeoPhysics::GeoPhysicsFormation*>( formation );
 
@@ -185,87 +196,126 @@ void DerivedProperties::HydrostaticPressureFormationCalculator::computeHydrostat
    }
 
    const DataModel::AbstractProperty* hydrostaticPressureProperty = propertyManager.getProperty ( getPropertyNames ()[ 0 ]);
-   DerivedFormationPropertyPtr hydrostaticPressure = DerivedFormationPropertyPtr ( new DerivedProperties::DerivedFormationProperty ( hydrostaticPressureProperty, snapshot, formation,
-                                                                                                                                     propertyManager.getMapGrid (),
-                                                                                                                                     currentFormation->getMaximumNumberOfElements() + 1 ));
-
-   const DataModel::AbstractProperty* depthProperty = propertyManager.getProperty ( "Depth" );
-   FormationPropertyPtr depth = propertyManager.getFormationProperty ( depthProperty, snapshot, formation );
 
-   if( depth != 0 ) {
-      const GeoPhysics::GeoPhysicsFormation* formationAbove = 0;
+   // Collect the formations up to the top of the domain, or up to the first formation whose hydrostatic pressure is available.
+   // Requesting the hydrostatic pressure of the formation above instead would compute the column recursively, keeping the
+   // input properties of all formations retrieved until the top is reached.
+   std::vector<const GeoPhysics::GeoPhysicsFormation*> formations ( 1, currentFormation );
+   const GeoPhysics::GeoPhysicsFormation* formationAbove = getFormationAbove ( currentFormation, snapshot );
 
-      const GeoPhysics::FluidType* fluid = dynamic_cast<const GeoPhysics::FluidType*>(currentFormation->getFluidType ());
+   while ( formationAbove != 0 and not propertyManager.formationPropertyIsCalculated ( hydrostaticPressureProperty, snapshot, formationAbove )) {
+      formations.push_back ( formationAbove );
+      formationAbove = getFormationAbove ( formationAbove, snapshot );
+   }
 
-      double fluidDensity = 0;
+   FormationPropertyPtr hydrostaticPressureAbove;
 
-      double thickness;
-      double segmentPressure;
-      double pressure;
-      unsigned int topNodeIndex = hydrostaticPressure->lastK ();
-      double undefinedValue = hydrostaticPressure->getUndefinedValue ();
+   if ( formationAbove != 0 ) {
+      hydrostaticPressureAbove = propertyManager.getFormationProperty ( hydrostaticPressureProperty, snapshot, formationAbove );
+   }
 
-      derivedProperties.clear ();
+   derivedProperties.clear ();
 
-      if ( currentFormation->getTopSurface ()->getSnapshot () == 0 ||
-           currentFormation->getTopSurface ()->getSnapshot ()->getTime () > snapshot->getTime ()) {
-         formationAbove = dynamic_cast<const GeoPhysics::GeoPhysicsFormation*>( currentFormation->getTopSurface ()->getTopFormation ());
-      }
+   for ( std::vector<const GeoPhysics::GeoPhysicsFormation*>::const_reverse_iterator formationIter = formations.rbegin (); formationIter != formations.rend (); ++formationIter ) {
+      DerivedFormationPropertyPtr hydrostaticPressure;
 
-      if ( fluid == 0 ) {
-         fluidDensity = 0.0;
+      if ( m_hydrostaticDecompactionMode ) {
+         hydrostaticPressure = computeHydrostaticPressureForDecompactionMode ( propertyManager, snapshot, *formationIter, formationAbove, hydrostaticPressureAbove );
       } else {
-         const DataAccess::Interface::RunParameters* runParameters = m_projectHandle.getRunParameters();
-         const double temperatureGradient = 0.001 * runParameters->getTemperatureGradient ();
-         fluidDensity = fluid->getCorrectedSimpleDensity ( GeoPhysics::FluidType::DefaultStandardDepth,
-                                                           GeoPhysics::FluidType::DefaultHydrostaticPressureGradient,
-                                                           GeoPhysics::FluidType::StandardSurfaceTemperature,
-                                                           temperatureGradient );
+         hydrostaticPressure = computeHydrostaticPressureForCoupledMode ( propertyManager, snapshot, *formationIter, formationAbove, hydrostaticPressureAbove );
       }
 
-      // Initialise the top set of nodes for the hydrostatic pressure.
-      if ( formationAbove == 0 ) {
-         computeHydrostaticPressureAtSeaBottomForHydrostatic ( propertyManager, snapshot->getTime (), fluid, hydrostaticPressure );
-      } else {
-         copyHydrostaticPressureFromLayerAbove ( propertyManager, hydrostaticPressureProperty, snapshot, formationAbove, hydrostaticPressure );
+      if ( hydrostaticPressure != 0 ) {
+         derivedProperties.push_back ( hydrostaticPressure );
       }
 
-      PropertyRetriever depthRetriever ( depth );
+      formationAbove = *formationIter;
+      hydrostaticPressureAbove = hydrostaticPressure;
+   }
 
-      // now that the top of the set of nodes of the property has been initialised
-      // the hydrostatic pressure for the remaining nodes below them can be computed.
-      for ( unsigned int i = hydrostaticPressure->firstI ( true ); i <= hydrostaticPressure->lastI ( true ); ++i ) {
+}
 
-         for ( unsigned int j = hydrostaticPressure->firstJ ( true ); j <= hydrostaticPressure->lastJ ( true ); ++j ) {
+DerivedProperties::DerivedFormationPropertyPtr DerivedProperties::HydrostaticPressureFormationCalculator::computeHydrostaticPressureForDecompactionMode (       AbstractPropertyManager&               propertyManager,
+                                                                                                                                                   const DataModel::AbstractSnapshot*           snapshot,
+                                                                                                                                                   const GeoPhysics::GeoPhysicsFormation*       currentFormation,
+                                                                                                                                                   const GeoPhysics::GeoPhysicsFormation*       formationAbove,
+                                                                                                                                                   const FormationPropertyPtr&                  hydrostaticPressureAbove ) const {
 
-            if ( m_projectHandle.getNodeIsValid ( i, j )) {
+   const DataModel::AbstractProperty* hydrostaticPressureProperty = propertyManager.getProperty ( getPropertyNames ()[ 0 ]);
+   DerivedFormationPropertyPtr hydrostaticPressure = DerivedFormationPropertyPtr ( new DerivedProperties::DerivedFormationProperty ( hydrostaticPressureProperty, snapshot, currentFormation,
+                                                                                                                                     propertyManager.getMapGrid (),
+                                                                                                                                     currentFormation->getMaximumNumberOfElements() + 1 ));
 
-               // Loop index is shifted up by 1.
-               for ( unsigned int k = hydrostaticPressure->lastK (); k > hydrostaticPressure->firstK (); --k ) {
-                  // index k     is top node of segment
-                  // index k - 1 is bottom node of segment
+   const DataModel::AbstractProperty* depthProperty = propertyManager.getProperty ( "Depth" );
+   FormationPropertyPtr depth = propertyManager.getFormationProperty ( depthProperty, snapshot, currentFormation );
 
-                  thickness = depth->get ( i, j, k - 1 ) - depth->get ( i, j, k );
+   if( depth == 0 ) {
+      return DerivedFormationPropertyPtr ();
+   }
 
-                  segmentPressure = thickness * fluidDensity * Utilities::Physics::AccelerationDueToGravity * Utilities::Maths::PaToMegaPa;
-                  pressure = hydrostaticPressure->get ( i, j, k ) + segmentPressure;
-                  hydrostaticPressure->set ( i, j, k - 1, pressure );
-               }
+   const GeoPhysics::FluidType* fluid = dynamic_cast<const GeoPhysics::FluidType*>(currentFormation->getFluidType ());
 
-            } else {
+   double fluidDensity = 0;
 
-               for ( unsigned int k = hydrostaticPressure->firstK (); k <= hydrostaticPressure->lastK (); ++k ) {
-                  hydrostaticPressure->set ( i, j, k, undefinedValue );
-               }
+   double thickness;
+   double segmentPressure;
+   double pressure;
+   unsigned int topNodeIndex = hydrostaticPressure->lastK ();
+   double undefinedValue = hydrostaticPressure->getUndefinedValue ();
+
+   if ( fluid == 0 ) {
+      fluidDensity = 0.0;
+   } else {
+      const DataAccess::Interface::RunParameters* runParameters = m_projectHandle.getRunParameters();
+      const double temperatureGradient = 0.001 * runParameters->getTemperatureGradient ();
+      fluidDensity = fluid->getCorrectedSimpleDensity ( GeoPhysics::FluidType::DefaultStandardDepth,
+                                                        GeoPhysics::FluidType::DefaultHydrostaticPressureGradient,
+                                                        GeoPhysics::FluidType::StandardSurfaceTemperature,
+                                                        temperatureGradient );
+   }
+
+   // Initialise the top set of nodes for the hydrostatic pressure.
+   if ( formationAbove == 0 ) {
+      computeHydrostaticPressureAtSeaBottomForHydrostatic ( propertyManager, snapshot->getTime (), fluid, hydrostaticPressure );
+   } else {
+      copyHydrostaticPressureFromLayerAbove ( hydrostaticPressureAbove, hydrostaticPressure );
+   }
+
+   PropertyRetriever depthRetriever ( depth );
+
+   // now that the top of the set of nodes of the property has been initialised
+   // the hydrostatic pressure for the remaining nodes below them can be computed.
+   for ( unsigned int i = hydrostaticPressure->firstI ( true ); i <= hydrostaticPressure->lastI ( true ); ++i ) {
+
+      for ( unsigned int j = hydrostaticPressure->firstJ ( true ); j <= hydrostaticPressure->lastJ ( true ); ++j ) {
+
+         if ( m_projectHandle.getNodeIsValid ( i, j )) {
+
+            // Loop index is shifted up by 1.
+            for ( unsigned int k = hydrostaticPressure->lastK (); k > hydrostaticPressure->firstK (); --k ) {
+               // index k     is top node of segment
+               // index k - 1 is bottom node of segment
 
+               thickness = depth->get ( i, j, k - 1 ) - depth->get ( i, j, k );
+
+               segmentPressure = thickness * fluidDensity * Utilities::Physics::AccelerationDueToGravity * Utilities::Maths::PaToMegaPa;
+               pressure = hydrostaticPressure->get ( i, j, k ) + segmentPressure;
+               hydrostaticPressure->set ( i, j, k - 1, pressure );
+            }
+
+         } else {
+
+            for ( unsigned int k = hydrostaticPressure->firstK (); k <= hydrostaticPressure->lastK (); ++k ) {
+               hydrostaticPressure->set ( i, j, k, undefinedValue );
             }
 
          }
 
       }
 
-      derivedProperties.push_back ( hydrostaticPressure );
    }
+
+   return hydrostaticPressure;
 }
 
 
@@ -314,34 +364,27 @@ void DerivedProperties::HydrostaticPressureFormationCalculator::computeHydrostat
    }
 }
 
-void DerivedProperties::HydrostaticPressureFormationCalculator::computeHydrostaticPressureForCoupledMode (       AbstractPropertyManager&      propertyManager,
-                                                                                                           const DataModel::AbstractSnapshot*  snapshot,
-                                                                                                           const DataModel::AbstractFormation* formation,
-                                                                                                                 FormationPropertyList&        derivedProperties ) const {
-
-   const GeoPhysics::GeoPhysicsFormation* currentFormation = dynamic_cast<const GeoPhysics::GeoPhysicsFormation*>( formation );
-
-   const bool basementFormation = ( currentFormation->kind () == DataAccess::Interface::BASEMENT_FORMATION );
-
-   if ( basementFormation ) {
-      return computeForBasement( propertyManager, snapshot, formation, derivedProperties );
-   }
+DerivedProperties::DerivedFormationPropertyPtr DerivedProperties::HydrostaticPressureFormationCalculator::computeHydrostaticPressureForCoupledMode (       AbstractPropertyManager&               propertyManager,
+                                                                                                                                              const DataModel::AbstractSnapshot*           snapshot,
+                                                                                                                                              const GeoPhysics::GeoPhysicsFormation*       currentFormation,
+                                                                                                                                              const GeoPhysics::GeoPhysicsFormation*       formationAbove,
+                                                                                                                                              const FormationPropertyPtr&                  hydrostaticPressureAbove ) const {
 
    const DataModel::AbstractProperty* hydrostaticPressureProperty = propertyManager.getProperty ( getPropertyNames ()[ 0 ]);
-   DerivedFormationPropertyPtr hydrostaticPressure = DerivedFormationPropertyPtr ( new DerivedProperties::DerivedFormationProperty ( hydrostaticPressureProperty, snapshot, formation,
+   DerivedFormationPropertyPtr hydrostaticPressure = DerivedFormationPropertyPtr ( new DerivedProperties::DerivedFormationProperty ( hydrostaticPressureProperty, snapshot, currentFormation,
                                                                                                                                      propertyManager.getMapGrid (),
                                                                                                                                      currentFormation->getMaximumNumberOfElements() + 1 ));
 
    const DataModel::AbstractProperty* porePressureProperty = propertyManager.getProperty ( "Pressure" );
-   FormationPropertyPtr porePressure = propertyManager.getFormationProperty ( porePressureProperty, snapshot, formation );
+   FormationPropertyPtr porePressure = propertyManager.getFormationProperty ( porePressureProperty, snapshot, currentFormation );
    PropertyRetriever ppRetriever ( porePressure );
 
    const DataModel::AbstractProperty* depthProperty = propertyManager.getProperty ( "Depth" );
-   FormationPropertyPtr depth = propertyManager.getFormationProperty ( depthProperty, snapshot, formation );
+   FormationPropertyPtr depth = propertyManager.getFormationProperty ( depthProperty, snapshot, currentFormation );
    PropertyRetriever depthRetriever ( depth );
 
    const DataModel::AbstractProperty* temperatureProperty = propertyManager.getProperty ( "Temperature" );
-   FormationPropertyPtr temperature = propertyManager.getFormationProperty ( temperatureProperty, snapshot, formation );
+   FormationPropertyPtr temperature = propertyManager.getFormationProperty ( temperatureProperty, snapshot, currentFormation );
    PropertyRetriever temperatureRetriever;
    if ( temperature )
    {
@@ -349,7 +392,7 @@ void DerivedProperties::HydrostaticPressureFormationCalculator::computeHydrostat
    }
 
    if( m_opMode and temperature == 0 and depth != 0 ) {
-      DerivedFormationPropertyPtr temp = DerivedFormationPropertyPtr ( new DerivedProperties::DerivedFormationProperty ( temperatureProperty, snapshot, formation,
+      DerivedFormationPropertyPtr temp = DerivedFormationPropertyPtr ( new DerivedProperties::DerivedFormationProperty ( temperatureProperty, snapshot, currentFormation,
                                                                                                     propertyManager.getMapGrid (),
                                                                                                     currentFormation->getMaximumNumberOfElements() + 1 ));
 
@@ -358,8 +401,6 @@ void DerivedProperties::HydrostaticPressureFormationCalculator::computeHydrostat
       temperature = temp;
    }
 
-   const GeoPhysics::GeoPhysicsFormation* formationAbove = 0;
-
    const GeoPhysics::FluidType* fluid = dynamic_cast<const GeoPhysics::FluidType*>(currentFormation->getFluidType ());
 
    double fluidDensityTop;
@@ -371,18 +412,11 @@ void DerivedProperties::HydrostaticPressureFormationCalculator::computeHydrostat
    unsigned int topNodeIndex = hydrostaticPressure->lastK ();
    double undefinedValue = hydrostaticPressure->getUndefinedValue ();
 
-   derivedProperties.clear ();
-
-   if ( currentFormation->getTopSurface ()->getSnapshot () == 0 ||
-        currentFormation->getTopSurface ()->getSnapshot ()->getTime () > snapshot->getTime ()) {
-      formationAbove = dynamic_cast<const GeoPhysics::GeoPhysicsFormation*>( currentFormation->getTopSurface ()->getTopFormation ());
-   }
-
    // Initialise the top set of nodes for the hydrostatic pressure.
    if ( formationAbove == 0 ) {
       computeHydrostaticPressureAtSeaBottom ( propertyManager, snapshot->getTime (), fluid, hydrostaticPressure );
    } else {
-      copyHydrostaticPressureFromLayerAbove ( propertyManager, hydrostaticPressureProperty, snapshot, formationAbove, hydrostaticPressure );
+      copyHydrostaticPressureFromLayerAbove ( hydrostaticPressureAbove, hydrostaticPressure );
    }
 
 
@@ -431,9 +465,10 @@ void DerivedProperties::HydrostaticPressureFormationCalculator::computeHydrostat
       }
 
 
-      derivedProperties.push_back ( hydrostaticPressure );
+      return hydrostaticPressure;
    }
 
+   return DerivedFormationPropertyPtr ();
 }
 
 void DerivedProperties::HydrostaticPressureFormationCalculator::computeForBasement (       AbstractPropertyManager&      propertyManager,
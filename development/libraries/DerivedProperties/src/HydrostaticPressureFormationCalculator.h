@@ -41,28 +41,50 @@ namespace DerivedProperties {
                                const DataModel::AbstractFormation*                       formation,
                                      AbstractDerivedProperties::FormationPropertyList&   derivedProperties ) const;
 
+      /// \brief The values at the top of a formation are taken from the formation above.
+      virtual bool dependsOnFormationAbove () const;
+
       virtual bool isComputable ( const AbstractDerivedProperties::AbstractPropertyManager& propManager,
                                   const DataModel::AbstractSnapshot*                        snapshot,
                                   const DataModel::AbstractFormation*                       formation ) const;
    private :
 
-      /// \brief Compute hydrostatic pressure after a fastcauldron hydrostatic decompaction simulation mode.
-      void computeHydrostaticPressureForDecomapctionMode (       AbstractDerivedProperties::AbstractPropertyManager& propertyManager,
-                                                           const DataModel::AbstractSnapshot*                        snapshot,
-                                                           const DataModel::AbstractFormation*                       formation,
-                                                                 AbstractDerivedProperties::FormationPropertyList&   derivedProperties ) const;
-
       /// \brief Compute hydrostatic pressure after a fastcauldron hydrostatic temperature simulation mode.
       void computeHydrostaticPressureForHydrostaticMode (       AbstractDerivedProperties::AbstractPropertyManager& propertyManager,
                                                           const DataModel::AbstractSnapshot*                        snapshot,
                                                           const DataModel::AbstractFormation*                       formation,
                                                                 AbstractDerivedProperties::FormationPropertyList&   derivedProperties ) const;
 
+      /// \brief Compute the hydrostatic pressure for the formation and for the formations above it that have not been computed yet.
+      ///
+      /// The column is integrated top-down in a single pass, starting from the sea bottom or from the nearest formation above
+      /// whose hydrostatic pressure has been computed already. Only the input properties of one formation are retrieved at a time.
+      void computeHydrostaticPressureForColumn (       AbstractDerivedProperties::AbstractPropertyManager& propertyManager,
+                                                 const DataModel::AbstractSnapshot*                        snapshot,
+                                                 const DataModel::AbstractFormation*                       formation,
+                                                       AbstractDerivedProperties::FormationPropertyList&   derivedProperties ) const;
+
+      /// \brief Compute hydrostatic pressure after a fastcauldron hydrostatic decompaction simulation mode.
+      ///
+      /// Returns null if the depth is not available.
+      DerivedFormationPropertyPtr computeHydrostaticPressureForDecompactionMode (       AbstractDerivedProperties::AbstractPropertyManager& propertyManager,
+                                                                                 const DataModel::AbstractSnapshot*                        snapshot,
+                                                                                 const GeoPhysics::GeoPhysicsFormation*                    formation,
+                                                                                 const GeoPhysics::GeoPhysicsFormation*                    formationAbove,
+                                                                                 const AbstractDerivedProperties::FormationPropertyPtr&    hydrostaticPressureAbove ) const;
+
       /// \brief Compute hydrostatic pressure after a fastcauldron coupled simulation mode.
-      void computeHydrostaticPressureForCoupledMode (       AbstractDerivedProperties::AbstractPropertyManager& propertyManager,
-                                                      const DataModel::AbstractSnapshot*                        snapshot,
-                                                      const DataModel::AbstractFormation*                       formation,
-                                                            AbstractDerivedProperties::FormationPropertyList&   derivedProperties ) const;
+      ///
+      /// Returns null if the depth, temperature or pore pressure is not available.
+      DerivedFormationPropertyPtr computeHydrostaticPressureForCoupledMode (       AbstractDerivedProperties::AbstractPropertyManager& propertyManager,
+                                                                            const DataModel::AbstractSnapshot*                        snapshot,
+                                                                            const GeoPhysics::GeoPhysicsFormation*                    formation,
+                                                                            const GeoPhysics::GeoPhysicsFormation*                    formationAbove,
+                                                                            const AbstractDerivedProperties::FormationPropertyPtr&    hydrostaticPressureAbove ) const;
+
+      /// \brief Get the formation directly above the formation, null if there is none at the snapshot age.
+      const GeoPhysics::GeoPhysicsFormation* getFormationAbove ( const GeoPhysics::GeoPhysicsFormation* formation,
+                                                                 const DataModel::AbstractSnapshot*     snapshot ) const;
 
       /// \brief Compute hydrostatic pressure for the basement formation ( set to 0)
       void computeForBasement (       AbstractDerivedProperties::AbstractPropertyManager& propertyManager,
@@ -83,11 +105,10 @@ namespace DerivedProperties {
                                                                        DerivedFormationPropertyPtr&                        hydrostaticPressure ) const;
 
       /// \brief Copy the hydrostatic pressure from the formation directly above the surface.
-      void copyHydrostaticPressureFromLayerAbove (       AbstractDerivedProperties::AbstractPropertyManager& propertyManager,
-                                                   const DataModel::AbstractProperty*                        hydrostaticPressureProperty,
-                                                   const DataModel::AbstractSnapshot*                        snapshot,
-                                                   const DataModel::AbstractFormation*                       formationAbove,
-                                                         DerivedFormationPropertyPtr&                        hydrostaticPressure ) const;
+      ///
+      /// The top nodes are undefined if the hydrostatic pressure above is null.
+      void copyHydrostaticPressureFromLayerAbove ( const AbstractDerivedProperties::FormationPropertyPtr& hydrostaticPressureAbove,
+                                                         DerivedFormationPropertyPtr&                     hydrostaticPressure ) const;
 
       void computeEstimatedTemperature ( const double                                           snapshotAge,
                                          const AbstractDerivedProperties::FormationPropertyPtr& depth,
@@ -29,6 +29,8 @@
 #include "ConstantsPhysics.h"
 #include "ConstantsMathematics.h"
 
+#include <algorithm>
+
 using namespace AbstractDerivedProperties;
 using namespace std;
 
@@ -51,6 +53,9 @@ DerivedProperties::LithostaticPressureFormationCalculator::LithostaticPressureFo
       addDependentPropertyName( "ALCStepTopBasaltDepth");
       addDependentPropertyName( "ALCStepBasaltThickness");
    }
+
+   m_vesIndex = getDependentPropertyIndex ( "Ves" );
+   m_pressureIndex = getDependentPropertyIndex ( "Pressure" );
 }
 
 double DerivedProperties::LithostaticPressureFormationCalculator::calculateLithostaticPressure(double ves, double porePressure) const
@@ -58,6 +63,10 @@ double DerivedProperties::LithostaticPressureFormationCalculator::calculateLitho
   return ves * Utilities::Maths::PaToMegaPa + porePressure;
 }
 
+bool DerivedProperties::LithostaticPressureFormationCalculator::dependsOnFormationAbove () const {
+   return true;
+}
+
 void DerivedProperties::LithostaticPressureFormationCalculator::calculate (       AbstractPropertyManager&      propertyManager,
                                                                             const DataModel::AbstractSnapshot*  snapshot,
                                                                             const DataModel::AbstractFormation* formation,
@@ -366,15 +375,23 @@ bool DerivedProperties::LithostaticPressureFormationCalculator::isComputableForB
    return propertyIsComputable;
 }
 
-double DerivedProperties::LithostaticPressureFormationCalculator::calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                                                                       const GeoPhysics::CompoundLithology* /*lithology*/,
-                                                                                       const std::map<string, double>& dependentProperties ) const
+void DerivedProperties::LithostaticPressureFormationCalculator::calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                                                                      const GeoPhysics::CompoundLithology* const* /*lithologies*/,
+                                                                                      const unsigned int                          numberOfPositions,
+                                                                                      const double*                               dependentValues,
+                                                                                            double*                               values ) const
 {
   if( formation->kind() == DataAccess::Interface::BASEMENT_FORMATION )
   {
-     return DataAccess::Interface::DefaultUndefinedScalarValue; // Not Implemented for 0D calculations
+     std::fill( values, values + numberOfPositions, DataAccess::Interface::DefaultUndefinedScalarValue ); // Not Implemented for 0D calculations
+     return;
   }
 
-  return DerivedProperties::LithostaticPressureFormationCalculator::calculateLithostaticPressure(dependentProperties.at("Ves"),
-                                                                                                 dependentProperties.at("Pressure"));
+  const size_t numberOfDependentValues = getDependentPropertyNames ().size ();
+
+  for ( unsigned int p = 0; p < numberOfPositions; ++p, dependentValues += numberOfDependentValues )
+  {
+    values[p] = DerivedProperties::LithostaticPressureFormationCalculator::calculateLithostaticPressure(dependentValues[m_vesIndex],
+                                                                                                        dependentValues[m_pressureIndex]);
+  }
 }
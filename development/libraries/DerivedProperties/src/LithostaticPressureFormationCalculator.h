@@ -36,6 +36,9 @@ namespace DerivedProperties {
                                const DataModel::AbstractFormation*                       formation,
                                      AbstractDerivedProperties::FormationPropertyList&   derivedProperties ) const;
 
+      /// \brief The values in the basement depend on those of the formation above.
+      virtual bool dependsOnFormationAbove () const;
+
       /// \brief Calculate the lithostatic-pressure for the basement formation.
       ///
       /// \param [in]  propManager The property manager.
@@ -59,9 +62,11 @@ namespace DerivedProperties {
                                              const DataModel::AbstractSnapshot*                        snapshot,
                                              const DataModel::AbstractFormation*                       formation ) const;
 
-      virtual double calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                          const GeoPhysics::CompoundLithology* lithology,
-                                          const std::map<std::string, double>& dependentProperties ) const override;
+      virtual void calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                         const GeoPhysics::CompoundLithology* const* lithologies,
+                                         const unsigned int                          numberOfPositions,
+                                         const double*                               dependentValues,
+                                               double*                               values ) const override;
       
    private :
       double calculateLithostaticPressure(double ves, double porePressure) const;
@@ -81,6 +86,10 @@ namespace DerivedProperties {
       const GeoPhysics::ProjectHandle& m_projectHandle;
 
       bool m_hydrostaticDecompactionMode;
+
+      /// \brief The positions of the dependent properties used by calculateAtPositions, -1 if not a dependency.
+      int m_vesIndex;
+      int m_pressureIndex;
    };
 
 
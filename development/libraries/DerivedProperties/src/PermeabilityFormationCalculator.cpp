@@ -46,24 +46,32 @@ DerivedProperties::PermeabilityFormationCalculator::PermeabilityFormationCalcula
       addDependentPropertyName ( "ChemicalCompaction" );
    }
 
+   m_vesIndex = getDependentPropertyIndex ( "Ves" );
+   m_maxVesIndex = getDependentPropertyIndex ( "MaxVes" );
+   m_chemicalCompactionIndex = getDependentPropertyIndex ( "ChemicalCompaction" );
 }
 
-double DerivedProperties::PermeabilityFormationCalculator::calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                                                                const GeoPhysics::CompoundLithology* lithology,
-                                                                                const std::map<string, double>& dependentProperties ) const
+void DerivedProperties::PermeabilityFormationCalculator::calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                                                               const GeoPhysics::CompoundLithology* const* lithologies,
+                                                                               const unsigned int                          numberOfPositions,
+                                                                               const double*                               dependentValues,
+                                                                                     double*                               values ) const
 {
   double permNorm;
-  double permPlane;
   GeoPhysics::CompoundProperty porosity;
   bool chemicalCompactionRequired = m_chemicalCompactionRequired and formation->hasChemicalCompaction ();
-  const double chemicalCompactionValue = ( chemicalCompactionRequired ? dependentProperties.at("ChemicalCompaction") : 0.0 );
-
-  calculatePermeability(lithology,
-                        dependentProperties.at("Ves"),
-                        dependentProperties.at("MaxVes"),
-                        chemicalCompactionRequired, chemicalCompactionValue,
-                        permNorm, permPlane, porosity);
-  return permPlane;
+  const size_t numberOfDependentValues = getDependentPropertyNames ().size ();
+
+  for ( unsigned int p = 0; p < numberOfPositions; ++p, dependentValues += numberOfDependentValues )
+  {
+    const double chemicalCompactionValue = ( chemicalCompactionRequired ? dependentValues[m_chemicalCompactionIndex] : 0.0 );
+
+    calculatePermeability(lithologies[p],
+                          dependentValues[m_vesIndex],
+                          dependentValues[m_maxVesIndex],
+                          chemicalCompactionRequired, chemicalCompactionValue,
+                          permNorm, values[p], porosity);
+  }
 }
 
 void DerivedProperties::PermeabilityFormationCalculator::calculatePermeability(const GeoPhysics::CompoundLithology* lithology, double ves, double maxVes,
@@ -126,17 +134,22 @@ void DerivedProperties::PermeabilityFormationCalculator::calculate (       Abstr
       const double undefinedValue = ves->getUndefinedValue ();
       const double currentAge = snapshot->getTime();
 
-      double chemicalCompactionValue, permNorm, permPlane;
-      GeoPhysics::CompoundProperty porosity;
+      // The dependent properties have been retrieved above, the nodes are independent of each other.
+      const int firstI = static_cast<int>( verticalPermeability->firstI ( true ));
+      const int lastI  = static_cast<int>( verticalPermeability->lastI ( true ));
 
-      for ( unsigned int i = verticalPermeability->firstI ( true ); i <= verticalPermeability->lastI ( true ); ++i ) {
+      #pragma omp parallel for schedule ( static )
+      for ( int i = firstI; i <= lastI; ++i ) {
+
+         double permNorm, permPlane;
+         GeoPhysics::CompoundProperty porosity;
 
          for ( unsigned int j = verticalPermeability->firstJ ( true ); j <= verticalPermeability->lastJ ( true ); ++j ) {
 
             if ( m_projectHandle.getNodeIsValid ( i, j )) {
 
                for ( unsigned int k = verticalPermeability->firstK (); k <= verticalPermeability->lastK (); ++k ) {
-                  chemicalCompactionValue = ( chemicalCompactionRequired ? chemicalCompaction->get ( i, j, k ) : 0.0 );
+                  const double chemicalCompactionValue = ( chemicalCompactionRequired ? chemicalCompaction->get ( i, j, k ) : 0.0 );
 
                   calculatePermeability(lithologies( i, j, currentAge ), ves->get ( i, j, k ), maxVes->get ( i, j, k ), chemicalCompactionRequired,
                                         chemicalCompactionValue, permNorm, permPlane, porosity);
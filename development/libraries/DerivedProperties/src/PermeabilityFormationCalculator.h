@@ -40,9 +40,11 @@ namespace DerivedProperties {
                                const DataModel::AbstractFormation*                       formation,
                                      AbstractDerivedProperties::FormationPropertyList&   derivedProperties ) const;
 
-      virtual double calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                          const GeoPhysics::CompoundLithology* lithology,
-                                          const std::map<std::string, double>& dependentProperties) const override;
+      virtual void calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                         const GeoPhysics::CompoundLithology* const* lithologies,
+                                         const unsigned int                          numberOfPositions,
+                                         const double*                               dependentValues,
+                                               double*                               values ) const override;
 
    private :
       void calculatePermeability(const GeoPhysics::CompoundLithology* lithology, double ves, double maxVes, bool chemicalCompactionRequired,
@@ -50,6 +52,11 @@ namespace DerivedProperties {
 
       const GeoPhysics::ProjectHandle& m_projectHandle;
       bool m_chemicalCompactionRequired;
+
+      /// \brief The positions of the dependent properties used by calculateAtPositions, -1 if not a dependency.
+      int m_vesIndex;
+      int m_maxVesIndex;
+      int m_chemicalCompactionIndex;
    };
 
 }
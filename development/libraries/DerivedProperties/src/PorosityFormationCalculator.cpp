@@ -43,20 +43,30 @@ DerivedProperties::PorosityFormationCalculator::PorosityFormationCalculator ( co
       addDependentPropertyName ( "ChemicalCompaction" );
    }
 
+   m_vesIndex = getDependentPropertyIndex ( "Ves" );
+   m_maxVesIndex = getDependentPropertyIndex ( "MaxVes" );
+   m_chemicalCompactionIndex = getDependentPropertyIndex ( "ChemicalCompaction" );
 }
 
-double DerivedProperties::PorosityFormationCalculator::calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                                                            const GeoPhysics::CompoundLithology* lithology,
-                                                                            const std::map<string, double>& dependentProperties ) const
+void DerivedProperties::PorosityFormationCalculator::calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                                                           const GeoPhysics::CompoundLithology* const* lithologies,
+                                                                           const unsigned int                          numberOfPositions,
+                                                                           const double*                               dependentValues,
+                                                                                 double*                               values ) const
 {
   bool chemicalCompactionRequired = m_chemicalCompactionRequired and formation->hasChemicalCompaction ();
-  const double chemicalCompactionValue = ( chemicalCompactionRequired ? dependentProperties.at("ChemicalCompaction") : 0.0 );
-
-  return calculatePorosity(lithology,
-                           dependentProperties.at("Ves"),
-                           dependentProperties.at("MaxVes"),
-                           chemicalCompactionRequired,
-                           chemicalCompactionValue);
+  const size_t numberOfDependentValues = getDependentPropertyNames ().size ();
+
+  for ( unsigned int p = 0; p < numberOfPositions; ++p, dependentValues += numberOfDependentValues )
+  {
+    const double chemicalCompactionValue = ( chemicalCompactionRequired ? dependentValues[m_chemicalCompactionIndex] : 0.0 );
+
+    values[p] = calculatePorosity(lithologies[p],
+                                  dependentValues[m_vesIndex],
+                                  dependentValues[m_maxVesIndex],
+                                  chemicalCompactionRequired,
+                                  chemicalCompactionValue);
+  }
 }
 
 double DerivedProperties::PorosityFormationCalculator::calculatePorosity(const GeoPhysics::CompoundLithology* lithology, double ves, double maxVes, bool chemicalCompactionRequired, double chemicalCompactionValue) const
@@ -114,7 +124,12 @@ void DerivedProperties::PorosityFormationCalculator::calculate (       AbstractP
       const double undefinedValue = ves->getUndefinedValue ();
       const double currentTime = snapshot->getTime();
 
-      for ( unsigned int i = porosityProp->firstI ( true ); i <= porosityProp->lastI ( true ); ++i ) {
+      // The dependent properties have been retrieved above, the nodes are independent of each other.
+      const int firstI = static_cast<int>( porosityProp->firstI ( true ));
+      const int lastI  = static_cast<int>( porosityProp->lastI ( true ));
+
+      #pragma omp parallel for schedule ( static )
+      for ( int i = firstI; i <= lastI; ++i ) {
 
          for ( unsigned int j = porosityProp->firstJ ( true ); j <= porosityProp->lastJ ( true ); ++j ) {
 
@@ -40,14 +40,21 @@ namespace DerivedProperties {
                                      AbstractDerivedProperties::FormationPropertyList&   derivedProperties ) const;
 
 
-      virtual double calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                          const GeoPhysics::CompoundLithology* lithology,
-                                          const std::map<std::string, double>& dependentProperties ) const override;
+      virtual void calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                         const GeoPhysics::CompoundLithology* const* lithologies,
+                                         const unsigned int                          numberOfPositions,
+                                         const double*                               dependentValues,
+                                               double*                               values ) const override;
    private :
 
       double calculatePorosity(const GeoPhysics::CompoundLithology* lithology, double ves, double maxVes, bool chemicalCompactionRequired, double chemicalCompactionValue) const;
       const GeoPhysics::ProjectHandle& m_projectHandle;
       bool m_chemicalCompactionRequired;
+
+      /// \brief The positions of the dependent properties used by calculateAtPositions, -1 if not a dependency.
+      int m_vesIndex;
+      int m_maxVesIndex;
+      int m_chemicalCompactionIndex;
    };
 
 
@@ -30,6 +30,8 @@ using namespace std;
 DerivedProperties::SonicFormationCalculator::SonicFormationCalculator() {
    addPropertyName ( "SonicSlowness" );
    addDependentPropertyName ( "Velocity" );
+
+   m_velocityIndex = getDependentPropertyIndex ( "Velocity" );
 }
 
 double DerivedProperties::SonicFormationCalculator::calculateSonic(double velocity) const
@@ -94,9 +96,16 @@ void DerivedProperties::SonicFormationCalculator::calculate(       AbstractPrope
    } 
 }
 
-double DerivedProperties::SonicFormationCalculator::calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* /*formation*/,
-                                                                         const GeoPhysics::CompoundLithology* /*lithology*/,
-                                                                         const std::map<string, double>& dependentProperties ) const
+void DerivedProperties::SonicFormationCalculator::calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      /*formation*/,
+                                                                        const GeoPhysics::CompoundLithology* const* /*lithologies*/,
+                                                                        const unsigned int                          numberOfPositions,
+                                                                        const double*                               dependentValues,
+                                                                              double*                               values ) const
 {
-  return calculateSonic( dependentProperties.at( "Velocity" ) );
+  const size_t numberOfDependentValues = getDependentPropertyNames ().size ();
+
+  for ( unsigned int p = 0; p < numberOfPositions; ++p, dependentValues += numberOfDependentValues )
+  {
+    values[p] = calculateSonic( dependentValues[m_velocityIndex] );
+  }
 }
@@ -26,6 +26,8 @@
 #include "PropertyRetriever.h"
 #include "ConstantsMathematics.h"
 
+#include <algorithm>
+
 using namespace AbstractDerivedProperties;
 using namespace DataAccess::Interface;
 using namespace std;
@@ -46,6 +48,10 @@ DerivedProperties::ThermalConductivityFormationCalculator::ThermalConductivityFo
        addDependentPropertyName ( "ALCStepTopBasaltDepth" );
        addDependentPropertyName ( "ALCStepBasaltThickness" );
     }
+
+   m_porosityIndex = getDependentPropertyIndex ( "Porosity" );
+   m_temperatureIndex = getDependentPropertyIndex ( "Temperature" );
+   m_pressureIndex = getDependentPropertyIndex ( "Pressure" );
 }
 
 double DerivedProperties::ThermalConductivityFormationCalculator::calculateThermalConductivity(const GeoPhysics::CompoundLithology* lithology, const GeoPhysics::FluidType* fluid,
@@ -339,19 +345,27 @@ bool DerivedProperties::ThermalConductivityFormationCalculator::isComputableForB
    return propertyIsComputable;
 }
 
-double DerivedProperties::ThermalConductivityFormationCalculator::calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                                                                       const GeoPhysics::CompoundLithology* lithology,
-                                                                                       const std::map<string, double>& dependentProperties ) const
+void DerivedProperties::ThermalConductivityFormationCalculator::calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                                                                      const GeoPhysics::CompoundLithology* const* lithologies,
+                                                                                      const unsigned int                          numberOfPositions,
+                                                                                      const double*                               dependentValues,
+                                                                                            double*                               values ) const
 {
   const GeoPhysics::FluidType* fluid = dynamic_cast<const GeoPhysics::FluidType*>( formation->getFluidType() );
 
   if ( formation->kind() == DataAccess::Interface::BASEMENT_FORMATION )
   {
-    return DefaultUndefinedScalarValue; // Not Implemented for 0D calculation
+    std::fill( values, values + numberOfPositions, DefaultUndefinedScalarValue ); // Not Implemented for 0D calculation
+    return;
   }
 
-  return calculateThermalConductivity( lithology, fluid,
-                                       dependentProperties.at("Porosity"),
-                                       dependentProperties.at("Temperature"),
-                                       dependentProperties.at("Pressure") );
+  const size_t numberOfDependentValues = getDependentPropertyNames ().size ();
+
+  for ( unsigned int p = 0; p < numberOfPositions; ++p, dependentValues += numberOfDependentValues )
+  {
+    values[p] = calculateThermalConductivity( lithologies[p], fluid,
+                                              dependentValues[m_porosityIndex],
+                                              dependentValues[m_temperatureIndex],
+                                              dependentValues[m_pressureIndex] );
+  }
 }
@@ -68,9 +68,11 @@ namespace DerivedProperties {
                                              const DataModel::AbstractSnapshot*                        snapshot,
                                              const DataModel::AbstractFormation*                       formation ) const;
 
-      virtual double calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                          const GeoPhysics::CompoundLithology* lithology,
-                                          const std::map<std::string, double>& dependentProperties) const override;
+      virtual void calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                         const GeoPhysics::CompoundLithology* const* lithologies,
+                                         const unsigned int                          numberOfPositions,
+                                         const double*                               dependentValues,
+                                               double*                               values ) const override;
 
    private :
 
@@ -78,6 +80,11 @@ namespace DerivedProperties {
                                            const double porosity, const double temperature, const double porePressure ) const;
       const GeoPhysics::ProjectHandle& m_projectHandle;
 
+
+      /// \brief The positions of the dependent properties used by calculateAtPositions, -1 if not a dependency.
+      int m_porosityIndex;
+      int m_temperatureIndex;
+      int m_pressureIndex;
    };
 
 
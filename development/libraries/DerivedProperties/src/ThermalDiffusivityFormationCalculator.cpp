@@ -27,6 +27,8 @@
 #include "ConstantsNumerical.h"
 #include "ConstantsMathematics.h"
 
+#include <algorithm>
+
 using namespace AbstractDerivedProperties;
 
 DerivedProperties::ThermalDiffusivityFormationCalculator::ThermalDiffusivityFormationCalculator ( const GeoPhysics::ProjectHandle& projectHandle ) : m_projectHandle ( projectHandle ) {
@@ -36,6 +38,10 @@ DerivedProperties::ThermalDiffusivityFormationCalculator::ThermalDiffusivityForm
    addDependentPropertyName ( "Pressure" );
    addDependentPropertyName ( "LithoStaticPressure" );
    addDependentPropertyName ( "Porosity" );
+
+   m_porosityIndex = getDependentPropertyIndex ( "Porosity" );
+   m_pressureIndex = getDependentPropertyIndex ( "Pressure" );
+   m_temperatureIndex = getDependentPropertyIndex ( "Temperature" );
 }
 
 double DerivedProperties::ThermalDiffusivityFormationCalculator::calculateThermalDiffusivity(const GeoPhysics::CompoundLithology* lithology, const GeoPhysics::FluidType* fluid,
@@ -253,20 +259,29 @@ void DerivedProperties::ThermalDiffusivityFormationCalculator::calculateForBasem
 
 }
 
-double DerivedProperties::ThermalDiffusivityFormationCalculator::calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                                                                      const GeoPhysics::CompoundLithology* lithology,
-                                                                                      const std::map<std::string, double>& dependentProperties ) const
+void DerivedProperties::ThermalDiffusivityFormationCalculator::calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                                                                     const GeoPhysics::CompoundLithology* const* lithologies,
+                                                                                     const unsigned int                          numberOfPositions,
+                                                                                     const double*                               dependentValues,
+                                                                                           double*                               values ) const
 {
   const GeoPhysics::FluidType* fluid = dynamic_cast<const GeoPhysics::FluidType*>( formation->getFluidType ());
   if ( !fluid )
   {
-    return DataAccess::Interface::DefaultUndefinedScalarValue;
+    std::fill( values, values + numberOfPositions, DataAccess::Interface::DefaultUndefinedScalarValue );
+    return;
+  }
+
+  const size_t numberOfDependentValues = getDependentPropertyNames ().size ();
+
+  for ( unsigned int p = 0; p < numberOfPositions; ++p, dependentValues += numberOfDependentValues )
+  {
+    values[p] = DerivedProperties::ThermalDiffusivityFormationCalculator::calculateThermalDiffusivity(lithologies[p], fluid,
+                                                                                                     dependentValues[m_porosityIndex],
+                                                                                                     dependentValues[m_pressureIndex],
+                                                                                                     dependentValues[m_temperatureIndex],
+                                                                                                     DataAccess::Interface::DefaultUndefinedMapValue);
   }
-  return DerivedProperties::ThermalDiffusivityFormationCalculator::calculateThermalDiffusivity(lithology, fluid,
-                                                                                               dependentProperties.at("Porosity"),
-                                                                                               dependentProperties.at("Pressure"),
-                                                                                               dependentProperties.at("Temperature"),
-                                                                                               DataAccess::Interface::DefaultUndefinedMapValue);
 }
 
 bool DerivedProperties::ThermalDiffusivityFormationCalculator::isComputable ( const AbstractPropertyManager&      propManager,
@@ -62,15 +62,22 @@ namespace DerivedProperties {
                                   const DataModel::AbstractFormation*                 formation,
                                   AbstractDerivedProperties::FormationPropertyList&   derivedProperties ) const;
 
-      virtual double calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                          const GeoPhysics::CompoundLithology* lithology,
-                                          const std::map<std::string, double>& dependentProperties ) const override;
+      virtual void calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                         const GeoPhysics::CompoundLithology* const* lithologies,
+                                         const unsigned int                          numberOfPositions,
+                                         const double*                               dependentValues,
+                                               double*                               values ) const override;
    private :
       double calculateThermalDiffusivity(const GeoPhysics::CompoundLithology* lithology, const GeoPhysics::FluidType* fluid,
                                          const double porosity, const double porePressure, const double temperature, const double undefinedValue) const;
 
       const GeoPhysics::ProjectHandle& m_projectHandle;
 
+
+      /// \brief The positions of the dependent properties used by calculateAtPositions, -1 if not a dependency.
+      int m_porosityIndex;
+      int m_pressureIndex;
+      int m_temperatureIndex;
    };
 
 
@@ -36,6 +36,13 @@ DerivedProperties::VelocityFormationCalculator::VelocityFormationCalculator () {
    addDependentPropertyName ( "Temperature" );
    addDependentPropertyName ( "Ves" );
    addDependentPropertyName ( "MaxVes" );
+
+   m_porosityIndex = getDependentPropertyIndex ( "Porosity" );
+   m_bulkDensityIndex = getDependentPropertyIndex ( "BulkDensity" );
+   m_pressureIndex = getDependentPropertyIndex ( "Pressure" );
+   m_temperatureIndex = getDependentPropertyIndex ( "Temperature" );
+   m_vesIndex = getDependentPropertyIndex ( "Ves" );
+   m_maxVesIndex = getDependentPropertyIndex ( "MaxVes" );
 }
 
 double DerivedProperties::VelocityFormationCalculator::calculateVelocity(const GeoPhysics::FluidType* const geophysicsFluid, const GeoPhysics::CompoundLithology* lithology,
@@ -246,17 +253,23 @@ bool DerivedProperties::VelocityFormationCalculator::isComputable ( const Abstra
    return propertyIsComputable;
 }
 
-double DerivedProperties::VelocityFormationCalculator::calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                                                            const GeoPhysics::CompoundLithology* lithology,
-                                                                            const std::map<string, double>& dependentProperties ) const
+void DerivedProperties::VelocityFormationCalculator::calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                                                           const GeoPhysics::CompoundLithology* const* lithologies,
+                                                                           const unsigned int                          numberOfPositions,
+                                                                           const double*                               dependentValues,
+                                                                                 double*                               values ) const
 {
   const GeoPhysics::FluidType* fluid = dynamic_cast<const GeoPhysics::FluidType*>(formation->getFluidType ());
-
-  return DerivedProperties::VelocityFormationCalculator::calculateVelocity(fluid, lithology,
-                                                                           dependentProperties.at("Temperature"),
-                                                                           dependentProperties.at("Pressure"),
-                                                                           dependentProperties.at("BulkDensity"),
-                                                                           dependentProperties.at("Porosity"),
-                                                                           dependentProperties.at("Ves"),
-                                                                           dependentProperties.at("MaxVes"));
+  const size_t numberOfDependentValues = getDependentPropertyNames ().size ();
+
+  for ( unsigned int p = 0; p < numberOfPositions; ++p, dependentValues += numberOfDependentValues )
+  {
+    values[p] = DerivedProperties::VelocityFormationCalculator::calculateVelocity(fluid, lithologies[p],
+                                                                                  dependentValues[m_temperatureIndex],
+                                                                                  dependentValues[m_pressureIndex],
+                                                                                  dependentValues[m_bulkDensityIndex],
+                                                                                  dependentValues[m_porosityIndex],
+                                                                                  dependentValues[m_vesIndex],
+                                                                                  dependentValues[m_maxVesIndex]);
+  }
 }
@@ -51,14 +51,24 @@ namespace DerivedProperties {
                                   const DataModel::AbstractSnapshot*                        snapshot,
                                   const DataModel::AbstractFormation*                       formation ) const;
 
-      virtual double calculateAtPosition( const GeoPhysics::GeoPhysicsFormation* formation,
-                                          const GeoPhysics::CompoundLithology* lithology,
-                                          const std::map<std::string, double>& dependentProperties ) const override;
+      virtual void calculateAtPositions( const GeoPhysics::GeoPhysicsFormation*      formation,
+                                         const GeoPhysics::CompoundLithology* const* lithologies,
+                                         const unsigned int                          numberOfPositions,
+                                         const double*                               dependentValues,
+                                               double*                               values ) const override;
 
    private:
       double calculateVelocity( const GeoPhysics::FluidType * const geophysicsFluid, const GeoPhysics::CompoundLithology *lithology,
                                 const double temperature, const double pressure, const double bulkDensity, const double porosity,
                                 const double ves, const double maxVes) const;
+
+      /// \brief The positions of the dependent properties used by calculateAtPositions, -1 if not a dependency.
+      int m_porosityIndex;
+      int m_bulkDensityIndex;
+      int m_pressureIndex;
+      int m_temperatureIndex;
+      int m_vesIndex;
+      int m_maxVesIndex;
    };
 
 
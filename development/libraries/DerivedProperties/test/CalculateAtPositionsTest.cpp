@@ -0,0 +1,166 @@
+//
+// Copyright (C) 2015-2019 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#include "../src/BrineDensityCalculator.h"
+#include "../src/BrineViscosityCalculator.h"
+#include "../src/BulkDensityFormationCalculator.h"
+#include "../src/GammaRayFormationCalculator.h"
+#include "../src/LithostaticPressureFormationCalculator.h"
+#include "../src/PermeabilityFormationCalculator.h"
+#include "../src/PorosityFormationCalculator.h"
+#include "../src/SonicFormationCalculator.h"
+#include "../src/ThermalConductivityFormationCalculator.h"
+#include "../src/ThermalDiffusivityFormationCalculator.h"
+#include "../src/VelocityFormationCalculator.h"
+
+#include "TestProject.h"
+
+// GeoPhysics
+#include "CompoundLithologyComposition.h"
+#include "GeoPhysicsFormation.h"
+#include "GeoPhysicsObjectFactory.h"
+#include "GeoPhysicsProjectHandle.h"
+#include "LithologyManager.h"
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace AbstractDerivedProperties;
+
+namespace
+{
+   /// The plausible range of the dependent properties of the calculators.
+   const std::map<std::string, std::pair<double, double>> DependentPropertyRanges = {
+      { "Temperature",            { 10.0,   250.0 }},
+      { "Pressure",               {  0.1,   120.0 }},
+      { "LithoStaticPressure",    { 10.0,   200.0 }},
+      { "Ves",                    {  0.0,    60.0 }},
+      { "MaxVes",                 { 60.0,    80.0 }},
+      { "Porosity",               {  2.0,    60.0 }},
+      { "BulkDensity",            { 1800.0, 2800.0 }},
+      { "Velocity",               { 1500.0, 6000.0 }},
+      { "Depth",                  { 10.0,  8000.0 }},
+      { "ChemicalCompaction",     {  0.0,     0.1 }},
+      { "ALCStepTopBasaltDepth",  { 10.0,  8000.0 }},
+      { "ALCStepBasaltThickness", {  0.0,  1000.0 }}};
+
+   class CalculateAtPositionsTest : public ::testing::Test
+   {
+   protected :
+
+      /// Open the project, as if its last fastcauldron run was in the simulator mode if one is given.
+      void openProject( const std::string& simulatorMode )
+      {
+         m_projectHandle.reset( DerivedProperties::openTestProject( m_factory, simulatorMode ));
+         ASSERT_NE( m_projectHandle, nullptr );
+      }
+
+      /// Check that the values calculated together at a number of positions are those calculated one position at a time.
+      void compare( const FormationPropertyCalculator& calculator )
+      {
+         const GeoPhysics::CompoundLithologyComposition compositions[3] = {
+            { "Mudstone, 50% clay", "",      "",       100.0,  0.0,  0.0, "Homogeneous", -9999.0 },
+            { "Mudstone, 50% clay", "Crust", "",        60.0, 40.0,  0.0, "Homogeneous", -9999.0 },
+            { "Mudstone, 50% clay", "Crust", "Mantle",  30.0, 30.0, 40.0, "Homogeneous", -9999.0 }};
+
+         const GeoPhysics::CompoundLithology* lithologies[3];
+         for ( int l = 0; l < 3; ++l )
+         {
+            lithologies[l] = m_projectHandle->getLithologyManager().getCompoundLithology( compositions[l] );
+            ASSERT_NE( lithologies[l], nullptr );
+         }
+
+         const std::vector<std::string>& names = calculator.getDependentPropertyNames();
+         const unsigned int numberOfPositions = 11;
+         std::mt19937 generator( 19 );
+
+         std::vector<const GeoPhysics::CompoundLithology*> positionLithologies;
+         std::vector<double> dependentValues;
+         std::vector<std::map<std::string, double>> dependentProperties( numberOfPositions );
+         for ( unsigned int p = 0; p < numberOfPositions; ++p )
+         {
+            positionLithologies.push_back( lithologies[p % 3] );
+
+            for ( const std::string& name : names )
+            {
+               const std::pair<double, double>& range = DependentPropertyRanges.at( name );
+               const double value = std::uniform_real_distribution<double>( range.first, range.second )( generator );
+
+               dependentValues.push_back( value );
+               dependentProperties[p][name] = value;
+            }
+         }
+
+         std::unique_ptr<DataAccess::Interface::FormationList> formations( m_projectHandle->getFormations( nullptr, true ));
+         for ( const DataAccess::Interface::Formation* interfaceFormation : *formations )
+         {
+            const GeoPhysics::GeoPhysicsFormation* formation = dynamic_cast<const GeoPhysics::GeoPhysicsFormation*>( interfaceFormation );
+            ASSERT_NE( formation, nullptr );
+
+            std::vector<double> values( numberOfPositions, 0.0 );
+            calculator.calculateAtPositions( formation, positionLithologies.data(), numberOfPositions, dependentValues.data(), values.data() );
+
+            for ( unsigned int p = 0; p < numberOfPositions; ++p )
+            {
+               EXPECT_EQ( values[p], calculator.calculateAtPosition( formation, positionLithologies[p], dependentProperties[p] ))
+                  << formation->getName() << ", position " << p;
+            }
+         }
+      }
+
+      /// Compare all calculators used at positions.
+      void compareAll()
+      {
+         compare( DerivedProperties::BrineDensityCalculator( *m_projectHandle ));
+         compare( DerivedProperties::BrineViscosityCalculator( *m_projectHandle ));
+         compare( DerivedProperties::BulkDensityFormationCalculator( *m_projectHandle ));
+         compare( DerivedProperties::GammaRayFormationCalculator());
+         compare( DerivedProperties::LithostaticPressureFormationCalculator( *m_projectHandle ));
+         compare( DerivedProperties::PermeabilityFormationCalculator( *m_projectHandle ));
+         compare( DerivedProperties::PorosityFormationCalculator( *m_projectHandle ));
+         compare( DerivedProperties::SonicFormationCalculator());
+         compare( DerivedProperties::ThermalConductivityFormationCalculator( *m_projectHandle ));
+         compare( DerivedProperties::ThermalDiffusivityFormationCalculator( *m_projectHandle ));
+         compare( DerivedProperties::VelocityFormationCalculator());
+      }
+
+      GeoPhysics::ObjectFactory m_factory;
+      std::unique_ptr<GeoPhysics::ProjectHandle> m_projectHandle;
+   };
+}
+
+TEST_F( CalculateAtPositionsTest, WithoutSimulation )
+{
+   openProject( "" );
+   compareAll();
+}
+
+TEST_F( CalculateAtPositionsTest, HydrostaticDecompaction )
+{
+   openProject( "HydrostaticDecompaction" );
+   compareAll();
+}
+
+TEST_F( CalculateAtPositionsTest, HydrostaticTemperature )
+{
+   openProject( "HydrostaticTemperature" );
+   compareAll();
+}
+
+TEST_F( CalculateAtPositionsTest, CoupledPressureAndTemperature )
+{
+   openProject( "CoupledPressureAndTemperature" );
+   compareAll();
+}
@@ -0,0 +1,281 @@
+//
+// Copyright (C) 2015-2019 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#include "../src/AbstractPropertyManager.h"
+#include "../src/DerivedFormationProperty.h"
+#include "../src/FormationPropertyCalculator.h"
+#include "../src/HydrostaticPressureFormationCalculator.h"
+
+#include "MockProperty.h"
+#include "TestProject.h"
+
+// GeoPhysics
+#include "GeoPhysicsFormation.h"
+#include "GeoPhysicsObjectFactory.h"
+#include "GeoPhysicsProjectHandle.h"
+
+// DataAccess
+#include "Interface.h"
+#include "Snapshot.h"
+#include "Surface.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace AbstractDerivedProperties;
+
+namespace
+{
+   /// The depth, temperature and pore pressure of a formation, deeper for each formation down the column.
+   class ColumnCalculator : public FormationPropertyCalculator
+   {
+   public :
+
+      explicit ColumnCalculator( const DataAccess::Interface::FormationList& formations ) : m_formations( formations )
+      {
+         addPropertyName( "Depth" );
+         addPropertyName( "Temperature" );
+         addPropertyName( "Pressure" );
+      }
+
+      void calculate( AbstractPropertyManager&            propertyManager,
+                      const DataModel::AbstractSnapshot*  snapshot,
+                      const DataModel::AbstractFormation* formation,
+                      FormationPropertyList&              derivedProperties ) const final
+      {
+         const GeoPhysics::GeoPhysicsFormation* geoPhysicsFormation = dynamic_cast<const GeoPhysics::GeoPhysicsFormation*>( formation );
+         const unsigned int numberOfNodes = geoPhysicsFormation->getMaximumNumberOfElements() + 1;
+         const double topDepth = 1000.0 * double( std::find( m_formations.begin(), m_formations.end(), formation ) - m_formations.begin() );
+
+         DerivedProperties::DerivedFormationPropertyPtr depth( new DerivedProperties::DerivedFormationProperty(
+            propertyManager.getProperty( "Depth" ), snapshot, formation, propertyManager.getMapGrid(), numberOfNodes ));
+         DerivedProperties::DerivedFormationPropertyPtr temperature( new DerivedProperties::DerivedFormationProperty(
+            propertyManager.getProperty( "Temperature" ), snapshot, formation, propertyManager.getMapGrid(), numberOfNodes ));
+         DerivedProperties::DerivedFormationPropertyPtr pressure( new DerivedProperties::DerivedFormationProperty(
+            propertyManager.getProperty( "Pressure" ), snapshot, formation, propertyManager.getMapGrid(), numberOfNodes ));
+
+         for ( unsigned int i = depth->firstI( true ); i <= depth->lastI( true ); ++i )
+         {
+            for ( unsigned int j = depth->firstJ( true ); j <= depth->lastJ( true ); ++j )
+            {
+               for ( unsigned int k = depth->firstK(); k <= depth->lastK(); ++k )
+               {
+                  const double z = topDepth + ( depth->lastK() - k ) * ( 40.0 + 3.0 * i + 2.0 * j );
+                  depth->set( i, j, k, z );
+                  temperature->set( i, j, k, 10.0 + 0.03 * z );
+                  pressure->set( i, j, k, 0.1 + 0.0105 * z );
+               }
+            }
+         }
+
+         derivedProperties.push_back( depth );
+         derivedProperties.push_back( temperature );
+         derivedProperties.push_back( pressure );
+      }
+
+   private :
+
+      const DataAccess::Interface::FormationList& m_formations;
+   };
+
+   /// The recursion used before the column was integrated in a single pass: the hydrostatic pressure of the formation
+   /// above is requested first, such that the calculator integrates only the formation itself.
+   class RecursiveHydrostaticPressureCalculator : public DerivedProperties::HydrostaticPressureFormationCalculator
+   {
+   public :
+
+      explicit RecursiveHydrostaticPressureCalculator( const GeoPhysics::ProjectHandle& projectHandle ) :
+         DerivedProperties::HydrostaticPressureFormationCalculator( projectHandle )
+      {
+      }
+
+      void calculate( AbstractPropertyManager&            propertyManager,
+                      const DataModel::AbstractSnapshot*  snapshot,
+                      const DataModel::AbstractFormation* formation,
+                      FormationPropertyList&              derivedProperties ) const final
+      {
+         const DataAccess::Interface::Formation* currentFormation = dynamic_cast<const DataAccess::Interface::Formation*>( formation );
+
+         if ( currentFormation->getTopSurface()->getSnapshot() == 0 ||
+              currentFormation->getTopSurface()->getSnapshot()->getTime() > snapshot->getTime() )
+         {
+            const DataAccess::Interface::Formation* formationAbove = currentFormation->getTopSurface()->getTopFormation();
+
+            if ( formationAbove != 0 )
+            {
+               propertyManager.getFormationProperty( propertyManager.getProperty( getPropertyNames()[0] ), snapshot, formationAbove );
+            }
+         }
+
+         DerivedProperties::HydrostaticPressureFormationCalculator::calculate( propertyManager, snapshot, formation, derivedProperties );
+         EXPECT_LE( derivedProperties.size(), 1u ) << formation->getName();
+      }
+   };
+
+   /// Calculates the hydrostatic pressure, either for the column at once or recursively formation by formation.
+   class ColumnPropertyManager : public AbstractPropertyManager
+   {
+   public :
+
+      ColumnPropertyManager( const GeoPhysics::ProjectHandle& projectHandle, const DataAccess::Interface::FormationList& formations, const bool recursive ) :
+         m_projectHandle( projectHandle ),
+         m_depth( "Depth", DataModel::CONTINUOUS_3D_PROPERTY ),
+         m_temperature( "Temperature", DataModel::CONTINUOUS_3D_PROPERTY ),
+         m_pressure( "Pressure", DataModel::CONTINUOUS_3D_PROPERTY ),
+         m_hydrostaticPressure( "HydroStaticPressure", DataModel::CONTINUOUS_3D_PROPERTY )
+      {
+         addFormationPropertyCalculator( FormationPropertyCalculatorPtr( new ColumnCalculator( formations )));
+
+         if ( recursive )
+         {
+            addFormationPropertyCalculator( FormationPropertyCalculatorPtr( new RecursiveHydrostaticPressureCalculator( projectHandle )));
+         }
+         else
+         {
+            addFormationPropertyCalculator( FormationPropertyCalculatorPtr( new DerivedProperties::HydrostaticPressureFormationCalculator( projectHandle )));
+         }
+      }
+
+      const DataModel::AbstractProperty* getProperty( const std::string& name ) const final
+      {
+         for ( const DataModel::AbstractProperty* property : { &m_depth, &m_temperature, &m_pressure, &m_hydrostaticPressure } )
+         {
+            if ( property->getName() == name ) return property;
+         }
+
+         return nullptr;
+      }
+
+      const DataModel::AbstractGrid* getMapGrid() const final
+      {
+         return m_projectHandle.getActivityOutputGrid();
+      }
+
+      bool getNodeIsValid( const unsigned int i, const unsigned int j ) const final
+      {
+         return m_projectHandle.getNodeIsValid( i, j );
+      }
+
+   private :
+
+      const GeoPhysics::ProjectHandle& m_projectHandle;
+      const DataModel::MockProperty    m_depth;
+      const DataModel::MockProperty    m_temperature;
+      const DataModel::MockProperty    m_pressure;
+      const DataModel::MockProperty    m_hydrostaticPressure;
+   };
+
+   class HydrostaticPressureColumnTest : public ::testing::Test
+   {
+   protected :
+
+      /// Open the project as if its last fastcauldron run was in the simulator mode, and initialise the column.
+      void openProject( const std::string& simulatorMode )
+      {
+         m_projectHandle.reset( DerivedProperties::openTestProject( m_factory, simulatorMode, "Column" ));
+         ASSERT_NE( m_projectHandle, nullptr );
+         ASSERT_TRUE( DerivedProperties::initialiseTestProject( *m_projectHandle, "HydrostaticPressureColumnTest" ));
+
+         m_snapshot = m_projectHandle->findSnapshot( 0.0 );
+         ASSERT_NE( m_snapshot, nullptr );
+
+         m_formations.reset( m_projectHandle->getFormations( m_snapshot, true ));
+         ASSERT_GE( m_formations->size(), 4u );
+      }
+
+      /// Compare the hydrostatic pressure of the column with that of the recursion, after calculating that of the first formations.
+      void compare( const unsigned int numberCalculatedBefore )
+      {
+         ColumnPropertyManager recursive( *m_projectHandle, *m_formations, true );
+         ColumnPropertyManager column( *m_projectHandle, *m_formations, false );
+         const DataModel::AbstractProperty* property = column.getProperty( "HydroStaticPressure" );
+
+         // The deepest sediment is requested after the formations above it, if any
+         unsigned int bottom = 0;
+         for ( unsigned int f = 0; f < m_formations->size(); ++f )
+         {
+            if ( ( *m_formations )[f]->kind() == DataAccess::Interface::SEDIMENT_FORMATION ) bottom = f;
+         }
+         ASSERT_GE( bottom, 2u );
+         ASSERT_LT( numberCalculatedBefore, bottom );
+
+         for ( unsigned int f = 0; f < numberCalculatedBefore; ++f )
+         {
+            ASSERT_NE( column.getFormationProperty( property, m_snapshot, ( *m_formations )[f] ), nullptr );
+         }
+
+         ASSERT_NE( column.getFormationProperty( property, m_snapshot, ( *m_formations )[bottom] ), nullptr );
+
+         for ( unsigned int f = 0; f <= bottom; ++f )
+         {
+            EXPECT_TRUE( column.formationPropertyIsCalculated( property, m_snapshot, ( *m_formations )[f] )) << ( *m_formations )[f]->getName();
+         }
+
+         for ( const DataAccess::Interface::Formation* formation : *m_formations )
+         {
+            const FormationPropertyPtr expected = recursive.getFormationProperty( recursive.getProperty( "HydroStaticPressure" ), m_snapshot, formation );
+            const FormationPropertyPtr actual = column.getFormationProperty( property, m_snapshot, formation );
+            ASSERT_NE( expected, nullptr ) << formation->getName();
+            ASSERT_NE( actual, nullptr ) << formation->getName();
+            ASSERT_EQ( expected->lastK(), actual->lastK() ) << formation->getName();
+
+            for ( unsigned int i = actual->firstI( true ); i <= actual->lastI( true ); ++i )
+            {
+               for ( unsigned int j = actual->firstJ( true ); j <= actual->lastJ( true ); ++j )
+               {
+                  for ( unsigned int k = actual->firstK(); k <= actual->lastK(); ++k )
+                  {
+                     EXPECT_EQ( expected->get( i, j, k ), actual->get( i, j, k ))
+                        << formation->getName() << " at (" << i << ", " << j << ", " << k << ")";
+
+                     if ( k < actual->lastK() and formation->kind() == DataAccess::Interface::SEDIMENT_FORMATION and m_projectHandle->getNodeIsValid( i, j ))
+                     {
+                        EXPECT_GT( actual->get( i, j, k ), actual->get( i, j, k + 1 )) << formation->getName();
+                     }
+                  }
+               }
+            }
+         }
+      }
+
+      GeoPhysics::ObjectFactory m_factory;
+      std::unique_ptr<GeoPhysics::ProjectHandle> m_projectHandle;
+      const DataAccess::Interface::Snapshot* m_snapshot = nullptr;
+      std::unique_ptr<DataAccess::Interface::FormationList> m_formations;
+   };
+}
+
+TEST_F( HydrostaticPressureColumnTest, DecompactionWholeColumn )
+{
+   openProject( "HydrostaticDecompaction" );
+   compare( 0 );
+}
+
+TEST_F( HydrostaticPressureColumnTest, DecompactionPartiallyCalculated )
+{
+   openProject( "HydrostaticDecompaction" );
+   compare( 1 );
+}
+
+TEST_F( HydrostaticPressureColumnTest, CoupledWholeColumn )
+{
+   openProject( "CoupledPressureAndTemperature" );
+   compare( 0 );
+}
+
+TEST_F( HydrostaticPressureColumnTest, CoupledPartiallyCalculated )
+{
+   openProject( "CoupledPressureAndTemperature" );
+   compare( 1 );
+}
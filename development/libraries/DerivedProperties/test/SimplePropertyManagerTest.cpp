@@ -132,6 +132,40 @@ public :
 };
 
 
+/// \brief Calculates a formation property from Property1 of the same formation.
+class DependentFormationPropertyCalculator : public FormationPropertyCalculator {
+
+public :
+
+   DependentFormationPropertyCalculator ( const std::string& propertyName );
+
+   void calculate ( AbstractPropertyManager& propertyManager,
+                    const DataModel::AbstractSnapshot*          snapshot,
+                    const DataModel::AbstractFormation*         formation,
+                          FormationPropertyList&                derivedProperties ) const;
+
+private :
+
+   const std::string m_propertyName;
+
+};
+
+
+/// \brief Calculates several formation properties together, like the hydrostatic pressure of a column of formations.
+class MultipleFormationPropertyCalculator : public FormationPropertyCalculator {
+
+public :
+
+   MultipleFormationPropertyCalculator ();
+
+   void calculate ( AbstractPropertyManager& propertyManager,
+                    const DataModel::AbstractSnapshot*          snapshot,
+                    const DataModel::AbstractFormation*         formation,
+                          FormationPropertyList&                derivedProperties ) const;
+
+};
+
+
 class FormationMapProperty1Calculator : public FormationMapPropertyCalculator {
 
 public :
@@ -302,11 +336,244 @@ TEST ( AbstractPropertyManagerTest,  Test4 )
 }
 
 
+// Tests whether formation property values that are not used again are removed when the memory limit is exceeded.
+TEST ( AbstractPropertyManagerTest,  MemoryLimit )
+{
+   TestPropertyManager propertyManager;
+
+   const DataModel::AbstractProperty* property = propertyManager.getProperty ( "Property1" );
+
+   const DataModel::AbstractSnapshot*  snapshot   = new MockSnapshot ( 0.0 );
+   const DataModel::AbstractFormation* formation1 = new MockFormation ( "Formation1" );
+   const DataModel::AbstractFormation* formation2 = new MockFormation ( "Formation2" );
+   const DataModel::AbstractFormation* formation3 = new MockFormation ( "Formation3" );
+
+   FormationPropertyPtr formationProperty1 = propertyManager.getFormationProperty ( property, snapshot, formation1 );
+   EXPECT_EQ ( formationProperty1, propertyManager.getFormationProperty ( property, snapshot, formation1 ));
+
+   const size_t numberOfBytes = propertyManager.getCacheStatistics ().memoryInUse;
+   EXPECT_EQ ( numberOfBytes, 11 * 11 * 10 * sizeof ( double ));
+   EXPECT_EQ ( 1u, propertyManager.getCacheStatistics ().hits );
+   EXPECT_EQ ( 1u, propertyManager.getCacheStatistics ().misses );
+   EXPECT_EQ ( 1u, propertyManager.getCacheStatistics ().calculations );
+
+   // Only two sets of values fit, so when the third is calculated the values of the second formation are removed:
+   // those of the first formation have been used again, and those of the third have just been requested.
+   propertyManager.setMemoryLimit ( 2 * numberOfBytes );
+   FormationPropertyPtr formationProperty2 = propertyManager.getFormationProperty ( property, snapshot, formation2 );
+   propertyManager.getFormationProperty ( property, snapshot, formation3 );
+
+   EXPECT_EQ ( 1u, propertyManager.getCacheStatistics ().evictions );
+   EXPECT_EQ ( 2 * numberOfBytes, propertyManager.getCacheStatistics ().memoryInUse );
+   EXPECT_TRUE ( propertyManager.formationPropertyIsCalculated ( property, snapshot, formation1 ));
+   EXPECT_FALSE ( propertyManager.formationPropertyIsCalculated ( property, snapshot, formation2 ));
+   EXPECT_EQ ( formationProperty1, propertyManager.getFormationProperty ( property, snapshot, formation1 ));
+
+   // The values of the second formation are calculated again, replacing those of the third formation that were not used again.
+   FormationPropertyPtr recalculatedProperty2 = propertyManager.getFormationProperty ( property, snapshot, formation2 );
+
+   EXPECT_NE ( formationProperty2, recalculatedProperty2 );
+   EXPECT_EQ ( 1u, propertyManager.getCacheStatistics ().recalculations );
+   EXPECT_EQ ( 2u, propertyManager.getCacheStatistics ().evictions );
+   EXPECT_EQ ( 4u, propertyManager.getCacheStatistics ().calculations );
+   EXPECT_FALSE ( propertyManager.formationPropertyIsCalculated ( property, snapshot, formation3 ));
+   EXPECT_EQ ( formationProperty1, propertyManager.getFormationProperty ( property, snapshot, formation1 ));
+
+   PropertyRetriever propRet1 ( formationProperty2 );
+   PropertyRetriever propRet2 ( recalculatedProperty2 );
+
+   for ( unsigned int k = formationProperty2->firstK (); k <= formationProperty2->lastK (); ++ k ) {
+
+      for ( unsigned int i = formationProperty2->firstI ( true ); i <= formationProperty2->lastI ( true ); ++i ) {
+
+         for ( unsigned int j = formationProperty2->firstJ ( true ); j <= formationProperty2->lastJ ( true ); ++j ) {
+            EXPECT_DOUBLE_EQ ( formationProperty2->get ( i, j, k ), recalculatedProperty2->get ( i, j, k ));
+         }
+      }
+   }
+
+   propertyManager.removeProperties ( snapshot );
+   EXPECT_EQ ( 0u, propertyManager.getCacheStatistics ().memoryInUse );
+
+   delete snapshot;
+   delete formation1;
+   delete formation2;
+   delete formation3;
+}
+
+// Tests whether larger values are removed before smaller values that were used as recently.
+TEST ( AbstractPropertyManagerTest,  MemoryLimitBySize )
+{
+   TestPropertyManager propertyManager;
+
+   const DataModel::AbstractProperty* property = propertyManager.getProperty ( "Property1" );
+
+   const DataModel::AbstractSnapshot*  snapshot  = new MockSnapshot ( 0.0 );
+   const DataModel::AbstractFormation* formation = new MockFormation ( "Formation1" );
+   const DataModel::AbstractSurface*   surface1  = new MockSurface ( "Surface1" );
+   const DataModel::AbstractSurface*   surface2  = new MockSurface ( "Surface2" );
+   const DataModel::AbstractSurface*   surface3  = new MockSurface ( "Surface3" );
+
+   const size_t surfaceBytes   = 11 * 11 * sizeof ( double );
+   const size_t formationBytes = 10 * surfaceBytes;
+
+   // The formation values fit with two surfaces, not with three.
+   propertyManager.setMemoryLimit ( formationBytes + 2 * surfaceBytes );
+   propertyManager.getSurfaceProperty ( property, snapshot, surface1 );
+   propertyManager.getSurfaceProperty ( property, snapshot, surface2 );
+   propertyManager.getFormationProperty ( property, snapshot, formation );
+   EXPECT_EQ ( formationBytes + 2 * surfaceBytes, propertyManager.getCacheStatistics ().memoryInUse );
+
+   // The formation values are removed, although the first surface was used less recently.
+   propertyManager.getSurfaceProperty ( property, snapshot, surface3 );
+
+   EXPECT_EQ ( 1u, propertyManager.getCacheStatistics ().evictions );
+   EXPECT_EQ ( 3 * surfaceBytes, propertyManager.getCacheStatistics ().memoryInUse );
+   EXPECT_FALSE ( propertyManager.formationPropertyIsCalculated ( property, snapshot, formation ));
+
+   propertyManager.getSurfaceProperty ( property, snapshot, surface1 );
+   EXPECT_EQ ( 4u, propertyManager.getCacheStatistics ().calculations );
+
+   delete snapshot;
+   delete formation;
+   delete surface1;
+   delete surface2;
+   delete surface3;
+}
+
+// Tests whether values on which other properties depend are kept, rather than calculated again for each of these.
+TEST ( AbstractPropertyManagerTest,  MemoryLimitKeepsDependencies )
+{
+   TestPropertyManager propertyManager;
+
+   const DataModel::AbstractProperty* property  = propertyManager.getProperty ( "Property1" );
+   const DataModel::AbstractProperty* property4 = propertyManager.getProperty ( "Property4" );
+   const DataModel::AbstractProperty* property5 = propertyManager.getProperty ( "Property5" );
+
+   const DataModel::AbstractSnapshot*  snapshot   = new MockSnapshot ( 0.0 );
+   const DataModel::AbstractFormation* formation1 = new MockFormation ( "Formation1" );
+   const DataModel::AbstractFormation* formation2 = new MockFormation ( "Formation2" );
+   const DataModel::AbstractFormation* formation3 = new MockFormation ( "Formation3" );
+
+   const size_t numberOfBytes = 11 * 11 * 10 * sizeof ( double );
+   propertyManager.setMemoryLimit ( 3 * numberOfBytes );
+
+   // Property1 of the first formation is calculated as a dependency of Property4.
+   propertyManager.getFormationProperty ( property4, snapshot, formation1 );
+   EXPECT_EQ ( 2u, propertyManager.getCacheStatistics ().calculations );
+
+   // Other values, requested once, are removed before the dependency that was used least recently.
+   propertyManager.getFormationProperty ( property, snapshot, formation2 );
+   propertyManager.getFormationProperty ( property, snapshot, formation3 );
+
+   EXPECT_EQ ( 1u, propertyManager.getCacheStatistics ().evictions );
+   EXPECT_TRUE ( propertyManager.formationPropertyIsCalculated ( property, snapshot, formation1 ));
+   EXPECT_FALSE ( propertyManager.formationPropertyIsCalculated ( property, snapshot, formation2 ));
+
+   // Property5 of the first formation depends on the same values, these are not calculated again.
+   FormationPropertyPtr formationProperty5 = propertyManager.getFormationProperty ( property5, snapshot, formation1 );
+
+   EXPECT_EQ ( 0u, propertyManager.getCacheStatistics ().recalculations );
+   EXPECT_EQ ( 5u, propertyManager.getCacheStatistics ().calculations );
+   EXPECT_EQ ( 1u, propertyManager.getCacheStatistics ().hits );
+   EXPECT_TRUE ( propertyManager.formationPropertyIsCalculated ( property, snapshot, formation1 ));
+
+   PropertyRetriever propRet ( formationProperty5 );
+   EXPECT_DOUBLE_EQ ( 1.0, formationProperty5->get ( 0, 0, 0 ));
+
+   delete snapshot;
+   delete formation1;
+   delete formation2;
+   delete formation3;
+}
+
+// Tests whether the values calculated together are all kept, also when these do not fit within the memory limit.
+TEST ( AbstractPropertyManagerTest,  MemoryLimitKeepsValuesCalculatedTogether )
+{
+   TestPropertyManager propertyManager;
+
+   const DataModel::AbstractProperty* property  = propertyManager.getProperty ( "Property1" );
+   const DataModel::AbstractProperty* property6 = propertyManager.getProperty ( "Property6" );
+   const DataModel::AbstractProperty* property7 = propertyManager.getProperty ( "Property7" );
+   const DataModel::AbstractProperty* property8 = propertyManager.getProperty ( "Property8" );
+
+   const DataModel::AbstractSnapshot*  snapshot   = new MockSnapshot ( 0.0 );
+   const DataModel::AbstractFormation* formation1 = new MockFormation ( "Formation1" );
+   const DataModel::AbstractFormation* formation2 = new MockFormation ( "Formation2" );
+
+   const size_t numberOfBytes = 11 * 11 * 10 * sizeof ( double );
+   propertyManager.setMemoryLimit ( 2 * numberOfBytes );
+
+   // Only two of the three properties calculated together fit, all of them are kept.
+   propertyManager.getFormationProperty ( property6, snapshot, formation1 );
+
+   EXPECT_EQ ( 0u, propertyManager.getCacheStatistics ().evictions );
+   EXPECT_EQ ( 3 * numberOfBytes, propertyManager.getCacheStatistics ().memoryInUse );
+   EXPECT_TRUE ( propertyManager.formationPropertyIsCalculated ( property7, snapshot, formation1 ));
+   EXPECT_TRUE ( propertyManager.formationPropertyIsCalculated ( property8, snapshot, formation1 ));
+
+   // The other properties are requested next, these are not calculated again.
+   FormationPropertyPtr formationProperty8 = propertyManager.getFormationProperty ( property8, snapshot, formation1 );
+   propertyManager.getFormationProperty ( property7, snapshot, formation1 );
+
+   EXPECT_EQ ( 1u, propertyManager.getCacheStatistics ().calculations );
+   EXPECT_EQ ( 2u, propertyManager.getCacheStatistics ().hits );
+
+   PropertyRetriever propRet ( formationProperty8 );
+   EXPECT_DOUBLE_EQ ( 8.0, formationProperty8->get ( 0, 0, 0 ));
+
+   // Values calculated afterwards are back within the memory limit.
+   propertyManager.getFormationProperty ( property, snapshot, formation2 );
+
+   EXPECT_EQ ( 2u, propertyManager.getCacheStatistics ().evictions );
+   EXPECT_EQ ( 2 * numberOfBytes, propertyManager.getCacheStatistics ().memoryInUse );
+   EXPECT_TRUE ( propertyManager.formationPropertyIsCalculated ( property, snapshot, formation2 ));
+
+   delete snapshot;
+   delete formation1;
+   delete formation2;
+}
+
+// Tests whether formation property values that are no longer needed are removed from the property-manager.
+TEST ( AbstractPropertyManagerTest, RemoveFormationProperty )
+{
+   TestPropertyManager propertyManager;
+
+   const DataModel::AbstractProperty* property = propertyManager.getProperty ( "Property1" );
+
+   const DataModel::AbstractSnapshot*  snapshot  = new MockSnapshot ( 0.0 );
+   const DataModel::AbstractFormation* formation = new MockFormation ( "Formation1" );
+
+   std::vector<std::string> dependentNames ( 1, "Property2" );
+   propertyManager.getDependentPropertyNames ( property, dependentNames );
+   EXPECT_TRUE ( dependentNames.empty ());
+   EXPECT_FALSE ( propertyManager.formationPropertyDependsOnFormationAbove ( property ));
+
+   FormationPropertyPtr formationProperty = propertyManager.getFormationProperty ( property, snapshot, formation );
+   EXPECT_TRUE ( propertyManager.formationPropertyIsCalculated ( property, snapshot, formation ));
+
+   propertyManager.removeFormationProperty ( property, snapshot, formation );
+   EXPECT_FALSE ( propertyManager.formationPropertyIsCalculated ( property, snapshot, formation ));
+   EXPECT_EQ ( 0u, propertyManager.getCacheStatistics ().memoryInUse );
+
+   // The values are calculated again when requested afterwards.
+   EXPECT_NE ( formationProperty, propertyManager.getFormationProperty ( property, snapshot, formation ));
+   EXPECT_EQ ( 2u, propertyManager.getCacheStatistics ().calculations );
+
+   delete snapshot;
+   delete formation;
+}
+
 TestPropertyManager::TestPropertyManager () {
    // These will come from the project handle.
    m_mockProperties.push_back ( new DataModel::MockProperty ( "Property1", DataModel::CONTINUOUS_3D_PROPERTY ) );
    m_mockProperties.push_back ( new DataModel::MockProperty ( "Property2", DataModel::DISCONTINUOUS_3D_PROPERTY ) );
    m_mockProperties.push_back ( new DataModel::MockProperty ( "Property3", DataModel::FORMATION_2D_PROPERTY ) );
+   m_mockProperties.push_back ( new DataModel::MockProperty ( "Property4", DataModel::CONTINUOUS_3D_PROPERTY ) );
+   m_mockProperties.push_back ( new DataModel::MockProperty ( "Property5", DataModel::CONTINUOUS_3D_PROPERTY ) );
+   m_mockProperties.push_back ( new DataModel::MockProperty ( "Property6", DataModel::CONTINUOUS_3D_PROPERTY ) );
+   m_mockProperties.push_back ( new DataModel::MockProperty ( "Property7", DataModel::CONTINUOUS_3D_PROPERTY ) );
+   m_mockProperties.push_back ( new DataModel::MockProperty ( "Property8", DataModel::CONTINUOUS_3D_PROPERTY ) );
 
    // Add all properties to the property manager.
    for ( size_t i = 0; i < m_mockProperties.size (); ++i ) {
@@ -320,6 +587,9 @@ TestPropertyManager::TestPropertyManager () {
    addFormationMapPropertyCalculator ( FormationMapPropertyCalculatorPtr ( new FormationMapProperty1Calculator ));
    addFormationPropertyCalculator ( FormationPropertyCalculatorPtr ( new FormationProperty1Calculator ));
    addFormationSurfacePropertyCalculator ( FormationSurfacePropertyCalculatorPtr ( new FormationSurfaceProperty1Calculator ));
+   addFormationPropertyCalculator ( FormationPropertyCalculatorPtr ( new DependentFormationPropertyCalculator ( "Property4" )));
+   addFormationPropertyCalculator ( FormationPropertyCalculatorPtr ( new DependentFormationPropertyCalculator ( "Property5" )));
+   addFormationPropertyCalculator ( FormationPropertyCalculatorPtr ( new MultipleFormationPropertyCalculator ));
 }
 
 
@@ -455,6 +725,74 @@ void FormationProperty1Calculator::calculate ( AbstractPropertyManager& property
 }
 
 
+DependentFormationPropertyCalculator::DependentFormationPropertyCalculator ( const std::string& propertyName ) :
+   m_propertyName ( propertyName )
+{
+   addPropertyName ( propertyName );
+   addDependentPropertyName ( "Property1" );
+}
+
+void DependentFormationPropertyCalculator::calculate ( AbstractPropertyManager&            propertyManager,
+                                                       const DataModel::AbstractSnapshot*  snapshot,
+                                                       const DataModel::AbstractFormation* formation,
+                                                       FormationPropertyList&              derivedProperties ) const {
+
+   const DataModel::AbstractProperty* property = propertyManager.getProperty ( m_propertyName );
+   const FormationPropertyPtr property1 = propertyManager.getFormationProperty ( propertyManager.getProperty ( "Property1" ), snapshot, formation );
+   PropertyRetriever propRet ( property1 );
+
+   DerivedFormationPropertyPtr derivedProp = DerivedFormationPropertyPtr ( new TestFormationProperty ( property, snapshot, formation, propertyManager.getMapGrid (), 10 ));
+
+   derivedProperties.clear ();
+
+   for ( unsigned int k = derivedProp->firstK (); k <= derivedProp->lastK (); ++ k ) {
+
+      for ( unsigned int i = derivedProp->firstI ( true ); i <= derivedProp->lastI ( true ); ++i ) {
+
+         for ( unsigned int j = derivedProp->firstJ ( true ); j <= derivedProp->lastJ ( true ); ++j ) {
+            derivedProp->set ( i, j, k, property1->get ( i, j, k ) + 1.0 );
+         }
+      }
+   }
+
+   derivedProperties.push_back ( derivedProp );
+}
+
+
+MultipleFormationPropertyCalculator::MultipleFormationPropertyCalculator () {
+   addPropertyName ( "Property6" );
+   addPropertyName ( "Property7" );
+   addPropertyName ( "Property8" );
+}
+
+void MultipleFormationPropertyCalculator::calculate ( AbstractPropertyManager&            propertyManager,
+                                                      const DataModel::AbstractSnapshot*  snapshot,
+                                                      const DataModel::AbstractFormation* formation,
+                                                      FormationPropertyList&              derivedProperties ) const {
+
+   derivedProperties.clear ();
+
+   // The value of each property is the number in its name.
+   for ( size_t p = 0; p < getPropertyNames ().size (); ++p ) {
+      const DataModel::AbstractProperty* property = propertyManager.getProperty ( getPropertyNames ()[ p ]);
+      DerivedFormationPropertyPtr derivedProp = DerivedFormationPropertyPtr ( new TestFormationProperty ( property, snapshot, formation, propertyManager.getMapGrid (), 10 ));
+
+      for ( unsigned int k = derivedProp->firstK (); k <= derivedProp->lastK (); ++ k ) {
+
+         for ( unsigned int i = derivedProp->firstI ( true ); i <= derivedProp->lastI ( true ); ++i ) {
+
+            for ( unsigned int j = derivedProp->firstJ ( true ); j <= derivedProp->lastJ ( true ); ++j ) {
+               derivedProp->set ( i, j, k, static_cast<double>( 6 + p ));
+            }
+         }
+      }
+
+      derivedProperties.push_back ( derivedProp );
+   }
+
+}
+
+
 FormationSurfaceProperty1Calculator::FormationSurfaceProperty1Calculator () {
    addPropertyName ( "Property2" );
 }
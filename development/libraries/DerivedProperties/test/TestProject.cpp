@@ -0,0 +1,62 @@
+//
+// Copyright (C) 2015-2019 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#include "TestProject.h"
+
+// GeoPhysics
+#include "GeoPhysicsObjectFactory.h"
+#include "GeoPhysicsProjectHandle.h"
+
+// DataAccess
+#include "Interface.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace DerivedProperties {
+
+   GeoPhysics::ProjectHandle* openTestProject ( GeoPhysics::ObjectFactory& factory,
+                                                const std::string&         simulatorMode,
+                                                const std::string&         prefix ) {
+
+      std::string projectFileName = "DBMProject.project3d";
+
+      if ( not simulatorMode.empty ()) {
+         std::ifstream input ( projectFileName );
+         std::stringstream contents;
+         contents << input.rdbuf ();
+
+         std::string project = contents.str ();
+         const std::string header = "SimulationSequenceNumber SimulatorName SimulatorMode NumberOfCores SimulatorCommandLineParameters\n  ()   ()   ()   ()   ()\n";
+         const size_t position = project.find ( header );
+
+         if ( position == std::string::npos ) {
+            return nullptr;
+         }
+
+         project.insert ( position + header.size (), "1 \"fastcauldron\" \"" + simulatorMode + "\" 1 \"\"\n" );
+
+         projectFileName = prefix + simulatorMode + ".project3d";
+         std::ofstream output ( projectFileName );
+         output << project;
+      }
+
+      return dynamic_cast<GeoPhysics::ProjectHandle*>( DataAccess::Interface::OpenCauldronProject ( projectFileName, &factory ));
+   }
+
+   bool initialiseTestProject ( GeoPhysics::ProjectHandle& projectHandle,
+                                const std::string&         activityName ) {
+
+      return projectHandle.startActivity ( activityName, projectHandle.getLowResolutionOutputGrid (), false, false, false ) and
+             projectHandle.initialise () and
+             projectHandle.setFormationLithologies ( true, true );
+   }
+
+} // namespace DerivedProperties
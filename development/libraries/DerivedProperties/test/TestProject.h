@@ -0,0 +1,38 @@
+//
+// Copyright (C) 2015-2019 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#ifndef DERIVED_PROPERTIES__TEST_PROJECT_H
+#define DERIVED_PROPERTIES__TEST_PROJECT_H
+
+#include <string>
+
+namespace GeoPhysics {
+   class ObjectFactory;
+   class ProjectHandle;
+}
+
+namespace DerivedProperties {
+
+   /// \brief Open the DBMProject.project3d test project.
+   ///
+   /// If a simulator mode is given the project is opened as if its last fastcauldron run was in that mode,
+   /// from a copy written to <prefix><simulatorMode>.project3d. Tests that run at the same time use different prefixes.
+   /// \return The project handle, null if the project could not be opened.
+   GeoPhysics::ProjectHandle* openTestProject ( GeoPhysics::ObjectFactory& factory,
+                                                const std::string&         simulatorMode = "",
+                                                const std::string&         prefix = "" );
+
+   /// \brief Start the activity on the low resolution output grid and initialise the formations and their lithologies.
+   bool initialiseTestProject ( GeoPhysics::ProjectHandle& projectHandle,
+                                const std::string&         activityName );
+
+} // namespace DerivedProperties
+
+#endif // DERIVED_PROPERTIES__TEST_PROJECT_H
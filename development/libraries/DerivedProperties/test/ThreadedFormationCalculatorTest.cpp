@@ -0,0 +1,188 @@
+//
+// Copyright (C) 2015-2019 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#include "../src/AbstractPropertyManager.h"
+#include "../src/DerivedFormationProperty.h"
+#include "../src/FormationPropertyCalculator.h"
+#include "../src/PermeabilityFormationCalculator.h"
+#include "../src/PorosityFormationCalculator.h"
+
+#include "MockProperty.h"
+#include "TestProject.h"
+
+// GeoPhysics
+#include "GeoPhysicsFormation.h"
+#include "GeoPhysicsObjectFactory.h"
+#include "GeoPhysicsProjectHandle.h"
+
+// DataAccess
+#include "Interface.h"
+#include "Snapshot.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace AbstractDerivedProperties;
+
+namespace
+{
+   /// The ves and maximum ves of a formation, varying over the nodes.
+   class VesCalculator : public FormationPropertyCalculator
+   {
+   public :
+
+      VesCalculator()
+      {
+         addPropertyName( "Ves" );
+         addPropertyName( "MaxVes" );
+      }
+
+      void calculate( AbstractPropertyManager&            propertyManager,
+                      const DataModel::AbstractSnapshot*  snapshot,
+                      const DataModel::AbstractFormation* formation,
+                      FormationPropertyList&              derivedProperties ) const final
+      {
+         const GeoPhysics::GeoPhysicsFormation* geoPhysicsFormation = dynamic_cast<const GeoPhysics::GeoPhysicsFormation*>( formation );
+         const unsigned int numberOfNodes = geoPhysicsFormation->getMaximumNumberOfElements() + 1;
+
+         DerivedProperties::DerivedFormationPropertyPtr ves( new DerivedProperties::DerivedFormationProperty(
+            propertyManager.getProperty( "Ves" ), snapshot, formation, propertyManager.getMapGrid(), numberOfNodes ));
+         DerivedProperties::DerivedFormationPropertyPtr maxVes( new DerivedProperties::DerivedFormationProperty(
+            propertyManager.getProperty( "MaxVes" ), snapshot, formation, propertyManager.getMapGrid(), numberOfNodes ));
+
+         for ( unsigned int i = ves->firstI( true ); i <= ves->lastI( true ); ++i )
+         {
+            for ( unsigned int j = ves->firstJ( true ); j <= ves->lastJ( true ); ++j )
+            {
+               for ( unsigned int k = ves->firstK(); k <= ves->lastK(); ++k )
+               {
+                  const double value = 1.0e6 * ( 1.0 + ( ves->lastK() - k ) * ( 2.0 + 0.3 * i + 0.2 * j ));
+                  ves->set( i, j, k, value );
+                  maxVes->set( i, j, k, ( j % 2 == 0 ? 1.0 : 1.5 ) * value );
+               }
+            }
+         }
+
+         derivedProperties.push_back( ves );
+         derivedProperties.push_back( maxVes );
+      }
+   };
+
+   /// Calculates the porosity and permeability from the ves of the VesCalculator.
+   class VesPropertyManager : public AbstractPropertyManager
+   {
+   public :
+
+      explicit VesPropertyManager( const GeoPhysics::ProjectHandle& projectHandle ) :
+         m_projectHandle( projectHandle ),
+         m_properties{ DataModel::MockProperty( "Ves", DataModel::CONTINUOUS_3D_PROPERTY ),
+                       DataModel::MockProperty( "MaxVes", DataModel::CONTINUOUS_3D_PROPERTY ),
+                       DataModel::MockProperty( "ChemicalCompaction", DataModel::CONTINUOUS_3D_PROPERTY ),
+                       DataModel::MockProperty( "Porosity", DataModel::CONTINUOUS_3D_PROPERTY ),
+                       DataModel::MockProperty( "Permeability", DataModel::CONTINUOUS_3D_PROPERTY ),
+                       DataModel::MockProperty( "HorizontalPermeability", DataModel::CONTINUOUS_3D_PROPERTY )}
+      {
+         addFormationPropertyCalculator( FormationPropertyCalculatorPtr( new VesCalculator ));
+         addFormationPropertyCalculator( FormationPropertyCalculatorPtr( new DerivedProperties::PorosityFormationCalculator( projectHandle )));
+         addFormationPropertyCalculator( FormationPropertyCalculatorPtr( new DerivedProperties::PermeabilityFormationCalculator( projectHandle )));
+      }
+
+      const DataModel::AbstractProperty* getProperty( const std::string& name ) const final
+      {
+         for ( const DataModel::MockProperty& property : m_properties )
+         {
+            if ( property.getName() == name ) return &property;
+         }
+
+         return nullptr;
+      }
+
+      const DataModel::AbstractGrid* getMapGrid() const final
+      {
+         return m_projectHandle.getActivityOutputGrid();
+      }
+
+      bool getNodeIsValid( const unsigned int i, const unsigned int j ) const final
+      {
+         return m_projectHandle.getNodeIsValid( i, j );
+      }
+
+   private :
+
+      const GeoPhysics::ProjectHandle&           m_projectHandle;
+      const std::vector<DataModel::MockProperty> m_properties;
+   };
+
+   void setNumberOfThreads( const int numberOfThreads )
+   {
+#ifdef _OPENMP
+      omp_set_num_threads( numberOfThreads );
+#else
+      (void) numberOfThreads;
+#endif
+   }
+}
+
+// The porosity and permeability calculated by several threads are those calculated by one
+TEST( ThreadedFormationCalculatorTest, SameValuesAsOneThread )
+{
+   GeoPhysics::ObjectFactory factory;
+   std::unique_ptr<GeoPhysics::ProjectHandle> projectHandle( DerivedProperties::openTestProject( factory ));
+   ASSERT_NE( projectHandle, nullptr );
+   ASSERT_TRUE( DerivedProperties::initialiseTestProject( *projectHandle, "ThreadedFormationCalculatorTest" ));
+
+   const DataAccess::Interface::Snapshot* snapshot = projectHandle->findSnapshot( 0.0 );
+   ASSERT_NE( snapshot, nullptr );
+
+   std::unique_ptr<DataAccess::Interface::FormationList> formations( projectHandle->getFormations( snapshot, true ));
+
+   VesPropertyManager serial( *projectHandle );
+   VesPropertyManager threaded( *projectHandle );
+
+   unsigned int numberOfSediments = 0;
+
+   for ( const DataAccess::Interface::Formation* formation : *formations )
+   {
+      if ( formation->kind() != DataAccess::Interface::SEDIMENT_FORMATION ) continue;
+      ++numberOfSediments;
+
+      for ( const std::string name : { "Porosity", "Permeability", "HorizontalPermeability" } )
+      {
+         setNumberOfThreads( 1 );
+         const FormationPropertyPtr expected = serial.getFormationProperty( serial.getProperty( name ), snapshot, formation );
+         setNumberOfThreads( 4 );
+         const FormationPropertyPtr actual = threaded.getFormationProperty( threaded.getProperty( name ), snapshot, formation );
+         ASSERT_NE( expected, nullptr ) << formation->getName() << ", " << name;
+         ASSERT_NE( actual, nullptr ) << formation->getName() << ", " << name;
+
+         for ( unsigned int i = actual->firstI( true ); i <= actual->lastI( true ); ++i )
+         {
+            for ( unsigned int j = actual->firstJ( true ); j <= actual->lastJ( true ); ++j )
+            {
+               for ( unsigned int k = actual->firstK(); k <= actual->lastK(); ++k )
+               {
+                  EXPECT_EQ( expected->get( i, j, k ), actual->get( i, j, k ))
+                     << formation->getName() << ", " << name << " at (" << i << ", " << j << ", " << k << ")";
+               }
+            }
+         }
+      }
+   }
+
+   setNumberOfThreads( 1 );
+   EXPECT_GT( numberOfSediments, 0u );
+}
@@ -794,21 +794,25 @@ double DistributedGridMap::getAverageValue () const
       return m_averageValue;
    }
 
-   const unsigned int iLast = lastI();
-   const unsigned int jLast = lastJ();
-
-   for (unsigned int i = firstI(); i <= iLast; ++i)
+   ConstValueArray values;
+   if (getValueArray (values))
    {
-      for (unsigned int j = firstJ(); j <= jLast; ++j)
+      const unsigned int iLast = lastI();
+      const unsigned int jLast = lastJ();
+
+      for (unsigned int i = firstI(); i <= iLast; ++i)
       {
-         for (unsigned int k = 0; k < m_depth; ++k)
+         for (unsigned int j = firstJ(); j <= jLast; ++j)
          {
-            double value = getValue (i, j, k);
-
-            if (value != getUndefinedValue ())
+            for (unsigned int k = 0; k < m_depth; ++k)
             {
-               numValues++;
-               total += value;
+               double value = values (i, j, k);
+
+               if (value != m_undefinedValue)
+               {
+                  numValues++;
+                  total += value;
+               }
             }
          }
       }
@@ -837,21 +841,28 @@ void DistributedGridMap::getMinMaxValue (double & min, double & max) const
    double minGlobal;
    double maxGlobal;
 
-   const unsigned int iLast = lastI();
-   const unsigned int jLast = lastJ();
-
-   for (unsigned int i = firstI(); i <= iLast; ++i)
+   ConstValueArray values;
+   if (getValueArray (values))
    {
-      for (unsigned int j = firstJ(); j <= jLast; ++j)
+      // the order does not matter, so the values along I are visited contiguously
+      const unsigned int iFirst = firstI();
+      const unsigned int rowLength = lastI() - iFirst + 1;
+      const unsigned int jLast = lastJ();
+
+      for (unsigned int k = 0; k < m_depth; ++k)
       {
-         for (unsigned int k = 0; k < m_depth; k++)
+         for (unsigned int j = firstJ(); j <= jLast; ++j)
          {
-            double value = getValue (i, j, k);
-
-            if (value != getUndefinedValue ())
+            const double * row = &values (iFirst, j, k);
+            for (unsigned int i = 0; i < rowLength; ++i)
             {
-               maxLocal = std::max (value, maxLocal);
-               minLocal = std::min (value, minLocal);
+               const double value = row[i];
+
+               if (value != m_undefinedValue)
+               {
+                  maxLocal = std::max (value, maxLocal);
+                  minLocal = std::min (value, minLocal);
+               }
             }
          }
       }
@@ -873,20 +884,24 @@ double DistributedGridMap::getSumOfValues () const
 {
    double total = 0;
 
-   const unsigned int iLast = lastI();
-   const unsigned int jLast = lastJ();
-
-   for (unsigned int i = firstI(); i <= iLast; ++i)
+   ConstValueArray values;
+   if (getValueArray (values))
    {
-      for (unsigned int j = firstJ(); j <= jLast; ++j)
+      const unsigned int iLast = lastI();
+      const unsigned int jLast = lastJ();
+
+      for (unsigned int i = firstI(); i <= iLast; ++i)
       {
-         for (unsigned int k = 0; k < m_depth; ++k)
+         for (unsigned int j = firstJ(); j <= jLast; ++j)
          {
-            double value = getValue (i, j, k);
-
-            if (value != getUndefinedValue ())
+            for (unsigned int k = 0; k < m_depth; ++k)
             {
-               total += value;
+               double value = values (i, j, k);
+
+               if (value != m_undefinedValue)
+               {
+                  total += value;
+               }
             }
          }
       }
@@ -903,20 +918,24 @@ double DistributedGridMap::getSumOfSquaredValues () const
 {
    double total = 0;
 
-   const unsigned int iLast = lastI();
-   const unsigned int jLast = lastJ();
-
-   for (unsigned int i = firstI(); i <= iLast; ++i)
+   ConstValueArray values;
+   if (getValueArray (values))
    {
-      for (unsigned int j = firstJ(); j <= jLast; ++j)
+      const unsigned int iLast = lastI();
+      const unsigned int jLast = lastJ();
+
+      for (unsigned int i = firstI(); i <= iLast; ++i)
       {
-         for (unsigned int k = 0; k < m_depth; ++k)
+         for (unsigned int j = firstJ(); j <= jLast; ++j)
          {
-            double value = getValue (i, j, k);
-
-            if (value != getUndefinedValue ())
+            for (unsigned int k = 0; k < m_depth; ++k)
             {
-               total += value * value;
+               double value = values (i, j, k);
+
+               if (value != m_undefinedValue)
+               {
+                  total += value * value;
+               }
             }
          }
       }
@@ -933,20 +952,24 @@ int DistributedGridMap::getNumberOfDefinedValues () const
 {
    unsigned int numValues = 0;
 
-   const unsigned int iLast = lastI();
-   const unsigned int jLast = lastJ();
-
-   for (unsigned int i = firstI(); i <= iLast; ++i)
+   ConstValueArray values;
+   if (getValueArray (values))
    {
-      for (unsigned int j = firstJ(); j <= jLast; ++j)
+      const unsigned int iFirst = firstI();
+      const unsigned int rowLength = lastI() - iFirst + 1;
+      const unsigned int jLast = lastJ();
+
+      for (unsigned int k = 0; k < m_depth; ++k)
       {
-         for (unsigned int k = 0; k < m_depth; ++k)
+         for (unsigned int j = firstJ(); j <= jLast; ++j)
          {
-            double value = getValue (i, j, k);
-
-            if (value != getUndefinedValue ())
+            const double * row = &values (iFirst, j, k);
+            for (unsigned int i = 0; i < rowLength; ++i)
             {
-               numValues++;
+               if (row[i] != m_undefinedValue)
+               {
+                  numValues++;
+               }
             }
          }
       }
@@ -994,6 +1017,43 @@ double const * const * const * DistributedGridMap::getValues (void) const
    return m_values;
 }
 
+bool DistributedGridMap::getValueArray (ConstValueArray & values) const
+{
+   if (!m_retrieved) return false;
+
+   // The Petsc array is indexed by global indices and is contiguous over the local (ghosted) part
+   values.firstI = firstI (m_withGhosts);
+   values.firstJ = firstJ (m_withGhosts);
+   values.numI = numI (m_withGhosts);
+   values.numJ = numJ (m_withGhosts);
+   values.numK = m_depth;
+   values.data = &m_values[0][values.firstJ][values.firstI];
+   values.strideI = 1;
+   values.strideJ = values.numI;
+   values.strideK = static_cast<size_t>(values.numI) * values.numJ;
+
+   return true;
+}
+
+bool DistributedGridMap::getValueArray (ValueArray & values)
+{
+   ConstValueArray constValues;
+   if (!getValueArray (constValues)) return false;
+
+   values.data = const_cast<double *>(constValues.data);
+   values.firstI = constValues.firstI;
+   values.firstJ = constValues.firstJ;
+   values.numI = constValues.numI;
+   values.numJ = constValues.numJ;
+   values.numK = constValues.numK;
+   values.strideI = constValues.strideI;
+   values.strideJ = constValues.strideJ;
+   values.strideK = constValues.strideK;
+
+   m_modified = true;
+   return true;
+}
+
 void DistributedGridMap::printOn (std::ostream & ostr) const
 {
    unsigned int depth = getDepth ();
@@ -211,6 +211,11 @@ namespace DataAccess
       /// Return the array of values managed by this GridMap
       virtual double const * const * const * getValues (void) const;
 
+      /// Get the values for reading; the values along I are contiguous
+      virtual bool getValueArray (ConstValueArray & values) const;
+      /// Get the values for writing; the values along I are contiguous
+      virtual bool getValueArray (ValueArray & values);
+
       virtual void printOn (std::ostream &) const;
       virtual void printOn (MPI_Comm comm) const;
 
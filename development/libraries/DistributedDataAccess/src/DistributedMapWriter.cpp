@@ -97,7 +97,7 @@ bool DistributedMapWriter::open (const std::string & fileName, bool append)
 }
 void DistributedMapWriter::setChunking() {
 
-   if( m_outFile != 0 and ( H5_Parallel_PropertyList::isPrimaryPodEnabled () or H5_Parallel_PropertyList::isOneFileLustreEnabled () )) {
+   if( m_outFile != 0 and H5_Parallel_PropertyList::isChunkingEnabled () ) {
       m_outFile->setChunking ( true );
    }
       
@@ -21,7 +21,6 @@
 #include <iostream>
 #include <sstream>
 #include <vector>
-#include <list>
 
 #include <petsc.h>
 #include <mpi.h>
@@ -35,6 +34,7 @@
 #include "DistributedApplicationGlobalOperations.h"
 #include "domainShapeReader.h"
 #include "LogHandler.h"
+#include "MapFileCache.h"
 
 #include "cauldronschemafuncs.h"
 #include "h5_parallel_file_types.h"
@@ -48,7 +48,11 @@ using namespace Interface;
 using namespace std;
 
 const double DefaultUndefinedValue = 99999;
-struct MapFileCache {
+
+/// Number of files kept open per category if not set by -mapfilecache
+const int DefaultMapFileCacheSize = 2;
+
+struct MapFile {
     string fileName;
     H5_ReadOnly_File gridMapFile;
     double undefinedValue;
@@ -56,28 +60,39 @@ struct MapFileCache {
     int numI, numJ;
     int depth;
     bool isDoubleType;
+
+    void close () { gridMapFile.close (); }
 };
 
+typedef MapFileCache<MapFile> CategoryMapFileCache;
+
 void ProjectHandle::mapFileCacheConstructor (void)
 {
-    m_mapFileCache = new struct MapFileCache [4];
+    PetscInt cacheSize = DefaultMapFileCacheSize;
+    PetscOptionsGetInt (PETSC_IGNORE, PETSC_IGNORE, "-mapfilecache", &cacheSize, PETSC_IGNORE);
+
+    m_mapFileCache = new CategoryMapFileCache [4];
     for (int i = 0; i < 4; ++i)
     {
-        static_cast<struct MapFileCache * > (m_mapFileCache) [i].fileName = "";
+        static_cast<CategoryMapFileCache * > (m_mapFileCache) [i].setCapacity (static_cast<size_t> (std::max<PetscInt> (1, cacheSize)));
     }
 }
 void ProjectHandle::mapFileCacheDestructor (void)
 {
    if( m_mapFileCache != nullptr ) {
+      static const char * categoryNames [] = { "auxiliary", "hrdecompaction", "genex", "fastcauldron" };
+
       for (int i = 0; i < 4; ++i)
       {
-         if (static_cast<struct MapFileCache * > (m_mapFileCache) [i].fileName != "")
+         const CategoryMapFileCache & mapFileCache = static_cast<CategoryMapFileCache * > (m_mapFileCache) [i];
+
+         if (mapFileCache.hits () + mapFileCache.misses () > 0)
          {
-            static_cast<struct MapFileCache * > (m_mapFileCache) [i].gridMapFile.close ();
-            static_cast<struct MapFileCache * > (m_mapFileCache) [i].fileName = "";
+            LogHandler(LogHandler::INFO_SEVERITY) << "Map file cache (" << categoryNames[i] << ", " << mapFileCache.capacity ()
+                                                  << " files): " << mapFileCache.hits () << " hits, " << mapFileCache.misses () << " misses";
          }
       }
-      delete[] static_cast<struct MapFileCache * > (m_mapFileCache);
+      delete[] static_cast<CategoryMapFileCache * > (m_mapFileCache);
       m_mapFileCache = nullptr;
    }
 }
@@ -87,11 +102,7 @@ void ProjectHandle::mapFileCacheCloseFiles(void)
     if (m_mapFileCache != nullptr) {
         for (int i = 0; i < 4; ++i)
         {
-            if (static_cast<struct MapFileCache*> (m_mapFileCache)[i].fileName != "")
-            {
-                static_cast<struct MapFileCache*> (m_mapFileCache)[i].gridMapFile.close();
-                static_cast<struct MapFileCache*> (m_mapFileCache)[i].fileName = "";
-            }
+            static_cast<CategoryMapFileCache*> (m_mapFileCache)[i].close ();
         }
     }
 }
@@ -182,39 +193,37 @@ GridMap * ProjectHandle::loadGridMap (const Parent * parent, unsigned int childI
 {
    H5Eset_auto (NULL, NULL, NULL);
 
-   struct MapFileCache * mapFileCachePtr = 0;
+   CategoryMapFileCache * mapFileCachePtr = 0;
 
    if (filePathName.find ("HighResDecompaction_Results") != string::npos)
    {
-      mapFileCachePtr = &  static_cast<struct MapFileCache * > (m_mapFileCache) [hrdecompaction];
+      mapFileCachePtr = &  static_cast<CategoryMapFileCache * > (m_mapFileCache) [hrdecompaction];
    }
    else if (filePathName.find ("Genex5_Results") != string::npos ||
     filePathName.find ("Genex6_Results") != string::npos)
    {
-      mapFileCachePtr = & static_cast<struct MapFileCache * > (m_mapFileCache) [genex];
+      mapFileCachePtr = & static_cast<CategoryMapFileCache * > (m_mapFileCache) [genex];
    }
    else if (filePathName.find ("_Results.HDF") != string::npos) // then it must be fastcauldron...
    {
-      mapFileCachePtr = & static_cast<struct MapFileCache * > (m_mapFileCache) [fastcauldron];
+      mapFileCachePtr = & static_cast<CategoryMapFileCache * > (m_mapFileCache) [fastcauldron];
    }
    else // i.e. 3D
    {
-      mapFileCachePtr = & static_cast<struct MapFileCache * > (m_mapFileCache) [auxiliary];
+      mapFileCachePtr = & static_cast<CategoryMapFileCache * > (m_mapFileCache) [auxiliary];
    }
 
-   struct MapFileCache & mapFileCache = * mapFileCachePtr;
+   CategoryMapFileCache & mapFileCache = * mapFileCachePtr;
 
-   H5_ReadOnly_File & gridMapFile = mapFileCache.gridMapFile;
+   MapFile * cachedMapFile = mapFileCache.find (filePathName);
 
-   if (mapFileCache.fileName != filePathName)
+   if (cachedMapFile == nullptr)
    {
-      mapFileCache.rank = -1;   // needs to be invalidated
-      if (mapFileCache.fileName != "")
-      {
-         gridMapFile.close ();
-         mapFileCache.fileName = "";
-      }      
-            
+      MapFile & newMapFile = mapFileCache.insert (filePathName);
+      newMapFile.rank = -1;   // needs to be invalidated
+
+      H5_ReadOnly_File & newGridMapFile = newMapFile.gridMapFile;
+
       // It would be better to use a parallel mpio property list, but it drops performance for some cases on non-parallel file system (but works fine)
       H5_Parallel_PropertyList parPropertyList;
       H5_PropertyList propertyList;
@@ -223,7 +232,7 @@ GridMap * ProjectHandle::loadGridMap (const Parent * parent, unsigned int childI
       int fileOpen = 0;
       int globalFileOpen = 0;
 
-      if (!gridMapFile.open (filePathName.c_str (), propertyListPointer))
+      if (!newGridMapFile.open (filePathName.c_str (), propertyListPointer))
       {
           fileOpen = 1;
       }
@@ -232,21 +241,27 @@ GridMap * ProjectHandle::loadGridMap (const Parent * parent, unsigned int childI
 
       if (globalFileOpen > 0)
       {
-          gridMapFile.close();
+          newGridMapFile.close();
           propertyListPointer = &parPropertyList;
 
-          if (!gridMapFile.open(filePathName.c_str(), propertyListPointer))
+          if (!newGridMapFile.open(filePathName.c_str(), propertyListPointer))
           {
               cerr << "ERROR in ProjectHandle::loadGridMap (): Could not open " << filePathName << endl;
+              mapFileCache.eraseFront ();
               return nullptr;
           }
       }
 
-      mapFileCache.fileName = filePathName;
-      mapFileCache.undefinedValue = gridMapFile.GetUndefinedValue(); // value is in the file.
-   }   
+      newMapFile.undefinedValue = newGridMapFile.GetUndefinedValue(); // value is in the file.
+
+      cachedMapFile = &newMapFile;
+   }
+
+   MapFile & mapFile = * cachedMapFile;
+
+   H5_ReadOnly_File & gridMapFile = mapFile.gridMapFile;
 
-   if (mapFileCache.rank != 2)
+   if (mapFile.rank != 2)
    {
       // at least dimensions[2] is out of date.
 
@@ -262,33 +277,33 @@ GridMap * ProjectHandle::loadGridMap (const Parent * parent, unsigned int childI
 
       hsize_t dimensions[3];
 
-      mapFileCache.rank = H5Sget_simple_extent_dims (dataSpaceId, dimensions, 0);      
+      mapFile.rank = H5Sget_simple_extent_dims (dataSpaceId, dimensions, 0);      
 
-      mapFileCache.numI = dimensions[0];
-      mapFileCache.numJ = dimensions[1];
-      if (mapFileCache.rank == 2)
+      mapFile.numI = dimensions[0];
+      mapFile.numJ = dimensions[1];
+      if (mapFile.rank == 2)
       {
-         mapFileCache.depth = 1;
+         mapFile.depth = 1;
       }
       else
       {
-         mapFileCache.depth = dimensions[2];
+         mapFile.depth = dimensions[2];
       }
 
       // determine the dataset storage type
       hid_t dtype       = H5Dget_type( dataSetId );
       ssize_t dataSize  = H5Tget_size(dtype);
-      mapFileCache.isDoubleType = ( dataSize == H5_SIZEOF_DOUBLE );
+      mapFile.isDoubleType = ( dataSize == H5_SIZEOF_DOUBLE );
 
       H5Sclose (dataSpaceId);
       gridMapFile.closeDataset(dataSetId);
    }
 
-   const int numI = mapFileCache.numI;
-   const int numJ = mapFileCache.numJ;
-   unsigned int depth = mapFileCache.depth;
-   const double undefinedValue = mapFileCache.undefinedValue;
-   const bool isDoubleType = mapFileCache.isDoubleType;
+   const int numI = mapFile.numI;
+   const int numJ = mapFile.numJ;
+   unsigned int depth = mapFile.depth;
+   const double undefinedValue = mapFile.undefinedValue;
+   const bool isDoubleType = mapFile.isDoubleType;
 
    // create petsc type
    PetscDimensions *petscD;
@@ -0,0 +1,116 @@
+//
+// Copyright (C) 2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <string>
+
+namespace DataAccess
+{
+namespace Interface
+{
+
+/// LRU cache of the open map files of one category (hrdecompaction, genex, fastcauldron, auxiliary).
+///
+/// The most recently used file is in front of the list. MapFile must have a fileName member
+/// and a close function, the least recently used file is closed when it is evicted.
+template <class MapFile>
+class MapFileCache
+{
+public:
+  explicit MapFileCache(const size_t capacity = 1) :
+    m_capacity(std::max<size_t>(1, capacity)),
+    m_hits(0),
+    m_misses(0)
+  {
+  }
+
+  ~MapFileCache()
+  {
+    close();
+  }
+
+  MapFileCache(const MapFileCache&) = delete;
+  MapFileCache& operator=(const MapFileCache&) = delete;
+
+  /// Change the number of files kept open, the least recently used files are closed if there are more.
+  void setCapacity(const size_t capacity)
+  {
+    m_capacity = std::max<size_t>(1, capacity);
+
+    while (m_files.size() > m_capacity)
+    {
+      m_files.back().close();
+      m_files.pop_back();
+    }
+  }
+
+  /// Return the open file, moved to the front of the cache, or nullptr if the file is not in the cache.
+  MapFile* find(const std::string& fileName)
+  {
+    typename std::list<MapFile>::iterator mapFileIter = std::find_if(m_files.begin(), m_files.end(),
+                                                                     [&fileName](const MapFile& mapFile) { return mapFile.fileName == fileName; });
+
+    if (mapFileIter == m_files.end())
+    {
+      ++m_misses;
+      return nullptr;
+    }
+
+    ++m_hits;
+    m_files.splice(m_files.begin(), m_files, mapFileIter);
+    return &m_files.front();
+  }
+
+  /// Add a file that is not in the cache in front, the least recently used file is closed when the cache is full.
+  MapFile& insert(const std::string& fileName)
+  {
+    if (m_files.size() >= m_capacity)
+    {
+      m_files.back().close();
+      m_files.pop_back();
+    }
+
+    m_files.emplace_front();
+    m_files.front().fileName = fileName;
+    return m_files.front();
+  }
+
+  /// Remove the file in front without closing it, e.g. when it could not be opened.
+  void eraseFront()
+  {
+    m_files.pop_front();
+  }
+
+  /// Close and remove all the files.
+  void close()
+  {
+    for (MapFile& mapFile : m_files)
+    {
+      mapFile.close();
+    }
+    m_files.clear();
+  }
+
+  size_t capacity() const { return m_capacity; }
+  size_t size() const { return m_files.size(); }
+  size_t hits() const { return m_hits; }
+  size_t misses() const { return m_misses; }
+
+private:
+  std::list<MapFile> m_files;
+  size_t m_capacity;
+  size_t m_hits;
+  size_t m_misses;
+};
+
+} // namespace Interface
+} // namespace DataAccess
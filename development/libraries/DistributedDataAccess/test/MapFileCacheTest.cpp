@@ -0,0 +1,139 @@
+//
+// Copyright (C) 2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#include "../src/MapFileCache.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace DataAccess::Interface;
+
+namespace
+{
+
+// A file that records in which order the files are closed
+struct TestMapFile
+{
+  std::string fileName;
+  std::vector<std::string>* closedFiles = nullptr;
+  bool isOpen = false;
+
+  void close()
+  {
+    if (isOpen)
+    {
+      closedFiles->push_back(fileName);
+      isOpen = false;
+    }
+  }
+};
+
+class MapFileCacheTest : public ::testing::Test
+{
+protected:
+  TestMapFile& open(MapFileCache<TestMapFile>& cache, const std::string& fileName)
+  {
+    TestMapFile* mapFile = cache.find(fileName);
+
+    if (mapFile == nullptr)
+    {
+      mapFile = &cache.insert(fileName);
+      mapFile->closedFiles = &m_closedFiles;
+      mapFile->isOpen = true;
+      ++m_openCount;
+    }
+
+    return *mapFile;
+  }
+
+  std::vector<std::string> m_closedFiles;
+  int m_openCount = 0;
+};
+
+}
+
+TEST_F(MapFileCacheTest, EvictsLeastRecentlyUsed)
+{
+  MapFileCache<TestMapFile> cache(2);
+
+  open(cache, "Time_10.h5");
+  open(cache, "Time_20.h5");
+
+  // Alternating between the two files does not reopen them
+  open(cache, "Time_10.h5");
+  open(cache, "Time_20.h5");
+  open(cache, "Time_10.h5");
+  EXPECT_EQ(2, m_openCount);
+  EXPECT_EQ(3u, cache.hits());
+  EXPECT_EQ(2u, cache.misses());
+  EXPECT_TRUE(m_closedFiles.empty());
+
+  // Time_20.h5 is the least recently used file
+  open(cache, "Time_30.h5");
+  ASSERT_EQ(1u, m_closedFiles.size());
+  EXPECT_EQ("Time_20.h5", m_closedFiles[0]);
+  EXPECT_EQ(2u, cache.size());
+
+  open(cache, "Time_10.h5");
+  open(cache, "Time_40.h5");
+  ASSERT_EQ(2u, m_closedFiles.size());
+  EXPECT_EQ("Time_30.h5", m_closedFiles[1]);
+  EXPECT_EQ(4, m_openCount);
+}
+
+TEST_F(MapFileCacheTest, ReopensEvictedFile)
+{
+  MapFileCache<TestMapFile> cache(1);
+
+  TestMapFile& first = open(cache, "Time_10.h5");
+  EXPECT_EQ("Time_10.h5", first.fileName);
+
+  open(cache, "Time_20.h5");
+  ASSERT_EQ(1u, m_closedFiles.size());
+  EXPECT_EQ("Time_10.h5", m_closedFiles[0]);
+
+  // The evicted file is not in the cache anymore and is opened again
+  EXPECT_EQ(nullptr, cache.find("Time_10.h5"));
+  TestMapFile& reopened = open(cache, "Time_10.h5");
+  EXPECT_TRUE(reopened.isOpen);
+  EXPECT_EQ("Time_10.h5", reopened.fileName);
+  EXPECT_EQ(3, m_openCount);
+  EXPECT_EQ(0u, cache.hits());
+
+  EXPECT_EQ(&reopened, cache.find("Time_10.h5"));
+  EXPECT_EQ(1u, cache.hits());
+}
+
+TEST_F(MapFileCacheTest, CloseAndResize)
+{
+  MapFileCache<TestMapFile> cache(3);
+
+  open(cache, "Time_10.h5");
+  open(cache, "Time_20.h5");
+  open(cache, "Time_30.h5");
+
+  // The least recently used files are closed first
+  cache.setCapacity(1);
+  ASSERT_EQ(2u, m_closedFiles.size());
+  EXPECT_EQ("Time_10.h5", m_closedFiles[0]);
+  EXPECT_EQ("Time_20.h5", m_closedFiles[1]);
+  EXPECT_EQ(1u, cache.size());
+
+  cache.close();
+  EXPECT_EQ(0u, cache.size());
+  ASSERT_EQ(3u, m_closedFiles.size());
+  EXPECT_EQ("Time_30.h5", m_closedFiles[2]);
+
+  // A file that could not be opened is removed without being closed
+  open(cache, "Time_40.h5").isOpen = false;
+  cache.eraseFront();
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(3u, m_closedFiles.size());
+}
@@ -579,6 +579,10 @@ void AppCtx::printHelp () const {
   helpBuffer << "           -primaryPod <dir>           Use dir to store imtermediate output files. Dir should be a shared dir on the cluster (or local)" << endl;
   helpBuffer << "           -primaryDouble              Output only primary properties in double precision." << endl;
   helpBuffer << "           -allproperties              Output all properties (selected in FilterTimeIoTbl) and not just primary." << endl;
+  helpBuffer << "           -hdfchunked                 Write volume output with chunked layout." << endl;
+  helpBuffer << "           -hdfchunksize <ni,nj,nk>    Chunk shape of volume output, 0 entries are taken from the domain decomposition." << endl;
+  helpBuffer << "           -hdfcompress <level>        Compress volume output with deflate level 1-9 (default 4)." << endl;
+  helpBuffer << "           -mapfilecache <n>           Number of input HDF files kept open per result category (default 2)." << endl;
 
   helpBuffer << endl;
 
@@ -11,7 +11,7 @@
 #include "FormattingException.h"
 
 
-#ifdef __INTEL_COMPILER
+#ifdef NUMERICS_SIMD_AVX
 void FiniteElementMethod::BasisFunctionInterpolator::interpolatePropertiesMain ( const int NA, const int MA, const int MB,
                                                                                  const int colBlocks,
                                                                                  const int rowBlocks,
@@ -366,7 +366,7 @@ void FiniteElementMethod::BasisFunctionInterpolator::simpleInterpolate ( const N
 void FiniteElementMethod::BasisFunctionInterpolator::compute ( const Numerics::AlignedDenseMatrix& basisFunctionsTranspose,
                                                                const Numerics::AlignedDenseMatrix& propertyVectors,
                                                                      Numerics::AlignedDenseMatrix& interpolatedProperties,
-#ifdef __INTEL_COMPILER
+#ifdef NUMERICS_SIMD_AVX
                                                                const cpuInfo& cpuInfo
 #else
                                                                const cpuInfo&
@@ -383,7 +383,7 @@ void FiniteElementMethod::BasisFunctionInterpolator::compute ( const Numerics::A
       throw formattingexception::GeneralException () << "Dimension mismatch";
    }
 
-#ifdef __INTEL_COMPILER
+#ifdef NUMERICS_SIMD_AVX
    if ( cpuInfo.supportAvx( ) )
    {
       const double* bufAPos = basisFunctionsTranspose.data();
@@ -11,12 +11,8 @@
 #define FINITE_ELEMENT_METHOD__BASIS_FUNCTION_INTERPOLATOR_H
 
 // Access to STL
-#ifdef __INTEL_COMPILER
 #include <array>
 #include <cmath>
-#include <xmmintrin.h>
-#include <immintrin.h>
-#endif
 
 #include "AlignedDenseMatrix.h"
 #include "SimdInstruction.h"
@@ -49,7 +45,7 @@ namespace FiniteElementMethod {
 
    private :
 
-#ifdef __INTEL_COMPILER
+#ifdef NUMERICS_SIMD_AVX
 
       /// \brief An array of four vectors of doubles.
       typedef std::array<__m256d, 4> FourByFour;
@@ -77,18 +73,18 @@ namespace FiniteElementMethod {
       /// The 4x4 block is loaded into the 4 vectors and transposed.
       ///
       /// \f\left( \begin{array}{cccc}
-      /// a & e & i & m\                             \
-      /// b & f & j & n\                             \
-      /// c & g & k & o\                             \
+      /// a & e & i & m \cr
+      /// b & f & j & n \cr
+      /// c & g & k & o \cr
       /// d & h & l & p\end{array}
       /// \right) \f
       ///
       /// After transposing
       ///
       /// \f\left( \begin{array}{cccc}
-      /// a & b & c & d\                             \
-      /// e & f & g & h\                             \
-      /// i & j & k & l\                             \
+      /// a & b & c & d \cr
+      /// e & f & g & h \cr
+      /// i & j & k & l \cr
       /// m & n & o & p\end{array}
       /// \right) \f
       void loadContiguousTrans4x4 ( const double* mat, const int lda, FourByFour& avx );
@@ -98,18 +94,18 @@ namespace FiniteElementMethod {
       /// The 4x2 block is loaded into the 4 vectors and the transposed.
       ///
       /// \f\left( \begin{array}{cc}
-      /// a & e\                             \
-      /// b & f\                             \
-      /// c & g\                             \
+      /// a & e \cr
+      /// b & f \cr
+      /// c & g \cr
       /// d & h\end{array}
       /// \right) \f
       ///
       /// After transposing
       ///
       /// \f\left( \begin{array}{cccc}
-      /// a & b & c & d\                             \
-      /// e & f & g & h\                             \
-      /// a & b & c & d\                             \
+      /// a & b & c & d \cr
+      /// e & f & g & h \cr
+      /// a & b & c & d \cr
       /// e & f & g & h\end{array}
       /// \right) \f
       void loadContiguousTrans4x2 ( const double* mat, const int lda, FourByFour& avx );
@@ -119,18 +115,18 @@ namespace FiniteElementMethod {
       /// The 4x1 block is loaded into the 4 vectors.
       ///
       /// \f\left( \begin{array}{c}
-      /// a\                             \
-      /// b\                             \
-      /// c\                             \
+      /// a \cr
+      /// b \cr
+      /// c \cr
       /// d\end{array}
       /// \right) \f
       ///
       /// After transposing
       ///
       /// \f\left( \begin{array}{cccc}
-      /// a & b & c & d\                             \
-      /// a & b & c & d\                             \
-      /// a & b & c & d\                             \
+      /// a & b & c & d \cr
+      /// a & b & c & d \cr
+      /// a & b & c & d \cr
       /// a & b & c & d\end{array}
       /// \right) \f
       void loadBroadcast4x1 ( const double* mat, FourByFour& avx );
@@ -173,21 +169,21 @@ namespace FiniteElementMethod {
       /// Consider the 4 vectors to store 2 2x2 matrices.
       ///
       /// \f\left( \begin{array}{cc}
-      /// a & e\                             \
-      /// b & f\                             \
-      /// c & g\                             \
+      /// a & e \cr
+      /// b & f \cr
+      /// c & g \cr
       /// d & h\end{array}
       /// \right) \f
       ///
       /// These vectors can be considered to be two 2x2 matrices.
       ///
       /// \f m1=\left( \begin{array}{cc}
-      /// a & e\                             \
+      /// a & e \cr
       /// b & f\end{array}
       /// \right) \f
       ///
       /// \f m2=\left( \begin{array}{cc}
-      /// c & g\                             \
+      /// c & g \cr
       /// d & h\end{array}
       /// \right) \f
       ///
@@ -275,7 +271,7 @@ namespace FiniteElementMethod {
 
 }
 
-#ifdef __INTEL_COMPILER
+#ifdef NUMERICS_SIMD_AVX
 
 inline void FiniteElementMethod::BasisFunctionInterpolator::zero ( FourByFour& avx ) {
    // Set all values to be zero.
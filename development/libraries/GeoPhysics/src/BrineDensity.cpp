@@ -13,6 +13,8 @@
 #include "ArrayDefinitions.h"
 #include "AlignedMemoryAllocator.h"
 
+#include <algorithm>
+
 
 GeoPhysics::Brine::Density::Density() :
    m_perturbatedPhases( GeoPhysics::Brine::PhaseStateVec( s_fdStencil, 0.0 ) )
@@ -57,67 +59,31 @@ void GeoPhysics::Brine::Density::get( const GeoPhysics::Brine::PhaseStateVec & p
                                       ArrayDefs::Real_ptr brineProp ) const
 {
    const int n = phase.getVectorSize();
-   const int acqueousNum   = phase.getAqueousPhasesNum();
-   const int vapourNum     = phase.getVapourPhasesNum();
-   const int transitionNum = phase.getTransitionPhasesNum();
 
    const double salinity = phase.getSalinity();
 
-   const ArrayDefs::Int_ptr acqueousIdx   = phase.getAqueousIndices();
-   const ArrayDefs::Int_ptr vapourIdx     = phase.getVapourIndices();
-   const ArrayDefs::Int_ptr transitionIdx = phase.getTransitionIndices();
-
    const ArrayDefs::Real_ptr temperature       = phase.getTemperature();
    const ArrayDefs::Real_ptr pressure          = phase.getPressure();
    const ArrayDefs::Real_ptr higherTemperature = phase.getHighEndTransitionTemp();
    const ArrayDefs::Real_ptr lowerTemperature  = phase.getLowEndTransitionTemp();
 
-   if( acqueousNum > n/2 )
+   /// The aqueous and vapour values are evaluated for every element, with the temperature clamped to the ends of the
+   /// transition region, and the value of the phase of the element is selected by masked stores. The phase is not
+   /// branched on, so the loop is vectorised whatever the mix of phases.
+   ARRAY_SIMD_LOOP
+   for( int i=0; i < n; ++i )
    {
-      /// aqueousBatzleWang will be applied through vectorization to all the vector elements,
-      /// then the other phases will be adjusted
-      for( int i=0; i < n; ++i )             brineProp [i]                = aqueousBatzleWang( temperature[i],
-                                                                                               pressure[i],
-                                                                                               salinity );
-      for( int i=0; i < vapourNum; ++i )     brineProp [vapourIdx[i]]     = vapourIdealGas( temperature[vapourIdx[i]],
-                                                                                            pressure[vapourIdx[i]],
-                                                                                            salinity );
-      for( int i=0; i < transitionNum; ++i ) brineProp [transitionIdx[i]] = transitionRegion( temperature[transitionIdx[i]],
-                                                                                              pressure[transitionIdx[i]],
-                                                                                              salinity,
-                                                                                              higherTemperature[transitionIdx[i]],
-                                                                                              lowerTemperature [transitionIdx[i]] );
-   }
-   else if( transitionNum > n/2 )
-   {
-      /// transitionRegion will be applied through vectorization to all the vector elements,
-      /// then the other phases will be adjusted
-      for( int i=0; i < n; ++i )           brineProp [i]              = transitionRegion( temperature[i],
-                                                                                          pressure[i],
-                                                                                          salinity,
-                                                                                          higherTemperature[i],
-                                                                                          lowerTemperature [i] );
-      for( int i=0; i < acqueousNum; ++i ) brineProp [acqueousIdx[i]] = aqueousBatzleWang( temperature[acqueousIdx[i]],
-                                                                                           pressure[acqueousIdx[i]],
-                                                                                           salinity );
-      for( int i=0; i < vapourNum; ++i )   brineProp [vapourIdx[i]]   = vapourIdealGas( temperature[vapourIdx[i]],
-                                                                                        pressure[vapourIdx[i]],
-                                                                                        salinity );
-   }
-   else
-   {
-      /// All phases will be taken care of individually without making use of any vectorization
-      for( int i=0; i < vapourNum; ++i )     brineProp [vapourIdx[i]]     = vapourIdealGas( temperature[vapourIdx[i]],
-                                                                                            pressure[vapourIdx[i]],
-                                                                                            salinity );
-      for( int i=0; i < acqueousNum; ++i )   brineProp [acqueousIdx[i]]   = aqueousBatzleWang( temperature[acqueousIdx[i]],
-                                                                                               pressure[acqueousIdx[i]],
-                                                                                               salinity );
-      for( int i=0; i < transitionNum; ++i ) brineProp [transitionIdx[i]] = transitionRegion( temperature[transitionIdx[i]],
-                                                                                              pressure[transitionIdx[i]],
-                                                                                              salinity,
-                                                                                              higherTemperature[transitionIdx[i]],
-                                                                                              lowerTemperature [transitionIdx[i]] );
+      const double t       = temperature[i];
+      const double lowerT  = lowerTemperature[i];
+      const double higherT = higherTemperature[i];
+
+      const double aqueous    = aqueousBatzleWang( std::min( t, lowerT ), pressure[i], salinity );
+      const double vapour     = vapourIdealGas( std::max( t, higherT ), pressure[i], salinity );
+      const double transition = aqueous + ( t - lowerT ) * ( vapour - aqueous ) / ( higherT - lowerT );
+
+      brineProp[i] = transition;
+      if ( t >= higherT ) brineProp[i] = vapour;
+      if ( t <= lowerT )  brineProp[i] = aqueous;
    }
 }
 
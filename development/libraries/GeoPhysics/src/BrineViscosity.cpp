@@ -11,6 +11,8 @@
 #include "BrineViscosity.h"
 #include "BrinePhases.h"
 
+#include <algorithm>
+
 GeoPhysics::Brine::Viscosity::Viscosity( const double salinity ) :
   m_term1( ( 0.42 * (std::pow ( salinity, 0.8 ) - 0.17) * (std::pow ( salinity, 0.8 ) - 0.17) + 0.045 ) ),
   m_term2( 0.001 * (0.1 + 0.333 * salinity) ),
@@ -50,49 +52,27 @@ void GeoPhysics::Brine::Viscosity::get( const GeoPhysics::Brine::PhaseStateVec &
                                         ArrayDefs::Real_ptr brineProp ) const
 {
    const int n = phase.getVectorSize();
-   const int acqueousNum   = phase.getAqueousPhasesNum();
-   const int vapourNum     = phase.getVapourPhasesNum();
-   const int transitionNum = phase.getTransitionPhasesNum();
-
-   const ArrayDefs::Int_ptr acqueousIdx   = phase.getAqueousIndices();
-   const ArrayDefs::Int_ptr vapourIdx     = phase.getVapourIndices();
-   const ArrayDefs::Int_ptr transitionIdx = phase.getTransitionIndices();
 
    const ArrayDefs::Real_ptr temperature       = phase.getTemperature();
-   const ArrayDefs::Real_ptr pressure          = phase.getPressure();
    const ArrayDefs::Real_ptr higherTemperature = phase.getHighEndTransitionTemp();
    const ArrayDefs::Real_ptr lowerTemperature  = phase.getLowEndTransitionTemp();
 
-   if( acqueousNum > n/2 )
+   /// The aqueous value is evaluated for every element, with the temperature clamped to the low end of the
+   /// transition region, and the value of the phase of the element is selected by masked stores. The phase is not
+   /// branched on; the exponential and power are vectorised only when a vector maths library may be used (see ARRAY_SIMD_LOOP).
+   ARRAY_SIMD_LOOP
+   for( int i=0; i < n; ++i )
    {
-      /// aqueousBatzleWang will be applied through vectorization to all the vector elements,
-      /// then the other phases will be adjusted
-      for( int i=0; i < n; ++i )             brineProp [i]                = aqueousBatzleWang( temperature[i] );
-      for( int i=0; i < vapourNum; ++i )     brineProp [vapourIdx[i]]     = vapourConstant();
-      for( int i=0; i < transitionNum; ++i ) brineProp [transitionIdx[i]] = transitionRegion( temperature[transitionIdx[i]],
-                                                                                                pressure[transitionIdx[i]],
-                                                                                                higherTemperature[transitionIdx[i]],
-                                                                                                lowerTemperature [transitionIdx[i]] );
-   }
-   else if( transitionNum > n/2 )
-   {
-      /// transitionRegion will be applied through vectorization to all the vector elements,
-      /// then the other phases will be adjusted
-      for( int i=0; i < n; ++i )           brineProp [i]                = transitionRegion( temperature[i],
-                                                                                              pressure[i],
-                                                                                              higherTemperature[i],
-                                                                                              lowerTemperature [i] );
-      for( int i=0; i < acqueousNum; ++i ) brineProp [acqueousIdx[i]]   = aqueousBatzleWang( temperature[acqueousIdx[i]] );
-      for( int i=0; i < vapourNum; ++i )   brineProp [vapourIdx[i]]     = vapourConstant();
-   }
-   else
-   {
-      /// All phases will be taken care of individually without making use of any vectorization
-      for( int i=0; i < vapourNum; ++i )     brineProp [vapourIdx[i]]     = vapourConstant();
-      for( int i=0; i < acqueousNum; ++i )   brineProp [acqueousIdx[i]]   = aqueousBatzleWang( temperature[acqueousIdx[i]] );
-      for( int i=0; i < transitionNum; ++i ) brineProp [transitionIdx[i]] = transitionRegion( temperature[transitionIdx[i]],
-                                                                                              pressure[transitionIdx[i]],
-                                                                                              higherTemperature[transitionIdx[i]],
-                                                                                              lowerTemperature [transitionIdx[i]] );
+      const double t       = temperature[i];
+      const double lowerT  = lowerTemperature[i];
+      const double higherT = higherTemperature[i];
+
+      const double aqueous    = aqueousBatzleWang( std::min( t, lowerT ));
+      const double vapour     = vapourConstant();
+      const double transition = aqueous + ( t - lowerT ) * ( vapour - aqueous ) / ( higherT - lowerT );
+
+      brineProp[i] = transition;
+      if ( t >= higherT ) brineProp[i] = vapour;
+      if ( t <= lowerT )  brineProp[i] = aqueous;
    }
 }
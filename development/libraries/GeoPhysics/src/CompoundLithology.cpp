@@ -24,6 +24,8 @@ using Utilities::Physics::AccelerationDueToGravity;
 #include "ConstantsMathematics.h"
 using Utilities::Maths::MilliDarcyToM2;
 using Utilities::Maths::MicroWattsToWatts;
+#include "SimdMathematics.h"
+namespace SimdMaths = Utilities::SimdMaths;
 
 #include "FormattingException.h"
 #include "Interface.h"
@@ -1137,27 +1139,27 @@ void GeoPhysics::CompoundLithology::calcBulkThermCondNP ( const unsigned int siz
                                                           double*       bulkThermalCondN,
                                                           double*       bulkThermalCondP ) const {
 
-   double matrixThermalConductivityN;
-   double matrixThermalConductivityP;
+   // The matrix conductivities are interpolated from the tables first, so that the mixing
+   // with the fluid is done in loops over contiguous values without any calls to the tables.
+   for ( unsigned int i = 0; i < size; ++i ) {
+      bulkThermalCondN [ i ] = thermalconductivityN ( temperature [ i ]);
+      bulkThermalCondP [ i ] = thermalconductivityP ( temperature [ i ]);
+   }
 
    if ( fluidThermalConductivity != nullptr ) {
 
+      ARRAY_SIMD_LOOP
       for ( unsigned int i = 0; i < size; ++i ) {
-          matrixThermalConductivityN = thermalconductivityN ( temperature [ i ]);
-          matrixThermalConductivityP = thermalconductivityP ( temperature [ i ]);
-
-          bulkThermalCondN [ i ] = matrixThermalConductivityN * pow ( fluidThermalConductivity [ i ] / matrixThermalConductivityN, porosity [ i ]);
-          bulkThermalCondP [ i ] = matrixThermalConductivityP * pow ( fluidThermalConductivity [ i ] / matrixThermalConductivityP, porosity [ i ]);
+         bulkThermalCondN [ i ] *= SimdMaths::pow ( fluidThermalConductivity [ i ] / bulkThermalCondN [ i ], porosity [ i ]);
+         bulkThermalCondP [ i ] *= SimdMaths::pow ( fluidThermalConductivity [ i ] / bulkThermalCondP [ i ], porosity [ i ]);
       }
 
    } else {
 
+      ARRAY_SIMD_LOOP
       for ( unsigned int i = 0; i < size; ++i ) {
-          matrixThermalConductivityN = thermalconductivityN ( temperature [ i ]);
-          matrixThermalConductivityP = thermalconductivityP ( temperature [ i ]);
-
-          bulkThermalCondN [ i ] = pow ( matrixThermalConductivityN, 1.0 - porosity [ i ]);
-          bulkThermalCondP [ i ] = pow ( matrixThermalConductivityP, 1.0 - porosity [ i ]);
+         bulkThermalCondN [ i ] = SimdMaths::pow ( bulkThermalCondN [ i ], 1.0 - porosity [ i ]);
+         bulkThermalCondP [ i ] = SimdMaths::pow ( bulkThermalCondP [ i ], 1.0 - porosity [ i ]);
       }
 
    }
@@ -1354,6 +1356,7 @@ void GeoPhysics::CompoundLithology::calcBulkPermeabilityNP ( const unsigned int
       double permeabilityAnisotropy = m_lithoComponents [ 0 ]->getPermAniso ();
       m_lithoComponents [ 0 ]->permeability ( size, ves, maxVes, porosities.getSimpleData ( 0 ), permeabilityNormal );
 
+      ARRAY_SIMD_LOOP
       for ( unsigned int i = 0; i < size; ++i ) {
          permeabilityNormal [ i ] *= MilliDarcyToM2;
          permeabilityPlane [ i ] = permeabilityAnisotropy * permeabilityNormal [ i ];
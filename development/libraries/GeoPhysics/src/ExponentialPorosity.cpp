@@ -88,6 +88,7 @@ namespace GeoPhysics
       assert( ((uintptr_t)(const void *)(chemicalComp) % 32) == 0 );
       assert( ((uintptr_t)(const void *)(porosities) % 32) == 0 );
 
+      ARRAY_SIMD_LOOP
       for( size_t i = 0; i < n; ++i)
       {
          porosities[i] = computeSingleValue( ves[i], maxVes[i], includeChemicalCompaction, chemicalComp[i] );
@@ -109,6 +110,7 @@ namespace GeoPhysics
       assert( ((uintptr_t)(const void *)(porosities) % 32) == 0 );
       assert( ((uintptr_t)(const void *)(porosityDers) % 32) == 0 );
 
+      ARRAY_SIMD_LOOP
       for( size_t i = 0; i < n; ++i)
       {
           porosities[i] = computeSingleValue( ves[i], maxVes[i], includeChemicalCompaction, chemicalComp[i] );
@@ -18,7 +18,9 @@ using namespace std;
 // utilities library
 #include "FormattingException.h"
 #include "ConstantsMathematics.h"
+#include "SimdMathematics.h"
 using Utilities::Maths::MilliDarcyToM2;
+namespace SimdMaths = Utilities::SimdMaths;
 
 GeoPhysics::PermeabilityMixer::PermeabilityMixer () :
    m_layeringIndex ( -1.0 ),
@@ -376,14 +378,14 @@ inline void GeoPhysics::PermeabilityMixer::mixTwoHomogeneous ( const unsigned in
 
    // This can be done when the object is "reset"
    double mixedAnisotropy = std::pow ( permeabilityAnisotropy1 / permeabilityAnisotropy2, fractionLithology1 ) * permeabilityAnisotropy2;
-   double mixedPermeability;
 
    ArrayDefs::Real_ptr permeabilities1 = simplePermeabilities.getData ( 0 );
    ArrayDefs::Real_ptr permeabilities2 = simplePermeabilities.getData ( 1 );
 
    // The permeability cannot be zero
+   ARRAY_SIMD_LOOP
    for ( unsigned int i = 0; i < size; ++i ) {
-      mixedPermeability = MilliDarcyToM2 * std::pow ( permeabilities1 [ i ] / permeabilities2 [ i ], fractionLithology1 ) * permeabilities2 [ i ];
+      double mixedPermeability = MilliDarcyToM2 * SimdMaths::pow ( permeabilities1 [ i ] / permeabilities2 [ i ], fractionLithology1 ) * permeabilities2 [ i ];
       permeabilityNormal [ i ] = mixedPermeability;
       permeabilityPlane [ i ] = mixedAnisotropy * mixedPermeability;
    }
@@ -408,12 +410,12 @@ inline void GeoPhysics::PermeabilityMixer::mixThreeHomogeneous ( const unsigned
 
    double mixedAnisotropy = std::pow ( permeabilityAnisotropy1 / permeabilityAnisotropy3, fractionLithology1 ) *
                             std::pow ( permeabilityAnisotropy2 / permeabilityAnisotropy3, fractionLithology2 ) * permeabilityAnisotropy3;
-   double mixedPermeability;
 
    // The permeability cannot be zero
+   ARRAY_SIMD_LOOP
    for ( unsigned int i = 0; i < size; ++i ) {
       double invPerm3 = 1.0 / permeabilities3 [ i ];
-      mixedPermeability = MilliDarcyToM2 * ( std::pow ( permeabilities1 [ i ] * invPerm3, fractionLithology1 ) * std::pow ( permeabilities2 [ i ] * invPerm3, fractionLithology2 ) * permeabilities3 [ i ]);
+      double mixedPermeability = MilliDarcyToM2 * ( SimdMaths::pow ( permeabilities1 [ i ] * invPerm3, fractionLithology1 ) * SimdMaths::pow ( permeabilities2 [ i ] * invPerm3, fractionLithology2 ) * permeabilities3 [ i ]);
       permeabilityNormal [ i ] = mixedPermeability;
       permeabilityPlane [ i ] = mixedAnisotropy * mixedPermeability;
    }
@@ -430,16 +432,13 @@ inline void GeoPhysics::PermeabilityMixer::mixTwoLayeringIndexZero ( const unsig
    ArrayDefs::Real_ptr permeabilities1 = simplePermeabilities.getData ( 0 );
    ArrayDefs::Real_ptr permeabilities2 = simplePermeabilities.getData ( 1 );
 
-   double k21;
-   double normal;
-   double plane;
-
+   ARRAY_SIMD_LOOP
    for ( unsigned int i = 0; i < size; ++i ) {
-      k21 = std::cbrt ( permeabilities2 [ i ] / permeabilities1 [ i ]);
-      normal = 1.0 + m_percentRatio2 * k21;
+      double k21 = SimdMaths::cbrt ( permeabilities2 [ i ] / permeabilities1 [ i ]);
+      double normal = 1.0 + m_percentRatio2 * k21;
       permeabilityNormal [ i ] = normal * normal * normal * permeabilities1 [ i ] * m_percentPowerNormal * MilliDarcyToM2;
 
-      plane = 1.0 + m_percentRatio2 * m_anisoRatioExp2 * k21;
+      double plane = 1.0 + m_percentRatio2 * m_anisoRatioExp2 * k21;
       permeabilityPlane [ i ] = plane * plane * plane * m_percentPowerPlane * permeabilityAnisotropy1 * permeabilities1 [ i ] * MilliDarcyToM2;
    }
 
@@ -456,20 +455,15 @@ inline void GeoPhysics::PermeabilityMixer::mixThreeLayeringIndexZero ( const uns
    ArrayDefs::Real_ptr permeabilities2 = simplePermeabilities.getData ( 1 );
    ArrayDefs::Real_ptr permeabilities3 = simplePermeabilities.getData ( 2 );
 
-   double k21;
-   double k31;
-   double normal;
-   double plane;
-   double k1Inv;
-
+   ARRAY_SIMD_LOOP
    for ( unsigned int i = 0; i < size; ++i ) {
-      k1Inv = permeabilities1 [ i ];
-      k21 = std::cbrt ( permeabilities2 [ i ] / k1Inv );
-      k31 = std::cbrt ( permeabilities3 [ i ] / k1Inv );
-      normal = 1.0 + m_percentRatio2 * k21 + m_percentRatio3 * k31;
+      double k1Inv = permeabilities1 [ i ];
+      double k21 = SimdMaths::cbrt ( permeabilities2 [ i ] / k1Inv );
+      double k31 = SimdMaths::cbrt ( permeabilities3 [ i ] / k1Inv );
+      double normal = 1.0 + m_percentRatio2 * k21 + m_percentRatio3 * k31;
       permeabilityNormal [ i ] = normal * normal * normal * permeabilities1 [ i ] * m_percentPowerNormal * MilliDarcyToM2;
 
-      plane = 1.0 + m_percentRatio2 * m_anisoRatioExp2 * k21 + m_percentRatio3 * m_anisoRatioExp3 * k31;
+      double plane = 1.0 + m_percentRatio2 * m_anisoRatioExp2 * k21 + m_percentRatio3 * m_anisoRatioExp3 * k31;
       permeabilityPlane [ i ] = plane * plane * plane * m_percentPowerPlane * permeabilityAnisotropy1 * permeabilities1 [ i ] * MilliDarcyToM2;
    }
 
@@ -487,13 +481,11 @@ inline void GeoPhysics::PermeabilityMixer::mixTwoLayeringIndexQuarter ( const un
    ArrayDefs::Real_ptr permeabilities1 = simplePermeabilities.getData ( 0 );
    ArrayDefs::Real_ptr permeabilities2 = simplePermeabilities.getData ( 1 );
 
-   double perm;
-   double permRatio;
-
+   ARRAY_SIMD_LOOP
    for ( unsigned int i = 0; i < size; ++i ) {
-      permRatio = permeabilities2 [ i ] / permeabilities1 [ i ];
-      permeabilityNormal [ i ] = MilliDarcyToM2 * std::pow ( permRatio, fractionLithology2 ) * permeabilities1 [ i ];
-      perm = 1.0 + m_percentRatio2 * m_anisoRatioExp2 * std::sqrt ( permRatio );
+      double permRatio = permeabilities2 [ i ] / permeabilities1 [ i ];
+      permeabilityNormal [ i ] = MilliDarcyToM2 * SimdMaths::pow ( permRatio, fractionLithology2 ) * permeabilities1 [ i ];
+      double perm = 1.0 + m_percentRatio2 * m_anisoRatioExp2 * std::sqrt ( permRatio );
       // m_percentPowerPlane := fraction1 * fraction1
       permeabilityPlane [ i ] = MilliDarcyToM2 * perm * perm * permeabilities1 [ i ] * permeabilityAnisotropy1 * m_percentPowerPlane;
    }
@@ -514,17 +506,14 @@ inline void GeoPhysics::PermeabilityMixer::mixThreeLayeringIndexQuarter ( const
    ArrayDefs::Real_ptr permeabilities2 = simplePermeabilities.getData ( 1 );
    ArrayDefs::Real_ptr permeabilities3 = simplePermeabilities.getData ( 2 );
 
-   double perm;
-   double permRatio21;
-   double permRatio31;
-
+   ARRAY_SIMD_LOOP
    for ( unsigned int i = 0; i < size; ++i ) {
-      permRatio21 = permeabilities2 [ i ] / permeabilities1 [ i ];
-      permRatio31 = permeabilities3 [ i ] / permeabilities1 [ i ];
+      double permRatio21 = permeabilities2 [ i ] / permeabilities1 [ i ];
+      double permRatio31 = permeabilities3 [ i ] / permeabilities1 [ i ];
 
-      permeabilityNormal [ i ] = MilliDarcyToM2 * std::pow ( permRatio21, fractionLithology2 ) * std::pow ( permRatio31, fractionLithology3 ) * permeabilities1 [ i ];
+      permeabilityNormal [ i ] = MilliDarcyToM2 * SimdMaths::pow ( permRatio21, fractionLithology2 ) * SimdMaths::pow ( permRatio31, fractionLithology3 ) * permeabilities1 [ i ];
 
-      perm = 1.0 + m_percentRatio2 * m_anisoRatioExp2 * std::sqrt ( permRatio21 ) + m_percentRatio3 * m_anisoRatioExp3 * std::sqrt ( permRatio31 );
+      double perm = 1.0 + m_percentRatio2 * m_anisoRatioExp2 * std::sqrt ( permRatio21 ) + m_percentRatio3 * m_anisoRatioExp3 * std::sqrt ( permRatio31 );
       permeabilityPlane [ i ] = MilliDarcyToM2 * perm * perm * permeabilities1 [ i ] * permeabilityAnisotropy1 * m_percentPowerPlane;
    }
 
@@ -542,17 +531,15 @@ inline void GeoPhysics::PermeabilityMixer::mixTwoLayeringIndexGeneral ( const un
    ArrayDefs::Real_ptr permeabilities1 = simplePermeabilities.getData ( 0 );
    ArrayDefs::Real_ptr permeabilities2 = simplePermeabilities.getData ( 1 );
 
-   double permRatio;
-   double permRatioExp;
-
+   ARRAY_SIMD_LOOP
    for ( unsigned int i = 0; i < size; ++i ) {
-      permRatio = permeabilities2 [ i ] / permeabilities1 [ i ];
-      permRatioExp = std::pow(permRatio, m_mixHorizonExp);
+      double permRatio = permeabilities2 [ i ] / permeabilities1 [ i ];
+      double permRatioExp = SimdMaths::pow(permRatio, m_mixHorizonExp);
 
-      permeabilityNormal [ i ] = std::pow ( 1.0 + m_percentRatio2 * permRatio / (permRatioExp * permRatioExp ), m_inverseMixVerticalExp );
+      permeabilityNormal [ i ] = SimdMaths::pow ( 1.0 + m_percentRatio2 * permRatio / (permRatioExp * permRatioExp ), m_inverseMixVerticalExp );
       permeabilityNormal [ i ] *= m_percentPowerNormal * permeabilities1 [ i ] * MilliDarcyToM2;
 
-      permeabilityPlane  [ i ] = std::pow( 1.0 + m_percentRatio2 * m_anisoRatioExp2 * permRatioExp,  m_inverseMixHorizonExp );
+      permeabilityPlane  [ i ] = SimdMaths::pow( 1.0 + m_percentRatio2 * m_anisoRatioExp2 * permRatioExp,  m_inverseMixHorizonExp );
       permeabilityPlane  [ i ] *= m_percentPowerPlane * permeabilityAnisotropy1 * permeabilities1 [ i ] * MilliDarcyToM2;
    }
 
@@ -569,24 +556,19 @@ inline void GeoPhysics::PermeabilityMixer::mixThreeLayeringIndexGeneral ( const
    ArrayDefs::Real_ptr permeabilities2 = simplePermeabilities.getData ( 1 );
    ArrayDefs::Real_ptr permeabilities3 = simplePermeabilities.getData ( 2 );
 
-   double perm1Inv;
-   double permRatio21;
-   double permRatio31;
-   double permRatio21Exp;
-   double permRatio31Exp;
-
+   ARRAY_SIMD_LOOP
    for ( unsigned int i = 0; i < size; ++i ) {
-      perm1Inv = 1.0 / permeabilities1 [ i ];
-      permRatio21 = permeabilities2 [ i ] * perm1Inv;
-      permRatio31 = permeabilities3 [ i ] * perm1Inv;
+      double perm1Inv = 1.0 / permeabilities1 [ i ];
+      double permRatio21 = permeabilities2 [ i ] * perm1Inv;
+      double permRatio31 = permeabilities3 [ i ] * perm1Inv;
 
-      permRatio21Exp = std::pow ( permRatio21, m_mixHorizonExp );
-      permRatio31Exp = std::pow ( permRatio31, m_mixHorizonExp );
+      double permRatio21Exp = SimdMaths::pow ( permRatio21, m_mixHorizonExp );
+      double permRatio31Exp = SimdMaths::pow ( permRatio31, m_mixHorizonExp );
 
-      permeabilityNormal [ i ] = std::pow ( 1.0 + m_percentRatio2 * permRatio21 / (permRatio21Exp * permRatio21Exp ) + m_percentRatio3 * permRatio31 / (permRatio31Exp * permRatio31Exp ), m_inverseMixVerticalExp );
+      permeabilityNormal [ i ] = SimdMaths::pow ( 1.0 + m_percentRatio2 * permRatio21 / (permRatio21Exp * permRatio21Exp ) + m_percentRatio3 * permRatio31 / (permRatio31Exp * permRatio31Exp ), m_inverseMixVerticalExp );
       permeabilityNormal [ i ] *= m_percentPowerNormal * permeabilities1 [ i ] * MilliDarcyToM2;
 
-      permeabilityPlane  [ i ] = std::pow( 1.0 + m_percentRatio2 * m_anisoRatioExp2 * permRatio21Exp + m_percentRatio3 * m_anisoRatioExp3 * permRatio31Exp,  m_inverseMixHorizonExp );
+      permeabilityPlane  [ i ] = SimdMaths::pow( 1.0 + m_percentRatio2 * m_anisoRatioExp2 * permRatio21Exp + m_percentRatio3 * m_anisoRatioExp3 * permRatio31Exp,  m_inverseMixHorizonExp );
       permeabilityPlane  [ i ] *= m_percentPowerPlane * permeabilityAnisotropy1 * permeabilities1 [ i ] * MilliDarcyToM2;
 
    }
@@ -601,6 +583,7 @@ void GeoPhysics::PermeabilityMixer::mixPermeabilityArrayOneLitho ( const unsigne
    ArrayDefs::Real_ptr permeabilities1 = simplePermeabilities.getData ( 0 );
    double permeabilityAnisotropy = m_anisotropies [ 0 ];
 
+   ARRAY_SIMD_LOOP
    for ( unsigned int i = 0; i < size; ++i ) {
       permeabilityNormal [ i ] = permeabilities1 [ i ] * MilliDarcyToM2;
       permeabilityPlane [ i ] = permeabilityAnisotropy * permeabilities1 [ i ] * MilliDarcyToM2;
@@ -11,11 +11,7 @@
 #define GEOPHYSICS__PERMEABILITY_MIXER__H
 
 // Access to STL
-#ifdef _MSC_VER
 #include <array>
-#else
-#include <tr1/array>
-#endif
 
 #include <vector>
 
@@ -475,3 +475,44 @@ TEST ( BrineDensity, testing_derivative_pressure_exact_values_vec )
    AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::free( pres );
    AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::free( densDers );
 }
+
+
+/// Testing that the vector interface gives the values of the scalar interface for batches
+/// mixing all phases, across (but also outside the allowed range of) the parameter space.
+TEST ( BrineDensity, testing_density_vector_against_scalar )
+{
+   const int n = 64;
+   ArrayDefs::Real_ptr temp = AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::allocate ( n );
+   ArrayDefs::Real_ptr pres = AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::allocate ( n );
+   ArrayDefs::Real_ptr dens = AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::allocate ( n );
+
+   for ( int j=0; j<=8; ++j )
+   {
+      GeoPhysics::Brine::PhaseStateVec phases( n, 0.05*double(j) );
+      GeoPhysics::Brine::PhaseStateScalar phase( 0.05*double(j) );
+      GeoPhysics::Brine::Density density;
+
+      for ( int i=0; i<=250; ++i )
+      {
+         // Temperatures from below the minimum to above the maximum, the pressure changing along the batch
+         for ( int k=0; k<n; ++k )
+         {
+            temp[k] = -100.0 + 1700.0 * double(k) / double(n-1);
+            pres[k] = -1.0 + 0.85 * double(i) + 0.5 * double(k % 7);
+            dens[k] = 0.0;
+         }
+         phases.set( n, temp, pres );
+         density.get( phases, dens );
+         for ( int k=0; k<n; ++k )
+         {
+            phase.set( temp[k], pres[k] );
+            const double expected = density.get( phase );
+            EXPECT_NEAR( dens[k], expected, 1.0e-12 * expected );
+         }
+      }
+   }
+
+   AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::free( temp );
+   AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::free( pres );
+   AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::free( dens );
+}
@@ -432,3 +432,44 @@ TEST ( BrineViscosity, testing_viscosity_vector_exact_val_same_phase )
    AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::free( pres );
    AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::free( visc );
 }
+
+
+/// Testing that the vector interface gives the values of the scalar interface for batches
+/// mixing all phases, across (but also outside the allowed range of) the parameter space.
+TEST ( BrineViscosity, testing_viscosity_vector_against_scalar )
+{
+   const int n = 64;
+   ArrayDefs::Real_ptr temp = AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::allocate ( n );
+   ArrayDefs::Real_ptr pres = AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::allocate ( n );
+   ArrayDefs::Real_ptr visc = AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::allocate ( n );
+
+   for ( int j=0; j<=8; ++j )
+   {
+      GeoPhysics::Brine::PhaseStateVec phases( n, 0.05*double(j) );
+      GeoPhysics::Brine::PhaseStateScalar phase( 0.05*double(j) );
+      GeoPhysics::Brine::Viscosity viscosity( phase.getSalinity() );
+
+      for ( int i=0; i<=250; ++i )
+      {
+         // Temperatures from below the minimum to above the maximum, the pressure changing along the batch
+         for ( int k=0; k<n; ++k )
+         {
+            temp[k] = -100.0 + 1700.0 * double(k) / double(n-1);
+            pres[k] = -1.0 + 0.85 * double(i) + 0.5 * double(k % 7);
+            visc[k] = 0.0;
+         }
+         phases.set( n, temp, pres );
+         viscosity.get( phases, visc );
+         for ( int k=0; k<n; ++k )
+         {
+            phase.set( temp[k], pres[k] );
+            const double expected = viscosity.get( phase );
+            EXPECT_NEAR( visc[k], expected, 1.0e-12 * expected );
+         }
+      }
+   }
+
+   AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::free( temp );
+   AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::free( pres );
+   AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::free( visc );
+}
@@ -0,0 +1,144 @@
+//
+// Copyright (C) 2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#include "../src/PermeabilityMixer.h"
+#include "../src/GeoPhysicalConstants.h"
+#include "../../utilities/src/AlignedWorkSpaceArrays.h"
+#include "../../utilities/src/AlignedMemoryAllocator.h"
+#include "../../utilities/src/ConstantsMathematics.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace GeoPhysics;
+using Utilities::Maths::MilliDarcyToM2;
+
+typedef AlignedWorkSpaceArrays<MaximumNumberOfLithologies> PermeabilityWorkSpaceArrays;
+
+namespace
+{
+
+   const unsigned int NumberOfValues      = 4096;
+   const unsigned int NumberOfRepetitions = 100;
+
+   /// \brief Mix the permeabilities with the array and with the scalar function, compare the results and report the throughput of both.
+   void benchmarkMixing ( const std::string&                        name,
+                          const std::vector<double>&                percentages,
+                          const std::vector<double>&                anisotropies,
+                          const double                              layeringIndex,
+                          const DataAccess::Interface::MixModelType mixModel ) {
+
+      typedef std::chrono::high_resolution_clock Clock;
+
+      const size_t numberOfLithologies = percentages.size ();
+
+      PermeabilityMixer mixer;
+      mixer.reset ( percentages, anisotropies, false, layeringIndex, mixModel, false );
+
+      PermeabilityWorkSpaceArrays simplePermeabilities ( NumberOfValues );
+      ArrayDefs::Real_ptr         permeabilityNormal = AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::allocate ( NumberOfValues );
+      ArrayDefs::Real_ptr         permeabilityPlane  = AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::allocate ( NumberOfValues );
+
+      // Permeabilities between 1.0e-6 and 1.0e3 mD, different for each lithology.
+      for ( size_t l = 0; l < numberOfLithologies; ++l ) {
+
+         for ( unsigned int i = 0; i < NumberOfValues; ++i ) {
+            simplePermeabilities.getData ( l )[ i ] = std::pow ( 10.0, -6.0 + 9.0 * double (( i + 1000 * l ) % NumberOfValues ) / double ( NumberOfValues ));
+         }
+
+      }
+
+      const Clock::time_point arrayStart = Clock::now ();
+
+      for ( unsigned int r = 0; r < NumberOfRepetitions; ++r ) {
+         mixer.mixPermeabilityArray ( NumberOfValues, simplePermeabilities, permeabilityNormal, permeabilityPlane );
+      }
+
+      const double arraySeconds = std::chrono::duration<double>( Clock::now () - arrayStart ).count ();
+
+      PermeabilityMixer::FixedSizeArray permeabilities;
+      double normal = 0.0;
+      double plane = 0.0;
+      double checksum = 0.0;
+
+      const Clock::time_point scalarStart = Clock::now ();
+
+      for ( unsigned int r = 0; r < NumberOfRepetitions; ++r ) {
+
+         for ( unsigned int i = 0; i < NumberOfValues; ++i ) {
+
+            for ( size_t l = 0; l < numberOfLithologies; ++l ) {
+               permeabilities [ l ] = simplePermeabilities.getData ( l )[ i ];
+            }
+
+            mixer.mixPermeability ( permeabilities, normal, plane );
+            checksum += normal;
+         }
+
+      }
+
+      const double scalarSeconds = std::chrono::duration<double>( Clock::now () - scalarStart ).count ();
+
+      // The two paths evaluate the same mixing rules, although the expressions are arranged differently.
+      for ( unsigned int i = 0; i < NumberOfValues; ++i ) {
+
+         for ( size_t l = 0; l < numberOfLithologies; ++l ) {
+            permeabilities [ l ] = simplePermeabilities.getData ( l )[ i ];
+         }
+
+         mixer.mixPermeability ( permeabilities, normal, plane );
+
+         EXPECT_NEAR ( permeabilityNormal [ i ] / MilliDarcyToM2, normal, 1.0e-10 * normal ) << name << " at " << i;
+         EXPECT_NEAR ( permeabilityPlane  [ i ] / MilliDarcyToM2, plane,  1.0e-10 * plane  ) << name << " at " << i;
+      }
+
+      EXPECT_TRUE ( std::isfinite ( checksum ));
+
+      const double numberOfEvaluations = double ( NumberOfValues ) * double ( NumberOfRepetitions );
+
+      std::cout << std::setw ( 24 ) << std::left << name << std::right
+                << " array: "  << std::setw ( 8 ) << std::fixed << std::setprecision ( 2 ) << 1.0e-6 * numberOfEvaluations / arraySeconds  << " M/s"
+                << " scalar: " << std::setw ( 8 ) << std::fixed << std::setprecision ( 2 ) << 1.0e-6 * numberOfEvaluations / scalarSeconds << " M/s"
+                << std::endl;
+
+      AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::free ( permeabilityNormal );
+      AlignedMemoryAllocator<double, ARRAY_ALIGNMENT>::free ( permeabilityPlane );
+   }
+
+}
+
+// Timing of the array mixing against the scalar one, run with --gtest_also_run_disabled_tests
+TEST ( MixingPermeabilityArrayBenchmark, DISABLED_TwoLithologies )
+{
+   const std::vector<double> percentages  ({ 60.0, 40.0 });
+   const std::vector<double> anisotropies ({ 1.0, 2.5 });
+
+   benchmarkMixing ( "homogeneous",             percentages, anisotropies, 1.0,  DataAccess::Interface::HOMOGENEOUS );
+   benchmarkMixing ( "layered, index 0",        percentages, anisotropies, 0.0,  DataAccess::Interface::LAYERED );
+   benchmarkMixing ( "layered, index 0.25",     percentages, anisotropies, 0.25, DataAccess::Interface::LAYERED );
+   benchmarkMixing ( "layered, index 0.6",      percentages, anisotropies, 0.6,  DataAccess::Interface::LAYERED );
+}
+
+TEST ( MixingPermeabilityArrayBenchmark, DISABLED_ThreeLithologies )
+{
+   const std::vector<double> percentages  ({ 50.0, 30.0, 20.0 });
+   const std::vector<double> anisotropies ({ 1.0, 2.5, 4.0 });
+
+   benchmarkMixing ( "homogeneous",             percentages, anisotropies, 1.0,  DataAccess::Interface::HOMOGENEOUS );
+   benchmarkMixing ( "layered, index 0",        percentages, anisotropies, 0.0,  DataAccess::Interface::LAYERED );
+   benchmarkMixing ( "layered, index 0.25",     percentages, anisotropies, 0.25, DataAccess::Interface::LAYERED );
+   benchmarkMixing ( "layered, index 0.6",      percentages, anisotropies, 0.6,  DataAccess::Interface::LAYERED );
+}
@@ -8,9 +8,6 @@
 #include "AlignedMemoryAllocator.h"
 #include "CpuInfo.h"
 
-#define USE_BLAS_LIBRARY
-
-#ifdef USE_BLAS_LIBRARY
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -31,7 +28,6 @@ inline void dgemm(char transa, char transb, int m, int n, int k, double alpha, c
 inline void dgemv(char transa, int m, int n, double alpha, const double *a, int lda, const double *x, int incx, double beta, double *y, int incy) {
    dgemv_ ( &transa, &m, &n, &alpha, a, &lda, x, &incx, &beta, y, &incy );
 }
-#endif
 
 
 Numerics::AlignedDenseMatrix::AlignedDenseMatrix () : m_rows ( 0 ), m_cols ( 0 ) {
@@ -220,6 +216,37 @@ void Numerics::matmult ( const MatrixTransposeType transposeA,
 }
 
 
+namespace {
+
+   /// \brief Compute the matrix-matrix product with the instructions of the SIMD technology.
+   template <Numerics::SimdInstructionTechnology simdTechnology>
+   void technologyMatmult ( const Numerics::MatrixTransposeType transposeA,
+                            const Numerics::MatrixTransposeType transposeB,
+                            const double                        alpha,
+                            const Numerics::AlignedDenseMatrix& a,
+                            const Numerics::AlignedDenseMatrix& b,
+                            const double                        beta,
+                                  Numerics::AlignedDenseMatrix& c ) {
+
+      typedef Numerics::details::MatDetails<simdTechnology> Details;
+
+      if ( transposeA == Numerics::NO_TRANSPOSE and transposeB == Numerics::NO_TRANSPOSE ) {
+         Details::matMatProd( alpha, a, b, beta, c );
+      }
+      else if ( transposeA == Numerics::NO_TRANSPOSE and transposeB == Numerics::TRANSPOSE ) {
+         Details::matMatTransProd( alpha, a, b, beta, c );
+      }
+      else if ( transposeA == Numerics::TRANSPOSE and transposeB == Numerics::NO_TRANSPOSE ) {
+         Details::matTransMatProd( alpha, a, b, beta, c );
+      }
+      else { // if ( transposeA == TRANSPOSE and transposeB == TRANSPOSE ) {
+         Details::matTransMatTransProd( alpha, a, b, beta, c );
+      }
+
+   }
+
+}
+
 void Numerics::matmult ( const MatrixTransposeType transposeA,
                          const MatrixTransposeType transposeB,
                          const double              alpha,
@@ -228,7 +255,22 @@ void Numerics::matmult ( const MatrixTransposeType transposeA,
                          const double              beta,
                                AlignedDenseMatrix& c ) {
 
-#ifdef USE_BLAS_LIBRARY
+#ifdef NUMERICS_SIMD_MATMULT
+   simdMatmult ( transposeA, transposeB, alpha, a, b, beta, c );
+#else
+   blasMatmult ( transposeA, transposeB, alpha, a, b, beta, c );
+#endif
+
+}
+
+void Numerics::blasMatmult ( const MatrixTransposeType transposeA,
+                             const MatrixTransposeType transposeB,
+                             const double              alpha,
+                             const AlignedDenseMatrix& a,
+                             const AlignedDenseMatrix& b,
+                             const double              beta,
+                                   AlignedDenseMatrix& c ) {
+
    static const char transChar [ 2 ] = {'N', 'T'};
 
    int m;
@@ -255,56 +297,41 @@ void Numerics::matmult ( const MatrixTransposeType transposeA,
            b.data (), b.leadingDimension (),
            beta, c.data (), c.leadingDimension ());
 
-#else
-   cpuInfo cpuInfo;
-#ifdef __INTEL_COMPILER
-   if ( cpuInfo.supportAvx( ) )
-   {
-      if ( transposeA == NO_TRANSPOSE and transposeB == NO_TRANSPOSE ) {
-         details::MatDetails<SimdInstructionTechnology::AVX>::matMatProd( alpha, a, b, beta, c );
-      }
-      else if ( transposeA == NO_TRANSPOSE and transposeB == TRANSPOSE ) {
-         details::MatDetails<SimdInstructionTechnology::AVX>::matMatTransProd( alpha, a, b, beta, c );
-      }
-      else if ( transposeA == TRANSPOSE and transposeB == NO_TRANSPOSE ) {
-         details::MatDetails<SimdInstructionTechnology::AVX>::matTransMatProd( alpha, a, b, beta, c );
-      }
-      else { // if ( transposeA == TRANSPOSE and transposeB == TRANSPOSE ) {
-         details::MatDetails<SimdInstructionTechnology::AVX>::matTransMatTransProd( alpha, a, b, beta, c );
-      }
-   }
-   else if ( cpuInfo.supportSse() )
-   {
-      if ( transposeA == NO_TRANSPOSE and transposeB == NO_TRANSPOSE ) {
-         details::MatDetails<SimdInstructionTechnology::SSE>::matMatProd( alpha, a, b, beta, c );
-      }
-      else if ( transposeA == NO_TRANSPOSE and transposeB == TRANSPOSE ) {
-         details::MatDetails<SimdInstructionTechnology::SSE>::matMatTransProd( alpha, a, b, beta, c );
-      }
-      else if ( transposeA == TRANSPOSE and transposeB == NO_TRANSPOSE ) {
-         details::MatDetails<SimdInstructionTechnology::SSE>::matTransMatProd( alpha, a, b, beta, c );
-      }
-      else { // if ( transposeA == TRANSPOSE and transposeB == TRANSPOSE ) {
-         details::MatDetails<SimdInstructionTechnology::SSE>::matTransMatTransProd( alpha, a, b, beta, c );
-      }
+}
+
+void Numerics::simdMatmult ( const MatrixTransposeType transposeA,
+                             const MatrixTransposeType transposeB,
+                             const double              alpha,
+                             const AlignedDenseMatrix& a,
+                             const AlignedDenseMatrix& b,
+                             const double              beta,
+                                   AlignedDenseMatrix& c ) {
+
+   // The processor is queried once only.
+   static const cpuInfo cpu;
+
+   // There are no AVX-512 products, the columns of the matrices are aligned on 32 bytes only.
+#ifdef NUMERICS_SIMD_AVXFMA
+   if ( cpu.supportAvx () and cpu.supportFma3 ()) {
+      technologyMatmult<SimdInstructionTechnology::AVXFMA>( transposeA, transposeB, alpha, a, b, beta, c );
+      return;
    }
-   else
 #endif
-   {
-      if ( transposeA == NO_TRANSPOSE and transposeB == NO_TRANSPOSE ) {
-         details::MatDetails<SimdInstructionTechnology::NO_SIMD>::matMatProd( alpha, a, b, beta, c );
-      }
-      else if ( transposeA == NO_TRANSPOSE and transposeB == TRANSPOSE ) {
-         details::MatDetails<SimdInstructionTechnology::NO_SIMD>::matMatTransProd( alpha, a, b, beta, c );
-      }
-      else if ( transposeA == TRANSPOSE and transposeB == NO_TRANSPOSE ) {
-         details::MatDetails<SimdInstructionTechnology::NO_SIMD>::matTransMatProd( alpha, a, b, beta, c );
-      }
-      else { // if ( transposeA == TRANSPOSE and transposeB == TRANSPOSE ) {
-         details::MatDetails<SimdInstructionTechnology::NO_SIMD>::matTransMatTransProd( alpha, a, b, beta, c );
-      }
+
+#ifdef NUMERICS_SIMD_AVX
+   if ( cpu.supportAvx ()) {
+      technologyMatmult<SimdInstructionTechnology::AVX>( transposeA, transposeB, alpha, a, b, beta, c );
+      return;
    }
+#endif
 
+#ifdef NUMERICS_SIMD_SSE
+   if ( cpu.supportSse2 ()) {
+      technologyMatmult<SimdInstructionTechnology::SSE>( transposeA, transposeB, alpha, a, b, beta, c );
+      return;
+   }
 #endif
 
+   technologyMatmult<SimdInstructionTechnology::NO_SIMD>( transposeA, transposeB, alpha, a, b, beta, c );
+
 }
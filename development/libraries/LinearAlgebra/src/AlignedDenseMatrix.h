@@ -163,6 +163,8 @@ namespace Numerics {
    /// \brief Compute the product of two matrices.
    ///
    /// \f$ c = \alpha \times \mbox{op}\left( a \right) \times \mbox{op}\left( b \right) + \beta \times c \f$
+   ///
+   /// The product is computed by blasMatmult, or by simdMatmult when the build is configured with BM_SIMD_MATMULT.
    void matmult ( const MatrixTransposeType transposeA,
                   const MatrixTransposeType transposeB,
                   const double              alpha,
@@ -171,6 +173,24 @@ namespace Numerics {
                   const double              beta,
                         AlignedDenseMatrix& c );
 
+   /// \brief Compute the product of two matrices with the BLAS library.
+   void blasMatmult ( const MatrixTransposeType transposeA,
+                      const MatrixTransposeType transposeB,
+                      const double              alpha,
+                      const AlignedDenseMatrix& a,
+                      const AlignedDenseMatrix& b,
+                      const double              beta,
+                            AlignedDenseMatrix& c );
+
+   /// \brief Compute the product of two matrices with the SIMD specialisations, the widest supported by the processor.
+   void simdMatmult ( const MatrixTransposeType transposeA,
+                      const MatrixTransposeType transposeB,
+                      const double              alpha,
+                      const AlignedDenseMatrix& a,
+                      const AlignedDenseMatrix& b,
+                      const double              beta,
+                            AlignedDenseMatrix& c );
+
    /// \brief Compute the product of two matrices.
    ///
    /// \f$ c = \alpha \times \mbox{op}\left( a \right) \times \mbox{op}\left( b \right) + \beta \times c \f$
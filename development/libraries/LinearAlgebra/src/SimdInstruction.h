@@ -62,7 +62,7 @@ namespace Numerics {
 
    };
 
-#ifdef __INTEL_COMPILER
+#ifdef NUMERICS_SIMD_SSE
    /// \brief Specialisation of SimdInstruction with SSE instruction set.
    template<>
    struct SimdInstruction<SSE> {
@@ -131,9 +131,9 @@ namespace Numerics {
       static PackedDouble mulAdd ( const PackedDouble& a, const PackedDouble& b, const PackedDouble& c );
 
    };
+#endif
 
-
-
+#ifdef NUMERICS_SIMD_AVX
    /// \brief Specialisation of SimdInstruction with AVX instruction set.
    template<>
    struct SimdInstruction<AVX> {
@@ -204,9 +204,9 @@ namespace Numerics {
       static PackedDouble mulAdd ( const PackedDouble& a, const PackedDouble& b, const PackedDouble& c );
 
    };
+#endif
 
-
-
+#ifdef NUMERICS_SIMD_AVXFMA
    /// \brief Specialisation of SimdInstruction with AVX-FMA instruction set.
    template<>
    struct SimdInstruction<AVXFMA> {
@@ -334,7 +334,7 @@ Numerics::SimdInstruction<SimdTechnology>::mulAdd ( const PackedDouble& a, const
 }
 
 
-#ifdef __INTEL_COMPILER
+#ifdef NUMERICS_SIMD_SSE
 //--------------------------------
 // SSE
 //--------------------------------
@@ -374,8 +374,10 @@ inline Numerics::SimdInstruction<Numerics::SSE>::PackedDouble
 Numerics::SimdInstruction<Numerics::SSE>::mulAdd ( const PackedDouble& a, const PackedDouble& b, const PackedDouble& c ) {
    return _mm_add_pd ( c, _mm_mul_pd ( a, b ));
 }
+#endif
 
 
+#ifdef NUMERICS_SIMD_AVX
 //--------------------------------
 // AVX
 //--------------------------------
@@ -416,8 +418,10 @@ inline Numerics::SimdInstruction<Numerics::AVX>::PackedDouble
 Numerics::SimdInstruction<Numerics::AVX>::mulAdd ( const PackedDouble& a, const PackedDouble& b, const PackedDouble& c ) {
    return _mm256_add_pd ( c, _mm256_mul_pd ( a, b ));
 }
+#endif
 
 
+#ifdef NUMERICS_SIMD_AVXFMA
 //--------------------------------
 // AVX-FMA
 //--------------------------------
@@ -460,7 +464,6 @@ Numerics::SimdInstruction<Numerics::AVXFMA>::mulAdd ( const PackedDouble& a, con
    // comptute a * b + c
    return _mm256_fmadd_pd ( a, b, c );
 }
-
 #endif
 
 #endif // NUMERICS__SIMD_INSTRUCTION__H
@@ -4,6 +4,28 @@
 #include <xmmintrin.h>
 #include <immintrin.h>
 
+/// \def NUMERICS_SIMD_SSE
+/// \brief Defined when the SSE specialisations are available.
+///
+/// The Intel compiler accepts the SSE and AVX intrinsics whatever the target instruction set,
+/// GCC and Clang only when the target includes them, e.g. with -mavx2 -mfma (see BM_SIMD_TARGET).
+/// Whether the processor supports the instructions has to be checked at runtime with cpuInfo.
+#if defined(__INTEL_COMPILER) || defined(__SSE2__)
+#define NUMERICS_SIMD_SSE
+#endif
+
+/// \def NUMERICS_SIMD_AVX
+/// \brief Defined when the AVX specialisations are available.
+#if defined(__INTEL_COMPILER) || defined(__AVX__)
+#define NUMERICS_SIMD_AVX
+#endif
+
+/// \def NUMERICS_SIMD_AVXFMA
+/// \brief Defined when the AVX-FMA specialisations are available.
+#if defined(__INTEL_COMPILER) || ( defined(__AVX__) && defined(__FMA__))
+#define NUMERICS_SIMD_AVXFMA
+#endif
+
 
 namespace Numerics {
 
@@ -37,7 +59,7 @@ namespace Numerics {
 
    };
 
-#ifdef __INTEL_COMPILER
+#ifdef NUMERICS_SIMD_SSE
    /// \brief Specialisation of SimdTraits for SSE instructions.
    template<>
    struct SimdTraits<SSE> {
@@ -57,8 +79,9 @@ namespace Numerics {
       static const int DoubleStride = Alignment / sizeof ( double );
 
    };
+#endif
 
-
+#ifdef NUMERICS_SIMD_AVX
    /// \brief Specialisation of SimdTraits for AVX instructions.
    template<>
    struct SimdTraits<AVX> {
@@ -78,8 +101,10 @@ namespace Numerics {
       static const int DoubleStride = Alignment / sizeof ( double );
 
    };
+#endif
 
-   /// \brief Specialisation of SimdTraits for AVX instructions.
+#ifdef NUMERICS_SIMD_AVXFMA
+   /// \brief Specialisation of SimdTraits for AVX-FMA instructions.
    template<>
    struct SimdTraits<AVXFMA> {
 
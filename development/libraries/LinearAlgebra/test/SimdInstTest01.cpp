@@ -27,8 +27,7 @@ TEST ( SimdInstrTests, NoSimdTest01 ) {
 
 }
 
-#ifdef __INTEL_COMPILER
-#ifdef __SSE__
+#ifdef NUMERICS_SIMD_SSE
 TEST ( SimdInstrTests, SseTest01 ) {
 
    static const Numerics::SimdInstructionTechnology SimdUsed = Numerics::SSE;
@@ -62,7 +61,7 @@ TEST ( SimdInstrTests, SseTest01 ) {
 }
 #endif
 
-#ifdef __AVX__
+#ifdef NUMERICS_SIMD_AVX
 TEST ( SimdInstrTests, AvxTest01 ) {
 
    static const Numerics::SimdInstructionTechnology SimdUsed = Numerics::AVX;
@@ -97,4 +96,3 @@ TEST ( SimdInstrTests, AvxTest01 ) {
    delete [] a2;
 }
 #endif
-#endif
@@ -39,8 +39,7 @@ TEST ( SimdInstrTests, NoSimdTest02 ) {
 
 }
 
-#ifdef __INTEL_COMPILER
-#ifdef __SSE__
+#ifdef NUMERICS_SIMD_SSE
 TEST ( SimdInstrTests, SseTest02 ) {
 
    static const Numerics::SimdInstructionTechnology SimdUsed = Numerics::SSE;
@@ -82,7 +81,7 @@ TEST ( SimdInstrTests, SseTest02 ) {
 }
 #endif
 
-#ifdef __AVX__
+#ifdef NUMERICS_SIMD_AVX
 TEST ( SimdInstrTests, AvxTest02 ) {
 
    static const Numerics::SimdInstructionTechnology SimdUsed = Numerics::AVX;
@@ -91,7 +90,7 @@ TEST ( SimdInstrTests, AvxTest02 ) {
    typedef Numerics::SimdInstruction<SimdUsed> SimdInstruction;
 
 
-   typedef array<double, SimdTraits::DoubleStride> DoubleArray;
+   typedef std::array<double, SimdTraits::DoubleStride> DoubleArray;
 
    double value1 = 2.5;
    double value2 = 3.25;
@@ -129,4 +128,3 @@ TEST ( SimdInstrTests, AvxTest02 ) {
    EXPECT_EQ ( a[3], muladd );
 }
 #endif
-#endif
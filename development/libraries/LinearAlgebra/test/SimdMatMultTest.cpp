@@ -0,0 +1,200 @@
+#include "../src/SimdTraits.h"
+#include "../src/SimdInstruction.h"
+#include "../src/AlignedDenseMatrix.h"
+#include "../src/MatMultDetails.h"
+#include "../../utilities/src/CpuInfo.h"
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <cmath>
+
+#ifdef _WIN32
+double drand48 () {
+   return static_cast<double>(rand ()) / static_cast<double>(RAND_MAX+1);
+}
+#endif
+
+using namespace Numerics;
+
+namespace {
+
+   // Sizes of the matrices, chosen so that the number of rows is not a multiple of the simd stride.
+   const int n1 = 8;
+   const int n2 = 27;
+   const int n3 = 13;
+
+   // Fill the matrix with random values.
+   void randomise ( AlignedDenseMatrix& mat ) {
+
+      for ( int j = 0; j < mat.cols (); ++j ) {
+
+         for ( int i = 0; i < mat.rows (); ++i ) {
+            mat ( i, j ) = drand48 ();
+         }
+
+      }
+
+   }
+
+   // Compute c = alpha op(a) op(b) + beta c with the simd technology.
+   template <SimdInstructionTechnology simdTechnology>
+   void matmult ( const MatrixTransposeType transposeA,
+                  const MatrixTransposeType transposeB,
+                  const double              alpha,
+                  const AlignedDenseMatrix& a,
+                  const AlignedDenseMatrix& b,
+                  const double              beta,
+                        AlignedDenseMatrix& c ) {
+
+      typedef details::MatDetails<simdTechnology> Details;
+
+      if ( transposeA == NO_TRANSPOSE and transposeB == NO_TRANSPOSE ) {
+         Details::matMatProd ( alpha, a, b, beta, c );
+      } else if ( transposeA == NO_TRANSPOSE and transposeB == TRANSPOSE ) {
+         Details::matMatTransProd ( alpha, a, b, beta, c );
+      } else if ( transposeA == TRANSPOSE and transposeB == NO_TRANSPOSE ) {
+         Details::matTransMatProd ( alpha, a, b, beta, c );
+      } else {
+         Details::matTransMatTransProd ( alpha, a, b, beta, c );
+      }
+
+   }
+
+   // Compare the product computed with the simd technology with that computed without simd instructions.
+   //
+   // The order of the operations and the use of fused multiply-add may differ,
+   // so the results are expected to be equal up to round-off only.
+   template <SimdInstructionTechnology simdTechnology>
+   void compareWithScalar ( const MatrixTransposeType transposeA,
+                            const MatrixTransposeType transposeB ) {
+
+      AlignedDenseMatrix a ( transposeA == NO_TRANSPOSE ? n1 : n2, transposeA == NO_TRANSPOSE ? n2 : n1 );
+      AlignedDenseMatrix b ( transposeB == NO_TRANSPOSE ? n2 : n3, transposeB == NO_TRANSPOSE ? n3 : n2 );
+      AlignedDenseMatrix c ( n1, n3 );
+
+      randomise ( a );
+      randomise ( b );
+      randomise ( c );
+
+      AlignedDenseMatrix expected ( c );
+
+      matmult<NO_SIMD>       ( transposeA, transposeB, 1.5, a, b, 0.5, expected );
+      matmult<simdTechnology>( transposeA, transposeB, 1.5, a, b, 0.5, c );
+
+      for ( int i = 0; i < n1; ++i ) {
+
+         for ( int j = 0; j < n3; ++j ) {
+            EXPECT_NEAR ( expected ( i, j ), c ( i, j ), std::abs ( expected ( i, j )) * 1.0e-13 );
+         }
+
+      }
+
+   }
+
+   template <SimdInstructionTechnology simdTechnology>
+   void compareAllVariants () {
+      compareWithScalar<simdTechnology>( NO_TRANSPOSE, NO_TRANSPOSE );
+      compareWithScalar<simdTechnology>( NO_TRANSPOSE, TRANSPOSE );
+      compareWithScalar<simdTechnology>( TRANSPOSE,    NO_TRANSPOSE );
+      compareWithScalar<simdTechnology>( TRANSPOSE,    TRANSPOSE );
+   }
+
+   const cpuInfo& getCpuInfo () {
+      static const cpuInfo cpu;
+      return cpu;
+   }
+
+}
+
+#ifdef NUMERICS_SIMD_SSE
+TEST ( SimdMatrixMultiply, Sse ) {
+
+   if ( not getCpuInfo ().supportSse2 ()) {
+      return;
+   }
+
+   compareAllVariants<SSE>();
+}
+#endif
+
+#ifdef NUMERICS_SIMD_AVX
+TEST ( SimdMatrixMultiply, Avx ) {
+
+   if ( not getCpuInfo ().supportAvx ()) {
+      return;
+   }
+
+   compareAllVariants<AVX>();
+}
+#endif
+
+#ifdef NUMERICS_SIMD_AVXFMA
+TEST ( SimdMatrixMultiply, AvxFma ) {
+
+   if ( not getCpuInfo ().supportAvx () or not getCpuInfo ().supportFma3 ()) {
+      return;
+   }
+
+   compareAllVariants<AVXFMA>();
+}
+#endif
+
+//
+// The products computed with BLAS and with the SIMD specialisations, either of which is used by matmult, are the same up to round-off.
+//
+TEST ( SimdMatrixMultiply, BlasAndSimd ) {
+
+   for ( const MatrixTransposeType transposeA : { NO_TRANSPOSE, TRANSPOSE }) {
+
+      for ( const MatrixTransposeType transposeB : { NO_TRANSPOSE, TRANSPOSE }) {
+         AlignedDenseMatrix a ( transposeA == NO_TRANSPOSE ? n1 : n2, transposeA == NO_TRANSPOSE ? n2 : n1 );
+         AlignedDenseMatrix b ( transposeB == NO_TRANSPOSE ? n2 : n3, transposeB == NO_TRANSPOSE ? n3 : n2 );
+         AlignedDenseMatrix c ( n1, n3 );
+
+         randomise ( a );
+         randomise ( b );
+         randomise ( c );
+
+         AlignedDenseMatrix expected ( c );
+
+         Numerics::blasMatmult ( transposeA, transposeB, 1.5, a, b, 0.5, expected );
+         Numerics::simdMatmult ( transposeA, transposeB, 1.5, a, b, 0.5, c );
+
+         for ( int i = 0; i < n1; ++i ) {
+
+            for ( int j = 0; j < n3; ++j ) {
+               EXPECT_NEAR ( expected ( i, j ), c ( i, j ), std::abs ( expected ( i, j )) * 1.0e-13 ) << transposeA << " " << transposeB;
+            }
+
+         }
+
+      }
+
+   }
+
+}
+
+//
+// The product computed by matmult, whichever technology it uses, is compared with the scalar product.
+//
+TEST ( SimdMatrixMultiply, Dispatch ) {
+
+   AlignedDenseMatrix a ( n1, n2 );
+   AlignedDenseMatrix b ( n2, n3 );
+   AlignedDenseMatrix c ( n1, n3 );
+   AlignedDenseMatrix expected ( n1, n3 );
+
+   randomise ( a );
+   randomise ( b );
+
+   matmult<NO_SIMD> ( NO_TRANSPOSE, NO_TRANSPOSE, 1.0, a, b, 0.0, expected );
+   Numerics::matmult ( NO_TRANSPOSE, NO_TRANSPOSE, 1.0, a, b, 0.0, c );
+
+   for ( int i = 0; i < n1; ++i ) {
+
+      for ( int j = 0; j < n3; ++j ) {
+         EXPECT_NEAR ( expected ( i, j ), c ( i, j ), std::abs ( expected ( i, j )) * 1.0e-13 );
+      }
+
+   }
+
+}
@@ -7,8 +7,7 @@ TEST ( SimdTraitTests, NoSimdTest ) {
    EXPECT_EQ ( true, sizeof ( Numerics::SimdTraits<Numerics::NO_SIMD>::PackedDouble ) == sizeof (double));
 }
 
-#ifdef __INTEL_COMPILER
-#ifdef __SSE__
+#ifdef NUMERICS_SIMD_SSE
 TEST ( SimdTraitTests, SseTest ) {
    EXPECT_EQ ( true, Numerics::SimdTraits<Numerics::SSE>::Alignment == 2 * sizeof (double));
    EXPECT_EQ ( true, Numerics::SimdTraits<Numerics::SSE>::DoubleStride == 2 );
@@ -16,11 +15,19 @@ TEST ( SimdTraitTests, SseTest ) {
 }
 #endif
 
-#ifdef __AVX__
+#ifdef NUMERICS_SIMD_AVX
 TEST ( SimdTraitTests, AvxTest ) {
    EXPECT_EQ ( true, Numerics::SimdTraits<Numerics::AVX>::Alignment == 4 * sizeof (double));
    EXPECT_EQ ( true, Numerics::SimdTraits<Numerics::AVX>::DoubleStride == 4 );
    EXPECT_EQ ( true, sizeof ( Numerics::SimdTraits<Numerics::AVX>::PackedDouble ) == 4 * sizeof (double));
 }
 #endif
+
+#ifdef NUMERICS_SIMD_AVXFMA
+TEST ( SimdTraitTests, AvxFmaTest ) {
+   EXPECT_EQ ( true, Numerics::SimdTraits<Numerics::AVXFMA>::Alignment == 4 * sizeof (double));
+   EXPECT_EQ ( true, Numerics::SimdTraits<Numerics::AVXFMA>::DoubleStride == 4 );
+   EXPECT_EQ ( true, sizeof ( Numerics::SimdTraits<Numerics::AVXFMA>::PackedDouble ) == 4 * sizeof (double));
+}
 #endif
+
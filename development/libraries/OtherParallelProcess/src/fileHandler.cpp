@@ -3,6 +3,7 @@
 #include "stdlib.h"
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 #include "hdf5.h"
 #include "fileHandler.h"
@@ -10,21 +11,6 @@
 #include "H5FDmpio.h"
 //#define SAFE_RUN 1
 
-bool errorFlag = false;
-
-void reduce_op( float *invec, float *inoutvec, int *len, MPI_Datatype *datatype ) {
-
-  for( int i = 0; i < * len; ++ i ) {
-
-    if( invec[i] != 0 ) {
-      if( inoutvec[i] != 0 ) {
-        errorFlag = true;
-      }
-      inoutvec[i] = invec[i];
-    }
-  }
-}
-
 void FileHandler::openLocalFile( hid_t fileAccessPList ) {
 
   m_localFileId = H5Fopen( m_fileName.c_str(), H5F_ACC_RDONLY, fileAccessPList );
@@ -33,34 +19,38 @@ void FileHandler::openLocalFile( hid_t fileAccessPList ) {
 
 void FileHandler::openGlobalFile () {
 
-  if( m_rank == 0 ) {
-    m_globalFileId = H5Fcreate( m_fileName.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT );
-  }
+  // All processes create the global file and write their own hyperslabs into it
+  hid_t fileAccessPList = H5Pcreate( H5P_FILE_ACCESS );
+  H5Pset_fapl_mpio( fileAccessPList, m_comm, MPI_INFO_NULL );
 
+  m_globalFileId = H5Fcreate( m_fileName.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fileAccessPList );
+
+  H5Pclose( fileAccessPList );
 }
 
 hid_t FileHandler::closeGlobalFile() {
-  if( m_rank == 0 ) {
-    return H5Fclose( m_globalFileId );
-  }
-  return 0;
+  return H5Fclose( m_globalFileId );
 }
 
 void FileHandler::createGroup( const char* name ) {
 
-  if( m_rank == 0 ) {
-    // Greate a group in the global file
-    m_groupId = H5Gcreate( m_globalFileId, name,  H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+  // Greate a group in the global file (collective)
+  m_groupId = H5Gcreate( m_globalFileId, name,  H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
 
-    if( m_groupId < 0 ) {
-      std::cout << " ERROR Cannot open or create the group " << name << std::endl;
-    }
+  if( m_groupId < 0 && m_rank == 0 ) {
+    std::cout << " ERROR Cannot open or create the group " << name << std::endl;
   }
 }
 
 void FileHandler::closeSpaces( ) {
-  H5Sclose( m_filespace );
-  H5Sclose( m_memspace );
+  if( m_filespace != H5P_DEFAULT ) {
+    H5Sclose( m_filespace );
+    m_filespace = H5P_DEFAULT;
+  }
+  if( m_memspace != H5P_DEFAULT ) {
+    H5Sclose( m_memspace );
+    m_memspace = H5P_DEFAULT;
+  }
 }
 
 void FileHandler::closeGlobalDset( ) {
@@ -78,26 +68,47 @@ void FileHandler::writeAttributes( ) {
 
 void FileHandler::createDataset( const char* name , hid_t dtype ) {
 
-  if( m_rank == 0 ) {
+  // Create the global dataset (collective)
+  hid_t globalSpace = H5Screate_simple( m_spatialDimension, m_dimensions, NULL );
 
-    // Write the global data into the global file
-    m_memspace = H5Screate_simple( m_spatialDimension, m_count, NULL );
+  if( m_groupId != H5P_DEFAULT ) {
+    // Dataset is under the sub-group
+    m_global_dset_id = H5Dcreate( m_groupId, name, dtype, globalSpace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+  } else {
+    // Dataset is under the main group
+    m_global_dset_id = H5Dcreate( m_globalFileId, name, dtype, globalSpace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+  }
 
-    if( m_groupId != H5P_DEFAULT ) {
-      // Dataset is under the sub-group
-      m_global_dset_id = H5Dcreate( m_groupId, name, dtype, m_memspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
-    } else {
-      // Dataset is under the main group
-      m_global_dset_id = H5Dcreate( m_globalFileId, name, dtype, m_memspace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
-    }
+  H5Sclose( globalSpace );
 
-    if( m_global_dset_id < 0 ) {
-      std::cout << " ERROR Cannot create the group" << name << std::endl;
-    }
-    m_filespace = H5Dget_space( m_global_dset_id );
+  if( m_global_dset_id < 0 && m_rank == 0 ) {
+    std::cout << " ERROR Cannot create the dataset " << name << std::endl;
+  }
+}
+
+herr_t FileHandler::writeDataset( hid_t dtype, const void * buffer ) {
+
+  hsize_t valNumber = 1;
+  for( int d = 0; d < m_spatialDimension; ++ d ) {
+    valNumber *= m_count[d];
+  }
+
+  // Every process writes its own hyperslab (possibly empty) into the global dataset
+  m_filespace = H5Dget_space( m_global_dset_id );
+  m_memspace  = H5Screate_simple( 1, &valNumber, NULL );
+
+  if( valNumber > 0 ) {
     H5Sselect_hyperslab( m_filespace, H5S_SELECT_SET, m_offset, NULL, m_count, NULL );
+  } else {
+    H5Sselect_none( m_filespace );
+    H5Sselect_none( m_memspace );
   }
 
+  herr_t status = H5Dwrite( m_global_dset_id, dtype, m_memspace, m_filespace, m_transferPList, buffer );
+
+  closeSpaces();
+
+  return status;
 }
 
 void FileHandler::setSpatialDimension( int dimension ) {
@@ -131,14 +142,10 @@ bool FileHandler::mergeFiles( const bool appendRank ) {
   }
   openGlobalFile();
 
-  if( m_rank == 0 && m_globalFileId < 0 ) {
-    std::cout << " ERROR Cannot open or create the global file " << m_fileName << std::endl;
-    status = 1;
-  }
-
-  MPI_Bcast( &status, 1, MPI_INT, 0, m_comm );
-
-  if( status > 0 ) {
+  if( checkError( m_globalFileId ) < 0 ) {
+    if( m_rank == 0 ) {
+      std::cout << " ERROR Cannot open or create the global file " << m_fileName << std::endl;
+    }
     // global file cannot be created
     H5Fclose( m_localFileId );
     if( m_rank == 0 ) {
@@ -154,9 +161,7 @@ bool FileHandler::mergeFiles( const bool appendRank ) {
 
   close_status = checkError( status );
 
-  status = closeGlobalFile();
-
-  MPI_Bcast( &status, 1, MPI_INT, 0, m_comm );
+  status = checkError( closeGlobalFile() );
 
   if( status < 0 || close_status < 0 || iteration_status < 0 ) {
     if( m_rank == 0 ) {
@@ -182,16 +187,18 @@ FileHandler::FileHandler ( MPI_Comm comm, const std::string & fileName, const st
     m_dimensions [d] = 0;
   }
 
-  MPI_Op_create(( MPI_User_function *)reduce_op, true, &m_op );
+  m_transferPList = H5Pcreate( H5P_DATASET_XFER );
+  H5Pset_dxpl_mpio( m_transferPList, H5FD_MPIO_COLLECTIVE );
 }
 
 FileHandler::~FileHandler() {
 
-  MPI_Op_free ( &m_op );
+  H5Pclose ( m_transferPList );
 }
 
 herr_t FileHandler::reallocateBuffers ( ssize_t dataSize ) {
 
+  // buffers hold the local hyperslab (m_count) only
   size_t valNumber = 0;
   size_t valCount  = 0;
 
@@ -199,16 +206,15 @@ herr_t FileHandler::reallocateBuffers ( ssize_t dataSize ) {
     valNumber = 1;
 
     for (int d = 0; d < m_spatialDimension && d < MAX_FILE_DIMENSION; ++d) {
-      m_count [d] = m_dimensions[d];
       valNumber *= m_count[d];
     }
   }
 
+  valCount = valNumber * std::max<ssize_t>( 0, dataSize );
+
   if( m_spatialDimension > 1 ) {
-    m_data.resize( valNumber );
-    m_sumData.resize( valNumber );
+    m_data.resize( valCount );
   } else {
-    valCount = valNumber * dataSize;
     m_data1D.resize( valCount );
   }
   return 0;
@@ -233,6 +239,12 @@ herr_t FileHandler::readAttributes( hid_t localDataSetId, hid_t globalDataSetId
       status = H5Aget_name( localAttrId, MAX_ATTRIBUTE_NAME_SIZE, attrName );
       attrName[status] = '\0';
 
+      // The hyperslab of the process is meaningful in the local file only
+      if( strcmp( attrName, LOCAL_OFFSET_ATTRIBUTE ) == 0 || strcmp( attrName, LOCAL_COUNT_ATTRIBUTE ) == 0 ) {
+        H5Aclose( localAttrId );
+        continue;
+      }
+
       hid_t dataTypeId = H5Aget_type( localAttrId );
 
       hid_t dataSpace  = H5Aget_space( localAttrId );
@@ -305,7 +317,7 @@ void readGroup(const char* name, FileHandler* reader, void* voidReader)
   // Iterate over the members of the group
   H5Giterate ( reader-> m_localFileId, groupName.str().c_str(), nullptr, readDataset, voidReader );
 
-  if( reader->m_rank == 0 ) {
+  if( reader->m_groupId != H5P_DEFAULT ) {
     H5Gclose( reader->m_groupId );
   }
 }
@@ -366,27 +378,18 @@ herr_t readDataset ( hid_t groupId, const char* name, void * voidReader)  {
 
   // Get the dataset datatype
   hid_t   dtype    = H5Dget_type( reader->m_local_dset_id );
-  ssize_t dataSize = H5Tget_size(dtype);
 
   H5T_class_t storageTypeId = H5Tget_class( dtype );
 
   bool isFloatType = ( storageTypeId == H5T_FLOAT );
 
 #ifdef SAFE_RUN
+  ssize_t dataSize = H5Tget_size(dtype);
   if( reader->checkError ( dataSize ) < 0 || dataSize < 0 ) {
     return -1;
   }
 #endif
 
-  // Allocate data buffers
-  reader->reallocateBuffers ( dataSize );
-
-  // Read the local data
-  reader->m_memspace = H5Screate_simple( reader->m_spatialDimension, reader->m_count, NULL );
-  reader->m_filespace = H5Dget_space( reader->m_local_dset_id );
-
-  H5Sselect_hyperslab( reader->m_filespace, H5S_SELECT_SET, reader->m_offset, NULL, reader->m_count, NULL );
-
   if( reader->m_spatialDimension > 1 ) {
     if( isFloatType ) {
       status = reader->merge2D ( name, dtype );
@@ -400,91 +403,317 @@ herr_t readDataset ( hid_t groupId, const char* name, void * voidReader)  {
     status = reader->merge1D ( name, dtype );
   }
 
-  if( reader->m_rank == 0 ) {
-
-    if( status >= 0 ) {
-      reader->writeAttributes();
-    } else {
-      std::cout << " ERROR Cannot write the dataset " << name << " into the group " << reader-> m_groupName << std::endl;
-    }
-
-    H5Sclose( reader->m_filespace );
-    H5Sclose( reader->m_memspace );
+  if( status >= 0 ) {
+    reader->writeAttributes();
+  } else if( reader->m_rank == 0 ) {
+    std::cout << " ERROR Cannot write the dataset " << name << " into the group " << reader-> m_groupName << std::endl;
+  }
 
+  if( reader->m_global_dset_id >= 0 ) {
     reader->closeGlobalDset();
   }
 
+  H5Tclose( dtype );
   H5Dclose( reader->m_local_dset_id );
 
-#ifdef SAFE_RUN
-  MPI_Bcast( &status, 1, MPI_INT, 0, reader->m_comm );
-
-  if( status < 0 ) {
+  // The merge fails if it fails on any process, a negative value stops the iteration over the local file
+  if( reader->checkError( status ) < 0 ) {
     return -1;
   }
-#endif
 
   return 0;
 }
 
 herr_t FileHandler::merge1D ( const char* name, hid_t  dtype ) {
 
-  herr_t status = H5Dread ( m_local_dset_id, dtype, m_memspace, m_filespace, H5P_DEFAULT, m_data1D.data() );
+  // 1D datasets are small and identical on all processes: read it completely, rank 0 writes it
+  for( int d = 0; d < m_spatialDimension; ++ d ) {
+    m_offset[d] = 0;
+    m_count [d] = m_dimensions[d];
+  }
 
-  closeSpaces();
+  reallocateBuffers ( H5Tget_size( dtype ));
 
-  if( m_rank == 0 && status >= 0 ) {
-    createDataset( name, dtype );
+  herr_t status = H5Dread ( m_local_dset_id, dtype, H5S_ALL, H5S_ALL, H5P_DEFAULT, m_data1D.data() );
 
-    status = H5Dwrite( m_global_dset_id, dtype, m_memspace, m_filespace, H5P_DEFAULT, m_data1D.data() );
+  if( m_rank != 0 ) {
+    for( int d = 0; d < m_spatialDimension; ++ d ) {
+      m_count [d] = 0;
+    }
   }
-  return status;
+
+  createDataset( name, dtype );
+
+  herr_t writeStatus = writeDataset( dtype, m_data1D.data() );
+
+  return ( status < 0 ? status : writeStatus );
 }
 
 herr_t FileHandler::merge2D ( const char* name, hid_t dtype ) {
 
-  herr_t status = H5Dread ( m_local_dset_id, dtype, m_memspace, m_filespace, H5P_DEFAULT, m_data.data() );
+  herr_t status = findLocalHyperslab ();
 
-  if( status < 0 ) {
+  if( status >= 0 ) {
+    reallocateBuffers ( H5Tget_size( dtype ));
+
+    hsize_t valNumber = m_data.size() / H5Tget_size( dtype );
+
+    if( valNumber > 0 ) {
+      // Read the local hyperslab only
+      hid_t memspace  = H5Screate_simple( 1, &valNumber, NULL );
+      hid_t filespace = H5Dget_space( m_local_dset_id );
+
+      H5Sselect_hyperslab( filespace, H5S_SELECT_SET, m_offset, NULL, m_count, NULL );
+
+      status = H5Dread ( m_local_dset_id, dtype, memspace, filespace, H5P_DEFAULT, m_data.data() );
+
+      H5Sclose( filespace );
+      H5Sclose( memspace );
+    }
+  }
+
+  if( checkError( status ) < 0 ) {
     if( m_rank == 0 ) {
       H5Eprint ( H5E_DEFAULT, 0 );
       std::cout << "ERROR Cannot read dataset " << name << std::endl;
     }
-    return status;
+    return -1;
   }
 
-  closeSpaces();
-
-  // Collect all local data in a global array on rank 0
-  if( m_rank == 0 ) {
-    std::fill( m_sumData.begin(), m_sumData.end(), 0 );
+  if( hasOverlappingHyperslabs () ) {
+    if( m_rank == 0 ) {
+      std::cout << "Basin_Warning: Duplicated data found in " << name << " dataset" << std::endl;
+    }
   }
 
-  errorFlag = false;
+  createDataset( name, dtype );
 
-  MPI_Reduce( m_data.data(), m_sumData.data(), m_data.size(), MPI_FLOAT, m_op, 0, m_comm );
+  status = writeDataset( dtype, m_data.data() );
 
-  if( errorFlag ) {
+  if( status < 0 ) {
     if( m_rank == 0 ) {
-      std::cout << "Basin_Warning: Duplicated data found in " << name << " dataset" << std::endl;
+      H5Eprint ( H5E_DEFAULT, 0 );
+      std::cout << "ERROR Cannot write dataset " << name << std::endl;
     }
   }
+  return status;
+}
+
+bool FileHandler::readLocalHyperslab () {
+
+  if( H5Aexists( m_local_dset_id, LOCAL_OFFSET_ATTRIBUTE ) <= 0 || H5Aexists( m_local_dset_id, LOCAL_COUNT_ATTRIBUTE ) <= 0 ) {
+    return false;
+  }
+
+  hsize_t offset [MAX_FILE_DIMENSION];
+  hsize_t count  [MAX_FILE_DIMENSION];
+
+  const char * names [2] = { LOCAL_OFFSET_ATTRIBUTE, LOCAL_COUNT_ATTRIBUTE };
+  hsize_t * values [2] = { offset, count };
+
+  bool isValid = true;
+
+  for( int n = 0; n < 2 && isValid; ++ n ) {
+    hid_t attrId = H5Aopen( m_local_dset_id, names[n], H5P_DEFAULT );
+    hid_t space  = H5Aget_space( attrId );
+
+    isValid = ( attrId >= 0 && H5Sget_simple_extent_npoints( space ) == static_cast<hssize_t>( m_spatialDimension ) &&
+                H5Aread( attrId, H5T_NATIVE_HSIZE, values[n] ) >= 0 );
+
+    H5Sclose( space );
+    H5Aclose( attrId );
+  }
+
+  // The hyperslab must lie inside the dataset
+  for( int d = 0; d < m_spatialDimension && isValid; ++ d ) {
+    isValid = ( offset[d] + count[d] <= m_dimensions[d] );
+  }
+
+  if( isValid ) {
+    for( int d = 0; d < m_spatialDimension; ++ d ) {
+      m_offset[d] = offset[d];
+      m_count [d] = count[d];
+    }
+  }
+
+  return isValid;
+}
+
+herr_t FileHandler::findLocalHyperslab () {
+
+  // Written by the producer, files of older versions do not have it
+  if( readLocalHyperslab () ) {
+    return 0;
+  }
+
+  hsize_t lower [MAX_FILE_DIMENSION];
+  hsize_t upper [MAX_FILE_DIMENSION];
+
+  for( int d = 0; d < m_spatialDimension; ++ d ) {
+    lower[d] = m_dimensions[d];
+    upper[d] = 0;
+  }
+
+  // The local file spans the global domain, so the whole dataset is scanned
+  hsize_t scanOffset [MAX_FILE_DIMENSION];
+  hsize_t scanCount  [MAX_FILE_DIMENSION];
+
+  for( int d = 0; d < m_spatialDimension; ++ d ) {
+    scanOffset[d] = 0;
+    scanCount [d] = m_dimensions[d];
+  }
+
+  // Scan the region in slabs along the first dimension
+  hsize_t sliceSize = 1;
+  for( int d = 1; d < m_spatialDimension; ++ d ) {
+    sliceSize *= scanCount[d];
+  }
+
+  const hsize_t slicesPerSlab = std::max<hsize_t>( 1, MAX_SCAN_BUFFER_SIZE / std::max<hsize_t>( 1, sliceSize ));
+
+  hsize_t slabOffset [MAX_FILE_DIMENSION];
+  hsize_t slabCount  [MAX_FILE_DIMENSION];
+
+  for( int d = 0; d < m_spatialDimension; ++ d ) {
+    slabOffset[d] = scanOffset[d];
+    slabCount [d] = scanCount[d];
+  }
+
+  hid_t filespace = H5Dget_space( m_local_dset_id );
+  herr_t status = 0;
+
+  for( hsize_t first = 0; first < scanCount[0] && sliceSize > 0 && status >= 0; first += slicesPerSlab ) {
+
+    slabOffset[0] = scanOffset[0] + first;
+    slabCount [0] = std::min( slicesPerSlab, scanCount[0] - first );
+
+    hsize_t valNumber = slabCount[0] * sliceSize;
+    m_scanData.resize( valNumber );
+
+    hid_t memspace = H5Screate_simple( 1, &valNumber, NULL );
+    H5Sselect_hyperslab( filespace, H5S_SELECT_SET, slabOffset, NULL, slabCount, NULL );
+
+    status = H5Dread ( m_local_dset_id, H5T_NATIVE_FLOAT, memspace, filespace, H5P_DEFAULT, m_scanData.data() );
+
+    H5Sclose( memspace );
+
+    for( hsize_t n = 0; n < valNumber && status >= 0; ++ n ) {
 
-  if( m_rank == 0 && status >= 0 ) {
-    createDataset( name, dtype );
+      if( m_scanData[n] != 0 ) {
+        // Convert the linear index in the slab into dataset indices
+        hsize_t index = n;
+        hsize_t position [MAX_FILE_DIMENSION];
 
-    status = H5Dwrite( m_global_dset_id, dtype, m_memspace, m_filespace, H5P_DEFAULT, m_sumData.data() );
-    if( status < 0 ) {
-      if( m_rank == 0 ) {
-        H5Eprint ( H5E_DEFAULT, 0 );
-        std::cout << "ERROR Cannot write dataset " << name << std::endl;
+        for( int d = m_spatialDimension - 1; d > 0; -- d ) {
+          position[d] = scanOffset[d] + index % scanCount[d];
+          index /= scanCount[d];
+        }
+        position[0] = slabOffset[0] + index;
+
+        for( int d = 0; d < m_spatialDimension; ++ d ) {
+          lower[d] = std::min( lower[d], position[d] );
+          upper[d] = std::max( upper[d], position[d] + 1 );
+        }
       }
-      return status;
     }
   }
+
+  H5Sclose( filespace );
+
+  // Release the scan buffer, it can be large for big datasets
+  std::vector<float>().swap( m_scanData );
+
+  bool isEmpty = false;
+  for( int d = 0; d < m_spatialDimension; ++ d ) {
+    isEmpty = isEmpty || lower[d] >= upper[d];
+  }
+
+  for( int d = 0; d < m_spatialDimension; ++ d ) {
+    m_offset[d] = ( isEmpty ? 0 : lower[d] );
+    m_count [d] = ( isEmpty ? 0 : upper[d] - lower[d] );
+  }
+
   return status;
 }
 
+herr_t FileHandler::clearGlobalDataset () {
+
+  int size;
+  MPI_Comm_size( m_comm, &size );
+
+  // Every process writes zeros into an equal share of the rows of the global dataset
+  const hsize_t rows = m_dimensions[0];
+  const hsize_t firstRow = rows * m_rank / size;
+  const hsize_t lastRow  = rows * ( m_rank + 1 ) / size;
+
+  hsize_t offset [MAX_FILE_DIMENSION];
+  hsize_t count  [MAX_FILE_DIMENSION];
+
+  hsize_t valNumber = 1;
+  for( int d = 0; d < m_spatialDimension; ++ d ) {
+    offset[d] = ( d == 0 ? firstRow : 0 );
+    count [d] = ( d == 0 ? lastRow - firstRow : m_dimensions[d] );
+    valNumber *= count[d];
+  }
+
+  std::vector<float> zeros( valNumber, 0 );
+
+  hid_t filespace = H5Dget_space( m_global_dset_id );
+  hid_t memspace  = H5Screate_simple( 1, &valNumber, NULL );
+
+  if( valNumber > 0 ) {
+    H5Sselect_hyperslab( filespace, H5S_SELECT_SET, offset, NULL, count, NULL );
+  } else {
+    H5Sselect_none( filespace );
+    H5Sselect_none( memspace );
+  }
+
+  herr_t status = H5Dwrite( m_global_dset_id, H5T_NATIVE_FLOAT, memspace, filespace, m_transferPList, zeros.data() );
+
+  H5Sclose( memspace );
+  H5Sclose( filespace );
+
+  return status;
+}
+
+bool FileHandler::hasOverlappingHyperslabs () {
+
+  int size;
+  MPI_Comm_size( m_comm, &size );
+
+  const int boxSize = 2 * MAX_FILE_DIMENSION;
+
+  std::vector<unsigned long long> box ( boxSize, 0 );
+  std::vector<unsigned long long> boxes ( boxSize * size, 0 );
+
+  for( int d = 0; d < m_spatialDimension; ++ d ) {
+    box[2 * d]     = m_offset[d];
+    box[2 * d + 1] = m_offset[d] + m_count[d];
+  }
+
+  MPI_Allgather( box.data(), boxSize, MPI_UNSIGNED_LONG_LONG, boxes.data(), boxSize, MPI_UNSIGNED_LONG_LONG, m_comm );
+
+  for( int i = 0; i < size; ++ i ) {
+    for( int j = i + 1; j < size; ++ j ) {
+
+      bool overlap = true;
+
+      for( int d = 0; d < m_spatialDimension && overlap; ++ d ) {
+        const unsigned long long * a = &boxes[ i * boxSize + 2 * d ];
+        const unsigned long long * b = &boxes[ j * boxSize + 2 * d ];
+
+        // empty boxes have a[0] == a[1] and never overlap
+        overlap = a[0] < a[1] && b[0] < b[1] && a[0] < b[1] && b[0] < a[1];
+      }
+
+      if( overlap ) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void FileHandler::setGlobalFileId( hid_t id ) {
   m_globalFileId = id;
 
@@ -8,13 +8,19 @@
 const int MAX_FILE_DIMENSION = 3;
 const int MAX_ATTRIBUTE_NAME_SIZE = 64;
 
+/// Maximum number of values read at once while searching for the local hyperslab
+const hsize_t MAX_SCAN_BUFFER_SIZE = 1048576;
+
 
 /// \brief This file contains a functionality for merging multiple HDF files (located in  $TMPDIRs) into one file (located in Project path).
+///        Every process reads only the hyperslab it owns in its local file. The producer stores the hyperslab in the dataset
+///        attributes LOCAL_OFFSET_ATTRIBUTE and LOCAL_COUNT_ATTRIBUTE, for older files it is the bounding box of the non-zero values.
 ///        Different merging modes:
-/// CREATE - Every process reads its local file. Process with rank 0 creates a global file in project path directory and writes merging results to it
-/// REUSE  - Every process reads its local file. Process with rank 0 re-writes its local file with merging results.
+/// CREATE - All processes create a global file in project path directory and write their own hyperslabs into it collectively (MPI-IO)
+/// REUSE  - Process with rank 0 re-writes its local file with merging results. Other processes send their hyperslabs to rank 0 one by one.
 ///          The merging file has to be copied to a final destination afterwards.
-/// APPEND - Every process reads its local file. Process with rank 0 opens/create a global file in Project path and updates it with merging results.
+/// APPEND - All processes open/create a global file in Project path and update it collectively with their own hyperslabs.
+///          Datasets that exist already are cleared first, so no values of the previous output remain.
 
    /// \brief Handles merging of HDF output files produced by simulation with OFPP (one file per process) enabled
 class  FileHandler {
@@ -53,6 +59,8 @@ public:
    virtual void writeAttributes();
    /// \brief Create dataset into  global file
    virtual void createDataset( const char* name , hid_t dtype );
+   /// \brief Write the local hyperslab (m_offset, m_count) into the global dataset
+   virtual herr_t writeDataset( hid_t dtype, const void * buffer );
 
    /// \brief collective check of an error
    int  checkError ( hid_t value );
@@ -69,6 +77,26 @@ public:
    /// \brief merge 2D dataset
    herr_t merge2D ( const char* name, hid_t dtype );
 
+   /// \brief Find the hyperslab owned by this process in the local dataset
+   ///
+   /// The hyperslab is read from the dataset attributes written by the producer. Without them (files of older versions)
+   /// it is the bounding box of the non-zero values, the local dataset is scanned in slabs of at most MAX_SCAN_BUFFER_SIZE values.
+   /// The result is stored in m_offset and m_count.
+   herr_t findLocalHyperslab ();
+
+   /// \brief Read the hyperslab from the LOCAL_OFFSET_ATTRIBUTE and LOCAL_COUNT_ATTRIBUTE attributes of the local dataset
+   ///
+   /// Returns false if the attributes do not exist or do not fit the dataset, m_offset and m_count are not changed then.
+   bool readLocalHyperslab ();
+
+   /// \brief Write zeros into the whole global dataset (collective), each process writing an equal share of the rows
+   ///
+   /// Used before an existing dataset is updated, since every process writes only the non-zero part of its data.
+   herr_t clearGlobalDataset ();
+
+   /// \brief Collective check whether hyperslabs of different processes overlap
+   bool hasOverlappingHyperslabs ();
+
   /// \brief Access members
    int getRank() const;
    hid_t getLocalFileId () const;
@@ -80,6 +108,11 @@ public:
    hid_t getFilespace() const;
    hid_t getSpatialDimension() const;
    const char * getFileName() const;
+   MPI_Comm getComm() const;
+   const hsize_t * getDimensions() const;
+   /// \brief The local hyperslab of the last merged dataset
+   const hsize_t * getOffset() const;
+   const hsize_t * getCount() const;
 
    void setLocalFileId ( hid_t aLocalId );
    void setGlobalFileId ( hid_t aGlobalId );
@@ -113,8 +146,8 @@ private:
    hid_t m_memspace = H5P_DEFAULT;
    hid_t m_filespace = H5P_DEFAULT;
 
-   std::vector<float> m_data;     // local data buffer for 2D dataset (for reading)
-   std::vector<float> m_sumData;  // global data buffer for 2D dataset (for collecting data on rank 0)
+   std::vector<char>  m_data;     // local data buffer for 2D dataset (local hyperslab only)
+   std::vector<float> m_scanData; // buffer for searching the local hyperslab
 
    std::vector<char> m_data1D;    // data buffer for 1D dataset (for reading and writing )
    std::vector<char> m_attrData;  // attributes buffer
@@ -125,8 +158,8 @@ private:
    /// \brief Path to Temporary directory where local files are located
    std::string m_tempDirName;
 
-   /// \brief Operation to collect data on 0 process
-   MPI_Op m_op;
+   /// \brief Collective data transfer property list for writing into the global file
+   hid_t m_transferPList;
 
    /// \brief Name of the current group
    std::string m_groupName;
@@ -172,4 +205,20 @@ inline hid_t FileHandler::getSpatialDimension() const {
    return m_spatialDimension;
 }
 
+inline MPI_Comm FileHandler::getComm() const {
+   return m_comm;
+}
+
+inline const hsize_t * FileHandler::getDimensions() const {
+   return m_dimensions;
+}
+
+inline const hsize_t * FileHandler::getOffset() const {
+   return m_offset;
+}
+
+inline const hsize_t * FileHandler::getCount() const {
+   return m_count;
+}
+
 #endif
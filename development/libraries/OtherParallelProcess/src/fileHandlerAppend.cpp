@@ -7,37 +7,41 @@
 #include "hdf5.h"
 #include "fileHandlerAppend.h"
 
+#include "H5FDmpio.h"
+
 FileHandlerAppend::FileHandlerAppend( MPI_Comm comm, const std::string & fileName, const std::string & tempDirName ):
       FileHandler( comm, fileName, tempDirName) {
 };
 
 void FileHandlerAppend::openGlobalFile () {
 
-   if( getRank() == 0 ) {
-      // Update existing file
-      setGlobalFileId ( H5Fopen( getFileName(), H5F_ACC_RDWR, H5P_DEFAULT ));
-      //If it doesn't exist create one
-      if(  getGlobalFileId()  < 0 ) {
-         setGlobalFileId ( H5Fcreate( getFileName(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT ));
-      }
+   // All processes open the global file and write their own hyperslabs into it
+   hid_t fileAccessPList = H5Pcreate( H5P_FILE_ACCESS );
+   H5Pset_fapl_mpio( fileAccessPList, getComm(), MPI_INFO_NULL );
+
+   // Update existing file
+   setGlobalFileId ( H5Fopen( getFileName(), H5F_ACC_RDWR, fileAccessPList ));
+   //If it doesn't exist create one
+   if(  getGlobalFileId()  < 0 ) {
+      setGlobalFileId ( H5Fcreate( getFileName(), H5F_ACC_TRUNC, H5P_DEFAULT, fileAccessPList ));
    }
+
+   H5Pclose( fileAccessPList );
 }
 
 //  Open or create a group in the global file
 void FileHandlerAppend::createGroup( const char* name ) {
 
-   if( getRank() == 0 ) {
-      // Open existing group for update
-      setGroupId( H5Gopen( getGlobalFileId(), name, H5P_DEFAULT ));
-      // create a group if it doesn't exist
-      if( getGroupId() < 0 ) {
-         setGroupId ( H5Gcreate( getGlobalFileId(), name,  H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT ));
-         // Unset update flag because the file is created
-         m_update = false;
-      }
-      if( getGroupId() < 0 ) {
-         std::cout << " ERROR Cannot open or create the group " << name << std::endl;
-      }
+   // Open existing group for update
+   setGroupId( H5Gopen( getGlobalFileId(), name, H5P_DEFAULT ));
+   // create a group if it doesn't exist
+   if( getGroupId() < 0 ) {
+      setGroupId ( H5Gcreate( getGlobalFileId(), name,  H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT ));
+      // Unset update flag because the file is created
+      m_update = false;
+   }
+   if( getGroupId() < 0 && getRank() == 0 ) {
+      std::cout << " ERROR Cannot open or create the group " << name << std::endl;
    }
 }
 // Writes attributes into created global file.
@@ -54,30 +58,26 @@ void FileHandlerAppend::writeAttributes( ) {
 // Create or open a dataset in global file
 void FileHandlerAppend::createDataset( const char* name , hid_t dtype ) {
 
-   if( getRank() == 0 ) {
-
-      // Write the global data into the global file
-      setMemspace( H5Screate_simple( getSpatialDimension(), m_count, NULL ));
-
-      if( getGroupId() != H5P_DEFAULT ) {
-         // Dataset is under the sub-group
-         setGlobalDsetId( H5Dopen ( getGroupId(), name, H5P_DEFAULT ));
-         if( getGlobalDsetId() < 0 ) {
-            setGlobalDsetId( H5Dcreate( getGroupId(), name, dtype, getMemspace(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT ));
-         }
-      } else {
-         // Dataset is under the main group
-         setGlobalDsetId ( H5Dopen ( getGlobalFileId(), name, H5P_DEFAULT ));
-         if( getGlobalDsetId() < 0 ) {
-            setGlobalDsetId( H5Dcreate( getGlobalFileId(), name, dtype, getMemspace(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT ));
-         }
-      }
+   hid_t locationId = ( getGroupId() != H5P_DEFAULT ? getGroupId() : getGlobalFileId() );
+
+   // Open the dataset for update (collective)
+   setGlobalDsetId( H5Dopen ( locationId, name, H5P_DEFAULT ));
 
-      if( getGlobalDsetId() < 0 ) {
-         std::cout << " ERROR Cannot create the dataset " << name << std::endl;
+   if( getGlobalDsetId() >= 0 ) {
+      // Every process writes only the non-zero part of its data, the values of the previous
+      // output outside those parts must not survive the update.
+      if( getSpatialDimension() > 1 and clearGlobalDataset() < 0 and getRank() == 0 ) {
+         std::cout << " ERROR Cannot clear the dataset " << name << std::endl;
       }
+   } else {
+      hid_t globalSpace = H5Screate_simple( getSpatialDimension(), getDimensions(), NULL );
+
+      setGlobalDsetId( H5Dcreate( locationId, name, dtype, globalSpace, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT ));
+
+      H5Sclose( globalSpace );
+   }
 
-      setFilespace ( H5Dget_space( getGlobalDsetId() ));
-      H5Sselect_hyperslab( getFilespace(), H5S_SELECT_SET, m_offset, NULL, m_count, NULL );
+   if( getGlobalDsetId() < 0 && getRank() == 0 ) {
+      std::cout << " ERROR Cannot create the dataset " << name << std::endl;
    }
 }
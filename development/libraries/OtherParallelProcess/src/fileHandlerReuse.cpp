@@ -4,9 +4,35 @@
 #include <sstream>
 #include <iostream>
 
+#include <algorithm>
+#include <limits>
+
 #include "hdf5.h"
 #include "fileHandlerReuse.h"
 
+namespace {
+
+   /// Largest number of values in one message, the counts of MPI are int
+   const hsize_t MAX_MESSAGE_VALUES = static_cast<hsize_t>( std::numeric_limits<int>::max() );
+
+   /// Send the values in messages of at most MAX_MESSAGE_VALUES values, a partition can be larger than 2 GiB
+   void sendValues( const char * buffer, const hsize_t valNumber, MPI_Datatype valueType, const size_t dataSize, const int tag, MPI_Comm comm ) {
+
+      for( hsize_t first = 0; first < valNumber; first += MAX_MESSAGE_VALUES ) {
+         const int count = static_cast<int>( std::min( MAX_MESSAGE_VALUES, valNumber - first ));
+         MPI_Send( const_cast<char*>( buffer + first * dataSize ), count, valueType, 0, tag, comm );
+      }
+   }
+
+   void receiveValues( char * buffer, const hsize_t valNumber, MPI_Datatype valueType, const size_t dataSize, const int source, const int tag, MPI_Comm comm ) {
+
+      for( hsize_t first = 0; first < valNumber; first += MAX_MESSAGE_VALUES ) {
+         const int count = static_cast<int>( std::min( MAX_MESSAGE_VALUES, valNumber - first ));
+         MPI_Recv( buffer + first * dataSize, count, valueType, source, tag, comm, MPI_STATUS_IGNORE );
+      }
+   }
+}
+
 void FileHandlerReuse::openLocalFile( hid_t fileAccessPList ) {
 
    // only rank 0 needs RDWR access?
@@ -17,14 +43,6 @@ void FileHandlerReuse::openLocalFile( hid_t fileAccessPList ) {
    }
 }
 
-void FileHandlerReuse::closeSpaces( ) {
-
-   // filespace and memspace will be used by rank 0
-   if( getRank() != 0 ) {
-      H5Sclose( getFilespace() );
-      H5Sclose( getMemspace() );
-   }
-}
 
 void FileHandlerReuse::createGroup( const char* name ) {
    
@@ -34,4 +52,97 @@ void FileHandlerReuse::createGroup( const char* name ) {
    }
   
 }
- 
+
+void FileHandlerReuse::writeAttributes() {
+
+   // The dataset holds the values of all processes now
+   if( getRank() == 0 ) {
+      if( H5Aexists( getGlobalDsetId(), LOCAL_OFFSET_ATTRIBUTE ) > 0 ) {
+         H5Adelete( getGlobalDsetId(), LOCAL_OFFSET_ATTRIBUTE );
+      }
+
+      if( H5Aexists( getGlobalDsetId(), LOCAL_COUNT_ATTRIBUTE ) > 0 ) {
+         H5Adelete( getGlobalDsetId(), LOCAL_COUNT_ATTRIBUTE );
+      }
+   }
+}
+
+herr_t FileHandlerReuse::writeDataset( hid_t dtype, const void * buffer ) {
+
+   // The local file of rank 0 already contains its own hyperslab and is the only file to write into.
+   // Other processes send their hyperslabs one at a time, so the memory on rank 0 is bounded by the largest partition.
+   const int boxSize = 2 * MAX_FILE_DIMENSION;
+   const size_t dataSize = H5Tget_size( dtype );
+   const int tag = 0;
+
+   herr_t status = 0;
+   unsigned long long box [boxSize];
+
+   // The values are sent whole, so the counts are numbers of values rather than bytes
+   MPI_Datatype valueType;
+   MPI_Type_contiguous( static_cast<int>( dataSize ), MPI_BYTE, &valueType );
+   MPI_Type_commit( &valueType );
+
+   if( getRank() != 0 ) {
+      unsigned long long valNumber = 1;
+
+      for( int d = 0; d < MAX_FILE_DIMENSION; ++ d ) {
+         box[d] = m_offset[d];
+         box[MAX_FILE_DIMENSION + d] = ( d < getSpatialDimension() ? m_count[d] : 1 );
+         valNumber *= box[MAX_FILE_DIMENSION + d];
+      }
+
+      MPI_Send( box, boxSize, MPI_UNSIGNED_LONG_LONG, 0, tag, getComm() );
+
+      if( valNumber > 0 ) {
+         sendValues( static_cast<const char*>( buffer ), valNumber, valueType, dataSize, tag, getComm() );
+      }
+   } else {
+      int size;
+      MPI_Comm_size( getComm(), &size );
+
+      std::vector<char> data;
+
+      for( int source = 1; source < size; ++ source ) {
+         MPI_Recv( box, boxSize, MPI_UNSIGNED_LONG_LONG, source, tag, getComm(), MPI_STATUS_IGNORE );
+
+         hsize_t offset [MAX_FILE_DIMENSION];
+         hsize_t count  [MAX_FILE_DIMENSION];
+         hsize_t valNumber = 1;
+
+         for( int d = 0; d < MAX_FILE_DIMENSION; ++ d ) {
+            offset[d] = box[d];
+            count [d] = box[MAX_FILE_DIMENSION + d];
+            valNumber *= count[d];
+         }
+
+         if( valNumber == 0 ) {
+            continue;
+         }
+
+         data.resize( valNumber * dataSize );
+         receiveValues( data.data(), valNumber, valueType, dataSize, source, tag, getComm() );
+
+         if( status < 0 ) {
+            // keep receiving to complete the communication
+            continue;
+         }
+
+         hid_t filespace = H5Dget_space( getGlobalDsetId() );
+         hid_t memspace  = H5Screate_simple( 1, &valNumber, NULL );
+
+         H5Sselect_hyperslab( filespace, H5S_SELECT_SET, offset, NULL, count, NULL );
+
+         status = H5Dwrite( getGlobalDsetId(), dtype, memspace, filespace, H5P_DEFAULT, data.data() );
+
+         H5Sclose( memspace );
+         H5Sclose( filespace );
+      }
+   }
+
+   MPI_Type_free( &valueType );
+
+   MPI_Bcast( &status, 1, MPI_INT, 0, getComm() );
+
+   return status;
+}
@@ -17,10 +17,13 @@ public:
    void  openLocalFile( hid_t fileAccessPList );
    void  createGroup( const char* name );
    hid_t closeGlobalFile();
-   void  closeSpaces();
    void  closeGlobalDset() {}
-   void  writeAttributes() {}
+   /// \brief The attributes are in the file of rank 0 already, only the hyperslab of rank 0 is removed
+   void  writeAttributes();
    void  createDataset( const char* name , hid_t dtype );
+
+   /// \brief Rank 0 receives the hyperslabs of other processes one by one and writes them into its local file
+   herr_t writeDataset( hid_t dtype, const void * buffer );
 };
 
 inline hid_t FileHandlerReuse::closeGlobalFile() {
@@ -8,6 +8,11 @@ class FileHandler;
 
 enum MergeOption { CREATE, REUSE, APPEND, UNKNOWN };
 
+/// \brief Dataset attributes with the hyperslab owned by the process (offset and count in every dimension).
+///        The producer writes them into the local files, so the merge does not have to search for the hyperslab.
+const char * const LOCAL_OFFSET_ATTRIBUTE = "LocalHyperslabOffset";
+const char * const LOCAL_COUNT_ATTRIBUTE  = "LocalHyperslabCount";
+
 bool copyFile( const std::string & dstPath, const std::string & currentPath );
 
 bool mergeFiles( FileHandler * aFileHandler, const bool appendRank = true ) ;
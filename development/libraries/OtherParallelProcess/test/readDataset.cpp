@@ -18,7 +18,8 @@
 
 // Tesing of the merging of "one file per process" output files into a one hdf file
 //
-// Each process creates a local file, process 0 creates a global file. All processes call "readDataset" method.
+// Each process creates a local file, all processes create the global file collectively (MPI-IO) or reuse a local file.
+// All processes call "readDataset" method, which returns the status of the merge on all processes.
 // Output of "readDataset": The merging file is written (not closed yet)
 //
 //  1: Dataset is written correctly
@@ -28,7 +29,11 @@
 //  5: Reallocation of buffers
 //  6: Collective check of an error
 //  7: Dataset and attribute are written correctly. Reuse of the file structure.
-//  7: Dataset and attribute are written correctly. Update existing file.
+//  8: Dataset and attribute are written correctly. Update existing file.
+//  9: Distributed 2D dataset: every process contributes only its own rows. Reuse of the file structure.
+// 10: Distributed 2D dataset: update of an existing dataset, no values of the previous output remain.
+// 11: Distributed 2D dataset: every process contributes only its own rows. Create a new global file.
+// 12: Distributed 2D dataset: the rows of every process are given by the hyperslab attributes of the producer. Reuse of the file structure.
 
 namespace
 {
@@ -331,23 +336,22 @@ TEST( h5mergeTest, MergeExistingFiles1 )
 
       EXPECT_EQ( 5, status );
 
-      File b( name, false );
-      if (MPIHelper::rank() == 0)
-      {
-         status = b.open( File::Create, 0, true );
-         ASSERT_FALSE( File::CannotCreateFile == status ) << "Global file can't be created." << std::endl;
+      // The global file is created by all processes
+      reader.openGlobalFile();
+      ASSERT_GE( reader.getGlobalFileId(), 0 ) << "Global file can't be created." << std::endl;
 
-         EXPECT_EQ( 0, status );
-      }
-      reader.setGlobalFileId ( b.fileId () );
       reader.setLocalFileId ( a.fileId () );
 
       EXPECT_EQ( 0, readDataset( a.fileId(), StdDataSetName.c_str(), &reader ));
 
+      EXPECT_GE( reader.closeGlobalFile(), 0 );
+
       if (MPIHelper::rank() == 0)
       {
-         b.close();
+         File b( name, false );
          EXPECT_EQ( 5, b.open( File::Open, -1, true ));
+         b.close();
+         std::remove( name.c_str() );
       }
    }
 
@@ -368,23 +372,22 @@ TEST( h5mergeTest, MergeExistingFiles2 )
 
       EXPECT_EQ( 5, status );
 
-      File b( name, false );
-      if (MPIHelper::rank() == 0)
-      {
-         status = b.open( File::CreateWithAttr, 0, true );
-         ASSERT_FALSE( File::CannotCreateFile == status ) << "Global file can't be created." << std::endl;
+      // The global file is created by all processes
+      reader.openGlobalFile();
+      ASSERT_GE( reader.getGlobalFileId(), 0 ) << "Global file can't be created." << std::endl;
 
-         EXPECT_EQ( 0, status );
-      }
-      reader.setGlobalFileId ( b.fileId () );
       reader.setLocalFileId ( a.fileId () );
 
       EXPECT_EQ( 0, readDataset( a.fileId(), StdDataSetName.c_str(), &reader ));
 
+      EXPECT_GE( reader.closeGlobalFile(), 0 );
+
       if (MPIHelper::rank() == 0)
       {
-         b.close();
+         File b( name, false );
          EXPECT_EQ( 5, b.open( File::OpenWithAttr, -1, true ));
+         b.close();
+         std::remove( name.c_str() );
       }
    }
 
@@ -416,18 +419,19 @@ TEST( h5mergeTest, MergeExistingFiles4 )
 
       EXPECT_EQ( 5, status );
 
-      File b( name, false );
-      if (MPIHelper::rank() == 0)
-      {
-         status = b.open( File::Create, 0, true );
-         ASSERT_FALSE( File::CannotCreateFile == status ) << "Global file can't be created." << std::endl;
+      reader.openGlobalFile();
+      ASSERT_GE( reader.getGlobalFileId(), 0 ) << "Global file can't be created." << std::endl;
 
-         EXPECT_EQ( 0, status );
-      }
-      reader.setGlobalFileId ( b.fileId () );
       reader.setLocalFileId  ( a.fileId () );
 
       EXPECT_EQ( -1, readDataset( a.fileId(), "", &reader ));
+
+      EXPECT_GE( reader.closeGlobalFile(), 0 );
+
+      if (MPIHelper::rank() == 0)
+      {
+         std::remove( name.c_str() );
+      }
    }
 
 }
@@ -512,3 +516,309 @@ TEST( h5mergeTest, AppendExistingFiles8 )
    }
 
 }
+
+TEST( h5mergeTest, ReuseDistributedData9 )
+{
+   if (MPIHelper::size() > 1)
+   {
+      const int rank = MPIHelper::rank();
+      const int size = MPIHelper::size();
+
+      // Every process owns two rows of the global dataset, the rest of its local file is zero
+      const hsize_t rowsPerRank = 2;
+      const hsize_t columns = 3;
+      hsize_t dims[2] = { rowsPerRank * size, columns };
+
+      std::string name = File::tempName();
+      File a( name, true );
+
+      hid_t fileId = H5Fcreate( a.name().c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT );
+      ASSERT_GE( fileId, 0 );
+
+      std::vector<float> data( dims[0] * dims[1], 0 );
+      for( hsize_t i = rank * rowsPerRank; i < ( rank + 1 ) * rowsPerRank; ++ i ) {
+         for( hsize_t j = 0; j < columns; ++ j ) {
+            data[ i * columns + j ] = static_cast<float>( rank + 1 );
+         }
+      }
+
+      hid_t space = H5Screate_simple( 2, dims, NULL );
+      hid_t dataset = H5Dcreate( fileId, StdDataSetName.c_str(), H5T_NATIVE_FLOAT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+      ASSERT_GE( dataset, 0 );
+      EXPECT_GE( H5Dwrite( dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data() ), 0 );
+      H5Dclose( dataset );
+
+      FileHandlerReuse reader( MPI_COMM_WORLD, name, "." );
+      reader.setLocalFileId( fileId );
+
+      if( rank == 0 ) {
+         reader.setGlobalFileId ( fileId );
+      }
+
+      EXPECT_EQ( 0, readDataset( fileId, StdDataSetName.c_str(), &reader ));
+
+      if( rank == 0 )
+      {
+         // The file of rank 0 contains the rows of all processes
+         std::fill( data.begin(), data.end(), 0 );
+
+         dataset = H5Dopen( fileId, StdDataSetName.c_str(), H5P_DEFAULT );
+         EXPECT_GE( H5Dread( dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data() ), 0 );
+         H5Dclose( dataset );
+
+         for( hsize_t i = 0; i < dims[0]; ++ i ) {
+            for( hsize_t j = 0; j < columns; ++ j ) {
+               EXPECT_EQ( static_cast<float>( i / rowsPerRank + 1 ), data[ i * columns + j ] );
+            }
+         }
+      }
+
+      H5Sclose( space );
+      H5Fclose( fileId );
+      std::remove( a.name().c_str() );
+   }
+}
+
+TEST( h5mergeTest, AppendDistributedData10 )
+{
+   if (MPIHelper::size() > 1)
+   {
+      const int rank = MPIHelper::rank();
+      const int size = MPIHelper::size();
+
+      // Every process owns two rows of the global dataset, the last process has only zeros
+      const hsize_t rowsPerRank = 2;
+      const hsize_t columns = 3;
+      hsize_t dims[2] = { rowsPerRank * size, columns };
+
+      const std::string globalName = File::tempName();
+      File local( File::tempName(), true );
+
+      // The global file holds the dataset of a previous output
+      if( rank == 0 ) {
+         hid_t fileId = H5Fcreate( globalName.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT );
+         ASSERT_GE( fileId, 0 );
+
+         std::vector<float> previous( dims[0] * dims[1], 9.0f );
+         hid_t space = H5Screate_simple( 2, dims, NULL );
+         hid_t dataset = H5Dcreate( fileId, StdDataSetName.c_str(), H5T_NATIVE_FLOAT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+         EXPECT_GE( H5Dwrite( dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, previous.data() ), 0 );
+         H5Dclose( dataset );
+         H5Sclose( space );
+         H5Fclose( fileId );
+      }
+
+      MPIHelper::barrier();
+
+      hid_t localId = H5Fcreate( local.name().c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT );
+      ASSERT_GE( localId, 0 );
+
+      std::vector<float> data( dims[0] * dims[1], 0 );
+      if( rank < size - 1 ) {
+         for( hsize_t i = rank * rowsPerRank; i < ( rank + 1 ) * rowsPerRank; ++ i ) {
+            for( hsize_t j = 0; j < columns; ++ j ) {
+               data[ i * columns + j ] = static_cast<float>( rank + 1 );
+            }
+         }
+      }
+
+      hid_t space = H5Screate_simple( 2, dims, NULL );
+      hid_t dataset = H5Dcreate( localId, StdDataSetName.c_str(), H5T_NATIVE_FLOAT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+      ASSERT_GE( dataset, 0 );
+      EXPECT_GE( H5Dwrite( dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data() ), 0 );
+      H5Dclose( dataset );
+      H5Sclose( space );
+
+      FileHandlerAppend reader( MPI_COMM_WORLD, globalName, "." );
+      reader.openGlobalFile();
+      ASSERT_GE( reader.getGlobalFileId(), 0 );
+      reader.setLocalFileId( localId );
+
+      EXPECT_EQ( 0, readDataset( localId, StdDataSetName.c_str(), &reader ));
+
+      EXPECT_GE( reader.closeGlobalFile(), 0 );
+      H5Fclose( localId );
+
+      MPIHelper::barrier();
+
+      if( rank == 0 )
+      {
+         // The rows of the last process are zero, none of the previous values remain
+         hid_t fileId = H5Fopen( globalName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+         dataset = H5Dopen( fileId, StdDataSetName.c_str(), H5P_DEFAULT );
+         EXPECT_GE( H5Dread( dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data() ), 0 );
+         H5Dclose( dataset );
+         H5Fclose( fileId );
+
+         for( hsize_t i = 0; i < dims[0]; ++ i ) {
+            const hsize_t owner = i / rowsPerRank;
+            const float expected = ( owner < static_cast<hsize_t>( size - 1 ) ? static_cast<float>( owner + 1 ) : 0.0f );
+
+            for( hsize_t j = 0; j < columns; ++ j ) {
+               EXPECT_EQ( expected, data[ i * columns + j ] );
+            }
+         }
+
+         std::remove( globalName.c_str() );
+      }
+
+      std::remove( local.name().c_str() );
+   }
+}
+
+TEST( h5mergeTest, CreateDistributedData11 )
+{
+   if (MPIHelper::size() > 1)
+   {
+      const int rank = MPIHelper::rank();
+      const int size = MPIHelper::size();
+
+      // Every process owns two rows of the global dataset, the rest of its local file is zero
+      const hsize_t rowsPerRank = 2;
+      const hsize_t columns = 3;
+      hsize_t dims[2] = { rowsPerRank * size, columns };
+
+      std::string name = File::tempName();
+      File a( name, true );
+
+      hid_t localId = H5Fcreate( a.name().c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT );
+      ASSERT_GE( localId, 0 );
+
+      std::vector<float> data( dims[0] * dims[1], 0 );
+      for( hsize_t i = rank * rowsPerRank; i < ( rank + 1 ) * rowsPerRank; ++ i ) {
+         for( hsize_t j = 0; j < columns; ++ j ) {
+            data[ i * columns + j ] = static_cast<float>( rank + 1 );
+         }
+      }
+
+      hid_t space = H5Screate_simple( 2, dims, NULL );
+      hid_t dataset = H5Dcreate( localId, StdDataSetName.c_str(), H5T_NATIVE_FLOAT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+      ASSERT_GE( dataset, 0 );
+      EXPECT_GE( H5Dwrite( dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data() ), 0 );
+      H5Dclose( dataset );
+      H5Sclose( space );
+
+      // The global file is created by all processes, each one writes its own rows only
+      FileHandler reader( MPI_COMM_WORLD, name, "." );
+      reader.openGlobalFile();
+      ASSERT_GE( reader.getGlobalFileId(), 0 );
+      reader.setLocalFileId( localId );
+
+      EXPECT_EQ( 0, readDataset( localId, StdDataSetName.c_str(), &reader ));
+
+      // Every process found the rows it owns
+      EXPECT_EQ( rank * rowsPerRank, reader.getOffset()[0] );
+      EXPECT_EQ( rowsPerRank, reader.getCount()[0] );
+      EXPECT_EQ( columns, reader.getCount()[1] );
+
+      EXPECT_GE( reader.closeGlobalFile(), 0 );
+      H5Fclose( localId );
+
+      if( rank == 0 )
+      {
+         // The global file contains the rows of all processes
+         std::fill( data.begin(), data.end(), 0 );
+
+         hid_t fileId = H5Fopen( name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT );
+         ASSERT_GE( fileId, 0 );
+         dataset = H5Dopen( fileId, StdDataSetName.c_str(), H5P_DEFAULT );
+         EXPECT_GE( H5Dread( dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data() ), 0 );
+         H5Dclose( dataset );
+         H5Fclose( fileId );
+
+         for( hsize_t i = 0; i < dims[0]; ++ i ) {
+            for( hsize_t j = 0; j < columns; ++ j ) {
+               EXPECT_EQ( static_cast<float>( i / rowsPerRank + 1 ), data[ i * columns + j ] );
+            }
+         }
+
+         std::remove( name.c_str() );
+      }
+
+      std::remove( a.name().c_str() );
+   }
+}
+
+TEST( h5mergeTest, ReuseHyperslabAttributes12 )
+{
+   if (MPIHelper::size() > 1)
+   {
+      const int rank = MPIHelper::rank();
+      const int size = MPIHelper::size();
+
+      // Every process owns two rows of the global dataset, the first one is zero. The rest of its local file
+      // is filled with -1, so the hyperslab can only be found from the attributes.
+      const hsize_t rowsPerRank = 2;
+      const hsize_t columns = 3;
+      hsize_t dims[2] = { rowsPerRank * size, columns };
+
+      std::string name = File::tempName();
+      File a( name, true );
+
+      hid_t fileId = H5Fcreate( a.name().c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT );
+      ASSERT_GE( fileId, 0 );
+
+      std::vector<float> data( dims[0] * dims[1], -1 );
+      for( hsize_t i = rank * rowsPerRank; i < ( rank + 1 ) * rowsPerRank; ++ i ) {
+         for( hsize_t j = 0; j < columns; ++ j ) {
+            data[ i * columns + j ] = ( i % rowsPerRank == 0 ? 0 : static_cast<float>( rank + 1 ));
+         }
+      }
+
+      hid_t space = H5Screate_simple( 2, dims, NULL );
+      hid_t dataset = H5Dcreate( fileId, StdDataSetName.c_str(), H5T_NATIVE_FLOAT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+      ASSERT_GE( dataset, 0 );
+      EXPECT_GE( H5Dwrite( dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data() ), 0 );
+
+      hsize_t hyperslab [2][2] = { { rank * rowsPerRank, 0 }, { rowsPerRank, columns } };
+      const char * attributeNames [2] = { LOCAL_OFFSET_ATTRIBUTE, LOCAL_COUNT_ATTRIBUTE };
+      hsize_t attributeDims = 2;
+      hid_t attributeSpace = H5Screate_simple( 1, &attributeDims, NULL );
+
+      for( int n = 0; n < 2; ++ n ) {
+         hid_t attributeId = H5Acreate( dataset, attributeNames[n], H5T_NATIVE_HSIZE, attributeSpace, H5P_DEFAULT, H5P_DEFAULT );
+         EXPECT_GE( H5Awrite( attributeId, H5T_NATIVE_HSIZE, hyperslab[n] ), 0 );
+         H5Aclose( attributeId );
+      }
+
+      H5Sclose( attributeSpace );
+      H5Dclose( dataset );
+
+      FileHandlerReuse reader( MPI_COMM_WORLD, name, "." );
+      reader.setLocalFileId( fileId );
+
+      if( rank == 0 ) {
+         reader.setGlobalFileId ( fileId );
+      }
+
+      EXPECT_EQ( 0, readDataset( fileId, StdDataSetName.c_str(), &reader ));
+
+      // The zero row is part of the hyperslab
+      EXPECT_EQ( rank * rowsPerRank, reader.getOffset()[0] );
+      EXPECT_EQ( 0u, reader.getOffset()[1] );
+      EXPECT_EQ( rowsPerRank, reader.getCount()[0] );
+      EXPECT_EQ( columns, reader.getCount()[1] );
+
+      if( rank == 0 )
+      {
+         // The file of rank 0 contains the rows of all processes, the hyperslab of rank 0 is removed
+         std::fill( data.begin(), data.end(), -1 );
+
+         dataset = H5Dopen( fileId, StdDataSetName.c_str(), H5P_DEFAULT );
+         EXPECT_GE( H5Dread( dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data() ), 0 );
+         EXPECT_EQ( 0, H5Aexists( dataset, LOCAL_OFFSET_ATTRIBUTE ));
+         EXPECT_EQ( 0, H5Aexists( dataset, LOCAL_COUNT_ATTRIBUTE ));
+         H5Dclose( dataset );
+
+         for( hsize_t i = 0; i < dims[0]; ++ i ) {
+            for( hsize_t j = 0; j < columns; ++ j ) {
+               EXPECT_EQ( ( i % rowsPerRank == 0 ? 0 : static_cast<float>( i / rowsPerRank + 1 )), data[ i * columns + j ] );
+            }
+         }
+      }
+
+      H5Sclose( space );
+      H5Fclose( fileId );
+      std::remove( a.name().c_str() );
+   }
+}
@@ -6,12 +6,18 @@
 
 #include "FilePath.h"
 
+#include <algorithm>
+
 #ifndef _MSC_VER
 #include "h5merge.h"
 #endif
 
 bool        H5_Parallel_PropertyList :: s_primaryPod = false;
 bool        H5_Parallel_PropertyList :: s_oneFileLustre = false;
+bool        H5_Parallel_PropertyList :: s_chunkedOutput = false;
+int         H5_Parallel_PropertyList :: s_compressionLevel = 0;
+
+std::vector<hsize_t> H5_Parallel_PropertyList :: s_chunkSize;
 
 std::string H5_Parallel_PropertyList :: s_temporaryDirName;
 
@@ -86,6 +92,64 @@ hid_t H5_Parallel_PropertyList :: createRawTransferDatasetPropertyList() const
    return pList;
 }
 
+hid_t H5_Parallel_PropertyList :: createChunkedDatasetPropertyList( const int numDimensions, const hsize_t * localDims, const hsize_t * globalDims ) const
+{
+   hid_t dcpl = H5Pcreate (H5P_DATASET_CREATE);
+
+   std::vector<hsize_t> chunk ( localDims, localDims + numDimensions );
+
+   // chunk size must be the same for all ranks. By default the chunk is the smallest partition of the
+   // domain decomposition, so that in the regular case every rank writes to its own chunks only.
+   MPI_Allreduce ( (void *)localDims, chunk.data (), numDimensions, MPI_UNSIGNED_LONG_LONG, MPI_MIN, PETSC_COMM_WORLD );
+
+   for( int i = 0; i < numDimensions; ++ i ) {
+
+      if( i < static_cast<int>( s_chunkSize.size ()) and s_chunkSize[i] > 0 ) {
+         chunk[i] = s_chunkSize[i];
+      }
+
+      chunk[i] = std::max<hsize_t>( 1, std::min( chunk[i], globalDims[i] ));
+   }
+
+   H5Pset_chunk (dcpl, numDimensions, chunk.data ());
+
+   if( s_compressionLevel > 0 ) {
+#if H5_VERSION_GE(1,10,2)
+      // Filtered datasets can only be written collectively (see createRawTransferDatasetPropertyList).
+      if( H5Zfilter_avail ( H5Z_FILTER_DEFLATE ) > 0 ) {
+         // byte shuffle improves the deflate ratio for floating-point data
+         if( H5Zfilter_avail ( H5Z_FILTER_SHUFFLE ) > 0 ) {
+            H5Pset_shuffle (dcpl);
+         }
+         H5Pset_deflate (dcpl, static_cast<unsigned int>( s_compressionLevel ));
+      }
+#endif
+
+      // When the chunks tile every partition exactly, each chunk is written completely by a single rank
+      // and there is no need to initialise it with the fill value. Otherwise the chunks at the edges of
+      // the partitions are written partly by each rank and must be initialised.
+      int tilesPartition = 1;
+
+      for( int i = 0; i < numDimensions; ++ i ) {
+
+         if( localDims[i] % chunk[i] != 0 ) {
+            tilesPartition = 0;
+         }
+
+      }
+
+      int tilesAllPartitions = 0;
+      MPI_Allreduce ( &tilesPartition, &tilesAllPartitions, 1, MPI_INT, MPI_LAND, PETSC_COMM_WORLD );
+
+      if( tilesAllPartitions ) {
+         H5Pset_fill_time (dcpl, H5D_FILL_TIME_NEVER);
+      }
+
+   }
+
+   return dcpl;
+}
+
 void H5_Parallel_PropertyList ::setOtherFileProcessOptions( const bool createDir )
 {
    PetscBool primaryPod = PETSC_FALSE;
@@ -167,6 +231,56 @@ void H5_Parallel_PropertyList ::setOtherFileProcessOptions( const bool createDir
          setOneFileLustre(true);
       }
    }
+
+   setChunkingAndCompressionOptions();
+}
+
+void H5_Parallel_PropertyList ::setChunkingAndCompressionOptions()
+{
+   PetscBool chunked = PETSC_FALSE;
+   PetscOptionsHasName (PETSC_IGNORE, PETSC_IGNORE, "-hdfchunked", &chunked );
+   s_chunkedOutput = ( chunked == PETSC_TRUE );
+
+   PetscInt chunkSize [ MAX_DIMS ] = { 0 };
+   PetscInt numberOfChunkDimensions = MAX_DIMS;
+   PetscBool chunkSizeDefined = PETSC_FALSE;
+   PetscOptionsGetIntArray (PETSC_IGNORE, PETSC_IGNORE, "-hdfchunksize", chunkSize, &numberOfChunkDimensions, &chunkSizeDefined );
+
+   s_chunkSize.clear ();
+   if( chunkSizeDefined ) {
+      for( PetscInt i = 0; i < numberOfChunkDimensions; ++ i ) {
+         s_chunkSize.push_back ( chunkSize[i] > 0 ? static_cast<hsize_t>( chunkSize[i] ) : 0 );
+      }
+      s_chunkedOutput = true;
+   }
+
+   PetscBool compressionDefined = PETSC_FALSE;
+   PetscOptionsHasName (PETSC_IGNORE, PETSC_IGNORE, "-hdfcompress", &compressionDefined );
+
+   PetscInt compressionLevel = 0;
+   PetscOptionsGetInt (PETSC_IGNORE, PETSC_IGNORE, "-hdfcompress", &compressionLevel, PETSC_IGNORE );
+
+   s_compressionLevel = 0;
+   if( compressionDefined ) {
+      // the option without a value selects a moderate level: higher levels cost much more time for little gain
+      s_compressionLevel = static_cast<int>( compressionLevel > 0 ? std::min<PetscInt>( compressionLevel, 9 ) : 4 );
+
+#if H5_VERSION_GE(1,10,2)
+      if( H5Zfilter_avail ( H5Z_FILTER_DEFLATE ) <= 0 ) {
+         PetscPrintf ( PETSC_COMM_WORLD, "  Basin_Warning: HDF5 library is built without deflate filter. Output will not be compressed.\n" );
+         s_compressionLevel = 0;
+      }
+#else
+      PetscPrintf ( PETSC_COMM_WORLD, "  Basin_Warning: Parallel compression requires HDF5 1.10.2 or later. Output will not be compressed.\n" );
+      s_compressionLevel = 0;
+#endif
+   }
+
+   if( s_compressionLevel > 0 ) {
+      PetscPrintf ( PETSC_COMM_WORLD, "Volume output is compressed with deflate level %d\n", s_compressionLevel );
+   } else if ( s_chunkedOutput ) {
+      PetscPrintf ( PETSC_COMM_WORLD, "Volume output is written with chunked layout\n" );
+   }
 }
 
 bool H5_Parallel_PropertyList :: copyMergedFile( const std::string & filePathName, const bool appendRank )
@@ -3,6 +3,8 @@
 
 #include <mpi.h>
 
+#include <vector>
+
 #include "h5_file_types.h"
 
 class H5_Parallel_PropertyList : public H5_PropertyList
@@ -16,9 +18,16 @@ public:
    virtual hid_t createCreateDatasetPropertyList( ) const;
    virtual hid_t createAccessDatasetPropertyList( ) const;
    virtual hid_t createRawTransferDatasetPropertyList( ) const;
+
+   /// Chunk shape is aligned with the domain decomposition unless set by -hdfchunksize,
+   /// shuffle and deflate filters are added if compression is enabled by -hdfcompress.
+   virtual hid_t createChunkedDatasetPropertyList( const int numDimensions, const hsize_t * localDims, const hsize_t * globalDims ) const;
          
    static void setOtherFileProcessOptions( const bool createDir =  true ) ;
 
+   /// Read the chunking and compression command-line options (-hdfchunked, -hdfchunksize, -hdfcompress)
+   static void setChunkingAndCompressionOptions();
+
    static void setOneNodeCollectiveBufferingOption();
 
    static bool isOneFileLustreEnabled() 
@@ -27,6 +36,17 @@ public:
    static bool isPrimaryPodEnabled() 
    { return s_primaryPod; }
 
+   /// Every process writes its own file in the temporary directory, the files are merged afterwards
+   static bool isOneFilePerProcessEnabled()
+   { return not s_primaryPod and not s_oneFileLustre and not s_temporaryDirName.empty(); }
+
+   /// Volume output is written with chunked layout
+   static bool isChunkingEnabled()
+   { return s_primaryPod or s_oneFileLustre or s_chunkedOutput or s_compressionLevel > 0; }
+
+   static int getCompressionLevel()
+   { return s_compressionLevel; }
+
    static std::string getTempDirName() 
    { return s_temporaryDirName; }
 
@@ -65,6 +85,20 @@ private:
 
    static bool s_oneFileLustre;
 
+   // "Chunked" output: volume (3D) HDF files are written with chunked datasets in any output mode.
+   // Command-line options:
+   //  "-hdfchunked" - enable chunked layout
+   //  "-hdfchunksize <ni,nj,nk>" - chunk shape in dataset dimension order, 0 or missing entries are taken
+   //                               from the domain decomposition (smallest local partition size over all ranks)
+   //  "-hdfcompress <level>" - compress chunks with shuffle and deflate filters, level 1-9 (implies -hdfchunked)
+   //
+   // Compressed datasets are written collectively (requires parallel HDF5 1.10.2 or later) and
+   // are decompressed transparently by all HDF5 readers.
+
+   static bool s_chunkedOutput;
+   static int  s_compressionLevel;
+   static std::vector<hsize_t> s_chunkSize;
+
    static std::string s_temporaryDirName;
    static MPI_Info s_mpiInfo;
 
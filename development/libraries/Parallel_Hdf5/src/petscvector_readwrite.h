@@ -11,6 +11,10 @@
 #include "h5_vector_conversions.h"
 #include "h5_file_types.h"
 
+#ifndef _MSC_VER
+#include "h5merge.h"
+#endif
+
 template <class Type> 
 class PetscVector_ReadWrite : public Buffer_ReadWrite
 {
@@ -140,6 +144,7 @@ public:
           status = h5File->writeDataset (dataId, buffer,
                                          (dataSpace.first)->space_id(), 
                                          (dataSpace.second)->space_id());
+          writeLocalHyperslab (dataId, localVecInfo);
           H5Dclose (dataId);
       }
  
@@ -168,6 +173,7 @@ public:
         status = h5File->writeDataset (dataId, buffer,
                                        (dataSpace.first)->space_id(), 
                                        (dataSpace.second)->space_id());
+        writeLocalHyperslab (dataId, localVecInfo);
 
 	    H5Dclose (dataId);
         delete dataSpace.first;
@@ -179,6 +185,39 @@ public:
       return status;
    } 
 
+   // In one file per process mode every local file spans the global domain, the hyperslab owned by the
+   // process is stored with the dataset so that the merge does not have to search for it (see FileHandler)
+   static void writeLocalHyperslab (hid_t dataId, DMDALocalInfo &localVecInfo)
+   {
+#ifndef _MSC_VER
+      if ( !H5_Parallel_PropertyList::isOneFilePerProcessEnabled ()) return;
+
+      H5_VectorBoundaries dataBounds (localVecInfo);
+
+      writeHyperslabAttribute (dataId, LOCAL_OFFSET_ATTRIBUTE, dataBounds.offsetBounds());
+      writeHyperslabAttribute (dataId, LOCAL_COUNT_ATTRIBUTE, dataBounds.localBounds());
+#endif
+   }
+
+   static void writeHyperslabAttribute (hid_t dataId, const char *attributeName, const H5_Dimensions<hsize_t> &values)
+   {
+      hsize_t numDimensions = values.numDimensions ();
+      hid_t space = H5Screate_simple (1, &numDimensions, NULL);
+
+      // the dataset is rewritten by overWriteRawData
+      hid_t attributeId = ( H5Aexists (dataId, attributeName) > 0 ?
+                            H5Aopen (dataId, attributeName, H5P_DEFAULT) :
+                            H5Acreate2 (dataId, attributeName, H5T_NATIVE_HSIZE, space, H5P_DEFAULT, H5P_DEFAULT) );
+
+      if ( attributeId > -1 )
+      {
+         H5Awrite (attributeId, H5T_NATIVE_HSIZE, values.dimensions ());
+         H5Aclose (attributeId);
+      }
+
+      H5Sclose (space);
+   }
+
    static DataSpace createHyperslabFilespace (DMDALocalInfo &localVecInfo, const bool useChunks = false )
    {
      // create size and offset from Local Vec Info
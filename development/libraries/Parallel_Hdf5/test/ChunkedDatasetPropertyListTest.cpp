@@ -0,0 +1,134 @@
+#include "h5_parallel_file_types.h"
+
+#include <petsc.h>
+#include <hdf5.h>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+struct Init
+{
+   Init() { PetscInitialize(0, 0, 0, 0); }
+   ~Init() { PetscFinalize(); }
+} initMe;
+
+namespace
+{
+   const char * const FileName = "ChunkedDatasetPropertyListTest.h5";
+
+   /// Create a dataset collectively with the chunked dataset property list and return its creation property list.
+   /// Every rank owns a partition of numI x 6 x 10 values, the partitions are stacked along the first dimension.
+   hid_t createDataset( const hsize_t numI )
+   {
+      H5_Parallel_PropertyList propertyList;
+
+      hsize_t localDims[3] = { numI, 6, 10 };
+      hsize_t globalDims[3] = { 0, 6, 10 };
+      MPI_Allreduce( &localDims[0], &globalDims[0], 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, PETSC_COMM_WORLD );
+
+      hid_t fapl = propertyList.createFilePropertyList();
+      hid_t fileId = H5Fcreate( FileName, H5F_ACC_TRUNC, H5P_DEFAULT, fapl );
+      H5Pclose( fapl );
+      EXPECT_GE( fileId, 0 );
+
+      hid_t dcpl = propertyList.createChunkedDatasetPropertyList( 3, localDims, globalDims );
+      hid_t spaceId = H5Screate_simple( 3, globalDims, 0 );
+      hid_t dataSetId = H5Dcreate2( fileId, "/Layer=0", H5T_NATIVE_FLOAT, spaceId, H5P_DEFAULT, dcpl, H5P_DEFAULT );
+      EXPECT_GE( dataSetId, 0 );
+
+      // the properties of the dataset as stored in the file
+      hid_t datasetDcpl = H5Dget_create_plist( dataSetId );
+
+      H5Dclose( dataSetId );
+      H5Sclose( spaceId );
+      H5Pclose( dcpl );
+      H5Fclose( fileId );
+
+      return datasetDcpl;
+   }
+
+   void setOptions( const char * chunkSize, const char * compressionLevel )
+   {
+      PetscOptionsClearValue( PETSC_IGNORE, "-hdfchunksize" );
+      PetscOptionsClearValue( PETSC_IGNORE, "-hdfcompress" );
+
+      if( chunkSize != 0 ) {
+         PetscOptionsSetValue( PETSC_IGNORE, "-hdfchunksize", chunkSize );
+      }
+
+      if( compressionLevel != 0 ) {
+         PetscOptionsSetValue( PETSC_IGNORE, "-hdfcompress", compressionLevel );
+      }
+
+      H5_Parallel_PropertyList::setChunkingAndCompressionOptions();
+   }
+
+   int getRank()
+   {
+      int rank;
+      MPI_Comm_rank( PETSC_COMM_WORLD, &rank );
+      return rank;
+   }
+}
+
+// The chunk is the smallest partition, compressed with shuffle and deflate
+TEST( ChunkedDatasetPropertyList, CompressedDataset )
+{
+   setOptions( 0, "5" );
+   EXPECT_TRUE( H5_Parallel_PropertyList::isChunkingEnabled() );
+
+   hid_t dcpl = createDataset( getRank() == 0 ? 4 : 3 );
+
+   int size;
+   MPI_Comm_size( PETSC_COMM_WORLD, &size );
+
+   hsize_t chunk[3] = { 0, 0, 0 };
+   ASSERT_EQ( 3, H5Pget_chunk( dcpl, 3, chunk ));
+   EXPECT_EQ( size == 1 ? 4u : 3u, chunk[0] );
+   EXPECT_EQ( 6u, chunk[1] );
+   EXPECT_EQ( 10u, chunk[2] );
+
+#if H5_VERSION_GE(1,10,2)
+   ASSERT_EQ( 5, H5_Parallel_PropertyList::getCompressionLevel() );
+
+   unsigned int flags = 0;
+   size_t numberOfValues = 1;
+   unsigned int level = 0;
+   ASSERT_GE( H5Pget_filter_by_id2( dcpl, H5Z_FILTER_DEFLATE, &flags, &numberOfValues, &level, 0, 0, 0 ), 0 );
+   EXPECT_EQ( 5u, level );
+
+   numberOfValues = 0;
+   EXPECT_GE( H5Pget_filter_by_id2( dcpl, H5Z_FILTER_SHUFFLE, &flags, &numberOfValues, 0, 0, 0, 0 ), 0 );
+#endif
+
+   // the larger partition is not tiled by the chunks, so they are initialised with the fill value
+   H5D_fill_time_t fillTime;
+   H5Pget_fill_time( dcpl, &fillTime );
+   EXPECT_EQ( size == 1 ? H5D_FILL_TIME_NEVER : H5D_FILL_TIME_IFSET, fillTime );
+
+   H5Pclose( dcpl );
+}
+
+// The chunk shape given by -hdfchunksize, 0 entries are taken from the partition
+TEST( ChunkedDatasetPropertyList, ChunkSizeOption )
+{
+   setOptions( "2,0,5", 0 );
+   EXPECT_TRUE( H5_Parallel_PropertyList::isChunkingEnabled() );
+   EXPECT_EQ( 0, H5_Parallel_PropertyList::getCompressionLevel() );
+
+   hid_t dcpl = createDataset( 4 );
+
+   hsize_t chunk[3] = { 0, 0, 0 };
+   ASSERT_EQ( 3, H5Pget_chunk( dcpl, 3, chunk ));
+   EXPECT_EQ( 2u, chunk[0] );
+   EXPECT_EQ( 6u, chunk[1] );
+   EXPECT_EQ( 5u, chunk[2] );
+
+   // without compression there are no filters
+   EXPECT_EQ( 0, H5Pget_nfilters( dcpl ));
+
+   H5Pclose( dcpl );
+
+   setOptions( 0, 0 );
+}
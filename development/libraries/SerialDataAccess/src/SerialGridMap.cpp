@@ -427,19 +427,17 @@ double SerialGridMap::getAverageValue () const
       return m_averageValue;
    }
 
-   for (unsigned int i = 0; i < static_cast<unsigned int>(m_grid->numI()); i++)
+   // the values are stored in the same order as they are visited by the loops over i, j and k
+   const double * values = m_values ? m_values[0][0] : nullptr;
+   const size_t size = this->numValues ();
+
+   for (size_t n = 0; n < size; ++n)
    {
-      for (unsigned int j = 0; j < static_cast<unsigned int>(m_grid->numJ()); j++)
+      const double value = values ? values[n] : m_singleValue;
+      if (value != m_undefinedValue)
       {
-         for (unsigned int k = 0; k < m_depth; k++)
-         {
-            const double value = getValue (i, j, k);
-            if (value != getUndefinedValue ())
-            {
-               numValues++;
-               total += value;
-            }
-         }
+         numValues++;
+         total += value;
       }
    }
 
@@ -457,19 +455,16 @@ void SerialGridMap::getMinMaxValue (double & min, double & max) const
    min = std::numeric_limits< double >::max();
    max = -std::numeric_limits< double >::max();
 
-   for (unsigned int i = 0; i < static_cast<unsigned int>(m_grid->numI ()); i++)
+   const double * values = m_values ? m_values[0][0] : nullptr;
+   const size_t size = numValues ();
+
+   for (size_t n = 0; n < size; ++n)
    {
-      for (unsigned int j = 0; j < static_cast<unsigned int>(m_grid->numJ ()); j++)
+      const double value = values ? values[n] : m_singleValue;
+      if (value != m_undefinedValue)
       {
-         for (unsigned int k = 0; k < m_depth; k++)
-         {
-            double value = getValue (i, j, k);
-            if (value != getUndefinedValue ())
-            {
-               max = std::max (value, max);
-               min = std::min (value, min);
-            }
-         }
+         max = std::max (value, max);
+         min = std::min (value, min);
       }
    }
    if (min == std::numeric_limits< double >::max() )
@@ -482,18 +477,15 @@ double SerialGridMap::getSumOfValues () const
 {
    double total = 0;
 
-   for (unsigned int i = 0; i < static_cast<unsigned int>(m_grid->numI ()); i++)
+   const double * values = m_values ? m_values[0][0] : nullptr;
+   const size_t size = numValues ();
+
+   for (size_t n = 0; n < size; ++n)
    {
-      for (unsigned int j = 0; j < static_cast<unsigned int>(m_grid->numJ ()); j++)
+      const double value = values ? values[n] : m_singleValue;
+      if (value != m_undefinedValue)
       {
-         for (unsigned int k = 0; k < m_depth; k++)
-         {
-            const double value = getValue (i, j, k);
-            if (value != getUndefinedValue ())
-            {
-               total += value;
-            }
-         }
+         total += value;
       }
    }
 
@@ -504,19 +496,15 @@ double SerialGridMap::getSumOfSquaredValues () const
 {
    double total = 0;
 
-   for (unsigned int i = 0; i < static_cast<unsigned int>(m_grid->numI ()); i++)
+   const double * values = m_values ? m_values[0][0] : nullptr;
+   const size_t size = numValues ();
+
+   for (size_t n = 0; n < size; ++n)
    {
-      for (unsigned int j = 0; j < static_cast<unsigned int>(m_grid->numJ ()); j++)
+      const double value = values ? values[n] : m_singleValue;
+      if (value != m_undefinedValue)
       {
-         for (unsigned int k = 0; k < m_depth; k++)
-         {
-            const double value = getValue (i, j, k);
-
-            if (value != getUndefinedValue ())
-            {
-               total += value * value;
-            }
-         }
+         total += value * value;
       }
    }
 
@@ -527,24 +515,26 @@ int SerialGridMap::getNumberOfDefinedValues () const
 {
    int numValues = 0;
 
-   for (unsigned int i = 0; i < static_cast<unsigned int>(m_grid->numI ()); i++)
+   const double * values = m_values ? m_values[0][0] : nullptr;
+   const size_t size = this->numValues ();
+
+   for (size_t n = 0; n < size; ++n)
    {
-      for (unsigned int j = 0; j < static_cast<unsigned int>(m_grid->numJ ()); j++)
+      const double value = values ? values[n] : m_singleValue;
+      if (value != m_undefinedValue)
       {
-         for (unsigned int k = 0; k < m_depth; k++)
-         {
-            const double value = getValue (i, j, k);
-            if (value != getUndefinedValue ())
-            {
-               numValues++;
-            }
-         }
+         numValues++;
       }
    }
 
    return numValues;
 }
 
+size_t SerialGridMap::numValues () const
+{
+   return static_cast<size_t>(m_grid->numI ()) * static_cast<size_t>(m_grid->numJ ()) * m_depth;
+}
+
 unsigned int SerialGridMap::getDepth () const
 {
    return m_depth;
@@ -560,6 +550,53 @@ double const * const * const * SerialGridMap::getValues () const
    return m_values;
 }
 
+bool SerialGridMap::getValueArray (ConstValueArray & values) const
+{
+   values.firstI = 0;
+   values.firstJ = 0;
+   values.numI = m_grid->numI ();
+   values.numJ = m_grid->numJ ();
+   values.numK = m_depth;
+
+   if (!m_values)
+   {
+      // a constant map stays constant: all points share its single value
+      values.data = &m_singleValue;
+      values.strideI = 0;
+      values.strideJ = 0;
+      values.strideK = 0;
+      return true;
+   }
+
+   values.data = m_values[0][0];
+   values.strideI = static_cast<size_t>(values.numJ) * m_depth;
+   values.strideJ = m_depth;
+   values.strideK = 1;
+
+   return true;
+}
+
+bool SerialGridMap::getValueArray (ValueArray & values)
+{
+   // values are written per point, so a constant map gets its array of values, as with getValues
+   getValues ();
+
+   ConstValueArray constValues;
+   getValueArray (constValues);
+
+   values.data = const_cast<double *>(constValues.data);
+   values.firstI = constValues.firstI;
+   values.firstJ = constValues.firstJ;
+   values.numI = constValues.numI;
+   values.numJ = constValues.numJ;
+   values.numK = constValues.numK;
+   values.strideI = constValues.strideI;
+   values.strideJ = constValues.strideJ;
+   values.strideK = constValues.strideK;
+
+   return true;
+}
+
 void SerialGridMap::printOn (std::ostream & ostr) const
 {
    const unsigned int depth = getDepth ();
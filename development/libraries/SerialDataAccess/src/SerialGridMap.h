@@ -118,6 +118,11 @@ namespace DataAccess
          /// Return the array of values managed by this GridMap
          double const * const * const * getValues() const final;
 
+         /// Get the values for reading; the values along K are contiguous
+         bool getValueArray(ConstValueArray & values) const final;
+         /// Get the values for writing; the values along K are contiguous
+         bool getValueArray(ValueArray & values) final;
+
          /// Print the attributes and map values of this GridMap
               // May not work if user application is compiled under IRIX with CC -lang:std
          void printOn(std::ostream &) const final;
@@ -167,6 +172,9 @@ namespace DataAccess
 
          /// The depth of the third dimension
          unsigned int m_depth;
+
+         /// return the number of values of the map
+         size_t numValues() const;
       };
    }
 }
@@ -438,3 +438,96 @@ TEST( SerialGridMap, SetValues )
    EXPECT_TRUE( sGridMap->isConstant() );
    EXPECT_DOUBLE_EQ( sGridMap->getConstantValue(), 123.456 );
 }
+
+// Bulk access to the values
+TEST( SerialGridMap, ValueArray )
+{
+   std::unique_ptr<DataAccess::Interface::Grid> grid( new DataAccess::Interface::SerialGrid( s_minI, s_minJ, s_maxI, s_maxJ, s_numI, s_numJ ) );
+   std::unique_ptr<DataAccess::Interface::SerialGridMap> sGridMap(
+      new DataAccess::Interface::SerialGridMap(nullptr, 0, grid.get(), s_value, s_depth) );
+
+   DataAccess::Interface::GridMap::ValueArray values;
+   ASSERT_TRUE( sGridMap->getValueArray( values ) );
+   EXPECT_EQ( values.numI, s_numI );
+   EXPECT_EQ( values.numJ, s_numJ );
+   EXPECT_EQ( values.numK, s_depth );
+   EXPECT_EQ( values.strideK, 1 );
+   EXPECT_DOUBLE_EQ( values( 4, 3, 2 ), s_value );
+
+   values( 4, 3, 2 ) = s_subValue;
+   EXPECT_DOUBLE_EQ( sGridMap->getValue( 4u, 3u, 2u ), s_subValue );
+
+   // Rows along I
+   std::vector<double> row( s_numI );
+   for (int i = 0; i < s_numI; ++i) row[i] = i;
+   EXPECT_TRUE( sGridMap->setRow( 1, 2, row ) );
+   EXPECT_FALSE( sGridMap->setRow( s_numJ, 2, row ) );
+   EXPECT_FALSE( sGridMap->setRow( 1, s_depth, row ) );
+   EXPECT_FALSE( sGridMap->setRow( 1, 2, std::vector<double>( 2 ) ) );
+
+   std::vector<double> copy;
+   EXPECT_TRUE( sGridMap->getRow( 1, 2, copy ) );
+   EXPECT_EQ( copy, row );
+   for (int i = 0; i < s_numI; ++i)
+   {
+      EXPECT_DOUBLE_EQ( sGridMap->getValue( (unsigned int)i, 1u, 2u ), i );
+   }
+
+   // Columns along K
+   EXPECT_TRUE( sGridMap->getColumn( 5, 1, copy ) );
+   ASSERT_EQ( copy.size(), s_depth );
+   EXPECT_DOUBLE_EQ( copy[0], s_value );
+   EXPECT_DOUBLE_EQ( copy[2], 5 );
+
+   EXPECT_TRUE( sGridMap->setColumn( 5, 1, std::vector<double>( s_depth, s_subValue ) ) );
+   EXPECT_DOUBLE_EQ( sGridMap->getValue( 5u, 1u, 0u ), s_subValue );
+   EXPECT_FALSE( sGridMap->getColumn( s_numI, 1, copy ) );
+
+   // The whole map, ordered by i, then j, then k
+   std::vector<double> all;
+   EXPECT_TRUE( sGridMap->getAllValues( all ) );
+   ASSERT_EQ( all.size(), s_numI * s_numJ * s_depth );
+   EXPECT_DOUBLE_EQ( all[(4 * s_numJ + 3) * s_depth + 2], s_subValue );
+
+   for (size_t n = 0; n < all.size(); ++n) all[n] = n;
+   EXPECT_TRUE( sGridMap->setAllValues( all ) );
+   EXPECT_DOUBLE_EQ( sGridMap->getValue( 4u, 3u, 2u ), (4 * s_numJ + 3) * s_depth + 2 );
+   EXPECT_DOUBLE_EQ( sGridMap->getSumOfValues(), all.size() * (all.size() - 1) / 2.0 );
+}
+
+// Reading the values of a constant map leaves it constant
+TEST( SerialGridMap, ConstantValueArray )
+{
+   std::unique_ptr<DataAccess::Interface::Grid> grid( new DataAccess::Interface::SerialGrid( s_minI, s_minJ, s_maxI, s_maxJ, s_numI, s_numJ ) );
+   std::unique_ptr<DataAccess::Interface::SerialGridMap> sGridMap(
+      new DataAccess::Interface::SerialGridMap(nullptr, 0, grid.get(), s_value, s_depth) );
+   const DataAccess::Interface::GridMap & constGridMap = *sGridMap;
+
+   DataAccess::Interface::GridMap::ConstValueArray values;
+   ASSERT_TRUE( constGridMap.getValueArray( values ) );
+   EXPECT_EQ( values.numI, s_numI );
+   EXPECT_EQ( values.numJ, s_numJ );
+   EXPECT_EQ( values.numK, s_depth );
+   EXPECT_EQ( values.strideI, 0 );
+   EXPECT_EQ( values.strideJ, 0 );
+   EXPECT_EQ( values.strideK, 0 );
+   EXPECT_DOUBLE_EQ( values( 4, 3, 2 ), s_value );
+
+   std::vector<double> copy;
+   EXPECT_TRUE( constGridMap.getRow( 1, 2, copy ) );
+   EXPECT_EQ( copy, std::vector<double>( s_numI, s_value ) );
+   EXPECT_TRUE( constGridMap.getColumn( 5, 1, copy ) );
+   EXPECT_EQ( copy, std::vector<double>( s_depth, s_value ) );
+   EXPECT_TRUE( constGridMap.getAllValues( copy ) );
+   EXPECT_EQ( copy, std::vector<double>( s_numI * s_numJ * s_depth, s_value ) );
+   EXPECT_TRUE( sGridMap->isConstant() );
+
+   // Writing gives the map its array of values
+   DataAccess::Interface::GridMap::ValueArray writable;
+   ASSERT_TRUE( sGridMap->getValueArray( writable ) );
+   EXPECT_EQ( writable.strideK, 1 );
+   writable( 4, 3, 2 ) = s_subValue;
+   EXPECT_FALSE( sGridMap->isConstant() );
+   EXPECT_DOUBLE_EQ( sGridMap->getValue( 4u, 3u, 1u ), s_value );
+   EXPECT_DOUBLE_EQ( sGridMap->getValue( 4u, 3u, 2u ), s_subValue );
+}
@@ -200,37 +200,8 @@ hid_t H5_Write_File::addDataset (const char *dataname, hid_t locId, hid_t type,
       H5Gunlink (locId, dataname);
    }
 
-   hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
- 
-   int rank = 0;
-   MPI_Comm_rank ( MPI_COMM_WORLD, &rank );
-
-   const hsize_t  * dims =  memspace->dims();
-            
-   hsize_t * chunk= new hsize_t[numDimensions];
-
-   for( int i = 0; i < numDimensions; ++ i ) {
-      chunk[i] =  dims[i];
-   }
-
-   // chunk size must be the same for all ranks
-   MPI_Allreduce ( (void *)dims, chunk, numDimensions, MPI_UNSIGNED_LONG_LONG, MPI_MIN, MPI_COMM_WORLD);
-
-   // H5Pset_cache //chunking cache size. Works only for reading
-
-   // H5Pset_layout(dcpl, H5D_CHUNKED);
-   
-   // hsize_t totsize = 1;
-   // for( int i = 0; i < numDimensions; ++ i ) {
-   //    totsize *= chunk[i];
-   // }
-   // hsize_t cachesize = totsize * sizeof( int );
-   // H5Pset_chunk_cache (dcpl, totsize, cachesize, 1 );
-   
-   H5Pset_chunk(dcpl, numDimensions, chunk);
-
-   delete []chunk;
-
+   // chunk shape and filters are defined by the property list type (chunk size must be the same for all ranks)
+   hid_t dcpl = hPropertyListType->createChunkedDatasetPropertyList( numDimensions, memspace->dims(), space.dims() );
 
    datasetId = H5Dcreate (locId, dataname, type, space.space_id(), H5P_DEFAULT, dcpl, dapl);
 
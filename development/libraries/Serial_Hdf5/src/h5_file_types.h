@@ -42,6 +42,14 @@ public:
       return H5P_DEFAULT;
    }
 
+   // returns dataset creation property list for chunked layout (default: chunk = local size, no filters)
+   virtual hid_t createChunkedDatasetPropertyList( const int numDimensions, const hsize_t * localDims, const hsize_t * globalDims ) const
+   {
+      hid_t dcpl = H5Pcreate( H5P_DATASET_CREATE );
+      H5Pset_chunk( dcpl, numDimensions, localDims );
+      return dcpl;
+   }
+
 };
 
 //
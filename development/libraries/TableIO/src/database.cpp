@@ -19,6 +19,7 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <stdexcept>
 using namespace std;
 
 #include <string.h>
@@ -356,7 +357,11 @@ namespace database {
          }
          else
          {
-            if ( !table->loadFromStream( infile ) ) { return false; }
+            if ( !table->storeFromStream( infile ) )
+            {
+               cerr << "Error occurred during loading table " << line << endl;
+               return false;
+            }
          }
          m_tablesInFile[line] = table != nullptr ? true : false;
       }
@@ -377,7 +382,10 @@ namespace database {
 
 
    Table::Table( const TableDefinition & tableDefinition ) :
-      m_tableDefinition( tableDefinition )
+      m_tableDefinition( tableDefinition ),
+      m_storage( new RecordStorage( tableDefinition ) ),
+      m_numChanges( 0 ),
+      m_pending( false )
    {
       setVersion( tableDefinition.version() );
    }
@@ -393,6 +401,8 @@ namespace database {
 
    void Table::copyTo( Table* table ) const {
 
+      if ( m_pending ) loadPending();
+
       if ( table != nullptr and table->name() == m_tableDefinition.name() ) {
 
          for ( size_t i = 0; i < m_records.size(); ++i ) {
@@ -405,6 +415,10 @@ namespace database {
 
    void Table::clear( bool deleteRecords )
    {
+      // the records that have not been parsed yet are not there for anyone to keep
+      m_pending = false;
+      string().swap( m_pendingText );
+
       if ( deleteRecords )
       {
          for ( RecordListIterator iter = m_records.begin(); iter != m_records.end(); ++iter )
@@ -412,9 +426,15 @@ namespace database {
             Record *record = *iter;
             delete record;
          }
+
+         // Release the memory of the values, unless records that have been copied still use it
+         if ( m_storage.use_count() == 1 )
+            m_storage.reset( new RecordStorage( m_tableDefinition ) );
       }
 
       m_records.clear();
+      m_indices.clear();
+      ++m_numChanges;
    }
 
 
@@ -430,6 +450,7 @@ namespace database {
 
    Table::iterator Table::findRecordPosition( Record * record )
    {
+      if ( m_pending ) loadPending();
       if ( !record ) return end();
 
       Table::iterator iter;
@@ -465,6 +486,7 @@ namespace database {
       if ( iter != end() )
       {
          m_records.erase( iter );
+         ++m_numChanges;
          return true;
       }
       else
@@ -480,13 +502,16 @@ namespace database {
       Table::iterator iter = findRecordPosition( record2 );
 
       m_records.insert( iter, record1 );
+      ++m_numChanges;
       return true;
    }
 
    void Table::addRecord( Record * record )
    {
       // assert (record->getTable () == this);
+      if ( m_pending ) loadPending();
       m_records.push_back( record );
+      ++m_numChanges;
    }
 
 
@@ -499,6 +524,7 @@ namespace database {
       if ( iter != end() )
       {
          m_records.erase( iter );
+         ++m_numChanges;
          delete record;
       }
       return true;
@@ -517,6 +543,7 @@ namespace database {
    {
       if ( iter != end() )
       {
+         ++m_numChanges;
          return ( m_records.erase( iter ) );
       }
 
@@ -528,15 +555,11 @@ namespace database {
       int index = getIndex( fieldName );
       if ( index < 0 ) return 0;
 
-      Table::iterator iter;
-      for ( iter = begin(); iter != end(); ++iter )
-      {
-         Record * record = *iter;
-         const std::string & foundValue = record->getValue<std::string>( index );
+      std::string key;
+      appendToKey( key, value );
 
-         if ( foundValue == value ) return record;
-      }
-      return 0;
+      const std::vector< Record * > * records = findRecords( std::vector< size_t >( 1, index ), key );
+      return records ? records->front() : 0;
    }
 
    Record * Table::findRecord( const std::string & field1, const std::string & value1, const std::string & field2, const std::string & value2, Record * other )
@@ -545,26 +568,109 @@ namespace database {
       int index2 = getIndex( field2 );
       if ( index1 < 0 || index2 < 0 ) return 0;
 
-      Table::iterator iter;
-      for ( iter = begin(); iter != end(); ++iter )
+      std::vector< size_t > fields;
+      fields.push_back( index1 );
+      fields.push_back( index2 );
+
+      std::string key;
+      appendToKey( key, value1 );
+      appendToKey( key, value2 );
+
+      const std::vector< Record * > * records = findRecords( fields, key );
+      if ( !records ) return 0;
+
+      for ( size_t i = 0; i < records->size(); ++i )
       {
-         Record * record = *iter;
-         if ( record != other &&
-              value1 == record->getValue<std::string>( index1 ) &&
-              value2 == record->getValue<std::string>( index2 ) )
-            return record;
+         if ( ( *records )[ i ] != other ) return ( *records )[ i ];
       }
       return 0;
    }
 
+   const std::vector< Record * > * Table::findRecords( const std::vector< size_t > & fields, const std::string & key )
+   {
+      std::vector< RecordIndex >::iterator index;
+      for ( index = m_indices.begin(); index != m_indices.end(); ++index )
+      {
+         if ( index->fields == fields ) break;
+      }
+
+      if ( index == m_indices.end() )
+      {
+         m_indices.push_back( RecordIndex() );
+         index = m_indices.end() - 1;
+         index->fields = fields;
+         buildIndex( *index );
+      }
+      else if ( !isUpToDate( *index ) )
+      {
+         buildIndex( *index );
+      }
+
+      std::unordered_map< std::string, std::vector< Record * > >::const_iterator found = index->records.find( key );
+      return found == index->records.end() ? 0 : &found->second;
+   }
+
+   void Table::buildIndex( RecordIndex & index )
+   {
+      index.numChanges = m_numChanges;
+      index.storages.clear();
+      index.records.clear();
+
+      std::string key;
+      for ( Table::iterator iter = begin(); iter != end(); ++iter )
+      {
+         Record * record = *iter;
+
+         // records copied from another table still have their values there
+         if ( index.storages.empty() || index.storages.back().first != record->m_storage )
+         {
+            size_t i = 0;
+            while ( i < index.storages.size() && index.storages[ i ].first != record->m_storage ) ++i;
+            if ( i == index.storages.size() )
+               index.storages.push_back( std::make_pair( record->m_storage, record->m_storage->numChanges( index.fields ) ) );
+            else
+               std::swap( index.storages[ i ], index.storages.back() );
+         }
+
+         key.clear();
+         for ( size_t i = 0; i < index.fields.size(); ++i )
+            appendToKey( key, record->getValue<std::string>( index.fields[ i ] ) );
+
+         index.records[ key ].push_back( record );
+      }
+   }
+
+   bool Table::isUpToDate( const RecordIndex & index ) const
+   {
+      if ( index.numChanges != m_numChanges ) return false;
+
+      for ( size_t i = 0; i < index.storages.size(); ++i )
+      {
+         if ( index.storages[ i ].first->numChanges( index.fields ) != index.storages[ i ].second ) return false;
+      }
+      return true;
+   }
+
+   void Table::appendToKey( std::string & key, const std::string & value )
+   {
+      // the length goes first, so keys of several values cannot be mixed up
+      const size_t length = value.size();
+      key.append( reinterpret_cast<const char *>( &length ), sizeof( length ) );
+      key.append( value );
+   }
+
    void Table::sort( OrderingFunc func )
    {
+      if ( m_pending ) loadPending();
       std::sort( m_records.begin(), m_records.end(), func );
+      ++m_numChanges;
    }
 
    void Table::stable_sort( OrderingFunc func )
    {
+      if ( m_pending ) loadPending();
       std::stable_sort( m_records.begin(), m_records.end(), func );
+      ++m_numChanges;
    }
 
    struct LocalTableSorter
@@ -622,7 +728,9 @@ namespace database {
 
    void Table::stable_sort( const std::vector<std::string> & fldList )
    {
+      if ( m_pending ) loadPending();
       std::stable_sort( m_records.begin(), m_records.end(), LocalTableSorter( this, fldList ) );
+      ++m_numChanges;
    }
 
    void Table::unique( EqualityFunc equalityFunc, MergeFunc mergeFunc )
@@ -640,6 +748,7 @@ namespace database {
             }
 
             m_records.erase( iter + 1 );
+            ++m_numChanges;
             delete recordNext;
          }
          else
@@ -675,6 +784,18 @@ namespace database {
    {
       ofile << ";" << endl;
 
+      if ( m_pending )
+      {
+         // not accessed since it was read, so written back as it was
+         ofile << "; " << m_tableDefinition.description() << endl;
+         ofile << ";" << endl;
+         ofile << "[" << m_tableDefinition.name() << "]" << endl;
+         ofile << m_pendingText;
+         ofile << ";" << endl;
+
+         return !ofile.fail();
+      }
+
       bool rowBased;
 
       if ( static_cast<int>(m_tableDefinition.size()) > Database::GetMaxFieldsPerLine() )
@@ -703,6 +824,8 @@ namespace database {
 
    bool Table::loadFromStream( istream & infile )
    {
+      if ( m_pending ) loadPending();
+
       vector < int >dataToFieldMap;
 
       string line;
@@ -734,6 +857,122 @@ namespace database {
       }
    }
 
+   namespace
+   {
+      size_t findWordInLine( const string & line, size_t linePos, const char * & word, size_t & length, string & buffer );
+   }
+
+   bool Table::storeFromStream( istream & infile )
+   {
+      // records are added to the ones there are already, which only parsing can do
+      if ( m_pending || !m_records.empty() )
+         return loadFromStream( infile );
+
+      string line;
+      while ( true )
+      {
+         getline( infile, line, '\n' );
+         if ( infile.eof() ) { return false; }
+
+         m_pendingText += line;
+         m_pendingText += '\n';
+
+         // same end of table as findAndRemoveDelimiters( line, "[]" ) && line == "End"
+         if ( line.compare( 0, 5, "[End]" ) == 0 ) break;
+      }
+
+      m_pending = true;
+
+      // a table that cannot be parsed fails to load now, not when it is first accessed
+      if ( !checkPending() )
+      {
+         clear( true );
+         return false;
+      }
+
+      return true;
+   }
+
+   bool Table::checkPending()
+   {
+      istringstream infile( m_pendingText );
+
+      string line;
+
+      if ( !loadLine( infile, line, true ) ) { return false; }
+
+      if ( line.find( ";v" ) == 0 )
+      {
+         // throws for a version that is not a number, as parsing does
+         stoi( line.substr( 2 ) );
+         if ( !loadLine( infile, line ) ) { return false; }
+      }
+
+      if ( findAndRemoveDelimiters( line, "[]" ) && line == "End" )
+      {
+         return true;
+      }
+      else if ( findAndRemoveDelimiters( line, "<>" ) && line == "Row" )
+      {
+         // row-based tables are rare and small, these are parsed straight away
+         m_pending = false;
+
+         istringstream lines( m_pendingText );
+         const bool loaded = loadFromStream( lines );
+         string().swap( m_pendingText );
+         return loaded;
+      }
+
+      // the fields of each record line are found as Record::loadFromLine does, without storing their values
+      vector < int >dataToFieldMap;
+      if ( !loadDataToFieldMapFromLine( line, dataToFieldMap ) ) { return false; }
+      if ( !loadUnitsFromStream(        infile               ) ) { return false; }
+
+      string buffer;
+      while ( true )
+      {
+         if ( !loadLine( infile, line ) )
+            return false;
+         if ( findAndRemoveDelimiters( line, "[]" ) && line == "End" )
+            return true;
+
+         size_t linePos = 0;
+         for ( size_t field = 0; field < dataToFieldMap.size(); ++field )
+         {
+            if ( linePos == string::npos )
+               return false;
+
+            const char * word;
+            size_t length;
+            linePos = findWordInLine( line, linePos, word, length, buffer );
+         }
+      }
+   }
+
+   void Table::loadPending() const
+   {
+      // parsing the records does not change the table as seen from outside
+      Table * table = const_cast<Table *>( this );
+      table->m_pending = false;
+
+      istringstream infile( m_pendingText );
+
+      if ( !table->loadFromStream( infile ) )
+      {
+         // not expected, storeFromStream has checked the lines
+         // drop the records parsed so far, but keep the lines: the table is still written back as it was read
+         string text;
+         text.swap( table->m_pendingText );
+         table->clear( true );
+         table->m_pendingText.swap( text );
+         table->m_pending = true;
+
+         throw std::runtime_error( "Error occurred during loading table " + m_tableDefinition.name() );
+      }
+
+      string().swap( table->m_pendingText );
+   }
+
    bool Table::loadDataToFieldMapFromLine( string & line, vector < int >&dataToFieldMap )
    {
       size_t fieldNameStartPos = 0;
@@ -792,6 +1031,7 @@ namespace database {
    bool Table::loadRecordsFromStream( istream & infile, vector < int >&dataToFieldMap )
    {
       string line;
+      string buffer;
 
       while ( true )
       {
@@ -802,7 +1042,7 @@ namespace database {
 
          Record *record = createRecord();
 
-         if ( !record->loadFromLine( line, dataToFieldMap ) )
+         if ( !record->loadFromLine( line, dataToFieldMap, buffer ) )
             return false;
       }
    }
@@ -853,228 +1093,378 @@ namespace database {
    }
 
 
-   Record::Record( const TableDefinition & tableDefinition, Table * table )
-      : m_table( table ), m_tableDefinition( tableDefinition )
+   namespace
    {
-      createFields();
+      bool saveValue( const bool & value, ostream & ofile, int &borrowed )
+      {
+         string valueString = value == false ? "false" : "true";
+
+         return saveStringToStream( ofile, valueString, borrowed, Database::GetFieldWidth() );
+      }
+
+      bool saveValue( const string & value, ostream & ofile, int &borrowed )
+      {
+         const string quote = "\"";
+
+         string valueString = value;
+
+         size_t wordQuotePos;
+         size_t wordStartPos = 0;
+
+         do
+         {
+            wordQuotePos = valueString.find_first_of( quote, wordStartPos );
+            if ( wordQuotePos != string::npos )
+            {
+               valueString.insert( wordQuotePos, "\\" );
+               wordStartPos = wordQuotePos + 2;
+            }
+            else
+            {
+               break;
+            }
+         } while ( true );
+
+         valueString.insert( 0, "\"" );
+         valueString += "\"";
+
+         return saveStringToStream( ofile, valueString, borrowed, Database::GetFieldWidth() );
+      }
+
+      template < class Type > bool saveValue( const Type & value, ostream & ofile, int &borrowed )
+      {
+         std::ostringstream buf;
+         buf.precision( Database::GetPrecision() );
+         buf << value;
+         std::string return_string = buf.str();
+
+         return saveStringToStream( ofile, return_string, borrowed, Database::GetFieldWidth() );
+      }
+
+      // The word is not necessarily null-terminated, but it is always followed by a character that ends a number
+      bool assignValue( bool & value, const char * word, size_t length )
+      {
+         if ( length == 0 )
+            return false;
+
+         value = !( length == 5 && strncmp( word, "false", 5 ) == 0 );
+
+         return true;
+      }
+
+      bool assignValue( string & value, const char * word, size_t length )
+      {
+         if ( length == 0 )
+            return false;
+
+         value.assign( word, length );
+         return true;
+      }
+
+      bool assignValue( int & value, const char * word, size_t length )
+      {
+         if ( length == 0 )
+            return false;
+
+         value = atoi( word );
+
+         return true;
+      }
+
+      bool assignValue( long & value, const char * word, size_t length )
+      {
+         if ( length == 0 )
+            return false;
+
+         value = atol( word );
+
+         return true;
+      }
+
+      bool assignValue( float & value, const char * word, size_t length )
+      {
+         if ( length == 0 )
+            return false;
+
+         value = (float)atof( word );
+
+         return true;
+      }
+
+      bool assignValue( double & value, const char * word, size_t length )
+      {
+         if ( length == 0 )
+            return false;
+
+         value = atof( word );
+
+         return true;
+      }
+
+      /// Same as loadWordFromLine, but without copying the word: it points into the line,
+      /// or into the buffer if the word is quoted
+      size_t findWordInLine( const string & line, size_t linePos, const char * & word, size_t & length, string & buffer )
+      {
+         const char * separators = " \t";
+
+         word = line.c_str() + line.size();
+         length = 0;
+
+         size_t wordStartPos = line.find_first_not_of( separators, linePos );
+         if ( wordStartPos == string::npos )
+            return string::npos;
+
+         size_t wordEndPos;
+         if ( line[ wordStartPos ] == '"' )
+         {
+            buffer.clear();
+            do
+            {
+               wordEndPos = line.find( '"', wordStartPos + 1 );
+               if ( wordEndPos == string::npos )
+               {
+                  word = buffer.c_str();
+                  length = buffer.size();
+                  return string::npos;
+               }
+
+               if ( line[ wordEndPos - 1 ] != '\\' )
+               {
+                  buffer.append( line, wordStartPos + 1, wordEndPos - ( wordStartPos + 1 ) );
+                  break;
+               }
+
+               // escaped quote
+               buffer.append( line, wordStartPos + 1, ( wordEndPos - 1 ) - ( wordStartPos + 1 ) );
+               buffer += '"';
+               wordStartPos = wordEndPos;
+            } while ( true );
+
+            word = buffer.c_str();
+            length = buffer.size();
+         }
+         else
+         {
+            wordEndPos = line.find_first_of( separators, wordStartPos + 1 );
+            word = line.c_str() + wordStartPos;
+            length = ( wordEndPos == string::npos ? line.size() : wordEndPos ) - wordStartPos;
+         }
+
+         return wordEndPos + 1;
+      }
    }
 
-   Record::Record( const Record & other )
-      : m_table( other.m_table ),
-      m_tableDefinition( other.m_tableDefinition ),
-      m_fields()
+   template < class Type > Column < Type >::Column( const FieldDefinition & fieldDef )
+      : AbstractColumn( fieldDef ), m_numRows( 0 ), m_default()
    {
-      for ( size_t i = 0; i < other.m_fields.size(); ++i )
-         m_fields.push_back( other.m_fields[ i ]->clone() );
+      const string & defaultValue = fieldDef.defaultValue();
+      assignValue( m_default, defaultValue.c_str(), defaultValue.size() );
    }
 
-   Record::Record( const Record & record, Table * table )
-      : m_table( table ),
-      m_tableDefinition( table->getTableDefinition() ),
-      m_fields()
+   template < class Type > void Column < Type >::resize( size_t numRows )
    {
-      for ( size_t i = 0; i < record.m_fields.size(); ++i ) {
-         m_fields.push_back( record.m_fields[ i ]->clone() );
-      }
+      while ( m_blocks.size() * BlockSize < numRows )
+         m_blocks.push_back( std::unique_ptr< Type[] >( new Type[ BlockSize ] ) );
+
+      for ( ; m_numRows < numRows; ++m_numRows )
+         ( *this )[ m_numRows ] = m_default;
    }
 
+   template < class Type > void Column < Type >::setDefault( size_t row )
+   {
+      ( *this )[ row ] = m_default;
+      ++m_numChanges;
+   }
 
-   Record* Record::deepCopy( Table * table ) const {
+   template < class Type > void Column < Type >::copy( size_t row, const AbstractColumn & from, size_t fromRow )
+   {
+      ( *this )[ row ] = static_cast< const Column < Type > & >( from )[ fromRow ];
+      ++m_numChanges;
+   }
 
-      Record* newRecord = nullptr;
+   template < class Type > bool Column < Type >::assignFromString( size_t row, const char * word, size_t length )
+   {
+      ++m_numChanges;
+      return assignValue( ( *this )[ row ], word, length );
+   }
 
-      if ( table != nullptr and table->name() == m_table->name() ) {
-         newRecord = new Record( *this, table );
-      }
+   template < class Type > bool Column < Type >::saveToStream( size_t row, ostream & ofile, int &borrowed ) const
+   {
+      return saveValue( ( *this )[ row ], ofile, borrowed );
+   }
 
-      return newRecord;
+
+   RecordStorage::RecordStorage( const TableDefinition & tableDefinition )
+      : m_tableDefinition( tableDefinition ), m_numRows( 0 )
+   {
+      addColumns();
    }
 
-   void Record::createFields( void )
+   void RecordStorage::addColumns( void )
    {
-      for ( size_t i = 0; i < m_tableDefinition.size(); i++ )
+      // fields can be added to the table definition after the table has been created
+      for ( size_t i = m_columns.size(); i < m_tableDefinition.size(); i++ )
       {
-         FieldDefinition *fieldDef = m_tableDefinition.getFieldDefinition( i );
+         const FieldDefinition & fieldDef = *m_tableDefinition.getFieldDefinition( i );
 
-         std::shared_ptr<AbstractField> field;
+         std::unique_ptr<AbstractColumn> column;
 
-         switch ( fieldDef->dataType() )
+         switch ( fieldDef.dataType() )
          {
          case Bool:
-            field.reset( new Field < bool >( *fieldDef ) );
+            column.reset( new Column < bool >( fieldDef ) );
 
             break;
          case Int:
-            field.reset( new Field < int >( *fieldDef ) );
+            column.reset( new Column < int >( fieldDef ) );
 
             break;
          case Long:
-            field.reset( new Field < long >( *fieldDef ) );
+            column.reset( new Column < long >( fieldDef ) );
 
             break;
          case Float:
-            field.reset( new Field < float >( *fieldDef ) );
+            column.reset( new Column < float >( fieldDef ) );
 
             break;
          case Double:
-            field.reset( new Field < double >( *fieldDef ) );
+            column.reset( new Column < double >( fieldDef ) );
 
             break;
          case String:
-            field.reset( new Field < string >( *fieldDef ) );
+            column.reset( new Column < string >( fieldDef ) );
 
             break;
          default:
             assert( false );
          }
 
-         m_fields.push_back( field );
-      }
-   }
+         if ( column )
+            column->resize( m_numRows );
 
-   const std::string & Record::tableName() const
-   {
-      return getTable()->name();
+         m_columns.push_back( std::move( column ) );
+      }
    }
 
-   void Record::destroyYourself( void )
+   size_t RecordStorage::addRow( void )
    {
-      getTable()->deleteRecord( this );
-   }
+      addColumns();
 
-   void Record::addToTable( void )
-   {
-      getTable()->addRecord( this );
-   }
+      if ( !m_freeRows.empty() )
+      {
+         const size_t row = m_freeRows.back();
+         m_freeRows.pop_back();
 
-   std::shared_ptr<AbstractField> Record::getField( const string & name, int *cachedIndex ) const
-   {
-      int hint = ( cachedIndex ? *cachedIndex : -1 );
+         for ( size_t i = 0; i < m_columns.size(); ++i )
+            m_columns[ i ]->setDefault( row );
 
-      int index = m_tableDefinition.getIndex( name, hint );
+         return row;
+      }
 
-      if ( cachedIndex )
-         *cachedIndex = index;
+      ++m_numRows;
+      for ( size_t i = 0; i < m_columns.size(); ++i )
+         m_columns[ i ]->resize( m_numRows );
 
-      return index == -1 ? std::shared_ptr<AbstractField>() : m_fields[ index ];
+      return m_numRows - 1;
    }
 
-   template <> bool Field < bool >::saveToStream( ostream & ofile, int &borrowed )
+   size_t RecordStorage::copyRow( const RecordStorage & from, size_t fromRow )
    {
+      const size_t row = addRow();
 
-      string valueString = m_value == false ? "false" : "true";
+      // the other storage may belong to a table of another schema; only matching fields are copied
+      const size_t numColumns = std::min( m_columns.size(), from.m_columns.size() );
+      for ( size_t i = 0; i < numColumns; ++i )
+      {
+         if ( m_columns[ i ]->getFieldDefinition().dataType() == from.m_columns[ i ]->getFieldDefinition().dataType() )
+            m_columns[ i ]->copy( row, *from.m_columns[ i ], fromRow );
+      }
 
-      return saveStringToStream( ofile, valueString, borrowed, Database::GetFieldWidth() );
+      return row;
    }
 
-   template <> bool Field < string >::saveToStream( ostream & ofile, int &borrowed )
+   void RecordStorage::removeRow( size_t row )
    {
-      const string quote = "\"";
-
-      string valueString = m_value;
-
-      size_t wordQuotePos;
-      size_t wordStartPos = 0;
-
-      do
-      {
-         wordQuotePos = valueString.find_first_of( quote, wordStartPos );
-         if ( wordQuotePos != string::npos )
-         {
-            valueString.insert( wordQuotePos, "\\" );
-            wordStartPos = wordQuotePos + 2;
-         }
-         else
-         {
-            break;
-         }
-      } while ( true );
-
-      valueString.insert( 0, "\"" );
-      valueString += "\"";
-
-      return saveStringToStream( ofile, valueString, borrowed, Database::GetFieldWidth() );
+      m_freeRows.push_back( row );
    }
 
-
-   template < class Type > bool Field < Type >::saveToStream( ostream & ofile, int &borrowed )
+   size_t RecordStorage::numChanges( const std::vector< size_t > & indices ) const
    {
-
-      std::ostringstream buf;
-      buf.precision( Database::GetPrecision() );
-      buf << m_value;
-      std::string return_string = buf.str();
-
-      return saveStringToStream( ofile, return_string, borrowed, Database::GetFieldWidth() );
+      size_t numChanges = 0;
+      for ( size_t i = 0; i < indices.size(); ++i )
+      {
+         if ( indices[ i ] < m_columns.size() ) numChanges += m_columns[ indices[ i ] ]->numChanges();
+      }
+      return numChanges;
    }
 
 
-   template < class Type > bool Field < Type >::assignFromString( const string & word )
+   Record::Record( const TableDefinition & tableDefinition, Table * table )
+      : m_table( table ), m_tableDefinition( tableDefinition ),
+      m_storage( table ? table->m_storage : std::make_shared<RecordStorage>( tableDefinition ) )
    {
-      assert( false );
-      return false;
+      m_row = m_storage->addRow();
    }
 
-   template <> bool Field < bool >::assignFromString( const string & word )
+   Record::Record( const Record & other )
+      : m_table( other.m_table ),
+      m_tableDefinition( other.m_tableDefinition ),
+      m_storage( other.m_storage )
    {
-      if ( word.length() == 0 )
-         return false;
-
-      if ( word == "false" )
-         m_value = false;
-      else
-         m_value = true;
-
-      return true;
+      m_row = m_storage->copyRow( *other.m_storage, other.m_row );
    }
 
-   template <> bool Field < string >::assignFromString( const string & word )
+   Record::Record( const Record & record, Table * table )
+      : m_table( table ),
+      m_tableDefinition( table->getTableDefinition() ),
+      m_storage( table->m_storage )
    {
-      if ( word.length() == 0 )
-         return false;
-
-      m_value = word;
-      return true;
+      m_row = m_storage->copyRow( *record.m_storage, record.m_row );
    }
 
-   template <> bool Field < int >::assignFromString( const string & word )
+   Record::~Record( void )
    {
-      if ( word.length() == 0 )
-         return false;
+      m_storage->removeRow( m_row );
+   }
 
-      m_value = atoi( word.c_str() );
 
-      return true;
-   }
+   Record* Record::deepCopy( Table * table ) const {
 
-   template <> bool Field < long >::assignFromString( const string & word )
-   {
-      if ( word.length() == 0 )
-         return false;
+      Record* newRecord = nullptr;
 
-      m_value = atol( word.c_str() );
+      if ( table != nullptr and table->name() == m_table->name() ) {
+         newRecord = new Record( *this, table );
+      }
 
-      return true;
+      return newRecord;
    }
 
-   template <> bool Field < float >::assignFromString( const string & word )
+   const std::string & Record::tableName() const
    {
-      if ( word.length() == 0 )
-         return false;
+      return getTable()->name();
+   }
 
-      m_value = (float)atof( word.c_str() );
+   void Record::destroyYourself( void )
+   {
+      getTable()->deleteRecord( this );
+   }
 
-      return true;
+   void Record::addToTable( void )
+   {
+      getTable()->addRecord( this );
    }
 
-   template <> bool Field < double >::assignFromString( const string & word )
+   size_t Record::getFieldIndex( const string & name, int *cachedIndex ) const
    {
-      if ( word.length() == 0 )
-         return false;
+      int hint = ( cachedIndex ? *cachedIndex : -1 );
 
-      m_value = atof( word.c_str() );
+      int index = m_tableDefinition.getIndex( name, hint );
 
-      return true;
+      if ( cachedIndex )
+         *cachedIndex = index;
+
+      assert( index != -1 );
+      return index;
    }
 
    void Record::printOn( ostream & str )
@@ -1099,12 +1489,13 @@ namespace database {
          {
             borrowed = 0;
 
-            const FieldDefinition & fieldDef = m_fields[ position ]->getFieldDefinition();
+            const AbstractColumn & column = m_storage->column( position );
+            const FieldDefinition & fieldDef = column.getFieldDefinition();
 
             fieldDef.saveNameToStream( ofile, borrowed );
             ofile << "      ";
 
-            m_fields[ position ]->saveToStream( ofile, borrowed );
+            column.saveToStream( m_row, ofile, borrowed );
             ofile << "      ";
 
             fieldDef.saveUnitToStream( ofile, borrowed );
@@ -1117,7 +1508,7 @@ namespace database {
                ofile << " ";
             }
 
-            m_fields[ position ]->saveToStream( ofile, borrowed );
+            m_storage->column( position ).saveToStream( m_row, ofile, borrowed );
          }
       }
 
@@ -1127,21 +1518,22 @@ namespace database {
    }
 
 
-   bool Record::loadFromLine( const std::string & line, vector < int > & dataToFieldMap )
+   bool Record::loadFromLine( const std::string & line, vector < int > & dataToFieldMap, std::string & buffer )
    {
       size_t linePos = 0;
 
       for ( vector < int >::iterator mapIter = dataToFieldMap.begin();
             mapIter != dataToFieldMap.end(); ++mapIter )
       {
-         string fieldValue;
+         const char * word;
+         size_t length;
 
          if (linePos == string::npos)
          {
             return false;
          }
 
-         linePos = loadWordFromLine( line, linePos, fieldValue );
+         linePos = findWordInLine( line, linePos, word, length, buffer );
 
          int toIndex = *mapIter;
 
@@ -1151,10 +1543,8 @@ namespace database {
             continue;
          }
 
-         if (!assignFromStringToIndex(fieldValue, toIndex))
-         {
-            return false;
-         }
+         // values are parsed in place, straight into the column of the field
+         m_storage->column( toIndex ).assignFromString( m_row, word, length );
       }
 
       return true;
@@ -1164,7 +1554,7 @@ namespace database {
    {
       FieldDefinition *fieldDef = m_tableDefinition.getFieldDefinition( toIndex );
       assert( fieldDef->isValid() );
-      getField( toIndex )->assignFromString( word );
+      m_storage->column( toIndex ).assignFromString( m_row, word.c_str(), word.size() );
 
       return true;
    }
@@ -20,6 +20,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 using std::istream;
@@ -40,70 +41,118 @@ namespace database
    template <> void checkType < double >(       const double      &a, const datatype::DataType type );
    template <> void checkType < std::string > ( const std::string &a, const datatype::DataType type );
 
-   /// Fields contain the values of a Record.
-   /// This class is a template because we need a different Field class for different types,
+   /// Columns contain the values of one field for all Records of a Table.
+   /// This class is a template because we need a different Column class for different types,
    /// e.g. int, long, double, float, string.
+   /// Values are stored in contiguous blocks that are never moved, so references to values stay valid while rows are added.
    /// This class is used only for implementation purposes.
-   class AbstractField
+   class AbstractColumn
    {
       public:
-         virtual ~AbstractField() {}
+         virtual ~AbstractColumn() {}
 
-         explicit AbstractField( const FieldDefinition & fieldDefinition )
-            : m_fieldDefinition(fieldDefinition)
+         explicit AbstractColumn( const FieldDefinition & fieldDefinition )
+            : m_numChanges(0), m_fieldDefinition(fieldDefinition)
          {}
 
          const FieldDefinition & getFieldDefinition() const
          { return m_fieldDefinition; }
 
-         std::shared_ptr<AbstractField> clone() const
-         { return std::shared_ptr<AbstractField>( doClone() ); }
+         /// number of times a value has been assigned, to find out whether the column has changed
+         size_t numChanges() const
+         { return m_numChanges; }
 
-         virtual bool assignFromString (const std::string & word) = 0;
-         virtual bool saveToStream (ostream & ofile, int &borrowed) = 0;
+         /// add rows until the column has the given number of rows, with the default value
+         virtual void resize (size_t numRows) = 0;
+         /// set the value of a row to the default value
+         virtual void setDefault (size_t row) = 0;
+         /// copy the value of a row of another column of the same type
+         virtual void copy (size_t row, const AbstractColumn & from, size_t fromRow) = 0;
 
-      private:
-         virtual AbstractField * doClone() const = 0;
+         virtual bool assignFromString (size_t row, const char * word, size_t length) = 0;
+         virtual bool saveToStream (size_t row, ostream & ofile, int &borrowed) const = 0;
+
+      protected:
+         size_t m_numChanges;
 
+      private:
          const FieldDefinition & m_fieldDefinition;
    };
 
-   template < class Type > class Field : public AbstractField
+   template < class Type > class Column : public AbstractColumn
    {
       public:
-         virtual ~Field() {}
+         explicit Column (const FieldDefinition & fieldDef);
 
-         /// save the value to a stream.
-         bool saveToStream (ostream & ofile, int &borrowed);
+         Type & operator[] (size_t row)
+         { return m_blocks[row >> BlockShift][row & BlockMask]; }
 
-         explicit Field (const FieldDefinition & fieldDef)
-            : AbstractField(fieldDef)
+         const Type & operator[] (size_t row) const
+         { return m_blocks[row >> BlockShift][row & BlockMask]; }
+
+         void set (size_t row, const Type & value)
          {
-            assignFromString(fieldDef.defaultValue());
+            (*this)[row] = value;
+            ++m_numChanges;
          }
 
+         virtual void resize (size_t numRows);
+         virtual void setDefault (size_t row);
+         virtual void copy (size_t row, const AbstractColumn & from, size_t fromRow);
+
+         virtual bool assignFromString (size_t row, const char * word, size_t length);
+         virtual bool saveToStream (size_t row, ostream & ofile, int &borrowed) const;
+
+      private:
+         static const size_t BlockShift = 8;
+         static const size_t BlockSize = size_t(1) << BlockShift;
+         static const size_t BlockMask = BlockSize - 1;
+
+         std::vector< std::unique_ptr< Type[] > > m_blocks;
+         size_t m_numRows;
+         Type m_default;
+   };
 
-         void setValue (const Type & value)
+   /// The values of the Records of a Table, stored column-wise: one typed Column per field.
+   /// Each Record refers to a row in here. The storage is shared between the Table and its Records,
+   /// so Records that are copied into, or outlive, another Table keep their values.
+   /// This class is used only for implementation purposes.
+   class RecordStorage
+   {
+      public:
+         explicit RecordStorage (const TableDefinition & tableDefinition);
+
+         /// add a row with default values and return its index
+         size_t addRow();
+         /// add a row with the values of a row of another storage and return its index
+         size_t copyRow (const RecordStorage & from, size_t fromRow);
+         /// make a row available for reuse
+         void removeRow (size_t row);
+
+         /// return the total number of changes of the columns with the given indices
+         size_t numChanges (const std::vector< size_t > & indices) const;
+
+         AbstractColumn & column (size_t index)
          {
-            checkType < Type > (value, getFieldDefinition().dataType ());
-            m_value = value;
+            assert( index < m_columns.size() );
+            return *m_columns[index];
          }
 
-         const Type & getValue() const
+         template < class Type >
+         Column < Type > & column (size_t index)
          {
-            checkType < Type > (m_value, getFieldDefinition().dataType ());
-            return m_value;
+            AbstractColumn & col = column (index);
+            checkType < Type > (Type(), col.getFieldDefinition().dataType ());
+            return static_cast< Column < Type > & >(col);
          }
 
-         virtual bool assignFromString (const std::string & word);
-
       private:
-         virtual Field<Type> * doClone() const
-         {
-            return new Field<Type>( *this );
-         }
+         void addColumns();
 
-         Type m_value;
+         const TableDefinition & m_tableDefinition;
+         std::vector< std::unique_ptr< AbstractColumn > > m_columns;
+         std::vector< size_t > m_freeRows;
+         size_t m_numRows;
    };
 
 
@@ -113,7 +162,7 @@ namespace database
    {
    public:
       // destructor
-      ~Record() {}
+      ~Record();
 
       /// print the record's content
       void printOn (ostream &);
@@ -131,25 +180,25 @@ namespace database
       template <typename Type>
       void setValue (size_t index, const Type & value)
       {
-         std::dynamic_pointer_cast< Field < Type > >(getField (index))->setValue(value);
+         m_storage->column < Type > (index).set (m_row, value);
       }
 
       template < class Type >
       void setValue (const std::string & fieldName, const Type & value, int * cachedIndex = nullptr) const
       {
-         std::dynamic_pointer_cast< Field < Type > >( getField (fieldName, cachedIndex) )->setValue(value);
+         m_storage->column < Type > (getFieldIndex (fieldName, cachedIndex)).set (m_row, value);
       }
 
       template <typename Type>
       const Type & getValue (size_t index) const
       {
-         return std::dynamic_pointer_cast< const Field < Type > >(getField (index))->getValue();
+         return m_storage->column < Type > (index)[m_row];
       }
 
       template < class Type >
       const Type & getValue (const std::string & fieldName, int * cachedIndex = nullptr) const
       {
-         return std::dynamic_pointer_cast< const Field < Type > >( getField (fieldName, cachedIndex) )->getValue();
+         return m_storage->column < Type > (getFieldIndex (fieldName, cachedIndex))[m_row];
       }
 
       Record (const TableDefinition & tableDefinition, Table * table);
@@ -172,16 +221,7 @@ namespace database
    private:
       friend class Table;
 
-      typedef std::vector< std::shared_ptr< AbstractField > > FieldList;
-      typedef FieldList::iterator FieldListIterator;
-
-      std::shared_ptr<AbstractField> getField (size_t index) const { return m_fields[index]; }
-
-      std::shared_ptr<AbstractField> getField(const std::string & name, int * index) const;
-
-      // Record (const TableDefinition & tableDefinition, Table * table);
-      //      Record (Record & record);
-      void createFields();
+      size_t getFieldIndex (const std::string & name, int * cachedIndex) const;
 
       void destroyYourself();
       void addToTable();
@@ -190,13 +230,14 @@ namespace database
       bool saveToStream (ostream & ofile, bool rowBased);
       bool saveFieldToStream (ostream & ofile, int fieldIndex, int &borrowed);
 
-      bool loadFromLine (const std::string & line, std::vector < int >&dataToFieldMap);
+      bool loadFromLine (const std::string & line, std::vector < int >&dataToFieldMap, std::string & buffer);
       bool assignFromStringToIndex (const std::string & word, int toIndex);
 
 
       Table * m_table;
       const TableDefinition & m_tableDefinition;
-      FieldList m_fields;
+      std::shared_ptr< RecordStorage > m_storage;
+      size_t m_row;
    };
 
 
@@ -258,7 +299,7 @@ namespace database
       const std::string & name() { return m_tableDefinition.name(); }
 
       /// return verision of data schema in which this table was written. Used in table upgrade scheme
-      int version() { return m_version; }
+      int version() { if (m_pending) loadPending(); return m_version; }
 
       Record * getRecord (const Table::iterator & iter) const;
 
@@ -266,14 +307,17 @@ namespace database
       const TableDefinition & getTableDefinition () const;
 
       /// Return the number of Records in the Table.
-      size_t size() { return m_records.size(); }
+      size_t size() { if (m_pending) loadPending(); return m_records.size(); }
 
       /// Return the Record at the specified index
       Record *getRecord (int i);
       /// Return the Record at the specified index
       Record *operator[] (int i);
 
-      /// Find a record in which the specified field has the specified value
+      /// Find the first record in which the specified field has the specified value
+      /// The records are looked up in a hash index on the field, which is built by the first search
+      /// and rebuilt by the first search after records are added, removed or sorted, or after values of the field are changed.
+      /// Reordering the records through the iterators of the table is not noticed; use sort() instead.
       Record * findRecord( const std::string & fieldName, const std::string & value );
       Record * findRecord( const std::string & field1, const std::string & value1, const std::string & field2,
                            const std::string & value2, Record * other = nullptr);
@@ -319,6 +363,37 @@ namespace database
       const TableDefinition & m_tableDefinition;
       RecordList m_records;
       int        m_version;
+      std::shared_ptr< RecordStorage > m_storage; // values of the records, column-wise
+
+      /// Hash index on the values of one or more string fields, in use by findRecord
+      struct RecordIndex
+      {
+         std::vector< size_t > fields;
+         size_t numChanges;   // number of changes of the table when the index was built
+         std::vector< std::pair< std::shared_ptr< RecordStorage >, size_t > > storages; // with their number of changes of the fields
+         std::unordered_map< std::string, std::vector< Record * > > records; // in the order of the table
+      };
+
+      std::vector< RecordIndex > m_indices;
+      size_t m_numChanges; // number of times records have been added, removed or reordered
+
+      /// A Table read from file keeps the lines of its records until it is first accessed, only then these are parsed.
+      /// A Table that is never accessed is written back as it was read.
+      bool        m_pending;
+      std::string m_pendingText;
+
+      /// Keep the lines of the table, these are checked such that the file fails to load if they cannot be parsed
+      bool storeFromStream (istream & infile);
+      /// Check that the pending lines can be parsed, row-based tables are parsed straight away
+      bool checkPending();
+      /// Parse the pending lines; throws std::runtime_error if these cannot be parsed after all, leaving the lines pending
+      void loadPending() const;
+
+      /// return the records that have the given key in the index on the given fields
+      const std::vector< Record * > * findRecords( const std::vector< size_t > & fields, const std::string & key );
+      void buildIndex( RecordIndex & index );
+      bool isUpToDate( const RecordIndex & index ) const;
+      static void appendToKey( std::string & key, const std::string & value );
 
       explicit Table (const TableDefinition & tableDefinition);
       ~Table();
@@ -514,6 +589,7 @@ namespace database
 
    inline Record *Table::getRecord (int i)
    {
+      if (m_pending) loadPending();
       if (i >= 0 && i < static_cast<int>(size ()))
          return m_records[i];
       else
@@ -527,21 +603,25 @@ namespace database
 
    inline Table::iterator Table::begin()
    {
+      if (m_pending) loadPending();
       return m_records.begin ();
    }
 
    inline Table::iterator Table::end()
    {
+      if (m_pending) loadPending();
       return m_records.end ();
    }
 
    inline Table::const_iterator Table::begin() const
    {
+      if (m_pending) loadPending();
       return m_records.begin();
    }
 
    inline Table::const_iterator Table::end() const
    {
+      if (m_pending) loadPending();
       return m_records.end();
    }
 
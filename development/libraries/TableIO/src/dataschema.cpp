@@ -71,12 +71,8 @@ int TableDefinition::getIndex (const string & name, int hint) const
       if (fieldDef->hasName (name)) return hint;
    }
 
-   for (int i = 0; i < static_cast<int>(size ()); i++)
-   {
-      FieldDefinition * fieldDef = getFieldDefinition (i);
-
-      if (fieldDef->hasName (name)) return i;
-   }
+   std::unordered_map<std::string, int>::const_iterator found = m_fieldIndices.find (name);
+   if (found != m_fieldIndices.end ()) return found->second;
 
    // cerr << "Error: Field " << name << " not part of Table " << m_name << endl;
    return -1;
@@ -85,6 +81,7 @@ int TableDefinition::getIndex (const string & name, int hint) const
 bool TableDefinition::addFieldDefinition (FieldDefinition * fieldDef)
 {
    m_fieldDefinitionList.push_back (fieldDef);
+   m_fieldIndices.insert (std::make_pair (fieldDef->name (), static_cast<int>(m_fieldDefinitionList.size ()) - 1));
 
    if (fieldDef->storageType () == FieldDefinition::Volatile) return true;
 
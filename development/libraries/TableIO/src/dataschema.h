@@ -19,6 +19,7 @@
 #include <cstdlib>
 #include <fstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "datatype.h"
@@ -106,6 +107,7 @@ namespace database
 
       FieldDefinitionList m_fieldDefinitionList;
       Shuffle m_outputOrdering;
+      std::unordered_map<std::string, int> m_fieldIndices; // index of the first FieldDefinition with a name
 
       bool addFieldDefinition (FieldDefinition * fieldDefinition);
 
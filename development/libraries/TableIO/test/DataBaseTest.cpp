@@ -4,8 +4,11 @@
 using namespace database;
 using namespace datatype;
 
+#include <cstdio>
+#include <fstream>
 #include <string>
 #include <sstream>
+#include <stdexcept>
 
 #include <gtest/gtest.h>
 
@@ -116,6 +119,250 @@ TEST ( TableIoDataBaseTest, SaveToStreamTest ) {
 }
 
 
+TEST ( TableIoDataBaseTest, ColumnarStorageTest ) {
+
+   Database* database =  createDataBase ();
+   Table* table = database->getTable ( Table2 );
+
+   //--------------------------------
+   // Load records, skipping over an unknown field and unescaping quoted strings.
+   std::stringstream input;
+   input << ";v100"                                                     << std::endl;
+   input << "  StringField   UnknownField   FloatField"                 << std::endl;
+   input << "  ()            ()             ()"                         << std::endl;
+   input << "  \"Say \\\"hi\\\"\"  7  1.5"                              << std::endl;
+   input << "  \"Field 5\"     8              2.5e3"                      << std::endl;
+   input << "[End]"                                                     << std::endl;
+
+   EXPECT_TRUE ( table->loadFromStream ( input ) );
+   EXPECT_EQ ( table->size (), 5 );
+   EXPECT_EQ ( getStringField ( table->getRecord ( 3 ) ), "Say \"hi\"" );
+   EXPECT_EQ ( getFloatField  ( table->getRecord ( 3 ) ), 1.5 );
+   EXPECT_EQ ( getStringField ( table->getRecord ( 4 ) ), "Field 5" );
+   EXPECT_EQ ( getFloatField  ( table->getRecord ( 4 ) ), 2500.0 );
+
+   // Saving and loading again gives the same table.
+   Database::SetFieldWidth ( 24 );
+   std::stringstream saved;
+   EXPECT_TRUE ( table->saveToStream ( saved ) );
+
+   Database* other = createDataBase ();
+   Table* otherTable = other->getTable ( Table2 );
+   otherTable->clear ();
+
+   std::string line;
+   while ( std::getline ( saved, line ) && line != "[" + Table2 + "]" ) {}
+
+   EXPECT_TRUE ( otherTable->loadFromStream ( saved ) );
+   EXPECT_EQ ( otherTable->size (), 5 );
+
+   std::stringstream resaved;
+   EXPECT_TRUE ( otherTable->saveToStream ( resaved ) );
+   EXPECT_EQ ( resaved.str (), saved.str () );
+
+   //--------------------------------
+   // Values do not move when records are added, and new records get the default values.
+   Record* rec = table->getRecord ( 0 );
+   const std::string& value = rec->getValue<std::string>( "StringField" );
+
+   for ( int i = 0; i < 1000; ++i ) {
+      table->createRecord ();
+   }
+
+   EXPECT_EQ ( &value, &rec->getValue<std::string>( "StringField" ) );
+   EXPECT_EQ ( value, "Field1" );
+   EXPECT_EQ ( getStringField ( table->getRecord ( 1004 ) ), "SomeText" );
+   EXPECT_EQ ( getFloatField  ( table->getRecord ( 1004 ) ), 1.23 );
+
+   //--------------------------------
+   // Copied records keep their values, also when the original table is cleared.
+   Record* copy = new Record ( *table->getRecord ( 1 ) );
+   otherTable->addRecord ( new Record ( *table->getRecord ( 3 ), otherTable ) );
+   setFloatField ( copy, 40.0 );
+
+   EXPECT_EQ ( getFloatField ( table->getRecord ( 1 ) ), 20.0 );
+
+   table->clear ();
+   EXPECT_EQ ( table->size (), 0 );
+   EXPECT_EQ ( getStringField ( copy ), "Field2" );
+   EXPECT_EQ ( getFloatField  ( copy ), 40.0 );
+   EXPECT_EQ ( getStringField ( otherTable->getRecord ( 5 ) ), "Say \"hi\"" );
+
+   delete copy;
+   delete other;
+   delete database;
+}
+
+bool descendingFloatField ( Record* rec1, Record* rec2 ) {
+   return getFloatField ( rec1 ) > getFloatField ( rec2 );
+}
+
+TEST ( TableIoDataBaseTest, FindRecordTest ) {
+
+   Database* database =  createDataBase ();
+   Table* table = database->getTable ( Table2 );
+
+   Record* rec = table->createRecord ();
+   setStringField ( rec, "Field2" );
+   setFloatField  ( rec, 40.0 );
+
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field1" ), table->getRecord ( 0 ) );
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field2" ), table->getRecord ( 1 ) );
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field4" ), nullptr );
+   EXPECT_EQ ( table->findRecord ( "UnknownField", "Field1" ), nullptr );
+
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field2", "StringField", "Field2" ), table->getRecord ( 1 ) );
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field2", "StringField", "Field2", table->getRecord ( 1 ) ), rec );
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field2", "StringField", "Field3" ), nullptr );
+
+   // The index follows changes of values and records.
+   setStringField ( table->getRecord ( 0 ), "Field4" );
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field1" ), nullptr );
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field4" ), table->getRecord ( 0 ) );
+
+   table->sort ( descendingFloatField );
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field2" ), rec );
+
+   table->deleteRecord ( rec );
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field2" ), table->getRecord ( 1 ) );
+
+   // Also for records that keep their values in another database.
+   Database* other = createDataBase ();
+   Record* copy = new Record ( *other->getTable ( Table2 )->getRecord ( 0 ) );
+   table->addRecord ( copy );
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field1" ), copy );
+
+   setStringField ( copy, "Field5" );
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field1" ), nullptr );
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field5" ), copy );
+
+   table->clear ();
+   EXPECT_EQ ( table->findRecord ( "StringField", "Field5" ), nullptr );
+
+   delete database;
+   delete other;
+}
+
+TEST ( TableIoDataBaseTest, LazyLoadTest ) {
+
+   const std::string fileName = "LazyLoadTest.project3d";
+   {
+      std::ofstream file ( fileName.c_str () );
+      file << "[MyTestTable1]"                                   << std::endl;
+      file << ";v100"                                            << std::endl;
+      file << "IntegerField1 IntegerField2   IntegerField3"      << std::endl;
+      file << "() () ()"                                         << std::endl;
+      file << "; a comment that only survives if the table is not parsed" << std::endl;
+      file << "10 20    30"                                      << std::endl;
+      file << "[End]"                                            << std::endl;
+      file << "[MyTestTable2]"                                   << std::endl;
+      file << "StringField FloatField"                           << std::endl;
+      file << "() ()"                                            << std::endl;
+      file << "\"Field1\" 10"                                  << std::endl;
+      file << "[End]"                                            << std::endl;
+   }
+
+   DataSchema* dataSchema = createSchema ();
+   Database* database = Database::CreateFromFile ( fileName, *dataSchema );
+   delete dataSchema;
+   std::remove ( fileName.c_str () );
+   ASSERT_NE ( database, nullptr );
+
+   // Only the accessed table is parsed and written as usual, the other one is written as it was read.
+   Table* table = database->getTable ( Table2 );
+   EXPECT_EQ ( table->size (), 1 );
+   EXPECT_EQ ( getStringField ( table->getRecord ( 0 ) ), "Field1" );
+
+   Database::SetFieldWidth ( 24 );
+   std::stringstream contents;
+   database->saveToStream ( contents );
+
+   std::stringstream expectedContents;
+   expectedContents << ";"                                                          << std::endl;
+   expectedContents << "; Description of MyTestTable1"                              << std::endl;
+   expectedContents << ";"                                                          << std::endl;
+   expectedContents << "[MyTestTable1]"                                             << std::endl;
+   expectedContents << ";v100"                                                      << std::endl;
+   expectedContents << "IntegerField1 IntegerField2   IntegerField3"                << std::endl;
+   expectedContents << "() () ()"                                                   << std::endl;
+   expectedContents << "; a comment that only survives if the table is not parsed" << std::endl;
+   expectedContents << "10 20    30"                                                << std::endl;
+   expectedContents << "[End]"                                                      << std::endl;
+   expectedContents << ";"                                                          << std::endl;
+   expectedContents << ";"                                                          << std::endl;
+   expectedContents << "; Description of MyTestTable2"                              << std::endl;
+   expectedContents << ";"                                                          << std::endl;
+   expectedContents << "[MyTestTable2]"                                             << std::endl;
+   expectedContents << ";v100"                                                      << std::endl;
+   expectedContents << "             StringField               FloatField"         << std::endl;
+   expectedContents << "                      ()                       ()"         << std::endl;
+   expectedContents << "                \"Field1\"                       10"       << std::endl;
+   expectedContents << "[End]"                                                      << std::endl;
+   expectedContents << ";"                                                          << std::endl;
+   EXPECT_EQ ( contents.str (), expectedContents.str () );
+
+   // The other table is parsed when accessed.
+   table = database->getTable ( Table1 );
+   EXPECT_EQ ( table->version (), 100 );
+   ASSERT_EQ ( table->size (), 1 );
+   EXPECT_EQ ( getIntegerField1 ( table->getRecord ( 0 ) ), 10 );
+   EXPECT_EQ ( getIntegerField3 ( table->getRecord ( 0 ) ), 30 );
+
+   delete database;
+}
+
+TEST ( TableIoDataBaseTest, LazyLoadFailureTest ) {
+
+   const std::string fileName = "LazyLoadFailureTest.project3d";
+   DataSchema* dataSchema = createSchema ();
+
+   // The unterminated strings cannot be parsed: the file fails to load, the table is not parsed lazily.
+   {
+      std::ofstream file ( fileName.c_str () );
+      file << "[MyTestTable2]"                                   << std::endl;
+      file << "StringField FloatField"                           << std::endl;
+      file << "() ()"                                            << std::endl;
+      file << "\"Field1\" 10"                                  << std::endl;
+      file << "\"Field2 20"                                      << std::endl;
+      file << "[End]"                                            << std::endl;
+   }
+   EXPECT_EQ ( Database::CreateFromFile ( fileName, *dataSchema ), nullptr );
+
+   {
+      std::ofstream file ( fileName.c_str () );
+      file << "[MyTestTable1]"                                   << std::endl;
+      file << ";v100"                                            << std::endl;
+      file << "<Row>"                                            << std::endl;
+      file << "IntegerField1 10"                                 << std::endl;
+      file << "IntegerField2 \"20"                              << std::endl;
+      file << "[End]"                                            << std::endl;
+   }
+   EXPECT_EQ ( Database::CreateFromFile ( fileName, *dataSchema ), nullptr );
+
+   // A row-based table is parsed when it is loaded.
+   {
+      std::ofstream file ( fileName.c_str () );
+      file << "[MyTestTable1]"                                   << std::endl;
+      file << ";v100"                                            << std::endl;
+      file << "<Row>"                                            << std::endl;
+      file << "IntegerField1 10"                                 << std::endl;
+      file << "IntegerField3 30"                                 << std::endl;
+      file << "[End]"                                            << std::endl;
+   }
+   Database* database = Database::CreateFromFile ( fileName, *dataSchema );
+   delete dataSchema;
+   std::remove ( fileName.c_str () );
+   ASSERT_NE ( database, nullptr );
+
+   Table* table = database->getTable ( Table1 );
+   ASSERT_EQ ( table->size (), 1 );
+   EXPECT_EQ ( getIntegerField1 ( table->getRecord ( 0 ) ), 10 );
+   EXPECT_EQ ( getIntegerField2 ( table->getRecord ( 0 ) ), 2 );
+   EXPECT_EQ ( getIntegerField3 ( table->getRecord ( 0 ) ), 30 );
+
+   delete database;
+}
+
 DataSchema* createSchema () {
 
    DataSchema* dataSchema = new DataSchema;
@@ -8,56 +8,97 @@
 // Do not distribute without written permission from Shell.
 //
 
-#ifdef _MSC_VER
-#pragma warning (push)
-#pragma warning (disable : 4244 4996)
-// boost/iostreams/copy.hpp(128):
-//   warning C4244: 'argument': conversion from 'std::streamsize' to 'int', possible loss of data
-//
-// C:\Program Files (x86)\Microsoft Visual Studio 14.0\VC\include\xutility(2372)
-//   warning C4996: 'std::copy::_Unchecked_iterators::_Deprecate': Call to 'std::copy' with parameters that may be unsafe
-//   this call relies on the caller to check that the passed values are correct. To disable this warning,
-//   use -D_SCL_SECURE_NO_WARNINGS. See documentation on how to use Visual C++ 'Checked Iterators'
-
-// Visual Studio warning C4996 comes from a security check on iterators and std::copy from boost, which uses
-// raw pointers, so to disable it algorithm header has to be not included yet in this scope
-#endif
-#ifdef _ALGORITHM_
-#error algorithm header has already been included before boost (see comments)
-#endif
-#include <algorithm>
-#include <boost/iostreams/filtering_stream.hpp>
-#include <boost/iostreams/filter/gzip.hpp>
-#include <boost/iostreams/copy.hpp>
-#include <boost/iostreams/stream.hpp>
-#include <boost/iostreams/device/file.hpp>
-#ifdef _MSC_VER
-#pragma warning (pop)
-#endif
-
 #include "DataStore.h"
 #include "VisualizationAPI.h"
 #include "VisualizationIO_native.h"
 
 #include "lz4.h"
+#include <zlib.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <cstring>
-#include <streambuf>
+#include <limits>
+#include <memory>
+#include <sstream>
 
 #define MINIMALBYTESTOCOMPRESS 50
 #define APPLY_COMPRESSION true
 #define COMPRESSION_LZ4 true
+#define FLOAT_FILTER (FilterDelta | FilterShuffle)
+#define VOLUME_TILE_I 64
+#define VOLUME_TILE_J 64
+#define VOLUME_TILE_K 16
 
 using namespace CauldronIO;
 
+namespace
+{
+    // Adding 16 to the window bits selects the gzip wrapper (as written by boost::iostreams::gzip_compressor)
+    const int GzipWindowBits = MAX_WBITS + 16;
+    // zlib counts bytes in uInt, so larger blocks are fed in pieces
+    const size_t MaxZlibChunk = std::numeric_limits<uInt>::max();
+
+    /// \brief Hands the next piece of a buffer to zlib when it has consumed the previous one
+    void refill(Bytef*& next, uInt& avail, char*& remaining, size_t& remainingSize)
+    {
+        if (avail != 0 || remainingSize == 0) return;
+
+        avail = (uInt)std::min(remainingSize, MaxZlibChunk);
+        next = reinterpret_cast<Bytef*>(remaining);
+        remaining += avail;
+        remainingSize -= avail;
+    }
+
+    /// \brief Inflates a gzip block into a preallocated buffer
+    /// \returns the number of bytes written; complete is false if the output buffer was too small
+    size_t inflateGzip(const char* inputData, size_t compressedSize, char* outputData, size_t outputSize, bool& complete)
+    {
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+        if (inflateInit2(&stream, GzipWindowBits) != Z_OK)
+            throw CauldronIOException("Error during gzip decompression");
+
+        char* input = const_cast<char*>(inputData);
+        char* output = outputData;
+        size_t inputLeft = compressedSize;
+        size_t outputLeft = outputSize;
+
+        int status = Z_OK;
+        while (status == Z_OK)
+        {
+            refill(stream.next_in, stream.avail_in, input, inputLeft);
+            refill(stream.next_out, stream.avail_out, output, outputLeft);
+            status = inflate(&stream, Z_NO_FLUSH);
+        }
+
+        const size_t written = outputSize - outputLeft - stream.avail_out;
+        const bool outputFull = outputLeft == 0 && stream.avail_out == 0;
+        inflateEnd(&stream);
+
+        complete = status == Z_STREAM_END;
+        if (!complete && !(status == Z_BUF_ERROR && outputFull))
+            throw CauldronIOException("Error during gzip decompression");
+
+        return written;
+    }
+
+    /// \brief Quantizes a (finite, in range) value to the nearest multiple of step
+    int32_t quantizeValue(float value, double step)
+    {
+        return (int32_t)std::llround(value / step);
+    }
+}
+
 /// DataStoreLoad
 //////////////////////////////////////////////////////////////////////////
 
-CauldronIO::DataStoreLoad::DataStoreLoad(DataStoreParams* params)
+CauldronIO::DataStoreLoad::DataStoreLoad(const DataStoreParams* params)
 {
-    m_params = static_cast<DataStoreParams*>(params);
+    m_params = params;
 
     if (!exists(m_params->fileName))
     {
@@ -67,96 +108,393 @@ CauldronIO::DataStoreLoad::DataStoreLoad(DataStoreParams* params)
       throw CauldronIOException(msg);
     }
 
-    m_file_in.open(m_params->fileName.c_str(), std::fstream::in | std::fstream::binary);
-    m_data_uncompressed = nullptr;
+    m_data_mapped = nullptr;
 }
 
 CauldronIO::DataStoreLoad::~DataStoreLoad()
 {
-    m_file_in.close();
+    if (m_mapping.is_open())
+        m_mapping.close();
 
     // No need to destroy the parameters; they are not owned by us
 }
 
 float* CauldronIO::DataStoreLoad::getData(size_t& uncompressedSize)
 {
-    // Get the compressed data from file
-    if (!m_data_uncompressed)
-        prefetch();
+    // Tiled volumes are assembled tile by tile
+    if (isTiled())
+    {
+        std::unique_ptr<char[]> result(new char[uncompressedSize]);
+        getData(result.get(), uncompressedSize);
+        return (float*)result.release();
+    }
+
+    // Map the data from file
+    const char* mappedData = getMappedData();
 
     size_t compressedSize = m_params->size;
-    float* result = (float*)m_data_uncompressed;
+    char* result;
 
     // Decompress using gzip
     if (m_params->compressed && !m_params->compressed_lz4)
     {
-        char* resultChar = decompress(m_data_uncompressed, compressedSize);
-        result = (float*)resultChar;
-        delete[] m_data_uncompressed;
-
-        if (compressedSize != uncompressedSize)
-            throw CauldronIOException("Error during gzip decompression");
+        std::unique_ptr<char[]> decompressed(new char[uncompressedSize]);
+        decompress(mappedData, compressedSize, decompressed.get(), uncompressedSize);
+        result = decompressed.release();
     }
     // Decompress using lz4
     else if (m_params->compressed_lz4)
     {
-        char* resultChar = decompress_lz4(m_data_uncompressed, compressedSize, uncompressedSize);
-        result = (float*)resultChar;
-        delete[] m_data_uncompressed;
+        result = decompress_lz4(mappedData, compressedSize, uncompressedSize);
     }
-    // No decompression needed
+    // No decompression needed, but the caller owns the result so we need a copy of the mapped block
     else
+    {
         uncompressedSize = compressedSize;
+        result = new char[uncompressedSize];
+        std::memcpy(result, mappedData, uncompressedSize);
+    }
+
+    // Reverse the pre-filter
+    if (m_params->filter != FilterNone)
+    {
+        std::unique_ptr<char[]> filtered(result);
+        result = new char[uncompressedSize];
+        removeFilter(filtered.get(), result, uncompressedSize, m_params->filter);
+    }
+
+    // Lossy data holds quantized values
+    if (m_params->quantization != 0)
+        dequantize(result, uncompressedSize, m_params->quantization);
 
-    // Release pointer to data - do not delete, we do not own the data
-    m_data_uncompressed = nullptr;
-    return result;
+    return (float*)result;
+}
+
+void CauldronIO::DataStoreLoad::getData(char* buffer, size_t uncompressedSize)
+{
+    if (isTiled())
+    {
+        if (uncompressedSize != m_params->numI * m_params->numJ * m_params->numK * sizeof(float))
+            throw CauldronIOException("Buffer size mismatch");
+
+        VolumeRegion all = { 0, 0, 0, m_params->numI, m_params->numJ, m_params->numK };
+        getRegion(all, (float*)buffer);
+        return;
+    }
+
+    const char* mappedData = getMappedData();
+
+    // Filtered data is decoded into a scratch buffer, from which the filter is reversed into the given buffer
+    std::unique_ptr<char[]> filtered;
+    char* target = buffer;
+    if (m_params->filter != FilterNone)
+    {
+        filtered.reset(new char[uncompressedSize]);
+        target = filtered.get();
+    }
+
+    if (m_params->compressed_lz4)
+    {
+        int decompressedSize = LZ4_decompress_safe(mappedData, target, (int)m_params->size, (int)uncompressedSize);
+        if (decompressedSize < 0 || (size_t)decompressedSize != uncompressedSize)
+            throw CauldronIOException("Error during lz4 decompression");
+    }
+    else if (m_params->compressed)
+    {
+        decompress(mappedData, m_params->size, target, uncompressedSize);
+    }
+    else
+    {
+        if (uncompressedSize != m_params->size)
+            throw CauldronIOException("Buffer size mismatch");
+
+        std::memcpy(target, mappedData, uncompressedSize);
+    }
+
+    if (filtered)
+        removeFilter(filtered.get(), buffer, uncompressedSize, m_params->filter);
+
+    if (m_params->quantization != 0)
+        dequantize(buffer, uncompressedSize, m_params->quantization);
 }
 
 void CauldronIO::DataStoreLoad::prefetch()
 {
-    if (!m_data_uncompressed)
+    if (m_mapping.is_open() || m_params->size == 0) return;
+
+    // The mapping offset has to be a multiple of the allocation granularity: map from the
+    // aligned position before the block and skip the leading bytes
+    const size_t alignment = (size_t)boost::iostreams::mapped_file::alignment();
+    const size_t mapOffset = (m_params->offset / alignment) * alignment;
+    const size_t leading = m_params->offset - mapOffset;
+
+    boost::iostreams::mapped_file_params mapParams(m_params->fileName.string());
+    mapParams.flags = boost::iostreams::mapped_file::priv;
+    mapParams.offset = (boost::iostreams::stream_offset)mapOffset;
+    mapParams.length = leading + m_params->size;
+
+    try
+    {
+        m_mapping.open(mapParams);
+    }
+    catch (std::exception& ex)
+    {
+        throw CauldronIOException(std::string("Could not map file ") + m_params->fileName.string() + ": " + ex.what());
+    }
+
+    if (!m_mapping.is_open() || m_mapping.size() != leading + m_params->size)
+        throw CauldronIOException(std::string("Unable to map requested number of bytes from ") + m_params->fileName.string());
+
+    m_data_mapped = m_mapping.const_data() + leading;
+}
+
+bool CauldronIO::DataStoreLoad::isCompressed() const
+{
+    return m_params->compressed || m_params->filter != FilterNone || m_params->quantization != 0 || isTiled();
+}
+
+bool CauldronIO::DataStoreLoad::isTiled() const
+{
+    return m_params->tileI > 0;
+}
+
+void CauldronIO::DataStoreLoad::getRegion(const VolumeRegion& region, float* buffer)
+{
+    const DataStoreParams& params = *m_params;
+    if (!isTiled())
+        throw CauldronIOException("Cannot retrieve a region of data that is not tiled");
+    if (region.firstI + region.numI > params.numI || region.firstJ + region.numJ > params.numJ || region.firstK + region.numK > params.numK)
+        throw CauldronIOException("Region is outside of the stored volume");
+    if (region.numI == 0 || region.numJ == 0 || region.numK == 0)
+        return;
+
+    const size_t numTilesI = (params.numI + params.tileI - 1) / params.tileI;
+    const size_t numTilesJ = (params.numJ + params.tileJ - 1) / params.tileJ;
+
+    std::vector<float> tile(params.tileI * params.tileJ * params.tileK);
+    std::unique_ptr<char[]> scratch;
+
+    for (size_t tk = region.firstK / params.tileK; tk <= (region.firstK + region.numK - 1) / params.tileK; ++tk)
+    {
+        for (size_t tj = region.firstJ / params.tileJ; tj <= (region.firstJ + region.numJ - 1) / params.tileJ; ++tj)
+        {
+            for (size_t ti = region.firstI / params.tileI; ti <= (region.firstI + region.numI - 1) / params.tileI; ++ti)
+            {
+                // Tiles at the upper boundaries are cut off by the volume
+                const size_t tileFirstI = ti * params.tileI, tileFirstJ = tj * params.tileJ, tileFirstK = tk * params.tileK;
+                const size_t tileNumI = std::min(params.tileI, params.numI - tileFirstI);
+                const size_t tileNumJ = std::min(params.tileJ, params.numJ - tileFirstJ);
+                const size_t tileNumK = std::min(params.tileK, params.numK - tileFirstK);
+
+                getTile(ti + tj * numTilesI + tk * numTilesI * numTilesJ, tileNumI * tileNumJ * tileNumK * sizeof(float), (char*)tile.data(), scratch);
+
+                // Copy the intersection of tile and region, row by row
+                const size_t firstI = std::max(region.firstI, tileFirstI), lastI = std::min(region.firstI + region.numI, tileFirstI + tileNumI);
+                const size_t firstJ = std::max(region.firstJ, tileFirstJ), lastJ = std::min(region.firstJ + region.numJ, tileFirstJ + tileNumJ);
+                const size_t firstK = std::max(region.firstK, tileFirstK), lastK = std::min(region.firstK + region.numK, tileFirstK + tileNumK);
+
+                for (size_t k = firstK; k < lastK; ++k)
+                {
+                    for (size_t j = firstJ; j < lastJ; ++j)
+                    {
+                        const float* source = &tile[(firstI - tileFirstI) + (j - tileFirstJ) * tileNumI + (k - tileFirstK) * tileNumI * tileNumJ];
+                        float* dest = buffer + (firstI - region.firstI) + (j - region.firstJ) * region.numI + (k - region.firstK) * region.numI * region.numJ;
+                        std::memcpy(dest, source, (lastI - firstI) * sizeof(float));
+                    }
+                }
+            }
+        }
+    }
+}
+
+void CauldronIO::DataStoreLoad::getTile(size_t tileIndex, size_t numBytes, char* buffer, std::unique_ptr<char[]>& scratch)
+{
+    const char* mappedData = getMappedData();
+
+    if (tileIndex + 1 >= m_params->tileOffsets.size())
+        throw CauldronIOException("Tile index out of range");
+
+    const char* tileData = mappedData + m_params->tileOffsets[tileIndex];
+    const size_t storedSize = m_params->tileOffsets[tileIndex + 1] - m_params->tileOffsets[tileIndex];
+
+    // Tiles that did not compress are stored as is (also not quantized)
+    if (storedSize == numBytes)
     {
-        // Read from disk
-        size_t compressedSize = m_params->size;
-        m_file_in.seekg(m_params->offset);
-        m_data_uncompressed = new char[compressedSize];
-        m_file_in.read(m_data_uncompressed, compressedSize);
+        std::memcpy(buffer, tileData, numBytes);
+        return;
     }
+
+    char* target = buffer;
+    if (m_params->filter != FilterNone)
+    {
+        if (!scratch)
+            scratch.reset(new char[m_params->tileI * m_params->tileJ * m_params->tileK * sizeof(float)]);
+        target = scratch.get();
+    }
+
+    if (m_params->compressed_lz4)
+    {
+        int decompressedSize = LZ4_decompress_safe(tileData, target, (int)storedSize, (int)numBytes);
+        if (decompressedSize < 0 || (size_t)decompressedSize != numBytes)
+            throw CauldronIOException("Error during lz4 decompression");
+    }
+    else if (m_params->compressed)
+    {
+        decompress(tileData, storedSize, target, numBytes);
+    }
+    else
+    {
+        throw CauldronIOException("Tile size mismatch");
+    }
+
+    if (target != buffer)
+        removeFilter(target, buffer, numBytes, m_params->filter);
+
+    if (m_params->quantization != 0)
+        dequantize(buffer, numBytes, m_params->quantization);
+}
+
+const char* CauldronIO::DataStoreLoad::getMappedData()
+{
+    if (!m_data_mapped)
+        prefetch();
+
+    return m_data_mapped;
+}
+
+std::shared_ptr<float> CauldronIO::DataStoreLoad::shareMappedData()
+{
+    if (isCompressed())
+        throw CauldronIOException("Cannot share a compressed data block");
+
+    // The private mapping can be written to; the pointer shares ownership of the mapping
+    float* data = reinterpret_cast<float*>(const_cast<char*>(getMappedData()));
+    std::shared_ptr<boost::iostreams::mapped_file> mapping = std::make_shared<boost::iostreams::mapped_file>(m_mapping);
+
+    m_mapping = boost::iostreams::mapped_file();
+    m_data_mapped = nullptr;
+
+    return std::shared_ptr<float>(mapping, data);
 }
 
 char* CauldronIO::DataStoreLoad::decompress(const char* inputData, size_t& elements)
 {
-    std::stringstream data, result;
-    data.write(inputData, elements);
+    if (elements < 18)
+        throw CauldronIOException("Error during gzip decompression");
 
-    // Use boost streams to decompress gzip
-    boost::iostreams::filtering_streambuf<boost::iostreams::input> out;
-    out.push(boost::iostreams::gzip_decompressor());
-    out.push(data);
-    elements = boost::iostreams::copy(out, result);
+    // The gzip trailer holds the uncompressed size modulo 2^32: blocks larger than that need more room
+    const unsigned char* trailer = reinterpret_cast<const unsigned char*>(inputData + elements - 4);
+    size_t uncompressedSize = (size_t)trailer[0] | ((size_t)trailer[1] << 8) | ((size_t)trailer[2] << 16) | ((size_t)trailer[3] << 24);
 
-    // Copy the result into a char array
-    std::streambuf* pbuf = result.rdbuf();
-    pbuf->pubseekpos(0);
-    char* charResult = new char[elements];
-    pbuf->sgetn(charResult, elements);
+    while (true)
+    {
+        std::unique_ptr<char[]> result(new char[uncompressedSize]);
+
+        bool complete;
+        size_t written = inflateGzip(inputData, elements, result.get(), uncompressedSize, complete);
+        if (complete && written == uncompressedSize)
+        {
+            elements = written;
+            return result.release();
+        }
+        if (complete)
+            throw CauldronIOException("Error during gzip decompression");
 
-    return charResult;
+        uncompressedSize += (size_t)std::numeric_limits<unsigned int>::max() + 1;
+    }
+}
+
+void CauldronIO::DataStoreLoad::decompress(const char* inputData, size_t compressedSize, char* outputData, size_t uncompressedSize)
+{
+    bool complete;
+    size_t written = inflateGzip(inputData, compressedSize, outputData, uncompressedSize, complete);
+
+    if (!complete || written != uncompressedSize)
+        throw CauldronIOException("Error during gzip decompression");
 }
 
 char* CauldronIO::DataStoreLoad::decompress_lz4(const char* inputData, size_t compressedSize, size_t uncompressedSize)
 {
     char* dest = new char[uncompressedSize];
-    size_t actualCompressedSize = (size_t)LZ4_decompress_fast(inputData, dest, (int)uncompressedSize);
+
+    // The input may be a file mapping, so never read beyond the compressed block
+    int decompressedSize = LZ4_decompress_safe(inputData, dest, (int)compressedSize, (int)uncompressedSize);
 
     // Check for success
-    if (compressedSize != actualCompressedSize)
+    if (decompressedSize < 0 || (size_t)decompressedSize != uncompressedSize)
+    {
+        delete[] dest;
         throw CauldronIOException("Error during decompression");
+    }
 
     return dest;
 }
 
+void CauldronIO::DataStoreLoad::removeFilter(const char* inputData, char* outputData, size_t numBytes, unsigned int filter)
+{
+    const size_t numWords = numBytes / sizeof(uint32_t);
+    const bool delta = (filter & FilterDelta) != 0;
+    const bool shuffle = (filter & FilterShuffle) != 0;
+    const unsigned char* input = reinterpret_cast<const unsigned char*>(inputData);
+
+    uint32_t previous = 0;
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        uint32_t value;
+        if (shuffle)
+            value = (uint32_t)input[i] | ((uint32_t)input[numWords + i] << 8) |
+                    ((uint32_t)input[2 * numWords + i] << 16) | ((uint32_t)input[3 * numWords + i] << 24);
+        else
+            std::memcpy(&value, inputData + i * sizeof(uint32_t), sizeof(uint32_t));
+
+        uint32_t word = delta ? value + previous : value;
+        previous = word;
+        std::memcpy(outputData + i * sizeof(uint32_t), &word, sizeof(uint32_t));
+    }
+
+    // Trailing bytes that do not make up a word are stored as is
+    const size_t wordBytes = numWords * sizeof(uint32_t);
+    std::memcpy(outputData + wordBytes, inputData + wordBytes, numBytes - wordBytes);
+}
+
+void CauldronIO::DataStoreLoad::dequantize(char* data, size_t numBytes, double step)
+{
+    const size_t size = numBytes / sizeof(float);
+    for (size_t i = 0; i < size; ++i)
+    {
+        int32_t quantized;
+        std::memcpy(&quantized, data + i * sizeof(int32_t), sizeof(int32_t));
+
+        // Must match the conversion that was checked against the error bound in DataStoreSave::getQuantizationStep
+        float value = quantized == std::numeric_limits<int32_t>::min() ? DefaultUndefinedValue : (float)(quantized * step);
+        std::memcpy(data + i * sizeof(float), &value, sizeof(float));
+    }
+}
+
+unsigned int CauldronIO::DataStoreLoad::parseFilter(const std::string& filterName)
+{
+    unsigned int filter = FilterNone;
+
+    size_t start = 0;
+    while (start < filterName.size())
+    {
+        size_t end = filterName.find(',', start);
+        if (end == std::string::npos) end = filterName.size();
+
+        const std::string name = filterName.substr(start, end - start);
+        if (name == "delta")
+            filter |= FilterDelta;
+        else if (name == "shuffle")
+            filter |= FilterShuffle;
+        else if (name != "none")
+            throw CauldronIOException("Unknown datastore filter " + name);
+
+        start = end + 1;
+    }
+
+    return filter;
+}
+
 void CauldronIO::DataStoreLoad::getVolume(pugi::xml_node ptree, std::shared_ptr<VolumeData> volumeData, const ibs::FilePath& path)
 {
     bool foundSome = false;
@@ -202,6 +540,50 @@ CauldronIO::DataStoreParams* CauldronIO::DataStoreLoad::getDatastoreParams(pugi:
     paramsNative->compressed_lz4 = compression == "lz4";
     paramsNative->size = (size_t)datastoreNode.attribute("size").as_ullong();
     paramsNative->offset = (size_t)datastoreNode.attribute("offset").as_ullong();
+    // Stores written before pre-filters were introduced have no filter attribute
+    paramsNative->filter = parseFilter(datastoreNode.attribute("filter").value());
+    // Lossy data
+    paramsNative->quantization = datastoreNode.attribute("quantization").as_double();
+    paramsNative->errorBound = datastoreNode.attribute("errorbound").as_double();
+    if (paramsNative->quantization < 0 || paramsNative->quantization != paramsNative->quantization)
+    {
+        delete paramsNative;
+        throw CauldronIOException("Invalid quantization in datastore");
+    }
+
+    // Tiled volume
+    if (datastoreNode.attribute("tileI"))
+    {
+        paramsNative->tileI = (size_t)datastoreNode.attribute("tileI").as_ullong();
+        paramsNative->tileJ = (size_t)datastoreNode.attribute("tileJ").as_ullong();
+        paramsNative->tileK = (size_t)datastoreNode.attribute("tileK").as_ullong();
+        paramsNative->numI = (size_t)datastoreNode.attribute("numI").as_ullong();
+        paramsNative->numJ = (size_t)datastoreNode.attribute("numJ").as_ullong();
+        paramsNative->numK = (size_t)datastoreNode.attribute("numK").as_ullong();
+
+        if (paramsNative->tileI == 0 || paramsNative->tileJ == 0 || paramsNative->tileK == 0)
+        {
+            delete paramsNative;
+            throw CauldronIOException("Invalid tile size in datastore");
+        }
+
+        size_t numTiles = ((paramsNative->numI + paramsNative->tileI - 1) / paramsNative->tileI) *
+                          ((paramsNative->numJ + paramsNative->tileJ - 1) / paramsNative->tileJ) *
+                          ((paramsNative->numK + paramsNative->tileK - 1) / paramsNative->tileK);
+
+        std::istringstream tileSizes(datastoreNode.child("tilesizes").text().get());
+        paramsNative->tileOffsets.reserve(numTiles + 1);
+        paramsNative->tileOffsets.push_back(0);
+        size_t tileSize;
+        while (tileSizes >> tileSize)
+            paramsNative->tileOffsets.push_back(paramsNative->tileOffsets.back() + tileSize);
+
+        if (paramsNative->tileOffsets.size() != numTiles + 1 || paramsNative->tileOffsets.back() != paramsNative->size)
+        {
+            delete paramsNative;
+            throw CauldronIOException("Inconsistent tile sizes in datastore");
+        }
+    }
 
     return paramsNative;
 }
@@ -229,16 +611,26 @@ CauldronIO::DataStoreSave::DataStoreSave(const std::string& filename, bool appen
     else
         m_file_out.open(filename.c_str(), std::fstream::binary | std::fstream::ate | std::fstream::app);
 
+    if (!m_file_out.is_open())
+        throw CauldronIOException("Cannot open datastore " + filename + " for writing");
+
     m_compress = APPLY_COMPRESSION;
+    m_filter = FLOAT_FILTER;
+    m_tileI = VOLUME_TILE_I;
+    m_tileJ = VOLUME_TILE_J;
+    m_tileK = VOLUME_TILE_K;
 
     m_fileName = filename;
-    m_flushed = false;
-    m_offset = 0;
+    m_numWritten = 0;
+
+    // New data is written after the existing data
+    m_offset = append ? (size_t)m_file_out.tellp() : 0;
+    m_existingSize = m_offset;
 }
 
 CauldronIO::DataStoreSave::~DataStoreSave()
 {
-    if (!m_flushed)
+    if (!m_dataToCompress.empty())
         flush();
 
     m_file_out.flush();
@@ -251,19 +643,39 @@ CauldronIO::DataStoreSave::~DataStoreSave()
 
 char* CauldronIO::DataStoreSave::compress(const char* inputData, size_t& elements)
 {
-    std::stringstream data, result;
-    data.write(inputData, elements);
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, GzipWindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        throw CauldronIOException("Error during gzip compression");
+
+    // Worst case output size for this block: the deflateBound formula plus the gzip wrapper,
+    // computed here because deflateBound itself is limited to uLong
+    const size_t maxOutputSize = elements + (elements >> 12) + (elements >> 14) + (elements >> 25) + 32;
+    std::unique_ptr<char[]> output(new char[maxOutputSize]);
+
+    char* input = const_cast<char*>(inputData);
+    char* outputPos = output.get();
+    size_t inputLeft = elements;
+    size_t outputLeft = maxOutputSize;
+
+    int status = Z_OK;
+    while (status == Z_OK)
+    {
+        refill(stream.next_in, stream.avail_in, input, inputLeft);
+        refill(stream.next_out, stream.avail_out, outputPos, outputLeft);
+        status = deflate(&stream, inputLeft == 0 ? Z_FINISH : Z_NO_FLUSH);
+    }
+
+    const size_t written = maxOutputSize - outputLeft - stream.avail_out;
+    deflateEnd(&stream);
 
-    boost::iostreams::filtering_streambuf<boost::iostreams::input> out;
-    out.push(boost::iostreams::gzip_compressor());
-    out.push(data);
-    elements = boost::iostreams::copy(out, result);
+    if (status != Z_STREAM_END)
+        throw CauldronIOException("Error during gzip compression");
 
-    // Copy the result into a char array
-    std::streambuf* pbuf = result.rdbuf();
-    pbuf->pubseekpos(0);
-    char* charResult = new char[elements];
-    pbuf->sgetn(charResult, elements);
+    // Hand back an exactly sized buffer, so blocks waiting to be flushed do not hold on to the worst case allocation
+    char* charResult = new char[written];
+    std::memcpy(charResult, output.get(), written);
+    elements = written;
 
     return charResult;
 }
@@ -288,13 +700,190 @@ char* CauldronIO::DataStoreSave::compress_lz4(const char* inputData, size_t& ele
 
 void CauldronIO::DataStoreSave::addData(const float* data, size_t size, bool compressData)
 {
-    std::shared_ptr<DataToCompress> dataToCompress(new DataToCompress(data, size * sizeof(float), compressData));
+    std::shared_ptr<DataToCompress> dataToCompress(new DataToCompress(data, size * sizeof(float), compressData, m_filter));
     m_dataToCompress.push_back(dataToCompress);
 }
 
+void CauldronIO::DataStoreSave::setErrorBound(const ErrorBound& errorBound)
+{
+    m_errorBound = errorBound;
+}
+
+void CauldronIO::DataStoreSave::setFilter(unsigned int filter)
+{
+    m_filter = filter;
+}
+
+void CauldronIO::DataStoreSave::setTileSize(size_t tileI, size_t tileJ, size_t tileK)
+{
+    if (tileI == 0 || tileJ == 0 || tileK == 0)
+        tileI = tileJ = tileK = 0;
+
+    m_tileI = tileI;
+    m_tileJ = tileJ;
+    m_tileK = tileK;
+}
+
+void CauldronIO::DataStoreSave::applyFilter(const char* inputData, char* outputData, size_t numBytes, unsigned int filter)
+{
+    const size_t numWords = numBytes / sizeof(uint32_t);
+    const bool delta = (filter & FilterDelta) != 0;
+    const bool shuffle = (filter & FilterShuffle) != 0;
+    unsigned char* output = reinterpret_cast<unsigned char*>(outputData);
+
+    uint32_t previous = 0;
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        uint32_t word;
+        std::memcpy(&word, inputData + i * sizeof(uint32_t), sizeof(uint32_t));
+
+        uint32_t value = delta ? word - previous : word;
+        previous = word;
+
+        if (shuffle)
+        {
+            output[i] = (unsigned char)value;
+            output[numWords + i] = (unsigned char)(value >> 8);
+            output[2 * numWords + i] = (unsigned char)(value >> 16);
+            output[3 * numWords + i] = (unsigned char)(value >> 24);
+        }
+        else
+            std::memcpy(outputData + i * sizeof(uint32_t), &value, sizeof(uint32_t));
+    }
+
+    // Trailing bytes that do not make up a word are stored as is
+    const size_t wordBytes = numWords * sizeof(uint32_t);
+    std::memcpy(outputData + wordBytes, inputData + wordBytes, numBytes - wordBytes);
+}
+
+std::string CauldronIO::DataStoreSave::getFilterName(unsigned int filter)
+{
+    std::string name;
+    if (filter & FilterDelta)
+        name = "delta";
+    if (filter & FilterShuffle)
+        name += name.empty() ? "shuffle" : ",shuffle";
+
+    return name.empty() ? "none" : name;
+}
+
+void CauldronIO::DataStoreSave::addFilterAttribute(pugi::xml_node node, unsigned int filter)
+{
+    // Leave the attribute out for unfiltered data, so older readers can still load it
+    if (filter != FilterNone)
+        node.append_attribute("filter") = getFilterName(filter).c_str();
+}
+
+void CauldronIO::DataStoreSave::addQuantizationAttributes(pugi::xml_node node, double step, double errorBound)
+{
+    // Leave the attributes out for lossless data
+    if (step == 0) return;
+
+    node.append_attribute("quantization") = step;
+    node.append_attribute("errorbound") = errorBound;
+}
+
+void CauldronIO::DataStoreSave::addEncodingAttributes(pugi::xml_node node, const DataStoreParams* params)
+{
+    addFilterAttribute(node, params->filter);
+    addQuantizationAttributes(node, params->quantization, params->errorBound);
+
+    if (params->tileI == 0) return;
+
+    node.append_attribute("tileI") = (unsigned long long)params->tileI;
+    node.append_attribute("tileJ") = (unsigned long long)params->tileJ;
+    node.append_attribute("tileK") = (unsigned long long)params->tileK;
+    node.append_attribute("numI") = (unsigned long long)params->numI;
+    node.append_attribute("numJ") = (unsigned long long)params->numJ;
+    node.append_attribute("numK") = (unsigned long long)params->numK;
+
+    std::ostringstream tileSizes;
+    for (size_t i = 0; i + 1 < params->tileOffsets.size(); ++i)
+        tileSizes << (i == 0 ? "" : " ") << params->tileOffsets[i + 1] - params->tileOffsets[i];
+    node.append_child("tilesizes").text() = tileSizes.str().c_str();
+}
+
+double CauldronIO::DataStoreSave::getQuantizationStep(const float* data, size_t size, const ErrorBound& errorBound, double& absoluteBound)
+{
+    absoluteBound = 0;
+    if (errorBound.bound <= 0) return 0;
+
+    // Range of the defined values
+    double minValue = std::numeric_limits<double>::max();
+    double maxValue = -std::numeric_limits<double>::max();
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (data[i] == DefaultUndefinedValue) continue;
+        if (!std::isfinite(data[i])) return 0;
+
+        minValue = std::min(minValue, (double)data[i]);
+        maxValue = std::max(maxValue, (double)data[i]);
+    }
+    if (minValue > maxValue) return 0;
+
+    absoluteBound = errorBound.relative ? errorBound.bound * (maxValue - minValue) : errorBound.bound;
+    if (absoluteBound <= 0) return 0;
+
+    // Decoded values are rounded to float, which may add up to half an ulp of the largest value to the error
+    const double maxAbsValue = std::max(std::fabs(minValue), std::fabs(maxValue)) + absoluteBound;
+    const double margin = std::nextafter((float)maxAbsValue, std::numeric_limits<float>::max()) - (float)maxAbsValue;
+    const double step = 2 * (absoluteBound - margin);
+    if (step <= 0 || maxAbsValue / step >= (double)std::numeric_limits<int32_t>::max())
+        return 0;
+
+    // Verify the bound for every value exactly as it will be decoded; the undefined value cannot be a decoded value
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (data[i] == DefaultUndefinedValue) continue;
+
+        const float decoded = (float)(quantizeValue(data[i], step) * step);
+        if (std::fabs((double)decoded - (double)data[i]) > absoluteBound || decoded == DefaultUndefinedValue)
+            return 0;
+    }
+
+    return step;
+}
+
+void CauldronIO::DataStoreSave::quantize(const float* inputData, char* outputData, size_t size, double step)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        int32_t quantized = inputData[i] == DefaultUndefinedValue ? std::numeric_limits<int32_t>::min() : quantizeValue(inputData[i], step);
+        std::memcpy(outputData + i * sizeof(int32_t), &quantized, sizeof(int32_t));
+    }
+}
+
 void CauldronIO::DataStoreSave::flush()
 {
-    for (size_t i = 0; i < m_dataToCompress.size(); i++)
+    writeBlocks(m_dataToCompress.size());
+
+    // Make sure the data is on disk before any xml referring to it is written
+    m_file_out.flush();
+    if (!m_file_out)
+        throw CauldronIOException("Error writing datastore " + m_fileName);
+}
+
+size_t CauldronIO::DataStoreSave::flushProcessed()
+{
+    size_t numBlocks = 0;
+    while (numBlocks < m_dataToCompress.size() && m_dataToCompress[numBlocks]->isProcessed())
+        numBlocks++;
+
+    writeBlocks(numBlocks);
+    if (!m_file_out)
+        throw CauldronIOException("Error writing datastore " + m_fileName);
+
+    return m_numWritten;
+}
+
+size_t CauldronIO::DataStoreSave::getNumBlocks() const
+{
+    return m_numWritten + m_dataToCompress.size();
+}
+
+void CauldronIO::DataStoreSave::writeBlocks(size_t numBlocks)
+{
+    for (size_t i = 0; i < numBlocks; i++)
     {
         std::shared_ptr<DataToCompress> data = m_dataToCompress.at(i);
 
@@ -311,7 +900,9 @@ void CauldronIO::DataStoreSave::flush()
         data->updateXmlNode();
     }
 
-    m_flushed = true;
+    // Written blocks are released, unless someone else still holds them
+    m_dataToCompress.erase(m_dataToCompress.begin(), m_dataToCompress.begin() + numBlocks);
+    m_numWritten += numBlocks;
 }
 
 void CauldronIO::DataStoreSave::addSurface(const std::shared_ptr<SurfaceData>& surfaceData, pugi::xml_node node)
@@ -335,18 +926,20 @@ void CauldronIO::DataStoreSave::addSurface(const std::shared_ptr<SurfaceData>& s
     // or 2) this map has been created in native format, but was not loaded from disk (so no datastoreparams were set)
     if (mapNative == nullptr || (mapNative != nullptr && mapNative->getDataStoreParams() == nullptr))
     {
-       addData(surfaceData->getSurfaceValues(), surfaceData->getGeometry()->getSize(), compress);
+       const float* data = surfaceData->getSurfaceValues();
+       addData(data, surfaceData->getGeometry()->getSize(), compress);
        m_dataToCompress.back()->setXmlNode(subNode);
+
+       // Store lossy if requested and the error bound can be guaranteed; the data cannot be lossy without compression
+       double absoluteBound;
+       double step = compress ? getQuantizationStep(data, surfaceData->getGeometry()->getSize(), m_errorBound, absoluteBound) : 0;
+       if (step != 0)
+           m_dataToCompress.back()->setQuantization(step, absoluteBound);
     }
     else
     {
        // This surface already has been written: skip it
-       const DataStoreParams* const params = mapNative->getDataStoreParams();
-       assert(m_fileName == params->fileName.string());
-
-       subNode.append_attribute("offset") = (unsigned long long)m_offset;
-       subNode.append_attribute("size") = (unsigned long long)params->size;
-       m_offset += params->size;
+       addStoredData(subNode, mapNative->getDataStoreParams());
     }
 }
 
@@ -394,21 +987,31 @@ void CauldronIO::DataStoreSave::writeVolumePart(pugi::xml_node volNode, bool com
     if (writeData)
     {
        // Write the volume and update the offset
-       writeVolume(volume, IJK, compress);
-       m_dataToCompress.back()->setXmlNode(subNode);
+       writeVolume(volume, IJK, compress, subNode);
     }
     else
     {
         // This volume already has been written: skip it
-        const DataStoreParams* const params = nativeVolume->getDataStoreParamsIJK();
-        assert(m_fileName == params->fileName.string());
-
-        subNode.append_attribute("offset") = (unsigned long long)m_offset;
-        subNode.append_attribute("size") = (unsigned long long)params->size;
-        m_offset += params->size;
+        addStoredData(subNode, IJK ? nativeVolume->getDataStoreParamsIJK() : nativeVolume->getDataStoreParamsKIJ());
     }
 }
 
+void CauldronIO::DataStoreSave::addStoredData(pugi::xml_node node, const DataStoreParams* params) const
+{
+    // Only blocks in this file can be referred to; paths may be spelled differently
+    boost::system::error_code error;
+    if (!boost::filesystem::equivalent(boost::filesystem::path(m_fileName), params->fileName, error))
+        throw CauldronIOException("Existing data is not stored in datastore " + m_fileName);
+
+    // The block must be part of what was already in the file: anything else means the store was truncated or is written concurrently
+    if (params->offset + params->size > m_existingSize)
+        throw CauldronIOException("Existing data lies beyond the end of datastore " + m_fileName);
+
+    node.append_attribute("offset") = (unsigned long long)params->offset;
+    node.append_attribute("size") = (unsigned long long)params->size;
+    addEncodingAttributes(node, params);
+}
+
 void CauldronIO::DataStoreSave::addData(void* data, pugi::xml_node node, size_t numBytes)
 {
     pugi::xml_node subNode = node.append_child("datastore");
@@ -425,21 +1028,92 @@ void CauldronIO::DataStoreSave::addData(void* data, pugi::xml_node node, size_t
     m_dataToCompress.back()->setXmlNode(subNode);
 }
 
-void CauldronIO::DataStoreSave::writeVolume(const std::shared_ptr<VolumeData>& volume, bool dataIJK, bool compress)
+void CauldronIO::DataStoreSave::writeVolume(const std::shared_ptr<VolumeData>& volume, bool dataIJK, bool compress, pugi::xml_node node)
 {
     if (volume->isConstant()) return;
+
+    // Volumes larger than a tile are tiled, so regions can be read back without decompressing everything
+    const std::shared_ptr<Geometry3D>& geometry = volume->getGeometry();
+    if (dataIJK && m_tileI > 0 &&
+        (geometry->getNumI() > m_tileI || geometry->getNumJ() > m_tileJ || geometry->getNumK() > m_tileK))
+    {
+        writeTiledVolume(volume, compress, node);
+        return;
+    }
+
     const float* data = (dataIJK ? volume->getVolumeValues_IJK() : volume->getVolumeValues_KIJ());
 
-    addData(data, volume->getGeometry()->getSize(), compress);
+    addData(data, geometry->getSize(), compress);
+    m_dataToCompress.back()->setXmlNode(node);
+
+    double absoluteBound;
+    double step = compress ? getQuantizationStep(data, geometry->getSize(), m_errorBound, absoluteBound) : 0;
+    if (step != 0)
+        m_dataToCompress.back()->setQuantization(step, absoluteBound);
+}
+
+void CauldronIO::DataStoreSave::writeTiledVolume(const std::shared_ptr<VolumeData>& volume, bool compress, pugi::xml_node node)
+{
+    const std::shared_ptr<Geometry3D>& geometry = volume->getGeometry();
+    const size_t numI = geometry->getNumI();
+    const size_t numJ = geometry->getNumJ();
+    const size_t numK = geometry->getNumK();
+
+    node.append_attribute("tileI") = (unsigned long long)m_tileI;
+    node.append_attribute("tileJ") = (unsigned long long)m_tileJ;
+    node.append_attribute("tileK") = (unsigned long long)m_tileK;
+    node.append_attribute("numI") = (unsigned long long)numI;
+    node.append_attribute("numJ") = (unsigned long long)numJ;
+    node.append_attribute("numK") = (unsigned long long)numK;
+    const float* data = volume->getVolumeValues_IJK();
+
+    // One quantization step for the whole volume, so the relative bound refers to the range of the volume
+    double absoluteBound;
+    double step = compress ? getQuantizationStep(data, geometry->getSize(), m_errorBound, absoluteBound) : 0;
+
+    // Tiles that are not compressed are neither filtered nor quantized
+    if (compress)
+    {
+        addFilterAttribute(node, m_filter);
+        addQuantizationAttributes(node, step, absoluteBound);
+    }
+
+    const size_t numTiles = ((numI + m_tileI - 1) / m_tileI) * ((numJ + m_tileJ - 1) / m_tileJ) * ((numK + m_tileK - 1) / m_tileK);
+    std::shared_ptr<std::vector<size_t> > tileSizes(new std::vector<size_t>(numTiles));
+
+    size_t tileIndex = 0;
+    for (size_t k = 0; k < numK; k += m_tileK)
+    {
+        for (size_t j = 0; j < numJ; j += m_tileJ)
+        {
+            for (size_t i = 0; i < numI; i += m_tileI, ++tileIndex)
+            {
+                VolumeRegion tile = { i, j, k, std::min(m_tileI, numI - i), std::min(m_tileJ, numJ - j), std::min(m_tileK, numK - k) };
+                bool compressTile = compress && tile.numI * tile.numJ * tile.numK * sizeof(float) > MINIMALBYTESTOCOMPRESS;
+
+                std::shared_ptr<DataToCompress> dataToCompress(new DataToCompress(data, numI, numJ, tile, tileIndex, tileSizes, compressTile, m_filter));
+                dataToCompress->setXmlNode(node);
+                if (compressTile && step != 0)
+                    dataToCompress->setQuantization(step, absoluteBound);
+                m_dataToCompress.push_back(dataToCompress);
+            }
+        }
+    }
 }
 
 /// DataToCompress
 //////////////////////////////////////////////////////////////////////////
 
-CauldronIO::DataToCompress::DataToCompress(const void* inputData, size_t numBytes, bool compress)
+CauldronIO::DataToCompress::DataToCompress(const void* inputData, size_t numBytes, bool compress, unsigned int filter)
 {
     m_inputData = inputData;
     m_compress = compress;
+    m_filter = filter;
+    m_quantization = m_errorBound = 0;
+    m_volumeData = nullptr;
+    m_volumeNumI = m_volumeNumJ = 0;
+    m_tile = VolumeRegion();
+    m_tileIndex = 0;
     m_inputSize = numBytes;
     m_outputData = nullptr;
     m_node_set = false;
@@ -455,6 +1129,24 @@ CauldronIO::DataToCompress::~DataToCompress()
     }
 }
 
+CauldronIO::DataToCompress::DataToCompress(const float* volumeData, size_t numI, size_t numJ, const VolumeRegion& tile, size_t tileIndex,
+                                           std::shared_ptr<std::vector<size_t> > tileSizes, bool compress, unsigned int filter)
+    : DataToCompress(nullptr, tile.numI * tile.numJ * tile.numK * sizeof(float), compress, filter)
+{
+    m_volumeData = volumeData;
+    m_volumeNumI = numI;
+    m_volumeNumJ = numJ;
+    m_tile = tile;
+    m_tileIndex = tileIndex;
+    m_tileSizes = tileSizes;
+}
+
+void CauldronIO::DataToCompress::setQuantization(double step, double errorBound)
+{
+    m_quantization = step;
+    m_errorBound = errorBound;
+}
+
 void CauldronIO::DataToCompress::setOffset(size_t offset)
 {
     m_offset = offset;
@@ -465,12 +1157,55 @@ void CauldronIO::DataToCompress::compress()
     // Nothing to do if this has been processed
     if (m_processed) return;
 
+    // Gather the tile from the volume; this is kept as output if it does not compress
+    if (m_tileSizes)
+    {
+        m_tileData.reset(new char[m_inputSize]);
+        float* dest = (float*)m_tileData.get();
+        for (size_t k = m_tile.firstK; k < m_tile.firstK + m_tile.numK; ++k)
+        {
+            for (size_t j = m_tile.firstJ; j < m_tile.firstJ + m_tile.numJ; ++j, dest += m_tile.numI)
+                std::memcpy(dest, m_volumeData + m_tile.firstI + j * m_volumeNumI + k * m_volumeNumI * m_volumeNumJ, m_tile.numI * sizeof(float));
+        }
+        m_inputData = m_tileData.get();
+    }
+
     m_outputNrBytes = m_inputSize;
+    if (!m_compress)
+    {
+        m_processed = true;
+        return;
+    }
 
-    if (m_compress && !COMPRESSION_LZ4)
-        m_outputData = (void*)DataStoreSave::compress((char*)m_inputData, m_outputNrBytes);
-    else if (m_compress && COMPRESSION_LZ4)
-        m_outputData = (void*)DataStoreSave::compress_lz4((char*)m_inputData, m_outputNrBytes);
+    // Quantize and pre-filter into scratch buffers; only the compressed result is kept
+    const char* input = (const char*)m_inputData;
+    std::unique_ptr<char[]> quantized;
+    if (m_quantization != 0)
+    {
+        quantized.reset(new char[m_inputSize]);
+        DataStoreSave::quantize((const float*)input, quantized.get(), m_inputSize / sizeof(float), m_quantization);
+        input = quantized.get();
+    }
+
+    std::unique_ptr<char[]> filtered;
+    if (m_filter != FilterNone)
+    {
+        filtered.reset(new char[m_inputSize]);
+        DataStoreSave::applyFilter(input, filtered.get(), m_inputSize, m_filter);
+        input = filtered.get();
+    }
+
+    if (!COMPRESSION_LZ4)
+        m_outputData = (void*)DataStoreSave::compress(input, m_outputNrBytes);
+    else
+        m_outputData = (void*)DataStoreSave::compress_lz4(input, m_outputNrBytes);
+
+    // The gathered tile is not needed once it compressed
+    if (m_outputData && m_tileData)
+    {
+        m_tileData.reset();
+        m_inputData = nullptr;
+    }
 
     m_processed = true;
 }
@@ -494,6 +1229,11 @@ size_t CauldronIO::DataToCompress::getOutputSizeInBytes() const
     return m_outputNrBytes;
 }
 
+size_t CauldronIO::DataToCompress::getBufferSizeInBytes() const
+{
+    return (m_outputData ? m_outputNrBytes : 0) + (m_tileData ? m_inputSize : 0);
+}
+
 void CauldronIO::DataToCompress::setXmlNode(pugi::xml_node node)
 {
     m_node = node;
@@ -503,10 +1243,43 @@ void CauldronIO::DataToCompress::setXmlNode(pugi::xml_node node)
 void CauldronIO::DataToCompress::updateXmlNode()
 {
     assert(m_node_set);
+
+    // Tiles are written back to back: the first sets the offset, the last one the total size and the tile table
+    if (m_tileSizes)
+    {
+        std::vector<size_t>& tileSizes = *m_tileSizes;
+        tileSizes[m_tileIndex] = m_outputNrBytes;
+
+        if (m_tileIndex == 0)
+            m_node.append_attribute("offset") = (unsigned long long)m_offset;
+
+        if (m_tileIndex + 1 == tileSizes.size())
+        {
+            size_t totalSize = 0;
+            std::ostringstream sizes;
+            for (size_t i = 0; i < tileSizes.size(); ++i)
+            {
+                totalSize += tileSizes[i];
+                sizes << (i == 0 ? "" : " ") << tileSizes[i];
+            }
+            m_node.append_attribute("size") = (unsigned long long)totalSize;
+            m_node.append_child("tilesizes").text() = sizes.str().c_str();
+        }
+
+        // Release the gathered tile if it was written uncompressed
+        m_tileData.reset();
+        return;
+    }
+
     m_node.append_attribute("size") = (unsigned long long)m_outputNrBytes;
     m_node.append_attribute("offset") = (unsigned long long)m_offset;
 
-    // If compression failed reset compression (none)
+    // If compression failed reset compression (none); the unfiltered, lossless input is written in that case
     if (m_compress && m_outputData == nullptr)
         m_node.attribute("compression") = "none";
+    else if (m_compress)
+    {
+        DataStoreSave::addFilterAttribute(m_node, m_filter);
+        DataStoreSave::addQuantizationAttributes(m_node, m_quantization, m_errorBound);
+    }
 }
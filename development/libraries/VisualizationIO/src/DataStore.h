@@ -14,10 +14,13 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <iostream>
 #include <fstream>
 #include "pugixml.hpp"
 #include "FilePath.h"
+#include "VisualizationAPI.h"
 
 namespace CauldronIO
 {
@@ -30,35 +33,93 @@ namespace CauldronIO
     class Geometry2D;
     class Geometry3D;
 
+    /// \brief Pre-filters applied to floating point blocks before compression; these can be combined
+    /// \details Both work on 32-bit words, so they are lossless: delta stores the difference with the previous word,
+    /// shuffle groups the n-th byte of all words together. Encoding applies delta first, decoding reverses the order.
+    enum DataStoreFilter
+    {
+        FilterNone = 0,
+        FilterDelta = 1,
+        FilterShuffle = 2
+    };
+
+    /// \brief Error bound for lossy storage of floating point data
+    /// \details Lossy data is quantized to integers before filtering and compression; every decoded value is guaranteed
+    /// to be within the bound of the original. Undefined values are kept exactly. If the bound cannot be guaranteed for
+    /// all values of a block (infinite values, or a bound below float precision) the block is stored lossless.
+    struct ErrorBound
+    {
+        ErrorBound() : bound(0), relative(false) { ; }
+        ErrorBound(double bound, bool relative) : bound(bound), relative(relative) { ; }
+
+        double bound;  // maximum absolute error, or fraction of the value range of a block if relative; zero for lossless
+        bool relative; // true if the bound is relative to the value range
+    };
+
     /// \brief Little struct to hold parameters to be able to retrieve data from disk
     struct DataStoreParams
     {
-        DataStoreParams() : fileName("") { ; }
+        DataStoreParams() : fileName(""), filter(FilterNone), quantization(0), errorBound(0), tileI(0), tileJ(0), tileK(0), numI(0), numJ(0), numK(0) { ; }
 
         boost::filesystem::path fileName;
         size_t offset;       // offset within the file
         size_t size;         // size of data chunk
         bool compressed;     // true if compressed
         bool compressed_lz4; // true if compressed with lz4 algorithm
+        unsigned int filter; // DataStoreFilter flags applied before compression
+        double quantization; // quantization step of lossy data; zero if lossless
+        double errorBound;   // absolute error bound of lossy data
+
+        // Tiled IJK volumes: the data chunk holds independently compressed tiles, I fastest, then J, then K.
+        // A tile whose stored size equals its uncompressed size is stored as is (not compressed nor filtered).
+        size_t tileI, tileJ, tileK;      // tile dimensions; zero if not tiled
+        size_t numI, numJ, numK;         // volume dimensions
+        std::vector<size_t> tileOffsets; // offset of each tile relative to the chunk, plus the chunk size
     };
 
     /// \brief Little class to load data from binary storage
+    /// \details The data block is memory-mapped rather than read: uncompressed blocks can be used in place
+    /// and compressed blocks are decompressed straight from the mapping. Only the pages that are touched become resident.
+    /// The mapping is private (copy-on-write), so data used in place can be modified without changing the file.
     class DataStoreLoad
     {
     public:
         /// \brief Prepares the dataload from the given parameters
-        DataStoreLoad(DataStoreParams* params);
+        DataStoreLoad(const DataStoreParams* params);
         /// \brief Load the data from the datastore: ownership is transferred to caller!
         /// \param [inout] size (input): the expected uncompressed size of the data; output: the actual uncompressed size
         float* getData(size_t& size);
-        /// \brief Load the data from disk, but do not decompress yet
+        /// \brief Load the (decompressed) data from the datastore into the given buffer of uncompressedSize bytes
+        void getData(char* buffer, size_t uncompressedSize);
+        /// \brief Map the data block from disk, but do not decompress yet
         void prefetch();
+        /// \brief Returns true if the data block needs decompression (or removal of a pre-filter)
+        bool isCompressed() const;
+        /// \brief Returns the raw (possibly compressed) data block inside the file mapping; the pointer is owned by this object
+        /// and valid for its lifetime
+        const char* getMappedData();
+        /// \brief Returns the uncompressed data block inside the file mapping, which is kept alive by the returned pointer
+        /// \details The mapping is handed over: it is released when the last copy of the pointer is destroyed, not with this object
+        std::shared_ptr<float> shareMappedData();
+        /// \brief Returns true if the data block is a tiled volume
+        bool isTiled() const;
+        /// \brief Load a sub-box of a tiled volume into the given buffer, decompressing only the tiles it intersects
+        /// \param [in] region the sub-box, with k relative to the first k of the stored volume
+        void getRegion(const VolumeRegion& region, float* buffer);
         ~DataStoreLoad();
 
         // Returns a decompressed char* with size "size", for given input data char* and size
         static char* decompress(const char* data, size_t& size);
+        // Decompresses gzip data of compressedSize bytes into the preallocated output buffer of uncompressedSize bytes
+        static void decompress(const char* inputData, size_t compressedSize, char* outputData, size_t uncompressedSize);
         // Returns a decompressed char* with size "size", for given input data char* and uncompressed size; the compressedSize will be output
         static char* decompress_lz4(const char* inputData, size_t compressedSize, size_t uncompressedSize);
+        // Reverses the DataStoreFilter flags of the inputData into outputData, both of numBytes
+        static void removeFilter(const char* inputData, char* outputData, size_t numBytes, unsigned int filter);
+        // Returns the DataStoreFilter flags for the XML filter attribute value (empty when not filtered)
+        static unsigned int parseFilter(const std::string& filterName);
+        // Converts quantized data of numBytes back to floats, in place
+        static void dequantize(char* data, size_t numBytes, double step);
 
         /// \brief Creates a volume from the current XML node and assigns given Property
         static void getVolume(pugi::xml_node propertyVolNode, std::shared_ptr<VolumeData> volumeData, const ibs::FilePath& path);
@@ -68,9 +129,11 @@ namespace CauldronIO
         static void getSurface(pugi::xml_node propertyMapNode, std::shared_ptr<SurfaceData> surfaceData, const ibs::FilePath& path);
 
     private:
-        std::ifstream m_file_in;
-        DataStoreParams* m_params;
-        char* m_data_uncompressed;
+        void getTile(size_t tileIndex, size_t numBytes, char* buffer, std::unique_ptr<char[]>& scratch);
+
+        boost::iostreams::mapped_file m_mapping;
+        const DataStoreParams* m_params;
+        const char* m_data_mapped;
     };
 
     /// \brief Little class to hold data to compress
@@ -81,7 +144,14 @@ namespace CauldronIO
         /// \param[in] inputData the (void) data to compress
         /// \param[in] numBytes the number of bytes in the input data to compress
         /// \param[in] compress if true the data will be compressed, otherwise, no compression
-        DataToCompress(const void* inputData, size_t numBytes, bool compress);
+        /// \param[in] filter DataStoreFilter flags to apply before compression; only for floating point data
+        DataToCompress(const void* inputData, size_t numBytes, bool compress, unsigned int filter = FilterNone);
+        /// \brief Creates a new instance for one tile of an IJK volume; the tile is gathered from the volume when compressed
+        /// \param[in] volumeData the volume data, numI * numJ * numK floats, I fastest
+        /// \param[in] tile the sub-box of this tile, with k relative to the first k of the volume
+        /// \param[in] tileSizes stored size of all tiles of the volume, shared between them; the last tile writes the XML node
+        DataToCompress(const float* volumeData, size_t numI, size_t numJ, const VolumeRegion& tile, size_t tileIndex,
+                       std::shared_ptr<std::vector<size_t> > tileSizes, bool compress, unsigned int filter);
         /// \brief Destroys the obect
         ~DataToCompress();
         /// \brief Sets the offset within the binary output file; to be written to
@@ -94,17 +164,32 @@ namespace CauldronIO
         const void* getOutputData() const;
         /// \brief
         size_t getOutputSizeInBytes() const;
+        /// \brief Returns the number of bytes allocated by this block: the compressed data and the gathered tile, if any
+        size_t getBufferSizeInBytes() const;
         /// \brief
         void setXmlNode(pugi::xml_node node);
         /// \brief Writes size and offset to the xml node
         void updateXmlNode();
+        /// \brief Store this (floating point) block lossy, quantized with the given step
+        void setQuantization(double step, double errorBound);
 
      private:
         const void* m_inputData; // not owned by us (!)
         void* m_outputData;
         size_t m_inputSize, m_outputNrBytes, m_offset;
-        bool m_compress, m_processed, m_node_set;
+        bool m_compress, m_node_set;
+        boost::atomic<bool> m_processed; // set by the compressing thread, read by the writing thread
+        unsigned int m_filter;
+        double m_quantization, m_errorBound;
         pugi::xml_node m_node;
+
+        // Tile of a volume; only used if m_tileSizes is set
+        const float* m_volumeData;
+        size_t m_volumeNumI, m_volumeNumJ;
+        VolumeRegion m_tile;
+        size_t m_tileIndex;
+        std::shared_ptr<std::vector<size_t> > m_tileSizes;
+        std::unique_ptr<char[]> m_tileData;
     };
 
     /// \brief Little class to load data from binary storage
@@ -114,20 +199,50 @@ namespace CauldronIO
         /// \brief Creates a new instance, to store binary data to the given filename
         /// \param [in] append If true, appends to existing data structure, otherwise, write from scratch. This is only supported with native data
         /// \param [in] filename filename where to save to
+        /// \details When appending, existing data is never rewritten: new blocks go after the current end of the file, so readers of the
+        /// existing data are not affected
        DataStoreSave(const std::string& filename, bool append);
         ~DataStoreSave();
 
-        /// \brief Write all data to disk
+        /// \brief Write all data to disk; compresses blocks that have not been compressed yet
+        /// \details Blocks are released once written, so this can be called repeatedly while data is added
         void flush();
+        /// \brief Writes the blocks, in order, up to the first one that has not been compressed yet
+        /// \returns the number of blocks written so far
+        size_t flushProcessed();
+        /// \returns the number of blocks added so far, written or not
+        size_t getNumBlocks() const;
 
         /// \brief Adds a surface to the XML node, and writes the binary data
         void addSurface(const std::shared_ptr<SurfaceData>& surfaceData, pugi::xml_node node);
         /// \brief Adds a volume to the XML node, and writes the binary data
         void addVolume(const std::shared_ptr<VolumeData>& data, pugi::xml_node node, size_t numBytes);
-        /// \brief Returns a list with DataToCompress that can be compressed
+        /// \brief Returns a list with DataToCompress that has not been written yet, and can be compressed
         std::vector<std::shared_ptr<DataToCompress> > getDataToCompressList();
         /// \brief Add generic data to this datastore
         void addData(void* data, pugi::xml_node node, size_t numBytes);
+        /// \brief Sets the DataStoreFilter flags for surfaces and volumes added from now on
+        void setFilter(unsigned int filter);
+        /// \brief Sets the tile dimensions for IJK volumes added from now on; zero disables tiling
+        void setTileSize(size_t tileI, size_t tileJ, size_t tileK);
+        /// \brief Sets the error bound for surfaces and volumes added from now on; a zero bound stores them lossless
+        void setErrorBound(const ErrorBound& errorBound);
+
+        /// \brief Applies the DataStoreFilter flags to the inputData into outputData, both of numBytes
+        static void applyFilter(const char* inputData, char* outputData, size_t numBytes, unsigned int filter);
+        /// \brief Returns the XML filter attribute value for the DataStoreFilter flags
+        static std::string getFilterName(unsigned int filter);
+        /// \brief Adds the filter attribute to the datastore node, if any filter is set
+        static void addFilterAttribute(pugi::xml_node node, unsigned int filter);
+        /// \brief Adds the quantization attributes to the datastore node, if the data is lossy
+        static void addQuantizationAttributes(pugi::xml_node node, double step, double errorBound);
+        /// \brief Adds filter, quantization and tile layout of already stored data to the datastore node
+        static void addEncodingAttributes(pugi::xml_node node, const DataStoreParams* params);
+        /// \brief Returns the quantization step that guarantees the error bound for all values, or zero if it cannot be guaranteed
+        /// \param [out] absoluteBound the absolute error bound
+        static double getQuantizationStep(const float* data, size_t size, const ErrorBound& errorBound, double& absoluteBound);
+        /// \brief Quantizes size floats to 32-bit integers with the given step
+        static void quantize(const float* inputData, char* outputData, size_t size, double step);
 
         // Returns a compressed char* with size "size", for given input data char* and size
         static char* compress(const char* data, size_t& size);
@@ -135,16 +250,22 @@ namespace CauldronIO
         static char* compress_lz4(const char* inputData, size_t& size);
 
     private:
-        void writeVolume(const std::shared_ptr<VolumeData>& volume, bool dataIJK, bool compress);
+        void writeVolume(const std::shared_ptr<VolumeData>& volume, bool dataIJK, bool compress, pugi::xml_node node);
+        void writeTiledVolume(const std::shared_ptr<VolumeData>& volume, bool compress, pugi::xml_node node);
         void writeVolumePart(pugi::xml_node volNode, bool compress, bool IJK, const std::shared_ptr<VolumeData>& volume);
         void addData(const float* data, size_t size, bool compressData);
+        void addStoredData(pugi::xml_node node, const DataStoreParams* params) const;
+        void writeBlocks(size_t numBlocks);
 
         std::ofstream m_file_out;
         std::string m_fileName;
-        size_t m_offset;
+        size_t m_offset, m_existingSize;
         bool m_compress;
-        std::vector<std::shared_ptr<DataToCompress> > m_dataToCompress;
-        bool m_flushed;
+        unsigned int m_filter;
+        ErrorBound m_errorBound;
+        size_t m_tileI, m_tileJ, m_tileK;
+        std::vector<std::shared_ptr<DataToCompress> > m_dataToCompress; // blocks not written yet
+        size_t m_numWritten;
     };
 }
 
@@ -11,6 +11,7 @@
 #include "ImportFromXML.h"
 #include "VisualizationIO_native.h"
 #include "DataStore.h"
+#include "XmlIndex.h"
 #include "FilePath.h"
 #include "FolderPath.h"
 
@@ -21,6 +22,41 @@
 
 using namespace CauldronIO;
 
+/// \brief Parses a snapshot from the project xml when it is first accessed
+class CauldronIO::ImportFromXML::SnapShotLoader : public SnapShotContents
+{
+public:
+    SnapShotLoader(const std::weak_ptr<Project>& project, const ibs::FilePath& absPath, const std::shared_ptr<XmlIndex::File>& xmlFile,
+                   const std::string& outputPath, const XmlIndex::SnapShotEntry& entry)
+        : m_project(project), m_absPath(absPath), m_xmlFile(xmlFile), m_outputPath(outputPath), m_entry(entry)
+    {
+    }
+
+    virtual void load(SnapShot& snapShot)
+    {
+        // The snapshot refers to properties, formations and geometries of its project
+        std::shared_ptr<Project> project = m_project.lock();
+        if (!project)
+            throw CauldronIOException("Cannot load snapshot of a project that has been deleted");
+
+        std::string text = XmlIndex::readSnapShot(*m_xmlFile, m_entry);
+        pugi::xml_document doc;
+        if (!doc.load_buffer(text.data(), text.size()) || !doc.child("snapshot"))
+            throw CauldronIOException("Error during parsing snapshot in xml file");
+
+        ImportFromXML importExport(m_absPath);
+        importExport.m_project = project;
+        importExport.getSnapShotContents(doc.child("snapshot"), snapShot, ibs::FilePath(m_outputPath));
+    }
+
+private:
+    std::weak_ptr<Project> m_project;
+    ibs::FilePath m_absPath;
+    std::shared_ptr<XmlIndex::File> m_xmlFile; // shared by the snapshots of the project
+    std::string m_outputPath;
+    XmlIndex::SnapShotEntry m_entry;
+};
+
 //////////////////////////////////////////////////////////////////////////
 /// Importing from native format
 //////////////////////////////////////////////////////////////////////////
@@ -30,8 +66,16 @@ std::shared_ptr<Project> CauldronIO::ImportFromXML::importFromXML(const std::str
     if (!ibs::FilePath(filename).exists())
         throw CauldronIOException("Cannot open file");
 
+    // With an up to date index only the xml outside the snapshots is parsed now; snapshots are parsed on first access,
+    // from the file opened here, so replacing the xml later on does not affect this project
+    std::shared_ptr<XmlIndex::File> xmlFile(new XmlIndex::File(filename));
+    std::vector<XmlIndex::SnapShotEntry> snapShots;
+    std::string xmlWithoutSnapShots;
+    bool indexed = XmlIndex::load(*xmlFile, snapShots, xmlWithoutSnapShots);
+
     pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(filename.c_str());
+    pugi::xml_parse_result result = indexed ? doc.load_buffer(xmlWithoutSnapShots.data(), xmlWithoutSnapShots.size())
+                                            : doc.load_file(filename.c_str());
 
     if (!result)
         throw CauldronIOException("Error during parsing xml file");
@@ -43,6 +87,8 @@ std::shared_ptr<Project> CauldronIO::ImportFromXML::importFromXML(const std::str
     try
     {
        project = importExport.getProject(doc);
+       if (indexed)
+          importExport.addIndexedSnapShots(xmlFile, snapShots);
     }
     catch (CauldronIOException& excp)
     {
@@ -88,7 +134,8 @@ std::shared_ptr<Project> CauldronIO::ImportFromXML::getProject(const pugi::xml_d
     }
 
     bool forwardCompatible = dataXmlVersionMajor > xml_version_major || (dataXmlVersionMajor == xml_version_major && dataXmlVersionMinor > xml_version_minor);
-    bool backwardCompatible = dataXmlVersionMajor < xml_version_major || (dataXmlVersionMajor == xml_version_major && dataXmlVersionMinor < xml_version_minor);
+    // Versions from xml_version_minor_oldest on only add optional attributes to the datastores, whose absence means the old behaviour
+    bool backwardCompatible = dataXmlVersionMajor < xml_version_major || (dataXmlVersionMajor == xml_version_major && dataXmlVersionMinor < xml_version_minor_oldest);
 
     if (forwardCompatible)
         throw CauldronIOException("Xml format not forward compatible");
@@ -105,6 +152,8 @@ std::shared_ptr<Project> CauldronIO::ImportFromXML::getProject(const pugi::xml_d
         fullOutputPath = ibs::FilePath(outputPath);
     }
 
+    m_outputPath = fullOutputPath.path();
+
     // Create the project
     m_project.reset(new Project(projectName, projectDescript, projectVersion, dataXmlVersionMajor, dataXmlVersionMinor));
 
@@ -341,92 +390,107 @@ std::shared_ptr<Project> CauldronIO::ImportFromXML::getProject(const pugi::xml_d
         // Create the snapshot
         std::shared_ptr<SnapShot> snapShot(new SnapShot(age, kind, isminor));
 
-        // Find all surfaces
-        /////////////////////////////////////////
-        pugi::xml_node hasSurfaces = snapShotNode.child("surfaces");
-        if (hasSurfaces)
-        {
-            for (pugi::xml_node surfaceNode = hasSurfaces.child("surface"); surfaceNode; surfaceNode = surfaceNode.next_sibling("surface"))
-            {
-                std::shared_ptr<Surface> surface = getSurface(surfaceNode, fullOutputPath);
+        getSnapShotContents(snapShotNode, *snapShot, fullOutputPath);
 
-                // Add to snapshot
-                snapShot->addSurface(surface);
-            }
-        }
+        m_project->addSnapShot(snapShot);
+    }
 
-        // Find all (continuous) volumes
-        /////////////////////////////////////////
-        pugi::xml_node hasVolumes = snapShotNode.child("volume");
-        if (hasVolumes)
+    return m_project;
+}
+
+void CauldronIO::ImportFromXML::getSnapShotContents(pugi::xml_node snapShotNode, SnapShot& snapShot, const ibs::FilePath& fullOutputPath)
+{
+    // Find all surfaces
+    /////////////////////////////////////////
+    pugi::xml_node hasSurfaces = snapShotNode.child("surfaces");
+    if (hasSurfaces)
+    {
+        for (pugi::xml_node surfaceNode = hasSurfaces.child("surface"); surfaceNode; surfaceNode = surfaceNode.next_sibling("surface"))
         {
-            std::shared_ptr<Volume> volume = getVolume(hasVolumes, fullOutputPath);
-            snapShot->setVolume(volume);
+            std::shared_ptr<Surface> surface = getSurface(surfaceNode, fullOutputPath);
+
+            // Add to snapshot
+            snapShot.addSurface(surface);
         }
+    }
 
-        // Get formation volumes
-        //////////////////////////////////////////////////////////////////////////
-        pugi::xml_node hasFormationVolumes = snapShotNode.child("formvols");
+    // Find all (continuous) volumes
+    /////////////////////////////////////////
+    pugi::xml_node hasVolumes = snapShotNode.child("volume");
+    if (hasVolumes)
+    {
+        std::shared_ptr<Volume> volume = getVolume(hasVolumes, fullOutputPath);
+        snapShot.setVolume(volume);
+    }
 
-        // Get all property volume data
-        if (hasFormationVolumes)
+    // Get formation volumes
+    //////////////////////////////////////////////////////////////////////////
+    pugi::xml_node hasFormationVolumes = snapShotNode.child("formvols");
+
+    // Get all property volume data
+    if (hasFormationVolumes)
+    {
+        for (pugi::xml_node formVolNode = hasFormationVolumes.child("formvol"); formVolNode; formVolNode = formVolNode.next_sibling("formvol"))
         {
-            for (pugi::xml_node formVolNode = hasFormationVolumes.child("formvol"); formVolNode; formVolNode = formVolNode.next_sibling("formvol"))
-            {
-                std::string formationName = formVolNode.attribute("formation").value();
-                std::shared_ptr<const Formation> formationIO = m_project->findFormation(formationName);
-                assert(formationIO);
+            std::string formationName = formVolNode.attribute("formation").value();
+            std::shared_ptr<const Formation> formationIO = m_project->findFormation(formationName);
+            assert(formationIO);
 
-                // There should be a volume
-                pugi::xml_node volumeNode = formVolNode.child("volume");
-                std::shared_ptr<Volume> volume = getVolume(volumeNode, fullOutputPath);
+            // There should be a volume
+            pugi::xml_node volumeNode = formVolNode.child("volume");
+            std::shared_ptr<Volume> volume = getVolume(volumeNode, fullOutputPath);
 
-                // Add it to the list
-                FormationVolume formVolume(formationIO, volume);
-                snapShot->addFormationVolume(formVolume);
-            }
+            // Add it to the list
+            FormationVolume formVolume(formationIO, volume);
+            snapShot.addFormationVolume(formVolume);
         }
+    }
 
-        // Get trappers
-        //////////////////////////////////////////////////////////////////////////
+    // Get trappers
+    //////////////////////////////////////////////////////////////////////////
 
-        pugi::xml_node hasTrappers = snapShotNode.child("trappers");
-        if (hasTrappers)
+    pugi::xml_node hasTrappers = snapShotNode.child("trappers");
+    if (hasTrappers)
+    {
+        for (pugi::xml_node trapperNode = hasTrappers.child("trapper"); trapperNode; trapperNode = trapperNode.next_sibling("trapper"))
         {
-            for (pugi::xml_node trapperNode = hasTrappers.child("trapper"); trapperNode; trapperNode = trapperNode.next_sibling("trapper"))
-            {
-                int ID = trapperNode.attribute("id").as_int();
-                int persistentID = trapperNode.attribute("persistentID").as_int();
-                int downstreamTrapperID = trapperNode.attribute("downstreamtrapper").as_int();
-                float depth = trapperNode.attribute("depth").as_float();
-                float spillDepth = trapperNode.attribute("spillDepth").as_float();
-                std::string reservoirname = trapperNode.attribute("reservoirname").value();
-
-                float x      = trapperNode.attribute("posX").as_float();
-                float y      = trapperNode.attribute("posY").as_float();
-                float spillX = trapperNode.attribute("spillPosX").as_float();
-                float spillY = trapperNode.attribute("spillPosY").as_float();
-                float goc    = trapperNode.attribute("goc").as_float();
-                float owc    = trapperNode.attribute("owc").as_float();
-
-                std::shared_ptr<Trapper> trapperIO(new Trapper(ID, persistentID));
-                trapperIO->setDownStreamTrapperID(downstreamTrapperID);
-                trapperIO->setReservoirName(reservoirname);
-                trapperIO->setSpillDepth(spillDepth);
-                trapperIO->setSpillPointPosition(spillX, spillY);
-                trapperIO->setDepth(depth);
-                trapperIO->setPosition(x, y);
-                trapperIO->setOWC(owc);
-                trapperIO->setGOC(goc);
-
-                snapShot->addTrapper(trapperIO);
-            }
+            int ID = trapperNode.attribute("id").as_int();
+            int persistentID = trapperNode.attribute("persistentID").as_int();
+            int downstreamTrapperID = trapperNode.attribute("downstreamtrapper").as_int();
+            float depth = trapperNode.attribute("depth").as_float();
+            float spillDepth = trapperNode.attribute("spillDepth").as_float();
+            std::string reservoirname = trapperNode.attribute("reservoirname").value();
+
+            float x      = trapperNode.attribute("posX").as_float();
+            float y      = trapperNode.attribute("posY").as_float();
+            float spillX = trapperNode.attribute("spillPosX").as_float();
+            float spillY = trapperNode.attribute("spillPosY").as_float();
+            float goc    = trapperNode.attribute("goc").as_float();
+            float owc    = trapperNode.attribute("owc").as_float();
+
+            std::shared_ptr<Trapper> trapperIO(new Trapper(ID, persistentID));
+            trapperIO->setDownStreamTrapperID(downstreamTrapperID);
+            trapperIO->setReservoirName(reservoirname);
+            trapperIO->setSpillDepth(spillDepth);
+            trapperIO->setSpillPointPosition(spillX, spillY);
+            trapperIO->setDepth(depth);
+            trapperIO->setPosition(x, y);
+            trapperIO->setOWC(owc);
+            trapperIO->setGOC(goc);
+
+            snapShot.addTrapper(trapperIO);
         }
+    }
+}
 
+void CauldronIO::ImportFromXML::addIndexedSnapShots(const std::shared_ptr<XmlIndex::File>& xmlFile, const std::vector<XmlIndex::SnapShotEntry>& snapShots)
+{
+    for (const XmlIndex::SnapShotEntry& entry : snapShots)
+    {
+        std::shared_ptr<SnapShot> snapShot(new SnapShot(entry.age, (SnapShotKind)entry.kind, entry.isMinor));
+        snapShot->setContents(std::shared_ptr<SnapShotContents>(new SnapShotLoader(m_project, m_absPath, xmlFile, m_outputPath, entry)));
         m_project->addSnapShot(snapShot);
     }
-
-    return m_project;
 }
 
 std::shared_ptr<const Reservoir> CauldronIO::ImportFromXML::getReservoir(pugi::xml_node reservoirNode) const
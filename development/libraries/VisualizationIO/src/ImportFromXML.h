@@ -13,6 +13,7 @@
 
 #include "VisualizationAPI.h"
 #include "DataStore.h"
+#include "XmlIndex.h"
 #include "FilePath.h"
 
 #ifdef _MSC_VER
@@ -30,6 +31,7 @@ namespace CauldronIO
     {
     public:
         /// \brief Creates a new Project from the supplied XML indexing file
+        /// If there is an up to date binary index next to the xml file, snapshots are parsed on first access
         /// Throws a CauldronIOException on failure
        static std::shared_ptr<Project> importFromXML(const std::string& filename);
         
@@ -41,14 +43,19 @@ namespace CauldronIO
         std::shared_ptr<Property> getProperty(pugi::xml_node propertyNode) const;
         std::shared_ptr<Formation> getFormation(pugi::xml_node formationNode, const ibs::FilePath& fullOutputPath) const;
         std::shared_ptr<Project> getProject(const pugi::xml_document& pt);
+        void getSnapShotContents(pugi::xml_node snapShotNode, SnapShot& snapShot, const ibs::FilePath& fullOutputPath);
+        void addIndexedSnapShots(const std::shared_ptr<XmlIndex::File>& xmlFile, const std::vector<XmlIndex::SnapShotEntry>& snapShots);
         std::shared_ptr<const Reservoir> getReservoir(pugi::xml_node reservoirNode) const;
         std::shared_ptr<const Geometry2D> getGeometry2D(pugi::xml_node surfaceNode) const;
         std::shared_ptr<Volume> getVolume(pugi::xml_node volumeNode, const ibs::FilePath& path);
         std::shared_ptr<CauldronIO::Surface> getSurface(pugi::xml_node surfaceNode, const ibs::FilePath& fullOutputPath) const;
         CauldronIO::PropertySurfaceData getPropertySurfaceData(pugi::xml_node &propertyMapNode, const ibs::FilePath& fullOutputPath) const;
         
+        class SnapShotLoader;
+
         // member variables
         ibs::FilePath m_absPath;
+        std::string m_outputPath;
         std::shared_ptr<Project> m_project;
     };
 }
@@ -408,8 +408,49 @@ CauldronIO::SnapShot::~SnapShot()
     m_trapperList.clear();
 }
 
+void CauldronIO::SnapShot::setContents(const std::shared_ptr<SnapShotContents>& contents)
+{
+    loadContents();
+    m_contents = contents;
+}
+
+bool CauldronIO::SnapShot::isLoaded() const
+{
+    return !m_contents;
+}
+
+void CauldronIO::SnapShot::loadContents() const
+{
+    if (!m_contents) return;
+
+    // Reset first: the contents are added through the public methods, which end up here again
+    std::shared_ptr<SnapShotContents> contents;
+    contents.swap(m_contents);
+
+    SnapShot& snapShot = const_cast<SnapShot&>(*this);
+    const size_t numSurfaces = m_surfaceList.size();
+    const size_t numFormationVolumes = m_formationVolumeList.size();
+    const size_t numTrappers = m_trapperList.size();
+    const std::shared_ptr<Volume> volume = m_volume;
+    try
+    {
+        contents->load(snapShot);
+    }
+    catch (...)
+    {
+        // Drop what was loaded and keep the contents, so the snapshot is not left loaded but empty
+        snapShot.m_surfaceList.erase(snapShot.m_surfaceList.begin() + numSurfaces, snapShot.m_surfaceList.end());
+        snapShot.m_formationVolumeList.erase(snapShot.m_formationVolumeList.begin() + numFormationVolumes, snapShot.m_formationVolumeList.end());
+        snapShot.m_trapperList.erase(snapShot.m_trapperList.begin() + numTrappers, snapShot.m_trapperList.end());
+        snapShot.m_volume = volume;
+        m_contents.swap(contents);
+        throw;
+    }
+}
+
 void CauldronIO::SnapShot::setVolume(std::shared_ptr<Volume>& volume)
 {
+    loadContents();
     m_volume = volume;
 }
 
@@ -417,11 +458,13 @@ void CauldronIO::SnapShot::addSurface(std::shared_ptr<Surface>& newSurface)
 {
     if (!newSurface) throw CauldronIOException("Cannot add empty surface");
 
+    loadContents();
     m_surfaceList.push_back(newSurface);
 }
 
 void CauldronIO::SnapShot::addFormationVolume(FormationVolume& formVolume)
 {
+    loadContents();
     m_formationVolumeList.push_back(formVolume);
 }
 
@@ -430,6 +473,7 @@ void CauldronIO::SnapShot::addTrapper(std::shared_ptr<Trapper>& newTrapper)
 {
     if (!newTrapper) throw CauldronIOException("Cannot add empty trapper");
 
+    loadContents();
     m_trapperList.push_back(newTrapper);
 }
 
@@ -450,21 +494,25 @@ bool CauldronIO::SnapShot::isMinorShapshot() const
 
 const SurfaceList& CauldronIO::SnapShot::getSurfaceList() const
 {
+    loadContents();
     return m_surfaceList;
 }
 
 const std::shared_ptr<Volume>& CauldronIO::SnapShot::getVolume() const
 {
+    loadContents();
     return m_volume;
 }
 
 const FormationVolumeList& CauldronIO::SnapShot::getFormationVolumeList() const
 {
+    loadContents();
     return m_formationVolumeList;
 }
 
 const TrapperList& CauldronIO::SnapShot::getTrapperList() const
 {
+    loadContents();
     return m_trapperList;
 }
 
@@ -512,6 +560,7 @@ float CauldronIO::SnapShot::getPropertyAtLocation(const FormationList& formation
                                                   const std::string& reservoirName, const std::string& surfaceName,
                                                   const std::string& formationName ) const
 {
+   loadContents();
 
    if(property == 0)  throw  CauldronIOException ("Property not found");
    if(zCoord == DefaultUndefinedScalarValue and formationName == "" and surfaceName == "") {
@@ -804,6 +853,7 @@ bool CauldronIO::SnapShot::findFormationForSurface(const FormationList& formatio
 
 void CauldronIO::SnapShot::retrieve()
 {
+    loadContents();
     if (m_volume)
         m_volume->retrieve();
     for(FormationVolume& formVolume: m_formationVolumeList)
@@ -1700,8 +1750,7 @@ void CauldronIO::SurfaceData::setConstantValue(float value)
 
 CauldronIO::SurfaceData::~SurfaceData()
 {
-    if (m_internalData) delete[] m_internalData;
-    m_internalData = nullptr;
+    freeData();
 }
 
 const std::shared_ptr<const Geometry2D>& CauldronIO::SurfaceData::getGeometry() const
@@ -1715,8 +1764,29 @@ void CauldronIO::SurfaceData::setData_IJ(float* data)
    else       setData(data);
 }
 
+void CauldronIO::SurfaceData::setSharedData_IJ(const std::shared_ptr<float>& data)
+{
+    if (!data) throw CauldronIOException("Cannot set data from empty buffer");
+
+    freeData();
+    m_sharedData = data;
+    m_internalData = data.get();
+    m_retrieved = true;
+}
+
+void CauldronIO::SurfaceData::freeData()
+{
+    if (!m_sharedData && m_internalData) delete[] m_internalData;
+    m_sharedData.reset();
+    m_internalData = nullptr;
+}
+
 void CauldronIO::SurfaceData::setData(float* data, bool setValue, float value)
 {
+    // A shared buffer is not ours to overwrite; keep it alive while copying, data may point into it
+    std::shared_ptr<float> sharedData = m_sharedData;
+    if (sharedData) freeData();
+
     // If our data buffer exists, we will just reuse it. Otherwise, allocate
     if (!m_internalData)
     {
@@ -1879,8 +1949,7 @@ size_t CauldronIO::SurfaceData::getMapIndex(size_t i, size_t j) const
 
 void CauldronIO::SurfaceData::release()
 {
-    if (m_internalData) delete[] m_internalData;
-    m_internalData = nullptr;
+    freeData();
     m_retrieved = false;
 }
 
@@ -2155,10 +2224,8 @@ CauldronIO::VolumeData::VolumeData(const std::shared_ptr<Geometry3D>& geometry,
 
 CauldronIO::VolumeData::~VolumeData()
 {
-    if (m_internalDataIJK) delete[] m_internalDataIJK;
-    if (m_internalDataKIJ) delete[] m_internalDataKIJ;
-    m_internalDataIJK = nullptr;
-    m_internalDataKIJ = nullptr;
+    freeData(&m_internalDataIJK);
+    freeData(&m_internalDataKIJ);
 }
 
 const std::shared_ptr<Geometry3D>& CauldronIO::VolumeData::getGeometry() const
@@ -2394,6 +2461,35 @@ void CauldronIO::VolumeData::setData_IJK(float* data, bool setValue /*= false*/,
     setData(data, &m_internalDataIJK, setValue, value);
 }
 
+void CauldronIO::VolumeData::setSharedData_KIJ(const std::shared_ptr<float>& data)
+{
+    if (!data) throw CauldronIOException("Cannot set data from empty buffer");
+
+    freeData(&m_internalDataKIJ);
+    m_sharedDataKIJ = data;
+    m_internalDataKIJ = data.get();
+    m_retrieved = true;
+}
+
+void CauldronIO::VolumeData::setSharedData_IJK(const std::shared_ptr<float>& data)
+{
+    if (!data) throw CauldronIOException("Cannot set data from empty buffer");
+
+    freeData(&m_internalDataIJK);
+    m_sharedDataIJK = data;
+    m_internalDataIJK = data.get();
+    m_retrieved = true;
+}
+
+void CauldronIO::VolumeData::freeData(float** internalData)
+{
+    std::shared_ptr<float>& sharedData = (internalData == &m_internalDataIJK ? m_sharedDataIJK : m_sharedDataKIJ);
+
+    if (!sharedData && *internalData) delete[] *internalData;
+    sharedData.reset();
+    *internalData = nullptr;
+}
+
 
 void CauldronIO::VolumeData::updateGeometry()
 {
@@ -2452,6 +2548,10 @@ void CauldronIO::VolumeData::updateMinMax()
 
 void CauldronIO::VolumeData::setData(float* data, float** internalData, bool setValue /*= false*/, float value /*= 0*/)
 {
+    // A shared buffer is not ours to overwrite; keep it alive while copying, data may point into it
+    std::shared_ptr<float> sharedData = (internalData == &m_internalDataIJK ? m_sharedDataIJK : m_sharedDataKIJ);
+    if (sharedData) freeData(internalData);
+
     // If our data buffer exists, we will just reuse it. Otherwise, allocate
     if (!*internalData)
     {
@@ -2545,12 +2645,31 @@ bool CauldronIO::VolumeData::isRetrieved() const
     return m_retrieved;
 }
 
+void CauldronIO::VolumeData::retrieveRegion(const VolumeRegion &region, const ArrayView<float> &buffer) const
+{
+    checkRegion(region, buffer);
+
+    float* dest = buffer.data;
+    for (size_t k = region.firstK; k < region.firstK + region.numK; ++k)
+        for (size_t j = region.firstJ; j < region.firstJ + region.numJ; ++j)
+            for (size_t i = region.firstI; i < region.firstI + region.numI; ++i)
+                *dest++ = getValue(i, j, k);
+}
+
+void CauldronIO::VolumeData::checkRegion(const VolumeRegion &region, const ArrayView<float> &buffer) const
+{
+    if (region.firstI + region.numI > m_numI || region.firstJ + region.numJ > m_numJ ||
+        region.firstK < m_firstK || region.firstK + region.numK > m_firstK + m_numK)
+        throw CauldronIOException("Region is outside of the volume geometry");
+
+    if (buffer.size < region.numI * region.numJ * region.numK)
+        throw CauldronIOException("Buffer is too small for the requested region");
+}
+
 void CauldronIO::VolumeData::release()
 {
-    if (m_internalDataIJK) delete[] m_internalDataIJK;
-    if (m_internalDataKIJ) delete[] m_internalDataKIJ;
-    m_internalDataIJK = nullptr;
-    m_internalDataKIJ = nullptr;
+    freeData(&m_internalDataIJK);
+    freeData(&m_internalDataKIJ);
     m_retrieved = false;
 }
 
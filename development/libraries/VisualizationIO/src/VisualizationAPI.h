@@ -254,6 +254,16 @@ namespace CauldronIO
         std::shared_ptr<Formation> m_formation;
     };
 
+    /// \class SnapShotContents
+    /// \brief Source of the contents of a snapshot, loaded on first access
+    class SnapShotContents
+    {
+    public:
+        virtual ~SnapShotContents() { ; }
+        /// \brief Adds all surfaces, volumes and trappers to the snapshot; throws a CauldronIOException on failure
+        virtual void load(SnapShot& snapShot) = 0;
+    };
+
     /// \class SnapShot 
     /// \brief container class holding all surfaces and volumes for a snapshot
     class SnapShot
@@ -271,6 +281,12 @@ namespace CauldronIO
         void retrieve();
         /// \brief Release all data in the snapshot
         void release();
+        /// \brief Defers loading of the contents until they are first accessed
+        /// \details The const getters (getSurfaceList, getVolume, ...) then load the contents, so they change the snapshot:
+        /// until the snapshot is loaded, they must not be called from several threads at once
+        void setContents(const std::shared_ptr<SnapShotContents>& contents);
+        /// \returns True if the contents have been loaded (or were not deferred)
+        bool isLoaded() const;
 
         /// \brief Add a surface to the snapshot; ownership is transfered
         void addSurface(std::shared_ptr<Surface>& surface);
@@ -316,10 +332,14 @@ namespace CauldronIO
                                    const std::string& reservoirName, const std::string& surfaceName, 
                                    const std::string& formationName ) const;
     private:
+        /// \brief Loads deferred contents, if any
+        void loadContents() const;
+
         SurfaceList m_surfaceList;
         std::shared_ptr<Volume> m_volume;
         FormationVolumeList m_formationVolumeList;
         TrapperList m_trapperList;
+        mutable std::shared_ptr<SnapShotContents> m_contents;
         SnapShotKind m_kind;
         bool m_isMinor;
         double m_age;
@@ -735,6 +755,14 @@ namespace CauldronIO
       size_t size;
     };
 
+    /// \class VolumeRegion
+    /// \brief A sub-box of a volume in grid indices; k is in the full-k range, corresponding to the depth volume
+    struct VolumeRegion
+    {
+      size_t firstI, firstJ, firstK;
+      size_t numI, numJ, numK;
+    };
+
     /// \class VisualizationIOData
     /// \brief interface class for surface and volume data
     class VisualizationIOData
@@ -792,6 +820,9 @@ namespace CauldronIO
         /// \param [in] data pointer to the xy data, ordered row-wise
         /// \note data is copied so data ownership is not transferred; data should be deleted by client if obsolete
         void setData_IJ(float* data);
+        /// \brief Assign data to the map without copying : geometry must have been assigned
+        /// \param [in] data the xy data, ordered row-wise; it is shared (e.g. with a file mapping) until the map is released
+        void setSharedData_IJ(const std::shared_ptr<float>& data);
         /// \returns  true if data is represented per row
         bool canGetRow() const;
         /// \returns true if data is represented per column
@@ -852,8 +883,10 @@ namespace CauldronIO
 
         void updateMinMax();
         void setData(float* data, bool setValue = false, float value = 0);
+        void freeData();
 
         float* m_internalData;
+        std::shared_ptr<float> m_sharedData; // owner of m_internalData if it is shared
         float m_constantValue;
         bool m_isConstant;
         bool m_updateMinMax;
@@ -931,6 +964,12 @@ namespace CauldronIO
         /// \param [in] setValue if true, a constant value will be assigned to the data
         /// \param [in] value the value to assign to the data if setValue is true
         void setData_IJK(float* data, bool setValue = false, float value = 0);
+        /// \brief Assign data to the volume without copying, as a 1D array: K fastest, then I, then J
+        /// \param [in] data the data; it is shared (e.g. with a file mapping) until the volume is released
+        void setSharedData_KIJ(const std::shared_ptr<float>& data);
+        /// \brief Assign data to the volume without copying, as a 1D array: I fastest, then J, then K
+        /// \param [in] data the data; it is shared (e.g. with a file mapping) until the volume is released
+        void setSharedData_IJK(const std::shared_ptr<float>& data);
         /// \returns true if IJK data is present (false if not present or constant data)
         bool hasDataIJK() const;
         /// \returns true if KIJ data is present (false if not present or constant data)
@@ -1014,6 +1053,11 @@ namespace CauldronIO
         virtual void retrieve() = 0;
         /// \brief Retrieve the data directly into the provided buffer. This method is provided to eliminate unnecessary data copies
         virtual void retrieve(const ArrayView<float> &buffer) const = 0;
+        /// \brief Retrieve the data of a sub-box into the provided buffer (I fastest, then J, then K), without retrieving the whole volume
+        /// \details The default implementation copies from retrieved data; the native implementation only reads the tiles the region intersects
+        /// \param [in] region the sub-box to retrieve; it must lie within the geometry
+        /// \param [in] buffer receives region.numI * region.numJ * region.numK values
+        virtual void retrieveRegion(const VolumeRegion &region, const ArrayView<float> &buffer) const;
         /// \brief Release memory; does not destroy the object; it can be retrieved again
         virtual void release();
         /// \returns true if data is available
@@ -1027,9 +1071,12 @@ namespace CauldronIO
         
         void updateMinMax() ;
         void setData(float* data, float** internalData, bool setValue = false, float value = 0);
+        void freeData(float** internalData);
         
         float* m_internalDataIJK;
         float* m_internalDataKIJ;
+        std::shared_ptr<float> m_sharedDataIJK; // owner of m_internalDataIJK if it is shared
+        std::shared_ptr<float> m_sharedDataKIJ; // owner of m_internalDataKIJ if it is shared
         float m_minValue, m_maxValue;
 	float m_sedimentMinValue;
 	float m_sedimentMaxValue;
@@ -1042,6 +1089,8 @@ namespace CauldronIO
 
     protected:
         void updateGeometry();
+        /// \brief Throws if the region does not lie within the geometry, or does not fit in the buffer
+        void checkRegion(const VolumeRegion &region, const ArrayView<float> &buffer) const;
         std::shared_ptr<Geometry3D> m_geometry;
         bool m_retrieved;
         size_t m_numI, m_numJ, m_firstK, m_lastK, m_numK;
@@ -13,7 +13,11 @@
 
 #define xml_version_major 0
                              // version 1: initial version
-#define xml_version_minor 2  // version 2: changed geometry storage
+                             // version 2: changed geometry storage
+                             // version 3: optional pre-filter attribute on datastores (written data uses delta,shuffle)
+                             // version 4: optional tiled storage of volumes (64x64x16 tiles, tileI/J/K attributes and tilesizes node)
+#define xml_version_minor 5  // version 5: optional error-bounded lossy storage (quantization and errorbound attributes)
+#define xml_version_minor_oldest 2 // oldest version still read: later versions only add optional datastore attributes
 
 #include <vector>
 #include <memory>
@@ -65,6 +69,7 @@ namespace CauldronIO
     enum FormationMapType {FIRSTMAP = 0, THICKNESS = 0, SRMIXINGHI = 1, LITHOTYPE1 = 2,  LITHOTYPE2 = 3, LITHOTYPE3 = 4, LASTMAP = 5}; 
 
     class SnapShot;
+    class SnapShotContents;
     class Project;
     class Surface;
     class SurfaceData;
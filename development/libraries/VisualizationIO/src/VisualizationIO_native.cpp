@@ -11,12 +11,6 @@
 #include "VisualizationIO_native.h"
 #include "DataStore.h"
 
-#include "lz4.h"
-
-#include <boost/iostreams/filtering_streambuf.hpp>
-#include <boost/iostreams/filter/gzip.hpp>
-#include <boost/iostreams/copy.hpp>
-
 #include <memory>
 
 using namespace CauldronIO;
@@ -31,54 +25,9 @@ namespace
   /// implementations.
   void retrieve(const DataStoreParams &params, const ArrayView<float> &buffer)
   {
-    // open the file and seek to the specified position
-    std::ifstream file;
-    file.open(params.fileName.string(), std::ios::binary);
-    if (!file)
-      throw CauldronIOException(std::string("Could not open file " + params.fileName.string()));
-    file.seekg(params.offset);
-
-    size_t uncompressedSize = buffer.size * sizeof(float);
-
-    if (params.compressed)
-    {
-      // allocate a buffer to load the compressed data into
-      std::unique_ptr<char[]> compressedData(new char[params.size]);
-
-      // setup source and destination pointers
-      char *src = compressedData.get();
-      char *dst = reinterpret_cast<char*>(buffer.data);
-
-      // read compressed data from file
-      file.read(src, params.size);
-      if ((size_t)file.gcount() != params.size)
-        throw CauldronIOException("Unable to read requested number of bytes");
-
-      // decompress into buffer
-      if (params.compressed_lz4)
-      {
-        size_t decompressedSize = (size_t)LZ4_decompress_safe(src, dst, (int)params.size, (int)uncompressedSize);
-        if (decompressedSize != uncompressedSize)
-          throw CauldronIOException(std::string("Error during lz4 decompression"));
-      }
-      else // using gzip compression
-      {
-        boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
-        in.push(boost::iostreams::gzip_decompressor());
-        in.push(boost::iostreams::array_source(src, params.size));
-        boost::iostreams::copy(in, boost::iostreams::array_sink(dst, uncompressedSize));
-      }
-    }
-    else // uncompressed data
-    {
-      // load the file contents directly into the buffer
-      if (uncompressedSize != params.size)
-        throw CauldronIOException("Buffer size mismatch");
-
-      file.read(reinterpret_cast<char*>(buffer.data), uncompressedSize);
-      if ((size_t)file.gcount() != uncompressedSize)
-        throw CauldronIOException("Unable to read requested number of bytes");
-    }
+    // map the block and decompress (or copy) it straight into the buffer
+    DataStoreLoad dataStore(&params);
+    dataStore.getData(reinterpret_cast<char*>(buffer.data), buffer.size * sizeof(float));
   }
 }
 
@@ -114,14 +63,22 @@ void CauldronIO::MapNative::retrieve()
 
     prefetch();
 
-    size_t size = sizeof(float)*m_numI*m_numJ;
-    float* data = m_dataStore->getData(size);
+    if (m_dataStore->isCompressed())
+    {
+        size_t size = sizeof(float)*m_numI*m_numJ;
+        float* data = m_dataStore->getData(size);
+        setData_IJ(data);
+        delete[] data;
+    }
+    else
+    {
+        // Use the file mapping in place; it is released with the data
+        setSharedData_IJ(m_dataStore->shareMappedData());
+    }
 
+    // Release the datastore; a shared mapping is released with the data
     delete m_dataStore;
     m_dataStore = nullptr;
-
-    setData_IJ(data);
-    delete[] data;
 }
 
 void CauldronIO::MapNative::retrieve(const ArrayView<float> &buffer) const
@@ -210,6 +167,40 @@ void CauldronIO::VolumeDataNative::retrieve(const ArrayView<float> &buffer) cons
   }
 }
 
+void CauldronIO::VolumeDataNative::retrieveRegion(const VolumeRegion &region, const ArrayView<float> &buffer) const
+{
+  // Use the data in memory if we have it
+  if (isConstant() || isRetrieved())
+  {
+    VolumeData::retrieveRegion(region, buffer);
+    return;
+  }
+
+  checkRegion(region, buffer);
+
+  if (m_dataIJK && m_paramsIJK->tileI > 0)
+  {
+    // Only the tiles intersecting the region are decompressed; the stored volume starts at the first k of the geometry
+    VolumeRegion storedRegion = region;
+    storedRegion.firstK -= m_firstK;
+
+    DataStoreLoad dataStore(m_paramsIJK);
+    dataStore.getRegion(storedRegion, buffer.data);
+    return;
+  }
+
+  // Not tiled: load the full volume and copy the region from it
+  std::vector<float> data(m_numI * m_numJ * m_numK);
+  DataStoreLoad dataStore(m_dataIJK ? m_paramsIJK : m_paramsKIJ);
+  dataStore.getData(reinterpret_cast<char*>(data.data()), data.size() * sizeof(float));
+
+  float* dest = buffer.data;
+  for (size_t k = region.firstK; k < region.firstK + region.numK; ++k)
+    for (size_t j = region.firstJ; j < region.firstJ + region.numJ; ++j)
+      for (size_t i = region.firstI; i < region.firstI + region.numI; ++i)
+        *dest++ = data[m_dataIJK ? computeIndex_IJK(i, j, k) : computeIndex_KIJ(i, j, k)];
+}
+
 void CauldronIO::VolumeDataNative::retrieve()
 {
     if (isConstant()) return;
@@ -218,32 +209,46 @@ void CauldronIO::VolumeDataNative::retrieve()
     {
         prefetch();
 
-        size_t size = sizeof(float)*m_numI*m_numJ*m_numK;
-        float* data = m_dataStoreIJK->getData(size);
-        
-        // Close filehandles etc.
+        // Geometry should already have been set
+        if (m_dataStoreIJK->isCompressed())
+        {
+            size_t size = sizeof(float)*m_numI*m_numJ*m_numK;
+            float* data = m_dataStoreIJK->getData(size);
+            setData_IJK(data);
+            delete[] data;
+        }
+        else
+        {
+            // Use the file mapping in place; it is released with the data
+            setSharedData_IJK(m_dataStoreIJK->shareMappedData());
+        }
+
+        // Release the datastore; a shared mapping is released with the data
         delete m_dataStoreIJK;
         m_dataStoreIJK = nullptr;
-
-        // Geometry should already have been set
-        setData_IJK(data);
-        delete[] data;
     }
 
     if (m_dataKIJ)
     {
         prefetch();
 
-        size_t size = sizeof(float)*m_numI*m_numJ*m_numK;
-        float* data = m_dataStoreKIJ->getData(size);
-
-        // Close filehandles etc.
+        // Geometry should already have been set
+        if (m_dataStoreKIJ->isCompressed())
+        {
+            size_t size = sizeof(float)*m_numI*m_numJ*m_numK;
+            float* data = m_dataStoreKIJ->getData(size);
+            setData_KIJ(data);
+            delete[] data;
+        }
+        else
+        {
+            // Use the file mapping in place; it is released with the data
+            setSharedData_KIJ(m_dataStoreKIJ->shareMappedData());
+        }
+
+        // Release the datastore; a shared mapping is released with the data
         delete m_dataStoreKIJ;
         m_dataStoreKIJ = nullptr;
-
-        // Geometry should already have been set
-        setData_KIJ(data);
-        delete[] data;
     }
 }
 
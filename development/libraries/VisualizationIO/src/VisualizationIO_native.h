@@ -62,6 +62,8 @@ namespace CauldronIO
         virtual void retrieve();
         /// \brief Retrieve the data directly into the provided buffer
         virtual void retrieve(const ArrayView<float> &buffer) const override;
+        /// \brief Retrieve a sub-box; for tiled data only the tiles intersecting the region are read
+        virtual void retrieveRegion(const VolumeRegion &region, const ArrayView<float> &buffer) const override;
         /// \returns a list of HDFinfo holding the data; can be null
         virtual const std::vector < std::shared_ptr<HDFinfo> >& getHDFinfo() { return m_info; }
         /// \brief Set all variables needed to retrieve the data
@@ -0,0 +1,264 @@
+//
+// Copyright (C) 2012-2015 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#include "XmlIndex.h"
+#include "VisualizationAPI.h"
+#include "Hash.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/thread/lock_guard.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace CauldronIO;
+
+namespace
+{
+    const char IndexMagic[8] = { 'C', 'L', 'D', 'R', 'N', 'I', 'D', 'X' };
+    const uint32_t IndexVersion = 1;
+    // Written as is; reads back differently on a machine with other byte order
+    const uint32_t ByteOrderMark = 0x01020304;
+
+    /// \brief Fixed layout of the index file header
+    struct IndexHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t xmlSize;
+        uint64_t xmlHash;         // hash of the xml outside the snapshot range
+        uint64_t snapShotsBegin;  // byte range of all snapshot elements
+        uint64_t snapShotsEnd;
+        uint64_t numSnapShots;
+    };
+
+    /// \brief Fixed layout of a snapshot in the index file
+    struct IndexEntry
+    {
+        double age;
+        int32_t kind;
+        int32_t isMinor;
+        uint64_t begin;
+        uint64_t end;
+        uint64_t hash;
+    };
+
+    /// \brief Writes a piece of xml to file, keeping track of the hash
+    void write(std::ofstream& file, const std::string& text, uint64_t& hash)
+    {
+        file.write(text.data(), text.size());
+        hash = XmlIndex::hash(text.data(), text.size(), hash);
+    }
+
+    /// \brief Prints a node to a string, as pugixml would do when saving the complete document
+    std::string print(pugi::xml_node node, unsigned int depth)
+    {
+        std::ostringstream text;
+        node.print(text, "\t", pugi::format_default, pugi::encoding_auto, depth);
+        return text.str();
+    }
+}
+
+CauldronIO::XmlIndex::File::File(const std::string& xmlFileName)
+    : m_fileName(xmlFileName), m_file(xmlFileName.c_str(), std::ios::binary), m_size(0)
+{
+    if (!m_file)
+        throw CauldronIOException("Cannot open file " + xmlFileName);
+
+    m_file.seekg(0, std::ios::end);
+    m_size = (size_t)m_file.tellg();
+}
+
+const std::string& CauldronIO::XmlIndex::File::getFileName() const
+{
+    return m_fileName;
+}
+
+size_t CauldronIO::XmlIndex::File::getSize() const
+{
+    return m_size;
+}
+
+bool CauldronIO::XmlIndex::File::read(size_t begin, size_t end, std::string& text)
+{
+    if (begin > end || end > m_size)
+        return false;
+
+    const size_t previousSize = text.size();
+    text.resize(previousSize + end - begin);
+    if (end == begin) return true;
+
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_file.clear();
+    m_file.seekg((std::streamoff)begin);
+    m_file.read(&text[previousSize], (std::streamsize)(end - begin));
+    return (bool)m_file;
+}
+
+std::string CauldronIO::XmlIndex::getIndexFileName(const std::string& xmlFileName)
+{
+    return xmlFileName + ".idx";
+}
+
+uint64_t CauldronIO::XmlIndex::hash(const char* data, size_t size, uint64_t previous)
+{
+    return Utilities::hash(data, size, previous);
+}
+
+bool CauldronIO::XmlIndex::save(const pugi::xml_document& doc, const std::string& xmlFileName, const std::string& indexFileName)
+{
+    // Only a plain project document is written in pieces
+    pugi::xml_node project = doc.child("project");
+    if (!project || project.first_attribute() || project.next_sibling())
+    {
+        boost::filesystem::remove(indexFileName);
+        return doc.save_file(xmlFileName.c_str());
+    }
+
+    std::ofstream file(xmlFileName.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+
+    // Same layout as pugi::xml_document::save, but the position of every snapshot is recorded
+    IndexHeader header;
+    std::memcpy(header.magic, IndexMagic, sizeof(IndexMagic));
+    header.version = IndexVersion;
+    header.byteOrder = ByteOrderMark;
+    header.snapShotsBegin = header.snapShotsEnd = 0;
+
+    uint64_t xmlHash = hash(nullptr, 0);
+    std::vector<IndexEntry> entries;
+
+    write(file, "<?xml version=\"1.0\"?>\n<project>\n", xmlHash);
+    for (pugi::xml_node child = project.first_child(); child; child = child.next_sibling())
+    {
+        if (std::string(child.name()) != "snapshots" || !child.child("snapshot"))
+        {
+            write(file, print(child, 1), xmlHash);
+            continue;
+        }
+
+        write(file, "\t<snapshots>\n", xmlHash);
+        header.snapShotsBegin = (uint64_t)file.tellp();
+        for (pugi::xml_node snapShot = child.first_child(); snapShot; snapShot = snapShot.next_sibling())
+        {
+            std::string text = print(snapShot, 2);
+            IndexEntry entry;
+            entry.age = snapShot.attribute("age").as_double();
+            entry.kind = snapShot.attribute("kind").as_int();
+            entry.isMinor = snapShot.attribute("isminor").as_bool() ? 1 : 0;
+            entry.begin = (uint64_t)file.tellp();
+            entry.end = entry.begin + text.size();
+            entry.hash = hash(text.data(), text.size());
+
+            // Other elements than snapshots cannot be left out when opening the project
+            if (std::string(snapShot.name()) != "snapshot")
+            {
+                boost::filesystem::remove(indexFileName);
+                file.close();
+                return doc.save_file(xmlFileName.c_str());
+            }
+
+            file.write(text.data(), text.size());
+            entries.push_back(entry);
+        }
+        header.snapShotsEnd = (uint64_t)file.tellp();
+        write(file, "\t</snapshots>\n", xmlHash);
+    }
+    write(file, "</project>\n", xmlHash);
+
+    header.xmlSize = (uint64_t)file.tellp();
+    header.xmlHash = xmlHash;
+    header.numSnapShots = entries.size();
+
+    file.close();
+    if (!file) return false;
+
+    // The xml is fine without its index: if the index cannot be written, just make sure there is no stale one
+    std::ofstream index(indexFileName.c_str(), std::ios::binary | std::ios::trunc);
+    if (index)
+    {
+        index.write((const char*)&header, sizeof(header));
+        if (!entries.empty())
+            index.write((const char*)entries.data(), entries.size() * sizeof(IndexEntry));
+        index.close();
+    }
+    if (!index)
+        boost::filesystem::remove(indexFileName);
+
+    return true;
+}
+
+bool CauldronIO::XmlIndex::load(File& xmlFile, std::vector<SnapShotEntry>& snapShots, std::string& xmlWithoutSnapShots)
+{
+    const std::string indexFileName = getIndexFileName(xmlFile.getFileName());
+    boost::system::error_code error;
+    if (!boost::filesystem::exists(indexFileName, error))
+        return false;
+
+    IndexHeader header;
+    std::vector<IndexEntry> entries;
+    try
+    {
+        boost::iostreams::mapped_file_source index(indexFileName);
+        if (index.size() < sizeof(header))
+            return false;
+
+        std::memcpy(&header, index.data(), sizeof(header));
+        if (std::memcmp(header.magic, IndexMagic, sizeof(IndexMagic)) != 0 || header.version != IndexVersion || header.byteOrder != ByteOrderMark)
+            return false;
+        if (index.size() != sizeof(header) + header.numSnapShots * sizeof(IndexEntry))
+            return false;
+
+        entries.resize((size_t)header.numSnapShots);
+        if (!entries.empty())
+            std::memcpy(entries.data(), index.data() + sizeof(header), entries.size() * sizeof(IndexEntry));
+    }
+    catch (std::exception&)
+    {
+        return false;
+    }
+
+    // The index is stale if the xml has been written since
+    if (xmlFile.getSize() != header.xmlSize || header.snapShotsBegin > header.snapShotsEnd || header.snapShotsEnd > header.xmlSize)
+        return false;
+
+    std::string xml;
+    xml.reserve((size_t)(header.xmlSize - (header.snapShotsEnd - header.snapShotsBegin)));
+    if (!xmlFile.read(0, (size_t)header.snapShotsBegin, xml) || !xmlFile.read((size_t)header.snapShotsEnd, (size_t)header.xmlSize, xml))
+        return false;
+    if (hash(xml.data(), xml.size()) != header.xmlHash)
+        return false;
+
+    snapShots.clear();
+    snapShots.reserve(entries.size());
+    for (const IndexEntry& entry : entries)
+    {
+        if (entry.begin < header.snapShotsBegin || entry.end > header.snapShotsEnd || entry.begin >= entry.end)
+            return false;
+
+        SnapShotEntry snapShot = { entry.age, entry.kind, entry.isMinor != 0, (size_t)entry.begin, (size_t)entry.end, entry.hash };
+        snapShots.push_back(snapShot);
+    }
+
+    xmlWithoutSnapShots.swap(xml);
+    return true;
+}
+
+std::string CauldronIO::XmlIndex::readSnapShot(File& xmlFile, const SnapShotEntry& snapShot)
+{
+    std::string text;
+    if (!xmlFile.read(snapShot.begin, snapShot.end, text) || hash(text.data(), text.size()) != snapShot.hash)
+        throw CauldronIOException("Snapshot cannot be read: " + xmlFile.getFileName() + " does not match its index");
+
+    return text;
+}
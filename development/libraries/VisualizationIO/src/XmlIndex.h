@@ -0,0 +1,86 @@
+//
+// Copyright (C) 2012-2015 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#ifndef __XmlIndex_h__
+#define __XmlIndex_h__
+
+#include "pugixml.hpp"
+#include <boost/thread/mutex.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace CauldronIO
+{
+    /// \class XmlIndex
+    /// \brief Binary index of the snapshots in a project xml file, stored next to it.
+    /// \details The index holds the byte range of every snapshot element in the xml, so a project can be opened by parsing only
+    /// the xml outside the snapshots, and each snapshot can be parsed when it is first accessed. The index is only used if it
+    /// matches the xml file; otherwise the xml is parsed as a whole.
+    class XmlIndex
+    {
+    public:
+        /// \brief Location and summary of a snapshot element in the xml file
+        struct SnapShotEntry
+        {
+            double age;
+            int kind;
+            bool isMinor;
+            size_t begin, end; // byte range of the snapshot element
+            uint64_t hash;     // hash of that byte range
+        };
+
+        /// \brief The xml file, kept open from the time its index is loaded
+        /// \details Snapshots are read from the file that was indexed, also when the xml has been replaced since (as ExportToXML
+        /// does by renaming a new file over it). Reads from several threads are serialised.
+        class File
+        {
+        public:
+            /// \brief Opens the xml file; throws a CauldronIOException if it cannot be opened
+            explicit File(const std::string& xmlFileName);
+
+            /// \returns the name the file was opened with
+            const std::string& getFileName() const;
+            /// \returns the size of the file when it was opened
+            size_t getSize() const;
+            /// \brief Appends a byte range of the file to text; returns false if it cannot be read
+            bool read(size_t begin, size_t end, std::string& text);
+
+        private:
+            std::string m_fileName;
+            std::ifstream m_file;
+            size_t m_size;
+            boost::mutex m_mutex;
+        };
+
+        /// \returns the file name of the index belonging to an xml file
+        static std::string getIndexFileName(const std::string& xmlFileName);
+
+        /// \brief Saves the document to xmlFileName and its index to indexFileName
+        /// \returns false if the xml cannot be written; the index is not written in that case
+        static bool save(const pugi::xml_document& doc, const std::string& xmlFileName, const std::string& indexFileName);
+
+        /// \brief Loads the index of an xml file
+        /// \param [in] xmlFile the opened xml file
+        /// \param [out] snapShots the snapshots, in order of the xml file
+        /// \param [out] xmlWithoutSnapShots the xml file with the snapshot elements left out
+        /// \returns false if there is no index, or the index does not match the xml file
+        static bool load(File& xmlFile, std::vector<SnapShotEntry>& snapShots, std::string& xmlWithoutSnapShots);
+
+        /// \brief Reads the snapshot element from the xml file; throws a CauldronIOException if it does not match the index
+        static std::string readSnapShot(File& xmlFile, const SnapShotEntry& snapShot);
+
+        /// \returns the 64-bit FNV-1a hash of the data, continuing from a previous hash
+        static uint64_t hash(const char* data, size_t size, uint64_t previous = 14695981039346656037ULL);
+    };
+}
+
+#endif
@@ -0,0 +1,382 @@
+//
+// Copyright (C) 2012-2015 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#include "DataPipeline.h"
+#include "VisualizationUtils.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace CauldronIO;
+
+CauldronIO::DataPipeline::DataPipeline(const std::vector<VisualizationIOData*>& data, size_t numThreads, size_t maxMemory)
+{
+    m_maxMemory = maxMemory;
+    m_memory = m_peakMemory = 0;
+    m_numRequired = 0;
+    m_numEvents = 0;
+    m_stop = false;
+
+    // Data can be part of the snapshot more than once; it is read once and released after it has been written the last time
+    for (VisualizationIOData* object : data)
+    {
+        std::map<const VisualizationIOData*, size_t>::iterator index = m_index.find(object);
+        if (index != m_index.end())
+        {
+            m_items[index->second].numUses++;
+            continue;
+        }
+
+        Item item;
+        item.data = object;
+        item.numBytes = getNumBytes(object);
+        item.numUses = 1;
+        item.retrieved = false;
+
+        m_index[object] = m_items.size();
+        m_items.push_back(item);
+    }
+
+    m_threads.add_thread(new boost::thread(&DataPipeline::read, this));
+    for (size_t i = 0; i < std::max((size_t)1, numThreads); ++i)
+        m_threads.add_thread(new boost::thread(&DataPipeline::work, this));
+}
+
+CauldronIO::DataPipeline::~DataPipeline()
+{
+    stop();
+}
+
+void CauldronIO::DataPipeline::waitFor(const VisualizationIOData* data)
+{
+    std::map<const VisualizationIOData*, size_t>::const_iterator found = m_index.find(data);
+    if (found == m_index.end()) return;
+    const size_t index = found->second;
+
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+
+    // Make sure the reader does not hold back on this data because of the memory limit
+    if (index >= m_numRequired)
+    {
+        m_numRequired = index + 1;
+        m_progress.notify_all();
+    }
+
+    while (!m_items[index].retrieved)
+    {
+        checkError();
+
+        const size_t numEvents = m_numEvents;
+        lock.unlock();
+        writeProcessed();
+        lock.lock();
+
+        if (!m_items[index].retrieved && numEvents == m_numEvents)
+            m_progress.wait(lock);
+    }
+}
+
+void CauldronIO::DataPipeline::write(VisualizationIOData* data, DataStoreSave& dataStore, size_t firstBlock)
+{
+    if (std::find(m_dataStores.begin(), m_dataStores.end(), &dataStore) == m_dataStores.end())
+        m_dataStores.push_back(&dataStore);
+
+    // The blocks not written yet are the last ones added to the datastore; nothing is written in between
+    std::vector<std::shared_ptr<DataToCompress> > blocks = dataStore.getDataToCompressList();
+    const size_t numBlocks = dataStore.getNumBlocks();
+    assert(firstBlock + blocks.size() >= numBlocks);
+
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        for (size_t i = blocks.size() - (numBlocks - firstBlock); i < blocks.size(); ++i)
+        {
+            Block block;
+            block.data = blocks[i];
+            block.dataStore = &dataStore;
+            block.number = numBlocks - blocks.size() + i;
+            block.numBytes = 0;
+            m_toCompress.push_back(block);
+        }
+        m_progress.notify_all();
+    }
+
+    std::map<const VisualizationIOData*, size_t>::const_iterator found = m_index.find(data);
+    if (found != m_index.end())
+    {
+        Item& item = m_items[found->second];
+        item.blocks.push_back(std::pair<DataStoreSave*, size_t>(&dataStore, numBlocks));
+        if (--item.numUses == 0)
+            m_toRelease.push_back(found->second);
+    }
+
+    writeProcessed();
+}
+
+void CauldronIO::DataPipeline::finish()
+{
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+    for (;;)
+    {
+        checkError();
+
+        const size_t numEvents = m_numEvents;
+        lock.unlock();
+        bool allWritten = writeProcessed();
+        lock.lock();
+
+        if (allWritten) break;
+        if (numEvents == m_numEvents)
+            m_progress.wait(lock);
+    }
+    lock.unlock();
+
+    for (DataStoreSave* dataStore : m_dataStores)
+        dataStore->flush();
+
+    stop();
+}
+
+size_t CauldronIO::DataPipeline::getPeakMemory() const
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    return m_peakMemory;
+}
+
+void CauldronIO::DataPipeline::read()
+{
+    std::vector<std::string> fileNames;
+    try
+    {
+        for (const Item& item : m_items)
+            fileNames.push_back(getHDFfile(item.data));
+    }
+    catch (std::exception& e)
+    {
+        setError(e.what());
+        return;
+    }
+
+    size_t i = 0;
+    while (i < m_items.size())
+    {
+        // The first item is read as soon as it fits in memory; the items after it are read along with it if these fit as well,
+        // and are stored in the same HDF file, so the file is opened once for all of them
+        std::vector<VisualizationIOData*> batch;
+        {
+            boost::unique_lock<boost::mutex> lock(m_mutex);
+            while (!m_stop && i >= m_numRequired && m_maxMemory > 0 && m_memory > 0 && m_memory + m_items[i].numBytes > m_maxMemory)
+                m_progress.wait(lock);
+            if (m_stop) return;
+
+            batch.push_back(m_items[i].data);
+            m_memory += m_items[i].numBytes;
+
+            while (!fileNames[i].empty() && i + batch.size() < m_items.size())
+            {
+                const Item& next = m_items[i + batch.size()];
+                if (fileNames[i + batch.size()] != fileNames[i]) break;
+                if (i + batch.size() >= m_numRequired && m_maxMemory > 0 && m_memory + next.numBytes > m_maxMemory) break;
+
+                batch.push_back(next.data);
+                m_memory += next.numBytes;
+            }
+            m_peakMemory = std::max(m_peakMemory, m_memory);
+        }
+
+        try
+        {
+            // HDF data is only read on this thread; data without it is retrieved here as well, as it may read HDF data itself
+            const bool hdfData = !batch[0]->getHDFinfo().empty();
+            if (hdfData)
+                VisualizationUtils::readHDFdata(batch);
+            else
+                batch[0]->retrieve();
+
+            boost::lock_guard<boost::mutex> lock(m_mutex);
+            for (size_t j = 0; j < batch.size(); ++j, ++i)
+            {
+                if (hdfData)
+                    m_toRetrieve.push_back(i);
+                else
+                    m_items[i].retrieved = true;
+            }
+            m_numEvents++;
+            m_progress.notify_all();
+        }
+        catch (std::exception& e)
+        {
+            setError(e.what());
+            return;
+        }
+    }
+}
+
+void CauldronIO::DataPipeline::work()
+{
+    for (;;)
+    {
+        Block block;
+        size_t index = 0;
+        {
+            boost::unique_lock<boost::mutex> lock(m_mutex);
+            while (!m_stop && m_toCompress.empty() && m_toRetrieve.empty())
+                m_progress.wait(lock);
+            if (m_stop) return;
+
+            // Compressed blocks can be written and released, so these go first
+            if (!m_toCompress.empty())
+            {
+                block = m_toCompress.front();
+                m_toCompress.pop_front();
+            }
+            else
+            {
+                index = m_toRetrieve.front();
+                m_toRetrieve.pop_front();
+            }
+        }
+
+        try
+        {
+            if (block.data)
+            {
+                block.data->compress();
+                block.numBytes = block.data->getBufferSizeInBytes();
+            }
+            else
+                m_items[index].data->retrieve();
+        }
+        catch (std::exception& e)
+        {
+            setError(e.what());
+            return;
+        }
+
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        if (!block.data)
+            m_items[index].retrieved = true;
+        else if (block.numBytes > 0)
+        {
+            m_compressed.push_back(block);
+            m_memory += block.numBytes;
+            m_peakMemory = std::max(m_peakMemory, m_memory);
+        }
+        m_numEvents++;
+        m_progress.notify_all();
+    }
+}
+
+bool CauldronIO::DataPipeline::writeProcessed()
+{
+    // Only the writing thread gets here, so the datastores and data to release are not shared
+    bool allWritten = true;
+    std::map<const DataStoreSave*, size_t> numWritten;
+    for (DataStoreSave* dataStore : m_dataStores)
+    {
+        numWritten[dataStore] = dataStore->flushProcessed();
+        allWritten &= numWritten[dataStore] == dataStore->getNumBlocks();
+    }
+
+    // Compressed blocks are released once written
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        std::vector<Block> compressed;
+        for (const Block& block : m_compressed)
+        {
+            if (numWritten[block.dataStore] > block.number)
+                m_memory -= block.numBytes;
+            else
+                compressed.push_back(block);
+        }
+        if (compressed.size() < m_compressed.size())
+        {
+            m_compressed.swap(compressed);
+            m_numEvents++;
+            m_progress.notify_all();
+        }
+    }
+
+    std::deque<size_t> toRelease;
+    for (size_t index : m_toRelease)
+    {
+        Item& item = m_items[index];
+
+        bool written = true;
+        for (const std::pair<DataStoreSave*, size_t>& blocks : item.blocks)
+            written &= numWritten[blocks.first] >= blocks.second;
+
+        if (!written)
+        {
+            toRelease.push_back(index);
+            continue;
+        }
+
+        item.data->release();
+
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        m_memory -= item.numBytes;
+        m_numEvents++;
+        m_progress.notify_all();
+    }
+    m_toRelease.swap(toRelease);
+
+    return allWritten && m_toRelease.empty();
+}
+
+void CauldronIO::DataPipeline::stop()
+{
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        m_stop = true;
+        m_progress.notify_all();
+    }
+    m_threads.join_all();
+}
+
+void CauldronIO::DataPipeline::setError(const std::string& message)
+{
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    if (m_error.empty())
+        m_error = message.empty() ? "Error while retrieving data" : message;
+    m_stop = true;
+    m_numEvents++;
+    m_progress.notify_all();
+}
+
+void CauldronIO::DataPipeline::checkError() const
+{
+    if (!m_error.empty())
+        throw CauldronIOException(m_error);
+}
+
+std::string CauldronIO::DataPipeline::getHDFfile(VisualizationIOData* data)
+{
+    const std::vector<std::shared_ptr<HDFinfo> >& hdfInfo = data->getHDFinfo();
+    if (hdfInfo.empty()) return std::string();
+
+    for (const std::shared_ptr<HDFinfo>& info : hdfInfo)
+    {
+        if (info->filepathName != hdfInfo[0]->filepathName)
+            return std::string();
+    }
+    return hdfInfo[0]->filepathName;
+}
+
+size_t CauldronIO::DataPipeline::getNumBytes(const VisualizationIOData* data)
+{
+    size_t numValues = 0;
+    if (const SurfaceData* map = dynamic_cast<const SurfaceData*>(data))
+        numValues = map->getGeometry()->getSize();
+    else if (const VolumeData* volume = dynamic_cast<const VolumeData*>(data))
+        numValues = volume->getGeometry()->getSize();
+
+    // The values read from file and the values converted from those
+    return 2 * numValues * sizeof(float);
+}
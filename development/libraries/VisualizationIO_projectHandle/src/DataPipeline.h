@@ -0,0 +1,104 @@
+//
+// Copyright (C) 2012-2015 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#ifndef __DataPipeline_h__
+#define __DataPipeline_h__
+
+#include "VisualizationAPI.h"
+#include "DataStore.h"
+#include <boost/thread.hpp>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace CauldronIO
+{
+    /// \class DataPipeline
+    /// \brief Reads, converts, compresses and writes the data of a snapshot as a pipeline with bounded memory
+    /// \details HDF data is read on a single reader thread, converted (retrieved) and compressed on worker threads, and written
+    /// in order on the thread building the xml. The reader keeps ahead of the writer as long as the data in memory stays below the
+    /// memory limit, and data is released as soon as it has been written; so reading, converting and writing overlap, while the
+    /// peak memory is bounded by the limit plus the data the writer is waiting for. Compressed blocks, and gathered tiles that
+    /// did not compress, count towards the limit until these are written.
+    class DataPipeline
+    {
+    public:
+        /// \brief Creates the pipeline and starts reading
+        /// \param[in] data the data to retrieve, in the order it will be written
+        /// \param[in] numThreads number of threads converting and compressing data
+        /// \param[in] maxMemory maximum number of bytes of data to have in memory; zero for no limit
+        DataPipeline(const std::vector<VisualizationIOData*>& data, size_t numThreads, size_t maxMemory);
+        /// \brief Stops all threads; data that has not been written is not released
+        ~DataPipeline();
+
+        /// \brief Waits until the data has been retrieved, meanwhile writing blocks that have been compressed
+        /// \details Returns at once for data that is not in the pipeline; throws a CauldronIOException if retrieving has failed
+        void waitFor(const VisualizationIOData* data);
+        /// \brief Compresses the blocks added to the datastore for this data since firstBlock; the data is released once these are written
+        void write(VisualizationIOData* data, DataStoreSave& dataStore, size_t firstBlock);
+        /// \brief Writes all remaining blocks and stops all threads
+        void finish();
+
+        /// \returns the peak number of bytes of data in memory
+        size_t getPeakMemory() const;
+
+    private:
+        /// \brief State of a single data object in the pipeline
+        struct Item
+        {
+            VisualizationIOData* data;
+            size_t numBytes;  // estimated memory while in the pipeline
+            size_t numUses;   // number of times the data is still to be written
+            bool retrieved;
+            std::vector<std::pair<DataStoreSave*, size_t> > blocks; // number of blocks of each datastore to write before release
+        };
+
+        /// \brief A block to compress and write
+        struct Block
+        {
+            std::shared_ptr<DataToCompress> data;
+            DataStoreSave* dataStore;
+            size_t number;    // index of the block in the datastore
+            size_t numBytes;  // memory held by the compressed block until it is written
+        };
+
+        void read();
+        void work();
+        bool writeProcessed();
+        void stop();
+        void setError(const std::string& message);
+        void checkError() const;
+        /// \returns the HDF file with all data of the object; empty if it has no HDF data, or its data is in more files
+        static std::string getHDFfile(VisualizationIOData* data);
+        static size_t getNumBytes(const VisualizationIOData* data);
+
+        std::vector<Item> m_items;
+        std::map<const VisualizationIOData*, size_t> m_index;
+        std::deque<size_t> m_toRetrieve;
+        std::deque<Block> m_toCompress;
+        std::vector<Block> m_compressed;
+        std::deque<size_t> m_toRelease;
+        std::vector<DataStoreSave*> m_dataStores;
+
+        size_t m_maxMemory, m_memory, m_peakMemory;
+        size_t m_numRequired;  // number of items the writer needs; these are read regardless of the memory limit
+        size_t m_numEvents;    // counts progress, to not miss it while writing
+        bool m_stop;
+        std::string m_error;
+
+        mutable boost::mutex m_mutex;
+        boost::condition_variable m_progress;
+        boost::thread_group m_threads;
+    };
+}
+
+#endif
@@ -12,9 +12,13 @@
 #include "VisualizationIO_native.h"
 #include "VisualizationUtils.h"
 #include "DataStore.h"
+#include "XmlIndex.h"
 #include "FilePath.h"
 #include "FolderPath.h"
 
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/sync/file_lock.hpp>
+
 #include <iomanip>
 #include <iostream>
 #include <fstream>
@@ -22,8 +26,46 @@
 
 using namespace CauldronIO;
 
+namespace
+{
+   /// \brief Returns true if the data has been written to a datastore before
+   bool isStored(VisualizationIOData* data)
+   {
+      if (MapNative* map = dynamic_cast<MapNative*>(data))
+         return map->getDataStoreParams() != nullptr;
+
+      if (VolumeDataNative* volume = dynamic_cast<VolumeDataNative*>(data))
+         return volume->getDataStoreParamsIJK() != nullptr || volume->getDataStoreParamsKIJ() != nullptr;
+
+      return false;
+   }
+}
+
+CauldronIO::ProjectLock::ProjectLock(const std::string& xmlFileName)
+   : m_lockFileName(xmlFileName + ".lock")
+{
+   // The lock file has to exist before it can be locked; it is left in place, the lock is released by the OS if we die
+   std::ofstream(m_lockFileName.c_str(), std::ios::app);
+   try
+   {
+      m_lock = boost::interprocess::file_lock(m_lockFileName.c_str());
+   }
+   catch (boost::interprocess::interprocess_exception&)
+   {
+      throw CauldronIOException("Cannot create lock file " + m_lockFileName);
+   }
+   if (!m_lock.try_lock())
+      throw CauldronIOException(xmlFileName + " is being written by another process");
+}
+
+CauldronIO::ProjectLock::~ProjectLock()
+{
+   m_lock.unlock();
+}
+
 bool ExportToXML::exportToXML(std::shared_ptr<Project>& project, const std::shared_ptr<Project>& projectExisting,
-                              const std::string& absPath, size_t numThreads, bool center)
+                              const std::string& absPath, size_t numThreads, bool center,
+                              const std::map<std::string, ErrorBound>& errorBounds, size_t maxMemory)
 {
    // Create empty property tree object
    ibs::FilePath outputPath(absPath);
@@ -33,6 +75,10 @@ bool ExportToXML::exportToXML(std::shared_ptr<Project>& project, const std::shar
    filenameNoExtension += "_vizIO_output";
    folderPath << filenameNoExtension;
 
+   ibs::FilePath xmlFileName(outputPath.filePath());
+   xmlFileName << outputPath.fileNameNoExtension() + ".xml";
+   ProjectLock lock(xmlFileName.path());
+
    // Create output directory if not existing
     if (!folderPath.exists())
     {
@@ -42,20 +88,80 @@ bool ExportToXML::exportToXML(std::shared_ptr<Project>& project, const std::shar
     pugi::xml_document doc;
     pugi::xml_node pt = doc.append_child("project");
 
-   ExportToXML newExport(outputPath.filePath(), filenameNoExtension, numThreads, center);
+   ExportToXML newExport(outputPath.filePath(), filenameNoExtension, numThreads, center, errorBounds, maxMemory);
 
     // Create xml property tree and write datastores
     newExport.addProject(pt, project, projectExisting);
+    newExport.reportErrorBounds();
 
     // Write property tree to XML file
-    ibs::FilePath xmlFileName(outputPath.filePath());
-    xmlFileName << outputPath.fileNameNoExtension() + ".xml";
+    return saveXML(doc, xmlFileName.path());
+}
+
+bool ExportToXML::appendToXML(std::shared_ptr<Project>& project, const std::string& absPath, size_t numThreads,
+                              const std::map<std::string, ErrorBound>& errorBounds, size_t maxMemory)
+{
+   ibs::FilePath outputPath(absPath);
+   ibs::FilePath xmlFileName(outputPath.filePath());
+   xmlFileName << outputPath.fileNameNoExtension() + ".xml";
+
+   if (!xmlFileName.exists())
+      throw CauldronIOException("Cannot append to " + xmlFileName.path() + ": it does not exist");
 
-    return doc.save_file(xmlFileName.cpath());
+   ProjectLock lock(xmlFileName.path());
+
+   // The stored project, to refer to its tables if they did not change
+   pugi::xml_document existingDoc;
+   if (!existingDoc.load_file(xmlFileName.cpath()))
+      throw CauldronIOException("Cannot append to " + xmlFileName.path() + ": it cannot be parsed");
+
+   std::string filenameNoExtension = outputPath.fileNameNoExtension();
+   filenameNoExtension += "_vizIO_output";
+
+   pugi::xml_document doc;
+   pugi::xml_node pt = doc.append_child("project");
+
+   ExportToXML newExport(outputPath.filePath(), filenameNoExtension, numThreads, false, errorBounds, maxMemory);
+   newExport.m_existingProjectNode = existingDoc.child("project");
+
+   // All metadata is written again, but only new data ends up in the (appended) datastores
+   newExport.addProjectDescription(pt, project, std::shared_ptr<Project>());
+   newExport.m_append = true;
+   newExport.addProjectData(pt, project, true);
+   newExport.reportErrorBounds();
+
+   return saveXML(doc, xmlFileName.path());
 }
 
-CauldronIO::ExportToXML::ExportToXML(const ibs::FilePath& absPath, const ibs::FilePath& relPath, size_t numThreads, bool center)
-   : m_fullPath(absPath), m_relPath(relPath), m_numThreads(numThreads), m_center(center)
+bool ExportToXML::saveXML(const pugi::xml_document& doc, const std::string& xmlFileName)
+{
+   // Readers that open the xml while it is written would otherwise see a partial project
+   const std::string tempFileName = xmlFileName + ".tmp";
+   const std::string indexFileName = XmlIndex::getIndexFileName(xmlFileName);
+   const std::string tempIndexFileName = XmlIndex::getIndexFileName(tempFileName);
+   if (!XmlIndex::save(doc, tempFileName, tempIndexFileName))
+      return false;
+
+   // An index that does not belong to the xml is ignored, so either can be replaced first
+   boost::system::error_code error;
+   if (boost::filesystem::exists(tempIndexFileName, error))
+      boost::filesystem::rename(tempIndexFileName, indexFileName, error);
+   else
+      boost::filesystem::remove(indexFileName, error);
+   if (error)
+      throw CauldronIOException("Cannot replace " + indexFileName + ": " + error.message());
+
+   boost::filesystem::rename(tempFileName, xmlFileName, error);
+   if (error)
+      throw CauldronIOException("Cannot replace " + xmlFileName + ": " + error.message());
+
+   return true;
+}
+
+CauldronIO::ExportToXML::ExportToXML(const ibs::FilePath& absPath, const ibs::FilePath& relPath, size_t numThreads, bool center,
+                                     const std::map<std::string, ErrorBound>& errorBounds, size_t maxMemory)
+   : m_fullPath(absPath), m_relPath(relPath), m_numThreads(numThreads), m_maxMemory(maxMemory), m_center(center), m_errorBounds(errorBounds),
+     m_pipeline(nullptr)
 {
     if( absPath.path() == "." ) {
        m_fullPath = relPath.path();
@@ -176,6 +282,7 @@ void ExportToXML::addProjectData(pugi::xml_node pt, std::shared_ptr<Project>& pr
       }
 
       // Retrieve it
+      allSurfaceData = getDataToRetrieve(allSurfaceData);
       CauldronIO::VisualizationUtils::retrieveAllData(allSurfaceData, m_numThreads);
 
       // Add the entries
@@ -348,7 +455,7 @@ void CauldronIO::ExportToXML::addSurface(DataStoreSave& dataStore, pugi::xml_nod
    pugi::xml_node ptree = surfacesNode.append_child("surface");
 
    // Retrieve data if necessary: if the getDataStoreParams is unequal to zero this means data is saved and does not need to be saved again
-    if (!surfaceIO->isRetrieved() && !m_append)
+    if (!m_pipeline && !surfaceIO->isRetrieved() && !m_append)
         surfaceIO->retrieve();
 
     // Write general info
@@ -381,6 +488,9 @@ void CauldronIO::ExportToXML::addPropertySurfaceData(pugi::xml_node &node, DataS
    node.append_attribute("property") = propertySurfaceData.first->getName().c_str();
 
    const std::shared_ptr<SurfaceData>& surfaceData = propertySurfaceData.second;
+   prepareData(surfaceData.get());
+   const size_t firstBlock = dataStore.getNumBlocks();
+
    if (surfaceData->getFormation())
       node.append_attribute("formation") = surfaceData->getFormation()->getName().c_str();
    if (surfaceData->getReservoir())
@@ -406,13 +516,22 @@ void CauldronIO::ExportToXML::addPropertySurfaceData(pugi::xml_node &node, DataS
    }
    else
    {
+      if (setErrorBound(dataStore, propertySurfaceData.first->getName()))
+      {
+         LossyData lossyData = { propertySurfaceData.first->getName(), node, surfaceData->getGeometry()->getSize() * sizeof(float) };
+         m_lossyData.push_back(lossyData);
+      }
+
       dataStore.addSurface(surfaceData, node);
+      dataStore.setErrorBound(ErrorBound());
    }
+
+   writeData(surfaceData.get(), dataStore, firstBlock);
 }
 
 void CauldronIO::ExportToXML::addVolume(DataStoreSave& dataStore, const std::shared_ptr<Volume>& volume, pugi::xml_node volNode)
 {
-    if (!volume->isRetrieved() && !m_append)
+    if (!m_pipeline && !volume->isRetrieved() && !m_append)
         volume->retrieve();
 
     volNode.append_attribute("subsurfacekind") = volume->getSubSurfaceKind();
@@ -426,6 +545,8 @@ void CauldronIO::ExportToXML::addVolume(DataStoreSave& dataStore, const std::sha
             const std::shared_ptr<const Property>& prop = propVolume.first;
             const std::shared_ptr<VolumeData>& data = propVolume.second;
             const std::shared_ptr<Geometry3D>& thisGeometry = data->getGeometry();
+            prepareData(data.get());
+            const size_t firstBlock = dataStore.getNumBlocks();
 
             pugi::xml_node node = propVolNodes.append_child("propertyvol");
             node.append_attribute("property") = prop->getName().c_str();
@@ -472,8 +593,17 @@ void CauldronIO::ExportToXML::addVolume(DataStoreSave& dataStore, const std::sha
          }
          else
          {
+            if (setErrorBound(dataStore, prop->getName()))
+            {
+               LossyData lossyData = { prop->getName(), node, numBytes };
+               m_lossyData.push_back(lossyData);
+            }
+
             dataStore.addVolume(data, node, numBytes);
+            dataStore.setErrorBound(ErrorBound());
          }
+
+         writeData(data.get(), dataStore, firstBlock);
         }
     }
 }
@@ -500,6 +630,68 @@ void CauldronIO::ExportToXML::addReferenceData(pugi::xml_node &node, const DataS
    }
    subNode.append_attribute("size") = (unsigned long long)params->size;
    subNode.append_attribute("offset") = (unsigned long long)params->offset;
+   DataStoreSave::addEncodingAttributes(subNode, params);
+}
+
+void CauldronIO::ExportToXML::prepareData(VisualizationIOData* data) const
+{
+   if (!m_pipeline) return;
+
+   m_pipeline->waitFor(data);
+   if (!data->isRetrieved() && !m_append)
+      data->retrieve();
+}
+
+void CauldronIO::ExportToXML::writeData(VisualizationIOData* data, DataStoreSave& dataStore, size_t firstBlock) const
+{
+   if (m_pipeline)
+      m_pipeline->write(data, dataStore, firstBlock);
+}
+
+bool CauldronIO::ExportToXML::setErrorBound(DataStoreSave& dataStore, const std::string& propertyName) const
+{
+   std::map<std::string, ErrorBound>::const_iterator errorBound = m_errorBounds.find(propertyName);
+   if (errorBound == m_errorBounds.end() || errorBound->second.bound <= 0)
+      return false;
+
+   dataStore.setErrorBound(errorBound->second);
+   return true;
+}
+
+void CauldronIO::ExportToXML::reportErrorBounds() const
+{
+   if (m_lossyData.empty()) return;
+
+   struct Summary
+   {
+      size_t lossy, lossless, rawBytes, storedBytes;
+   };
+   std::map<std::string, Summary> summaries;
+
+   // The datastore nodes have been completed when the data was flushed
+   for (const LossyData& lossyData : m_lossyData)
+   {
+      Summary& summary = summaries.insert(std::make_pair(lossyData.property, Summary())).first->second;
+      for (pugi::xml_node datastore = lossyData.node.child("datastore"); datastore; datastore = datastore.next_sibling("datastore"))
+      {
+         if (datastore.attribute("quantization"))
+            summary.lossy++;
+         else
+            summary.lossless++;
+         summary.rawBytes += lossyData.numBytes;
+         summary.storedBytes += (size_t)datastore.attribute("size").as_ullong();
+      }
+   }
+
+   std::cout << "Lossy storage summary:" << std::endl;
+   for (const std::pair<const std::string, Summary>& summary : summaries)
+   {
+      const ErrorBound& errorBound = m_errorBounds.at(summary.first);
+      const Summary& counts = summary.second;
+      std::cout << " " << summary.first << " (error bound " << errorBound.bound << (errorBound.relative ? " of range" : "") << "): "
+                << counts.lossy << " blocks lossy, " << counts.lossless << " lossless, "
+                << counts.rawBytes << " bytes stored in " << counts.storedBytes << " bytes" << std::endl;
+   }
 }
 
 void CauldronIO::ExportToXML::addGeometryInfo2D(pugi::xml_node node, const std::shared_ptr<const Geometry2D>& geometry) const
@@ -544,9 +736,16 @@ void CauldronIO::ExportToXML::addSnapShot(const std::shared_ptr<SnapShot>& snapS
       VisualizationUtils::replaceExistingProperties(snapShot, m_projectExisting);
    }
 
-    // Read all data into memory: if there is an existing project, this is too late...
-   std::vector < VisualizationIOData* > data = snapShot->getAllRetrievableData();
-    CauldronIO::VisualizationUtils::retrieveAllData(data, m_numThreads);
+   std::vector < VisualizationIOData* > data = getDataToRetrieve(snapShot->getAllRetrievableData());
+
+   // Cell-centering needs all data of the snapshot: read all data into memory. Otherwise, data is read, converted, compressed
+   // and written as it is added, keeping only as much in memory as the limit allows
+   std::unique_ptr<DataPipeline> pipeline;
+   if (m_center)
+      CauldronIO::VisualizationUtils::retrieveAllData(data, m_numThreads);
+   else
+      pipeline.reset(new DataPipeline(data, m_numThreads, m_maxMemory));
+   m_pipeline = pipeline.get();
 
     // Cell center data if necessary
     if (m_center)
@@ -609,6 +808,15 @@ void CauldronIO::ExportToXML::addSnapShot(const std::shared_ptr<SnapShot>& snapS
 
     // Compress all data
     ////////////////////////////////
+    if (pipeline)
+    {
+        // Only waits for the last blocks to be compressed and written
+        pipeline->finish();
+        m_pipeline = nullptr;
+
+        if (m_maxMemory > 0)
+            std::cout << "Peak memory of snapshot data: " << pipeline->getPeakMemory() / (1024 * 1024) << " MB" << std::endl;
+    }
 
     // Collect all data
     std::vector<std::shared_ptr<DataToCompress> > allData;
@@ -743,6 +951,39 @@ bool CauldronIO::ExportToXML::detectAppend(std::shared_ptr<Project>& project)
     return false;
 }
 
+std::vector<VisualizationIOData*> CauldronIO::ExportToXML::getDataToRetrieve(const std::vector<VisualizationIOData*>& data) const
+{
+   if (!m_append)
+      return data;
+
+   std::vector<VisualizationIOData*> newData;
+   for (VisualizationIOData* item : data)
+   {
+      if (!isStored(item))
+         newData.push_back(item);
+   }
+
+   return newData;
+}
+
+bool CauldronIO::ExportToXML::addStoredTable(pugi::xml_node node, const char* data, size_t numBytes) const
+{
+   // Only when appending, and if the stored table has the same records
+   pugi::xml_node existingNode = m_existingProjectNode.child(node.name());
+   if (!m_append || !existingNode || existingNode.attribute("number").as_ullong() * existingNode.attribute("record_size").as_ullong() != numBytes)
+      return false;
+
+   pugi::xml_node datastoreNode = existingNode.child("datastore");
+   std::unique_ptr<DataStoreParams> params(DataStoreLoad::getDatastoreParams(datastoreNode, m_fullPath));
+   DataStoreLoad dataStore(params.get());
+   std::unique_ptr<char[]> storedData((char*)dataStore.getData(numBytes));
+   if (std::memcmp(storedData.get(), data, numBytes) != 0)
+      return false;
+
+   node.append_copy(datastoreNode);
+   return true;
+}
+
 void CauldronIO::ExportToXML::addMigrationEventList(pugi::xml_node pt)
 {
     size_t nr_events = m_project->getMigrationEventsTable().size();
@@ -772,10 +1013,13 @@ void CauldronIO::ExportToXML::addMigrationEventList(pugi::xml_node pt)
         memcpy(dest, source, record_size);
     }
 
-    // Add all data
-    migrationDataStore.addData((void*)data, node, record_size * nr_events);
-    // Compress it and write to disk
-    migrationDataStore.flush();
+    // Add all data, unless the table can be referred to
+    if (!addStoredTable(node, data, record_size * nr_events))
+    {
+        migrationDataStore.addData((void*)data, node, record_size * nr_events);
+        // Compress it and write to disk
+        migrationDataStore.flush();
+    }
 
     delete[] data;
 }
@@ -810,10 +1054,13 @@ void CauldronIO::ExportToXML::addTrapperList(pugi::xml_node pt)
         memcpy(dest, source, record_size);
     }
 
-    // Add all data
-    trapperDataStore.addData((void*)data, node, record_size * nr_events);
-    // Compress it and write to disk
-    trapperDataStore.flush();
+    // Add all data, unless the table can be referred to
+    if (!addStoredTable(node, data, record_size * nr_events))
+    {
+        trapperDataStore.addData((void*)data, node, record_size * nr_events);
+        // Compress it and write to disk
+        trapperDataStore.flush();
+    }
 
     delete[] data;
 }
@@ -847,10 +1094,13 @@ void CauldronIO::ExportToXML::addTrapList(pugi::xml_node pt)
         memcpy(dest, source, record_size);
     }
 
-    // Add all data
-    trapDataStore.addData((void*)data, node, record_size * nr_events);
-    // Compress it and write to disk
-    trapDataStore.flush();
+    // Add all data, unless the table can be referred to
+    if (!addStoredTable(node, data, record_size * nr_events))
+    {
+        trapDataStore.addData((void*)data, node, record_size * nr_events);
+        // Compress it and write to disk
+        trapDataStore.flush();
+    }
 
     delete[] data;
 }
@@ -14,14 +14,33 @@
 #include "VisualizationAPI.h"
 #include "DataStore.h"
 #include "FilePath.h"
+#include "DataPipeline.h"
 #pragma warning (disable:488)
 #include <boost/lockfree/queue.hpp>
 #include <boost/atomic.hpp>
+#include <boost/interprocess/sync/file_lock.hpp>
 #include "pugixml.hpp"
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace CauldronIO
 {
+    /// \brief Exclusive lock on an xml-project while its datastores and xml are written, so two writing processes cannot interleave
+    /// \details Every writer of an xml-project holds it from the first datastore write until the xml is saved
+    class ProjectLock
+    {
+    public:
+        /// \brief Locks the given xml file; throws a CauldronIOException if another process holds the lock
+        explicit ProjectLock(const std::string& xmlFileName);
+        ~ProjectLock();
+
+    private:
+        std::string m_lockFileName;
+        boost::interprocess::file_lock m_lock;
+    };
+
     class ExportToXML
     {
     public:
@@ -33,10 +52,33 @@ namespace CauldronIO
         /// \param[in] numThreads number of threads (optional) used for compression
         /// \param[in] center if true, cell-center all properties except depth
         /// \param[in] derivedProperties if true, these are derived properties; save to separate file
+        /// \param[in] errorBounds (optional) properties, by name, to store lossy with the given error bound; all others are stored lossless
+        /// \param[in] maxMemory (optional) maximum number of bytes of snapshot data to keep in memory while converting; zero for no limit
         static bool exportToXML(std::shared_ptr<Project>& project, const std::shared_ptr<Project>& projectExisting,
-			const std::string& absPath, size_t numThreads = 1, bool center = false);
-       
-        ExportToXML(const ibs::FilePath& absPath, const ibs::FilePath& relPath, size_t numThreads, bool center);
+			const std::string& absPath, size_t numThreads = 1, bool center = false,
+			const std::map<std::string, ErrorBound>& errorBounds = std::map<std::string, ErrorBound>(), size_t maxMemory = 0);
+
+        /// \brief Appends new data of a project to an existing xml-project and its binary stores
+        /// Returns true on success, throws a CauldronIOException on failure
+        /// \param[in] project the project, as imported from absPath, with snapshots, properties or formations added to it
+        /// \param[in] absPath the path with the xml file name of the existing project
+        /// \param[in] numThreads number of threads (optional) used for compression
+        /// \param[in] errorBounds (optional) properties, by name, to store lossy with the given error bound
+        /// \param[in] maxMemory (optional) maximum number of bytes of snapshot data to keep in memory while converting; zero for no limit
+        /// \details Data that is already stored is referred to, only new data is written (after the end of the existing stores).
+        /// The migration, trapper and trap tables are only written again if they changed. See VisualizationUtils::addNewSnapShots.
+        /// The xml is replaced atomically once all data is on disk, so concurrent readers see either the old or the new project.
+        /// There is no cell-centering option: the existing data would be centered twice, so new data should be added centered if needed
+        static bool appendToXML(std::shared_ptr<Project>& project, const std::string& absPath, size_t numThreads = 1,
+                                const std::map<std::string, ErrorBound>& errorBounds = std::map<std::string, ErrorBound>(),
+                                size_t maxMemory = 0);
+
+        /// \brief Saves the xml document, with its binary index, by writing temporary files and renaming them over xmlFileName
+        /// The caller is expected to hold the ProjectLock of the xml file
+        static bool saveXML(const pugi::xml_document& doc, const std::string& xmlFileName);
+
+        ExportToXML(const ibs::FilePath& absPath, const ibs::FilePath& relPath, size_t numThreads, bool center,
+                    const std::map<std::string, ErrorBound>& errorBounds = std::map<std::string, ErrorBound>(), size_t maxMemory = 0);
 
         void addProjectDescription(pugi::xml_node pt, std::shared_ptr<Project>& project, const std::shared_ptr<Project>& projectExisting);
         void addProjectData(pugi::xml_node pt, std::shared_ptr<Project>& project, const bool addSnapshots = true);
@@ -48,6 +90,18 @@ namespace CauldronIO
         /// we should not re-write the existing binary data (that would be very inefficient)
         /// This method detects that we need to append the binary files, instead of writing them from scratch
         bool detectAppend(std::shared_ptr<Project>& project);
+        /// Returns the data that still needs to be retrieved for writing; in append mode, data already stored is referred to instead
+        std::vector<VisualizationIOData*> getDataToRetrieve(const std::vector<VisualizationIOData*>& data) const;
+
+        /// Makes sure the data is in memory before it is written: waits for the pipeline, or retrieves it here
+        void prepareData(VisualizationIOData* data) const;
+        /// Writes the blocks added to the datastore for the data since firstBlock through the pipeline, if any
+        void writeData(VisualizationIOData* data, DataStoreSave& dataStore, size_t firstBlock) const;
+
+        /// Sets the error bound configured for the property on the datastore; returns true if it is to be stored lossy
+        bool setErrorBound(DataStoreSave& dataStore, const std::string& propertyName) const;
+        /// Prints, per lossy property, how many blocks were stored lossy and the space saved
+        void reportErrorBounds() const;
 
         // Method to compress blocks of data on a thread
         static void compressDataQueue(std::vector< std::shared_ptr < DataToCompress > > allData, boost::lockfree::queue<int>* queue);
@@ -64,6 +118,8 @@ namespace CauldronIO
        void addMigrationEventList(pugi::xml_node pt);
        void addTrapperList(pugi::xml_node pt);
        void addTrapList(pugi::xml_node pt);
+       /// When appending, refers the table node to the stored table if that holds the same data; returns false if it has to be written
+       bool addStoredTable(pugi::xml_node node, const char* data, size_t numBytes) const;
        void addGenexHistory(pugi::xml_node pt);
        void addBurialHistory(pugi::xml_node pt);
        void addMassBalance(pugi::xml_node pt);
@@ -73,8 +129,22 @@ namespace CauldronIO
        ibs::FilePath m_relPath;
        std::shared_ptr<Project> m_project;
        std::shared_ptr<const Project> m_projectExisting;
+       pugi::xml_node m_existingProjectNode;
        bool m_append, m_center;
-       size_t m_numThreads;
+       size_t m_numThreads, m_maxMemory;
+       std::map<std::string, ErrorBound> m_errorBounds;
+
+       // Reads, converts and writes the data of the snapshot being exported; not used when cell-centering, which needs all data at once
+       DataPipeline* m_pipeline;
+
+       // Data written for properties with an error bound: property name, xml node holding the datastore(s) and bytes per datastore
+       struct LossyData
+       {
+          std::string property;
+          pugi::xml_node node;
+          size_t numBytes;
+       };
+       mutable std::vector<LossyData> m_lossyData;
     };
 }
 #endif
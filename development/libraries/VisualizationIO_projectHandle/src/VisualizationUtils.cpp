@@ -12,6 +12,7 @@
 #include "VisualizationUtils.h"
 #include "DataStore.h"
 #include <assert.h>
+#include <algorithm>
 #include "hdf5.h"
 #include <boost/thread.hpp>
 
@@ -777,6 +778,59 @@ void VisualizationUtils::replaceFormations(const std::shared_ptr<Project>& proje
    }
 }
 
+size_t VisualizationUtils::addNewSnapShots(const std::shared_ptr<Project>& project, const std::shared_ptr<const Project>& newProject)
+{
+   size_t numAdded = 0;
+   for (std::shared_ptr<SnapShot> snapShot : newProject->getSnapShots())
+   {
+      bool exists = false;
+      for (const std::shared_ptr<SnapShot>& snapShotExisting : project->getSnapShots())
+      {
+         exists = exists or (snapShotExisting->getAge() == snapShot->getAge() and snapShotExisting->getKind() == snapShot->getKind() and
+                             snapShotExisting->isMinorShapshot() == snapShot->isMinorShapshot());
+      }
+
+      if (not exists)
+      {
+         project->addSnapShot(snapShot);
+         ++numAdded;
+      }
+   }
+
+   // The added snapshots are written with references to these; existing ones are not added twice
+   for (std::shared_ptr<const Property> property : newProject->getProperties())
+      project->addProperty(property);
+   for (const std::shared_ptr<const Geometry2D>& geometry : newProject->getGeometries())
+      project->addGeometry(geometry);
+   for (std::shared_ptr<const Reservoir> reservoir : newProject->getReservoirs())
+   {
+      if (not project->findReservoir(reservoir->getName()))
+         project->addReservoir(reservoir);
+   }
+
+   // The tables cover the whole run, so the new ones replace the stored ones
+   if (not newProject->getMigrationEventsTable().empty())
+   {
+      project->clearMigrationEventsTable();
+      for (const std::shared_ptr<MigrationEvent>& event : newProject->getMigrationEventsTable())
+         project->addMigrationEvent(event);
+   }
+   if (not newProject->getTrapperTable().empty())
+   {
+      project->clearTrapperTable();
+      for (std::shared_ptr<Trapper> trapper : newProject->getTrapperTable())
+         project->addTrapper(trapper);
+   }
+   if (not newProject->getTrapTable().empty())
+   {
+      project->clearTrapTable();
+      for (std::shared_ptr<Trap> trap : newProject->getTrapTable())
+         project->addTrap(trap);
+   }
+
+   return numAdded;
+}
+
 void VisualizationUtils::replaceExistingProperties(const std::shared_ptr<SnapShot>& snapShot, std::shared_ptr<const Project>& projectToExtend)
 {
 	// Find the snapshot
@@ -932,6 +986,30 @@ void VisualizationUtils::replaceVolume(const std::shared_ptr<Volume>& currentVol
 	}
 }
 
+void VisualizationUtils::readHDFdata(const std::vector<VisualizationIOData*>& data)
+{
+	// Group the datasets of all objects by file, so each file is opened once
+	std::vector < std::string > hdfFileNames;
+	std::vector < std::vector < std::shared_ptr<CauldronIO::HDFinfo> > > hdfInfoListList;
+	for (VisualizationIOData* object : data)
+	{
+		for (const std::shared_ptr<CauldronIO::HDFinfo>& hdfInfo : object->getHDFinfo())
+		{
+			size_t k = std::find(hdfFileNames.begin(), hdfFileNames.end(), hdfInfo->filepathName) - hdfFileNames.begin();
+			if (k == hdfFileNames.size())
+			{
+				hdfFileNames.push_back(hdfInfo->filepathName);
+				hdfInfoListList.push_back(std::vector < std::shared_ptr<CauldronIO::HDFinfo> >());
+			}
+			hdfInfoListList[k].push_back(hdfInfo);
+		}
+	}
+
+	boost::lockfree::queue<int> queue(128); // unused
+	for (size_t k = 0; k < hdfInfoListList.size(); ++k)
+		loadHDFdata(hdfInfoListList[k], &queue);
+}
+
 void VisualizationUtils::retrieveSingleData(std::shared_ptr<CauldronIO::SurfaceData> map)
 {
 	boost::lockfree::queue<int> queue(128); // unused
@@ -50,6 +50,16 @@ namespace CauldronIO
         /// \param[in] project the project to add references
         /// \param[in] projectExisting the project with existing formations
         static void replaceFormations(const std::shared_ptr<Project>& project, std::shared_ptr<const Project>& projectExisting);
+        /// \brief Adds the snapshots of newProject that are not in the project, with the properties, geometries and reservoirs they refer to,
+        /// and takes over the migration, trapper and trap tables of newProject if it has them
+        /// \param[in] project the project to add the snapshots to
+        /// \param[in] newProject the project with (possibly) new snapshots, e.g. imported from a project handle after a new run
+        /// \returns the number of snapshots added
+        static size_t addNewSnapShots(const std::shared_ptr<Project>& project, const std::shared_ptr<const Project>& newProject);
+        /// \brief Reads the HDF data of the given objects into memory, so these can be retrieved on any thread
+        /// \details Each HDF file is opened once, to read the datasets of all objects in it
+        /// \param[in] data the data to read; objects without HDF data are skipped
+        static void readHDFdata(const std::vector<VisualizationIOData*>& data);
         /// \param[in] map data to retrieve
         static void retrieveSingleData(std::shared_ptr<CauldronIO::SurfaceData> map);
         /// \brief Little method to find data within a project
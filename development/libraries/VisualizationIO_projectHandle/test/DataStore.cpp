@@ -9,10 +9,73 @@
 //
 
 #include <gtest/gtest.h>
-#include "../src/DataStore.h"
-
-using namespace CauldronIO;
-
+#include "../src/DataStore.h"
+#include "../src/VisualizationIO_native.h"
+#include "../src/ImportFromXML.h"
+#include "../src/XmlIndex.h"
+#include "../src/DataPipeline.h"
+#include "../src/ExportToXML.h"
+#include "../src/VisualizationUtils.h"
+
+#include <boost/filesystem.hpp>
+
+#include <boost/iostreams/filtering_streambuf.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/copy.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using namespace CauldronIO;
+
+namespace
+{
+    // Reference gzip path through boost::iostreams and stringstreams, as used before the direct zlib implementation
+    std::string streamGzip(const char* inputData, size_t size, bool compress)
+    {
+        std::stringstream data, result;
+        data.write(inputData, size);
+
+        boost::iostreams::filtering_streambuf<boost::iostreams::input> out;
+        if (compress)
+            out.push(boost::iostreams::gzip_compressor());
+        else
+            out.push(boost::iostreams::gzip_decompressor());
+        out.push(data);
+        boost::iostreams::copy(out, result);
+
+        return result.str();
+    }
+
+    double megaBytesPerSecond(size_t numBytes, std::chrono::steady_clock::duration elapsed)
+    {
+        return numBytes / 1048576.0 / std::chrono::duration<double>(elapsed).count();
+    }
+
+    // A snapshot with a single map with values offset, offset + 1, ...
+    std::shared_ptr<SnapShot> createMapSnapShot(double age, const std::shared_ptr<const Property>& property,
+                                                const std::shared_ptr<const Geometry2D>& geometry, float offset)
+    {
+        std::vector<float> values(geometry->getSize());
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = offset + (float)i;
+
+        std::shared_ptr<SurfaceData> map(new MapNative(geometry));
+        map->setData_IJ(values.data());
+        PropertySurfaceData propertyMap(property, map);
+        std::shared_ptr<Surface> surface(new Surface("Surface", Sediment));
+        surface->addPropertySurfaceData(propertyMap);
+        std::shared_ptr<SnapShot> snapShot(new SnapShot(age, SYSTEM, false));
+        snapShot->addSurface(surface);
+        return snapShot;
+    }
+}
+
 TEST( DataStore, Compression )
 {
     const char hello[5] = { 'h', 'e', 'l', 'l', 'o' };
@@ -41,4 +104,697 @@ TEST( DataStore, Compression )
 
     delete[] compressed;
     delete[] decompressed;
-}
\ No newline at end of file
+}
+TEST( DataStore, MappedLoad )
+{
+    // Blocks end up at offsets that are not aligned to the mapping granularity
+    std::vector<float> small(3), large(10000);
+    for (size_t i = 0; i < small.size(); ++i) small[i] = (float)i;
+    for (size_t i = 0; i < large.size(); ++i) large[i] = (float)(i % 17) * 0.5f;
+
+    pugi::xml_document doc;
+    pugi::xml_node root = doc.append_child("root");
+    {
+        DataStoreSave dataStore("MappedLoad.cldrn", false);
+        dataStore.addData(small.data(), root.append_child("small"), small.size() * sizeof(float));
+        dataStore.addData(large.data(), root.append_child("large"), large.size() * sizeof(float));
+        dataStore.flush();
+    }
+
+    const std::vector<float>* expected[2] = { &small, &large };
+    const char* names[2] = { "small", "large" };
+    for (int block = 0; block < 2; ++block)
+    {
+        pugi::xml_node datastoreNode = root.child(names[block]).child("datastore");
+        std::unique_ptr<DataStoreParams> params(DataStoreLoad::getDatastoreParams(datastoreNode, ibs::FilePath(".")));
+        size_t numBytes = expected[block]->size() * sizeof(float);
+
+        DataStoreLoad dataStore(params.get());
+        size_t size = numBytes;
+        float* data = dataStore.getData(size);
+        EXPECT_EQ(size, numBytes);
+        for (size_t i = 0; i < expected[block]->size(); ++i)
+            EXPECT_FLOAT_EQ(data[i], (*expected[block])[i]);
+        delete[] data;
+
+        std::vector<float> buffer(expected[block]->size());
+        dataStore.getData((char*)buffer.data(), numBytes);
+        EXPECT_TRUE(buffer == *expected[block]);
+    }
+
+    ibs::FilePath("MappedLoad.cldrn").remove();
+}
+
+TEST( DataStore, MappedMap )
+{
+    std::vector<float> values(100 * 100);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = (float)(i % 23);
+    values[10] = std::numeric_limits<float>::quiet_NaN();
+
+    pugi::xml_document doc;
+    pugi::xml_node node = doc.append_child("map");
+    {
+        DataStoreSave dataStore("MappedMap.cldrn", false);
+        dataStore.addData(values.data(), node, values.size() * sizeof(float));
+        dataStore.flush();
+    }
+
+    pugi::xml_node datastoreNode = node.child("datastore");
+    std::shared_ptr<Geometry2D> geometry(new Geometry2D(100, 100, 100.0, 100.0, 0.0, 0.0));
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        MapNative map(geometry);
+        map.setDataStore(DataStoreLoad::getDatastoreParams(datastoreNode, ibs::FilePath(".")));
+        map.retrieve();
+
+        // The map uses the mapping in place: the NaN is replaced in the private mapping, the file keeps it
+        EXPECT_FLOAT_EQ(22.0f, map.getMaxValue());
+        EXPECT_EQ(DefaultUndefinedValue, map.getValue(10, 0));
+        EXPECT_FLOAT_EQ(11.0f, map.getValue(11, 0));
+
+        // Assigning data afterwards copies it into a buffer of the map's own
+        map.setData_IJ(values.data());
+        EXPECT_FLOAT_EQ(1.0f, map.getValue(1, 0));
+        map.release();
+    }
+
+    std::unique_ptr<DataStoreParams> params(DataStoreLoad::getDatastoreParams(datastoreNode, ibs::FilePath(".")));
+    DataStoreLoad dataStore(params.get());
+    std::vector<float> stored(values.size());
+    dataStore.getData((char*)stored.data(), stored.size() * sizeof(float));
+    EXPECT_TRUE(std::isnan(stored[10]));
+
+    ibs::FilePath("MappedMap.cldrn").remove();
+}
+
+TEST( DataStore, GzipCompatibility )
+{
+    // A smooth property, compressible like typical volume data
+    std::vector<float> data(64 * 1024);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = 1000.0f + 10.0f * std::sin(i * 1e-4f) + (float)(i % 64);
+    const size_t numBytes = data.size() * sizeof(float);
+
+    size_t compressedSize = numBytes;
+    std::unique_ptr<char[]> compressed(DataStoreSave::compress((const char*)data.data(), compressedSize));
+    EXPECT_LT(compressedSize, numBytes);
+
+    std::unique_ptr<char[]> decompressed(new char[numBytes]);
+    DataStoreLoad::decompress(compressed.get(), compressedSize, decompressed.get(), numBytes);
+    EXPECT_EQ(std::memcmp(decompressed.get(), data.data(), numBytes), 0);
+
+    // The direct and the stream based paths have to read each other's output
+    const std::string streamCompressed = streamGzip((const char*)data.data(), numBytes, true);
+    std::memset(decompressed.get(), 0, numBytes);
+    DataStoreLoad::decompress(streamCompressed.data(), streamCompressed.size(), decompressed.get(), numBytes);
+    EXPECT_EQ(std::memcmp(decompressed.get(), data.data(), numBytes), 0);
+    EXPECT_EQ(streamGzip(compressed.get(), compressedSize, false), std::string((const char*)data.data(), numBytes));
+}
+
+// Timing of the direct zlib path against the stream based one, run with --gtest_also_run_disabled_tests
+TEST( DataStore, DISABLED_GzipThroughput )
+{
+    // A smooth 4 MB property, compressible like typical volume data
+    std::vector<float> data(1024 * 1024);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = 1000.0f + 10.0f * std::sin(i * 1e-4f) + (float)(i % 64);
+    const size_t numBytes = data.size() * sizeof(float);
+    const int repeats = 3;
+
+    std::chrono::steady_clock::duration streamCompress(0), streamDecompress(0), directCompress(0), directDecompress(0);
+    std::string streamCompressed;
+    for (int run = 0; run < repeats; ++run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        streamCompressed = streamGzip((const char*)data.data(), numBytes, true);
+        streamCompress += std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        std::string decompressed = streamGzip(streamCompressed.data(), streamCompressed.size(), false);
+        streamDecompress += std::chrono::steady_clock::now() - start;
+        ASSERT_EQ(decompressed.size(), numBytes);
+    }
+
+    std::unique_ptr<char[]> compressed;
+    std::unique_ptr<char[]> decompressed(new char[numBytes]);
+    size_t compressedSize = 0;
+    for (int run = 0; run < repeats; ++run)
+    {
+        compressedSize = numBytes;
+        auto start = std::chrono::steady_clock::now();
+        compressed.reset(DataStoreSave::compress((const char*)data.data(), compressedSize));
+        directCompress += std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        DataStoreLoad::decompress(compressed.get(), compressedSize, decompressed.get(), numBytes);
+        directDecompress += std::chrono::steady_clock::now() - start;
+        ASSERT_EQ(std::memcmp(decompressed.get(), data.data(), numBytes), 0);
+    }
+
+    std::cout << "gzip compress   (MB/s): streams " << megaBytesPerSecond(repeats * numBytes, streamCompress)
+              << ", direct " << megaBytesPerSecond(repeats * numBytes, directCompress) << std::endl;
+    std::cout << "gzip decompress (MB/s): streams " << megaBytesPerSecond(repeats * numBytes, streamDecompress)
+              << ", direct " << megaBytesPerSecond(repeats * numBytes, directDecompress) << std::endl;
+
+}
+
+TEST( DataStore, PreFilters )
+{
+    // A smooth depth-like field, plus two trailing bytes that do not make up a word
+    std::vector<float> data(100000);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = 2500.0f + 0.37f * i + 25.0f * std::sin(i * 1e-3f);
+    const size_t numBytes = data.size() * sizeof(float) + 2;
+    std::vector<char> input(numBytes, 7);
+    std::memcpy(input.data(), data.data(), data.size() * sizeof(float));
+
+    const unsigned int filters[4] = { FilterNone, FilterDelta, FilterShuffle, FilterDelta | FilterShuffle };
+    size_t compressedSizes[4];
+    for (int f = 0; f < 4; ++f)
+    {
+        EXPECT_EQ(DataStoreLoad::parseFilter(DataStoreSave::getFilterName(filters[f])), filters[f]);
+
+        std::vector<char> filtered(numBytes), restored(numBytes);
+        DataStoreSave::applyFilter(input.data(), filtered.data(), numBytes, filters[f]);
+        DataStoreLoad::removeFilter(filtered.data(), restored.data(), numBytes, filters[f]);
+        EXPECT_TRUE(restored == input);
+
+        compressedSizes[f] = numBytes;
+        std::unique_ptr<char[]> compressed(DataStoreSave::compress_lz4(filtered.data(), compressedSizes[f]));
+    }
+
+    // Each filter helps, the combination most; together these make the block compress at least four times better
+    EXPECT_LT(compressedSizes[1], compressedSizes[0]);
+    EXPECT_LT(compressedSizes[2], compressedSizes[0]);
+    EXPECT_LT(compressedSizes[3], compressedSizes[1]);
+    EXPECT_LT(compressedSizes[3], compressedSizes[2]);
+    EXPECT_LT(4 * compressedSizes[3], compressedSizes[0]);
+    EXPECT_THROW(DataStoreLoad::parseFilter("bitround"), CauldronIOException);
+
+    // Round trip through a datastore file: the filter is recorded in the XML and reversed on load
+    pugi::xml_document doc;
+    pugi::xml_node root = doc.append_child("root");
+    {
+        DataStoreSave dataStore("PreFilters.cldrn", false);
+        dataStore.addData(input.data(), root, numBytes);
+    }
+    pugi::xml_node datastoreNode = root.child("datastore");
+    pugi::xml_node mapNode = root.append_child("map");
+    std::unique_ptr<DataStoreParams> params(DataStoreLoad::getDatastoreParams(datastoreNode, ibs::FilePath(".")));
+    EXPECT_EQ(params->filter, (unsigned int)FilterNone);
+
+    std::shared_ptr<Geometry2D> geometry(new Geometry2D(400, 250, 100.0, 100.0, 0.0, 0.0));
+    std::shared_ptr<MapNative> map(new MapNative(geometry));
+    map->setData_IJ(data.data());
+    {
+        DataStoreSave dataStore("PreFilters.cldrn", false);
+        dataStore.addSurface(map, mapNode);
+    }
+    datastoreNode = mapNode.child("datastore");
+    params.reset(DataStoreLoad::getDatastoreParams(datastoreNode, ibs::FilePath(".")));
+    EXPECT_EQ(params->filter, (unsigned int)(FilterDelta | FilterShuffle));
+
+    DataStoreLoad dataStore(params.get());
+    std::vector<float> result(data.size());
+    dataStore.getData((char*)result.data(), result.size() * sizeof(float));
+    EXPECT_TRUE(result == data);
+
+    ibs::FilePath("PreFilters.cldrn").remove();
+}
+
+TEST( DataStore, TiledVolumeRegion )
+{
+    // 70 x 50 x 20 cells with 32 x 32 x 8 tiles: partial tiles along every axis
+    const size_t numI = 70, numJ = 50, numK = 20, firstK = 3;
+    std::shared_ptr<Geometry3D> geometry(new Geometry3D(numI, numJ, numK, firstK, 100.0, 100.0, 0.0, 0.0));
+    std::vector<float> data(numI * numJ * numK);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = 1000.0f + (float)i * 0.25f;
+
+    std::shared_ptr<VolumeDataNative> volume(new VolumeDataNative(geometry));
+    volume->setData_IJK(data.data());
+
+    pugi::xml_document doc;
+    pugi::xml_node volumeNode = doc.append_child("volume");
+    {
+        DataStoreSave dataStore("TiledVolume.cldrn", false);
+        dataStore.setTileSize(32, 32, 8);
+        dataStore.addVolume(volume, volumeNode, data.size() * sizeof(float));
+    }
+
+    pugi::xml_node datastoreNode = volumeNode.child("datastore");
+    EXPECT_EQ(datastoreNode.attribute("tileI").as_uint(), 32u);
+
+    std::shared_ptr<VolumeDataNative> loaded(new VolumeDataNative(geometry));
+    DataStoreLoad::getVolume(volumeNode, loaded, ibs::FilePath("."));
+    EXPECT_EQ(loaded->getDataStoreParamsIJK()->tileOffsets.size(), 3u * 2u * 3u + 1u);
+
+    // A k-slab, a window crossing tile boundaries and a single column
+    const VolumeRegion regions[3] = { { 0, 0, firstK + 9, numI, numJ, 1 }, { 20, 30, firstK + 5, 40, 15, 10 }, { 69, 49, firstK, 1, 1, numK } };
+    for (const VolumeRegion& region : regions)
+    {
+        std::vector<float> result(region.numI * region.numJ * region.numK);
+        ArrayView<float> buffer = { result.data(), result.size() };
+        loaded->retrieveRegion(region, buffer);
+        EXPECT_FALSE(loaded->isRetrieved());
+
+        size_t index = 0;
+        for (size_t k = region.firstK; k < region.firstK + region.numK; ++k)
+            for (size_t j = region.firstJ; j < region.firstJ + region.numJ; ++j)
+                for (size_t i = region.firstI; i < region.firstI + region.numI; ++i)
+                    EXPECT_EQ(result[index++], data[i + j * numI + (k - firstK) * numI * numJ]);
+    }
+
+    VolumeRegion outside = { 0, 0, 0, 1, 1, 1 };
+    float value;
+    ArrayView<float> single = { &value, 1 };
+    EXPECT_THROW(loaded->retrieveRegion(outside, single), CauldronIOException);
+
+    // The full volume is assembled from all tiles
+    loaded->retrieve();
+    ASSERT_TRUE(loaded->isRetrieved());
+    EXPECT_EQ(std::memcmp(loaded->getVolumeValues_IJK(), data.data(), data.size() * sizeof(float)), 0);
+
+    ibs::FilePath("TiledVolume.cldrn").remove();
+}
+
+TEST( DataStore, LossyErrorBound )
+{
+    // A noisy temperature-like field with some undefined values
+    const size_t numI = 400, numJ = 250;
+    std::shared_ptr<Geometry2D> geometry(new Geometry2D(numI, numJ, 100.0, 100.0, 0.0, 0.0));
+    std::vector<float> data(numI * numJ);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = (i % 997 == 0) ? DefaultUndefinedValue : 80.0f + 0.01f * i + 3.0f * std::sin(i * 0.7f);
+
+    const double bounds[4] = { 0.01, 1e-3, 1e-9, 0.0 };
+    const bool relative[4] = { false, true, false, false };
+    size_t sizes[4];
+    for (int b = 0; b < 4; ++b)
+    {
+        pugi::xml_document doc;
+        pugi::xml_node mapNode = doc.append_child("map");
+        std::shared_ptr<MapNative> map(new MapNative(geometry));
+        map->setData_IJ(data.data());
+        {
+            DataStoreSave dataStore("LossyErrorBound.cldrn", false);
+            dataStore.setErrorBound(ErrorBound(bounds[b], relative[b]));
+            dataStore.addSurface(map, mapNode);
+        }
+
+        pugi::xml_node datastoreNode = mapNode.child("datastore");
+        std::unique_ptr<DataStoreParams> params(DataStoreLoad::getDatastoreParams(datastoreNode, ibs::FilePath(".")));
+        sizes[b] = params->size;
+
+        DataStoreLoad dataStore(params.get());
+        std::vector<float> result(data.size());
+        dataStore.getData((char*)result.data(), result.size() * sizeof(float));
+
+        // A bound below float precision cannot be guaranteed: stored lossless
+        if (b >= 2)
+        {
+            EXPECT_FALSE(datastoreNode.attribute("quantization"));
+            EXPECT_TRUE(result == data);
+            continue;
+        }
+
+        ASSERT_TRUE(datastoreNode.attribute("quantization"));
+        const double absoluteBound = datastoreNode.attribute("errorbound").as_double();
+        EXPECT_LE(absoluteBound, relative[b] ? bounds[b] * 2600.0 : bounds[b]);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            if (data[i] == DefaultUndefinedValue)
+                EXPECT_EQ(result[i], DefaultUndefinedValue);
+            else
+                EXPECT_LE(std::fabs((double)result[i] - (double)data[i]), absoluteBound);
+        }
+    }
+    // Both lossy blocks are smaller than the lossless one
+    EXPECT_LT(sizes[0], sizes[3]);
+    EXPECT_LT(sizes[1], sizes[3]);
+    EXPECT_EQ(sizes[2], sizes[3]);
+
+    // Non-finite values make the whole block lossless
+    double absoluteBound;
+    EXPECT_GT(DataStoreSave::getQuantizationStep(data.data(), data.size(), ErrorBound(0.01, false), absoluteBound), 0.0);
+    data[5] = std::numeric_limits<float>::infinity();
+    EXPECT_EQ(DataStoreSave::getQuantizationStep(data.data(), data.size(), ErrorBound(0.01, false), absoluteBound), 0.0);
+    data[5] = 80.0f;
+
+    // Tiled volumes share one quantization step across all tiles
+    const size_t numK = 20;
+    std::shared_ptr<Geometry3D> geometry3D(new Geometry3D(70, 50, numK, 0, 100.0, 100.0, 0.0, 0.0));
+    std::vector<float> volumeData(data.begin(), data.begin() + 70 * 50 * numK);
+    std::shared_ptr<VolumeDataNative> volume(new VolumeDataNative(geometry3D));
+    volume->setData_IJK(volumeData.data());
+
+    pugi::xml_document doc;
+    pugi::xml_node volumeNode = doc.append_child("volume");
+    {
+        DataStoreSave dataStore("LossyErrorBound.cldrn", false);
+        dataStore.setTileSize(32, 32, 8);
+        dataStore.setErrorBound(ErrorBound(0.05, false));
+        dataStore.addVolume(volume, volumeNode, volumeData.size() * sizeof(float));
+    }
+    ASSERT_TRUE(volumeNode.child("datastore").attribute("quantization"));
+
+    std::shared_ptr<VolumeDataNative> loaded(new VolumeDataNative(geometry3D));
+    DataStoreLoad::getVolume(volumeNode, loaded, ibs::FilePath("."));
+    loaded->retrieve();
+    ASSERT_TRUE(loaded->isRetrieved());
+    for (size_t i = 0; i < volumeData.size(); ++i)
+        EXPECT_LE(std::fabs((double)loaded->getVolumeValues_IJK()[i] - (double)volumeData[i]), 0.05);
+
+    ibs::FilePath("LossyErrorBound.cldrn").remove();
+}
+
+TEST( DataStore, Append )
+{
+    std::shared_ptr<Geometry2D> geometry(new Geometry2D(40, 25, 100.0, 100.0, 0.0, 0.0));
+    std::vector<float> first(geometry->getSize()), second(geometry->getSize());
+    for (size_t i = 0; i < first.size(); ++i)
+    {
+        first[i] = 100.0f + (float)i;
+        second[i] = std::sin((float)i);
+    }
+
+    pugi::xml_document doc;
+    pugi::xml_node firstNode = doc.append_child("first");
+    {
+        std::shared_ptr<MapNative> map(new MapNative(geometry));
+        map->setData_IJ(first.data());
+        DataStoreSave dataStore("Append.cldrn", false);
+        dataStore.addSurface(map, firstNode);
+    }
+    std::ifstream existing("Append.cldrn", std::ios::binary | std::ios::ate);
+    const size_t existingSize = (size_t)existing.tellg();
+    existing.close();
+
+    // Refer to the stored map and append a new one: the existing block keeps its place, the new one goes after it
+    std::shared_ptr<MapNative> stored(new MapNative(geometry));
+    DataStoreLoad::getSurface(firstNode, stored, ibs::FilePath("."));
+
+    pugi::xml_document appendDoc;
+    pugi::xml_node storedNode = appendDoc.append_child("first");
+    pugi::xml_node secondNode = appendDoc.append_child("second");
+    {
+        std::shared_ptr<MapNative> map(new MapNative(geometry));
+        map->setData_IJ(second.data());
+        DataStoreSave dataStore("Append.cldrn", true);
+        dataStore.addSurface(stored, storedNode);
+        dataStore.addSurface(map, secondNode);
+    }
+    EXPECT_EQ(storedNode.child("datastore").attribute("offset").as_ullong(), firstNode.child("datastore").attribute("offset").as_ullong());
+    EXPECT_EQ(secondNode.child("datastore").attribute("offset").as_ullong(), (unsigned long long)existingSize);
+
+    const std::vector<float>* expected[2] = { &first, &second };
+    pugi::xml_node nodes[2] = { storedNode, secondNode };
+    for (int block = 0; block < 2; ++block)
+    {
+        std::shared_ptr<MapNative> loaded(new MapNative(geometry));
+        DataStoreLoad::getSurface(nodes[block], loaded, ibs::FilePath("."));
+        loaded->retrieve();
+        EXPECT_EQ(std::memcmp(loaded->getSurfaceValues(), expected[block]->data(), first.size() * sizeof(float)), 0);
+    }
+
+    // Data that is not in the store can only mean it was truncated
+    {
+        std::ofstream truncated("Append.cldrn", std::ios::binary | std::ios::trunc);
+    }
+    pugi::xml_node failNode = appendDoc.append_child("fail");
+    {
+        DataStoreSave dataStore("Append.cldrn", true);
+        EXPECT_THROW(dataStore.addSurface(stored, failNode), CauldronIOException);
+    }
+
+    ibs::FilePath("Append.cldrn").remove();
+}
+
+TEST( DataStore, XmlIndex )
+{
+    // A small project with a few snapshots holding constant maps
+    pugi::xml_document doc;
+    pugi::xml_node project = doc.append_child("project");
+    project.append_child("name").text() = "XmlIndex";
+    project.append_child("outputpath").text() = "XmlIndex_vizIO_output";
+    pugi::xml_node version = project.append_child("xml-version");
+    version.append_attribute("major") = xml_version_major;
+    version.append_attribute("minor") = xml_version_minor;
+    pugi::xml_node property = project.append_child("properties").append_child("property");
+    property.append_attribute("name") = "Depth";
+    property.append_attribute("cauldronname") = "Depth";
+    property.append_attribute("username") = "Depth";
+    property.append_attribute("unit") = "m";
+    pugi::xml_node snapShots = project.append_child("snapshots");
+    for (int i = 0; i < 3; ++i)
+    {
+        pugi::xml_node snapShot = snapShots.append_child("snapshot");
+        snapShot.append_attribute("age") = 10.0 * i;
+        snapShot.append_attribute("kind") = (int)SYSTEM;
+        snapShot.append_attribute("isminor") = i == 1;
+        pugi::xml_node surface = snapShot.append_child("surfaces").append_child("surface");
+        surface.append_attribute("name") = "Surface";
+        pugi::xml_node map = surface.append_child("propertymaps").append_child("propertymap");
+        map.append_attribute("property") = "Depth";
+        map.append_attribute("geom-index") = 0;
+        map.append_attribute("constantvalue") = 100.0f * i;
+    }
+    pugi::xml_node geometry = project.append_child("geometries").append_child("geometry");
+    geometry.append_attribute("numI") = 10;
+    geometry.append_attribute("numJ") = 10;
+    geometry.append_attribute("deltaI") = 100.0;
+    geometry.append_attribute("deltaJ") = 100.0;
+
+    const std::string xmlFileName = "XmlIndex.xml";
+    ASSERT_TRUE(XmlIndex::save(doc, xmlFileName, XmlIndex::getIndexFileName(xmlFileName)));
+
+    // The written xml is a normal project
+    pugi::xml_document reloaded;
+    ASSERT_TRUE(reloaded.load_file(xmlFileName.c_str()));
+    EXPECT_EQ(std::distance(reloaded.child("project").child("snapshots").children("snapshot").begin(),
+                            reloaded.child("project").child("snapshots").children("snapshot").end()), 3);
+
+    // Snapshots are only parsed when accessed
+    std::shared_ptr<Project> indexed = ImportFromXML::importFromXML(xmlFileName);
+    ASSERT_EQ(indexed->getSnapShots().size(), 3u);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const std::shared_ptr<SnapShot>& snapShot = indexed->getSnapShots()[i];
+        EXPECT_FALSE(snapShot->isLoaded());
+        EXPECT_EQ(snapShot->getAge(), 10.0 * i);
+        EXPECT_EQ(snapShot->isMinorShapshot(), i == 1);
+    }
+    const std::shared_ptr<SnapShot>& last = indexed->getSnapShots()[2];
+    ASSERT_EQ(last->getSurfaceList().size(), 1u);
+    EXPECT_TRUE(last->isLoaded());
+    EXPECT_FALSE(indexed->getSnapShots()[1]->isLoaded());
+    EXPECT_EQ(last->getSurfaceList()[0]->getPropertySurfaceDataList()[0].second->getConstantValue(), 200.0f);
+
+    // A stale index is not used
+    {
+        std::ofstream xml(xmlFileName.c_str(), std::ios::app);
+        xml << "\n";
+    }
+    std::shared_ptr<Project> parsed = ImportFromXML::importFromXML(xmlFileName);
+    ASSERT_EQ(parsed->getSnapShots().size(), 3u);
+    EXPECT_TRUE(parsed->getSnapShots()[1]->isLoaded());
+    EXPECT_EQ(parsed->getSnapShots()[1]->getSurfaceList()[0]->getPropertySurfaceDataList()[0].second->getConstantValue(), 100.0f);
+
+    // Snapshots that changed after opening cannot be loaded anymore
+    snapShots.first_child().child("surfaces").child("surface").child("propertymaps").child("propertymap").attribute("constantvalue") = 5.0f;
+    ASSERT_TRUE(doc.save_file(xmlFileName.c_str()));
+    EXPECT_THROW(indexed->getSnapShots()[0]->getSurfaceList(), CauldronIOException);
+    EXPECT_EQ(indexed->getSnapShots()[1]->getSurfaceList().size(), 1u);
+
+    // A project keeps reading the xml it was opened from when that is replaced
+    ASSERT_TRUE(XmlIndex::save(doc, xmlFileName, XmlIndex::getIndexFileName(xmlFileName)));
+    std::shared_ptr<Project> opened = ImportFromXML::importFromXML(xmlFileName);
+    snapShots.first_child().child("surfaces").child("surface").child("propertymaps").child("propertymap").attribute("constantvalue") = 7.0f;
+    ASSERT_TRUE(XmlIndex::save(doc, xmlFileName + ".tmp", XmlIndex::getIndexFileName(xmlFileName + ".tmp")));
+    boost::filesystem::rename(XmlIndex::getIndexFileName(xmlFileName + ".tmp"), XmlIndex::getIndexFileName(xmlFileName));
+    boost::filesystem::rename(xmlFileName + ".tmp", xmlFileName);
+    ASSERT_FALSE(opened->getSnapShots()[0]->isLoaded());
+    EXPECT_EQ(opened->getSnapShots()[0]->getSurfaceList()[0]->getPropertySurfaceDataList()[0].second->getConstantValue(), 5.0f);
+
+    ibs::FilePath(xmlFileName).remove();
+    ibs::FilePath(XmlIndex::getIndexFileName(xmlFileName)).remove();
+}
+
+TEST( DataStore, XmlVersion )
+{
+    // Files written before the optional datastore attributes were added are still read, newer ones are refused
+    const int minorVersions[3] = { xml_version_minor_oldest, xml_version_minor, xml_version_minor + 1 };
+    const std::string xmlFileName = "XmlVersion.xml";
+    for (int i = 0; i < 3; ++i)
+    {
+        pugi::xml_document doc;
+        pugi::xml_node project = doc.append_child("project");
+        project.append_child("name").text() = "XmlVersion";
+        project.append_child("outputpath").text() = "XmlVersion_vizIO_output";
+        pugi::xml_node version = project.append_child("xml-version");
+        version.append_attribute("major") = xml_version_major;
+        version.append_attribute("minor") = minorVersions[i];
+        pugi::xml_node geometry = project.append_child("geometries").append_child("geometry");
+        geometry.append_attribute("numI") = 10;
+        geometry.append_attribute("numJ") = 10;
+        geometry.append_attribute("deltaI") = 100.0;
+        geometry.append_attribute("deltaJ") = 100.0;
+        ASSERT_TRUE(doc.save_file(xmlFileName.c_str()));
+
+        if (minorVersions[i] > xml_version_minor)
+        {
+            EXPECT_THROW(ImportFromXML::importFromXML(xmlFileName), CauldronIOException);
+        }
+        else
+        {
+            std::shared_ptr<Project> imported = ImportFromXML::importFromXML(xmlFileName);
+            EXPECT_EQ(imported->getXmlVersionMinor(), minorVersions[i]);
+        }
+    }
+
+    ibs::FilePath(xmlFileName).remove();
+}
+
+TEST( DataStore, AppendToXML )
+{
+    // A converted project with one snapshot and a migration table
+    std::shared_ptr<const Property> property(new Property("Depth", "Depth", "Depth", "m", FormationProperty, Surface2DProperty));
+    std::shared_ptr<const Geometry2D> geometry(new Geometry2D(16, 12, 100.0, 100.0, 0.0, 0.0));
+    std::shared_ptr<MigrationEvent> event(new MigrationEvent());
+    event->setSourceAge(10.0f);
+
+    std::shared_ptr<Project> project(new Project("AppendToXML", "", "", xml_version_major, xml_version_minor));
+    std::shared_ptr<SnapShot> snapShot = createMapSnapShot(10.0, property, geometry, 1000.0f);
+    std::shared_ptr<const Property> projectProperty(property);
+    project->addProperty(projectProperty);
+    project->addGeometry(geometry);
+    project->addSnapShot(snapShot);
+    project->addMigrationEvent(event);
+    ASSERT_TRUE(ExportToXML::exportToXML(project, std::shared_ptr<Project>(), "AppendToXML.project3d"));
+
+    const std::string outputPath = "AppendToXML_vizIO_output";
+    const std::string migrationStore = outputPath + "/migration_events.cldrn";
+    const uintmax_t migrationStoreSize = boost::filesystem::file_size(migrationStore);
+
+    // A new run with an extra snapshot and the same migration table
+    std::shared_ptr<Project> newProject(new Project("AppendToXML", "", "", xml_version_major, xml_version_minor));
+    std::shared_ptr<SnapShot> newSnapShot = createMapSnapShot(5.0, property, geometry, 2000.0f);
+    std::shared_ptr<SnapShot> oldSnapShot = createMapSnapShot(10.0, property, geometry, 1000.0f);
+    newProject->addProperty(projectProperty);
+    newProject->addGeometry(geometry);
+    newProject->addSnapShot(oldSnapShot);
+    newProject->addSnapShot(newSnapShot);
+    newProject->addMigrationEvent(event);
+
+    std::shared_ptr<Project> converted = ImportFromXML::importFromXML("AppendToXML.xml");
+    EXPECT_EQ(VisualizationUtils::addNewSnapShots(converted, newProject), 1u);
+    ASSERT_TRUE(ExportToXML::appendToXML(converted, "AppendToXML.project3d"));
+
+    // The unchanged table is referred to, not stored again
+    EXPECT_EQ(boost::filesystem::file_size(migrationStore), migrationStoreSize);
+
+    std::shared_ptr<Project> appended = ImportFromXML::importFromXML("AppendToXML.xml");
+    ASSERT_EQ(appended->getSnapShots().size(), 2u);
+    const float offsets[2] = { 1000.0f, 2000.0f };
+    for (size_t i = 0; i < 2; ++i)
+    {
+        std::shared_ptr<SurfaceData> map = appended->getSnapShots()[i]->getSurfaceList().at(0)->getPropertySurfaceDataList().at(0).second;
+        map->retrieve();
+        for (size_t j = 0; j < geometry->getSize(); ++j)
+            ASSERT_EQ(map->getSurfaceValues()[j], offsets[i] + (float)j);
+    }
+    ASSERT_EQ(appended->getMigrationEventsTable().size(), 1u);
+    EXPECT_EQ(appended->getMigrationEventsTable()[0]->getSourceAge(), 10.0f);
+
+    // A changed table replaces the stored one
+    std::shared_ptr<MigrationEvent> secondEvent(new MigrationEvent());
+    secondEvent->setSourceAge(5.0f);
+    newProject->addMigrationEvent(secondEvent);
+    EXPECT_EQ(VisualizationUtils::addNewSnapShots(appended, newProject), 0u);
+    ASSERT_TRUE(ExportToXML::appendToXML(appended, "AppendToXML.project3d"));
+    EXPECT_GT(boost::filesystem::file_size(migrationStore), migrationStoreSize);
+    EXPECT_EQ(ImportFromXML::importFromXML("AppendToXML.xml")->getMigrationEventsTable().size(), 2u);
+
+    boost::filesystem::remove_all(outputPath);
+    ibs::FilePath("AppendToXML.xml").remove();
+    ibs::FilePath(XmlIndex::getIndexFileName("AppendToXML.xml")).remove();
+    ibs::FilePath("AppendToXML.xml.lock").remove();
+}
+
+TEST( DataStore, Pipeline )
+{
+    // Maps stored on disk, to be read, converted and written again through the pipeline
+    const size_t numMaps = 12;
+    std::shared_ptr<Geometry2D> geometry(new Geometry2D(64, 48, 100.0, 100.0, 0.0, 0.0));
+    const size_t numBytes = geometry->getSize() * sizeof(float);
+
+    pugi::xml_document doc;
+    std::vector<pugi::xml_node> inputNodes;
+    {
+        std::vector<std::shared_ptr<MapNative> > inputs;
+        DataStoreSave dataStore("Pipeline_in.cldrn", false);
+        for (size_t map = 0; map < numMaps; ++map)
+        {
+            std::vector<float> values(geometry->getSize());
+            for (size_t i = 0; i < values.size(); ++i)
+                values[i] = (float)(map * 1000 + i % 97);
+
+            inputs.push_back(std::shared_ptr<MapNative>(new MapNative(geometry)));
+            inputs.back()->setData_IJ(values.data());
+            inputNodes.push_back(doc.append_child("input"));
+            dataStore.addSurface(inputs.back(), inputNodes.back());
+        }
+    }
+
+    std::vector<std::shared_ptr<MapNative> > stored;
+    std::vector<VisualizationIOData*> data;
+    for (size_t map = 0; map < numMaps; ++map)
+    {
+        stored.push_back(std::shared_ptr<MapNative>(new MapNative(geometry)));
+        DataStoreLoad::getSurface(inputNodes[map], stored.back(), ibs::FilePath("."));
+        data.push_back(stored.back().get());
+    }
+
+    // Room for three maps: each map is counted twice, as read and converted
+    const size_t maxMemory = 6 * numBytes;
+    std::vector<pugi::xml_node> outputNodes;
+    std::vector<std::shared_ptr<MapNative> > outputs; // blocks refer to the values until written
+    {
+        DataStoreSave dataStore("Pipeline_out.cldrn", false);
+        DataPipeline pipeline(data, 3, maxMemory);
+        for (size_t map = 0; map < numMaps; ++map)
+        {
+            pipeline.waitFor(stored[map].get());
+            ASSERT_TRUE(stored[map]->isRetrieved());
+
+            outputs.push_back(std::shared_ptr<MapNative>(new MapNative(geometry)));
+            outputs.back()->setData_IJ(const_cast<float*>(stored[map]->getSurfaceValues()));
+            outputNodes.push_back(doc.append_child("output"));
+
+            const size_t firstBlock = dataStore.getNumBlocks();
+            dataStore.addSurface(outputs.back(), outputNodes.back());
+            pipeline.write(stored[map].get(), dataStore, firstBlock);
+        }
+        pipeline.finish();
+
+        // Only the map waited for can go over the limit
+        EXPECT_GT(pipeline.getPeakMemory(), 0u);
+        EXPECT_LE(pipeline.getPeakMemory(), maxMemory + 2 * numBytes);
+    }
+
+    for (size_t map = 0; map < numMaps; ++map)
+    {
+        EXPECT_FALSE(stored[map]->isRetrieved());
+
+        std::shared_ptr<MapNative> input(new MapNative(geometry)), output(new MapNative(geometry));
+        DataStoreLoad::getSurface(inputNodes[map], input, ibs::FilePath("."));
+        DataStoreLoad::getSurface(outputNodes[map], output, ibs::FilePath("."));
+        input->retrieve();
+        output->retrieve();
+        EXPECT_EQ(std::memcmp(input->getSurfaceValues(), output->getSurfaceValues(), numBytes), 0);
+    }
+
+    ibs::FilePath("Pipeline_in.cldrn").remove();
+    ibs::FilePath("Pipeline_out.cldrn").remove();
+}
@@ -439,6 +439,40 @@ TEST(SnapShot, Add)
 
 }
 
+namespace
+{
+	// Adds a surface, then fails the first time it is loaded
+	class FailingSnapShotContents : public SnapShotContents
+	{
+	public:
+		FailingSnapShotContents() : m_numLoads(0) {}
+
+		virtual void load(SnapShot& snapShot)
+		{
+			std::shared_ptr<Surface> surface(new Surface("surface", Sediment));
+			snapShot.addSurface(surface);
+			if (m_numLoads++ == 0)
+				throw CauldronIOException("Cannot load snapshot");
+		}
+
+	private:
+		int m_numLoads;
+	};
+}
+
+TEST(SnapShot, LoadContents_HandleFailure)
+{
+	std::shared_ptr<SnapShot> snap(new SnapShot(10, SYSTEM, false));
+	snap->setContents(std::shared_ptr<SnapShotContents>(new FailingSnapShotContents()));
+	EXPECT_FALSE(snap->isLoaded());
+
+	EXPECT_THROW(snap->getSurfaceList(), CauldronIOException);
+	EXPECT_FALSE(snap->isLoaded());
+
+	EXPECT_EQ(snap->getSurfaceList().size(), 1);
+	EXPECT_TRUE(snap->isLoaded());
+}
+
 TEST(SnapShot, AddSurface_HandleEmptySurface)
 {
 	std::shared_ptr<SnapShot> snapShot(new SnapShot(0, SYSTEM, false));
@@ -14,6 +14,24 @@
 /// \brief The alignment, in bytes, required by arrays of the types below (Real_ptr and ConstReal_ptr)
 const int ARRAY_ALIGNMENT = 32;
 
+/// \def ARRAY_SIMD_LOOP
+/// \brief Request vectorisation of the loop that follows.
+///
+/// The iterations of the loop must be independent, any temporaries must be declared inside the loop body.
+/// Calls to the standard maths functions are vectorised only when a vector maths library may be used
+/// (e.g. SVML with the Intel compiler, libmvec with GCC and -ffast-math); use the functions of
+/// SimdMathematics.h instead, which for AVX2 and AVX512 targets are vectorised with the precise floating point model.
+
+/// \def ARRAY_SIMD_FUNCTION
+/// \brief Declare that the function that follows may be called from the lanes of an ARRAY_SIMD_LOOP.
+#if defined(_OPENMP) && ( defined(__GNUG__) || defined(__clang__) || defined(__INTEL_COMPILER))
+#define ARRAY_SIMD_LOOP _Pragma("omp simd")
+#define ARRAY_SIMD_FUNCTION _Pragma("omp declare simd notinbranch")
+#else
+#define ARRAY_SIMD_LOOP
+#define ARRAY_SIMD_FUNCTION
+#endif
+
 namespace ArrayDefs
 {
 
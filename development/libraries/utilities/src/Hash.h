@@ -0,0 +1,42 @@
+//
+// Copyright (C) 2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+/// @file Hash.h
+/// @brief This file has the hash function used to detect changes to files and inputs
+
+#ifndef UTILITIES_HASH_H
+#define UTILITIES_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Utilities
+{
+   /// \brief The initial value of the 64-bit FNV-1a hash
+   constexpr uint64_t HashOffsetBasis = 14695981039346656037ULL;
+
+   /// \brief The 64-bit FNV-1a hash of the data, continuing from a previous hash
+   ///
+   /// Hashing data in pieces gives the same result as hashing it at once.
+   inline uint64_t hash ( const char* data, const size_t size, const uint64_t previous = HashOffsetBasis )
+   {
+      uint64_t result = previous;
+
+      for ( size_t i = 0; i < size; ++i )
+      {
+         result ^= static_cast<unsigned char>( data[i] );
+         result *= 1099511628211ULL;
+      }
+
+      return result;
+   }
+}
+
+#endif // UTILITIES_HASH_H
@@ -0,0 +1,306 @@
+//
+// Copyright (C) 2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+/// @file SimdMathematics.h
+/// @brief Exponential, logarithm, power and cube root for ARRAY_SIMD_LOOP loops.
+///
+/// The standard maths functions are only vectorised by the compiler when it may call a vector maths library,
+/// which for GCC requires -ffast-math. The implementations in Detail are written in plain floating point and
+/// integer arithmetic, without tables or branches, so they are vectorised with the precise floating point model.
+/// Their intermediate results are kept in double-double precision, so the results are within one unit in the
+/// last place of those of the standard functions.
+///
+/// Only with four or more lanes of doubles (AVX2 with FMA, AVX512) are these faster than the scalar standard
+/// functions; for other targets, and for the Intel compiler with its own vector maths library, the functions
+/// below call the standard ones.
+
+#ifndef UTILITIES_SIMDMATHEMATICS_H
+#define UTILITIES_SIMDMATHEMATICS_H
+
+#include "ArrayDefinitions.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+/// \def SIMD_MATHS_INLINE
+/// \brief The functions must be inlined into the loops calling them to be vectorised, whatever their size.
+#if defined(__GNUG__) || defined(__clang__) || defined(__INTEL_COMPILER)
+#define SIMD_MATHS_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define SIMD_MATHS_INLINE __forceinline
+#else
+#define SIMD_MATHS_INLINE inline
+#endif
+
+/// \def SIMD_MATHS_VECTORISED
+/// \brief Whether the functions below use the vectorised implementations.
+#if defined(_OPENMP) && !defined(__INTEL_COMPILER) && ( defined(__AVX512F__) || ( defined(__AVX2__) && defined(__FMA__) ))
+#define SIMD_MATHS_VECTORISED 1
+#else
+#define SIMD_MATHS_VECTORISED 0
+#endif
+
+namespace Utilities
+{
+   namespace SimdMaths
+   {
+
+      namespace Detail
+      {
+         /// @brief A value as the unevaluated sum of two doubles, the low part is at most half a unit in the last place of the high part.
+         struct DoubleDouble
+         {
+            double hi;
+            double lo;
+         };
+
+         constexpr double Ln2Hi           = 6.93147180369123816490e-01; ///< ln(2) rounded to 32 bits, so that its product with an exponent is exact
+         constexpr double Ln2Lo           = 1.90821492927058770002e-10; ///< ln(2) - Ln2Hi
+         constexpr double InvLn2          = 1.44269504088896338700e+00; ///< 1 / ln(2)
+         constexpr double Sqrt2           = 1.41421356237309504880e+00;
+         constexpr double RoundMagic      = 6755399441055744.0;         ///< 1.5 * 2^52, adding and subtracting it rounds to the nearest integer
+         constexpr double SplitFactor     = 134217729.0;                ///< 2^27 + 1, splits a double into two halves whose products are exact
+         constexpr double MaximumExponent = 709.782712893384;           ///< Above this exp overflows
+         constexpr double MinimumExponent = -745.1332191019412;         ///< Below this exp underflows to zero
+
+         SIMD_MATHS_INLINE uint64_t toBits ( const double value ) {
+            uint64_t bits;
+            std::memcpy ( &bits, &value, sizeof ( bits ));
+            return bits;
+         }
+
+         SIMD_MATHS_INLINE double fromBits ( const uint64_t bits ) {
+            double value;
+            std::memcpy ( &value, &bits, sizeof ( value ));
+            return value;
+         }
+
+         /// @brief Select a or b by bitwise operations on a mask.
+         ///
+         /// Both values are calculated before the selection. A conditional expression is not used, since the
+         /// compiler may move the calculation of the selected value into a branch, which it does not if-convert
+         /// when the calculation may raise a floating point exception.
+         SIMD_MATHS_INLINE double select ( const bool condition, const double a, const double b ) {
+            const uint64_t mask = uint64_t ( 0 ) - uint64_t ( condition );
+            return fromBits (( toBits ( a ) & mask ) | ( toBits ( b ) & ~mask ));
+         }
+
+         /// @brief The sum of two doubles and its rounding error.
+         SIMD_MATHS_INLINE DoubleDouble twoSum ( const double a, const double b ) {
+            const double sum = a + b;
+            const double bVirtual = sum - a;
+            const double aVirtual = sum - bVirtual;
+            return DoubleDouble { sum, ( a - aVirtual ) + ( b - bVirtual ) };
+         }
+
+         /// @brief The sum of two doubles and its rounding error, when |a| >= |b|.
+         SIMD_MATHS_INLINE DoubleDouble fastTwoSum ( const double a, const double b ) {
+            const double sum = a + b;
+            return DoubleDouble { sum, b - ( sum - a ) };
+         }
+
+         /// @brief The product of two doubles and its rounding error.
+         ///
+         /// Without fused multiply-add instructions the error is found by Dekker's splitting. The splitting must
+         /// not be used when the compiler may contract its products and sums into fused multiply-adds.
+         SIMD_MATHS_INLINE DoubleDouble twoProduct ( const double a, const double b ) {
+#if defined(__FMA__) || defined(__AVX512F__)
+            const double product = a * b;
+            return DoubleDouble { product, std::fma ( a, b, -product ) };
+#else
+            const double aSplit = SplitFactor * a;
+            const double aHi = aSplit - ( aSplit - a );
+            const double aLo = a - aHi;
+            const double bSplit = SplitFactor * b;
+            const double bHi = bSplit - ( bSplit - b );
+            const double bLo = b - bHi;
+            const double product = a * b;
+            return DoubleDouble { product, (( aHi * bHi - product ) + aHi * bLo + aLo * bHi ) + aLo * bLo };
+#endif
+         }
+
+         /// @brief Two to the power of an integer valued double in [-1022, 1023].
+         SIMD_MATHS_INLINE double twoToThePower ( const double exponent ) {
+            return fromBits (( toBits ( exponent + RoundMagic ) - toBits ( RoundMagic ) + 1023 ) << 52 );
+         }
+
+         /// @brief The natural logarithm of a positive finite value in double-double precision.
+         SIMD_MATHS_INLINE DoubleDouble logarithm ( double x ) {
+            // Scale subnormal values into the normal range
+            const bool subnormal = x < std::numeric_limits<double>::min ();
+            const uint64_t bits = toBits ( select ( subnormal, x * 18014398509481984.0, x ));
+
+            // x = 2^e * m with m in [sqrt(1/2), sqrt(2))
+            const uint64_t mantissaBits = bits & 0x000FFFFFFFFFFFFFULL;
+            const bool upper = fromBits ( mantissaBits | 0x3FF0000000000000ULL ) > Sqrt2;
+            const double mantissa = fromBits ( mantissaBits | ( upper ? 0x3FE0000000000000ULL : 0x3FF0000000000000ULL ));
+            const double bias = subnormal ? ( upper ? 1076.0 : 1077.0 ) : ( upper ? 1022.0 : 1023.0 );
+            const double exponent = fromBits (( bits >> 52 ) | 0x4330000000000000ULL ) - 4503599627370496.0 - bias;
+
+            // log(m) = 2 atanh(s) with s = (m - 1) / (m + 1), |s| < 0.1716; m - 1 is exact
+            const double numerator = mantissa - 1.0;
+            const DoubleDouble denominator = twoSum ( mantissa, 1.0 );
+            const double sHi = numerator / denominator.hi;
+            const DoubleDouble product = twoProduct ( sHi, denominator.hi );
+            const double sLo = (( numerator - product.hi ) - product.lo - sHi * denominator.lo ) / denominator.hi;
+
+            // 2 atanh(s) = 2s + s^3 * (2/3 + 2/5 s^2 + ...), truncated below 1.0e-20
+            const double s2 = sHi * sHi;
+            double series = 2.0 / 23.0;
+            series = 2.0 / 21.0 + s2 * series;
+            series = 2.0 / 19.0 + s2 * series;
+            series = 2.0 / 17.0 + s2 * series;
+            series = 2.0 / 15.0 + s2 * series;
+            series = 2.0 / 13.0 + s2 * series;
+            series = 2.0 / 11.0 + s2 * series;
+            series = 2.0 /  9.0 + s2 * series;
+            series = 2.0 /  7.0 + s2 * series;
+            series = 2.0 /  5.0 + s2 * series;
+            series = 2.0 /  3.0 + s2 * series;
+            const double tail = sHi * s2 * series;
+
+            const DoubleDouble head = twoSum ( exponent * Ln2Hi, 2.0 * sHi );
+            const DoubleDouble sum  = twoSum ( head.hi, tail );
+            return fastTwoSum ( sum.hi, sum.lo + head.lo + 2.0 * sLo + exponent * Ln2Lo );
+         }
+
+         /// @brief The exponential of a double-double value.
+         SIMD_MATHS_INLINE double exponential ( const double hi, const double lo ) {
+            // exp(x) = 2^q * exp(r) with |r| <= ln(2) / 2
+            const double q = ( hi * InvLn2 + RoundMagic ) - RoundMagic;
+            const DoubleDouble reduced = twoSum ( hi, -q * Ln2Hi );
+            const DoubleDouble r = fastTwoSum ( reduced.hi, reduced.lo + lo - q * Ln2Lo );
+
+            // exp(r) - 1 - r = r^2 * (1/2 + r/6 + ...), truncated below 1.0e-20
+            double series = 1.0 / 20922789888000.0;
+            series = 1.0 / 1307674368000.0 + r.hi * series;
+            series = 1.0 / 87178291200.0   + r.hi * series;
+            series = 1.0 / 6227020800.0    + r.hi * series;
+            series = 1.0 / 479001600.0     + r.hi * series;
+            series = 1.0 / 39916800.0      + r.hi * series;
+            series = 1.0 / 3628800.0       + r.hi * series;
+            series = 1.0 / 362880.0        + r.hi * series;
+            series = 1.0 / 40320.0         + r.hi * series;
+            series = 1.0 / 5040.0          + r.hi * series;
+            series = 1.0 / 720.0           + r.hi * series;
+            series = 1.0 / 120.0           + r.hi * series;
+            series = 1.0 / 24.0            + r.hi * series;
+            series = 1.0 / 6.0             + r.hi * series;
+            series = 0.5                   + r.hi * series;
+            const double tail = r.hi * r.hi * series + r.hi * r.lo;
+
+            const DoubleDouble sum = fastTwoSum ( 1.0, r.hi );
+            const double value = sum.hi + ( sum.lo + r.lo + tail );
+
+            // Scale in two steps, so that results near the limits of the range are neither overflowed nor flushed early
+            const double clamped = select ( q > 1100.0, 1100.0, select ( q < -1100.0, -1100.0, q ));
+            const double q1 = ( 0.5 * clamped + RoundMagic ) - RoundMagic;
+            const double scaled = value * twoToThePower ( q1 ) * twoToThePower ( clamped - q1 );
+
+            const double result = select ( hi > MaximumExponent, std::numeric_limits<double>::infinity (), select ( hi < MinimumExponent, 0.0, scaled ));
+            return select ( hi != hi, hi, result );
+         }
+
+         /// @brief The branch-free exponential of x.
+         SIMD_MATHS_INLINE double exp ( const double x ) {
+            return exponential ( x, 0.0 );
+         }
+
+         /// @brief The branch-free natural logarithm of x, for x >= 0.
+         SIMD_MATHS_INLINE double log ( const double x ) {
+            const DoubleDouble value = logarithm ( x );
+            double result = select ( x > 0.0, value.hi + value.lo, std::numeric_limits<double>::quiet_NaN () );
+            result = select ( x == std::numeric_limits<double>::infinity (), x, result );
+            return select ( x == 0.0, -std::numeric_limits<double>::infinity (), result );
+         }
+
+         /// @brief The branch-free x to the power y, for x >= 0.
+         ///
+         /// Negative values of x, which for integer values of y have a power, are not supported and give NaN.
+         SIMD_MATHS_INLINE double pow ( const double x, const double y ) {
+            const DoubleDouble logX = logarithm ( x );
+            const DoubleDouble product = twoProduct ( y, logX.hi );
+            const double power = exponential ( product.hi, product.lo + y * logX.lo );
+
+            // The limits of x^y for x towards 0 and infinity
+            const bool positiveExponent = y > 0.0;
+            const double zeroPower = select ( positiveExponent, 0.0, std::numeric_limits<double>::infinity () );
+            const double infinityPower = select ( positiveExponent, std::numeric_limits<double>::infinity (), 0.0 );
+
+            double result = select ( x > 0.0, power, std::numeric_limits<double>::quiet_NaN () );
+            result = select ( x == 0.0, zeroPower, result );
+            result = select ( x == std::numeric_limits<double>::infinity (), infinityPower, result );
+            return select ( y == 0.0, 1.0, result );
+         }
+
+         /// @brief The branch-free cube root of x.
+         SIMD_MATHS_INLINE double cbrt ( const double x ) {
+            const double absolute = std::fabs ( x );
+            const DoubleDouble logX = logarithm ( absolute );
+
+            // A third of the logarithm in double-double precision
+            const double thirdHi = logX.hi / 3.0;
+            const DoubleDouble product = twoProduct ( thirdHi, 3.0 );
+            const double thirdLo = (( logX.hi - product.hi ) - product.lo + logX.lo ) / 3.0;
+            const double root = exponential ( thirdHi, thirdLo );
+
+            // Zero, infinity and NaN are their own cube roots
+            const bool special = ( x == 0.0 ) | ( absolute == std::numeric_limits<double>::infinity () ) | ( x != x );
+            return select ( special, x, select ( x < 0.0, -root, root ));
+         }
+
+      }
+
+      /// @brief The exponential of x.
+      ARRAY_SIMD_FUNCTION
+      SIMD_MATHS_INLINE double exp ( const double x ) {
+#if SIMD_MATHS_VECTORISED
+         return Detail::exp ( x );
+#else
+         return std::exp ( x );
+#endif
+      }
+
+      /// @brief The natural logarithm of x, for x >= 0.
+      ARRAY_SIMD_FUNCTION
+      SIMD_MATHS_INLINE double log ( const double x ) {
+#if SIMD_MATHS_VECTORISED
+         return Detail::log ( x );
+#else
+         return std::log ( x );
+#endif
+      }
+
+      /// @brief x to the power y, for x >= 0.
+      ARRAY_SIMD_FUNCTION
+      SIMD_MATHS_INLINE double pow ( const double x, const double y ) {
+#if SIMD_MATHS_VECTORISED
+         return Detail::pow ( x, y );
+#else
+         return std::pow ( x, y );
+#endif
+      }
+
+      /// @brief The cube root of x.
+      ARRAY_SIMD_FUNCTION
+      SIMD_MATHS_INLINE double cbrt ( const double x ) {
+#if SIMD_MATHS_VECTORISED
+         return Detail::cbrt ( x );
+#else
+         return std::cbrt ( x );
+#endif
+      }
+
+   }
+}
+
+#endif // UTILITIES_SIMDMATHEMATICS_H
@@ -0,0 +1,30 @@
+//
+// Copyright (C) 2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#include "Hash.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+// Reference values of the 64-bit FNV-1a hash
+TEST( Hash, ReferenceValues )
+{
+   EXPECT_EQ( 0xcbf29ce484222325ULL, Utilities::hash( "", 0 ) );
+   EXPECT_EQ( 0xaf63dc4c8601ec8cULL, Utilities::hash( "a", 1 ) );
+   EXPECT_EQ( 0x85944171f73967e8ULL, Utilities::hash( "foobar", 6 ) );
+}
+
+TEST( Hash, ContinuesFromPreviousHash )
+{
+   const std::string text = "StratIoTbl\nLithotypeIoTbl\n";
+
+   const uint64_t first = Utilities::hash( text.data(), 11 );
+   EXPECT_EQ( Utilities::hash( text.data(), text.size() ), Utilities::hash( text.data() + 11, text.size() - 11, first ) );
+   EXPECT_NE( first, Utilities::hash( text.data(), text.size() ) );
+}
@@ -0,0 +1,158 @@
+//
+// Copyright (C) 2018 Shell International Exploration & Production.
+// All rights reserved.
+//
+// Developed under license for Shell by PDS BV.
+//
+// Confidential and proprietary source code of Shell.
+// Do not distribute without written permission from Shell.
+//
+
+#include "../src/SimdMathematics.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+   /// The difference between a value and its reference in units in the last place of the reference.
+   double ulps ( const double value, const long double reference ) {
+      const double rounded = static_cast<double>( reference );
+      if ( value == rounded ) return 0.0;
+      const double ulp = std::nextafter ( std::fabs ( rounded ), std::numeric_limits<double>::infinity ()) - std::fabs ( rounded );
+      return static_cast<double>( std::fabs ( value - reference )) / ulp;
+   }
+
+   /// Powers and cube roots of values spread over many orders of magnitude, calculated in an ARRAY_SIMD_LOOP.
+   class SimdMathematicsTest : public ::testing::Test
+   {
+   protected :
+
+      static const unsigned int NumberOfValues = 100000;
+
+      void SetUp () override {
+         std::mt19937 generator ( 3 );
+         std::uniform_real_distribution<double> decade ( -300.0, 300.0 );
+         std::uniform_real_distribution<double> exponent ( -4.0, 4.0 );
+
+         m_x.resize ( NumberOfValues );
+         m_y.resize ( NumberOfValues );
+         m_result.resize ( NumberOfValues );
+
+         for ( unsigned int i = 0; i < NumberOfValues; ++i ) {
+            m_x [ i ] = std::pow ( 10.0, decade ( generator ));
+            m_y [ i ] = exponent ( generator );
+         }
+      }
+
+      std::vector<double> m_x;
+      std::vector<double> m_y;
+      std::vector<double> m_result;
+   };
+
+   void power ( const unsigned int n, ArrayDefs::ConstReal_ptr x, ArrayDefs::ConstReal_ptr y, ArrayDefs::Real_ptr result ) {
+      ARRAY_SIMD_LOOP
+      for ( unsigned int i = 0; i < n; ++i ) {
+         result [ i ] = Utilities::SimdMaths::Detail::pow ( x [ i ], y [ i ]);
+      }
+   }
+
+   void cubeRoot ( const unsigned int n, ArrayDefs::ConstReal_ptr x, ArrayDefs::Real_ptr result ) {
+      ARRAY_SIMD_LOOP
+      for ( unsigned int i = 0; i < n; ++i ) {
+         result [ i ] = Utilities::SimdMaths::Detail::cbrt ( x [ i ]);
+      }
+   }
+
+}
+
+TEST_F ( SimdMathematicsTest, Power )
+{
+   power ( NumberOfValues, m_x.data (), m_y.data (), m_result.data ());
+
+   for ( unsigned int i = 0; i < NumberOfValues; ++i ) {
+      const double expected = std::pow ( m_x [ i ], m_y [ i ]);
+
+      // Outside the range of normal values the results are rounded to fewer bits
+      if ( expected > std::numeric_limits<double>::min () and expected < std::numeric_limits<double>::max ()) {
+         ASSERT_LE ( ulps ( m_result [ i ], std::pow ( static_cast<long double>( m_x [ i ]), static_cast<long double>( m_y [ i ]))), 1.0 ) << m_x [ i ] << "^" << m_y [ i ];
+      }
+   }
+}
+
+TEST_F ( SimdMathematicsTest, CubeRoot )
+{
+   cubeRoot ( NumberOfValues, m_x.data (), m_result.data ());
+
+   for ( unsigned int i = 0; i < NumberOfValues; ++i ) {
+      ASSERT_LE ( ulps ( m_result [ i ], std::cbrt ( static_cast<long double>( m_x [ i ]))), 1.0 ) << m_x [ i ];
+   }
+
+   for ( unsigned int i = 0; i < NumberOfValues; ++i ) {
+      EXPECT_EQ ( Utilities::SimdMaths::Detail::cbrt ( -m_x [ i ]), -m_result [ i ]);
+   }
+}
+
+TEST ( SimdMathematics, ExponentialAndLogarithm )
+{
+   for ( double x = -745.0; x < 709.7; x += 0.0137 ) {
+      ASSERT_LE ( ulps ( Utilities::SimdMaths::Detail::exp ( x ), std::exp ( static_cast<long double>( x ))), 1.0 ) << x;
+   }
+
+   for ( double x = 1.0e-320; x < 1.0e300; x *= 1.37 ) {
+      ASSERT_LE ( ulps ( Utilities::SimdMaths::Detail::log ( x ), std::log ( static_cast<long double>( x ))), 1.0 ) << x;
+   }
+}
+
+TEST ( SimdMathematics, SpecialValues )
+{
+   using namespace Utilities::SimdMaths;
+   const double infinity = std::numeric_limits<double>::infinity ();
+   const double nan = std::numeric_limits<double>::quiet_NaN ();
+
+   for ( const double y : { -2.5, -1.0, 0.0, 0.5, 3.0 }) {
+      EXPECT_EQ ( Detail::pow ( 0.0, y ), std::pow ( 0.0, y )) << y;
+      EXPECT_EQ ( Detail::pow ( 1.0, y ), 1.0 ) << y;
+      EXPECT_EQ ( Detail::pow ( infinity, y ), std::pow ( infinity, y )) << y;
+      EXPECT_TRUE ( std::isnan ( Detail::pow ( nan, y )) or y == 0.0 ) << y;
+   }
+
+   EXPECT_EQ ( Detail::pow ( nan, 0.0 ), 1.0 );
+   EXPECT_TRUE ( std::isnan ( Detail::pow ( -2.0, 0.5 )));
+   EXPECT_EQ ( Detail::pow ( 10.0, 400.0 ), infinity );
+   EXPECT_EQ ( Detail::pow ( 10.0, -400.0 ), 0.0 );
+
+   EXPECT_EQ ( Detail::cbrt ( 0.0 ), 0.0 );
+   EXPECT_TRUE ( std::signbit ( Detail::cbrt ( -0.0 )));
+   EXPECT_EQ ( Detail::cbrt ( infinity ), infinity );
+   EXPECT_EQ ( Detail::cbrt ( -infinity ), -infinity );
+   EXPECT_EQ ( Detail::cbrt ( -27.0 ), -3.0 );
+   EXPECT_TRUE ( std::isnan ( Detail::cbrt ( nan )));
+
+   EXPECT_EQ ( Detail::exp ( 710.0 ), infinity );
+   EXPECT_EQ ( Detail::exp ( -746.0 ), 0.0 );
+   EXPECT_EQ ( Detail::exp ( -infinity ), 0.0 );
+   EXPECT_GT ( Detail::exp ( -740.0 ), 0.0 );
+   EXPECT_TRUE ( std::isnan ( Detail::exp ( nan )));
+
+   EXPECT_EQ ( Detail::log ( 0.0 ), -infinity );
+   EXPECT_EQ ( Detail::log ( infinity ), infinity );
+   EXPECT_EQ ( Detail::log ( 1.0 ), 0.0 );
+   EXPECT_TRUE ( std::isnan ( Detail::log ( -1.0 )));
+   EXPECT_TRUE ( std::isnan ( Detail::log ( nan )));
+}
+
+// Whichever implementation is selected for the target, the results are those of the standard functions
+TEST ( SimdMathematics, StandardFunctions )
+{
+   for ( double x = 1.0e-6; x < 1.0e6; x *= 1.7 ) {
+      EXPECT_NEAR ( Utilities::SimdMaths::pow ( x, 1.7 ), std::pow ( x, 1.7 ), 2.0e-16 * std::pow ( x, 1.7 )) << x;
+      EXPECT_NEAR ( Utilities::SimdMaths::cbrt ( x ), std::cbrt ( x ), 4.0e-16 * std::cbrt ( x )) << x;
+      EXPECT_NEAR ( Utilities::SimdMaths::exp ( std::log ( x )), x, 2.0e-16 * x * std::max ( 1.0, std::fabs ( std::log ( x )))) << x;
+      EXPECT_NEAR ( Utilities::SimdMaths::log ( x ), std::log ( x ), 2.0e-16 * std::fabs ( std::log ( x ))) << x;
+   }
+}